@@ -6,7 +6,11 @@
 #include <chrono>
 #include <mutex>
 #include <sstream>
+#ifdef _WIN32
 #include <windows.h>
+#else
+#include <cstdio>
+#endif
 
 class AppLogger {
 public:
@@ -34,7 +38,11 @@ private:
         const auto now = std::chrono::system_clock::now();
         const auto nowTimeT = std::chrono::system_clock::to_time_t(now);
         std::tm tmNow = {};
+#ifdef _WIN32
         localtime_s(&tmNow, &nowTimeT);
+#else
+        localtime_r(&nowTimeT, &tmNow);
+#endif
 
         const auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch()) % 1000;
 
@@ -54,7 +62,11 @@ private:
         }
 
         const std::string debugLine = std::string("[") + fileName + "] " + message + "\n";
+#ifdef _WIN32
         OutputDebugStringA(debugLine.c_str());
+#else
+        std::fputs(debugLine.c_str(), stderr);
+#endif
     }
 
     inline static std::mutex s_logMutex;
@@ -0,0 +1,256 @@
+#include "HttpRequestQueue.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <list>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace Nakama {
+
+namespace {
+
+struct QueuedJob {
+    HttpRequestJob job;
+    std::chrono::steady_clock::time_point submittedAt;
+};
+
+using DroppedJob = std::pair<std::function<void(HttpDropReason)>, HttpDropReason>;
+
+void RunDrops(std::vector<DroppedJob>& dropped) {
+    for (auto& entry : dropped) {
+        if (entry.first) entry.first(entry.second);
+    }
+    dropped.clear();
+}
+
+} // namespace
+
+struct HttpRequestQueue::State {
+    mutable std::mutex mutex;
+    std::condition_variable workAvailable;
+    mutable std::condition_variable idle;
+    std::array<std::deque<QueuedJob>, kHttpRequestPriorityCount> queues;
+    std::list<HttpCancelTokenPtr> running;
+    bool stopping = false;
+    HttpRequestQueueStats stats;
+
+    size_t queuedTotal() const {
+        return queues[0].size() + queues[1].size() + queues[2].size();
+    }
+
+    void updateQueuedStats() {
+        for (size_t i = 0; i < kHttpRequestPriorityCount; ++i) stats.queued[i] = queues[i].size();
+        stats.peakQueued = std::max(stats.peakQueued, queuedTotal());
+    }
+};
+
+const char* GetHttpRequestPriorityName(HttpRequestPriority priority) {
+    switch (priority) {
+    case HttpRequestPriority::Auth: return "auth";
+    case HttpRequestPriority::Gameplay: return "gameplay";
+    case HttpRequestPriority::Cosmetic: return "cosmetic";
+    }
+    return "unknown";
+}
+
+const char* GetHttpDropReasonName(HttpDropReason reason) {
+    switch (reason) {
+    case HttpDropReason::Cancelled: return "cancelled";
+    case HttpDropReason::Expired: return "expired";
+    case HttpDropReason::Shed: return "shed";
+    case HttpDropReason::Rejected: return "rejected";
+    case HttpDropReason::Shutdown: return "shutdown";
+    }
+    return "unknown";
+}
+
+HttpRequestQueue::HttpRequestQueue(size_t workerCount, size_t capacity)
+    : _state(std::make_shared<State>()) {
+    _state->stats.workerCount = std::max<size_t>(1, workerCount);
+    _state->stats.capacity = std::max<size_t>(1, capacity);
+    for (size_t i = 0; i < _state->stats.workerCount; ++i) {
+        std::thread(&HttpRequestQueue::workerLoop, _state).detach();
+    }
+}
+
+HttpRequestQueue::~HttpRequestQueue() {
+    std::vector<DroppedJob> dropped;
+    {
+        std::lock_guard<std::mutex> lock(_state->mutex);
+        _state->stopping = true;
+        for (auto& queue : _state->queues) {
+            for (auto& entry : queue) dropped.emplace_back(std::move(entry.job.drop), HttpDropReason::Shutdown);
+            queue.clear();
+        }
+        for (const auto& token : _state->running) token->cancel();
+        _state->updateQueuedStats();
+    }
+    _state->workAvailable.notify_all();
+    _state->idle.notify_all();
+    RunDrops(dropped);
+}
+
+HttpCancelTokenPtr HttpRequestQueue::submit(HttpRequestJob job) {
+    if (!job.token) job.token = std::make_shared<HttpCancelToken>();
+    HttpCancelTokenPtr token = job.token;
+    const size_t level = std::min(static_cast<size_t>(job.priority), kHttpRequestPriorityCount - 1);
+
+    std::vector<DroppedJob> dropped;
+    {
+        std::lock_guard<std::mutex> lock(_state->mutex);
+        ++_state->stats.submitted;
+        if (_state->stopping) {
+            dropped.emplace_back(std::move(job.drop), HttpDropReason::Shutdown);
+            token = nullptr;
+        } else {
+            if (_state->queuedTotal() >= _state->stats.capacity) {
+                // Shed the newest job of the lowest priority below this one
+                for (size_t victim = kHttpRequestPriorityCount - 1; victim > level; --victim) {
+                    auto& queue = _state->queues[victim];
+                    if (queue.empty()) continue;
+                    dropped.emplace_back(std::move(queue.back().job.drop), HttpDropReason::Shed);
+                    queue.pop_back();
+                    ++_state->stats.shed;
+                    break;
+                }
+            }
+            if (_state->queuedTotal() >= _state->stats.capacity) {
+                ++_state->stats.rejected;
+                dropped.emplace_back(std::move(job.drop), HttpDropReason::Rejected);
+                token = nullptr;
+            } else {
+                _state->queues[level].push_back(QueuedJob{std::move(job), std::chrono::steady_clock::now()});
+                _state->updateQueuedStats();
+            }
+        }
+    }
+    if (token) _state->workAvailable.notify_one();
+    RunDrops(dropped);
+    return token;
+}
+
+bool HttpRequestQueue::cancel(const HttpCancelTokenPtr& token) {
+    if (!token) return false;
+    token->cancel();
+
+    std::vector<DroppedJob> dropped;
+    // Destroyed after the lock is released: the job's captures may own the queue itself
+    QueuedJob removed;
+    bool found = false;
+    {
+        std::lock_guard<std::mutex> lock(_state->mutex);
+        for (auto& queue : _state->queues) {
+            auto it = std::find_if(queue.begin(), queue.end(), [&](const QueuedJob& entry) { return entry.job.token == token; });
+            if (it == queue.end()) continue;
+            removed = std::move(*it);
+            queue.erase(it);
+            dropped.emplace_back(std::move(removed.job.drop), HttpDropReason::Cancelled);
+            ++_state->stats.cancelled;
+            found = true;
+            break;
+        }
+        if (found) {
+            _state->updateQueuedStats();
+            if (_state->queuedTotal() == 0 && _state->running.empty()) _state->idle.notify_all();
+        } else {
+            found = std::find(_state->running.begin(), _state->running.end(), token) != _state->running.end();
+        }
+    }
+    RunDrops(dropped);
+    return found;
+}
+
+void HttpRequestQueue::cancelAll() {
+    std::vector<DroppedJob> dropped;
+    {
+        std::lock_guard<std::mutex> lock(_state->mutex);
+        for (auto& queue : _state->queues) {
+            for (auto& entry : queue) {
+                entry.job.token->cancel();
+                dropped.emplace_back(std::move(entry.job.drop), HttpDropReason::Cancelled);
+                ++_state->stats.cancelled;
+            }
+            queue.clear();
+        }
+        for (const auto& token : _state->running) token->cancel();
+        _state->updateQueuedStats();
+        if (_state->running.empty()) _state->idle.notify_all();
+    }
+    RunDrops(dropped);
+}
+
+HttpRequestQueueStats HttpRequestQueue::getStats() const {
+    std::lock_guard<std::mutex> lock(_state->mutex);
+    return _state->stats;
+}
+
+void HttpRequestQueue::waitIdle() const {
+    std::unique_lock<std::mutex> lock(_state->mutex);
+    _state->idle.wait(lock, [this]() {
+        return _state->stopping || (_state->queuedTotal() == 0 && _state->running.empty());
+    });
+}
+
+void HttpRequestQueue::workerLoop(const std::shared_ptr<State>& state) {
+    std::vector<DroppedJob> dropped;
+    std::unique_lock<std::mutex> lock(state->mutex);
+    for (;;) {
+        state->workAvailable.wait(lock, [&]() { return state->stopping || state->queuedTotal() > 0; });
+        if (state->stopping) return;
+
+        QueuedJob entry;
+        for (auto& queue : state->queues) {
+            if (queue.empty()) continue;
+            entry = std::move(queue.front());
+            queue.pop_front();
+            break;
+        }
+        state->updateQueuedStats();
+
+        const auto now = std::chrono::steady_clock::now();
+        HttpDropReason reason = HttpDropReason::Cancelled;
+        bool drop = false;
+        if (entry.job.token->isCancelled()) {
+            ++state->stats.cancelled;
+            drop = true;
+        } else if (entry.job.deadline != std::chrono::steady_clock::time_point{} && now >= entry.job.deadline) {
+            ++state->stats.expired;
+            reason = HttpDropReason::Expired;
+            drop = true;
+        }
+        if (drop) {
+            dropped.emplace_back(std::move(entry.job.drop), reason);
+            const bool nowIdle = state->queuedTotal() == 0 && state->running.empty();
+            lock.unlock();
+            RunDrops(dropped);
+            entry = QueuedJob{};
+            if (nowIdle) state->idle.notify_all();
+            lock.lock();
+            continue;
+        }
+
+        const auto wait = std::chrono::duration_cast<std::chrono::microseconds>(now - entry.submittedAt);
+        ++state->stats.started;
+        state->stats.totalWait += wait;
+        state->stats.maxWait = std::max(state->stats.maxWait, wait);
+        ++state->stats.busyWorkers;
+        const auto slot = state->running.insert(state->running.end(), entry.job.token);
+        lock.unlock();
+
+        if (entry.job.run) entry.job.run(*entry.job.token);
+        // Release the job's captures before relocking: they may own the queue itself
+        entry = QueuedJob{};
+
+        lock.lock();
+        state->running.erase(slot);
+        --state->stats.busyWorkers;
+        ++state->stats.completed;
+        if (state->queuedTotal() == 0 && state->running.empty()) state->idle.notify_all();
+    }
+}
+
+} // namespace Nakama
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+
+namespace Nakama {
+
+// Lower value = served first. Within one priority requests run in submission order.
+enum class HttpRequestPriority : uint8_t {
+    Auth = 0,     // authenticate / session refresh: everything else waits on it
+    Gameplay = 1, // stage, character and match RPCs
+    Cosmetic = 2, // shop and inventory browsing
+};
+constexpr size_t kHttpRequestPriorityCount = 3;
+
+const char* GetHttpRequestPriorityName(HttpRequestPriority priority);
+
+// Set by the owner of a request (or by HttpRequestQueue::cancelAll); the job polls it.
+class HttpCancelToken {
+public:
+    void cancel() { _cancelled.store(true); }
+    bool isCancelled() const { return _cancelled.load(); }
+
+private:
+    std::atomic<bool> _cancelled{false};
+};
+using HttpCancelTokenPtr = std::shared_ptr<HttpCancelToken>;
+
+// Why a job was dropped without running.
+enum class HttpDropReason : uint8_t {
+    Cancelled, // its token was cancelled while it waited
+    Expired,   // it waited past its deadline
+    Shed,      // the queue was full and a higher-priority job took its slot
+    Rejected,  // the queue was full of jobs at the same or higher priority
+    Shutdown,  // the queue was destroyed
+};
+
+const char* GetHttpDropReasonName(HttpDropReason reason);
+
+struct HttpRequestJob {
+    HttpRequestPriority priority = HttpRequestPriority::Gameplay;
+    HttpCancelTokenPtr token;                               // created by submit() when empty
+    std::chrono::steady_clock::time_point deadline{};       // zero = no deadline
+    std::function<void(const HttpCancelToken& token)> run;  // on a worker thread
+    std::function<void(HttpDropReason reason)> drop;        // exactly one of run / drop is called
+};
+
+struct HttpRequestQueueStats {
+    size_t workerCount = 0;
+    size_t busyWorkers = 0;
+    size_t capacity = 0;
+    std::array<size_t, kHttpRequestPriorityCount> queued{};
+    size_t peakQueued = 0;
+    uint64_t submitted = 0;
+    uint64_t started = 0;
+    uint64_t completed = 0;
+    uint64_t cancelled = 0;
+    uint64_t expired = 0;
+    uint64_t shed = 0;
+    uint64_t rejected = 0;
+    std::chrono::microseconds totalWait{0}; // submit -> start, over `started` jobs
+    std::chrono::microseconds maxWait{0};
+
+    size_t GetQueuedTotal() const { return queued[0] + queued[1] + queued[2]; }
+};
+
+// Fixed pool of worker threads fed by a bounded priority queue. Platform independent: the
+// transport puts its blocking HTTP calls in HttpRequestJob::run.
+//
+// Backpressure: at most `capacity` jobs wait. A job submitted to a full queue evicts the
+// newest waiting job of the lowest priority below its own (dropped as Shed); when there is
+// none it is itself dropped as Rejected. drop callbacks run on the thread that decided the
+// drop (submitter, worker or destructor), never under the queue lock.
+//
+// Workers are detached and keep the shared state alive, so the queue may be destroyed from
+// inside a job (e.g. when that job held the last reference to its owner). The destructor
+// drops the waiting jobs and cancels the running ones without waiting for them.
+class HttpRequestQueue {
+public:
+    HttpRequestQueue(size_t workerCount, size_t capacity);
+    ~HttpRequestQueue();
+
+    HttpRequestQueue(const HttpRequestQueue&) = delete;
+    HttpRequestQueue& operator=(const HttpRequestQueue&) = delete;
+
+    // Returns the job's token, or nullptr when the job was rejected (its drop already ran).
+    HttpCancelTokenPtr submit(HttpRequestJob job);
+
+    // Cancels the job holding token: waiting, it is dropped as Cancelled here (freeing its slot);
+    // running, its job sees the token. False when the job is neither waiting nor running.
+    bool cancel(const HttpCancelTokenPtr& token);
+    // Cancels every waiting and running job: waiting ones are dropped as Cancelled here.
+    void cancelAll();
+
+    HttpRequestQueueStats getStats() const;
+
+    // Blocks until no job is waiting or running. For tools and shutdown paths, not for the
+    // render thread.
+    void waitIdle() const;
+
+private:
+    struct State;
+    static void workerLoop(const std::shared_ptr<State>& state);
+
+    std::shared_ptr<State> _state;
+};
+
+} // namespace Nakama
@@ -13,12 +13,17 @@
 #include <iomanip>
 #include <memory>
 #include <sstream>
-#include <thread>
 #include <vector>
 
 #ifndef WINHTTP_ACCESS_TYPE_AUTOMATIC_PROXY
 #define WINHTTP_ACCESS_TYPE_AUTOMATIC_PROXY WINHTTP_ACCESS_TYPE_DEFAULT_PROXY
 #endif
+#ifndef WINHTTP_OPTION_ENABLE_HTTP_PROTOCOL
+#define WINHTTP_OPTION_ENABLE_HTTP_PROTOCOL 133
+#endif
+#ifndef WINHTTP_PROTOCOL_FLAG_HTTP2
+#define WINHTTP_PROTOCOL_FLAG_HTTP2 0x1
+#endif
 
 namespace Nakama {
 
@@ -128,6 +133,20 @@ std::string ExtractJsonStringField(const std::string& json, const std::string& f
     return out;
 }
 
+uint16_t QueryLocalPort(HINTERNET hRequest) {
+    WINHTTP_CONNECTION_INFO info{};
+    DWORD size = sizeof(info);
+    info.cbSize = size;
+    if (!WinHttpQueryOption(hRequest, WINHTTP_OPTION_CONNECTION_INFO, &info, &size)) return 0;
+    if (info.LocalAddress.ss_family == AF_INET) {
+        return ntohs(reinterpret_cast<const sockaddr_in*>(&info.LocalAddress)->sin_port);
+    }
+    if (info.LocalAddress.ss_family == AF_INET6) {
+        return ntohs(reinterpret_cast<const sockaddr_in6*>(&info.LocalAddress)->sin6_port);
+    }
+    return 0;
+}
+
 bool BodyIndicatesCreateTrue(const std::string& body) {
     if (body.empty()) return false;
     const std::string lower = ToLowerAscii(body);
@@ -142,8 +161,22 @@ bool BodyIndicatesCreateTrue(const std::string& body) {
 
 } // namespace
 
-NakamaIPv4HttpTransport::NakamaIPv4HttpTransport(bool forceIPv4)
-    : _forceIPv4(forceIPv4), _timeout(std::chrono::seconds(30)) {
+NakamaIPv4HttpTransport::NakamaIPv4HttpTransport(bool forceIPv4, size_t workerCount, size_t queueCapacity)
+    : _forceIPv4(forceIPv4), _timeout(std::chrono::seconds(30)),
+      _requestQueue(std::make_unique<HttpRequestQueue>(workerCount, queueCapacity)) {
+}
+
+NakamaIPv4HttpTransport::HostConnection::~HostConnection() {
+    if (connect) WinHttpCloseHandle(connect);
+    if (session) WinHttpCloseHandle(session);
+}
+
+void NakamaIPv4HttpTransport::setConnectionPoolLimits(uint32_t maxConnectionsPerHost, std::chrono::milliseconds idleTimeout, bool keepAlive) {
+    std::lock_guard<std::mutex> lock(_poolMutex);
+    _maxConnectionsPerHost = std::max(1u, maxConnectionsPerHost);
+    _idleTimeout = idleTimeout;
+    _keepAlive = keepAlive;
+    _connections.clear();
 }
 
 void NakamaIPv4HttpTransport::setBaseUri(const std::string& uri) {
@@ -157,6 +190,8 @@ void NakamaIPv4HttpTransport::setTimeout(std::chrono::milliseconds time) {
 }
 
 void NakamaIPv4HttpTransport::tick() {
+    evictIdleConnections(std::chrono::steady_clock::now());
+
     std::vector<PendingCallback> callbacks;
     {
         std::lock_guard<std::mutex> lock(_pendingMutex);
@@ -170,6 +205,10 @@ void NakamaIPv4HttpTransport::tick() {
 }
 
 void NakamaIPv4HttpTransport::request(const NHttpRequest& req, const NHttpResponseCallback& callback) {
+    submitRequest(req, callback);
+}
+
+uint64_t NakamaIPv4HttpTransport::submitRequest(const NHttpRequest& req, const NHttpResponseCallback& callback) {
     std::shared_ptr<NakamaIPv4HttpTransport> self;
     try {
         self = shared_from_this();
@@ -180,7 +219,7 @@ void NakamaIPv4HttpTransport::request(const NHttpRequest& req, const NHttpRespon
             response->errorMessage = "transport ownership error";
             callback(response);
         }
-        return;
+        return 0;
     }
 
     std::string baseUri;
@@ -194,19 +233,119 @@ void NakamaIPv4HttpTransport::request(const NHttpRequest& req, const NHttpRespon
     const uint64_t requestId = ++_requestCounter;
     const uint64_t cancelGeneration = _cancelGeneration.load();
     const std::string method = httpMethodToString(req.method);
+
+    HttpRequestJob job;
+    job.priority = classifyRequestPriority(req);
+    job.token = std::make_shared<HttpCancelToken>();
+    const auto submittedAt = std::chrono::steady_clock::now();
+    if (timeout.count() > 0) {
+        // Still queued when its timeout is up: fail it instead of starting it late
+        job.deadline = submittedAt + timeout;
+    }
     AppLogger::LogNetwork("[HTTP#" + std::to_string(requestId) + "] -> " + method +
         " path='" + req.path + "' body_bytes=" + std::to_string(req.body.size()) +
+        " priority=" + GetHttpRequestPriorityName(job.priority) +
         " force_ipv4=" + std::string(_forceIPv4 ? "true" : "false"));
 
-    std::thread([self, requestId, req, callback, baseUri, timeout, cancelGeneration]() {
-        const NHttpResponsePtr response = self->performRequest(requestId, req, baseUri, timeout, cancelGeneration);
-        if (!callback) return;
-        if (self->_cancelGeneration.load() != cancelGeneration) return;
+    job.run = [self, requestId, req, callback, baseUri, timeout, cancelGeneration, submittedAt](const HttpCancelToken& token) {
+        const auto waitMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - submittedAt).count();
+        const HttpRequestQueueStats stats = self->getQueueStats();
+        AppLogger::LogNetwork("[HTTP#" + std::to_string(requestId) + "] start queue_wait_ms=" + std::to_string(waitMs) +
+            " waiting=" + std::to_string(stats.GetQueuedTotal()) +
+            " busy=" + std::to_string(stats.busyWorkers) + "/" + std::to_string(stats.workerCount));
+
+        const NHttpResponsePtr response = self->performRequest(requestId, req, baseUri, timeout, token);
+        self->forgetRequest(requestId);
+        self->deliverResponse(callback, response, cancelGeneration);
+    };
+    job.drop = [self, requestId, callback, cancelGeneration](HttpDropReason reason) {
+        auto response = std::make_shared<NHttpResponse>();
+        switch (reason) {
+        case HttpDropReason::Cancelled:
+        case HttpDropReason::Shutdown:
+            response->statusCode = InternalStatusCodes::CANCELLED_BY_USER;
+            response->errorMessage = "cancelled";
+            break;
+        case HttpDropReason::Expired:
+            response->statusCode = InternalStatusCodes::CONNECTION_ERROR;
+            response->errorMessage = "timed out waiting for a request worker";
+            break;
+        case HttpDropReason::Shed:
+        case HttpDropReason::Rejected:
+            response->statusCode = InternalStatusCodes::INTERNAL_TRANSPORT_ERROR;
+            response->errorMessage = "request queue full";
+            break;
+        }
+        AppLogger::LogNetwork("[HTTP#" + std::to_string(requestId) + "] <- dropped reason=" +
+            GetHttpDropReasonName(reason) + " status=" + std::to_string(response->statusCode));
+        self->forgetRequest(requestId);
+        self->deliverResponse(callback, response, cancelGeneration);
+    };
 
-        std::lock_guard<std::mutex> lock(self->_pendingMutex);
-        if (self->_cancelGeneration.load() != cancelGeneration) return;
-        self->_pendingCallbacks.push_back(PendingCallback{callback, response});
-    }).detach();
+    {
+        // Registered before submit: a rejected job's drop runs inside submit and unregisters it
+        std::lock_guard<std::mutex> lock(_activeMutex);
+        _activeRequests.emplace(requestId, job.token);
+    }
+    _requestQueue->submit(std::move(job));
+    return requestId;
+}
+
+bool NakamaIPv4HttpTransport::cancelRequest(uint64_t requestId) {
+    HttpCancelTokenPtr token;
+    {
+        std::lock_guard<std::mutex> lock(_activeMutex);
+        auto it = _activeRequests.find(requestId);
+        if (it == _activeRequests.end()) return false;
+        token = it->second;
+    }
+    // A waiting job is dropped (and its callback queued) right here; a running one sees the
+    // token between WinHTTP calls
+    _requestQueue->cancel(token);
+    AppLogger::LogNetwork("[HTTP#" + std::to_string(requestId) + "] cancelRequest() invoked.");
+    return true;
+}
+
+void NakamaIPv4HttpTransport::forgetRequest(uint64_t requestId) {
+    std::lock_guard<std::mutex> lock(_activeMutex);
+    _activeRequests.erase(requestId);
+}
+
+void NakamaIPv4HttpTransport::deliverResponse(
+    const NHttpResponseCallback& callback, const NHttpResponsePtr& response, uint64_t cancelGeneration) {
+    if (!callback) return;
+    if (_cancelGeneration.load() != cancelGeneration) return;
+
+    std::lock_guard<std::mutex> lock(_pendingMutex);
+    if (_cancelGeneration.load() != cancelGeneration) return;
+    _pendingCallbacks.push_back(PendingCallback{callback, response});
+}
+
+HttpRequestQueueStats NakamaIPv4HttpTransport::getQueueStats() const {
+    return _requestQueue->getStats();
+}
+
+HttpRequestPriority NakamaIPv4HttpTransport::classifyRequestPriority(const NHttpRequest& req) {
+    const std::string& path = req.path;
+    if (path.find("/v2/account/authenticate") != std::string::npos ||
+        path.find("/v2/account/session") != std::string::npos ||
+        path.find("/v2/session") != std::string::npos) {
+        return HttpRequestPriority::Auth;
+    }
+
+    const std::string rpcPrefix = "/v2/rpc/";
+    const size_t rpcPos = path.find(rpcPrefix);
+    if (rpcPos != std::string::npos) {
+        const size_t idStart = rpcPos + rpcPrefix.size();
+        const size_t idEnd = path.find_first_of("?/", idStart);
+        const std::string rpcId = path.substr(idStart, idEnd == std::string::npos ? std::string::npos : idEnd - idStart);
+        // Browsing lists: shown when they arrive, nothing else waits on them
+        if (rpcId == "list_shop" || rpcId == "list_inventory" || rpcId == "list_char_inventory") {
+            return HttpRequestPriority::Cosmetic;
+        }
+    }
+    return HttpRequestPriority::Gameplay;
 }
 
 void NakamaIPv4HttpTransport::cancelAllRequests() {
@@ -215,7 +354,106 @@ void NakamaIPv4HttpTransport::cancelAllRequests() {
         std::lock_guard<std::mutex> lock(_pendingMutex);
         _pendingCallbacks.clear();
     }
-    AppLogger::LogNetwork("[HTTP] cancelAllRequests() invoked.");
+    _requestQueue->cancelAll();
+    {
+        // Requests still in flight keep their connection alive until they finish
+        std::lock_guard<std::mutex> lock(_poolMutex);
+        _connections.clear();
+    }
+    const HttpRequestQueueStats stats = _requestQueue->getStats();
+    AppLogger::LogNetwork("[HTTP] cancelAllRequests() invoked. queue: submitted=" + std::to_string(stats.submitted) +
+        " completed=" + std::to_string(stats.completed) +
+        " cancelled=" + std::to_string(stats.cancelled) +
+        " expired=" + std::to_string(stats.expired) +
+        " shed=" + std::to_string(stats.shed) +
+        " rejected=" + std::to_string(stats.rejected) +
+        " peak_waiting=" + std::to_string(stats.peakQueued) +
+        " max_wait_ms=" + std::to_string(stats.maxWait.count() / 1000));
+}
+
+NakamaIPv4HttpTransport::HostConnectionPtr NakamaIPv4HttpTransport::acquireConnection(
+    const ParsedBaseUri& base, std::string* outError) const {
+
+    const auto now = std::chrono::steady_clock::now();
+    evictIdleConnections(now);
+
+    const std::string key = std::string(base.secure ? "https://" : "http://") + base.host + ":" + std::to_string(base.port);
+    std::lock_guard<std::mutex> lock(_poolMutex);
+    if (_keepAlive) {
+        auto it = _connections.find(key);
+        if (it != _connections.end()) {
+            it->second->lastUsed = now;
+            return it->second;
+        }
+    }
+
+    auto connection = std::make_shared<HostConnection>();
+    connection->key = key;
+    connection->lastUsed = now;
+    connection->session = WinHttpOpen(
+        L"NakamaIPv4HttpTransport/1.0",
+        WINHTTP_ACCESS_TYPE_AUTOMATIC_PROXY,
+        WINHTTP_NO_PROXY_NAME,
+        WINHTTP_NO_PROXY_BYPASS,
+        0);
+    if (!connection->session) {
+        if (outError) *outError = "WinHttpOpen failed: " + Win32ErrorToString(GetLastError());
+        return nullptr;
+    }
+
+    DWORD retries = 2;
+    WinHttpSetOption(connection->session, WINHTTP_OPTION_CONNECT_RETRIES, &retries, sizeof(retries));
+    DWORD maxConns = _maxConnectionsPerHost;
+    WinHttpSetOption(connection->session, WINHTTP_OPTION_MAX_CONNS_PER_SERVER, &maxConns, sizeof(maxConns));
+    WinHttpSetOption(connection->session, WINHTTP_OPTION_MAX_CONNS_PER_1_0_SERVER, &maxConns, sizeof(maxConns));
+    // WinHTTP has no HTTP/1.1 pipelining; over TLS, HTTP/2 multiplexes concurrent RPCs on one
+    // socket instead. Older systems reject the option and stay on pooled HTTP/1.1.
+    DWORD protocols = WINHTTP_PROTOCOL_FLAG_HTTP2;
+    const bool http2 = base.secure &&
+        WinHttpSetOption(connection->session, WINHTTP_OPTION_ENABLE_HTTP_PROTOCOL, &protocols, sizeof(protocols)) == TRUE;
+
+    connection->connect = WinHttpConnect(connection->session, toWide(base.host).c_str(), static_cast<INTERNET_PORT>(base.port), 0);
+    if (!connection->connect) {
+        if (outError) *outError = "WinHttpConnect failed: " + Win32ErrorToString(GetLastError());
+        return nullptr;
+    }
+
+    if (_keepAlive) {
+        _connections[key] = connection;
+        AppLogger::LogNetwork("[HTTP] pool open host='" + key + "' max_conns=" + std::to_string(maxConns) +
+            " idle_timeout_ms=" + std::to_string(_idleTimeout.count()) +
+            " http2=" + std::string(http2 ? "true" : "false"));
+    }
+    return connection;
+}
+
+void NakamaIPv4HttpTransport::releaseConnection(const HostConnectionPtr& connection, bool reusable) const {
+    std::lock_guard<std::mutex> lock(_poolMutex);
+    connection->lastUsed = std::chrono::steady_clock::now();
+    if (reusable) return;
+
+    // A transport failure may have left the session's sockets unusable: open fresh ones next time
+    auto it = _connections.find(connection->key);
+    if (it != _connections.end() && it->second == connection) {
+        _connections.erase(it);
+        AppLogger::LogNetwork("[HTTP] pool drop host='" + connection->key + "' after transport error.");
+    }
+}
+
+void NakamaIPv4HttpTransport::evictIdleConnections(std::chrono::steady_clock::time_point now) const {
+    std::lock_guard<std::mutex> lock(_poolMutex);
+    for (auto it = _connections.begin(); it != _connections.end();) {
+        const HostConnectionPtr& connection = it->second;
+        // use_count() == 1: no request holds the connection, only the pool
+        if (connection.use_count() == 1 && now - connection->lastUsed >= _idleTimeout) {
+            AppLogger::LogNetwork("[HTTP] pool close host='" + connection->key + "' idle" +
+                " requests=" + std::to_string(connection->requestCount) +
+                " sockets=" + std::to_string(connection->localPorts.size()));
+            it = _connections.erase(it);
+        } else {
+            ++it;
+        }
+    }
 }
 
 NHttpResponsePtr NakamaIPv4HttpTransport::performRequest(
@@ -223,21 +461,22 @@ NHttpResponsePtr NakamaIPv4HttpTransport::performRequest(
     const NHttpRequest& req,
     const std::string& baseUri,
     std::chrono::milliseconds timeout,
-    uint64_t cancelGeneration) const {
+    const HttpCancelToken& cancelToken) const {
 
     auto response = std::make_shared<NHttpResponse>();
     const auto startedAt = std::chrono::steady_clock::now();
+    std::string connectionNote;
     const auto finishWithLog = [&](const std::string& result, int statusCode) {
         const auto elapsedMs = std::chrono::duration_cast<std::chrono::milliseconds>(
             std::chrono::steady_clock::now() - startedAt).count();
         AppLogger::LogNetwork("[HTTP#" + std::to_string(requestId) + "] <- " + result +
             " status=" + std::to_string(statusCode) +
             " elapsed_ms=" + std::to_string(elapsedMs) +
-            " resp_bytes=" + std::to_string(response->body.size()) +
+            " resp_bytes=" + std::to_string(response->body.size()) + connectionNote +
             (response->errorMessage.empty() ? "" : " error='" + response->errorMessage + "'"));
     };
 
-    if (_cancelGeneration.load() != cancelGeneration) {
+    if (cancelToken.isCancelled()) {
         response->statusCode = InternalStatusCodes::CANCELLED_BY_USER;
         response->errorMessage = "cancelled";
         finishWithLog("cancelled", response->statusCode);
@@ -254,39 +493,18 @@ NHttpResponsePtr NakamaIPv4HttpTransport::performRequest(
 
     const std::string objectPath = buildObjectPath(base, req);
     AppLogger::LogNetwork("[HTTP#" + std::to_string(requestId) + "] request_path='" + objectPath + "'");
-    const std::wstring hostWide = toWide(base.host);
     const std::wstring objectWide = toWide(objectPath);
     const std::wstring methodWide = toWide(httpMethodToString(req.method));
 
-    HINTERNET hSession = WinHttpOpen(
-        L"NakamaIPv4HttpTransport/1.0",
-        WINHTTP_ACCESS_TYPE_AUTOMATIC_PROXY,
-        WINHTTP_NO_PROXY_NAME,
-        WINHTTP_NO_PROXY_BYPASS,
-        0);
-
-    if (!hSession) {
-        const DWORD err = GetLastError();
-        response->statusCode = InternalStatusCodes::CONNECTION_ERROR;
-        response->errorMessage = "WinHttpOpen failed: " + Win32ErrorToString(err);
-        finishWithLog("error", response->statusCode);
-        return response;
-    }
-
-    const int timeoutMs = timeout.count() > 0 ? static_cast<int>(timeout.count()) : 30000;
-    WinHttpSetTimeouts(hSession, timeoutMs, timeoutMs, timeoutMs, timeoutMs);
-    DWORD retries = 2;
-    WinHttpSetOption(hSession, WINHTTP_OPTION_CONNECT_RETRIES, &retries, sizeof(retries));
-
-    HINTERNET hConnect = WinHttpConnect(hSession, hostWide.c_str(), static_cast<INTERNET_PORT>(base.port), 0);
-    if (!hConnect) {
-        const DWORD err = GetLastError();
+    std::string connectionError;
+    const HostConnectionPtr connection = acquireConnection(base, &connectionError);
+    if (!connection) {
         response->statusCode = InternalStatusCodes::CONNECTION_ERROR;
-        response->errorMessage = "WinHttpConnect failed: " + Win32ErrorToString(err);
-        WinHttpCloseHandle(hSession);
+        response->errorMessage = connectionError;
         finishWithLog("error", response->statusCode);
         return response;
     }
+    HINTERNET hConnect = connection->connect;
 
     DWORD openFlags = base.secure ? WINHTTP_FLAG_SECURE : 0;
     HINTERNET hRequest = WinHttpOpenRequest(
@@ -302,12 +520,14 @@ NHttpResponsePtr NakamaIPv4HttpTransport::performRequest(
         const DWORD err = GetLastError();
         response->statusCode = InternalStatusCodes::CONNECTION_ERROR;
         response->errorMessage = "WinHttpOpenRequest failed: " + Win32ErrorToString(err);
-        WinHttpCloseHandle(hConnect);
-        WinHttpCloseHandle(hSession);
+        releaseConnection(connection, false);
         finishWithLog("error", response->statusCode);
         return response;
     }
 
+    const int timeoutMs = timeout.count() > 0 ? static_cast<int>(timeout.count()) : 30000;
+    WinHttpSetTimeouts(hRequest, timeoutMs, timeoutMs, timeoutMs, timeoutMs);
+
 #ifndef WINHTTP_OPTION_RESOLUTION_HOSTNAME
 #define WINHTTP_OPTION_RESOLUTION_HOSTNAME 203
 #endif
@@ -357,6 +577,15 @@ NHttpResponsePtr NakamaIPv4HttpTransport::performRequest(
 
     setNoClientCert();
 
+    if (cancelToken.isCancelled()) {
+        response->statusCode = InternalStatusCodes::CANCELLED_BY_USER;
+        response->errorMessage = "cancelled";
+        WinHttpCloseHandle(hRequest);
+        releaseConnection(connection, true);
+        finishWithLog("cancelled", response->statusCode);
+        return response;
+    }
+
     bool sendOk = WinHttpSendRequest(hRequest,
         WINHTTP_NO_ADDITIONAL_HEADERS, 0,
         bodyPtr, bodyBytes, bodyBytes, 0) == TRUE;
@@ -377,8 +606,7 @@ NHttpResponsePtr NakamaIPv4HttpTransport::performRequest(
         response->errorMessage = "WinHttpSendRequest failed (code=" +
             std::to_string(static_cast<unsigned long>(sendErr)) + "): " + Win32ErrorToString(sendErr);
         WinHttpCloseHandle(hRequest);
-        WinHttpCloseHandle(hConnect);
-        WinHttpCloseHandle(hSession);
+        releaseConnection(connection, false);
         finishWithLog("error", response->statusCode);
         return response;
     }
@@ -388,8 +616,7 @@ NHttpResponsePtr NakamaIPv4HttpTransport::performRequest(
         response->statusCode = InternalStatusCodes::CONNECTION_ERROR;
         response->errorMessage = "WinHttpReceiveResponse failed: " + Win32ErrorToString(err);
         WinHttpCloseHandle(hRequest);
-        WinHttpCloseHandle(hConnect);
-        WinHttpCloseHandle(hSession);
+        releaseConnection(connection, false);
         finishWithLog("error", response->statusCode);
         return response;
     }
@@ -404,9 +631,19 @@ NHttpResponsePtr NakamaIPv4HttpTransport::performRequest(
     }
     response->statusCode = static_cast<int>(statusCode);
 
+    const uint16_t localPort = QueryLocalPort(hRequest);
+    {
+        std::lock_guard<std::mutex> lock(_poolMutex);
+        ++connection->requestCount;
+        const bool reused = localPort != 0 && !connection->localPorts.insert(localPort).second;
+        if (localPort != 0) {
+            connectionNote = " conn_port=" + std::to_string(localPort) + " conn_reused=" + std::string(reused ? "true" : "false");
+        }
+    }
+
     std::string body;
     for (;;) {
-        if (_cancelGeneration.load() != cancelGeneration) {
+        if (cancelToken.isCancelled()) {
             response->statusCode = InternalStatusCodes::CANCELLED_BY_USER;
             response->errorMessage = "cancelled";
             break;
@@ -435,8 +672,8 @@ NHttpResponsePtr NakamaIPv4HttpTransport::performRequest(
     }
 
     WinHttpCloseHandle(hRequest);
-    WinHttpCloseHandle(hConnect);
-    WinHttpCloseHandle(hSession);
+    // A cancelled read leaves unread bytes on the socket; WinHTTP discards that socket itself
+    releaseConnection(connection, response->errorMessage.empty() || response->statusCode == InternalStatusCodes::CANCELLED_BY_USER);
 
     finishWithLog(response->errorMessage.empty() ? "ok" : "error", response->statusCode);
     return response;
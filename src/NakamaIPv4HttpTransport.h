@@ -1,26 +1,49 @@
 #pragma once
 
 #include "nakama-cpp/NHttpTransportInterface.h"
+#include "HttpRequestQueue.h"
 #include <atomic>
 #include <chrono>
+#include <memory>
 #include <mutex>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 namespace Nakama {
 
 class NakamaIPv4HttpTransport final : public NHttpTransportInterface, public std::enable_shared_from_this<NakamaIPv4HttpTransport> {
 public:
-    explicit NakamaIPv4HttpTransport(bool forceIPv4);
+    // Requests run on workerCount I/O threads; at most queueCapacity wait for one (see
+    // HttpRequestQueue for the priority and backpressure rules).
+    explicit NakamaIPv4HttpTransport(bool forceIPv4, size_t workerCount = 4, size_t queueCapacity = 64);
     ~NakamaIPv4HttpTransport() override = default;
 
+    // Requests to the same scheme/host/port share one WinHTTP session, so their sockets stay
+    // open between RPCs (keep-alive) instead of paying a TCP/TLS handshake each time. At most
+    // maxConnectionsPerHost sockets are opened per host; a host whose connections sat unused for
+    // idleTimeout is closed. keepAlive=false restores one session per request.
+    void setConnectionPoolLimits(uint32_t maxConnectionsPerHost, std::chrono::milliseconds idleTimeout, bool keepAlive = true);
+
     void setBaseUri(const std::string& uri) override;
     void setTimeout(std::chrono::milliseconds time) override;
     void tick() override;
     void request(const NHttpRequest& req, const NHttpResponseCallback& callback = nullptr) override;
     void cancelAllRequests() override;
 
+    // request() that returns an id for cancelRequest (0 when the transport is not owned by a
+    // shared_ptr and the callback already ran with an error).
+    uint64_t submitRequest(const NHttpRequest& req, const NHttpResponseCallback& callback = nullptr);
+    // Cancels one request: still queued, it is dropped; running, its WinHTTP calls stop at the
+    // next check. Either way its callback gets CANCELLED_BY_USER. False once it has finished.
+    bool cancelRequest(uint64_t requestId);
+
+    HttpRequestQueueStats getQueueStats() const;
+
+    // auth > gameplay > cosmetic, from the request path (and the RPC id for /v2/rpc/).
+    static HttpRequestPriority classifyRequestPriority(const NHttpRequest& req);
+
 private:
     struct PendingCallback {
         NHttpResponseCallback callback;
@@ -40,7 +63,27 @@ private:
         const NHttpRequest& req,
         const std::string& baseUri,
         std::chrono::milliseconds timeout,
-        uint64_t cancelGeneration) const;
+        const HttpCancelToken& cancelToken) const;
+    void deliverResponse(const NHttpResponseCallback& callback, const NHttpResponsePtr& response, uint64_t cancelGeneration);
+    void forgetRequest(uint64_t requestId);
+
+    // Pooled WinHTTP session + connect handle for one host. Closed (with its keep-alive
+    // sockets) when the last owner lets go: the pool, or a request still in flight.
+    struct HostConnection {
+        void* session = nullptr; // HINTERNET
+        void* connect = nullptr; // HINTERNET
+        std::string key;
+        std::chrono::steady_clock::time_point lastUsed;
+        uint64_t requestCount = 0;
+        std::unordered_set<uint16_t> localPorts; // sockets seen, to tell a reused one
+
+        ~HostConnection();
+    };
+    using HostConnectionPtr = std::shared_ptr<HostConnection>;
+
+    HostConnectionPtr acquireConnection(const ParsedBaseUri& base, std::string* outError) const;
+    void releaseConnection(const HostConnectionPtr& connection, bool reusable) const;
+    void evictIdleConnections(std::chrono::steady_clock::time_point now) const;
 
     ParsedBaseUri parseBaseUri(const std::string& uri) const;
     std::string buildObjectPath(const ParsedBaseUri& base, const NHttpRequest& req) const;
@@ -61,8 +104,21 @@ private:
     mutable std::mutex _resolverMutex;
     mutable std::unordered_map<std::string, std::string> _ipv4Cache;
 
+    mutable std::mutex _poolMutex;
+    mutable std::unordered_map<std::string, HostConnectionPtr> _connections;
+    uint32_t _maxConnectionsPerHost = 4;
+    std::chrono::milliseconds _idleTimeout{30000};
+    bool _keepAlive = true;
+
     std::mutex _pendingMutex;
     std::vector<PendingCallback> _pendingCallbacks;
+
+    // Tokens of requests not yet finished, for cancelRequest
+    std::mutex _activeMutex;
+    std::unordered_map<uint64_t, HttpCancelTokenPtr> _activeRequests;
+
+    // Last member: its workers are told to stop before the state they use goes away
+    std::unique_ptr<HttpRequestQueue> _requestQueue;
 };
 
 } // namespace Nakama
@@ -141,6 +141,16 @@ bool IsTruthyEnv(const char* value) {
     return lower == "1" || lower == "true" || lower == "yes" || lower == "on";
 }
 
+uint32_t EnvUint(const char* value, uint32_t fallback) {
+    if (!value || !*value) return fallback;
+    try {
+        const long long parsed = std::stoll(TrimCopy(value));
+        return parsed >= 0 ? static_cast<uint32_t>(std::min<long long>(parsed, 0xFFFFFFFFll)) : fallback;
+    } catch (...) {
+        return fallback;
+    }
+}
+
 } // namespace
 
 std::string NakamaManager::escapeJson(const std::string& value) {
@@ -424,7 +434,17 @@ void NakamaManager::init(const std::string& host, int port, const std::string& s
         AppLogger::LogNetwork("[INIT#" + std::to_string(reqId) + "] createRestClient(custom_http_transport)...");
         
         try {
-            _httpTransport = std::make_shared<NakamaIPv4HttpTransport>(forceIPv4);
+            const uint32_t workers = std::max(1u, EnvUint(std::getenv("NDG_NAKAMA_HTTP_WORKERS"), 4));
+            const uint32_t queueMax = std::max(1u, EnvUint(std::getenv("NDG_NAKAMA_HTTP_QUEUE_MAX"), 64));
+            auto transport = std::make_shared<NakamaIPv4HttpTransport>(forceIPv4, workers, queueMax);
+            const uint32_t maxConns = EnvUint(std::getenv("NDG_NAKAMA_HTTP_MAX_CONNS"), 4);
+            const uint32_t idleMs = EnvUint(std::getenv("NDG_NAKAMA_HTTP_IDLE_MS"), 30000);
+            const bool keepAlive = !IsTruthyEnv(std::getenv("NDG_NAKAMA_HTTP_DISABLE_KEEPALIVE"));
+            transport->setConnectionPoolLimits(maxConns, std::chrono::milliseconds(idleMs), keepAlive);
+            AppLogger::LogNetwork("[INIT#" + std::to_string(reqId) + "] http_pool max_conns=" + std::to_string(maxConns) +
+                " idle_ms=" + std::to_string(idleMs) + " keep_alive=" + BoolText(keepAlive) +
+                " workers=" + std::to_string(workers) + " queue_max=" + std::to_string(queueMax));
+            _httpTransport = transport;
             _client = createRestClient(_params, _httpTransport);
         } catch (const std::bad_alloc& e) {
              AppLogger::Log("Nakama CRITICAL (Std::bad_alloc): " + std::string(e.what()));
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "AssetPack.h"
+#include "TextureDirectoryIndex.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <vector>
+
+namespace RealSpace3 {
+
+// Bytes of one asset. Packed uncompressed entries point straight into the pack
+// mapping; everything else points into a buffer owned by the view.
+struct AssetView {
+    const uint8_t* data = nullptr;
+    size_t size = 0;
+    std::string diskPath;              // set when served from a loose file
+    std::shared_ptr<const void> owner; // keeps the mapping or the buffer alive
+};
+
+// Virtual filesystem over the rs3 asset root ("scenes/<id>/world.bin",
+// "models/<id>/model.json", ...). Mounts are searched in mount order; the
+// default roots (system/rs3 under the working directory and the usual
+// OpenGunZ-Client locations) are mounted on first use, each as its *.rs3pak
+// files followed by the loose directory. Paths are case-insensitive and may
+// carry the "vfs:" prefix that packed packages use as their base directory.
+// Safe to use from loader and texture worker threads.
+class AssetFileSystem {
+public:
+    static constexpr const char* kVirtualPrefix = "vfs:";
+
+    static AssetFileSystem& getInstance() {
+        static AssetFileSystem instance;
+        return instance;
+    }
+
+    bool MountPack(const std::string& packPath, std::string* outError = nullptr);
+    bool MountDirectory(const std::string& directory, std::string* outError = nullptr);
+    // Idempotent; called implicitly by the lookups below.
+    void MountDefaultRoots();
+
+    bool Exists(const std::string& path);
+    bool Open(const std::string& path, AssetView& outView, std::string* outError = nullptr);
+    bool ReadFile(const std::string& path, std::vector<uint8_t>& outBytes, std::string* outError = nullptr);
+    // Forgets cached listings of loose directories (after tools rewrite them).
+    void InvalidateLooseIndex();
+
+    size_t GetMountCount() const;
+
+    static bool IsVirtualPath(const std::string& path);
+    // "vfs:" + normalized directory; used as a package base directory when served from a pack.
+    static std::string MakeVirtualPath(const std::string& path);
+
+private:
+    AssetFileSystem() = default;
+
+    struct Mount {
+        std::shared_ptr<const AssetPack> pack;
+        std::string directory; // loose mounts only
+    };
+
+    bool FindLoose(const std::string& directory, const std::string& key, std::string& outDiskPath);
+
+    mutable std::shared_mutex m_mutex;
+    std::vector<Mount> m_mounts;
+    TextureDirectoryIndex m_looseIndex;
+    std::once_flag m_defaultRootsOnce;
+};
+
+} // namespace RealSpace3
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace RealSpace3 {
+
+class MappedFile;
+
+enum class AssetPackCompression : uint8_t {
+    None = 0,
+    LZ4 = 1, // LZ4 block format, one block per entry
+};
+
+struct AssetPackEntryInfo {
+    std::string path;      // normalized (see TextureDirectoryIndex::Normalize)
+    uint64_t size = 0;     // uncompressed
+    uint64_t storedSize = 0;
+    AssetPackCompression compression = AssetPackCompression::None;
+};
+
+// Read-only, memory-mapped single-file archive (*.rs3pak, layout in docs/rs3_pack_v1.md).
+// The table of contents is an open-addressed hash table keyed by FNV-1a of the
+// normalized path, so lookups never touch the disk. Uncompressed entries are
+// returned as pointers into the mapping. Immutable after Open; safe to query
+// from any thread.
+class AssetPack {
+public:
+    static constexpr const char* kFileExtension = ".rs3pak";
+    static constexpr uint32_t kInvalidEntry = 0xFFFFFFFFu;
+
+    AssetPack();
+    ~AssetPack();
+    AssetPack(const AssetPack&) = delete;
+    AssetPack& operator=(const AssetPack&) = delete;
+
+    bool Open(const std::string& packPath, std::string* outError = nullptr);
+    void Close();
+    bool IsOpen() const { return m_base != nullptr; }
+    const std::string& GetPath() const { return m_path; }
+
+    uint32_t GetEntryCount() const { return m_entryCount; }
+    // Index of the entry for normalizedPath, or kInvalidEntry.
+    uint32_t Find(const std::string& normalizedPath) const;
+    bool GetEntryInfo(uint32_t index, AssetPackEntryInfo& outInfo) const;
+    // Bytes inside the mapping for uncompressed entries; nullptr for compressed ones.
+    const uint8_t* GetMappedData(uint32_t index, size_t& outSize) const;
+    // Copies (or decompresses) the entry.
+    bool Read(uint32_t index, std::vector<uint8_t>& outBytes, std::string* outError = nullptr) const;
+
+    static uint64_t HashPath(const std::string& normalizedPath);
+    // Decodes one LZ4 block; fails unless it expands to exactly dstSize bytes.
+    static bool DecompressLZ4Block(const uint8_t* src, size_t srcSize, uint8_t* dst, size_t dstSize);
+
+private:
+    std::string m_path;
+    std::unique_ptr<MappedFile> m_mapping;
+    const uint8_t* m_base = nullptr;
+    size_t m_size = 0;
+    const uint8_t* m_entries = nullptr;
+    const uint32_t* m_slots = nullptr;
+    const char* m_strings = nullptr;
+    size_t m_stringsSize = 0;
+    uint32_t m_entryCount = 0;
+    uint32_t m_slotMask = 0;
+};
+
+} // namespace RealSpace3
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "CinematicTimeline.h"
+#include "WavFile.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace RealSpace3 {
+
+// Offline mixer for timeline audio clips: interleaved stereo float PCM at one sample rate.
+// Placement is sample-accurate (a clip starting at startSec begins at frame
+// round(startSec * sampleRate)) and fades are linear gain ramps, so the mix of a timeline is
+// the same whatever block size it is rendered in.
+class RS3AudioMixer {
+public:
+    explicit RS3AudioMixer(uint32_t sampleRate = 48000);
+
+    uint32_t GetSampleRate() const { return m_sampleRate; }
+    size_t GetClipCount() const { return m_clips.size(); }
+    // One past the last frame any clip writes.
+    uint64_t GetEndFrame() const { return m_endFrame; }
+
+    // Stereo at sampleRate: mono is duplicated, more than two channels keep the first two, and
+    // other rates are resampled linearly.
+    static void ConvertToStereo(const RS3AudioBuffer& source, uint32_t sampleRate, RS3AudioBuffer& outBuffer);
+
+    // source must be stereo at the mixer rate (see ConvertToStereo); it is shared, not copied.
+    bool AddClip(const RS3TimelineAudioClip& clip, std::shared_ptr<const RS3AudioBuffer> source, std::string* outError = nullptr);
+
+    // Overwrites outStereo (frameCount * 2 floats) with frames [startFrame, startFrame + frameCount).
+    void Render(uint64_t startFrame, uint64_t frameCount, float* outStereo) const;
+
+private:
+    struct Clip {
+        std::shared_ptr<const RS3AudioBuffer> source;
+        uint64_t sourceFrame = 0;  // first source frame played (trim)
+        uint64_t startFrame = 0;   // on the timeline
+        uint64_t frameCount = 0;
+        float gain = 1.0f;
+        uint64_t fadeInEnd = 0;    // clip-local frame where the fade-in reaches its peak
+        uint64_t fadeOutStart = 0; // clip-local frame where the fade-out begins
+        float fadeInStep = 0.0f;   // per-frame envelope slope, 1 / fade length
+        float fadeOutStep = 0.0f;
+    };
+
+    void MixClip(const Clip& clip, uint64_t startFrame, uint64_t frameCount, float* outStereo) const;
+
+    uint32_t m_sampleRate = 48000;
+    std::vector<Clip> m_clips;
+    uint64_t m_endFrame = 0;
+};
+
+// Audio frames that cover the exported video: GetTimelineFrameCount(durationSec, fps) frames
+// at fps, rounded to the nearest sample.
+uint64_t GetTimelineAudioFrameCount(float durationSec, int fps, uint32_t sampleRate);
+
+// Loads every clip of the timeline (GetTimelineAudioClips; WAV files, each file read once) and
+// renders frameCount frames of the mix.
+bool RenderTimelineAudio(const RS3TimelineAudio& audio, uint64_t frameCount, uint32_t sampleRate,
+                         RS3AudioBuffer& outBuffer, std::string* outError = nullptr);
+
+} // namespace RealSpace3
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace RealSpace3 {
+
+// Block-compressed formats decodable on the CPU. Output follows D3D sampling:
+// BC4 -> (r, 0, 0, 255), BC5 -> (r, g, 0, 255).
+enum class BCnFormat : uint8_t {
+    BC1,
+    BC2,
+    BC3,
+    BC4,
+    BC5,
+    BC7
+};
+
+// Portable BCn -> RGBA8 decoder (no D3D/Windows dependency) for thumbnails,
+// tooling and CPU fallbacks. BC1-BC5 blocks are expanded with SSE2 where
+// available; BC7 is decoded bit-exact in scalar code. Large images are split
+// into bands of block rows decoded on worker threads.
+class BCnDecoder {
+public:
+    static constexpr uint32_t kBlockDim = 4;
+    static constexpr uint32_t kMinBlockRowsPerThread = 16;
+
+    static size_t GetBlockBytes(BCnFormat format);
+    static size_t GetCompressedSize(BCnFormat format, uint32_t width, uint32_t height);
+    static bool HasSimd();
+
+    // Decodes a single block into 4x4 RGBA8 texels, row-major (64 bytes).
+    static void DecodeBlock(BCnFormat format, const uint8_t* block, uint8_t* outRGBA);
+
+    // threadCount 0 uses hardware concurrency; small images always decode on the calling thread.
+    static bool Decode(BCnFormat format, uint32_t width, uint32_t height, const uint8_t* data, size_t dataSize,
+                       uint8_t* outRGBA, size_t outRowPitch, uint32_t threadCount = 0, std::string* outError = nullptr);
+    static bool Decode(BCnFormat format, uint32_t width, uint32_t height, const uint8_t* data, size_t dataSize,
+                       std::vector<uint8_t>& outRGBA, uint32_t threadCount = 0, std::string* outError = nullptr);
+};
+
+} // namespace RealSpace3
@@ -1,41 +1,56 @@
 #pragma once
 
 #include "CinematicTimeline.h"
+#include "CompiledTimeline.h"
+#include "TimelineTracks.h"
 
 #include <DirectXMath.h>
 
 #include <algorithm>
+#include <memory>
+#include <vector>
 
 namespace RealSpace3 {
 
 class CinematicPlayer {
 public:
+    // Compiles the timeline in memory, then plays it.
     bool Play(const RS3TimelineData& timeline, const RS3TimelinePlaybackOptions& options, std::string* outError = nullptr);
+    bool Play(std::shared_ptr<const RS3CompiledTimeline> timeline, const RS3TimelinePlaybackOptions& options, std::string* outError = nullptr);
     void Stop();
     void Pause(bool paused);
     void Seek(float timeSec);
     void Update(float deltaTimeSec);
     bool EvaluateCameraPose(RS3CameraPose& outPose) const;
+    // Transform, light, fog and clip track values at the current time.
+    bool EvaluateTracks(RS3TimelineTrackFrame& outFrame) const;
 
     bool IsPlaying() const { return m_playing; }
     bool HasTimeline() const { return m_hasTimeline; }
     float GetCurrentTime() const { return m_currentTimeSec; }
     float GetDuration() const { return m_durationSec; }
-    int GetFps() const { return std::max(1, m_timeline.fps); }
-    const RS3TimelineData& GetTimeline() const { return m_timeline; }
+    int GetFps() const { return m_timeline ? m_timeline->GetFps() : 60; }
+    const std::shared_ptr<const RS3CompiledTimeline>& GetTimeline() const { return m_timeline; }
 
 private:
-    static float ApplyEase(float t, RS3TimelineEase ease);
-    static DirectX::XMFLOAT3 CatmullRom(
-        const DirectX::XMFLOAT3& p0,
-        const DirectX::XMFLOAT3& p1,
-        const DirectX::XMFLOAT3& p2,
-        const DirectX::XMFLOAT3& p3,
-        float t);
-    static DirectX::XMVECTOR BuildCameraQuaternion(const RS3TimelineKeyframe& keyframe);
+    // Position over one segment as a cubic in the eased parameter:
+    // ((c3 * u + c2) * u + c1) * u + c0, expanded once from the Hermite form.
+    struct SegmentCurve {
+        DirectX::XMFLOAT3 c0;
+        DirectX::XMFLOAT3 c1;
+        DirectX::XMFLOAT3 c2;
+        DirectX::XMFLOAT3 c3;
+    };
+
+    void BuildSegmentCurves();
+    // Segment containing t; checks the cached segment and its successor before a binary search.
+    size_t FindSegment(float t) const;
 
 private:
-    RS3TimelineData m_timeline;
+    std::shared_ptr<const RS3CompiledTimeline> m_timeline;
+    std::vector<SegmentCurve> m_curves;
+    mutable size_t m_segmentCursor = 0;
+    mutable RS3TimelineTrackEvaluator m_tracks;
     RS3TimelinePlaybackOptions m_options;
     bool m_hasTimeline = false;
     bool m_playing = false;
@@ -4,7 +4,9 @@
 
 #include <DirectXMath.h>
 
+#include <cstdint>
 #include <string>
+#include <string_view>
 #include <vector>
 
 namespace RealSpace3 {
@@ -23,13 +25,84 @@ struct RS3TimelineKeyframe {
     RS3TimelineEase ease = RS3TimelineEase::Linear;
 };
 
+enum class RS3TimelineTrackType : uint32_t {
+    Transform = 0,   // model placement: position, rotation, uniform scale
+    Light = 1,       // scene key light color and intensity
+    Fog = 2,         // fog range and color
+    ClipTrigger = 3, // starts an animation clip on the target model
+};
+
+struct RS3TimelineTransformKey {
+    float t = 0.0f;
+    DirectX::XMFLOAT3 position = { 0.0f, 0.0f, 0.0f };
+    DirectX::XMFLOAT3 rotationDeg = { 0.0f, 0.0f, 0.0f }; // about X, then Y, then Z (world axes)
+    float scale = 1.0f;
+    RS3TimelineEase ease = RS3TimelineEase::Linear;
+};
+
+struct RS3TimelineLightKey {
+    float t = 0.0f;
+    DirectX::XMFLOAT3 color = { 1.0f, 1.0f, 1.0f };
+    float intensity = 1.0f;
+    RS3TimelineEase ease = RS3TimelineEase::Linear;
+};
+
+struct RS3TimelineFogKey {
+    float t = 0.0f;
+    float fogMin = 1000.0f;
+    float fogMax = 7000.0f;
+    DirectX::XMFLOAT3 color = { 1.0f, 1.0f, 1.0f };
+    RS3TimelineEase ease = RS3TimelineEase::Linear;
+};
+
+struct RS3TimelineClipKey {
+    float t = 0.0f;
+    std::string clip;
+    float speed = 1.0f;
+    bool loop = false;
+};
+
+// Authoring form of one track; only the key list matching `type` is used.
+struct RS3TimelineTrack {
+    RS3TimelineTrackType type = RS3TimelineTrackType::Transform;
+    std::string name;
+    std::string target; // model id (transform and clip tracks)
+    std::vector<RS3TimelineTransformKey> transformKeys;
+    std::vector<RS3TimelineLightKey> lightKeys;
+    std::vector<RS3TimelineFogKey> fogKeys;
+    std::vector<RS3TimelineClipKey> clipKeys;
+};
+
+const char* ToTimelineTrackTypeString(RS3TimelineTrackType type);
+bool ParseTimelineTrackTypeString(const std::string& value, RS3TimelineTrackType& outType);
+// Eased segment parameter; the ease of the key that ends the segment applies.
+float ApplyTimelineEase(float t, RS3TimelineEase ease);
+
+// One audio clip on the timeline. The clip plays file samples from trimInSec on, starting at
+// startSec, for durationSec (0 = to the end of the file); fades are linear in amplitude.
+struct RS3TimelineAudioClip {
+    std::string file;
+    float startSec = 0.0f;
+    float trimInSec = 0.0f;
+    float durationSec = 0.0f;
+    float gainDb = 0.0f;
+    float fadeInSec = 0.0f;
+    float fadeOutSec = 0.0f;
+};
+
+// `file`/`offsetSec`/`gainDb` is the original single-track form (a positive offset delays the
+// file, a negative one skips into it); `clips` are mixed on top of it.
 struct RS3TimelineAudio {
     bool enabled = false;
     std::string file;
     float offsetSec = 0.0f;
     float gainDb = 0.0f;
+    std::vector<RS3TimelineAudioClip> clips;
 };
 
+// Every clip the mixer plays: the single-track file (when enabled) as a clip, then `clips`.
+std::vector<RS3TimelineAudioClip> GetTimelineAudioClips(const RS3TimelineAudio& audio);
+
 struct RS3TimelineData {
     std::string version = "ndg_cine_v1";
     std::string sceneId;
@@ -37,9 +110,21 @@ struct RS3TimelineData {
     float durationSec = 0.0f;
     int fps = 60;
     std::vector<RS3TimelineKeyframe> keyframes;
+    std::vector<RS3TimelineTrack> tracks;
     RS3TimelineAudio audio;
 };
 
+// Frame sampling shared by the exporters: ceil(durationSec * fps) frames (at least one), frame i
+// at i / fps. Times are computed per frame rather than accumulated, so every tool samples the
+// same instants.
+int GetTimelineFrameCount(float durationSec, int fps);
+float GetTimelineFrameTime(int frame, int fps);
+
+// Finds a timeline on disk: as given, under the working directory or under
+// system/rs3/cinematics, with ".ndgcine.json" appended when the path has no extension.
+bool ResolveTimelineFile(const std::string& timelinePath, std::string& outResolvedPath);
 bool LoadTimelineFromFile(const std::string& timelinePath, RS3TimelineData& outTimeline, std::string* outError = nullptr);
+// Parses and validates timeline JSON already in memory (LoadTimelineFromFile minus the read).
+bool ParseTimelineJson(std::string_view json, RS3TimelineData& outTimeline, std::string* outError = nullptr);
 
 } // namespace RealSpace3
@@ -0,0 +1,174 @@
+#pragma once
+
+#include "CinematicTimeline.h"
+
+#include <DirectXMath.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace RealSpace3 {
+
+// One camera keyframe as stored in a compiled timeline (64 bytes, layout in docs/ndg_cine_bin.md).
+struct RS3CompiledKeyframe {
+    float t = 0.0f;
+    DirectX::XMFLOAT3 position = { 0.0f, 0.0f, 0.0f };
+    DirectX::XMFLOAT3 target = { 0.0f, 1.0f, 0.0f };
+    float rollDeg = 0.0f;
+    float fovDeg = 60.0f;
+    uint32_t ease = 0;                                         // RS3TimelineEase
+    DirectX::XMFLOAT4 rotation = { 0.0f, 0.0f, 0.0f, 1.0f };   // camera quaternion (see BuildTimelineCameraRotation)
+    float targetDistance = 1.0f;                               // max(1, |target - position|)
+    uint32_t reserved = 0;
+};
+
+// Segment i runs from keyframe i to keyframe i + 1 (32 bytes). The tangents are the
+// Catmull-Rom ones, (p[i+1] - p[i-1]) / 2 and (p[i+2] - p[i]) / 2 with the end keys repeated,
+// so the position is a cubic Hermite curve over the eased segment parameter.
+struct RS3CompiledSegment {
+    DirectX::XMFLOAT3 tangentStart = { 0.0f, 0.0f, 0.0f };
+    DirectX::XMFLOAT3 tangentEnd = { 0.0f, 0.0f, 0.0f };
+    float invDuration = 0.0f;
+    uint32_t reserved = 0;
+};
+
+// Track table entry (32 bytes). Keys are one contiguous block of the type's key struct;
+// names are offsets into the string section.
+struct RS3CompiledTrack {
+    uint32_t type = 0; // RS3TimelineTrackType
+    uint32_t keyCount = 0;
+    uint32_t keysOffset = 0;
+    uint32_t nameOffset = 0;
+    uint32_t nameLength = 0;
+    uint32_t targetOffset = 0;
+    uint32_t targetLength = 0;
+    uint32_t reserved = 0;
+};
+
+struct RS3CompiledTransformKey {
+    float t = 0.0f;
+    DirectX::XMFLOAT3 position = { 0.0f, 0.0f, 0.0f };
+    DirectX::XMFLOAT4 rotation = { 0.0f, 0.0f, 0.0f, 1.0f }; // from rotationDeg
+    float scale = 1.0f;
+    uint32_t ease = 0;
+};
+
+struct RS3CompiledLightKey {
+    float t = 0.0f;
+    DirectX::XMFLOAT3 color = { 1.0f, 1.0f, 1.0f };
+    float intensity = 1.0f;
+    uint32_t ease = 0;
+};
+
+struct RS3CompiledFogKey {
+    float t = 0.0f;
+    float fogMin = 1000.0f;
+    float fogMax = 7000.0f;
+    DirectX::XMFLOAT3 color = { 1.0f, 1.0f, 1.0f };
+    uint32_t ease = 0;
+    uint32_t reserved = 0;
+};
+
+struct RS3CompiledClipKey {
+    float t = 0.0f;
+    uint32_t clipOffset = 0;
+    uint32_t clipLength = 0;
+    float speed = 1.0f;
+    uint32_t loop = 0;
+};
+
+// Audio clip table entry (32 bytes); the file name is in the string section.
+struct RS3CompiledAudioClip {
+    uint32_t fileOffset = 0;
+    uint32_t fileLength = 0;
+    float startSec = 0.0f;
+    float trimInSec = 0.0f;
+    float durationSec = 0.0f;
+    float gainDb = 0.0f;
+    float fadeInSec = 0.0f;
+    float fadeOutSec = 0.0f;
+};
+
+static_assert(sizeof(RS3CompiledKeyframe) == 64, "RS3CompiledKeyframe must match the ndg_cine_bin layout");
+static_assert(sizeof(RS3CompiledSegment) == 32, "RS3CompiledSegment must match the ndg_cine_bin layout");
+static_assert(sizeof(RS3CompiledTrack) == 32, "RS3CompiledTrack must match the ndg_cine_bin layout");
+static_assert(sizeof(RS3CompiledTransformKey) == 40, "RS3CompiledTransformKey must match the ndg_cine_bin layout");
+static_assert(sizeof(RS3CompiledLightKey) == 24, "RS3CompiledLightKey must match the ndg_cine_bin layout");
+static_assert(sizeof(RS3CompiledFogKey) == 32, "RS3CompiledFogKey must match the ndg_cine_bin layout");
+static_assert(sizeof(RS3CompiledClipKey) == 20, "RS3CompiledClipKey must match the ndg_cine_bin layout");
+static_assert(sizeof(RS3CompiledAudioClip) == 32, "RS3CompiledAudioClip must match the ndg_cine_bin layout");
+
+// Camera orientation for a keyframe: +Y rotated onto (target - position), then rolled
+// around that direction by rollDeg.
+DirectX::XMFLOAT4 BuildTimelineCameraRotation(const DirectX::XMFLOAT3& position, const DirectX::XMFLOAT3& target, float rollDeg);
+
+// Playback-ready form of an ndg_cine_v1 timeline (*.ndgcine.bin): keyframes sorted by time
+// with their rotations and the segment tangents precomputed, plus the typed tracks with
+// sorted, fixed-size keys. Opened files are memory-mapped and read in place, so starting
+// playback costs no parsing, sorting or copying. Immutable once loaded; safe to share
+// between players.
+class RS3CompiledTimeline {
+public:
+    static constexpr const char* kFileExtension = ".ndgcine.bin";
+    static constexpr uint32_t kFormatVersion = 3;
+
+    // Produces the file image for a timeline (sorting copies of its keyframes and track keys).
+    static bool Compile(const RS3TimelineData& timeline, std::vector<uint8_t>& outBytes, std::string* outError = nullptr);
+    static bool WriteFile(const RS3TimelineData& timeline, const std::string& filePath, std::string* outError = nullptr);
+    // "<name>.ndgcine.json" -> "<name>.ndgcine.bin"
+    static std::string GetCompiledPath(const std::string& timelinePath);
+
+    bool Open(const std::string& filePath, std::string* outError = nullptr);
+    bool LoadFromTimeline(const RS3TimelineData& timeline, std::string* outError = nullptr);
+
+    bool IsLoaded() const { return m_keyframes != nullptr; }
+    std::string_view GetSceneId() const { return m_sceneId; }
+    RS3RenderMode GetMode() const { return m_mode; }
+    float GetDurationSec() const { return m_durationSec; }
+    int GetFps() const { return m_fps; }
+    uint32_t GetKeyframeCount() const { return m_keyframeCount; }
+    const RS3CompiledKeyframe* GetKeyframes() const { return m_keyframes; }
+    // GetKeyframeCount() - 1 entries.
+    const RS3CompiledSegment* GetSegments() const { return m_segments; }
+    const RS3TimelineAudio& GetAudio() const { return m_audio; }
+
+    uint32_t GetTrackCount() const { return m_trackCount; }
+    const RS3CompiledTrack* GetTracks() const { return m_tracks; }
+    std::string_view GetString(uint32_t offset, uint32_t length) const { return m_strings.substr(offset, length); }
+    // Key block of a track; Key must be the compiled key struct of track.type.
+    template <typename Key>
+    const Key* GetTrackKeys(const RS3CompiledTrack& track) const {
+        return reinterpret_cast<const Key*>(m_base + track.keysOffset);
+    }
+
+    // Editable copy (the studio reopens compiled files through this).
+    void ToTimelineData(RS3TimelineData& outTimeline) const;
+
+private:
+    bool Attach(std::shared_ptr<const void> owner, const uint8_t* data, size_t size, std::string* outError);
+
+    std::shared_ptr<const void> m_owner; // MappedFile or byte buffer
+    const uint8_t* m_base = nullptr;
+    std::string_view m_strings;
+    std::string_view m_sceneId;
+    RS3RenderMode m_mode = RS3RenderMode::MapOnlyCinematic;
+    float m_durationSec = 0.0f;
+    int m_fps = 60;
+    uint32_t m_keyframeCount = 0;
+    const RS3CompiledKeyframe* m_keyframes = nullptr;
+    const RS3CompiledSegment* m_segments = nullptr;
+    RS3TimelineAudio m_audio;
+    uint32_t m_trackCount = 0;
+    const RS3CompiledTrack* m_tracks = nullptr;
+};
+
+// Resolves timelinePath like LoadTimelineFromFile. A compiled sibling at least as new as the
+// JSON is mapped directly; otherwise the JSON is parsed and compiled in memory. A path that
+// names a *.ndgcine.bin file is mapped as is.
+bool LoadCompiledTimeline(const std::string& timelinePath, std::shared_ptr<const RS3CompiledTimeline>& outTimeline, std::string* outError = nullptr);
+
+} // namespace RealSpace3
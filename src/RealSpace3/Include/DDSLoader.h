@@ -2,14 +2,56 @@
 #ifndef NOMINMAX
 #define NOMINMAX
 #endif
+#include "DDSParser.h"
 #include <d3d11.h>
 #include <wrl/client.h>
+#include <memory>
 #include <string>
 #include <cstdint>
+#include <vector>
 
 namespace RealSpace3 {
 
-// Minimal DDS loader for GunZ texture formats (DXT1, DXT3, DXT5, uncompressed BGRA)
+struct DecodedTextureSubresource {
+    size_t offset = 0;
+    uint32_t rowPitch = 0;
+    uint32_t slicePitch = 0;
+};
+
+// CPU-side result of a decode; safe to produce on any thread and upload later.
+struct DecodedTexture {
+    uint32_t width = 0;
+    uint32_t height = 0;
+    uint32_t mipLevels = 1;
+    uint32_t arraySize = 1;    // cube faces count as slices
+    bool isCubemap = false;
+    DXGI_FORMAT format = DXGI_FORMAT_UNKNOWN;
+    std::vector<uint8_t> pixels;
+    // Zero-copy view: when set, subresource offsets index this caller-owned buffer
+    // (e.g. a mapped pack file) instead of pixels. It must outlive every upload,
+    // unless externalOwner holds it.
+    const uint8_t* externalData = nullptr;
+    std::shared_ptr<const void> externalOwner;
+    std::vector<DecodedTextureSubresource> subresources; // index = mip + slice * mipLevels
+
+    const uint8_t* GetData() const { return externalData ? externalData : pixels.data(); }
+    size_t GetSizeBytes() const {
+        if (!externalData) return pixels.size();
+        size_t bytes = 0;
+        for (const auto& sub : subresources) bytes += sub.slicePitch;
+        return bytes;
+    }
+    // Bytes of mips [firstMip, mipLevels) over all slices: what CreateFromDecoded(firstMip) uploads.
+    size_t GetSizeBytesFromMip(uint32_t firstMip) const {
+        size_t bytes = 0;
+        for (size_t i = 0; i < subresources.size(); ++i) {
+            if (mipLevels == 0 || i % mipLevels >= firstMip) bytes += subresources[i].slicePitch;
+        }
+        return bytes;
+    }
+};
+
+// DDS loader (layout parsing lives in DDSParser: BC1-BC7, sRGB, arrays, cubemaps, full mip chains)
 // Also supports BMP/PNG/TGA/JPG via WIC fallback
 class DDSLoader {
 public:
@@ -25,10 +67,35 @@ public:
         Microsoft::WRL::ComPtr<ID3D11ShaderResourceView>& outSRV
     );
 
-private:
-    static DXGI_FORMAT GetDXGIFormat(uint32_t fourCC, uint32_t rgbBitCount, uint32_t rMask, uint32_t gMask, uint32_t bMask, uint32_t aMask);
-    static size_t BitsPerPixel(DXGI_FORMAT fmt);
-    static void GetSurfaceInfo(size_t width, size_t height, DXGI_FORMAT fmt, size_t& numBytes, size_t& rowBytes, size_t& numRows);
+    // Creates a texture straight from a caller-owned DDS/PNG/... buffer, without temp files.
+    // DDS surfaces are uploaded from the buffer in place; it only has to live for this call.
+    static HRESULT CreateFromMemory(
+        ID3D11Device* device,
+        const uint8_t* data,
+        size_t size,
+        Microsoft::WRL::ComPtr<ID3D11ShaderResourceView>& outSRV
+    );
+
+    // Split path used by the streaming TextureManager: decode on a worker, create on the render thread.
+    static HRESULT DecodeFromFile(const std::wstring& filePath, DecodedTexture& outTexture);
+    static HRESULT DecodeWICFromFile(const std::wstring& filePath, DecodedTexture& outTexture);
+    // referenceSource keeps DDS surfaces in the caller's buffer (see DecodedTexture::externalData)
+    // instead of copying them; 24-bit and mip-generated textures are always copied.
+    static HRESULT DecodeFromMemory(const uint8_t* data, size_t size, DecodedTexture& outTexture, bool referenceSource = false);
+    static HRESULT DecodeWICFromMemory(const uint8_t* data, size_t size, DecodedTexture& outTexture);
+    // Copies the surfaces described by a parsed DDS out of the file bytes (expanding 24-bit data),
+    // or references them in place when referenceSource is set.
+    static HRESULT DecodeFromDDS(const uint8_t* fileData, const DDSInfo& info, DecodedTexture& outTexture, bool referenceSource = false);
+    // Builds a full box-filtered mip chain (linear light, alpha-weighted) for single-level
+    // 32-bit RGBA/BGRA textures. Returns S_FALSE when the texture is left unchanged.
+    static HRESULT GenerateMips(DecodedTexture& texture);
+    // firstMip > 0 creates a texture holding only mips [firstMip, mipLevels) (residency streaming).
+    static HRESULT CreateFromDecoded(
+        ID3D11Device* device,
+        const DecodedTexture& texture,
+        Microsoft::WRL::ComPtr<ID3D11ShaderResourceView>& outSRV,
+        uint32_t firstMip = 0
+    );
 };
 
 }
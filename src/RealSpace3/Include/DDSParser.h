@@ -0,0 +1,94 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace RealSpace3 {
+
+// Formats the DDS parser understands. Values match DXGI_FORMAT so the D3D side
+// can static_cast them; this header stays free of D3D/Windows includes.
+enum class DDSFormat : uint32_t {
+    Unknown = 0,
+    R32G32B32A32_FLOAT = 2,
+    R16G16B16A16_FLOAT = 10,
+    R16G16B16A16_UNORM = 11,
+    R8G8B8A8_UNORM = 28,
+    R8G8B8A8_UNORM_SRGB = 29,
+    R8G8_UNORM = 49,
+    R8_UNORM = 61,
+    A8_UNORM = 65,
+    BC1_UNORM = 71,
+    BC1_UNORM_SRGB = 72,
+    BC2_UNORM = 74,
+    BC2_UNORM_SRGB = 75,
+    BC3_UNORM = 77,
+    BC3_UNORM_SRGB = 78,
+    BC4_UNORM = 80,
+    BC4_SNORM = 81,
+    BC5_UNORM = 83,
+    BC5_SNORM = 84,
+    B5G6R5_UNORM = 85,
+    B5G5R5A1_UNORM = 86,
+    B8G8R8A8_UNORM = 87,
+    B8G8R8X8_UNORM = 88,
+    B8G8R8A8_UNORM_SRGB = 91,
+    B8G8R8X8_UNORM_SRGB = 93,
+    BC6H_UF16 = 95,
+    BC6H_SF16 = 96,
+    BC7_UNORM = 98,
+    BC7_UNORM_SRGB = 99,
+    B4G4R4A4_UNORM = 115
+};
+
+// One mip of one array slice (cube faces are slices). offset is relative to
+// the start of the file; rowPitch/slicePitch describe the layout after any
+// 24-bit expansion, sourceBytes the bytes actually stored in the file.
+struct DDSSurface {
+    uint32_t arraySlice = 0;
+    uint32_t mipLevel = 0;
+    uint32_t width = 0;
+    uint32_t height = 0;
+    size_t offset = 0;
+    size_t sourceBytes = 0;
+    uint32_t rowPitch = 0;
+    uint32_t slicePitch = 0;
+};
+
+struct DDSInfo {
+    uint32_t width = 0;
+    uint32_t height = 0;
+    uint32_t mipLevels = 1;
+    uint32_t arraySize = 1;    // cube faces included (6 per cube)
+    bool isCubemap = false;
+    bool hasDX10Header = false;
+    bool expand24Bit = false;  // legacy 24-bit RGB data; expanded to 32-bit with opaque alpha on load
+    DDSFormat format = DDSFormat::Unknown;
+    size_t dataOffset = 0;
+    // D3D subresource order: index = mipLevel + arraySlice * mipLevels.
+    std::vector<DDSSurface> surfaces;
+};
+
+// Header and surface-layout parsing for DDS files, independent of D3D.
+class DDSParser {
+public:
+    static constexpr uint32_t kMagic = 0x20534444; // "DDS "
+
+    static bool IsDDS(const uint8_t* data, size_t size);
+    // Fails for files that are not DDS, use unsupported formats (volume textures,
+    // partial cubemaps) or are truncated before the top mip of every slice.
+    // A truncated tail of the mip chain is dropped rather than rejected.
+    static bool Parse(const uint8_t* data, size_t size, DDSInfo& outInfo, std::string* outError = nullptr);
+
+    static bool IsBlockCompressed(DDSFormat format);
+    static bool IsSrgb(DDSFormat format);
+    static DDSFormat MakeSrgb(DDSFormat format);
+    static size_t BitsPerPixel(DDSFormat format);
+    static bool GetSurfaceInfo(uint32_t width, uint32_t height, DDSFormat format, size_t& outNumBytes, size_t& outRowBytes, size_t& outNumRows);
+
+    // Appends an opaque alpha byte to every 3-byte pixel (B,G,R -> B,G,R,255). src and dst must not overlap.
+    static void Expand24To32(const uint8_t* src, uint8_t* dst, size_t pixelCount);
+};
+
+} // namespace RealSpace3
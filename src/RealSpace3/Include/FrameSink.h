@@ -0,0 +1,192 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ImageEncoder.h"
+
+namespace RealSpace3 {
+
+// One captured frame: tightly packed BGRA8 rows, top row first.
+struct RS3CapturedFrame {
+    uint64_t index = 0;
+    uint32_t width = 0;
+    uint32_t height = 0;
+    std::vector<uint8_t> bgra;
+};
+
+// Consumer of captured frames. Open is called with the first frame's size; every later frame
+// has the same size and arrives in index order. Calls never overlap.
+class RS3FrameSink {
+public:
+    virtual ~RS3FrameSink() = default;
+
+    virtual bool Open(uint32_t width, uint32_t height, int fps, std::string* outError) = 0;
+    virtual bool WriteFrame(const RS3CapturedFrame& frame, std::string* outError) = 0;
+    virtual bool Close(std::string* outError) = 0;
+};
+
+// Streams raw BGRA frames into the stdin of a child process (ffmpeg -f rawvideo -i -).
+// The command is built once the frame size is known.
+class RS3FramePipeSink : public RS3FrameSink {
+public:
+    using CommandBuilder = std::function<std::string(uint32_t width, uint32_t height, int fps)>;
+
+    explicit RS3FramePipeSink(CommandBuilder buildCommand);
+    ~RS3FramePipeSink() override;
+
+    bool Open(uint32_t width, uint32_t height, int fps, std::string* outError) override;
+    bool WriteFrame(const RS3CapturedFrame& frame, std::string* outError) override;
+    // Closes the pipe and waits for the child; a non-zero exit code is an error.
+    bool Close(std::string* outError) override;
+
+    // "-f rawvideo -pix_fmt bgra -s WxH -r fps -i -"
+    static std::string BuildRawVideoInputArgs(uint32_t width, uint32_t height, int fps);
+
+private:
+    bool WriteBytes(const uint8_t* data, size_t size);
+
+    CommandBuilder m_buildCommand;
+#ifdef _WIN32
+    void* m_stdinWrite = nullptr; // HANDLE
+    void* m_process = nullptr;    // HANDLE
+#else
+    FILE* m_pipe = nullptr;
+#endif
+};
+
+struct RS3ImageSequenceStats {
+    uint64_t framesWritten = 0;
+    uint64_t encodedBytes = 0;
+    double encodeMs = 0.0;       // summed over encoder threads
+    double fileMs = 0.0;         // summed over encoder threads
+    double producerWaitMs = 0.0; // WriteFrame blocked with every slot in flight
+};
+
+// Writes each frame as <directory>/<prefix>_<index:06>.png|.qoi. Frames are encoded in parallel
+// on a fixed set of threads; WriteFrame copies into one of maxFramesInFlight slots and blocks
+// while all of them are still being encoded, so memory stays bounded. Slot and encode buffers
+// are reused across frames.
+class RS3ImageSequenceSink : public RS3FrameSink {
+public:
+    // threadCount 0 = hardware concurrency; maxFramesInFlight 0 = two per thread.
+    RS3ImageSequenceSink(std::string directory, std::string prefix, RS3ImageFormat format,
+        uint32_t threadCount = 0, uint32_t maxFramesInFlight = 0);
+    ~RS3ImageSequenceSink() override;
+
+    RS3ImageSequenceSink(const RS3ImageSequenceSink&) = delete;
+    RS3ImageSequenceSink& operator=(const RS3ImageSequenceSink&) = delete;
+
+    bool Open(uint32_t width, uint32_t height, int fps, std::string* outError) override;
+    // Fails once any earlier frame failed to encode or write.
+    bool WriteFrame(const RS3CapturedFrame& frame, std::string* outError) override;
+    // Waits for the frames in flight and joins the threads.
+    bool Close(std::string* outError) override;
+
+    uint32_t GetThreadCount() const { return m_threadCount; }
+    std::string GetFramePath(uint64_t index) const;
+    RS3ImageSequenceStats GetStats() const;
+
+private:
+    struct Slot {
+        RS3CapturedFrame frame;
+        std::vector<uint8_t> encoded;
+    };
+
+    void EncoderLoop();
+
+    std::string m_directory;
+    std::string m_prefix;
+    RS3ImageFormat m_format = RS3ImageFormat::Png;
+    uint32_t m_threadCount = 1;
+    uint32_t m_slotCount = 2;
+    std::vector<std::thread> m_threads;
+    mutable std::mutex m_mutex;
+    std::condition_variable m_jobReady;
+    std::condition_variable m_slotFree;
+    std::vector<std::unique_ptr<Slot>> m_freeSlots;
+    std::deque<std::unique_ptr<Slot>> m_jobs;
+    uint32_t m_busy = 0;
+    bool m_open = false;
+    bool m_closing = false;
+    bool m_failed = false;
+    std::string m_error;
+    RS3ImageSequenceStats m_stats;
+};
+
+// Keeps copies of the last N frames in memory (previews, tests, benchmarks).
+class RS3FrameRingSink : public RS3FrameSink {
+public:
+    explicit RS3FrameRingSink(uint32_t capacity);
+
+    bool Open(uint32_t width, uint32_t height, int fps, std::string* outError) override;
+    bool WriteFrame(const RS3CapturedFrame& frame, std::string* outError) override;
+    bool Close(std::string* outError) override;
+
+    // Oldest first.
+    std::vector<const RS3CapturedFrame*> GetFrames() const;
+    uint64_t GetFramesSeen() const { return m_framesSeen; }
+
+private:
+    std::vector<RS3CapturedFrame> m_ring;
+    size_t m_next = 0;
+    uint64_t m_framesSeen = 0;
+};
+
+struct RS3FrameWriterStats {
+    uint64_t framesWritten = 0;
+    double producerWaitMs = 0.0; // AcquireFrame blocked on a full pool
+    double sinkMs = 0.0;         // time inside the sink on the writer thread
+};
+
+// Hands frames from the render thread to a sink on a writer thread. Frame buffers come from a
+// fixed pool, so memory stays bounded: AcquireFrame blocks while every buffer is queued.
+class RS3FrameWriter {
+public:
+    RS3FrameWriter(RS3FrameSink& sink, uint32_t poolSize);
+    ~RS3FrameWriter();
+
+    RS3FrameWriter(const RS3FrameWriter&) = delete;
+    RS3FrameWriter& operator=(const RS3FrameWriter&) = delete;
+
+    bool Start(int fps, std::string* outError = nullptr);
+    // Free buffer from the pool (contents and size left from its last use), or null once the
+    // writer has failed.
+    std::unique_ptr<RS3CapturedFrame> AcquireFrame();
+    // Queues a frame for the sink. Returns false (and recycles the frame) after a failure.
+    bool SubmitFrame(std::unique_ptr<RS3CapturedFrame> frame);
+    // Writes everything queued, closes the sink and joins the thread.
+    bool Finish(std::string* outError = nullptr);
+
+    RS3FrameWriterStats GetStats() const;
+
+private:
+    void WriterLoop();
+
+    RS3FrameSink& m_sink;
+    int m_fps = 60;
+    std::thread m_thread;
+    mutable std::mutex m_mutex;
+    std::condition_variable m_queueChanged;
+    std::condition_variable m_poolChanged;
+    std::vector<std::unique_ptr<RS3CapturedFrame>> m_pool;
+    std::deque<std::unique_ptr<RS3CapturedFrame>> m_queue;
+    bool m_started = false;
+    bool m_finishing = false;
+    bool m_failed = false;
+    bool m_sinkOpen = false;
+    uint32_t m_width = 0;
+    uint32_t m_height = 0;
+    std::string m_error;
+    RS3FrameWriterStats m_stats;
+};
+
+} // namespace RealSpace3
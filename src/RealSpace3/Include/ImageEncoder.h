@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace RealSpace3 {
+
+enum class RS3ImageFormat {
+    Png = 0,
+    Qoi = 1,
+};
+
+inline const char* GetImageFormatExtension(RS3ImageFormat format) {
+    return format == RS3ImageFormat::Qoi ? ".qoi" : ".png";
+}
+
+// Encoders for captured frames: BGRA8 rows in, 8-bit RGB files out (alpha is dropped; frames
+// are opaque). Tuned for speed over size: PNG uses a single fixed-Huffman deflate block with a
+// one-probe LZ77 hash, QOI is the reference format. Output vectors are reused by the caller,
+// so steady-state encoding does not allocate.
+class ImageEncoder {
+public:
+    static bool EncodePng(const uint8_t* bgra, uint32_t width, uint32_t height, size_t rowPitch, std::vector<uint8_t>& outBytes);
+    static bool EncodeQoi(const uint8_t* bgra, uint32_t width, uint32_t height, size_t rowPitch, std::vector<uint8_t>& outBytes);
+    static bool Encode(RS3ImageFormat format, const uint8_t* bgra, uint32_t width, uint32_t height, size_t rowPitch, std::vector<uint8_t>& outBytes);
+};
+
+} // namespace RealSpace3
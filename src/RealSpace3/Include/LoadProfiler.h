@@ -0,0 +1,112 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace RealSpace3 {
+
+enum class LoadStage : uint8_t {
+    Resolve = 0, // path -> pack entry / disk file
+    Read,        // bytes from disk or pack (decompression included)
+    Decode,      // parse binary packages, decode images, generate mips
+    Validate,    // format checks and fix-ups (skeleton order, bind matrices)
+    Build,       // CPU acceleration structures (collision BSP, ray BVH, navmesh)
+    Upload,      // D3D11 buffer/texture creation
+    Package,     // enclosing span: one scene, model or character load
+    Count
+};
+
+const char* GetLoadStageName(LoadStage stage);
+
+struct LoadStageTotals {
+    uint64_t count = 0;
+    uint64_t nanoseconds = 0;
+    uint64_t bytes = 0;
+};
+
+// Timeline of asset load work. Disabled by default; when enabled every LoadScope records a
+// complete event (stage, name, thread, start, duration, bytes) that ExportChromeTrace writes
+// as Chrome trace-event JSON (chrome://tracing, Perfetto). Safe to use from any thread.
+class LoadProfiler {
+public:
+    static constexpr size_t kMaxEvents = 1u << 20;
+
+    static LoadProfiler& getInstance() {
+        static LoadProfiler instance;
+        return instance;
+    }
+
+    void SetEnabled(bool enabled) { m_enabled.store(enabled, std::memory_order_relaxed); }
+    bool IsEnabled() const { return m_enabled.load(std::memory_order_relaxed); }
+
+    // Nanoseconds on the steady clock since the profiler was created.
+    static uint64_t NowNanoseconds();
+    // Names the calling thread in exported traces.
+    void SetThreadName(const std::string& name);
+
+    void Record(LoadStage stage, const std::string& name, uint64_t startNs, uint64_t endNs, uint64_t bytes);
+    void Clear();
+
+    LoadStageTotals GetTotals(LoadStage stage) const;
+    size_t GetEventCount() const;
+    bool ExportChromeTrace(const std::string& filePath, std::string* outError = nullptr) const;
+
+private:
+    LoadProfiler() = default;
+
+    struct Event {
+        LoadStage stage = LoadStage::Package;
+        uint32_t threadId = 0;
+        uint64_t startNs = 0;
+        uint64_t durationNs = 0;
+        uint64_t bytes = 0;
+        std::string name;
+    };
+
+    static uint32_t GetThreadId();
+
+    std::atomic<bool> m_enabled{ false };
+    mutable std::mutex m_mutex;
+    std::vector<Event> m_events;
+    std::vector<std::pair<uint32_t, std::string>> m_threadNames;
+    std::array<LoadStageTotals, static_cast<size_t>(LoadStage::Count)> m_totals{};
+    uint64_t m_droppedEvents = 0;
+};
+
+// Times its own lifetime as one event. Costs one relaxed load when profiling is off.
+class LoadScope {
+public:
+    LoadScope(LoadStage stage, const std::string& name)
+        : m_stage(stage), m_active(LoadProfiler::getInstance().IsEnabled()) {
+        if (!m_active) return;
+        m_name = name;
+        m_startNs = LoadProfiler::NowNanoseconds();
+    }
+
+    ~LoadScope() { End(); }
+
+    LoadScope(const LoadScope&) = delete;
+    LoadScope& operator=(const LoadScope&) = delete;
+
+    void AddBytes(uint64_t bytes) { m_bytes += bytes; }
+    // Records now instead of at scope exit, so a following stage is not counted twice.
+    void End() {
+        if (!m_active) return;
+        m_active = false;
+        LoadProfiler::getInstance().Record(m_stage, m_name, m_startNs, LoadProfiler::NowNanoseconds(), m_bytes);
+    }
+
+private:
+    LoadStage m_stage;
+    bool m_active;
+    uint64_t m_startNs = 0;
+    uint64_t m_bytes = 0;
+    std::string m_name;
+};
+
+} // namespace RealSpace3
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace RealSpace3 {
+
+// Read-only memory mapping of a whole file (CreateFileMapping / mmap). The bytes stay
+// valid until Close or destruction.
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile();
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool Open(const std::string& path, std::string* outError = nullptr);
+    void Close();
+
+    bool IsOpen() const { return m_view != nullptr; }
+    const uint8_t* GetData() const { return static_cast<const uint8_t*>(m_view); }
+    size_t GetSize() const { return m_size; }
+
+private:
+#ifdef _WIN32
+    void* m_file = nullptr;    // HANDLE
+    void* m_mapping = nullptr; // HANDLE
+#else
+    int m_fd = -1;
+#endif
+    void* m_view = nullptr;
+    size_t m_size = 0;
+};
+
+} // namespace RealSpace3
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace RealSpace3 {
+
+struct MipLevelRGBA8 {
+    uint32_t width = 0;
+    uint32_t height = 0;
+    std::vector<uint8_t> pixels; // tightly packed, width * 4 bytes per row
+};
+
+// CPU box-filter mip generator for 8-bit 4-channel images (RGBA or BGRA; byte 3
+// is alpha). With srgb set, colour is averaged in linear light and alpha
+// linearly; with alphaWeighted set, colour is weighted by alpha so transparent
+// texels do not bleed into their neighbours.
+class MipGenerator {
+public:
+    static uint32_t CountMipLevels(uint32_t width, uint32_t height);
+
+    // Fills outLevels with levels 1..N-1 (the source is level 0).
+    static bool Generate(uint32_t width, uint32_t height, const uint8_t* pixels, size_t rowPitch,
+                         bool srgb, bool alphaWeighted, std::vector<MipLevelRGBA8>& outLevels, std::string* outError = nullptr);
+
+    // One 2:1 step; odd edges repeat the last row/column. dst is max(1, w/2) x max(1, h/2), tightly packed.
+    static void Downsample(const uint8_t* src, uint32_t width, uint32_t height, size_t rowPitch,
+                           bool srgb, bool alphaWeighted, uint8_t* dst);
+};
+
+} // namespace RealSpace3
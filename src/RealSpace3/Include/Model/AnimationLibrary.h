@@ -0,0 +1,75 @@
+#pragma once
+
+#include "ModelPackageLoader.h"
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace RealSpace3 {
+
+// One animation library (anim.bin) as authored against one skeleton. Immutable once
+// registered; every package and character using the clip set holds the same instance.
+struct RS3ClipSet {
+    std::string clipSetId;
+    std::string rigId;
+    std::vector<std::string> boneNames; // skeleton the channel bone indices refer to (normalized)
+    RS3ClipList clips;
+    std::vector<float> durations;       // per clip, seconds
+    std::unordered_map<std::string, uint32_t> clipIndexByName;
+
+    int32_t FindClip(const std::string& clipName) const;
+};
+
+// A clip set retargeted onto one skeleton by bone name. channelByBone[clip][bone] is the
+// channel driving that bone, or -1 when the bone keeps its bind pose.
+struct RS3ClipBinding {
+    std::shared_ptr<const RS3ClipSet> clipSet;
+    std::shared_ptr<const RS3BoneList> skeleton;
+    std::vector<std::vector<int32_t>> channelByBone;
+    uint32_t unmatchedChannels = 0;
+
+    const RS3AnimationChannel* FindChannel(uint32_t clipIndex, size_t boneIndex) const;
+};
+
+// Registry of clip sets by clipSetId and rigId, plus the bone remap tables built for them.
+// Entries are weak: a clip set stays loaded while any package or SkeletonPlayer uses it.
+// Safe to use from loader threads.
+class AnimationLibrary {
+public:
+    static AnimationLibrary& getInstance() {
+        static AnimationLibrary instance;
+        return instance;
+    }
+
+    std::shared_ptr<const RS3ClipSet> Find(const std::string& clipSetId);
+    // Most recently registered live clip set for the rig.
+    std::shared_ptr<const RS3ClipSet> FindForRig(const std::string& rigId);
+    // Returns the clip set already registered under the same id when another loader won the race.
+    std::shared_ptr<const RS3ClipSet> Register(std::shared_ptr<RS3ClipSet> clipSet);
+    // Remap table for (clipSet, skeleton); built once and shared by every player using the pair.
+    std::shared_ptr<const RS3ClipBinding> Bind(const std::shared_ptr<const RS3ClipSet>& clipSet,
+        const std::shared_ptr<const RS3BoneList>& skeleton);
+
+    size_t GetLiveClipSetCount();
+
+    // Bone names are matched case-insensitively.
+    static std::string NormalizeBoneName(const std::string& name);
+
+private:
+    AnimationLibrary() = default;
+
+    using BindingKey = std::pair<const RS3ClipSet*, const RS3BoneList*>;
+
+    std::mutex m_mutex;
+    std::unordered_map<std::string, std::weak_ptr<const RS3ClipSet>> m_clipSets;
+    std::unordered_map<std::string, std::weak_ptr<const RS3ClipSet>> m_clipSetsByRig;
+    std::map<BindingKey, std::weak_ptr<const RS3ClipBinding>> m_bindings;
+};
+
+} // namespace RealSpace3
@@ -3,6 +3,7 @@
 #include <DirectXMath.h>
 #include <cstdint>
 #include <filesystem>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -67,6 +68,9 @@ struct RS3AnimationClip {
     std::vector<RS3AnimationChannel> channels;
 };
 
+using RS3BoneList = std::vector<RS3Bone>;
+using RS3ClipList = std::vector<RS3AnimationClip>;
+
 struct RS3Material {
     uint32_t legacyFlags = 0;
     uint32_t alphaMode = 0;
@@ -80,6 +84,8 @@ struct RS3Material {
     std::string opacityTexture;
 };
 
+struct RS3ClipSet; // AnimationLibrary.h
+
 struct RS3AttachmentSocket {
     std::string name;
     int32_t nodeIndex = -1;
@@ -88,20 +94,28 @@ struct RS3AttachmentSocket {
 struct RS3ModelPackage {
     std::string modelId;
     std::string sourceGlb;
-    std::filesystem::path baseDir;
+    std::filesystem::path baseDir; // disk directory, or "vfs:models/<id>" when served from a pack
+    std::string rigId;
 
     std::vector<RS3ModelVertex> vertices;
     std::vector<uint32_t> indices;
     std::vector<RS3ModelSubmesh> submeshes;
 
-    std::vector<RS3Bone> bones;
-    std::vector<RS3AnimationClip> clips;
+    // Immutable; packages whose skeleton.bin has the same content share one copy
+    std::shared_ptr<const RS3BoneList> bones = std::make_shared<const RS3BoneList>();
+    // Registered in AnimationLibrary under the model.json clipSetId; null when anim.bin has no clips
+    std::shared_ptr<const RS3ClipSet> clipSet;
     std::vector<RS3Material> materials;
     std::vector<RS3AttachmentSocket> sockets;
 };
 
 class ModelPackageLoader {
 public:
+    // model.json file names and material texture names starting with this prefix live in the
+    // content store shared by all packages (models/_store/<kind>/<sha256>.<ext>).
+    static constexpr const char* kContentStorePrefix = "@store/";
+    static constexpr const char* kContentStoreDirectory = "models/_store";
+
     static bool LoadModelPackage(const std::string& modelId, RS3ModelPackage& outPackage, std::string* outError = nullptr);
 };
 
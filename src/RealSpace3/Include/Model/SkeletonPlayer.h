@@ -1,14 +1,23 @@
 #pragma once
 
+#include "AnimationLibrary.h"
 #include "ModelPackageLoader.h"
 
+#include <memory>
 #include <string>
 
 namespace RealSpace3 {
 
+// Per-character animation state. Skeleton, clips and bone remap tables are shared
+// (see AnimationLibrary); the player only owns the clip cursor.
 class SkeletonPlayer {
 public:
+    // Binds the package skeleton to its clip set, or to the rig's shared clip set when the
+    // package has none.
     void SetPackage(const RS3ModelPackage* package);
+    // Replaces the clip set (e.g. a rig library loaded by another model); the skeleton is kept.
+    void SetClipSet(std::shared_ptr<const RS3ClipSet> clipSet);
+    const std::shared_ptr<const RS3ClipSet>& GetClipSet() const { return m_clipSet; }
     bool SetAnimationClipByName(const std::string& clipName, float blendSeconds);
     const RS3AnimationClip* GetCurrentClip() const;
     float GetBlendSeconds() const;
@@ -17,7 +26,9 @@ public:
     float GetCurrentTimeSeconds() const;
 
 private:
-    const RS3ModelPackage* m_package = nullptr;
+    std::shared_ptr<const RS3BoneList> m_skeleton;
+    std::shared_ptr<const RS3ClipSet> m_clipSet;
+    std::shared_ptr<const RS3ClipBinding> m_binding;
     int32_t m_clipIndex = -1;
     float m_blendSeconds = 0.0f;
     float m_timeSeconds = 0.0f;
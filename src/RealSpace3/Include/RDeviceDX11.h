@@ -26,6 +26,16 @@ public:
     void DrawAtomicProof(); // PROVA DE VIDA DO RASTERIZADOR
     bool ReadBackBufferBGRA(std::vector<uint8_t>& outPixels, uint32_t& outWidth, uint32_t& outHeight);
 
+    // Pipelined readback for frame capture: QueueBackBufferCapture copies the back buffer into
+    // the next staging texture of a ring without waiting; ReadQueuedCapture maps the oldest one,
+    // normally slotCount - 1 frames later, when the GPU has long finished that copy.
+    bool BeginCaptureRing(uint32_t slotCount);
+    void EndCaptureRing();
+    bool QueueBackBufferCapture();
+    uint32_t GetQueuedCaptureCount() const { return m_captureQueued; }
+    uint32_t GetCaptureSlotCount() const { return static_cast<uint32_t>(m_captureRing.size()); }
+    bool ReadQueuedCapture(std::vector<uint8_t>& outPixels, uint32_t& outWidth, uint32_t& outHeight);
+
     int GetWidth() { return m_width; }
     int GetHeight() { return m_height; }
     ID3D11Device* GetDevice() { return m_pd3dDevice.Get(); }
@@ -60,6 +70,12 @@ private:
     ComPtr<ID3D11InputLayout>       m_pProofLayout;
     ComPtr<ID3D11DepthStencilState> m_pProofDS;
 
+    // Capture ring
+    std::vector<ComPtr<ID3D11Texture2D>> m_captureRing;
+    D3D11_TEXTURE2D_DESC m_captureDesc = {};
+    uint32_t m_captureNext = 0;
+    uint32_t m_captureQueued = 0;
+
     int m_width;
     int m_height;
 };
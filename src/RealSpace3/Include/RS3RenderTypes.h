@@ -21,6 +21,17 @@ struct RS3CameraPose {
     float farZ = 20000.0f;
 };
 
+// Light and fog values driven by a timeline; replaces the scene package values while set.
+struct RS3EnvironmentOverride {
+    bool hasLight = false;
+    DirectX::XMFLOAT3 lightColor = { 1.0f, 1.0f, 1.0f };
+    float lightIntensity = 1.0f;
+    bool hasFog = false;
+    float fogMin = 1000.0f;
+    float fogMax = 7000.0f;
+    DirectX::XMFLOAT3 fogColor = { 1.0f, 1.0f, 1.0f };
+};
+
 struct RS3TimelinePlaybackOptions {
     bool loop = false;
     float speed = 1.0f;
@@ -1,5 +1,9 @@
 #pragma once
 
+#include "SceneBatching.h"
+#include "SceneCollision.h"
+#include "SceneNavigation.h"
+#include "SceneRaycast.h"
 #include "ScenePackageLoader.h"
 #include "RS3RenderTypes.h"
 #include "StateManager.h"
@@ -35,6 +39,8 @@ public:
     RS3RenderMode GetRenderMode() const;
     bool SetCameraPose(const RS3CameraPose& pose, bool immediate);
     void ClearCameraPose();
+    void SetEnvironmentOverride(const RS3EnvironmentOverride& environment);
+    void ClearEnvironmentOverride();
     bool GetPreferredCameraPose(RS3CameraPose& outPose) const;
     bool GetPreferredCamera(DirectX::XMFLOAT3& outPos, DirectX::XMFLOAT3& outDir) const;
     bool SetCreationPreview(int sex, int face, int preset, int hair);
@@ -46,19 +52,27 @@ public:
     void SetCreationCameraAutoOrbit(bool enabled);
     void ResetCreationCamera();
     bool GetSpawnPos(DirectX::XMFLOAT3& outPos) const;
+    bool IsPointInSolid(const DirectX::XMFLOAT3& point) const;
+    bool TraceCollision(const DirectX::XMFLOAT3& from, const DirectX::XMFLOAT3& to, float* outFraction = nullptr) const;
+    bool RaycastWorld(const SceneRay& ray, SceneRayHit& outHit) const;
+    uint32_t RaycastWorldBatch(const SceneRay* rays, uint32_t rayCount, SceneRayHit* outHits) const;
+    bool FindNearestWalkablePoint(const DirectX::XMFLOAT3& point, float maxDistance, SceneNavPoint& outPoint) const;
+    bool FindWalkPath(const DirectX::XMFLOAT3& from, const DirectX::XMFLOAT3& to, std::vector<DirectX::XMFLOAT3>& outWaypoints) const;
 
 private:
     struct MapGpuVertex {
         DirectX::XMFLOAT3 pos;
         DirectX::XMFLOAT3 normal;
         DirectX::XMFLOAT2 uv;
+        float textureSlice = 0.0f; // Texture2DArray slice; ignored for plain textures
     };
 
-    struct MapSectionRuntime {
+    // Sections sharing a pass and texture (or texture array) merged into one draw.
+    struct MapBatchRuntime {
         uint32_t indexStart = 0;
         uint32_t indexCount = 0;
-        uint32_t materialFlags = 0;
-        Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> diffuseSRV;
+        int pass = 0;
+        TextureHandle diffuseTexture;
     };
 
     struct MapPerFrameCB {
@@ -141,6 +155,8 @@ private:
     void ResetCreationCameraRig();
     void UpdateCreationCameraFromRig();
     DirectX::XMFLOAT3 GetCreationCameraFocus() const;
+    void FillEnvironmentConstants(DirectX::XMFLOAT4& outLightDirIntensity, DirectX::XMFLOAT4& outLightColorFogMin,
+                                  DirectX::XMFLOAT4& outFogColorFogMax, DirectX::XMFLOAT4& outCameraPosFogEnabled) const;
 
 private:
     ID3D11Device* m_pd3dDevice = nullptr;
@@ -192,11 +208,17 @@ private:
     DirectX::XMFLOAT3 m_sceneLightDir = { 0.0f, -1.0f, -0.3f };
     DirectX::XMFLOAT3 m_sceneLightColor = { 1.0f, 1.0f, 1.0f };
     float m_sceneLightIntensity = 1.0f;
+    bool m_hasEnvironmentOverride = false;
+    RS3EnvironmentOverride m_environmentOverride;
 
-    std::vector<MapSectionRuntime> m_mapSections;
+    std::vector<MapBatchRuntime> m_mapBatches;
+    SceneCollisionBsp m_collisionBsp;
+    SceneRaycaster m_worldRaycaster;
+    SceneNavMesh m_navMesh;
 
     Microsoft::WRL::ComPtr<ID3D11VertexShader> m_mapVS;
     Microsoft::WRL::ComPtr<ID3D11PixelShader> m_mapPS;
+    Microsoft::WRL::ComPtr<ID3D11PixelShader> m_mapPSArray;
     Microsoft::WRL::ComPtr<ID3D11InputLayout> m_mapInputLayout;
     Microsoft::WRL::ComPtr<ID3D11SamplerState> m_mapSampler;
     Microsoft::WRL::ComPtr<ID3D11Buffer> m_mapVB;
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace RealSpace3 {
+
+// One drawable range of the world index buffer. textureKey identifies the bound
+// texture (0 = none); sections packed into the same Texture2DArray share a key
+// and differ only in arraySlice.
+struct SceneDrawSection {
+    int pass = 0;
+    uint32_t textureKey = 0;
+    uint32_t arraySlice = 0;
+    uint32_t indexStart = 0;
+    uint32_t indexCount = 0;
+};
+
+struct SceneDrawBatch {
+    int pass = 0;
+    uint32_t textureKey = 0;
+    uint32_t indexStart = 0;
+    uint32_t indexCount = 0;
+    uint32_t sectionCount = 0;
+};
+
+struct SceneBatchResult {
+    std::vector<uint32_t> indices;        // reordered so each batch is contiguous
+    std::vector<uint32_t> vertexSource;   // output vertex -> source vertex (identity, then duplicates)
+    std::vector<uint32_t> vertexSlices;   // array slice per output vertex
+    std::vector<SceneDrawBatch> batches;  // ordered by pass
+};
+
+// Merges world sections that share a pass and texture into single draws.
+// Vertices referenced from different array slices are duplicated so the slice
+// can travel as a vertex attribute. Passes listed in orderedPassMask (bit per
+// pass) keep their original section order and only merge adjacent sections,
+// which keeps alpha-blended output unchanged.
+class SceneDrawBatcher {
+public:
+    static bool Build(const std::vector<SceneDrawSection>& sections, const std::vector<uint32_t>& indices, uint32_t vertexCount,
+                      uint32_t orderedPassMask, SceneBatchResult& outResult, std::string* outError = nullptr);
+};
+
+} // namespace RealSpace3
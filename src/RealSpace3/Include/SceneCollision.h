@@ -0,0 +1,50 @@
+#pragma once
+
+#include "ScenePackageLoader.h"
+
+#include <DirectXMath.h>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace RealSpace3 {
+
+// Traversal layout for collision.bin. Planes and child links live in separate
+// arrays so a descent only touches 16 bytes of plane + 8 bytes of links per node.
+// Nodes are renumbered depth-first (positive side first), so the positive child
+// of an inner node is usually the next entry in both arrays.
+//
+// Child links: >= 0 is an inner node index, < 0 is a leaf. Leaves are stored
+// as ~solid, i.e. kLeafEmpty (-1) or kLeafSolid (-2).
+struct SceneCollisionChildren {
+    int32_t pos = -1;
+    int32_t neg = -1;
+};
+
+class SceneCollisionBsp {
+public:
+    static constexpr int32_t kLeafEmpty = -1;
+    static constexpr int32_t kLeafSolid = -2;
+
+    static bool Build(const ScenePackageCollision& source, SceneCollisionBsp& outBsp, std::string* outError = nullptr);
+
+    void Clear();
+    bool IsEmpty() const { return m_root == kLeafEmpty && m_planes.empty(); }
+    size_t GetNodeCount() const { return m_planes.size(); }
+    int32_t GetRoot() const { return m_root; }
+
+    bool IsPointSolid(const DirectX::XMFLOAT3& point) const;
+    // Returns true when the segment enters solid space; outFraction is the
+    // entry point in [0, 1] along from -> to.
+    bool TraceSegment(const DirectX::XMFLOAT3& from, const DirectX::XMFLOAT3& to, float* outFraction = nullptr) const;
+
+private:
+    static int32_t EncodeLeaf(bool solid) { return solid ? kLeafSolid : kLeafEmpty; }
+
+    std::vector<DirectX::XMFLOAT4A> m_planes;
+    std::vector<SceneCollisionChildren> m_children;
+    int32_t m_root = kLeafEmpty;
+    uint32_t m_maxDepth = 0;
+};
+
+} // namespace RealSpace3
@@ -27,6 +27,7 @@ public:
     bool playTimeline(const std::string& timelinePath, const RS3TimelinePlaybackOptions& opts);
     void stopTimeline();
     bool setCameraPose(const RS3CameraPose& pose, bool immediate);
+    void setEnvironmentOverride(const RS3EnvironmentOverride& environment);
     void setShowcaseViewport(int x, int y, int width, int height);
     bool setCreationPreview(int sex, int face, int preset, int hair);
     void setCreationPreviewVisible(bool visible);
@@ -42,11 +43,13 @@ public:
 private:
     SceneManager() = default;
     bool EnsureScene();
+    void ApplyTimelineTracks();
     ID3D11Device* m_pDevice = nullptr;
     std::unique_ptr<RScene> m_pCurrentScene;
     CinematicPlayer m_cinematicPlayer;
     bool m_hasCameraPoseOverride = false;
     RS3CameraPose m_cameraPoseOverride;
+    RS3TimelineTrackFrame m_trackFrame;
     int m_width = 1280;
     int m_height = 720;
 };
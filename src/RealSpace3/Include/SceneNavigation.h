@@ -0,0 +1,86 @@
+#pragma once
+
+#include "ScenePackageLoader.h"
+#include "Types.h"
+
+#include <DirectXMath.h>
+#include <cfloat>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace RealSpace3 {
+
+struct SceneNavSettings {
+    float maxSlopeDeg = 45.0f;      // steeper triangles are not walkable (world up is +Z)
+    float stepHeight = 40.0f;       // max vertical gap bridged between disjoint surfaces
+    float stepReach = 24.0f;        // max horizontal gap bridged by a step link
+    float weldTolerance = 0.5f;     // vertex welding grid used to find shared edges
+    // Alpha-tested sections (fences, foliage cards) are see-through and not solid, same as collision
+    uint32_t excludeMaterialFlags = RM_FLAG_HIDE | RM_FLAG_USEOPACITY | RM_FLAG_USEALPHATEST | RM_FLAG_ADDITIVE;
+};
+
+struct SceneNavPoint {
+    DirectX::XMFLOAT3 position = { 0.0f, 0.0f, 0.0f };
+    uint32_t polygon = 0;
+    float distance = FLT_MAX;
+};
+
+// Walkable surface graph derived from world.bin triangles. Nodes are walkable
+// triangles, links are shared edges (after welding) or step links between
+// nearby boundary edges. Cached next to world.bin as navmesh.bin.
+class SceneNavMesh {
+public:
+    static constexpr const char* kSidecarFileName = "navmesh.bin";
+
+    static bool Build(const ScenePackageData& package, const SceneNavSettings& settings, SceneNavMesh& outMesh, std::string* outError = nullptr);
+    // Loads <baseDir>/navmesh.bin when it matches the package and settings, otherwise builds it and
+    // rewrites the sidecar (loose scenes only; packed scenes read a baked one from the pack).
+    static bool LoadOrBuild(const ScenePackageData& package, const SceneNavSettings& settings, SceneNavMesh& outMesh, std::string* outError = nullptr);
+    static uint64_t ComputeSourceHash(const ScenePackageData& package, const SceneNavSettings& settings);
+
+    bool SaveToFile(const std::string& filePath, std::string* outError = nullptr) const;
+    bool LoadFromFile(const std::string& filePath, uint64_t expectedSourceHash, std::string* outError = nullptr);
+    bool LoadFromBytes(const std::vector<uint8_t>& bytes, uint64_t expectedSourceHash, std::string* outError = nullptr);
+
+    void Clear();
+    bool IsEmpty() const { return m_polygons.empty(); }
+    size_t GetPolygonCount() const { return m_polygons.size(); }
+    size_t GetLinkCount() const { return m_links.size(); }
+    uint64_t GetSourceHash() const { return m_sourceHash; }
+
+    bool FindNearestPoint(const DirectX::XMFLOAT3& point, float maxDistance, SceneNavPoint& outPoint) const;
+    // Waypoints run from the nearest walkable point of 'from' through link portals to the nearest point of 'to'.
+    bool FindPath(const DirectX::XMFLOAT3& from, const DirectX::XMFLOAT3& to, std::vector<DirectX::XMFLOAT3>& outWaypoints) const;
+
+private:
+    struct Polygon {
+        uint32_t v[3] = { 0, 0, 0 };
+        uint32_t sectionIndex = 0;
+        DirectX::XMFLOAT3 center = { 0.0f, 0.0f, 0.0f };
+    };
+
+    struct Link {
+        uint32_t target = 0;
+        DirectX::XMFLOAT3 portal = { 0.0f, 0.0f, 0.0f };
+    };
+
+    void BuildQueryGrid();
+    DirectX::XMFLOAT3 ClosestPointOnPolygon(uint32_t polygon, const DirectX::XMFLOAT3& point) const;
+
+    std::vector<DirectX::XMFLOAT3> m_vertices;
+    std::vector<Polygon> m_polygons;
+    std::vector<uint32_t> m_linkOffsets; // CSR: links of polygon i are [m_linkOffsets[i], m_linkOffsets[i + 1])
+    std::vector<Link> m_links;
+    uint64_t m_sourceHash = 0;
+
+    // XY query grid, rebuilt after Build/Load.
+    DirectX::XMFLOAT2 m_gridOrigin = { 0.0f, 0.0f };
+    float m_gridCellSize = 1.0f;
+    uint32_t m_gridWidth = 0;
+    uint32_t m_gridHeight = 0;
+    std::vector<uint32_t> m_gridOffsets;
+    std::vector<uint32_t> m_gridPolygons;
+};
+
+} // namespace RealSpace3
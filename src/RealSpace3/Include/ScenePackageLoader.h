@@ -46,7 +46,7 @@ struct ScenePackageCollision {
 
 struct ScenePackageData {
     std::string sceneId;
-    std::string baseDir;
+    std::string baseDir; // disk directory, or "vfs:scenes/<id>" when served from a pack
 
     DirectX::XMFLOAT3 cameraPos01 = { 0.0f, -800.0f, 220.0f };
     DirectX::XMFLOAT3 cameraDir01 = { 0.0f, 1.0f, -0.2f };
@@ -0,0 +1,80 @@
+#pragma once
+
+#include "ScenePackageLoader.h"
+
+#include <DirectXMath.h>
+#include <cfloat>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace RealSpace3 {
+
+struct SceneRay {
+    DirectX::XMFLOAT3 origin = { 0.0f, 0.0f, 0.0f };
+    DirectX::XMFLOAT3 direction = { 0.0f, 1.0f, 0.0f }; // distance is measured in units of |direction|
+    float maxDistance = FLT_MAX;
+};
+
+struct SceneRayHit {
+    bool hit = false;
+    float distance = FLT_MAX;
+    DirectX::XMFLOAT3 position = { 0.0f, 0.0f, 0.0f };
+    DirectX::XMFLOAT3 normal = { 0.0f, 0.0f, 1.0f };
+    uint32_t triangleIndex = 0;
+    uint32_t sectionIndex = 0;
+    uint32_t materialIndex = 0;
+    uint32_t materialFlags = 0;
+};
+
+// Triangle-level closest-hit queries against world.bin render geometry
+// (decals, hitscan feedback). Built once per scene from ScenePackageData;
+// no D3D dependency.
+class SceneRaycaster {
+public:
+    // Rays per SIMD traversal step (one DirectXMath register lane per ray).
+    static constexpr uint32_t kPacketSize = 4;
+
+    static bool Build(const ScenePackageData& package, SceneRaycaster& outRaycaster, std::string* outError = nullptr);
+
+    void Clear();
+    bool IsEmpty() const { return m_nodes.empty(); }
+    size_t GetTriangleCount() const { return m_triangles.size(); }
+    size_t GetNodeCount() const { return m_nodes.size(); }
+
+    bool Raycast(const SceneRay& ray, SceneRayHit& outHit) const;
+    // Traces rays in packets of kPacketSize; returns the number of rays that hit.
+    uint32_t RaycastBatch(const SceneRay* rays, uint32_t rayCount, SceneRayHit* outHits) const;
+
+private:
+    struct Node {
+        DirectX::XMFLOAT3 boundsMin;
+        uint32_t leftOrFirst = 0; // inner: left child (right = left + 1), leaf: first triangle
+        DirectX::XMFLOAT3 boundsMax;
+        uint32_t count = 0;       // > 0 marks a leaf
+    };
+
+    // Pre-transformed for Moller-Trumbore: v0 plus the two edges.
+    struct Triangle {
+        DirectX::XMFLOAT3 v0;
+        DirectX::XMFLOAT3 e1;
+        DirectX::XMFLOAT3 e2;
+    };
+
+    struct TriangleInfo {
+        uint32_t sourceTriangle = 0;
+        uint32_t sectionIndex = 0;
+        uint32_t materialIndex = 0;
+        uint32_t materialFlags = 0;
+    };
+
+    void TracePacket(const SceneRay* rays, uint32_t laneCount, SceneRayHit* outHits) const;
+    void FillHit(const SceneRay& ray, uint32_t triangle, float distance, SceneRayHit& outHit) const;
+
+    std::vector<Node> m_nodes;
+    std::vector<Triangle> m_triangles;
+    std::vector<TriangleInfo> m_triangleInfo;
+    uint32_t m_maxDepth = 0;
+};
+
+} // namespace RealSpace3
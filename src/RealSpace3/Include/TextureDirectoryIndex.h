@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstddef>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace RealSpace3 {
+
+// Case-insensitive file index used to resolve texture paths without probing
+// the filesystem per candidate. Roots are indexed recursively once (or read
+// from a package-provided list); any other directory is listed the first time
+// a path inside it is resolved. Safe to query from texture decode workers.
+class TextureDirectoryIndex {
+public:
+    // Optional list written next to a scene package: a header line, then one
+    // root-relative file path per line.
+    static constexpr const char* kPackageIndexFileName = "texture_index_v1.txt";
+    static constexpr const char* kPackageIndexHeader = "rs3_texture_index_v1";
+
+    // Indexes every file under root; uses <root>/texture_index_v1.txt instead of walking when present.
+    bool AddRoot(const std::string& root, std::string* outError = nullptr);
+    bool HasRoot(const std::string& root) const;
+    // Finds the on-disk spelling of path. Returns false only when the file does not exist
+    // (as far as the index knows), never touching disk for directories already covered.
+    bool Resolve(const std::string& path, std::string& outActualPath);
+    void Clear();
+
+    size_t GetFileCount() const;
+    size_t GetListedDirectoryCount() const;
+
+    // Lowercase, forward slashes, no duplicate or trailing slashes, "." and ".." segments collapsed
+    // (leading ".." of a relative path kept).
+    static std::string Normalize(const std::string& path);
+
+private:
+    bool IsCoveredLocked(const std::string& normalizedDirectory) const;
+    void ListDirectoryLocked(const std::string& normalizedDirectory, const std::string& directory);
+
+    mutable std::shared_mutex m_mutex;
+    std::unordered_map<std::string, std::string> m_files; // normalized path -> path as found on disk
+    std::vector<std::string> m_roots;                      // normalized; covers every subdirectory
+    std::unordered_set<std::string> m_listedDirectories;   // normalized; covers direct children only
+};
+
+} // namespace RealSpace3
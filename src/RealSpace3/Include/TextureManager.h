@@ -1,38 +1,147 @@
 #pragma once
+#include "TextureDirectoryIndex.h"
+#include "TextureResidency.h"
 #include <d3d11.h>
 #include <wrl/client.h>
 #include <string>
 #include <map>
 #include <memory>
+#include <set>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <thread>
+#include <vector>
+#include <cstdint>
 
 namespace RealSpace3 {
 
-class TextureManager {
+struct DecodedTexture;
+
+enum class TextureLoadState {
+    Pending,
+    Ready,
+    Missing
+};
+
+// Shared between the cache and every user of the texture; srv holds the
+// placeholder until the streamed texture is swapped in by Update(), and is
+// swapped again whenever residency refines, demotes or evicts it.
+struct TextureSlot {
+    Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> srv;
+    TextureLoadState state = TextureLoadState::Pending;
+    uint32_t residencyId = 0; // 0 = not managed by residency (blocking loads, placeholders)
+    bool isArray = false;     // srv is a Texture2DArray view; placeholders are always plain 2D
+};
+using TextureHandle = std::shared_ptr<TextureSlot>;
+
+class TextureManager : private ITextureResidencyDevice {
 public:
+    static constexpr uint64_t kDefaultUploadBudgetBytes = 16ull * 1024ull * 1024ull;
+
     TextureManager(ID3D11Device* device);
     ~TextureManager();
 
+    // Blocking load; resolves and decodes on the calling thread.
     Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> GetTexture(const std::string& path);
+    // Non-blocking load; returns a handle with a placeholder SRV and queues disk read + decode on a worker.
+    TextureHandle RequestTexture(const std::string& path);
+    // Uploads finished decodes to the GPU until uploadBudgetBytes have been committed this call (at
+    // least one texture; only the mips actually created count, i.e. the tail for new textures), then
+    // advances the residency frame: refines used textures and evicts to stay within budget.
+    void Update(uint64_t uploadBudgetBytes = kDefaultUploadBudgetBytes);
+    // Marks a streamed texture as used this frame; re-queues its decode if it was fully evicted.
+    void MarkUsed(const TextureHandle& texture);
+    size_t GetPendingCount() const;
+
+    void SetResidencyBudget(const TextureResidencyBudget& budget) { m_residency.SetBudget(budget); }
+    const TextureResidencyManager& GetResidency() const { return m_residency; }
+
+    // Decodes DDS (surfaces uploaded in place from the buffer) or any WIC format such as PNG from
+    // caller-owned memory, e.g. a pack entry or a download. Not cached; returns the fallback on failure.
     Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> CreateTextureFromMemory(const uint8_t* data, size_t size);
     Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> GetWhiteTexture() { return m_whiteSRV; }
     Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> GetFallbackTexture() { return m_fallbackSRV; }
-    
-    void SetBaseDirectory(const std::string& dir) { m_baseDirectory = dir; }
+
+    // Also indexes the directory once (or loads its texture_index_v1.txt) so lookups skip the filesystem.
+    void SetBaseDirectory(const std::string& dir);
     const std::string& GetBaseDirectory() const { return m_baseDirectory; }
-    
+    // Drops the directory index and cached misses, e.g. after textures were written to disk.
+    void InvalidateDirectoryIndex();
+    size_t GetMissCount() const { return m_missingKeys.size(); }
+
     void Clear();
 
 private:
+    struct StreamJob {
+        std::string key;
+        std::string path;
+        std::string baseDirectory;
+        uint64_t generation = 0;
+    };
+
+    struct ResidentTexture {
+        TextureHandle slot;
+        std::string key;
+        std::string path;
+        std::string baseDirectory;
+        std::shared_ptr<DecodedTexture> texture; // null once residency drops the CPU copy
+    };
+
+    struct StreamResult {
+        std::string key;
+        std::string path;
+        std::string resolvedPath;
+        std::string baseDirectory;
+        uint64_t generation = 0;
+        std::shared_ptr<DecodedTexture> texture; // null when no candidate decoded
+    };
+
     std::string NormalizePath(const std::string& path);
+    static std::string MakeMissKey(const std::string& key, const std::string& baseDirectory) { return baseDirectory + "|" + key; }
+    void RecordMiss(const std::string& key, const std::string& baseDirectory);
     std::wstring ToWide(const std::string& str);
-    bool TryLoadTexture(const std::string& path, Microsoft::WRL::ComPtr<ID3D11ShaderResourceView>& outSRV);
+    static std::vector<std::string> BuildCandidates(const std::string& path, const std::string& baseDirectory);
+    bool TryDecodeTexture(const std::string& path, DecodedTexture& outTexture);
+    bool ResolveAndDecode(const std::string& path, const std::string& baseDirectory, std::string& outResolved, DecodedTexture& outTexture);
+    void ApplyResult(TextureSlot& slot, const std::string& path, const std::string& resolvedPath, const DecodedTexture* texture);
+    void ApplyStreamResult(const TextureHandle& slot, StreamResult& result);
+    void QueueJob(const std::string& key, const std::string& path, const std::string& baseDirectory);
+
+    // ITextureResidencyDevice
+    bool CommitMips(uint32_t textureId, uint32_t firstMip) override;
+    void ReleaseGpu(uint32_t textureId) override;
+    void ReleaseCpu(uint32_t textureId) override;
+    void StartWorkers();
+    void StopWorkers();
+    void WorkerMain();
     void CreateDefaultTextures();
 
     ID3D11Device* m_pd3dDevice;
-    std::map<std::string, Microsoft::WRL::ComPtr<ID3D11ShaderResourceView>> m_textureCache;
+    std::map<std::string, TextureHandle> m_textureCache;
+    // Paths that resolved to nothing, per base directory; kept apart from the loaded-texture cache
+    // so they can be invalidated without dropping textures.
+    std::set<std::string> m_missingKeys;
+    TextureHandle m_missingTexture;
+    TextureDirectoryIndex m_directoryIndex;
     Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> m_fallbackSRV;
     Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> m_whiteSRV;
     std::string m_baseDirectory;
+
+    mutable std::mutex m_streamMutex;
+    std::condition_variable m_streamCv;
+    std::deque<StreamJob> m_jobs;
+    std::deque<StreamResult> m_completed;
+    std::vector<std::thread> m_workers;
+    uint64_t m_generation = 0;
+    size_t m_inFlight = 0;
+    bool m_stopWorkers = false;
+
+    TextureResidencyManager m_residency{ *this };
+    std::map<uint32_t, ResidentTexture> m_resident;
+    uint32_t m_nextResidencyId = 1;
+    uint64_t m_frame = 0;
+    uint64_t m_uploadedBytes = 0; // committed to the GPU by CommitMips during the current Update
 };
 
-}
\ No newline at end of file
+}
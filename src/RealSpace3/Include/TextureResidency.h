@@ -0,0 +1,91 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace RealSpace3 {
+
+struct TextureResidencyBudget {
+    uint64_t vramBytes = 512ull * 1024ull * 1024ull;
+    uint64_t ramBytes = 256ull * 1024ull * 1024ull;
+    uint32_t tailDimension = 64;     // first upload only carries mips no larger than this
+    uint32_t refinementsPerUpdate = 4;
+};
+
+struct TextureMipInfo {
+    uint32_t width = 0;
+    uint32_t height = 0;
+    uint64_t bytes = 0;
+};
+
+// Device side of residency. TextureManager implements it with D3D11; a mock
+// implementation is enough to exercise the accounting without a GPU.
+class ITextureResidencyDevice {
+public:
+    virtual ~ITextureResidencyDevice() = default;
+    // (Re)creates the GPU texture holding mips [firstMip, mipCount).
+    virtual bool CommitMips(uint32_t textureId, uint32_t firstMip) = 0;
+    virtual void ReleaseGpu(uint32_t textureId) = 0;
+    virtual void ReleaseCpu(uint32_t textureId) = 0;
+};
+
+// Tracks VRAM/RAM per texture and decides which mips are resident. Textures
+// start at their mip tail, recently used ones are refined one level per
+// update, and the least recently used ones (by frame) are demoted or evicted
+// when a budget is exceeded. Textures touched in the current or previous
+// frame are never evicted. Over the RAM budget, fully refined textures lose
+// their CPU copy first; any other victim is evicted from both RAM and VRAM.
+class TextureResidencyManager {
+public:
+    static constexpr uint32_t kNotResident = UINT32_MAX;
+
+    explicit TextureResidencyManager(ITextureResidencyDevice& device) : m_device(device) {}
+
+    void SetBudget(const TextureResidencyBudget& budget) { m_budget = budget; }
+    const TextureResidencyBudget& GetBudget() const { return m_budget; }
+
+    // Registers a texture whose decoded mips are in RAM and commits its tail.
+    // Ids are chosen by the caller (non-zero, unique). Returns whether the tail
+    // is resident; the texture stays registered even if the commit fails.
+    bool Register(uint32_t textureId, const std::vector<TextureMipInfo>& mips, uint64_t frame);
+    void Unregister(uint32_t textureId);
+    void Touch(uint32_t textureId, uint64_t frame);
+    void Update(uint64_t frame);
+    void Clear();
+
+    uint32_t GetFirstResidentMip(uint32_t textureId) const;
+    bool IsCpuResident(uint32_t textureId) const;
+    // GPU copy evicted and CPU copy dropped: the caller must decode again.
+    bool NeedsReload(uint32_t textureId) const;
+    uint64_t GetVramUsage() const { return m_vramUsage; }
+    uint64_t GetRamUsage() const { return m_ramUsage; }
+    size_t GetTextureCount() const { return m_entries.size(); }
+
+private:
+    struct Entry {
+        std::vector<TextureMipInfo> mips;
+        uint32_t tailMip = 0;
+        uint32_t firstResidentMip = kNotResident;
+        uint64_t vramBytes = 0;
+        uint64_t ramBytes = 0;
+        uint64_t lastUsedFrame = 0;
+        bool cpuResident = false;
+    };
+
+    uint64_t BytesFrom(const Entry& entry, uint32_t firstMip) const;
+    bool Commit(uint32_t textureId, Entry& entry, uint32_t firstMip);
+    void ReleaseGpu(uint32_t textureId, Entry& entry);
+    void ReleaseCpu(uint32_t textureId, Entry& entry);
+    bool MakeVramRoom(uint64_t extraBytes, uint64_t protectFromFrame, uint32_t keepId);
+    void EnforceRamBudget(uint64_t protectFromFrame);
+
+    ITextureResidencyDevice& m_device;
+    TextureResidencyBudget m_budget;
+    std::unordered_map<uint32_t, Entry> m_entries;
+    uint64_t m_vramUsage = 0;
+    uint64_t m_ramUsage = 0;
+};
+
+} // namespace RealSpace3
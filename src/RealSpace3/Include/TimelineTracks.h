@@ -0,0 +1,82 @@
+#pragma once
+
+#include "CompiledTimeline.h"
+#include "RS3RenderTypes.h"
+
+#include <DirectXMath.h>
+
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+namespace RealSpace3 {
+
+// Evaluated values of one track at the current time. Names and targets point into the
+// compiled timeline and stay valid while it is bound.
+struct RS3TrackTransformState {
+    uint32_t track = 0;
+    std::string_view target;
+    DirectX::XMFLOAT3 position = { 0.0f, 0.0f, 0.0f };
+    DirectX::XMFLOAT4 rotation = { 0.0f, 0.0f, 0.0f, 1.0f };
+    float scale = 1.0f;
+};
+
+struct RS3TrackLightState {
+    uint32_t track = 0;
+    DirectX::XMFLOAT3 color = { 1.0f, 1.0f, 1.0f };
+    float intensity = 1.0f;
+};
+
+struct RS3TrackFogState {
+    uint32_t track = 0;
+    float fogMin = 1000.0f;
+    float fogMax = 7000.0f;
+    DirectX::XMFLOAT3 color = { 1.0f, 1.0f, 1.0f };
+};
+
+// Last clip trigger at or before the current time; active is false before the first one.
+struct RS3TrackClipState {
+    uint32_t track = 0;
+    std::string_view target;
+    std::string_view clip;
+    float startTimeSec = 0.0f;
+    float clipTimeSec = 0.0f;
+    bool loop = false;
+    bool active = false;
+};
+
+struct RS3TimelineTrackFrame {
+    std::vector<RS3TrackTransformState> transforms;
+    std::vector<RS3TrackLightState> lights;
+    std::vector<RS3TrackFogState> fogs;
+    std::vector<RS3TrackClipState> clips;
+
+    void Clear() {
+        transforms.clear();
+        lights.clear();
+        fogs.clear();
+        clips.clear();
+    }
+};
+
+// Samples the typed tracks of a compiled timeline. Each track keeps its own key cursor, so
+// forward playback finds its keys in constant time; seeks fall back to a binary search.
+class RS3TimelineTrackEvaluator {
+public:
+    void Bind(std::shared_ptr<const RS3CompiledTimeline> timeline);
+    void Reset();
+    bool IsBound() const { return m_timeline != nullptr; }
+
+    // Fills frame with one entry per track, in track order within each type.
+    void Evaluate(float timeSec, RS3TimelineTrackFrame& outFrame);
+
+private:
+    std::shared_ptr<const RS3CompiledTimeline> m_timeline;
+    std::vector<uint32_t> m_cursors;
+};
+
+// First light track and first fog track of the frame; the rest only feed tools.
+RS3EnvironmentOverride BuildEnvironmentOverride(const RS3TimelineTrackFrame& frame);
+
+} // namespace RealSpace3
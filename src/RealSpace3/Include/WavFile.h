@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace RealSpace3 {
+
+// Decoded PCM: interleaved float samples, nominal range [-1, 1].
+struct RS3AudioBuffer {
+    uint32_t sampleRate = 48000;
+    uint32_t channels = 2;
+    std::vector<float> samples;
+
+    uint64_t GetFrameCount() const { return channels > 0 ? samples.size() / channels : 0; }
+};
+
+// RIFF/WAVE reader and writer. Reads 8/16/24/32-bit integer PCM and 32-bit float
+// (plain or WAVE_FORMAT_EXTENSIBLE); writes 16-bit PCM.
+class WavFile {
+public:
+    static bool Decode(const uint8_t* data, size_t size, RS3AudioBuffer& outBuffer, std::string* outError = nullptr);
+    static bool Load(const std::string& path, RS3AudioBuffer& outBuffer, std::string* outError = nullptr);
+
+    // Samples are clamped to [-1, 1] and rounded to the nearest 16-bit value.
+    static void EncodePcm16(const RS3AudioBuffer& buffer, std::vector<uint8_t>& outBytes);
+    static bool WritePcm16(const std::string& path, const RS3AudioBuffer& buffer, std::string* outError = nullptr);
+};
+
+} // namespace RealSpace3
@@ -0,0 +1,224 @@
+#include "../Include/AssetFileSystem.h"
+#include "../Include/LoadProfiler.h"
+#include "AppLogger.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <system_error>
+
+namespace RealSpace3 {
+namespace {
+
+namespace fs = std::filesystem;
+
+void SetError(std::string* outError, const std::string& message) {
+    if (outError) *outError = message;
+}
+
+std::string ToAssetKey(const std::string& path) {
+    const size_t prefixLength = std::char_traits<char>::length(AssetFileSystem::kVirtualPrefix);
+    if (AssetFileSystem::IsVirtualPath(path)) return TextureDirectoryIndex::Normalize(path.substr(prefixLength));
+    return TextureDirectoryIndex::Normalize(path);
+}
+
+bool ReadDiskFile(const std::string& filePath, std::vector<uint8_t>& outBytes) {
+    std::ifstream in(fs::path(filePath), std::ios::binary);
+    if (!in.is_open()) return false;
+
+    in.seekg(0, std::ios::end);
+    const std::streamoff size = in.tellg();
+    if (size < 0) return false;
+    in.seekg(0, std::ios::beg);
+
+    outBytes.resize(static_cast<size_t>(size));
+    if (!outBytes.empty()) {
+        in.read(reinterpret_cast<char*>(outBytes.data()), size);
+        if (!in.good() && !in.eof()) return false;
+    }
+    return true;
+}
+
+} // namespace
+
+bool AssetFileSystem::IsVirtualPath(const std::string& path) {
+    return path.compare(0, std::char_traits<char>::length(kVirtualPrefix), kVirtualPrefix) == 0;
+}
+
+std::string AssetFileSystem::MakeVirtualPath(const std::string& path) {
+    return kVirtualPrefix + ToAssetKey(path);
+}
+
+bool AssetFileSystem::MountPack(const std::string& packPath, std::string* outError) {
+    auto pack = std::make_shared<AssetPack>();
+    if (!pack->Open(packPath, outError)) return false;
+
+    std::unique_lock<std::shared_mutex> lock(m_mutex);
+    m_mounts.push_back(Mount{ std::move(pack), std::string() });
+    return true;
+}
+
+bool AssetFileSystem::MountDirectory(const std::string& directory, std::string* outError) {
+    std::error_code ec;
+    if (directory.empty() || !fs::is_directory(directory, ec)) {
+        SetError(outError, "Asset directory not found: " + directory);
+        return false;
+    }
+
+    std::string mounted = directory;
+    std::replace(mounted.begin(), mounted.end(), '\\', '/');
+    while (mounted.size() > 1 && mounted.back() == '/') mounted.pop_back();
+
+    std::unique_lock<std::shared_mutex> lock(m_mutex);
+    m_mounts.push_back(Mount{ nullptr, std::move(mounted) });
+    return true;
+}
+
+void AssetFileSystem::MountDefaultRoots() {
+    std::call_once(m_defaultRootsOnce, [this]() {
+        std::error_code ec;
+        const fs::path cwd = fs::current_path(ec);
+        if (ec) return;
+
+        // The only filesystem probing left on the load path: once per process, per root
+        const std::vector<fs::path> candidates = {
+            cwd / "system" / "rs3",
+            cwd / "OpenGunZ-Client" / "system" / "rs3",
+            cwd / ".." / "OpenGunZ-Client" / "system" / "rs3",
+            cwd / ".." / ".." / "OpenGunZ-Client" / "system" / "rs3",
+        };
+
+        for (const auto& candidate : candidates) {
+            if (!fs::is_directory(candidate, ec)) continue;
+            fs::path root = fs::weakly_canonical(candidate, ec);
+            if (ec) root = candidate;
+
+            std::vector<fs::path> packs;
+            fs::directory_iterator it(root, fs::directory_options::skip_permission_denied, ec);
+            for (const fs::directory_iterator end; !ec && it != end; it.increment(ec)) {
+                std::error_code fileEc;
+                if (!it->is_regular_file(fileEc)) continue;
+                if (TextureDirectoryIndex::Normalize(it->path().extension().string()) == AssetPack::kFileExtension) {
+                    packs.push_back(it->path());
+                }
+            }
+            std::sort(packs.begin(), packs.end());
+
+            for (const auto& packPath : packs) {
+                std::string error;
+                if (!MountPack(packPath.string(), &error)) {
+                    AppLogger::Log("[RS3] AssetFileSystem: pack skipped: " + error);
+                    continue;
+                }
+                AppLogger::Log("[RS3] AssetFileSystem: mounted pack " + packPath.generic_string());
+            }
+            MountDirectory(root.generic_string());
+        }
+    });
+}
+
+bool AssetFileSystem::FindLoose(const std::string& directory, const std::string& key, std::string& outDiskPath) {
+    // The index lists each directory once and answers later misses from memory
+    return m_looseIndex.Resolve(directory + "/" + key, outDiskPath);
+}
+
+bool AssetFileSystem::Exists(const std::string& path) {
+    MountDefaultRoots();
+    const std::string key = ToAssetKey(path);
+    if (key.empty()) return false;
+
+    std::shared_lock<std::shared_mutex> lock(m_mutex);
+    for (const Mount& mount : m_mounts) {
+        if (mount.pack) {
+            if (mount.pack->Find(key) != AssetPack::kInvalidEntry) return true;
+            continue;
+        }
+        std::string diskPath;
+        if (FindLoose(mount.directory, key, diskPath)) return true;
+    }
+    return false;
+}
+
+bool AssetFileSystem::Open(const std::string& path, AssetView& outView, std::string* outError) {
+    outView = AssetView{};
+    MountDefaultRoots();
+    const std::string key = ToAssetKey(path);
+    if (key.empty()) {
+        SetError(outError, "Empty asset path.");
+        return false;
+    }
+
+    std::shared_lock<std::shared_mutex> lock(m_mutex);
+    const Mount* found = nullptr;
+    uint32_t index = AssetPack::kInvalidEntry;
+    std::string diskPath;
+    {
+        LoadScope resolveScope(LoadStage::Resolve, key);
+        for (const Mount& mount : m_mounts) {
+            if (mount.pack) {
+                index = mount.pack->Find(key);
+                if (index == AssetPack::kInvalidEntry) continue;
+            } else if (!FindLoose(mount.directory, key, diskPath)) {
+                continue;
+            }
+            found = &mount;
+            break;
+        }
+    }
+
+    if (!found) {
+        SetError(outError, "Asset not found: " + path);
+        return false;
+    }
+
+    LoadScope readScope(LoadStage::Read, key);
+    if (found->pack) {
+        size_t size = 0;
+        if (const uint8_t* mapped = found->pack->GetMappedData(index, size)) {
+            // Mapped pages fault in on first touch, so this span is short and the
+            // page-in cost lands in the consumer's decode span
+            outView.data = mapped;
+            outView.size = size;
+            outView.owner = found->pack;
+            readScope.AddBytes(size);
+            return true;
+        }
+        auto buffer = std::make_shared<std::vector<uint8_t>>();
+        if (!found->pack->Read(index, *buffer, outError)) return false;
+        outView.data = buffer->data();
+        outView.size = buffer->size();
+        outView.owner = std::move(buffer);
+        readScope.AddBytes(outView.size);
+        return true;
+    }
+
+    auto buffer = std::make_shared<std::vector<uint8_t>>();
+    if (!ReadDiskFile(diskPath, *buffer)) {
+        SetError(outError, "Failed to read " + diskPath);
+        return false;
+    }
+    outView.data = buffer->data();
+    outView.size = buffer->size();
+    outView.diskPath = std::move(diskPath);
+    outView.owner = std::move(buffer);
+    readScope.AddBytes(outView.size);
+    return true;
+}
+
+bool AssetFileSystem::ReadFile(const std::string& path, std::vector<uint8_t>& outBytes, std::string* outError) {
+    AssetView view;
+    if (!Open(path, view, outError)) return false;
+    outBytes.assign(view.data, view.data + view.size);
+    return true;
+}
+
+void AssetFileSystem::InvalidateLooseIndex() {
+    m_looseIndex.Clear();
+}
+
+size_t AssetFileSystem::GetMountCount() const {
+    std::shared_lock<std::shared_mutex> lock(m_mutex);
+    return m_mounts.size();
+}
+
+} // namespace RealSpace3
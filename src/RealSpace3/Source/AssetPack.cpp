@@ -0,0 +1,282 @@
+#include "../Include/AssetPack.h"
+
+#include "../Include/MappedFile.h"
+
+#include <array>
+#include <cstring>
+
+namespace RealSpace3 {
+namespace {
+
+void SetError(std::string* outError, const std::string& message) {
+    if (outError) *outError = message;
+}
+
+constexpr std::array<uint8_t, 8> kPackMagic = { 0x52, 0x53, 0x33, 0x50, 0x41, 0x4B, 0x31, 0x00 }; // RS3PAK1\0
+constexpr uint32_t kPackVersion = 1;
+constexpr size_t kHeaderSize = 64;
+constexpr size_t kEntrySize = 40;
+// An LZ4 sequence byte expands to at most 255 output bytes; the cap keeps a hostile size from
+// reserving more than any packed asset needs
+constexpr uint64_t kMaxLZ4Ratio = 255;
+constexpr uint64_t kMaxLZ4EntrySize = 1ull << 30;
+
+struct PackHeader {
+    uint32_t version = 0;
+    uint32_t entryCount = 0;
+    uint32_t slotCount = 0;
+    uint32_t alignment = 0;
+    uint64_t tocOffset = 0;
+    uint64_t tocSize = 0;
+    uint64_t stringsSize = 0;
+};
+
+struct PackEntry {
+    uint64_t pathHash = 0;
+    uint64_t dataOffset = 0;
+    uint64_t storedSize = 0;
+    uint64_t size = 0;
+    uint32_t pathOffset = 0;
+    uint16_t pathLength = 0;
+    uint8_t compression = 0;
+};
+
+template <typename T>
+T ReadAt(const uint8_t* p) {
+    T value;
+    std::memcpy(&value, p, sizeof(T));
+    return value;
+}
+
+PackEntry ReadEntry(const uint8_t* entries, uint32_t index) {
+    const uint8_t* p = entries + static_cast<size_t>(index) * kEntrySize;
+    PackEntry e;
+    e.pathHash = ReadAt<uint64_t>(p + 0);
+    e.dataOffset = ReadAt<uint64_t>(p + 8);
+    e.storedSize = ReadAt<uint64_t>(p + 16);
+    e.size = ReadAt<uint64_t>(p + 24);
+    e.pathOffset = ReadAt<uint32_t>(p + 32);
+    e.pathLength = ReadAt<uint16_t>(p + 36);
+    e.compression = p[38];
+    return e;
+}
+
+bool ReadLength(const uint8_t* src, size_t srcSize, size_t& ip, size_t& length) {
+    uint8_t b = 0;
+    do {
+        if (ip >= srcSize) return false;
+        b = src[ip++];
+        length += b;
+    } while (b == 255);
+    return true;
+}
+
+} // namespace
+
+AssetPack::AssetPack() = default;
+
+AssetPack::~AssetPack() {
+    Close();
+}
+
+bool AssetPack::Open(const std::string& packPath, std::string* outError) {
+    Close();
+
+    auto mapping = std::make_unique<MappedFile>();
+    if (!mapping->Open(packPath, outError)) return false;
+
+    const uint8_t* base = mapping->GetData();
+    const size_t size = mapping->GetSize();
+    if (size < kHeaderSize || std::memcmp(base, kPackMagic.data(), kPackMagic.size()) != 0) {
+        SetError(outError, "Not an rs3 pack: " + packPath);
+        return false;
+    }
+
+    PackHeader header;
+    header.version = ReadAt<uint32_t>(base + 8);
+    header.entryCount = ReadAt<uint32_t>(base + 12);
+    header.slotCount = ReadAt<uint32_t>(base + 16);
+    header.alignment = ReadAt<uint32_t>(base + 20);
+    header.tocOffset = ReadAt<uint64_t>(base + 24);
+    header.tocSize = ReadAt<uint64_t>(base + 32);
+    header.stringsSize = ReadAt<uint64_t>(base + 40);
+
+    if (header.version != kPackVersion) {
+        SetError(outError, "Unsupported pack version " + std::to_string(header.version) + ": " + packPath);
+        return false;
+    }
+    if (header.slotCount == 0 || (header.slotCount & (header.slotCount - 1)) != 0 || header.slotCount <= header.entryCount) {
+        SetError(outError, "Pack hash table size is invalid: " + packPath);
+        return false;
+    }
+    const uint64_t expectedTocSize = static_cast<uint64_t>(header.entryCount) * kEntrySize + static_cast<uint64_t>(header.slotCount) * 4 + header.stringsSize;
+    if (header.tocOffset % 8 != 0 || header.tocOffset < kHeaderSize || header.tocSize != expectedTocSize ||
+        header.tocOffset > size || header.tocSize > size - header.tocOffset) {
+        SetError(outError, "Pack table of contents is out of range: " + packPath);
+        return false;
+    }
+
+    const uint8_t* entries = base + header.tocOffset;
+    const uint32_t* slots = reinterpret_cast<const uint32_t*>(entries + static_cast<size_t>(header.entryCount) * kEntrySize);
+    const char* strings = reinterpret_cast<const char*>(slots + header.slotCount);
+
+    // Validate once so lookups and reads can trust the table
+    for (uint32_t i = 0; i < header.entryCount; ++i) {
+        const PackEntry e = ReadEntry(entries, i);
+        const bool pathOk = static_cast<uint64_t>(e.pathOffset) + e.pathLength <= header.stringsSize;
+        const bool dataOk = e.dataOffset >= kHeaderSize && e.dataOffset <= header.tocOffset && e.storedSize <= header.tocOffset - e.dataOffset;
+        const bool codecOk = (e.compression == static_cast<uint8_t>(AssetPackCompression::None) && e.storedSize == e.size) ||
+                             (e.compression == static_cast<uint8_t>(AssetPackCompression::LZ4) && e.size <= kMaxLZ4EntrySize &&
+                              e.size <= e.storedSize * kMaxLZ4Ratio);
+        if (!pathOk || !dataOk || !codecOk) {
+            SetError(outError, "Pack entry " + std::to_string(i) + " is invalid: " + packPath);
+            return false;
+        }
+    }
+    uint32_t emptySlots = 0;
+    for (uint32_t s = 0; s < header.slotCount; ++s) {
+        if (slots[s] > header.entryCount) {
+            SetError(outError, "Pack hash slot " + std::to_string(s) + " is invalid: " + packPath);
+            return false;
+        }
+        if (slots[s] == 0) ++emptySlots;
+    }
+    // A miss stops at the first empty slot; a table without one would probe forever
+    if (emptySlots == 0) {
+        SetError(outError, "Pack hash table has no empty slot: " + packPath);
+        return false;
+    }
+
+    m_path = packPath;
+    m_mapping = std::move(mapping);
+    m_base = base;
+    m_size = size;
+    m_entries = entries;
+    m_slots = slots;
+    m_strings = strings;
+    m_stringsSize = static_cast<size_t>(header.stringsSize);
+    m_entryCount = header.entryCount;
+    m_slotMask = header.slotCount - 1;
+    return true;
+}
+
+void AssetPack::Close() {
+    m_mapping.reset();
+    m_path.clear();
+    m_base = nullptr;
+    m_size = 0;
+    m_entries = nullptr;
+    m_slots = nullptr;
+    m_strings = nullptr;
+    m_stringsSize = 0;
+    m_entryCount = 0;
+    m_slotMask = 0;
+}
+
+uint64_t AssetPack::HashPath(const std::string& normalizedPath) {
+    uint64_t hash = 14695981039346656037ull;
+    for (unsigned char c : normalizedPath) {
+        hash ^= c;
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+uint32_t AssetPack::Find(const std::string& normalizedPath) const {
+    if (!m_base) return kInvalidEntry;
+
+    const uint64_t hash = HashPath(normalizedPath);
+    // Linear probing; the packer keeps the table at most half full and Open guarantees an
+    // empty slot, so misses end quickly
+    for (uint32_t slot = static_cast<uint32_t>(hash) & m_slotMask;; slot = (slot + 1) & m_slotMask) {
+        const uint32_t stored = m_slots[slot];
+        if (stored == 0) return kInvalidEntry;
+        const PackEntry e = ReadEntry(m_entries, stored - 1);
+        if (e.pathHash == hash && e.pathLength == normalizedPath.size() &&
+            std::memcmp(m_strings + e.pathOffset, normalizedPath.data(), e.pathLength) == 0) {
+            return stored - 1;
+        }
+    }
+}
+
+bool AssetPack::GetEntryInfo(uint32_t index, AssetPackEntryInfo& outInfo) const {
+    if (index >= m_entryCount) return false;
+    const PackEntry e = ReadEntry(m_entries, index);
+    outInfo.path.assign(m_strings + e.pathOffset, e.pathLength);
+    outInfo.size = e.size;
+    outInfo.storedSize = e.storedSize;
+    outInfo.compression = static_cast<AssetPackCompression>(e.compression);
+    return true;
+}
+
+const uint8_t* AssetPack::GetMappedData(uint32_t index, size_t& outSize) const {
+    outSize = 0;
+    if (index >= m_entryCount) return nullptr;
+    const PackEntry e = ReadEntry(m_entries, index);
+    if (e.compression != static_cast<uint8_t>(AssetPackCompression::None)) return nullptr;
+    outSize = static_cast<size_t>(e.size);
+    return m_base + e.dataOffset;
+}
+
+bool AssetPack::Read(uint32_t index, std::vector<uint8_t>& outBytes, std::string* outError) const {
+    outBytes.clear();
+    if (index >= m_entryCount) {
+        SetError(outError, "Pack entry index out of range.");
+        return false;
+    }
+
+    const PackEntry e = ReadEntry(m_entries, index);
+    const uint8_t* stored = m_base + e.dataOffset;
+    outBytes.resize(static_cast<size_t>(e.size));
+    if (e.compression == static_cast<uint8_t>(AssetPackCompression::None)) {
+        if (e.size > 0) std::memcpy(outBytes.data(), stored, outBytes.size());
+        return true;
+    }
+
+    if (!DecompressLZ4Block(stored, static_cast<size_t>(e.storedSize), outBytes.data(), outBytes.size())) {
+        outBytes.clear();
+        SetError(outError, "Corrupt LZ4 entry '" + std::string(m_strings + e.pathOffset, e.pathLength) + "' in " + m_path);
+        return false;
+    }
+    return true;
+}
+
+bool AssetPack::DecompressLZ4Block(const uint8_t* src, size_t srcSize, uint8_t* dst, size_t dstSize) {
+    size_t ip = 0;
+    size_t op = 0;
+    while (ip < srcSize) {
+        const uint8_t token = src[ip++];
+
+        size_t literals = token >> 4;
+        if (literals == 15 && !ReadLength(src, srcSize, ip, literals)) return false;
+        if (literals > srcSize - ip || literals > dstSize - op) return false;
+        std::memcpy(dst + op, src + ip, literals);
+        ip += literals;
+        op += literals;
+
+        // The last sequence carries literals only
+        if (ip == srcSize) break;
+
+        if (srcSize - ip < 2) return false;
+        const size_t offset = static_cast<size_t>(src[ip]) | (static_cast<size_t>(src[ip + 1]) << 8);
+        ip += 2;
+        if (offset == 0 || offset > op) return false;
+
+        size_t matchLength = token & 15;
+        if (matchLength == 15 && !ReadLength(src, srcSize, ip, matchLength)) return false;
+        matchLength += 4;
+        if (matchLength > dstSize - op) return false;
+
+        const uint8_t* match = dst + op - offset;
+        if (offset >= matchLength) {
+            std::memcpy(dst + op, match, matchLength);
+        } else {
+            // Overlapping copy repeats the last `offset` bytes
+            for (size_t i = 0; i < matchLength; ++i) dst[op + i] = match[i];
+        }
+        op += matchLength;
+    }
+    return op == dstSize;
+}
+
+} // namespace RealSpace3
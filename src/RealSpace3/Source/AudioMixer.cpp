@@ -0,0 +1,223 @@
+#include "../Include/AudioMixer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define RS3_AUDIO_SSE2 1
+#include <emmintrin.h>
+#else
+#define RS3_AUDIO_SSE2 0
+#endif
+
+namespace RealSpace3 {
+namespace {
+
+void SetError(std::string* outError, const std::string& message) {
+    if (outError) *outError = message;
+}
+
+// Gain ramps restart every kRampFrames clip-local frames, so the ramp index stays exact in
+// float and a frame gets the same gain however the mix is split into Render calls.
+constexpr uint64_t kRampFrames = 4096;
+
+uint64_t SecondsToFrames(float seconds, uint32_t sampleRate) {
+    return static_cast<uint64_t>(std::llround(static_cast<double>(std::max(0.0f, seconds)) * sampleRate));
+}
+
+// dst[f] += src[f] * (gainStart + (firstIndex + f) * gainStep) for each stereo frame f.
+void MixStereoRamp(float* dst, const float* src, uint32_t frames, uint32_t firstIndex, float gainStart, float gainStep) {
+    uint32_t f = 0;
+#if RS3_AUDIO_SSE2
+    const float base = static_cast<float>(firstIndex);
+    const __m128 startVec = _mm_set1_ps(gainStart);
+    const __m128 stepVec = _mm_set1_ps(gainStep);
+    const __m128 two = _mm_set1_ps(2.0f);
+    __m128 index = _mm_setr_ps(base, base, base + 1.0f, base + 1.0f);
+    for (; f + 4 <= frames; f += 4) {
+        const __m128 gain0 = _mm_add_ps(startVec, _mm_mul_ps(index, stepVec));
+        index = _mm_add_ps(index, two);
+        const __m128 gain1 = _mm_add_ps(startVec, _mm_mul_ps(index, stepVec));
+        index = _mm_add_ps(index, two);
+        const __m128 mixed0 = _mm_add_ps(_mm_loadu_ps(dst + f * 2), _mm_mul_ps(_mm_loadu_ps(src + f * 2), gain0));
+        const __m128 mixed1 = _mm_add_ps(_mm_loadu_ps(dst + f * 2 + 4), _mm_mul_ps(_mm_loadu_ps(src + f * 2 + 4), gain1));
+        _mm_storeu_ps(dst + f * 2, mixed0);
+        _mm_storeu_ps(dst + f * 2 + 4, mixed1);
+    }
+#endif
+    for (; f < frames; ++f) {
+        const float gain = gainStart + static_cast<float>(firstIndex + f) * gainStep;
+        dst[f * 2] += src[f * 2] * gain;
+        dst[f * 2 + 1] += src[f * 2 + 1] * gain;
+    }
+}
+
+} // namespace
+
+RS3AudioMixer::RS3AudioMixer(uint32_t sampleRate)
+    : m_sampleRate(std::max(1u, sampleRate)) {
+}
+
+void RS3AudioMixer::ConvertToStereo(const RS3AudioBuffer& source, uint32_t sampleRate, RS3AudioBuffer& outBuffer) {
+    outBuffer.sampleRate = std::max(1u, sampleRate);
+    outBuffer.channels = 2;
+    const uint64_t sourceFrames = source.GetFrameCount();
+    if (sourceFrames == 0 || source.sampleRate == 0) {
+        outBuffer.samples.clear();
+        return;
+    }
+
+    const uint32_t channels = source.channels;
+    const auto sampleAt = [&](uint64_t frame, uint32_t channel) {
+        return source.samples[frame * channels + std::min(channel, channels - 1)];
+    };
+
+    if (source.sampleRate == outBuffer.sampleRate) {
+        outBuffer.samples.resize(sourceFrames * 2);
+        for (uint64_t i = 0; i < sourceFrames; ++i) {
+            outBuffer.samples[i * 2] = sampleAt(i, 0);
+            outBuffer.samples[i * 2 + 1] = sampleAt(i, 1);
+        }
+        return;
+    }
+
+    const double ratio = static_cast<double>(source.sampleRate) / outBuffer.sampleRate;
+    const uint64_t frames = std::max<uint64_t>(1, static_cast<uint64_t>(std::llround(sourceFrames / ratio)));
+    outBuffer.samples.resize(frames * 2);
+    for (uint64_t i = 0; i < frames; ++i) {
+        const double position = static_cast<double>(i) * ratio;
+        const uint64_t i0 = std::min(static_cast<uint64_t>(position), sourceFrames - 1);
+        const uint64_t i1 = std::min(i0 + 1, sourceFrames - 1);
+        const float t = static_cast<float>(position - static_cast<double>(i0));
+        for (uint32_t c = 0; c < 2; ++c) {
+            const float a = sampleAt(i0, c);
+            const float b = sampleAt(i1, c);
+            outBuffer.samples[i * 2 + c] = a + (b - a) * t;
+        }
+    }
+}
+
+bool RS3AudioMixer::AddClip(const RS3TimelineAudioClip& clip, std::shared_ptr<const RS3AudioBuffer> source, std::string* outError) {
+    if (!source || source->channels != 2 || source->sampleRate != m_sampleRate) {
+        SetError(outError, "Audio clip '" + clip.file + "' is not stereo at " + std::to_string(m_sampleRate) + " Hz.");
+        return false;
+    }
+
+    Clip entry;
+    entry.startFrame = SecondsToFrames(clip.startSec, m_sampleRate);
+    entry.sourceFrame = SecondsToFrames(clip.trimInSec, m_sampleRate);
+    const uint64_t sourceFrames = source->GetFrameCount();
+    const uint64_t available = sourceFrames > entry.sourceFrame ? sourceFrames - entry.sourceFrame : 0;
+    entry.frameCount = clip.durationSec > 0.0f
+        ? std::min(available, SecondsToFrames(clip.durationSec, m_sampleRate))
+        : available;
+    entry.gain = std::pow(10.0f, clip.gainDb / 20.0f);
+    entry.source = std::move(source);
+
+    // Envelope = min(1, i / fadeIn, (length - i) / fadeOut). When the fades overlap, the ramps
+    // meet at the first frame where the fade-out is the smaller one.
+    const uint64_t length = entry.frameCount;
+    const uint64_t fadeIn = SecondsToFrames(clip.fadeInSec, m_sampleRate);
+    const uint64_t fadeOut = SecondsToFrames(clip.fadeOutSec, m_sampleRate);
+    if (fadeIn > 0 && fadeOut > 0 && fadeIn + fadeOut > length) {
+        const uint64_t cross = (length * fadeIn + fadeIn + fadeOut - 1) / (fadeIn + fadeOut);
+        entry.fadeInEnd = cross;
+        entry.fadeOutStart = cross;
+    } else {
+        entry.fadeInEnd = std::min(fadeIn, length);
+        entry.fadeOutStart = length - std::min(fadeOut, length);
+    }
+    entry.fadeInStep = fadeIn > 0 ? 1.0f / static_cast<float>(fadeIn) : 0.0f;
+    entry.fadeOutStep = fadeOut > 0 ? 1.0f / static_cast<float>(fadeOut) : 0.0f;
+
+    if (entry.frameCount > 0) {
+        m_endFrame = std::max(m_endFrame, entry.startFrame + entry.frameCount);
+        m_clips.push_back(std::move(entry));
+    }
+    return true;
+}
+
+void RS3AudioMixer::MixClip(const Clip& clip, uint64_t startFrame, uint64_t frameCount, float* outStereo) const {
+    const uint64_t begin = std::max(startFrame, clip.startFrame);
+    const uint64_t end = std::min(startFrame + frameCount, clip.startFrame + clip.frameCount);
+    if (begin >= end) return;
+
+    const float* source = clip.source->samples.data() + clip.sourceFrame * 2;
+    float* dst = outStereo + (begin - startFrame) * 2;
+    uint64_t local = begin - clip.startFrame;
+    const uint64_t localEnd = end - clip.startFrame;
+    while (local < localEnd) {
+        // Envelope segment holding `local`: fade-in ramp, flat, or fade-out ramp
+        uint64_t segmentStart = 0;
+        uint64_t segmentEnd = clip.fadeInEnd;
+        int segment = 0;
+        if (local >= clip.fadeOutStart) {
+            segmentStart = clip.fadeOutStart;
+            segmentEnd = clip.frameCount;
+            segment = 2;
+        } else if (local >= clip.fadeInEnd) {
+            segmentStart = clip.fadeInEnd;
+            segmentEnd = clip.fadeOutStart;
+            segment = 1;
+        }
+
+        const uint64_t anchor = std::max(segmentStart, local - local % kRampFrames);
+        const uint64_t chunkEnd = std::min({ segmentEnd, anchor - anchor % kRampFrames + kRampFrames, localEnd });
+        float gainStart = clip.gain;
+        float gainStep = 0.0f;
+        if (segment == 0) {
+            gainStart = clip.gain * (static_cast<float>(anchor) * clip.fadeInStep);
+            gainStep = clip.gain * clip.fadeInStep;
+        } else if (segment == 2) {
+            gainStart = clip.gain * (static_cast<float>(clip.frameCount - anchor) * clip.fadeOutStep);
+            gainStep = -clip.gain * clip.fadeOutStep;
+        }
+
+        const uint32_t frames = static_cast<uint32_t>(chunkEnd - local);
+        MixStereoRamp(dst, source + local * 2, frames, static_cast<uint32_t>(local - anchor), gainStart, gainStep);
+        dst += static_cast<size_t>(frames) * 2;
+        local = chunkEnd;
+    }
+}
+
+void RS3AudioMixer::Render(uint64_t startFrame, uint64_t frameCount, float* outStereo) const {
+    std::fill(outStereo, outStereo + frameCount * 2, 0.0f);
+    for (const Clip& clip : m_clips) {
+        MixClip(clip, startFrame, frameCount, outStereo);
+    }
+}
+
+uint64_t GetTimelineAudioFrameCount(float durationSec, int fps, uint32_t sampleRate) {
+    const int videoFrames = GetTimelineFrameCount(durationSec, fps);
+    return static_cast<uint64_t>(std::llround(static_cast<double>(videoFrames) * sampleRate / std::max(1, fps)));
+}
+
+bool RenderTimelineAudio(const RS3TimelineAudio& audio, uint64_t frameCount, uint32_t sampleRate,
+                         RS3AudioBuffer& outBuffer, std::string* outError) {
+    RS3AudioMixer mixer(sampleRate);
+    std::map<std::string, std::shared_ptr<const RS3AudioBuffer>> sources;
+    for (const RS3TimelineAudioClip& clip : GetTimelineAudioClips(audio)) {
+        std::shared_ptr<const RS3AudioBuffer>& source = sources[clip.file];
+        if (!source) {
+            RS3AudioBuffer decoded;
+            if (!WavFile::Load(clip.file, decoded, outError)) {
+                return false;
+            }
+            auto stereo = std::make_shared<RS3AudioBuffer>();
+            RS3AudioMixer::ConvertToStereo(decoded, mixer.GetSampleRate(), *stereo);
+            source = std::move(stereo);
+        }
+        if (!mixer.AddClip(clip, source, outError)) {
+            return false;
+        }
+    }
+
+    outBuffer.sampleRate = mixer.GetSampleRate();
+    outBuffer.channels = 2;
+    outBuffer.samples.resize(frameCount * 2);
+    mixer.Render(0, frameCount, outBuffer.samples.data());
+    return true;
+}
+
+} // namespace RealSpace3
@@ -0,0 +1,467 @@
+#include "../Include/BCnDecoder.h"
+
+#include <algorithm>
+#include <cstring>
+#include <thread>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define RS3_BCN_SSE2 1
+#include <emmintrin.h>
+#else
+#define RS3_BCN_SSE2 0
+#endif
+
+namespace RealSpace3 {
+namespace {
+
+void SetError(std::string* outError, const std::string& message) {
+    if (outError) *outError = message;
+}
+
+uint32_t PackRGBA(uint32_t r, uint32_t g, uint32_t b, uint32_t a) {
+    return r | (g << 8) | (b << 16) | (a << 24);
+}
+
+uint16_t ReadU16(const uint8_t* p) {
+    return static_cast<uint16_t>(p[0] | (p[1] << 8));
+}
+
+uint32_t ReadU32(const uint8_t* p) {
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) | (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+// 5/6-bit -> 8-bit with round-to-nearest, matching decodeBC1 in rs3_texture_converter.js.
+struct Expand565Tables {
+    uint8_t five[32];
+    uint8_t six[64];
+
+    Expand565Tables() {
+        for (uint32_t v = 0; v < 32; ++v) five[v] = static_cast<uint8_t>((v * 510 + 31) / 62);
+        for (uint32_t v = 0; v < 64; ++v) six[v] = static_cast<uint8_t>((v * 510 + 63) / 126);
+    }
+};
+
+const Expand565Tables& GetExpand565() {
+    static const Expand565Tables tables;
+    return tables;
+}
+
+// Writes 16 texels selected by 2-bit indices (texel i uses bits 2i..2i+1).
+void ExpandIndices2(const uint32_t palette[4], uint32_t indices, uint8_t* outRGBA) {
+#if RS3_BCN_SSE2
+    // Each lane isolates its own 2-bit field of the row byte and compares it against
+    // the field pattern of every palette entry; the masks then select the colour.
+    const __m128i fieldMask = _mm_setr_epi32(0x03, 0x0C, 0x30, 0xC0);
+    const __m128i fieldOne = _mm_setr_epi32(0x01, 0x04, 0x10, 0x40);
+    const __m128i fieldTwo = _mm_add_epi32(fieldOne, fieldOne);
+    const __m128i p0 = _mm_set1_epi32(static_cast<int>(palette[0]));
+    const __m128i p1 = _mm_set1_epi32(static_cast<int>(palette[1]));
+    const __m128i p2 = _mm_set1_epi32(static_cast<int>(palette[2]));
+    const __m128i p3 = _mm_set1_epi32(static_cast<int>(palette[3]));
+    for (uint32_t row = 0; row < 4; ++row) {
+        const __m128i fields = _mm_and_si128(_mm_set1_epi32(static_cast<int>((indices >> (row * 8)) & 0xFF)), fieldMask);
+        const __m128i is1 = _mm_cmpeq_epi32(fields, fieldOne);
+        const __m128i is2 = _mm_cmpeq_epi32(fields, fieldTwo);
+        const __m128i is3 = _mm_cmpeq_epi32(fields, fieldMask);
+        const __m128i any = _mm_or_si128(_mm_or_si128(is1, is2), is3);
+        __m128i texels = _mm_andnot_si128(any, p0);
+        texels = _mm_or_si128(texels, _mm_and_si128(is1, p1));
+        texels = _mm_or_si128(texels, _mm_and_si128(is2, p2));
+        texels = _mm_or_si128(texels, _mm_and_si128(is3, p3));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(outRGBA + row * 16), texels);
+    }
+#else
+    for (uint32_t i = 0; i < 16; ++i) {
+        const uint32_t texel = palette[(indices >> (i * 2)) & 0x3];
+        std::memcpy(outRGBA + i * 4, &texel, 4);
+    }
+#endif
+}
+
+void DecodeColorBlock(const uint8_t* block, bool forceFourColor, uint8_t* outRGBA) {
+    const Expand565Tables& expand = GetExpand565();
+    const uint16_t c0 = ReadU16(block);
+    const uint16_t c1 = ReadU16(block + 2);
+    const uint32_t indices = ReadU32(block + 4);
+
+    const uint32_t r0 = expand.five[(c0 >> 11) & 0x1F], g0 = expand.six[(c0 >> 5) & 0x3F], b0 = expand.five[c0 & 0x1F];
+    const uint32_t r1 = expand.five[(c1 >> 11) & 0x1F], g1 = expand.six[(c1 >> 5) & 0x3F], b1 = expand.five[c1 & 0x1F];
+
+    uint32_t palette[4];
+    palette[0] = PackRGBA(r0, g0, b0, 255);
+    palette[1] = PackRGBA(r1, g1, b1, 255);
+    if (c0 > c1 || forceFourColor) {
+        palette[2] = PackRGBA((2 * r0 + r1 + 1) / 3, (2 * g0 + g1 + 1) / 3, (2 * b0 + b1 + 1) / 3, 255);
+        palette[3] = PackRGBA((r0 + 2 * r1 + 1) / 3, (g0 + 2 * g1 + 1) / 3, (b0 + 2 * b1 + 1) / 3, 255);
+    } else {
+        palette[2] = PackRGBA((r0 + r1 + 1) / 2, (g0 + g1 + 1) / 2, (b0 + b1 + 1) / 2, 255);
+        palette[3] = 0;
+    }
+    ExpandIndices2(palette, indices, outRGBA);
+}
+
+// BC3 alpha / BC4 / BC5 channel block: two endpoints and 16 3-bit indices.
+void DecodeChannelBlock(const uint8_t* block, uint8_t outValues[16]) {
+    const uint32_t a0 = block[0];
+    const uint32_t a1 = block[1];
+    uint8_t palette[8];
+    palette[0] = static_cast<uint8_t>(a0);
+    palette[1] = static_cast<uint8_t>(a1);
+    if (a0 > a1) {
+        for (uint32_t i = 1; i < 7; ++i) palette[i + 1] = static_cast<uint8_t>(((7 - i) * a0 + i * a1 + 3) / 7);
+    } else {
+        for (uint32_t i = 1; i < 5; ++i) palette[i + 1] = static_cast<uint8_t>(((5 - i) * a0 + i * a1 + 2) / 5);
+        palette[6] = 0;
+        palette[7] = 255;
+    }
+
+    uint64_t bits = 0;
+    for (uint32_t i = 0; i < 6; ++i) bits |= static_cast<uint64_t>(block[2 + i]) << (8 * i);
+    for (uint32_t i = 0; i < 16; ++i) outValues[i] = palette[(bits >> (3 * i)) & 0x7];
+}
+
+// ---------------------------------------------------------------------------
+// BC7
+// ---------------------------------------------------------------------------
+
+struct Bc7ModeInfo {
+    uint8_t subsets;
+    uint8_t partitionBits;
+    uint8_t rotationBits;
+    uint8_t indexSelectionBits;
+    uint8_t colorBits;
+    uint8_t alphaBits;
+    uint8_t endpointPBits;
+    uint8_t sharedPBits;
+    uint8_t indexBits;
+    uint8_t indexBits2;
+};
+
+const Bc7ModeInfo kBc7Modes[8] = {
+    { 3, 4, 0, 0, 4, 0, 1, 0, 3, 0 },
+    { 2, 6, 0, 0, 6, 0, 0, 1, 3, 0 },
+    { 3, 6, 0, 0, 5, 0, 0, 0, 2, 0 },
+    { 2, 6, 0, 0, 7, 0, 1, 0, 2, 0 },
+    { 1, 0, 2, 1, 5, 6, 0, 0, 2, 3 },
+    { 1, 0, 2, 0, 7, 8, 0, 0, 2, 2 },
+    { 1, 0, 0, 0, 7, 7, 1, 0, 4, 0 },
+    { 2, 6, 0, 0, 5, 5, 1, 0, 2, 0 },
+};
+
+// Bit i = subset of texel i.
+const uint16_t kBc7Partitions2[64] = {
+    0xCCCC, 0x8888, 0xEEEE, 0xECC8, 0xC880, 0xFEEC, 0xFEC8, 0xEC80,
+    0xC800, 0xFFEC, 0xFE80, 0xE800, 0xFFE8, 0xFF00, 0xFFF0, 0xF000,
+    0xF710, 0x008E, 0x7100, 0x08CE, 0x008C, 0x7310, 0x3100, 0x8CCE,
+    0x088C, 0x3110, 0x6666, 0x366C, 0x17E8, 0x0FF0, 0x718E, 0x399C,
+    0xAAAA, 0xF0F0, 0x5A5A, 0x33CC, 0x3C3C, 0x55AA, 0x9696, 0xA55A,
+    0x73CE, 0x13C8, 0x324C, 0x3BDC, 0x6996, 0xC33C, 0x9966, 0x0660,
+    0x0272, 0x04E4, 0x4E40, 0x2720, 0xC936, 0x936C, 0x39C6, 0x639C,
+    0x9336, 0x9CC6, 0x817E, 0xE718, 0xCCF0, 0x0FCC, 0x7744, 0xEE22,
+};
+
+// Bits 2i..2i+1 = subset of texel i.
+const uint32_t kBc7Partitions3[64] = {
+    0xAA685050, 0x6A5A5040, 0x5A5A4200, 0x5450A0A8, 0xA5A50000, 0xA0A05050, 0x5555A0A0, 0x5A5A5050,
+    0xAA550000, 0xAA555500, 0xAAAA5500, 0x90909090, 0x94949494, 0xA4A4A4A4, 0xA9A59450, 0x2A0A4250,
+    0xA5945040, 0x0A425054, 0xA5A5A500, 0x55A0A0A0, 0xA8A85454, 0x6A6A4040, 0xA4A45000, 0x1A1A0500,
+    0x0050A4A4, 0xAAA59090, 0x14696914, 0x69691400, 0xA08585A0, 0xAA821414, 0x50A4A450, 0x6A5A0200,
+    0xA9A58000, 0x5090A0A8, 0xA8A09050, 0x24242424, 0x00AA5500, 0x24924924, 0x24499224, 0x50A50A50,
+    0x500AA550, 0xAAAA4444, 0x66660000, 0xA5A0A5A0, 0x50A050A0, 0x69286928, 0x44AAAA44, 0x66666600,
+    0xAA444444, 0x54A854A8, 0x95809580, 0x96969600, 0xA85454A8, 0x80959580, 0xAA141414, 0x96960000,
+    0xAAAA1414, 0xA05050A0, 0xA0A5A5A0, 0x96000000, 0x40804080, 0xA9A8A9A8, 0xAAAAAA44, 0x2A4A5254,
+};
+
+const uint8_t kBc7Anchor2[64] = {
+    15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15,
+    15,  2,  8,  2,  2,  8,  8, 15,  2,  8,  2,  2,  8,  8,  2,  2,
+    15, 15,  6,  8,  2,  8, 15, 15,  2,  8,  2,  2,  2, 15, 15,  6,
+     6,  2,  6,  8, 15, 15,  2,  2, 15, 15, 15, 15, 15,  2,  2, 15,
+};
+
+const uint8_t kBc7Anchor3Second[64] = {
+     3,  3, 15, 15,  8,  3, 15, 15,  8,  8,  6,  6,  6,  5,  3,  3,
+     3,  3,  8, 15,  3,  3,  6, 10,  5,  8,  8,  6,  8,  5, 15, 15,
+     8, 15,  3,  5,  6, 10,  8, 15, 15,  3, 15,  5, 15, 15, 15, 15,
+     3, 15,  5,  5,  5,  8,  5, 10,  5, 10,  8, 13, 15, 12,  3,  3,
+};
+
+const uint8_t kBc7Anchor3Third[64] = {
+    15,  8,  8,  3, 15, 15,  3,  8, 15, 15, 15, 15, 15, 15, 15,  8,
+    15,  8, 15,  3, 15,  8, 15,  8,  3, 15,  6, 10, 15, 15, 10,  8,
+    15,  3, 15, 10, 10,  8,  9, 10,  6, 15,  8, 15,  3,  6,  6,  8,
+    15,  3, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15,  3, 15, 15,  8,
+};
+
+const uint8_t kBc7Weights2[4] = { 0, 21, 43, 64 };
+const uint8_t kBc7Weights3[8] = { 0, 9, 18, 27, 37, 46, 55, 64 };
+const uint8_t kBc7Weights4[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+class Bc7BitReader {
+public:
+    explicit Bc7BitReader(const uint8_t* block) {
+        for (uint32_t i = 0; i < 8; ++i) {
+            m_lo |= static_cast<uint64_t>(block[i]) << (8 * i);
+            m_hi |= static_cast<uint64_t>(block[8 + i]) << (8 * i);
+        }
+    }
+
+    uint32_t Read(uint32_t count) {
+        if (count == 0) return 0;
+        uint64_t value;
+        if (m_pos >= 64) {
+            value = m_hi >> (m_pos - 64);
+        } else if (m_pos + count <= 64) {
+            value = m_lo >> m_pos;
+        } else {
+            value = (m_lo >> m_pos) | (m_hi << (64 - m_pos));
+        }
+        m_pos += count;
+        return static_cast<uint32_t>(value & ((1u << count) - 1));
+    }
+
+private:
+    uint64_t m_lo = 0;
+    uint64_t m_hi = 0;
+    uint32_t m_pos = 0;
+};
+
+uint8_t Bc7Interpolate(uint32_t e0, uint32_t e1, uint32_t index, uint32_t indexBits) {
+    const uint8_t* weights = indexBits == 2 ? kBc7Weights2 : (indexBits == 3 ? kBc7Weights3 : kBc7Weights4);
+    const uint32_t w = weights[index];
+    return static_cast<uint8_t>(((64 - w) * e0 + w * e1 + 32) >> 6);
+}
+
+void DecodeBC7Block(const uint8_t* block, uint8_t* outRGBA) {
+    uint32_t mode = 0;
+    while (mode < 8 && !(block[0] & (1u << mode))) ++mode;
+    if (mode >= 8) {
+        // Reserved mode: the spec decodes it as transparent black.
+        std::memset(outRGBA, 0, 64);
+        return;
+    }
+
+    const Bc7ModeInfo& info = kBc7Modes[mode];
+    Bc7BitReader bits(block);
+    bits.Read(mode + 1);
+    const uint32_t partition = bits.Read(info.partitionBits);
+    const uint32_t rotation = bits.Read(info.rotationBits);
+    const uint32_t indexSelection = bits.Read(info.indexSelectionBits);
+
+    // endpoints[subset * 2 + endpoint][channel]
+    uint32_t endpoints[6][4] = {};
+    const uint32_t endpointCount = info.subsets * 2u;
+    for (uint32_t c = 0; c < 3; ++c) {
+        for (uint32_t e = 0; e < endpointCount; ++e) endpoints[e][c] = bits.Read(info.colorBits);
+    }
+    if (info.alphaBits) {
+        for (uint32_t e = 0; e < endpointCount; ++e) endpoints[e][3] = bits.Read(info.alphaBits);
+    }
+
+    uint32_t colorPrecision = info.colorBits;
+    uint32_t alphaPrecision = info.alphaBits;
+    if (info.endpointPBits || info.sharedPBits) {
+        uint32_t pbits[6] = {};
+        if (info.endpointPBits) {
+            for (uint32_t e = 0; e < endpointCount; ++e) pbits[e] = bits.Read(1);
+        } else {
+            for (uint32_t s = 0; s < info.subsets; ++s) pbits[s * 2] = pbits[s * 2 + 1] = bits.Read(1);
+        }
+        for (uint32_t e = 0; e < endpointCount; ++e) {
+            for (uint32_t c = 0; c < 4; ++c) endpoints[e][c] = (endpoints[e][c] << 1) | pbits[e];
+        }
+        ++colorPrecision;
+        if (alphaPrecision) ++alphaPrecision;
+    }
+
+    for (uint32_t e = 0; e < endpointCount; ++e) {
+        for (uint32_t c = 0; c < 3; ++c) {
+            const uint32_t v = endpoints[e][c] << (8 - colorPrecision);
+            endpoints[e][c] = v | (v >> colorPrecision);
+        }
+        if (alphaPrecision) {
+            const uint32_t v = endpoints[e][3] << (8 - alphaPrecision);
+            endpoints[e][3] = v | (v >> alphaPrecision);
+        } else {
+            endpoints[e][3] = 255;
+        }
+    }
+
+    uint32_t subsetOf[16] = {};
+    uint32_t anchor1 = 0;
+    uint32_t anchor2 = 0;
+    if (info.subsets == 2) {
+        for (uint32_t i = 0; i < 16; ++i) subsetOf[i] = (kBc7Partitions2[partition] >> i) & 0x1;
+        anchor1 = kBc7Anchor2[partition];
+    } else if (info.subsets == 3) {
+        for (uint32_t i = 0; i < 16; ++i) subsetOf[i] = (kBc7Partitions3[partition] >> (i * 2)) & 0x3;
+        anchor1 = kBc7Anchor3Second[partition];
+        anchor2 = kBc7Anchor3Third[partition];
+    }
+
+    uint32_t indices[16];
+    for (uint32_t i = 0; i < 16; ++i) {
+        const bool anchor = i == 0 || (info.subsets > 1 && i == anchor1) || (info.subsets > 2 && i == anchor2);
+        indices[i] = bits.Read(info.indexBits - (anchor ? 1u : 0u));
+    }
+    uint32_t indices2[16] = {};
+    if (info.indexBits2) {
+        for (uint32_t i = 0; i < 16; ++i) indices2[i] = bits.Read(info.indexBits2 - (i == 0 ? 1u : 0u));
+    }
+
+    for (uint32_t i = 0; i < 16; ++i) {
+        const uint32_t* e0 = endpoints[subsetOf[i] * 2];
+        const uint32_t* e1 = endpoints[subsetOf[i] * 2 + 1];
+        uint32_t colorIndex = indices[i], colorBits = info.indexBits;
+        uint32_t alphaIndex = indices[i], alphaBits = info.indexBits;
+        if (info.indexBits2) {
+            if (indexSelection) {
+                colorIndex = indices2[i]; colorBits = info.indexBits2;
+            } else {
+                alphaIndex = indices2[i]; alphaBits = info.indexBits2;
+            }
+        }
+
+        uint8_t* texel = outRGBA + i * 4;
+        for (uint32_t c = 0; c < 3; ++c) texel[c] = Bc7Interpolate(e0[c], e1[c], colorIndex, colorBits);
+        texel[3] = Bc7Interpolate(e0[3], e1[3], alphaIndex, alphaBits);
+        if (rotation) std::swap(texel[3], texel[rotation - 1]);
+    }
+}
+
+void DecodeBlockRows(BCnFormat format, uint32_t width, uint32_t height, const uint8_t* data,
+                     uint8_t* outRGBA, size_t outRowPitch, uint32_t firstBlockRow, uint32_t lastBlockRow) {
+    const uint32_t blocksX = (width + 3) / 4;
+    const size_t blockBytes = BCnDecoder::GetBlockBytes(format);
+    alignas(16) uint8_t texels[64];
+
+    for (uint32_t by = firstBlockRow; by < lastBlockRow; ++by) {
+        const uint8_t* block = data + static_cast<size_t>(by) * blocksX * blockBytes;
+        const uint32_t y = by * 4;
+        const uint32_t rows = std::min<uint32_t>(4, height - y);
+        for (uint32_t bx = 0; bx < blocksX; ++bx, block += blockBytes) {
+            BCnDecoder::DecodeBlock(format, block, texels);
+            const uint32_t x = bx * 4;
+            const size_t rowBytes = static_cast<size_t>(std::min<uint32_t>(4, width - x)) * 4;
+            for (uint32_t r = 0; r < rows; ++r) {
+                std::memcpy(outRGBA + (y + r) * outRowPitch + static_cast<size_t>(x) * 4, texels + r * 16, rowBytes);
+            }
+        }
+    }
+}
+
+} // namespace
+
+size_t BCnDecoder::GetBlockBytes(BCnFormat format) {
+    switch (format) {
+    case BCnFormat::BC1:
+    case BCnFormat::BC4:
+        return 8;
+    default:
+        return 16;
+    }
+}
+
+size_t BCnDecoder::GetCompressedSize(BCnFormat format, uint32_t width, uint32_t height) {
+    const size_t blocksX = (static_cast<size_t>(width) + 3) / 4;
+    const size_t blocksY = (static_cast<size_t>(height) + 3) / 4;
+    return blocksX * blocksY * GetBlockBytes(format);
+}
+
+bool BCnDecoder::HasSimd() {
+    return RS3_BCN_SSE2 != 0;
+}
+
+void BCnDecoder::DecodeBlock(BCnFormat format, const uint8_t* block, uint8_t* outRGBA) {
+    switch (format) {
+    case BCnFormat::BC1:
+        DecodeColorBlock(block, false, outRGBA);
+        break;
+    case BCnFormat::BC2:
+        DecodeColorBlock(block + 8, true, outRGBA);
+        for (uint32_t i = 0; i < 16; ++i) {
+            const uint32_t nibble = (block[i / 2] >> ((i & 1) * 4)) & 0xF;
+            outRGBA[i * 4 + 3] = static_cast<uint8_t>((nibble << 4) | nibble);
+        }
+        break;
+    case BCnFormat::BC3: {
+        uint8_t alpha[16];
+        DecodeChannelBlock(block, alpha);
+        DecodeColorBlock(block + 8, true, outRGBA);
+        for (uint32_t i = 0; i < 16; ++i) outRGBA[i * 4 + 3] = alpha[i];
+        break;
+    }
+    case BCnFormat::BC4: {
+        uint8_t red[16];
+        DecodeChannelBlock(block, red);
+        for (uint32_t i = 0; i < 16; ++i) {
+            const uint32_t texel = PackRGBA(red[i], 0, 0, 255);
+            std::memcpy(outRGBA + i * 4, &texel, 4);
+        }
+        break;
+    }
+    case BCnFormat::BC5: {
+        uint8_t red[16];
+        uint8_t green[16];
+        DecodeChannelBlock(block, red);
+        DecodeChannelBlock(block + 8, green);
+        for (uint32_t i = 0; i < 16; ++i) {
+            const uint32_t texel = PackRGBA(red[i], green[i], 0, 255);
+            std::memcpy(outRGBA + i * 4, &texel, 4);
+        }
+        break;
+    }
+    case BCnFormat::BC7:
+        DecodeBC7Block(block, outRGBA);
+        break;
+    }
+}
+
+bool BCnDecoder::Decode(BCnFormat format, uint32_t width, uint32_t height, const uint8_t* data, size_t dataSize,
+                        uint8_t* outRGBA, size_t outRowPitch, uint32_t threadCount, std::string* outError) {
+    if (!data || !outRGBA || width == 0 || height == 0) {
+        SetError(outError, "Invalid BCn decode arguments.");
+        return false;
+    }
+    if (outRowPitch < static_cast<size_t>(width) * 4) {
+        SetError(outError, "Output row pitch is smaller than width * 4.");
+        return false;
+    }
+    if (dataSize < GetCompressedSize(format, width, height)) {
+        SetError(outError, "Compressed data is smaller than the expected block count.");
+        return false;
+    }
+
+    const uint32_t blocksY = (height + 3) / 4;
+    uint32_t workers = threadCount ? threadCount : std::max(1u, std::thread::hardware_concurrency());
+    workers = std::min(workers, std::max(1u, blocksY / kMinBlockRowsPerThread));
+
+    if (workers <= 1) {
+        DecodeBlockRows(format, width, height, data, outRGBA, outRowPitch, 0, blocksY);
+        return true;
+    }
+
+    // Contiguous bands of block rows; the calling thread takes the first band.
+    const uint32_t rowsPerWorker = (blocksY + workers - 1) / workers;
+    std::vector<std::thread> threads;
+    threads.reserve(workers - 1);
+    for (uint32_t first = rowsPerWorker; first < blocksY; first += rowsPerWorker) {
+        const uint32_t last = std::min(blocksY, first + rowsPerWorker);
+        threads.emplace_back(DecodeBlockRows, format, width, height, data, outRGBA, outRowPitch, first, last);
+    }
+    DecodeBlockRows(format, width, height, data, outRGBA, outRowPitch, 0, std::min(blocksY, rowsPerWorker));
+    for (auto& thread : threads) thread.join();
+    return true;
+}
+
+bool BCnDecoder::Decode(BCnFormat format, uint32_t width, uint32_t height, const uint8_t* data, size_t dataSize,
+                        std::vector<uint8_t>& outRGBA, uint32_t threadCount, std::string* outError) {
+    outRGBA.assign(static_cast<size_t>(width) * height * 4, 0);
+    if (!Decode(format, width, height, data, dataSize, outRGBA.data(), static_cast<size_t>(width) * 4, threadCount, outError)) {
+        outRGBA.clear();
+        return false;
+    }
+    return true;
+}
+
+} // namespace RealSpace3
@@ -8,43 +8,38 @@ namespace {
 
 constexpr float kEpsilon = 1e-6f;
 
-float Clamp01(float t) {
-    return std::max(0.0f, std::min(1.0f, t));
-}
-
-float Length(const DirectX::XMFLOAT3& v) {
-    return std::sqrt(v.x * v.x + v.y * v.y + v.z * v.z);
-}
-
-DirectX::XMFLOAT3 Subtract(const DirectX::XMFLOAT3& a, const DirectX::XMFLOAT3& b) {
-    return { a.x - b.x, a.y - b.y, a.z - b.z };
-}
-
-DirectX::XMFLOAT3 Lerp(const DirectX::XMFLOAT3& a, const DirectX::XMFLOAT3& b, float t) {
+DirectX::XMFLOAT3 Combine(float a, const DirectX::XMFLOAT3& p, float b, const DirectX::XMFLOAT3& q,
+                          float c, const DirectX::XMFLOAT3& r, float d, const DirectX::XMFLOAT3& s) {
     return {
-        a.x + (b.x - a.x) * t,
-        a.y + (b.y - a.y) * t,
-        a.z + (b.z - a.z) * t
+        a * p.x + b * q.x + c * r.x + d * s.x,
+        a * p.y + b * q.y + c * r.y + d * s.y,
+        a * p.z + b * q.z + c * r.z + d * s.z
     };
 }
 
 } // namespace
 
 bool CinematicPlayer::Play(const RS3TimelineData& timeline, const RS3TimelinePlaybackOptions& options, std::string* outError) {
-    if (timeline.keyframes.empty()) {
-        if (outError) *outError = "Timeline has no camera keyframes.";
+    auto compiled = std::make_shared<RS3CompiledTimeline>();
+    if (!compiled->LoadFromTimeline(timeline, outError)) {
         return false;
     }
+    return Play(std::move(compiled), options, outError);
+}
 
-    m_timeline = timeline;
-    std::sort(m_timeline.keyframes.begin(), m_timeline.keyframes.end(), [](const RS3TimelineKeyframe& a, const RS3TimelineKeyframe& b) {
-        return a.t < b.t;
-    });
+bool CinematicPlayer::Play(std::shared_ptr<const RS3CompiledTimeline> timeline, const RS3TimelinePlaybackOptions& options, std::string* outError) {
+    if (!timeline || timeline->GetKeyframeCount() == 0) {
+        if (outError) *outError = "Timeline has no camera keyframes.";
+        return false;
+    }
 
+    m_timeline = std::move(timeline);
+    BuildSegmentCurves();
+    m_tracks.Bind(m_timeline);
     m_options = options;
-    m_durationSec = std::max(0.0f, m_timeline.durationSec);
+    m_durationSec = std::max(0.0f, m_timeline->GetDurationSec());
     if (m_durationSec <= 0.0f) {
-        m_durationSec = std::max(0.0f, m_timeline.keyframes.back().t);
+        m_durationSec = std::max(0.0f, m_timeline->GetKeyframes()[m_timeline->GetKeyframeCount() - 1].t);
     }
 
     m_startTimeSec = std::max(0.0f, std::min(options.startTimeSec, m_durationSec));
@@ -72,7 +67,10 @@ void CinematicPlayer::Stop() {
     m_durationSec = 0.0f;
     m_startTimeSec = 0.0f;
     m_endTimeSec = 0.0f;
-    m_timeline = RS3TimelineData{};
+    m_timeline.reset();
+    m_curves.clear();
+    m_segmentCursor = 0;
+    m_tracks.Reset();
 }
 
 void CinematicPlayer::Pause(bool paused) {
@@ -107,72 +105,68 @@ void CinematicPlayer::Update(float deltaTimeSec) {
     }
 }
 
-float CinematicPlayer::ApplyEase(float t, RS3TimelineEase ease) {
-    const float x = Clamp01(t);
-    if (ease == RS3TimelineEase::EaseInOutCubic) {
-        if (x < 0.5f) {
-            return 4.0f * x * x * x;
-        }
-        const float n = -2.0f * x + 2.0f;
-        return 1.0f - (n * n * n) * 0.5f;
+void CinematicPlayer::BuildSegmentCurves() {
+    m_curves.clear();
+    m_segmentCursor = 0;
+
+    const uint32_t keyframeCount = m_timeline->GetKeyframeCount();
+    if (keyframeCount < 2) return;
+
+    const RS3CompiledKeyframe* keyframes = m_timeline->GetKeyframes();
+    const RS3CompiledSegment* segments = m_timeline->GetSegments();
+    m_curves.resize(keyframeCount - 1);
+    for (uint32_t i = 0; i + 1 < keyframeCount; ++i) {
+        const DirectX::XMFLOAT3& p1 = keyframes[i].position;
+        const DirectX::XMFLOAT3& p2 = keyframes[i + 1].position;
+        const DirectX::XMFLOAT3& m1 = segments[i].tangentStart;
+        const DirectX::XMFLOAT3& m2 = segments[i].tangentEnd;
+
+        SegmentCurve& curve = m_curves[i];
+        curve.c0 = p1;
+        curve.c1 = m1;
+        curve.c2 = Combine(-3.0f, p1, -2.0f, m1, 3.0f, p2, -1.0f, m2);
+        curve.c3 = Combine(2.0f, p1, 1.0f, m1, -2.0f, p2, 1.0f, m2);
     }
-    return x;
 }
 
-DirectX::XMFLOAT3 CinematicPlayer::CatmullRom(
-    const DirectX::XMFLOAT3& p0,
-    const DirectX::XMFLOAT3& p1,
-    const DirectX::XMFLOAT3& p2,
-    const DirectX::XMFLOAT3& p3,
-    float t) {
-    const float t2 = t * t;
-    const float t3 = t2 * t;
-    return {
-        0.5f * ((2.0f * p1.x) + (-p0.x + p2.x) * t + (2.0f * p0.x - 5.0f * p1.x + 4.0f * p2.x - p3.x) * t2 + (-p0.x + 3.0f * p1.x - 3.0f * p2.x + p3.x) * t3),
-        0.5f * ((2.0f * p1.y) + (-p0.y + p2.y) * t + (2.0f * p0.y - 5.0f * p1.y + 4.0f * p2.y - p3.y) * t2 + (-p0.y + 3.0f * p1.y - 3.0f * p2.y + p3.y) * t3),
-        0.5f * ((2.0f * p1.z) + (-p0.z + p2.z) * t + (2.0f * p0.z - 5.0f * p1.z + 4.0f * p2.z - p3.z) * t2 + (-p0.z + 3.0f * p1.z - 3.0f * p2.z + p3.z) * t3)
-    };
-}
+size_t CinematicPlayer::FindSegment(float t) const {
+    const RS3CompiledKeyframe* keyframes = m_timeline->GetKeyframes();
+    const size_t lastSegment = m_timeline->GetKeyframeCount() - 2;
 
-DirectX::XMVECTOR CinematicPlayer::BuildCameraQuaternion(const RS3TimelineKeyframe& keyframe) {
-    const DirectX::XMVECTOR baseForward = DirectX::XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f);
-    const DirectX::XMVECTOR baseUp = DirectX::XMVectorSet(0.0f, 0.0f, 1.0f, 0.0f);
-
-    const DirectX::XMFLOAT3 dir = Subtract(keyframe.target, keyframe.position);
-    DirectX::XMVECTOR forward = DirectX::XMVectorSet(dir.x, dir.y, dir.z, 0.0f);
-    if (DirectX::XMVectorGetX(DirectX::XMVector3LengthSq(forward)) < kEpsilon) {
-        forward = baseForward;
-    } else {
-        forward = DirectX::XMVector3Normalize(forward);
-    }
+    // Segment s owns (t[s], t[s + 1]]; the first also owns everything before it, the last everything after
+    const auto owns = [&](size_t s) {
+        return (s == 0 || t > keyframes[s].t) && (s == lastSegment || t <= keyframes[s + 1].t);
+    };
 
-    DirectX::XMVECTOR axis = DirectX::XMVector3Cross(baseForward, forward);
-    float axisLenSq = DirectX::XMVectorGetX(DirectX::XMVector3LengthSq(axis));
-    const float dot = std::max(-1.0f, std::min(1.0f, DirectX::XMVectorGetX(DirectX::XMVector3Dot(baseForward, forward))));
-
-    DirectX::XMVECTOR qDir = DirectX::XMQuaternionIdentity();
-    if (axisLenSq > kEpsilon) {
-        axis = DirectX::XMVector3Normalize(axis);
-        const float angle = std::acos(dot);
-        qDir = DirectX::XMQuaternionRotationAxis(axis, angle);
-    } else if (dot < 0.0f) {
-        qDir = DirectX::XMQuaternionRotationAxis(baseUp, DirectX::XM_PI);
+    size_t seg = std::min(m_segmentCursor, lastSegment);
+    if (owns(seg)) return seg;
+    if (seg < lastSegment && owns(seg + 1)) {
+        m_segmentCursor = seg + 1;
+        return seg + 1;
     }
 
-    const DirectX::XMVECTOR qRoll = DirectX::XMQuaternionRotationAxis(forward, DirectX::XMConvertToRadians(keyframe.rollDeg));
-    return DirectX::XMQuaternionNormalize(DirectX::XMQuaternionMultiply(qRoll, qDir));
+    // Seek, loop wrap or a large step: the segment ends at the first key at or after t
+    const RS3CompiledKeyframe* first = keyframes + 1;
+    const RS3CompiledKeyframe* last = keyframes + lastSegment + 1;
+    const RS3CompiledKeyframe* it = std::lower_bound(first, last, t, [](const RS3CompiledKeyframe& key, float value) {
+        return key.t < value;
+    });
+    seg = (it == last) ? lastSegment : static_cast<size_t>(it - keyframes) - 1;
+    m_segmentCursor = seg;
+    return seg;
 }
 
 bool CinematicPlayer::EvaluateCameraPose(RS3CameraPose& outPose) const {
-    if (!m_hasTimeline || m_timeline.keyframes.empty()) {
+    if (!m_hasTimeline || !m_timeline) {
         return false;
     }
 
-    const auto& keyframes = m_timeline.keyframes;
+    const RS3CompiledKeyframe* keyframes = m_timeline->GetKeyframes();
+    const size_t keyframeCount = m_timeline->GetKeyframeCount();
     const float t = std::max(0.0f, std::min(m_currentTimeSec, m_durationSec));
 
-    if (keyframes.size() == 1) {
-        const auto& k = keyframes.front();
+    if (keyframeCount == 1) {
+        const auto& k = keyframes[0];
         outPose.position = k.position;
         outPose.target = k.target;
         outPose.up = { 0.0f, 0.0f, 1.0f };
@@ -182,31 +176,23 @@ bool CinematicPlayer::EvaluateCameraPose(RS3CameraPose& outPose) const {
         return true;
     }
 
-    size_t seg = keyframes.size() - 2;
-    for (size_t i = 0; i + 1 < keyframes.size(); ++i) {
-        if (t <= keyframes[i + 1].t) {
-            seg = i;
-            break;
-        }
-    }
-
+    const size_t seg = FindSegment(t);
     const auto& k1 = keyframes[seg];
     const auto& k2 = keyframes[seg + 1];
-    const auto& k0 = (seg == 0) ? keyframes[seg] : keyframes[seg - 1];
-    const auto& k3 = (seg + 2 < keyframes.size()) ? keyframes[seg + 2] : keyframes[seg + 1];
+    const auto& segment = m_timeline->GetSegments()[seg];
 
-    const float segmentDuration = std::max(kEpsilon, k2.t - k1.t);
-    const float rawU = (t - k1.t) / segmentDuration;
-    const float u = ApplyEase(rawU, k2.ease);
+    const float rawU = (t - k1.t) * segment.invDuration;
+    const float u = ApplyTimelineEase(rawU, static_cast<RS3TimelineEase>(k2.ease));
 
-    const DirectX::XMFLOAT3 pos = CatmullRom(k0.position, k1.position, k2.position, k3.position, u);
-    const float d1 = std::max(1.0f, Length(Subtract(k1.target, k1.position)));
-    const float d2 = std::max(1.0f, Length(Subtract(k2.target, k2.position)));
-    const float dist = d1 + (d2 - d1) * u;
+    const SegmentCurve& curve = m_curves[seg];
+    const DirectX::XMFLOAT3 pos = {
+        ((curve.c3.x * u + curve.c2.x) * u + curve.c1.x) * u + curve.c0.x,
+        ((curve.c3.y * u + curve.c2.y) * u + curve.c1.y) * u + curve.c0.y,
+        ((curve.c3.z * u + curve.c2.z) * u + curve.c1.z) * u + curve.c0.z
+    };
+    const float dist = k1.targetDistance + (k2.targetDistance - k1.targetDistance) * u;
 
-    DirectX::XMVECTOR q1 = BuildCameraQuaternion(k1);
-    DirectX::XMVECTOR q2 = BuildCameraQuaternion(k2);
-    DirectX::XMVECTOR q = DirectX::XMQuaternionSlerp(q1, q2, u);
+    DirectX::XMVECTOR q = DirectX::XMQuaternionSlerp(DirectX::XMLoadFloat4(&k1.rotation), DirectX::XMLoadFloat4(&k2.rotation), u);
     q = DirectX::XMQuaternionNormalize(q);
 
     const DirectX::XMVECTOR baseForward = DirectX::XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f);
@@ -232,4 +218,14 @@ bool CinematicPlayer::EvaluateCameraPose(RS3CameraPose& outPose) const {
     return true;
 }
 
+bool CinematicPlayer::EvaluateTracks(RS3TimelineTrackFrame& outFrame) const {
+    if (!m_hasTimeline || !m_timeline) {
+        outFrame.Clear();
+        return false;
+    }
+
+    m_tracks.Evaluate(std::max(0.0f, std::min(m_currentTimeSec, m_durationSec)), outFrame);
+    return true;
+}
+
 } // namespace RealSpace3
@@ -2,14 +2,15 @@
 
 #include <algorithm>
 #include <cctype>
-#include <cstdlib>
-#include <cstring>
+#include <charconv>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
 #include <filesystem>
 #include <fstream>
-#include <map>
 #include <optional>
-#include <sstream>
 #include <string>
+#include <string_view>
 #include <vector>
 
 namespace RealSpace3 {
@@ -23,32 +24,98 @@ void SetError(std::string* outError, const std::string& message) {
     }
 }
 
-struct JsonValue {
-    enum class Type {
-        Null,
-        Bool,
-        Number,
-        String,
-        Object,
-        Array
+// Value of a well-formed JSON number that does not fit a double. from_chars leaves its output
+// untouched in that case; this follows strtod: overflow is +-HUGE_VAL, underflow a signed zero.
+double OutOfRangeNumber(std::string_view token) {
+    const bool negative = !token.empty() && token.front() == '-';
+    size_t i = negative ? 1 : 0;
+
+    // Decimal exponent of the first significant digit
+    long long magnitude = 0;
+    bool significant = false;
+    bool fraction = false;
+    for (; i < token.size() && token[i] != 'e' && token[i] != 'E'; ++i) {
+        const char c = token[i];
+        if (c == '.') {
+            fraction = true;
+        } else if (fraction) {
+            if (!significant) {
+                --magnitude;
+                significant = c != '0';
+            }
+        } else if (significant) {
+            ++magnitude;
+        } else {
+            significant = c != '0';
+        }
+    }
+
+    if (i < token.size()) {
+        ++i;
+        const bool negativeExponent = i < token.size() && token[i] == '-';
+        if (i < token.size() && (token[i] == '+' || token[i] == '-')) ++i;
+        long long exponent = 0;
+        for (; i < token.size(); ++i) {
+            exponent = std::min<long long>(exponent * 10 + (token[i] - '0'), 1000000000LL);
+        }
+        magnitude += negativeExponent ? -exponent : exponent;
+    }
+
+    const double value = magnitude >= 0 ? HUGE_VAL : 0.0;
+    return negative ? -value : value;
+}
+
+enum class JsonType : uint8_t {
+    Null,
+    Bool,
+    Number,
+    String,
+    Object,
+    Array
+};
+
+struct JsonNode {
+    JsonType type = JsonType::Null;
+    uint32_t length = 0; // string bytes, or element/member count
+    union {
+        double number;
+        bool boolean;
+        const char* chars;
+        uint32_t first; // first element/member of the container's run
     };
 
-    Type type = Type::Null;
-    bool boolValue = false;
-    double numberValue = 0.0;
-    std::string stringValue;
-    std::map<std::string, JsonValue> objectValue;
-    std::vector<JsonValue> arrayValue;
+    JsonNode() : number(0.0) {}
 };
 
-class JsonParser {
+struct JsonMember {
+    std::string_view key;
+    uint32_t value = 0;
+};
+
+// Flat DOM over one JSON text. Nodes live in a single array; each container's children are
+// one contiguous run of m_elements (arrays) or m_members (objects, sorted by key), so a parse
+// does a handful of vector growths instead of one allocation per value. Strings without
+// escapes point into the source, which must outlive the document; decoded strings point into
+// m_strings, reserved up front so it never reallocates.
+class JsonDocument {
 public:
-    explicit JsonParser(const std::string& source)
-        : m_source(source) {}
+    static constexpr uint32_t kMaxDepth = 256;
+
+    bool Parse(std::string_view source, std::string* outError) {
+        m_source = source;
+        m_offset = 0;
+        m_nodes.clear();
+        m_elements.clear();
+        m_members.clear();
+        m_pendingElements.clear();
+        m_pendingMembers.clear();
+        m_strings.clear();
+        // Unescaping never grows a string, so the decoded total fits in the source size
+        m_strings.reserve(source.size());
+        m_nodes.reserve(source.size() / 8 + 1);
 
-    bool Parse(JsonValue& outValue, std::string* outError) {
         SkipWs();
-        if (!ParseValue(outValue, outError)) {
+        if (!ParseValue(0, outError)) {
             return false;
         }
         SkipWs();
@@ -59,31 +126,60 @@ public:
         return true;
     }
 
+    const JsonNode& Root() const { return m_nodes.front(); }
+
+    const JsonNode* Find(const JsonNode& object, std::string_view key) const {
+        if (object.type != JsonType::Object) return nullptr;
+        const auto begin = m_members.begin() + object.first;
+        const auto end = begin + object.length;
+        const auto it = std::lower_bound(begin, end, key, [](const JsonMember& member, std::string_view value) {
+            return member.key < value;
+        });
+        if (it == end || it->key != key) return nullptr;
+        return &m_nodes[it->value];
+    }
+
+    const JsonNode& At(const JsonNode& array, size_t index) const {
+        return m_nodes[m_elements[array.first + index]];
+    }
+
+    static std::string_view String(const JsonNode& node) {
+        return std::string_view(node.chars, node.length);
+    }
+
 private:
-    bool ParseValue(JsonValue& outValue, std::string* outError) {
+    uint32_t AddNode(JsonType type) {
+        m_nodes.emplace_back();
+        m_nodes.back().type = type;
+        return static_cast<uint32_t>(m_nodes.size() - 1);
+    }
+
+    bool ParseValue(uint32_t depth, std::string* outError) {
         SkipWs();
         if (m_offset >= m_source.size()) {
             SetError(outError, "Unexpected end of JSON input.");
             return false;
         }
+        if (depth > kMaxDepth) {
+            SetError(outError, "JSON nesting is too deep.");
+            return false;
+        }
 
         const char c = m_source[m_offset];
-        if (c == '{') return ParseObject(outValue, outError);
-        if (c == '[') return ParseArray(outValue, outError);
-        if (c == '"') return ParseStringValue(outValue, outError);
-        if (c == '-' || std::isdigit(static_cast<unsigned char>(c))) return ParseNumber(outValue, outError);
+        if (c == '{') return ParseObject(depth, outError);
+        if (c == '[') return ParseArray(depth, outError);
+        if (c == '"') return ParseStringValue(outError);
+        if (c == '-' || std::isdigit(static_cast<unsigned char>(c))) return ParseNumber(outError);
         if (MatchLiteral("true")) {
-            outValue.type = JsonValue::Type::Bool;
-            outValue.boolValue = true;
+            m_nodes[AddNode(JsonType::Bool)].boolean = true;
             return true;
         }
         if (MatchLiteral("false")) {
-            outValue.type = JsonValue::Type::Bool;
-            outValue.boolValue = false;
+            m_nodes[AddNode(JsonType::Bool)].boolean = false;
             return true;
         }
         if (MatchLiteral("null")) {
-            outValue.type = JsonValue::Type::Null;
+            AddNode(JsonType::Null);
             return true;
         }
 
@@ -91,148 +187,229 @@ private:
         return false;
     }
 
-    bool ParseObject(JsonValue& outValue, std::string* outError) {
-        if (!Consume('{')) {
-            SetError(outError, "Expected '{'.");
-            return false;
-        }
-        outValue = JsonValue{};
-        outValue.type = JsonValue::Type::Object;
+    bool ParseObject(uint32_t depth, std::string* outError) {
+        ++m_offset; // '{'
+        const uint32_t index = AddNode(JsonType::Object);
+        const size_t mark = m_pendingMembers.size();
 
         SkipWs();
-        if (Consume('}')) {
-            return true;
-        }
-
-        while (m_offset < m_source.size()) {
-            std::string key;
-            if (!ParseStringLiteral(key, outError)) {
-                return false;
-            }
-            SkipWs();
-            if (!Consume(':')) {
-                SetError(outError, "Expected ':' after object key.");
-                return false;
-            }
+        if (!Consume('}')) {
+            for (;;) {
+                std::string_view key;
+                if (!ParseStringLiteral(key, outError)) {
+                    return false;
+                }
+                SkipWs();
+                if (!Consume(':')) {
+                    SetError(outError, "Expected ':' after object key.");
+                    return false;
+                }
 
-            JsonValue item;
-            if (!ParseValue(item, outError)) {
-                return false;
-            }
-            outValue.objectValue.emplace(std::move(key), std::move(item));
+                const uint32_t value = static_cast<uint32_t>(m_nodes.size());
+                if (!ParseValue(depth + 1, outError)) {
+                    return false;
+                }
+                m_pendingMembers.push_back({ key, value });
 
-            SkipWs();
-            if (Consume('}')) {
-                return true;
-            }
-            if (!Consume(',')) {
-                SetError(outError, "Expected ',' or '}' in object.");
-                return false;
+                SkipWs();
+                if (Consume('}')) {
+                    break;
+                }
+                if (!Consume(',')) {
+                    SetError(outError, m_offset >= m_source.size() ? "Unterminated object." : "Expected ',' or '}' in object.");
+                    return false;
+                }
+                SkipWs();
             }
-            SkipWs();
         }
 
-        SetError(outError, "Unterminated object.");
-        return false;
+        // Nested containers have already moved their members out, so [mark, end) is ours.
+        // Stable sort keeps the first of duplicate keys in front, as std::map::emplace did.
+        const auto begin = m_pendingMembers.begin() + static_cast<std::ptrdiff_t>(mark);
+        std::stable_sort(begin, m_pendingMembers.end(), [](const JsonMember& a, const JsonMember& b) {
+            return a.key < b.key;
+        });
+        JsonNode& node = m_nodes[index];
+        node.first = static_cast<uint32_t>(m_members.size());
+        node.length = static_cast<uint32_t>(m_pendingMembers.size() - mark);
+        m_members.insert(m_members.end(), begin, m_pendingMembers.end());
+        m_pendingMembers.resize(mark);
+        return true;
     }
 
-    bool ParseArray(JsonValue& outValue, std::string* outError) {
-        if (!Consume('[')) {
-            SetError(outError, "Expected '['.");
-            return false;
-        }
-        outValue = JsonValue{};
-        outValue.type = JsonValue::Type::Array;
+    bool ParseArray(uint32_t depth, std::string* outError) {
+        ++m_offset; // '['
+        const uint32_t index = AddNode(JsonType::Array);
+        const size_t mark = m_pendingElements.size();
 
         SkipWs();
-        if (Consume(']')) {
-            return true;
-        }
-
-        while (m_offset < m_source.size()) {
-            JsonValue item;
-            if (!ParseValue(item, outError)) {
-                return false;
-            }
-            outValue.arrayValue.push_back(std::move(item));
+        if (!Consume(']')) {
+            for (;;) {
+                const uint32_t value = static_cast<uint32_t>(m_nodes.size());
+                if (!ParseValue(depth + 1, outError)) {
+                    return false;
+                }
+                m_pendingElements.push_back(value);
 
-            SkipWs();
-            if (Consume(']')) {
-                return true;
-            }
-            if (!Consume(',')) {
-                SetError(outError, "Expected ',' or ']' in array.");
-                return false;
+                SkipWs();
+                if (Consume(']')) {
+                    break;
+                }
+                if (!Consume(',')) {
+                    SetError(outError, m_offset >= m_source.size() ? "Unterminated array." : "Expected ',' or ']' in array.");
+                    return false;
+                }
+                SkipWs();
             }
-            SkipWs();
         }
 
-        SetError(outError, "Unterminated array.");
-        return false;
+        JsonNode& node = m_nodes[index];
+        node.first = static_cast<uint32_t>(m_elements.size());
+        node.length = static_cast<uint32_t>(m_pendingElements.size() - mark);
+        m_elements.insert(m_elements.end(), m_pendingElements.begin() + static_cast<std::ptrdiff_t>(mark), m_pendingElements.end());
+        m_pendingElements.resize(mark);
+        return true;
     }
 
-    bool ParseStringValue(JsonValue& outValue, std::string* outError) {
-        std::string value;
+    bool ParseStringValue(std::string* outError) {
+        std::string_view value;
         if (!ParseStringLiteral(value, outError)) {
             return false;
         }
-        outValue = JsonValue{};
-        outValue.type = JsonValue::Type::String;
-        outValue.stringValue = std::move(value);
+        JsonNode& node = m_nodes[AddNode(JsonType::String)];
+        node.chars = value.data();
+        node.length = static_cast<uint32_t>(value.size());
         return true;
     }
 
-    bool ParseStringLiteral(std::string& outString, std::string* outError) {
+    bool ParseStringLiteral(std::string_view& outString, std::string* outError) {
         if (!Consume('"')) {
             SetError(outError, "Expected string literal.");
             return false;
         }
 
-        outString.clear();
+        // Fast path: no escapes, the view points straight into the source
+        const size_t start = m_offset;
+        while (m_offset < m_source.size()) {
+            const char c = m_source[m_offset];
+            if (c == '"') {
+                outString = m_source.substr(start, m_offset - start);
+                ++m_offset;
+                return true;
+            }
+            if (c == '\\') break;
+            ++m_offset;
+        }
+        if (m_offset >= m_source.size()) {
+            SetError(outError, "Unterminated string literal.");
+            return false;
+        }
+
+        const size_t decodedStart = m_strings.size();
+        m_strings.append(m_source.data() + start, m_offset - start);
         while (m_offset < m_source.size()) {
             const char c = m_source[m_offset++];
             if (c == '"') {
+                outString = std::string_view(m_strings.data() + decodedStart, m_strings.size() - decodedStart);
                 return true;
             }
-            if (c == '\\') {
-                if (m_offset >= m_source.size()) {
-                    SetError(outError, "Unterminated escape sequence.");
-                    return false;
-                }
-                const char esc = m_source[m_offset++];
-                switch (esc) {
-                case '"': outString.push_back('"'); break;
-                case '\\': outString.push_back('\\'); break;
-                case '/': outString.push_back('/'); break;
-                case 'b': outString.push_back('\b'); break;
-                case 'f': outString.push_back('\f'); break;
-                case 'n': outString.push_back('\n'); break;
-                case 'r': outString.push_back('\r'); break;
-                case 't': outString.push_back('\t'); break;
-                case 'u':
-                    // Keep parser simple for timeline files: store unicode escape verbatim.
-                    if ((m_offset + 3) >= m_source.size()) {
-                        SetError(outError, "Invalid unicode escape.");
-                        return false;
-                    }
-                    outString += "\\u";
-                    outString.append(m_source.substr(m_offset, 4));
-                    m_offset += 4;
-                    break;
-                default:
-                    SetError(outError, "Unknown escape sequence.");
+            if (c != '\\') {
+                m_strings.push_back(c);
+                continue;
+            }
+            if (m_offset >= m_source.size()) {
+                SetError(outError, "Unterminated escape sequence.");
+                return false;
+            }
+            const char esc = m_source[m_offset++];
+            switch (esc) {
+            case '"': m_strings.push_back('"'); break;
+            case '\\': m_strings.push_back('\\'); break;
+            case '/': m_strings.push_back('/'); break;
+            case 'b': m_strings.push_back('\b'); break;
+            case 'f': m_strings.push_back('\f'); break;
+            case 'n': m_strings.push_back('\n'); break;
+            case 'r': m_strings.push_back('\r'); break;
+            case 't': m_strings.push_back('\t'); break;
+            case 'u':
+                if (!DecodeUnicodeEscape(outError)) {
                     return false;
                 }
-                continue;
+                break;
+            default:
+                SetError(outError, "Unknown escape sequence.");
+                return false;
             }
-            outString.push_back(c);
         }
 
         SetError(outError, "Unterminated string literal.");
         return false;
     }
 
-    bool ParseNumber(JsonValue& outValue, std::string* outError) {
+    bool ReadHex4(uint32_t& outValue) {
+        if (m_offset + 4 > m_source.size()) return false;
+        uint32_t value = 0;
+        for (size_t i = 0; i < 4; ++i) {
+            const char c = m_source[m_offset + i];
+            value <<= 4;
+            if (c >= '0' && c <= '9') value |= static_cast<uint32_t>(c - '0');
+            else if (c >= 'a' && c <= 'f') value |= static_cast<uint32_t>(c - 'a' + 10);
+            else if (c >= 'A' && c <= 'F') value |= static_cast<uint32_t>(c - 'A' + 10);
+            else return false;
+        }
+        m_offset += 4;
+        outValue = value;
+        return true;
+    }
+
+    // After "\u": decodes one code point (joining surrogate pairs) and appends it as UTF-8.
+    // Unpaired surrogates become U+FFFD.
+    bool DecodeUnicodeEscape(std::string* outError) {
+        uint32_t codePoint = 0;
+        if (!ReadHex4(codePoint)) {
+            SetError(outError, "Invalid unicode escape.");
+            return false;
+        }
+
+        if (codePoint >= 0xD800 && codePoint <= 0xDBFF) {
+            uint32_t low = 0;
+            const size_t rewind = m_offset;
+            if (m_offset + 1 < m_source.size() && m_source[m_offset] == '\\' && m_source[m_offset + 1] == 'u') {
+                m_offset += 2;
+                if (!ReadHex4(low)) {
+                    SetError(outError, "Invalid unicode escape.");
+                    return false;
+                }
+            }
+            if (low >= 0xDC00 && low <= 0xDFFF) {
+                codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (low - 0xDC00);
+            } else {
+                m_offset = rewind; // the next escape is decoded on its own
+                codePoint = 0xFFFD;
+            }
+        } else if (codePoint >= 0xDC00 && codePoint <= 0xDFFF) {
+            codePoint = 0xFFFD;
+        }
+
+        if (codePoint < 0x80) {
+            m_strings.push_back(static_cast<char>(codePoint));
+        } else if (codePoint < 0x800) {
+            m_strings.push_back(static_cast<char>(0xC0 | (codePoint >> 6)));
+            m_strings.push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+        } else if (codePoint < 0x10000) {
+            m_strings.push_back(static_cast<char>(0xE0 | (codePoint >> 12)));
+            m_strings.push_back(static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F)));
+            m_strings.push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+        } else {
+            m_strings.push_back(static_cast<char>(0xF0 | (codePoint >> 18)));
+            m_strings.push_back(static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F)));
+            m_strings.push_back(static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F)));
+            m_strings.push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+        }
+        return true;
+    }
+
+    bool ParseNumber(std::string* outError) {
         const size_t start = m_offset;
 
         if (Peek() == '-') {
@@ -277,17 +454,20 @@ private:
             }
         }
 
-        const std::string token = m_source.substr(start, m_offset - start);
-        char* endPtr = nullptr;
-        const double number = std::strtod(token.c_str(), &endPtr);
-        if (!endPtr || *endPtr != '\0') {
+        // from_chars: no temporary string and no locale dependence
+        double number = 0.0;
+        const char* first = m_source.data() + start;
+        const char* last = m_source.data() + m_offset;
+        const auto result = std::from_chars(first, last, number);
+        if (result.ptr != last || (result.ec != std::errc() && result.ec != std::errc::result_out_of_range)) {
             SetError(outError, "Failed to parse number token.");
             return false;
         }
+        if (result.ec == std::errc::result_out_of_range) {
+            number = OutOfRangeNumber(std::string_view(first, static_cast<size_t>(last - first)));
+        }
 
-        outValue = JsonValue{};
-        outValue.type = JsonValue::Type::Number;
-        outValue.numberValue = number;
+        m_nodes[AddNode(JsonType::Number)].number = number;
         return true;
     }
 
@@ -296,11 +476,9 @@ private:
         return m_source[m_offset];
     }
 
-    bool MatchLiteral(const char* literal) {
-        const size_t len = std::strlen(literal);
-        if (m_offset + len > m_source.size()) return false;
-        if (m_source.compare(m_offset, len, literal) != 0) return false;
-        m_offset += len;
+    bool MatchLiteral(std::string_view literal) {
+        if (m_source.compare(m_offset, literal.size(), literal) != 0) return false;
+        m_offset += literal.size();
         return true;
     }
 
@@ -311,47 +489,59 @@ private:
     }
 
     void SkipWs() {
-        while (m_offset < m_source.size() && std::isspace(static_cast<unsigned char>(m_source[m_offset]))) {
+        while (m_offset < m_source.size()) {
+            const char c = m_source[m_offset];
+            if (c != ' ' && c != '\n' && c != '\r' && c != '\t') break;
             ++m_offset;
         }
     }
 
 private:
-    const std::string& m_source;
+    std::string_view m_source;
     size_t m_offset = 0;
+    std::vector<JsonNode> m_nodes;
+    std::vector<uint32_t> m_elements;
+    std::vector<JsonMember> m_members;
+    std::vector<uint32_t> m_pendingElements;
+    std::vector<JsonMember> m_pendingMembers;
+    std::string m_strings;
 };
 
-const JsonValue* FindObjectField(const JsonValue& objectValue, const char* key) {
-    if (objectValue.type != JsonValue::Type::Object) return nullptr;
-    const auto it = objectValue.objectValue.find(key);
-    if (it == objectValue.objectValue.end()) return nullptr;
-    return &it->second;
+const JsonNode* FindObjectField(const JsonDocument& document, const JsonNode& objectValue, const char* key) {
+    return document.Find(objectValue, key);
 }
 
-std::optional<std::string> TryReadString(const JsonValue& objectValue, const char* key) {
-    const JsonValue* field = FindObjectField(objectValue, key);
-    if (!field || field->type != JsonValue::Type::String) return std::nullopt;
-    return field->stringValue;
+std::optional<std::string_view> TryReadString(const JsonDocument& document, const JsonNode& objectValue, const char* key) {
+    const JsonNode* field = document.Find(objectValue, key);
+    if (!field || field->type != JsonType::String) return std::nullopt;
+    return JsonDocument::String(*field);
 }
 
-std::optional<double> TryReadNumber(const JsonValue& objectValue, const char* key) {
-    const JsonValue* field = FindObjectField(objectValue, key);
-    if (!field || field->type != JsonValue::Type::Number) return std::nullopt;
-    return field->numberValue;
+std::optional<double> TryReadNumber(const JsonDocument& document, const JsonNode& objectValue, const char* key) {
+    const JsonNode* field = document.Find(objectValue, key);
+    if (!field || field->type != JsonType::Number) return std::nullopt;
+    return field->number;
 }
 
-bool ReadVec3(const JsonValue& objectValue, const char* key, DirectX::XMFLOAT3& outValue) {
-    const JsonValue* field = FindObjectField(objectValue, key);
-    if (!field || field->type != JsonValue::Type::Array || field->arrayValue.size() != 3) return false;
-    if (field->arrayValue[0].type != JsonValue::Type::Number ||
-        field->arrayValue[1].type != JsonValue::Type::Number ||
-        field->arrayValue[2].type != JsonValue::Type::Number) {
+std::optional<bool> TryReadBool(const JsonDocument& document, const JsonNode& objectValue, const char* key) {
+    const JsonNode* field = document.Find(objectValue, key);
+    if (!field || field->type != JsonType::Bool) return std::nullopt;
+    return field->boolean;
+}
+
+bool ReadVec3(const JsonDocument& document, const JsonNode& objectValue, const char* key, DirectX::XMFLOAT3& outValue) {
+    const JsonNode* field = document.Find(objectValue, key);
+    if (!field || field->type != JsonType::Array || field->length != 3) return false;
+    const JsonNode& x = document.At(*field, 0);
+    const JsonNode& y = document.At(*field, 1);
+    const JsonNode& z = document.At(*field, 2);
+    if (x.type != JsonType::Number || y.type != JsonType::Number || z.type != JsonType::Number) {
         return false;
     }
     outValue = {
-        static_cast<float>(field->arrayValue[0].numberValue),
-        static_cast<float>(field->arrayValue[1].numberValue),
-        static_cast<float>(field->arrayValue[2].numberValue)
+        static_cast<float>(x.number),
+        static_cast<float>(y.number),
+        static_cast<float>(z.number)
     };
     return true;
 }
@@ -387,15 +577,272 @@ bool ResolveTimelinePath(const std::string& rawPath, fs::path& outPath) {
     return false;
 }
 
-RS3TimelineEase ParseEase(const std::string& value) {
+RS3TimelineEase ParseEase(std::string_view value) {
     if (value == "ease-in-out-cubic" || value == "easeInOutCubic") {
         return RS3TimelineEase::EaseInOutCubic;
     }
     return RS3TimelineEase::Linear;
 }
 
+template <typename Key>
+void SortKeys(std::vector<Key>& keys) {
+    std::stable_sort(keys.begin(), keys.end(), [](const Key& a, const Key& b) {
+        return a.t < b.t;
+    });
+}
+
+bool ParseTrackKey(const JsonDocument& document, const JsonNode& item, RS3TimelineTrack& track, std::string* outError) {
+    const auto t = TryReadNumber(document, item, "t");
+    if (!t) {
+        SetError(outError, "Track key field 't' is required.");
+        return false;
+    }
+    const auto ease = TryReadString(document, item, "ease");
+    const RS3TimelineEase keyEase = ease ? ParseEase(*ease) : RS3TimelineEase::Linear;
+
+    switch (track.type) {
+    case RS3TimelineTrackType::Transform: {
+        RS3TimelineTransformKey key;
+        key.t = static_cast<float>(*t);
+        key.ease = keyEase;
+        if (!ReadVec3(document, item, "position", key.position)) {
+            SetError(outError, "Transform key field 'position' must be vec3.");
+            return false;
+        }
+        if (document.Find(item, "rotationDeg") && !ReadVec3(document, item, "rotationDeg", key.rotationDeg)) {
+            SetError(outError, "Transform key field 'rotationDeg' must be vec3.");
+            return false;
+        }
+        if (const auto scale = TryReadNumber(document, item, "scale")) {
+            key.scale = static_cast<float>(*scale);
+        }
+        track.transformKeys.push_back(key);
+        return true;
+    }
+    case RS3TimelineTrackType::Light: {
+        RS3TimelineLightKey key;
+        key.t = static_cast<float>(*t);
+        key.ease = keyEase;
+        if (document.Find(item, "color") && !ReadVec3(document, item, "color", key.color)) {
+            SetError(outError, "Light key field 'color' must be vec3.");
+            return false;
+        }
+        if (const auto intensity = TryReadNumber(document, item, "intensity")) {
+            key.intensity = std::max(0.0f, static_cast<float>(*intensity));
+        }
+        track.lightKeys.push_back(key);
+        return true;
+    }
+    case RS3TimelineTrackType::Fog: {
+        RS3TimelineFogKey key;
+        key.t = static_cast<float>(*t);
+        key.ease = keyEase;
+        if (const auto fogMin = TryReadNumber(document, item, "min")) {
+            key.fogMin = static_cast<float>(*fogMin);
+        }
+        if (const auto fogMax = TryReadNumber(document, item, "max")) {
+            key.fogMax = static_cast<float>(*fogMax);
+        }
+        if (document.Find(item, "color") && !ReadVec3(document, item, "color", key.color)) {
+            SetError(outError, "Fog key field 'color' must be vec3.");
+            return false;
+        }
+        track.fogKeys.push_back(key);
+        return true;
+    }
+    case RS3TimelineTrackType::ClipTrigger: {
+        RS3TimelineClipKey key;
+        key.t = static_cast<float>(*t);
+        const auto clip = TryReadString(document, item, "clip");
+        if (!clip || clip->empty()) {
+            SetError(outError, "Clip key field 'clip' is required.");
+            return false;
+        }
+        key.clip = std::string(*clip);
+        if (const auto speed = TryReadNumber(document, item, "speed")) {
+            key.speed = static_cast<float>(*speed);
+        }
+        if (const auto loop = TryReadBool(document, item, "loop")) {
+            key.loop = *loop;
+        }
+        track.clipKeys.push_back(std::move(key));
+        return true;
+    }
+    }
+    return false;
+}
+
+bool ParseAudioClips(const JsonDocument& document, const JsonNode& clipsArray, std::vector<RS3TimelineAudioClip>& outClips, std::string* outError) {
+    outClips.clear();
+    outClips.reserve(clipsArray.length);
+    for (uint32_t i = 0; i < clipsArray.length; ++i) {
+        const JsonNode& item = document.At(clipsArray, i);
+        const std::string prefix = "Audio clip " + std::to_string(i) + ": ";
+        if (item.type != JsonType::Object) {
+            SetError(outError, prefix + "each clip must be an object.");
+            return false;
+        }
+
+        RS3TimelineAudioClip clip;
+        const auto file = TryReadString(document, item, "file");
+        if (!file || file->empty()) {
+            SetError(outError, prefix + "field 'file' is required.");
+            return false;
+        }
+        clip.file = std::string(*file);
+        const auto readSeconds = [&](const char* key, float& outValue) -> bool {
+            if (const auto value = TryReadNumber(document, item, key)) {
+                if (!std::isfinite(*value) || *value < 0.0) {
+                    SetError(outError, prefix + "field '" + key + "' must be a non-negative number.");
+                    return false;
+                }
+                outValue = static_cast<float>(*value);
+            }
+            return true;
+        };
+        if (!readSeconds("startSec", clip.startSec) || !readSeconds("trimInSec", clip.trimInSec) ||
+            !readSeconds("durationSec", clip.durationSec) || !readSeconds("fadeInSec", clip.fadeInSec) ||
+            !readSeconds("fadeOutSec", clip.fadeOutSec)) {
+            return false;
+        }
+        if (const auto gainDb = TryReadNumber(document, item, "gainDb")) {
+            clip.gainDb = static_cast<float>(*gainDb);
+        }
+        outClips.push_back(std::move(clip));
+    }
+    return true;
+}
+
+bool ParseTracks(const JsonDocument& document, const JsonNode& tracksArray, std::vector<RS3TimelineTrack>& outTracks, std::string* outError) {
+    outTracks.clear();
+    outTracks.reserve(tracksArray.length);
+    for (uint32_t i = 0; i < tracksArray.length; ++i) {
+        const JsonNode& item = document.At(tracksArray, i);
+        const std::string prefix = "Track " + std::to_string(i) + ": ";
+        if (item.type != JsonType::Object) {
+            SetError(outError, prefix + "each track must be an object.");
+            return false;
+        }
+
+        RS3TimelineTrack track;
+        const auto typeText = TryReadString(document, item, "type");
+        if (!typeText || !ParseTimelineTrackTypeString(std::string(*typeText), track.type)) {
+            SetError(outError, prefix + "field 'type' must be transform, light, fog or clip.");
+            return false;
+        }
+        if (const auto name = TryReadString(document, item, "name")) {
+            track.name = std::string(*name);
+        }
+        if (const auto target = TryReadString(document, item, "target")) {
+            track.target = std::string(*target);
+        }
+        if ((track.type == RS3TimelineTrackType::Transform || track.type == RS3TimelineTrackType::ClipTrigger) && track.target.empty()) {
+            SetError(outError, prefix + "field 'target' is required for " + ToTimelineTrackTypeString(track.type) + " tracks.");
+            return false;
+        }
+
+        const JsonNode* keys = FindObjectField(document, item, "keys");
+        if (!keys || keys->type != JsonType::Array || keys->length == 0) {
+            SetError(outError, prefix + "field 'keys' must be a non-empty array.");
+            return false;
+        }
+        for (uint32_t k = 0; k < keys->length; ++k) {
+            const JsonNode& key = document.At(*keys, k);
+            std::string keyError;
+            if (key.type != JsonType::Object) {
+                SetError(outError, prefix + "each key must be an object.");
+                return false;
+            }
+            if (!ParseTrackKey(document, key, track, &keyError)) {
+                SetError(outError, prefix + keyError);
+                return false;
+            }
+        }
+
+        SortKeys(track.transformKeys);
+        SortKeys(track.lightKeys);
+        SortKeys(track.fogKeys);
+        SortKeys(track.clipKeys);
+        outTracks.push_back(std::move(track));
+    }
+    return true;
+}
+
 } // namespace
 
+const char* ToTimelineTrackTypeString(RS3TimelineTrackType type) {
+    switch (type) {
+    case RS3TimelineTrackType::Transform: return "transform";
+    case RS3TimelineTrackType::Light: return "light";
+    case RS3TimelineTrackType::Fog: return "fog";
+    case RS3TimelineTrackType::ClipTrigger: return "clip";
+    default: return "transform";
+    }
+}
+
+bool ParseTimelineTrackTypeString(const std::string& value, RS3TimelineTrackType& outType) {
+    if (value == "transform") {
+        outType = RS3TimelineTrackType::Transform;
+        return true;
+    }
+    if (value == "light") {
+        outType = RS3TimelineTrackType::Light;
+        return true;
+    }
+    if (value == "fog") {
+        outType = RS3TimelineTrackType::Fog;
+        return true;
+    }
+    if (value == "clip" || value == "clipTrigger") {
+        outType = RS3TimelineTrackType::ClipTrigger;
+        return true;
+    }
+    return false;
+}
+
+float ApplyTimelineEase(float t, RS3TimelineEase ease) {
+    const float x = std::max(0.0f, std::min(1.0f, t));
+    if (ease == RS3TimelineEase::EaseInOutCubic) {
+        if (x < 0.5f) {
+            return 4.0f * x * x * x;
+        }
+        const float n = -2.0f * x + 2.0f;
+        return 1.0f - (n * n * n) * 0.5f;
+    }
+    return x;
+}
+
+int GetTimelineFrameCount(float durationSec, int fps) {
+    const double frames = std::ceil(static_cast<double>(std::max(0.0f, durationSec)) * std::max(1, fps));
+    return std::max(1, static_cast<int>(frames));
+}
+
+float GetTimelineFrameTime(int frame, int fps) {
+    return static_cast<float>(static_cast<double>(frame) / std::max(1, fps));
+}
+
+std::vector<RS3TimelineAudioClip> GetTimelineAudioClips(const RS3TimelineAudio& audio) {
+    std::vector<RS3TimelineAudioClip> clips;
+    clips.reserve(audio.clips.size() + 1);
+    if (audio.enabled && !audio.file.empty()) {
+        RS3TimelineAudioClip clip;
+        clip.file = audio.file;
+        clip.startSec = std::max(0.0f, audio.offsetSec);
+        clip.trimInSec = std::max(0.0f, -audio.offsetSec);
+        clip.gainDb = audio.gainDb;
+        clips.push_back(std::move(clip));
+    }
+    clips.insert(clips.end(), audio.clips.begin(), audio.clips.end());
+    return clips;
+}
+
+bool ResolveTimelineFile(const std::string& timelinePath, std::string& outResolvedPath) {
+    fs::path resolvedPath;
+    if (!ResolveTimelinePath(timelinePath, resolvedPath)) return false;
+    outResolvedPath = resolvedPath.string();
+    return true;
+}
+
 bool LoadTimelineFromFile(const std::string& timelinePath, RS3TimelineData& outTimeline, std::string* outError) {
     fs::path resolvedPath;
     if (!ResolveTimelinePath(timelinePath, resolvedPath)) {
@@ -403,109 +850,117 @@ bool LoadTimelineFromFile(const std::string& timelinePath, RS3TimelineData& outT
         return false;
     }
 
-    std::ifstream input(resolvedPath, std::ios::binary);
+    std::ifstream input(resolvedPath, std::ios::binary | std::ios::ate);
     if (!input.is_open()) {
         SetError(outError, "Failed to open timeline file.");
         return false;
     }
 
-    std::stringstream buffer;
-    buffer << input.rdbuf();
-    const std::string json = buffer.str();
+    const std::streamoff fileSize = input.tellg();
+    std::string json(fileSize > 0 ? static_cast<size_t>(fileSize) : 0, '\0');
+    input.seekg(0, std::ios::beg);
+    if (!json.empty() && !input.read(json.data(), static_cast<std::streamsize>(json.size()))) {
+        SetError(outError, "Failed to read timeline file.");
+        return false;
+    }
     if (json.empty()) {
         SetError(outError, "Timeline file is empty.");
         return false;
     }
+    return ParseTimelineJson(json, outTimeline, outError);
+}
 
-    JsonParser parser(json);
-    JsonValue root;
+bool ParseTimelineJson(std::string_view json, RS3TimelineData& outTimeline, std::string* outError) {
+    JsonDocument document;
     std::string parseError;
-    if (!parser.Parse(root, &parseError)) {
+    if (!document.Parse(json, &parseError)) {
         SetError(outError, "Timeline JSON parse failed: " + parseError);
         return false;
     }
-    if (root.type != JsonValue::Type::Object) {
+    const JsonNode& root = document.Root();
+    if (root.type != JsonType::Object) {
         SetError(outError, "Timeline root must be an object.");
         return false;
     }
 
     RS3TimelineData parsed;
 
-    const auto version = TryReadString(root, "version");
+    const auto version = TryReadString(document, root, "version");
     if (!version || *version != "ndg_cine_v1") {
         SetError(outError, "Timeline version must be 'ndg_cine_v1'.");
         return false;
     }
-    parsed.version = *version;
+    parsed.version = std::string(*version);
 
-    const auto sceneId = TryReadString(root, "sceneId");
+    const auto sceneId = TryReadString(document, root, "sceneId");
     if (!sceneId || sceneId->empty()) {
         SetError(outError, "Timeline sceneId is required.");
         return false;
     }
-    parsed.sceneId = *sceneId;
+    parsed.sceneId = std::string(*sceneId);
 
-    const auto modeText = TryReadString(root, "mode");
-    if (!modeText || !ParseRenderModeString(*modeText, parsed.mode)) {
+    const auto modeText = TryReadString(document, root, "mode");
+    if (!modeText || !ParseRenderModeString(std::string(*modeText), parsed.mode)) {
         SetError(outError, "Timeline mode is invalid.");
         return false;
     }
 
-    const auto durationSec = TryReadNumber(root, "durationSec");
+    const auto durationSec = TryReadNumber(document, root, "durationSec");
     if (!durationSec || *durationSec <= 0.0) {
         SetError(outError, "Timeline durationSec must be > 0.");
         return false;
     }
     parsed.durationSec = static_cast<float>(*durationSec);
 
-    if (const auto fps = TryReadNumber(root, "fps")) {
+    if (const auto fps = TryReadNumber(document, root, "fps")) {
         parsed.fps = std::max(1, static_cast<int>(*fps));
     }
 
-    const JsonValue* cameraObject = FindObjectField(root, "camera");
-    if (!cameraObject || cameraObject->type != JsonValue::Type::Object) {
+    const JsonNode* cameraObject = FindObjectField(document, root, "camera");
+    if (!cameraObject || cameraObject->type != JsonType::Object) {
         SetError(outError, "Timeline camera object is required.");
         return false;
     }
 
-    const JsonValue* keyframesArray = FindObjectField(*cameraObject, "keyframes");
-    if (!keyframesArray || keyframesArray->type != JsonValue::Type::Array) {
+    const JsonNode* keyframesArray = FindObjectField(document, *cameraObject, "keyframes");
+    if (!keyframesArray || keyframesArray->type != JsonType::Array) {
         SetError(outError, "Timeline camera.keyframes array is required.");
         return false;
     }
 
     parsed.keyframes.clear();
-    parsed.keyframes.reserve(keyframesArray->arrayValue.size());
-    for (const auto& item : keyframesArray->arrayValue) {
-        if (item.type != JsonValue::Type::Object) {
+    parsed.keyframes.reserve(keyframesArray->length);
+    for (uint32_t i = 0; i < keyframesArray->length; ++i) {
+        const JsonNode& item = document.At(*keyframesArray, i);
+        if (item.type != JsonType::Object) {
             SetError(outError, "Each keyframe must be an object.");
             return false;
         }
 
         RS3TimelineKeyframe kf;
-        const auto t = TryReadNumber(item, "t");
+        const auto t = TryReadNumber(document, item, "t");
         if (!t) {
             SetError(outError, "Keyframe field 't' is required.");
             return false;
         }
         kf.t = static_cast<float>(*t);
 
-        if (!ReadVec3(item, "position", kf.position)) {
+        if (!ReadVec3(document, item, "position", kf.position)) {
             SetError(outError, "Keyframe field 'position' must be vec3.");
             return false;
         }
-        if (!ReadVec3(item, "target", kf.target)) {
+        if (!ReadVec3(document, item, "target", kf.target)) {
             SetError(outError, "Keyframe field 'target' must be vec3.");
             return false;
         }
 
-        if (const auto rollDeg = TryReadNumber(item, "rollDeg")) {
+        if (const auto rollDeg = TryReadNumber(document, item, "rollDeg")) {
             kf.rollDeg = static_cast<float>(*rollDeg);
         }
-        if (const auto fovDeg = TryReadNumber(item, "fovDeg")) {
+        if (const auto fovDeg = TryReadNumber(document, item, "fovDeg")) {
             kf.fovDeg = static_cast<float>(*fovDeg);
         }
-        if (const auto ease = TryReadString(item, "ease")) {
+        if (const auto ease = TryReadString(document, item, "ease")) {
             kf.ease = ParseEase(*ease);
         }
 
@@ -526,18 +981,37 @@ bool LoadTimelineFromFile(const std::string& timelinePath, RS3TimelineData& outT
     }
     parsed.durationSec = std::max(parsed.durationSec, parsed.keyframes.back().t);
 
-    if (const JsonValue* audioObject = FindObjectField(root, "audio")) {
-        if (audioObject->type == JsonValue::Type::Object) {
-            if (const auto file = TryReadString(*audioObject, "file")) {
-                parsed.audio.file = *file;
+    if (const JsonNode* tracksArray = FindObjectField(document, root, "tracks")) {
+        if (tracksArray->type != JsonType::Array) {
+            SetError(outError, "Timeline tracks must be an array.");
+            return false;
+        }
+        if (!ParseTracks(document, *tracksArray, parsed.tracks, outError)) {
+            return false;
+        }
+    }
+
+    if (const JsonNode* audioObject = FindObjectField(document, root, "audio")) {
+        if (audioObject->type == JsonType::Object) {
+            if (const auto file = TryReadString(document, *audioObject, "file")) {
+                parsed.audio.file = std::string(*file);
                 parsed.audio.enabled = !parsed.audio.file.empty();
             }
-            if (const auto offsetSecValue = TryReadNumber(*audioObject, "offsetSec")) {
+            if (const auto offsetSecValue = TryReadNumber(document, *audioObject, "offsetSec")) {
                 parsed.audio.offsetSec = static_cast<float>(*offsetSecValue);
             }
-            if (const auto gainDbValue = TryReadNumber(*audioObject, "gainDb")) {
+            if (const auto gainDbValue = TryReadNumber(document, *audioObject, "gainDb")) {
                 parsed.audio.gainDb = static_cast<float>(*gainDbValue);
             }
+            if (const JsonNode* clipsArray = FindObjectField(document, *audioObject, "clips")) {
+                if (clipsArray->type != JsonType::Array) {
+                    SetError(outError, "Timeline audio clips must be an array.");
+                    return false;
+                }
+                if (!ParseAudioClips(document, *clipsArray, parsed.audio.clips, outError)) {
+                    return false;
+                }
+            }
         }
     }
 
@@ -0,0 +1,688 @@
+#include "../Include/CompiledTimeline.h"
+
+#include "../Include/MappedFile.h"
+
+#include "AppLogger.h"
+
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+namespace RealSpace3 {
+namespace {
+
+namespace fs = std::filesystem;
+
+void SetError(std::string* outError, const std::string& message) {
+    if (outError) *outError = message;
+}
+
+constexpr std::array<uint8_t, 8> kCompiledMagic = { 0x4E, 0x44, 0x47, 0x43, 0x49, 0x4E, 0x45, 0x31 }; // NDGCINE1
+constexpr size_t kHeaderSize = 96;
+constexpr size_t kKeyBlockAlignment = 8;
+constexpr float kEpsilon = 1e-6f;
+
+struct CompiledHeader {
+    uint32_t version = 0;
+    uint32_t mode = 0;
+    float durationSec = 0.0f;
+    int32_t fps = 0;
+    uint32_t keyframeCount = 0;
+    uint32_t keyframesOffset = 0;
+    uint32_t segmentsOffset = 0;
+    uint32_t stringsOffset = 0;
+    uint32_t sceneIdLength = 0;
+    uint32_t audioFileLength = 0;
+    float audioOffsetSec = 0.0f;
+    float audioGainDb = 0.0f;
+    uint32_t audioEnabled = 0;
+    uint32_t fileSize = 0;
+    uint32_t trackCount = 0;
+    uint32_t tracksOffset = 0;
+    uint32_t stringsSize = 0;
+    uint32_t audioClipCount = 0;
+    uint32_t audioClipsOffset = 0;
+};
+
+template <typename T>
+T ReadAt(const uint8_t* p) {
+    T value;
+    std::memcpy(&value, p, sizeof(T));
+    return value;
+}
+
+template <typename T>
+void WriteAt(uint8_t* p, const T& value) {
+    std::memcpy(p, &value, sizeof(T));
+}
+
+DirectX::XMFLOAT3 Subtract(const DirectX::XMFLOAT3& a, const DirectX::XMFLOAT3& b) {
+    return { a.x - b.x, a.y - b.y, a.z - b.z };
+}
+
+DirectX::XMFLOAT3 HalfDelta(const DirectX::XMFLOAT3& from, const DirectX::XMFLOAT3& to) {
+    return { (to.x - from.x) * 0.5f, (to.y - from.y) * 0.5f, (to.z - from.z) * 0.5f };
+}
+
+float Length(const DirectX::XMFLOAT3& v) {
+    return std::sqrt(v.x * v.x + v.y * v.y + v.z * v.z);
+}
+
+uint64_t AlignUp(uint64_t value, uint64_t alignment) {
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+size_t GetTrackKeySize(uint32_t type) {
+    switch (static_cast<RS3TimelineTrackType>(type)) {
+    case RS3TimelineTrackType::Transform: return sizeof(RS3CompiledTransformKey);
+    case RS3TimelineTrackType::Light: return sizeof(RS3CompiledLightKey);
+    case RS3TimelineTrackType::Fog: return sizeof(RS3CompiledFogKey);
+    case RS3TimelineTrackType::ClipTrigger: return sizeof(RS3CompiledClipKey);
+    default: return 0;
+    }
+}
+
+size_t GetTrackKeyCount(const RS3TimelineTrack& track) {
+    switch (track.type) {
+    case RS3TimelineTrackType::Transform: return track.transformKeys.size();
+    case RS3TimelineTrackType::Light: return track.lightKeys.size();
+    case RS3TimelineTrackType::Fog: return track.fogKeys.size();
+    case RS3TimelineTrackType::ClipTrigger: return track.clipKeys.size();
+    default: return 0;
+    }
+}
+
+template <typename Key>
+std::vector<Key> SortedKeys(const std::vector<Key>& keys) {
+    std::vector<Key> sorted = keys;
+    std::stable_sort(sorted.begin(), sorted.end(), [](const Key& a, const Key& b) {
+        return a.t < b.t;
+    });
+    return sorted;
+}
+
+// X, then Y, then Z about the world axes
+DirectX::XMFLOAT4 BuildTransformRotation(const DirectX::XMFLOAT3& rotationDeg) {
+    const DirectX::XMVECTOR qx = DirectX::XMQuaternionRotationAxis(DirectX::XMVectorSet(1.0f, 0.0f, 0.0f, 0.0f), DirectX::XMConvertToRadians(rotationDeg.x));
+    const DirectX::XMVECTOR qy = DirectX::XMQuaternionRotationAxis(DirectX::XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f), DirectX::XMConvertToRadians(rotationDeg.y));
+    const DirectX::XMVECTOR qz = DirectX::XMQuaternionRotationAxis(DirectX::XMVectorSet(0.0f, 0.0f, 1.0f, 0.0f), DirectX::XMConvertToRadians(rotationDeg.z));
+    DirectX::XMFLOAT4 rotation;
+    DirectX::XMStoreFloat4(&rotation, DirectX::XMQuaternionNormalize(
+        DirectX::XMQuaternionMultiply(DirectX::XMQuaternionMultiply(qx, qy), qz)));
+    return rotation;
+}
+
+// Inverse of BuildTransformRotation (angles may differ, orientation is the same)
+DirectX::XMFLOAT3 TransformRotationToDegrees(const DirectX::XMFLOAT4& q) {
+    const float r11 = 1.0f - 2.0f * (q.y * q.y + q.z * q.z);
+    const float r21 = 2.0f * (q.x * q.y + q.w * q.z);
+    const float r31 = 2.0f * (q.x * q.z - q.w * q.y);
+    const float r32 = 2.0f * (q.y * q.z + q.w * q.x);
+    const float r33 = 1.0f - 2.0f * (q.x * q.x + q.y * q.y);
+    const float toDegrees = 180.0f / DirectX::XM_PI;
+    return {
+        std::atan2(r32, r33) * toDegrees,
+        std::asin(std::max(-1.0f, std::min(1.0f, -r31))) * toDegrees,
+        std::atan2(r21, r11) * toDegrees
+    };
+}
+
+RS3TimelineEase ToEase(uint32_t value) {
+    return value == static_cast<uint32_t>(RS3TimelineEase::EaseInOutCubic) ? RS3TimelineEase::EaseInOutCubic : RS3TimelineEase::Linear;
+}
+
+bool IsCompiledTimelinePath(const std::string& path) {
+    const std::string extension = RS3CompiledTimeline::kFileExtension;
+    if (path.size() < extension.size()) return false;
+    return std::equal(extension.rbegin(), extension.rend(), path.rbegin(), [](char a, char b) {
+        return a == static_cast<char>(std::tolower(static_cast<unsigned char>(b)));
+    });
+}
+
+} // namespace
+
+DirectX::XMFLOAT4 BuildTimelineCameraRotation(const DirectX::XMFLOAT3& position, const DirectX::XMFLOAT3& target, float rollDeg) {
+    const DirectX::XMVECTOR baseForward = DirectX::XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f);
+    const DirectX::XMVECTOR baseUp = DirectX::XMVectorSet(0.0f, 0.0f, 1.0f, 0.0f);
+
+    const DirectX::XMFLOAT3 dir = Subtract(target, position);
+    DirectX::XMVECTOR forward = DirectX::XMVectorSet(dir.x, dir.y, dir.z, 0.0f);
+    if (DirectX::XMVectorGetX(DirectX::XMVector3LengthSq(forward)) < kEpsilon) {
+        forward = baseForward;
+    } else {
+        forward = DirectX::XMVector3Normalize(forward);
+    }
+
+    DirectX::XMVECTOR axis = DirectX::XMVector3Cross(baseForward, forward);
+    const float axisLenSq = DirectX::XMVectorGetX(DirectX::XMVector3LengthSq(axis));
+    const float dot = std::max(-1.0f, std::min(1.0f, DirectX::XMVectorGetX(DirectX::XMVector3Dot(baseForward, forward))));
+
+    DirectX::XMVECTOR qDir = DirectX::XMQuaternionIdentity();
+    if (axisLenSq > kEpsilon) {
+        axis = DirectX::XMVector3Normalize(axis);
+        const float angle = std::acos(dot);
+        qDir = DirectX::XMQuaternionRotationAxis(axis, angle);
+    } else if (dot < 0.0f) {
+        qDir = DirectX::XMQuaternionRotationAxis(baseUp, DirectX::XM_PI);
+    }
+
+    const DirectX::XMVECTOR qRoll = DirectX::XMQuaternionRotationAxis(forward, DirectX::XMConvertToRadians(rollDeg));
+    DirectX::XMFLOAT4 rotation;
+    DirectX::XMStoreFloat4(&rotation, DirectX::XMQuaternionNormalize(DirectX::XMQuaternionMultiply(qRoll, qDir)));
+    return rotation;
+}
+
+bool RS3CompiledTimeline::Compile(const RS3TimelineData& timeline, std::vector<uint8_t>& outBytes, std::string* outError) {
+    if (timeline.keyframes.empty()) {
+        SetError(outError, "Timeline has no camera keyframes.");
+        return false;
+    }
+
+    const std::vector<RS3TimelineKeyframe> sorted = SortedKeys(timeline.keyframes);
+
+    // String section: sceneId, audio file, then track names, targets, clip names and audio clip files
+    std::string strings = timeline.sceneId + timeline.audio.file;
+    const auto addString = [&strings](const std::string& value, uint32_t& outOffset, uint32_t& outLength) {
+        outOffset = static_cast<uint32_t>(strings.size());
+        outLength = static_cast<uint32_t>(value.size());
+        strings += value;
+    };
+
+    const uint64_t keyframeCount = sorted.size();
+    const uint64_t segmentCount = keyframeCount - 1;
+    const uint64_t trackCount = timeline.tracks.size();
+    const uint64_t keyframesOffset = kHeaderSize;
+    const uint64_t segmentsOffset = keyframesOffset + keyframeCount * sizeof(RS3CompiledKeyframe);
+    const uint64_t tracksOffset = segmentsOffset + segmentCount * sizeof(RS3CompiledSegment);
+    const uint64_t audioClipCount = timeline.audio.clips.size();
+    const uint64_t audioClipsOffset = tracksOffset + trackCount * sizeof(RS3CompiledTrack);
+
+    std::vector<RS3CompiledTrack> tracks(timeline.tracks.size());
+    uint64_t keysEnd = audioClipsOffset + audioClipCount * sizeof(RS3CompiledAudioClip);
+    for (size_t i = 0; i < timeline.tracks.size(); ++i) {
+        const RS3TimelineTrack& source = timeline.tracks[i];
+        RS3CompiledTrack& track = tracks[i];
+        track.type = static_cast<uint32_t>(source.type);
+        track.keyCount = static_cast<uint32_t>(GetTrackKeyCount(source));
+        if (track.keyCount == 0) {
+            SetError(outError, "Track '" + source.name + "' has no keys.");
+            return false;
+        }
+        keysEnd = AlignUp(keysEnd, kKeyBlockAlignment);
+        track.keysOffset = static_cast<uint32_t>(keysEnd);
+        keysEnd += static_cast<uint64_t>(track.keyCount) * GetTrackKeySize(track.type);
+        addString(source.name, track.nameOffset, track.nameLength);
+        addString(source.target, track.targetOffset, track.targetLength);
+    }
+
+    // Clip names are interned after the track table strings; key blocks are written below
+    std::vector<std::vector<RS3TimelineClipKey>> sortedClipKeys(timeline.tracks.size());
+    std::vector<std::vector<std::pair<uint32_t, uint32_t>>> clipStrings(timeline.tracks.size());
+    for (size_t i = 0; i < timeline.tracks.size(); ++i) {
+        if (timeline.tracks[i].type != RS3TimelineTrackType::ClipTrigger) continue;
+        sortedClipKeys[i] = SortedKeys(timeline.tracks[i].clipKeys);
+        for (const RS3TimelineClipKey& key : sortedClipKeys[i]) {
+            std::pair<uint32_t, uint32_t> range;
+            addString(key.clip, range.first, range.second);
+            clipStrings[i].push_back(range);
+        }
+    }
+
+    std::vector<RS3CompiledAudioClip> audioClips(timeline.audio.clips.size());
+    for (size_t i = 0; i < timeline.audio.clips.size(); ++i) {
+        const RS3TimelineAudioClip& source = timeline.audio.clips[i];
+        RS3CompiledAudioClip& clip = audioClips[i];
+        addString(source.file, clip.fileOffset, clip.fileLength);
+        clip.startSec = source.startSec;
+        clip.trimInSec = source.trimInSec;
+        clip.durationSec = source.durationSec;
+        clip.gainDb = source.gainDb;
+        clip.fadeInSec = source.fadeInSec;
+        clip.fadeOutSec = source.fadeOutSec;
+    }
+
+    const uint64_t stringsOffset = keysEnd;
+    const uint64_t fileSize = stringsOffset + strings.size();
+    if (fileSize > 0xFFFFFFFFull) {
+        SetError(outError, "Timeline is too large to compile.");
+        return false;
+    }
+
+    outBytes.assign(static_cast<size_t>(fileSize), 0);
+    uint8_t* base = outBytes.data();
+    std::memcpy(base, kCompiledMagic.data(), kCompiledMagic.size());
+    WriteAt<uint32_t>(base + 8, kFormatVersion);
+    WriteAt<uint32_t>(base + 12, static_cast<uint32_t>(timeline.mode));
+    WriteAt<float>(base + 16, timeline.durationSec);
+    WriteAt<int32_t>(base + 20, std::max(1, timeline.fps));
+    WriteAt<uint32_t>(base + 24, static_cast<uint32_t>(keyframeCount));
+    WriteAt<uint32_t>(base + 28, static_cast<uint32_t>(keyframesOffset));
+    WriteAt<uint32_t>(base + 32, static_cast<uint32_t>(segmentsOffset));
+    WriteAt<uint32_t>(base + 36, static_cast<uint32_t>(stringsOffset));
+    WriteAt<uint32_t>(base + 40, static_cast<uint32_t>(timeline.sceneId.size()));
+    WriteAt<uint32_t>(base + 44, static_cast<uint32_t>(timeline.audio.file.size()));
+    WriteAt<float>(base + 48, timeline.audio.offsetSec);
+    WriteAt<float>(base + 52, timeline.audio.gainDb);
+    WriteAt<uint32_t>(base + 56, timeline.audio.enabled ? 1u : 0u);
+    WriteAt<uint32_t>(base + 60, static_cast<uint32_t>(fileSize));
+    WriteAt<uint32_t>(base + 64, static_cast<uint32_t>(trackCount));
+    WriteAt<uint32_t>(base + 68, static_cast<uint32_t>(tracksOffset));
+    WriteAt<uint32_t>(base + 72, static_cast<uint32_t>(strings.size()));
+    WriteAt<uint32_t>(base + 76, static_cast<uint32_t>(audioClipCount));
+    WriteAt<uint32_t>(base + 80, static_cast<uint32_t>(audioClipsOffset));
+
+    for (size_t i = 0; i < sorted.size(); ++i) {
+        const RS3TimelineKeyframe& source = sorted[i];
+        RS3CompiledKeyframe key;
+        key.t = source.t;
+        key.position = source.position;
+        key.target = source.target;
+        key.rollDeg = source.rollDeg;
+        key.fovDeg = source.fovDeg;
+        key.ease = static_cast<uint32_t>(source.ease);
+        key.rotation = BuildTimelineCameraRotation(source.position, source.target, source.rollDeg);
+        key.targetDistance = std::max(1.0f, Length(Subtract(source.target, source.position)));
+        std::memcpy(base + keyframesOffset + i * sizeof(RS3CompiledKeyframe), &key, sizeof(key));
+    }
+
+    for (size_t i = 0; i < segmentCount; ++i) {
+        const auto& p0 = sorted[i == 0 ? i : i - 1].position;
+        const auto& p1 = sorted[i].position;
+        const auto& p2 = sorted[i + 1].position;
+        const auto& p3 = sorted[i + 2 < sorted.size() ? i + 2 : i + 1].position;
+
+        RS3CompiledSegment segment;
+        segment.tangentStart = HalfDelta(p0, p2);
+        segment.tangentEnd = HalfDelta(p1, p3);
+        segment.invDuration = 1.0f / std::max(kEpsilon, sorted[i + 1].t - sorted[i].t);
+        std::memcpy(base + segmentsOffset + i * sizeof(RS3CompiledSegment), &segment, sizeof(segment));
+    }
+
+    for (size_t i = 0; i < timeline.tracks.size(); ++i) {
+        const RS3TimelineTrack& source = timeline.tracks[i];
+        const RS3CompiledTrack& track = tracks[i];
+        std::memcpy(base + tracksOffset + i * sizeof(RS3CompiledTrack), &track, sizeof(track));
+
+        uint8_t* keys = base + track.keysOffset;
+        switch (source.type) {
+        case RS3TimelineTrackType::Transform: {
+            const auto sortedKeys = SortedKeys(source.transformKeys);
+            for (size_t k = 0; k < sortedKeys.size(); ++k) {
+                RS3CompiledTransformKey key;
+                key.t = sortedKeys[k].t;
+                key.position = sortedKeys[k].position;
+                key.rotation = BuildTransformRotation(sortedKeys[k].rotationDeg);
+                key.scale = sortedKeys[k].scale;
+                key.ease = static_cast<uint32_t>(sortedKeys[k].ease);
+                std::memcpy(keys + k * sizeof(key), &key, sizeof(key));
+            }
+            break;
+        }
+        case RS3TimelineTrackType::Light: {
+            const auto sortedKeys = SortedKeys(source.lightKeys);
+            for (size_t k = 0; k < sortedKeys.size(); ++k) {
+                RS3CompiledLightKey key;
+                key.t = sortedKeys[k].t;
+                key.color = sortedKeys[k].color;
+                key.intensity = sortedKeys[k].intensity;
+                key.ease = static_cast<uint32_t>(sortedKeys[k].ease);
+                std::memcpy(keys + k * sizeof(key), &key, sizeof(key));
+            }
+            break;
+        }
+        case RS3TimelineTrackType::Fog: {
+            const auto sortedKeys = SortedKeys(source.fogKeys);
+            for (size_t k = 0; k < sortedKeys.size(); ++k) {
+                RS3CompiledFogKey key;
+                key.t = sortedKeys[k].t;
+                key.fogMin = sortedKeys[k].fogMin;
+                key.fogMax = sortedKeys[k].fogMax;
+                key.color = sortedKeys[k].color;
+                key.ease = static_cast<uint32_t>(sortedKeys[k].ease);
+                std::memcpy(keys + k * sizeof(key), &key, sizeof(key));
+            }
+            break;
+        }
+        case RS3TimelineTrackType::ClipTrigger: {
+            const auto& sortedKeys = sortedClipKeys[i];
+            for (size_t k = 0; k < sortedKeys.size(); ++k) {
+                RS3CompiledClipKey key;
+                key.t = sortedKeys[k].t;
+                key.clipOffset = clipStrings[i][k].first;
+                key.clipLength = clipStrings[i][k].second;
+                key.speed = sortedKeys[k].speed;
+                key.loop = sortedKeys[k].loop ? 1u : 0u;
+                std::memcpy(keys + k * sizeof(key), &key, sizeof(key));
+            }
+            break;
+        }
+        }
+    }
+
+    if (!audioClips.empty()) {
+        std::memcpy(base + audioClipsOffset, audioClips.data(), audioClips.size() * sizeof(RS3CompiledAudioClip));
+    }
+    std::memcpy(base + stringsOffset, strings.data(), strings.size());
+    return true;
+}
+
+bool RS3CompiledTimeline::WriteFile(const RS3TimelineData& timeline, const std::string& filePath, std::string* outError) {
+    std::vector<uint8_t> bytes;
+    if (!Compile(timeline, bytes, outError)) {
+        return false;
+    }
+
+    // Write then rename so a running client never maps a half-written file
+    const fs::path finalPath(filePath);
+    fs::path tempPath = finalPath;
+    tempPath += ".tmp";
+    {
+        std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+        if (!out.is_open()) {
+            SetError(outError, "Failed to open compiled timeline for writing: " + filePath);
+            return false;
+        }
+        out.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+        if (!out.good()) {
+            SetError(outError, "Failed to write compiled timeline: " + filePath);
+            return false;
+        }
+    }
+
+    std::error_code ec;
+    fs::rename(tempPath, finalPath, ec);
+    if (ec) {
+        fs::remove(tempPath, ec);
+        SetError(outError, "Failed to replace compiled timeline: " + filePath);
+        return false;
+    }
+    return true;
+}
+
+std::string RS3CompiledTimeline::GetCompiledPath(const std::string& timelinePath) {
+    static constexpr const char* kJsonExtension = ".ndgcine.json";
+    std::string lower = timelinePath;
+    std::transform(lower.begin(), lower.end(), lower.begin(), [](unsigned char c) {
+        return static_cast<char>(std::tolower(c));
+    });
+
+    std::string stem = timelinePath;
+    const size_t jsonLength = std::strlen(kJsonExtension);
+    if (lower.size() >= jsonLength && lower.compare(lower.size() - jsonLength, jsonLength, kJsonExtension) == 0) {
+        stem.resize(stem.size() - jsonLength);
+    } else {
+        fs::path path(timelinePath);
+        path.replace_extension();
+        stem = path.string();
+    }
+    return stem + kFileExtension;
+}
+
+bool RS3CompiledTimeline::Open(const std::string& filePath, std::string* outError) {
+    auto mapping = std::make_shared<MappedFile>();
+    if (!mapping->Open(filePath, outError)) {
+        return false;
+    }
+    const uint8_t* data = mapping->GetData();
+    const size_t size = mapping->GetSize();
+    return Attach(std::move(mapping), data, size, outError);
+}
+
+bool RS3CompiledTimeline::LoadFromTimeline(const RS3TimelineData& timeline, std::string* outError) {
+    auto bytes = std::make_shared<std::vector<uint8_t>>();
+    if (!Compile(timeline, *bytes, outError)) {
+        return false;
+    }
+    const uint8_t* data = bytes->data();
+    const size_t size = bytes->size();
+    return Attach(std::move(bytes), data, size, outError);
+}
+
+bool RS3CompiledTimeline::Attach(std::shared_ptr<const void> owner, const uint8_t* data, size_t size, std::string* outError) {
+    if (!data || size < kHeaderSize || std::memcmp(data, kCompiledMagic.data(), kCompiledMagic.size()) != 0) {
+        SetError(outError, "Not a compiled ndg_cine timeline.");
+        return false;
+    }
+
+    CompiledHeader header;
+    header.version = ReadAt<uint32_t>(data + 8);
+    header.mode = ReadAt<uint32_t>(data + 12);
+    header.durationSec = ReadAt<float>(data + 16);
+    header.fps = ReadAt<int32_t>(data + 20);
+    header.keyframeCount = ReadAt<uint32_t>(data + 24);
+    header.keyframesOffset = ReadAt<uint32_t>(data + 28);
+    header.segmentsOffset = ReadAt<uint32_t>(data + 32);
+    header.stringsOffset = ReadAt<uint32_t>(data + 36);
+    header.sceneIdLength = ReadAt<uint32_t>(data + 40);
+    header.audioFileLength = ReadAt<uint32_t>(data + 44);
+    header.audioOffsetSec = ReadAt<float>(data + 48);
+    header.audioGainDb = ReadAt<float>(data + 52);
+    header.audioEnabled = ReadAt<uint32_t>(data + 56);
+    header.fileSize = ReadAt<uint32_t>(data + 60);
+    header.trackCount = ReadAt<uint32_t>(data + 64);
+    header.tracksOffset = ReadAt<uint32_t>(data + 68);
+    header.stringsSize = ReadAt<uint32_t>(data + 72);
+    header.audioClipCount = ReadAt<uint32_t>(data + 76);
+    header.audioClipsOffset = ReadAt<uint32_t>(data + 80);
+
+    if (header.version != kFormatVersion) {
+        SetError(outError, "Unsupported compiled timeline version " + std::to_string(header.version) + ".");
+        return false;
+    }
+    if (header.fileSize != size || header.keyframeCount == 0 || header.mode > static_cast<uint32_t>(RS3RenderMode::Gameplay)) {
+        SetError(outError, "Compiled timeline header is invalid.");
+        return false;
+    }
+
+    const uint64_t keyframesEnd = static_cast<uint64_t>(header.keyframesOffset) + static_cast<uint64_t>(header.keyframeCount) * sizeof(RS3CompiledKeyframe);
+    const uint64_t segmentsEnd = static_cast<uint64_t>(header.segmentsOffset) + static_cast<uint64_t>(header.keyframeCount - 1) * sizeof(RS3CompiledSegment);
+    const uint64_t tracksEnd = static_cast<uint64_t>(header.tracksOffset) + static_cast<uint64_t>(header.trackCount) * sizeof(RS3CompiledTrack);
+    const uint64_t audioClipsEnd = static_cast<uint64_t>(header.audioClipsOffset) + static_cast<uint64_t>(header.audioClipCount) * sizeof(RS3CompiledAudioClip);
+    const uint64_t stringsEnd = static_cast<uint64_t>(header.stringsOffset) + header.stringsSize;
+    if (header.keyframesOffset < kHeaderSize || header.keyframesOffset % alignof(RS3CompiledKeyframe) != 0 ||
+        header.segmentsOffset < keyframesEnd || header.segmentsOffset % alignof(RS3CompiledSegment) != 0 ||
+        header.tracksOffset < segmentsEnd || header.tracksOffset % alignof(RS3CompiledTrack) != 0 ||
+        header.audioClipsOffset < tracksEnd || header.audioClipsOffset % alignof(RS3CompiledAudioClip) != 0 ||
+        header.stringsOffset < audioClipsEnd || stringsEnd > size ||
+        static_cast<uint64_t>(header.sceneIdLength) + header.audioFileLength > header.stringsSize) {
+        SetError(outError, "Compiled timeline sections are out of range.");
+        return false;
+    }
+
+    // Tracks are checked once here so evaluation can index keys and strings without bounds checks
+    const RS3CompiledTrack* tracks = reinterpret_cast<const RS3CompiledTrack*>(data + header.tracksOffset);
+    const auto stringInRange = [&header](uint32_t offset, uint32_t length) {
+        return static_cast<uint64_t>(offset) + length <= header.stringsSize;
+    };
+    for (uint32_t i = 0; i < header.trackCount; ++i) {
+        const RS3CompiledTrack& track = tracks[i];
+        const size_t keySize = GetTrackKeySize(track.type);
+        const uint64_t keysEnd = static_cast<uint64_t>(track.keysOffset) + static_cast<uint64_t>(track.keyCount) * keySize;
+        if (keySize == 0 || track.keyCount == 0 || track.keysOffset < audioClipsEnd || track.keysOffset % 4 != 0 ||
+            keysEnd > header.stringsOffset || !stringInRange(track.nameOffset, track.nameLength) ||
+            !stringInRange(track.targetOffset, track.targetLength)) {
+            SetError(outError, "Compiled timeline track " + std::to_string(i) + " is invalid.");
+            return false;
+        }
+        if (static_cast<RS3TimelineTrackType>(track.type) == RS3TimelineTrackType::ClipTrigger) {
+            const RS3CompiledClipKey* keys = reinterpret_cast<const RS3CompiledClipKey*>(data + track.keysOffset);
+            for (uint32_t k = 0; k < track.keyCount; ++k) {
+                if (!stringInRange(keys[k].clipOffset, keys[k].clipLength)) {
+                    SetError(outError, "Compiled timeline track " + std::to_string(i) + " has an invalid clip name.");
+                    return false;
+                }
+            }
+        }
+    }
+
+    const RS3CompiledAudioClip* audioClips = reinterpret_cast<const RS3CompiledAudioClip*>(data + header.audioClipsOffset);
+    for (uint32_t i = 0; i < header.audioClipCount; ++i) {
+        if (!stringInRange(audioClips[i].fileOffset, audioClips[i].fileLength)) {
+            SetError(outError, "Compiled timeline audio clip " + std::to_string(i) + " is invalid.");
+            return false;
+        }
+    }
+
+    m_owner = std::move(owner);
+    m_base = data;
+    m_strings = std::string_view(reinterpret_cast<const char*>(data + header.stringsOffset), header.stringsSize);
+    m_sceneId = m_strings.substr(0, header.sceneIdLength);
+    m_mode = static_cast<RS3RenderMode>(header.mode);
+    m_durationSec = header.durationSec;
+    m_fps = std::max(1, static_cast<int>(header.fps));
+    m_keyframeCount = header.keyframeCount;
+    m_keyframes = reinterpret_cast<const RS3CompiledKeyframe*>(data + header.keyframesOffset);
+    m_segments = reinterpret_cast<const RS3CompiledSegment*>(data + header.segmentsOffset);
+    m_trackCount = header.trackCount;
+    m_tracks = tracks;
+    m_audio = RS3TimelineAudio{};
+    m_audio.enabled = header.audioEnabled != 0;
+    m_audio.file = std::string(m_strings.substr(header.sceneIdLength, header.audioFileLength));
+    m_audio.offsetSec = header.audioOffsetSec;
+    m_audio.gainDb = header.audioGainDb;
+    m_audio.clips.reserve(header.audioClipCount);
+    for (uint32_t i = 0; i < header.audioClipCount; ++i) {
+        const RS3CompiledAudioClip& source = audioClips[i];
+        RS3TimelineAudioClip clip;
+        clip.file = std::string(GetString(source.fileOffset, source.fileLength));
+        clip.startSec = source.startSec;
+        clip.trimInSec = source.trimInSec;
+        clip.durationSec = source.durationSec;
+        clip.gainDb = source.gainDb;
+        clip.fadeInSec = source.fadeInSec;
+        clip.fadeOutSec = source.fadeOutSec;
+        m_audio.clips.push_back(std::move(clip));
+    }
+    return true;
+}
+
+void RS3CompiledTimeline::ToTimelineData(RS3TimelineData& outTimeline) const {
+    outTimeline = RS3TimelineData{};
+    outTimeline.sceneId = std::string(m_sceneId);
+    outTimeline.mode = m_mode;
+    outTimeline.durationSec = m_durationSec;
+    outTimeline.fps = m_fps;
+    outTimeline.audio = m_audio;
+    outTimeline.keyframes.reserve(m_keyframeCount);
+    for (uint32_t i = 0; i < m_keyframeCount; ++i) {
+        const RS3CompiledKeyframe& key = m_keyframes[i];
+        RS3TimelineKeyframe kf;
+        kf.t = key.t;
+        kf.position = key.position;
+        kf.target = key.target;
+        kf.rollDeg = key.rollDeg;
+        kf.fovDeg = key.fovDeg;
+        kf.ease = ToEase(key.ease);
+        outTimeline.keyframes.push_back(kf);
+    }
+
+    outTimeline.tracks.resize(m_trackCount);
+    for (uint32_t i = 0; i < m_trackCount; ++i) {
+        const RS3CompiledTrack& source = m_tracks[i];
+        RS3TimelineTrack& track = outTimeline.tracks[i];
+        track.type = static_cast<RS3TimelineTrackType>(source.type);
+        track.name = std::string(GetString(source.nameOffset, source.nameLength));
+        track.target = std::string(GetString(source.targetOffset, source.targetLength));
+        switch (track.type) {
+        case RS3TimelineTrackType::Transform: {
+            const auto* keys = GetTrackKeys<RS3CompiledTransformKey>(source);
+            for (uint32_t k = 0; k < source.keyCount; ++k) {
+                RS3TimelineTransformKey key;
+                key.t = keys[k].t;
+                key.position = keys[k].position;
+                key.rotationDeg = TransformRotationToDegrees(keys[k].rotation);
+                key.scale = keys[k].scale;
+                key.ease = ToEase(keys[k].ease);
+                track.transformKeys.push_back(key);
+            }
+            break;
+        }
+        case RS3TimelineTrackType::Light: {
+            const auto* keys = GetTrackKeys<RS3CompiledLightKey>(source);
+            for (uint32_t k = 0; k < source.keyCount; ++k) {
+                RS3TimelineLightKey key;
+                key.t = keys[k].t;
+                key.color = keys[k].color;
+                key.intensity = keys[k].intensity;
+                key.ease = ToEase(keys[k].ease);
+                track.lightKeys.push_back(key);
+            }
+            break;
+        }
+        case RS3TimelineTrackType::Fog: {
+            const auto* keys = GetTrackKeys<RS3CompiledFogKey>(source);
+            for (uint32_t k = 0; k < source.keyCount; ++k) {
+                RS3TimelineFogKey key;
+                key.t = keys[k].t;
+                key.fogMin = keys[k].fogMin;
+                key.fogMax = keys[k].fogMax;
+                key.color = keys[k].color;
+                key.ease = ToEase(keys[k].ease);
+                track.fogKeys.push_back(key);
+            }
+            break;
+        }
+        case RS3TimelineTrackType::ClipTrigger: {
+            const auto* keys = GetTrackKeys<RS3CompiledClipKey>(source);
+            for (uint32_t k = 0; k < source.keyCount; ++k) {
+                RS3TimelineClipKey key;
+                key.t = keys[k].t;
+                key.clip = std::string(GetString(keys[k].clipOffset, keys[k].clipLength));
+                key.speed = keys[k].speed;
+                key.loop = keys[k].loop != 0;
+                track.clipKeys.push_back(std::move(key));
+            }
+            break;
+        }
+        }
+    }
+}
+
+bool LoadCompiledTimeline(const std::string& timelinePath, std::shared_ptr<const RS3CompiledTimeline>& outTimeline, std::string* outError) {
+    std::string resolvedPath;
+    if (!ResolveTimelineFile(timelinePath, resolvedPath)) {
+        SetError(outError, "Timeline file not found: '" + timelinePath + "'.");
+        return false;
+    }
+
+    auto compiled = std::make_shared<RS3CompiledTimeline>();
+    if (IsCompiledTimelinePath(resolvedPath)) {
+        if (!compiled->Open(resolvedPath, outError)) {
+            return false;
+        }
+        outTimeline = std::move(compiled);
+        return true;
+    }
+
+    // Prefer the compiled sibling unless the JSON was edited after it was written
+    const std::string compiledPath = RS3CompiledTimeline::GetCompiledPath(resolvedPath);
+    std::error_code ec;
+    const auto compiledTime = fs::last_write_time(compiledPath, ec);
+    if (!ec) {
+        const auto sourceTime = fs::last_write_time(resolvedPath, ec);
+        if (!ec && compiledTime >= sourceTime) {
+            std::string compiledError;
+            if (compiled->Open(compiledPath, &compiledError)) {
+                outTimeline = std::move(compiled);
+                return true;
+            }
+            AppLogger::Log("[RS3] Ignoring compiled timeline '" + compiledPath + "': " + compiledError);
+        }
+    }
+
+    RS3TimelineData timeline;
+    if (!LoadTimelineFromFile(resolvedPath, timeline, outError)) {
+        return false;
+    }
+    if (!compiled->LoadFromTimeline(timeline, outError)) {
+        return false;
+    }
+    outTimeline = std::move(compiled);
+    return true;
+}
+
+} // namespace RealSpace3
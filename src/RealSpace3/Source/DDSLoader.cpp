@@ -2,7 +2,11 @@
 #define NOMINMAX
 #endif
 #include "../Include/DDSLoader.h"
+#include "../Include/BCnDecoder.h"
+#include "../Include/MipGenerator.h"
 #include "AppLogger.h"
+#include <atomic>
+#include <cstring>
 #include <fstream>
 #include <vector>
 #include <algorithm>
@@ -12,199 +16,283 @@
 
 namespace RealSpace3 {
 
-// DDS file structures
-#pragma pack(push, 1)
-struct DDS_PIXELFORMAT {
-    uint32_t dwSize;
-    uint32_t dwFlags;
-    uint32_t dwFourCC;
-    uint32_t dwRGBBitCount;
-    uint32_t dwRBitMask;
-    uint32_t dwGBitMask;
-    uint32_t dwBBitMask;
-    uint32_t dwABitMask;
-};
-
-struct DDS_HEADER {
-    uint32_t dwSize;
-    uint32_t dwFlags;
-    uint32_t dwHeight;
-    uint32_t dwWidth;
-    uint32_t dwPitchOrLinearSize;
-    uint32_t dwDepth;
-    uint32_t dwMipMapCount;
-    uint32_t dwReserved1[11];
-    DDS_PIXELFORMAT ddspf;
-    uint32_t dwCaps;
-    uint32_t dwCaps2;
-    uint32_t dwCaps3;
-    uint32_t dwCaps4;
-    uint32_t dwReserved2;
-};
-#pragma pack(pop)
-
-constexpr uint32_t DDS_MAGIC = 0x20534444; // "DDS "
-constexpr uint32_t DDPF_FOURCC = 0x4;
-constexpr uint32_t DDPF_RGB = 0x40;
-constexpr uint32_t DDPF_ALPHAPIXELS = 0x1;
-
-#ifndef MAKEFOURCC
-#define MAKEFOURCC(a, b, c, d) ((uint32_t)(uint8_t)(a) | ((uint32_t)(uint8_t)(b) << 8) | ((uint32_t)(uint8_t)(c) << 16) | ((uint32_t)(uint8_t)(d) << 24))
-#endif
+namespace {
 
-DXGI_FORMAT DDSLoader::GetDXGIFormat(uint32_t fourCC, uint32_t rgbBitCount, uint32_t rMask, uint32_t gMask, uint32_t bMask, uint32_t aMask) {
-    if (fourCC == MAKEFOURCC('D','X','T','1')) return DXGI_FORMAT_BC1_UNORM;
-    if (fourCC == MAKEFOURCC('D','X','T','2') || fourCC == MAKEFOURCC('D','X','T','3')) return DXGI_FORMAT_BC2_UNORM;
-    if (fourCC == MAKEFOURCC('D','X','T','4') || fourCC == MAKEFOURCC('D','X','T','5')) return DXGI_FORMAT_BC3_UNORM;
-
-    // Uncompressed
-    if (rgbBitCount == 32) {
-        if (rMask == 0x00FF0000 && gMask == 0x0000FF00 && bMask == 0x000000FF && aMask == 0xFF000000)
-            return DXGI_FORMAT_B8G8R8A8_UNORM;
-        if (rMask == 0x000000FF && gMask == 0x0000FF00 && bMask == 0x00FF0000 && aMask == 0xFF000000)
-            return DXGI_FORMAT_R8G8B8A8_UNORM;
-    }
-    if (rgbBitCount == 24) {
-        // 24-bit BGR — we'll need to convert, but for now use BGRA
-        return DXGI_FORMAT_B8G8R8A8_UNORM;
+bool IsMipGenerationFormat(DXGI_FORMAT format) {
+    switch (format) {
+    case DXGI_FORMAT_R8G8B8A8_UNORM:
+    case DXGI_FORMAT_R8G8B8A8_UNORM_SRGB:
+    case DXGI_FORMAT_B8G8R8A8_UNORM:
+    case DXGI_FORMAT_B8G8R8A8_UNORM_SRGB:
+    case DXGI_FORMAT_B8G8R8X8_UNORM:
+    case DXGI_FORMAT_B8G8R8X8_UNORM_SRGB:
+        return true;
+    default:
+        return false;
     }
+}
+
+// Shared tail of the WIC paths: first frame converted to BGRA, then a generated mip chain.
+HRESULT DecodeWICFrame(IWICImagingFactory* wicFactory, IWICBitmapDecoder* decoder, DecodedTexture& outTexture) {
+    Microsoft::WRL::ComPtr<IWICBitmapFrameDecode> frame;
+    HRESULT hr = decoder->GetFrame(0, &frame);
+    if (FAILED(hr)) return hr;
+
+    UINT width, height;
+    frame->GetSize(&width, &height);
 
-    return DXGI_FORMAT_UNKNOWN;
+    // Convert to BGRA
+    Microsoft::WRL::ComPtr<IWICFormatConverter> converter;
+    hr = wicFactory->CreateFormatConverter(&converter);
+    if (FAILED(hr)) return hr;
+
+    hr = converter->Initialize(frame.Get(), GUID_WICPixelFormat32bppBGRA, WICBitmapDitherTypeNone, nullptr, 0.0f, WICBitmapPaletteTypeCustom);
+    if (FAILED(hr)) return hr;
+
+    outTexture.pixels.resize(width * height * 4);
+    hr = converter->CopyPixels(nullptr, width * 4, (UINT)outTexture.pixels.size(), outTexture.pixels.data());
+    if (FAILED(hr)) return hr;
+
+    outTexture.width = width;
+    outTexture.height = height;
+    outTexture.mipLevels = 1;
+    outTexture.format = DXGI_FORMAT_B8G8R8A8_UNORM;
+    outTexture.subresources.push_back({ 0, width * 4, (uint32_t)outTexture.pixels.size() });
+    DDSLoader::GenerateMips(outTexture);
+    return S_OK;
 }
 
-size_t DDSLoader::BitsPerPixel(DXGI_FORMAT fmt) {
-    switch(fmt) {
-    case DXGI_FORMAT_BC1_UNORM: return 4;
-    case DXGI_FORMAT_BC2_UNORM: return 8;
-    case DXGI_FORMAT_BC3_UNORM: return 8;
-    case DXGI_FORMAT_R8G8B8A8_UNORM:
-    case DXGI_FORMAT_B8G8R8A8_UNORM: return 32;
-    default: return 32;
+// Block formats BCnDecoder can expand, with the RGBA8 format that samples the same.
+bool GetCpuDecodeFormat(DXGI_FORMAT format, BCnFormat& outFormat, DXGI_FORMAT& outDecodedFormat) {
+    outDecodedFormat = DXGI_FORMAT_R8G8B8A8_UNORM;
+    switch (format) {
+    case DXGI_FORMAT_BC1_UNORM_SRGB: outDecodedFormat = DXGI_FORMAT_R8G8B8A8_UNORM_SRGB; [[fallthrough]];
+    case DXGI_FORMAT_BC1_UNORM: outFormat = BCnFormat::BC1; return true;
+    case DXGI_FORMAT_BC2_UNORM_SRGB: outDecodedFormat = DXGI_FORMAT_R8G8B8A8_UNORM_SRGB; [[fallthrough]];
+    case DXGI_FORMAT_BC2_UNORM: outFormat = BCnFormat::BC2; return true;
+    case DXGI_FORMAT_BC3_UNORM_SRGB: outDecodedFormat = DXGI_FORMAT_R8G8B8A8_UNORM_SRGB; [[fallthrough]];
+    case DXGI_FORMAT_BC3_UNORM: outFormat = BCnFormat::BC3; return true;
+    case DXGI_FORMAT_BC4_UNORM: outFormat = BCnFormat::BC4; return true;
+    case DXGI_FORMAT_BC5_UNORM: outFormat = BCnFormat::BC5; return true;
+    case DXGI_FORMAT_BC7_UNORM_SRGB: outDecodedFormat = DXGI_FORMAT_R8G8B8A8_UNORM_SRGB; [[fallthrough]];
+    case DXGI_FORMAT_BC7_UNORM: outFormat = BCnFormat::BC7; return true;
+    default: return false;
     }
 }
 
-void DDSLoader::GetSurfaceInfo(size_t width, size_t height, DXGI_FORMAT fmt, size_t& numBytes, size_t& rowBytes, size_t& numRows) {
-    bool bc = false;
-    size_t bcnumBytesPerBlock = 0;
+bool IsTexture2DFormatSupported(ID3D11Device* device, DXGI_FORMAT format) {
+    UINT support = 0;
+    return SUCCEEDED(device->CheckFormatSupport(format, &support)) && (support & D3D11_FORMAT_SUPPORT_TEXTURE2D) != 0;
+}
 
-    switch(fmt) {
-    case DXGI_FORMAT_BC1_UNORM: bc = true; bcnumBytesPerBlock = 8; break;
-    case DXGI_FORMAT_BC2_UNORM: bc = true; bcnumBytesPerBlock = 16; break;
-    case DXGI_FORMAT_BC3_UNORM: bc = true; bcnumBytesPerBlock = 16; break;
-    default: break;
+// CPU fallback for block formats the device cannot create (BC7 below feature level 11, drivers
+// that reject a format): expands mips [firstMip, mipLevels) to RGBA8 and uploads that instead.
+HRESULT CreateDecompressed(ID3D11Device* device, const DecodedTexture& texture, BCnFormat bcnFormat, DXGI_FORMAT decodedFormat,
+                           Microsoft::WRL::ComPtr<ID3D11ShaderResourceView>& outSRV, uint32_t firstMip) {
+    static std::atomic<uint32_t> loggedFormats{ 0 };
+    const uint32_t formatBit = 1u << static_cast<uint32_t>(bcnFormat);
+    if ((loggedFormats.fetch_or(formatBit) & formatBit) == 0) {
+        AppLogger::Log("[DDSLoader] DXGI format " + std::to_string(static_cast<int>(texture.format))
+            + " not supported by the device; decoding on the CPU to RGBA8.");
     }
 
-    if (bc) {
-        size_t numBlocksWide = (std::max)(size_t(1), (width + 3) / 4);
-        size_t numBlocksHigh = (std::max)(size_t(1), (height + 3) / 4);
-        rowBytes = numBlocksWide * bcnumBytesPerBlock;
-        numRows = numBlocksHigh;
-        numBytes = rowBytes * numBlocksHigh;
-    } else {
-        size_t bpp = BitsPerPixel(fmt);
-        rowBytes = (width * bpp + 7) / 8;
-        numRows = height;
-        numBytes = rowBytes * height;
+    DecodedTexture rgba;
+    rgba.width = std::max<uint32_t>(1, texture.width >> firstMip);
+    rgba.height = std::max<uint32_t>(1, texture.height >> firstMip);
+    rgba.mipLevels = texture.mipLevels - firstMip;
+    rgba.arraySize = texture.arraySize;
+    rgba.isCubemap = texture.isCubemap;
+    rgba.format = decodedFormat;
+
+    size_t totalBytes = 0;
+    for (uint32_t slice = 0; slice < rgba.arraySize; ++slice) {
+        for (uint32_t mip = 0; mip < rgba.mipLevels; ++mip) {
+            const uint32_t width = std::max<uint32_t>(1, rgba.width >> mip);
+            const uint32_t height = std::max<uint32_t>(1, rgba.height >> mip);
+            rgba.subresources.push_back({ totalBytes, width * 4, width * height * 4 });
+            totalBytes += static_cast<size_t>(width) * height * 4;
+        }
+    }
+    rgba.pixels.resize(totalBytes);
+
+    for (uint32_t slice = 0; slice < rgba.arraySize; ++slice) {
+        for (uint32_t mip = 0; mip < rgba.mipLevels; ++mip) {
+            const DecodedTextureSubresource& src = texture.subresources[slice * texture.mipLevels + firstMip + mip];
+            const DecodedTextureSubresource& dst = rgba.subresources[slice * rgba.mipLevels + mip];
+            const uint32_t width = std::max<uint32_t>(1, rgba.width >> mip);
+            const uint32_t height = std::max<uint32_t>(1, rgba.height >> mip);
+            std::string error;
+            if (!BCnDecoder::Decode(bcnFormat, width, height, texture.GetData() + src.offset, src.slicePitch,
+                    rgba.pixels.data() + dst.offset, dst.rowPitch, 0, &error)) {
+                AppLogger::Log("[DDSLoader] CPU BCn decode failed: " + error);
+                return E_FAIL;
+            }
+        }
     }
+    return DDSLoader::CreateFromDecoded(device, rgba, outSRV);
 }
 
+} // namespace
+
 HRESULT DDSLoader::LoadFromFile(ID3D11Device* device, const std::wstring& filePath, Microsoft::WRL::ComPtr<ID3D11ShaderResourceView>& outSRV) {
+    DecodedTexture texture;
+    HRESULT hr = DecodeFromFile(filePath, texture);
+    if (FAILED(hr)) return hr;
+    return CreateFromDecoded(device, texture, outSRV);
+}
+
+HRESULT DDSLoader::LoadWICFromFile(ID3D11Device* device, const std::wstring& filePath, Microsoft::WRL::ComPtr<ID3D11ShaderResourceView>& outSRV) {
+    DecodedTexture texture;
+    HRESULT hr = DecodeWICFromFile(filePath, texture);
+    if (FAILED(hr)) return hr;
+    return CreateFromDecoded(device, texture, outSRV);
+}
+
+HRESULT DDSLoader::CreateFromMemory(ID3D11Device* device, const uint8_t* data, size_t size, Microsoft::WRL::ComPtr<ID3D11ShaderResourceView>& outSRV) {
+    DecodedTexture texture;
+    HRESULT hr = DecodeFromMemory(data, size, texture, true);
+    if (FAILED(hr)) return hr;
+    return CreateFromDecoded(device, texture, outSRV);
+}
+
+HRESULT DDSLoader::DecodeFromFile(const std::wstring& filePath, DecodedTexture& outTexture) {
+    outTexture = DecodedTexture{};
+
     std::ifstream file(filePath, std::ios::binary | std::ios::ate);
     if (!file.is_open()) return E_FAIL;
 
     size_t fileSize = (size_t)file.tellg();
     file.seekg(0, std::ios::beg);
 
-    if (fileSize < sizeof(uint32_t) + sizeof(DDS_HEADER)) return E_FAIL;
+    if (fileSize < sizeof(uint32_t)) return E_FAIL;
 
     std::vector<uint8_t> data(fileSize);
     file.read(reinterpret_cast<char*>(data.data()), fileSize);
     file.close();
 
-    // Verify magic
-    uint32_t magic = *reinterpret_cast<uint32_t*>(data.data());
-    if (magic != DDS_MAGIC) {
-        // Not a DDS file, try WIC
-        return LoadWICFromFile(device, filePath, outSRV);
-    }
-
-    const DDS_HEADER* header = reinterpret_cast<const DDS_HEADER*>(data.data() + 4);
-    if (header->dwSize != 124) return E_FAIL;
-
-    uint32_t width = header->dwWidth;
-    uint32_t height = header->dwHeight;
-    uint32_t mipCount = (std::max)(header->dwMipMapCount, 1u);
-
-    DXGI_FORMAT format = DXGI_FORMAT_UNKNOWN;
+    // The bytes are already in memory; WIC decodes them from there instead of reopening the file.
+    return DecodeFromMemory(data.data(), data.size(), outTexture);
+}
 
-    if (header->ddspf.dwFlags & DDPF_FOURCC) {
-        format = GetDXGIFormat(header->ddspf.dwFourCC, 0, 0, 0, 0, 0);
-    } else if (header->ddspf.dwFlags & (DDPF_RGB | DDPF_ALPHAPIXELS)) {
-        format = GetDXGIFormat(0, header->ddspf.dwRGBBitCount, header->ddspf.dwRBitMask, header->ddspf.dwGBitMask, header->ddspf.dwBBitMask, header->ddspf.dwABitMask);
-    }
+HRESULT DDSLoader::DecodeFromMemory(const uint8_t* data, size_t size, DecodedTexture& outTexture, bool referenceSource) {
+    outTexture = DecodedTexture{};
+    if (!data || size < sizeof(uint32_t)) return E_INVALIDARG;
 
-    if (format == DXGI_FORMAT_UNKNOWN) {
-        // Fallback: try WIC
-        return LoadWICFromFile(device, filePath, outSRV);
+    if (!DDSParser::IsDDS(data, size)) {
+        // Not a DDS file, try WIC
+        return DecodeWICFromMemory(data, size, outTexture);
     }
 
-    size_t dataOffset = 4 + sizeof(DDS_HEADER);
-    // Check for DX10 extended header
-    if (header->ddspf.dwFourCC == MAKEFOURCC('D','X','1','0')) {
-        dataOffset += 20; // DDS_HEADER_DXT10
+    DDSInfo info;
+    std::string parseError;
+    if (!DDSParser::Parse(data, size, info, &parseError)) {
+        // WIC's DDS codec still handles a few layouts we reject (e.g. volume slices)
+        AppLogger::Log("[DDSLoader] " + parseError + " Trying WIC.");
+        return DecodeWICFromMemory(data, size, outTexture);
     }
+    return DecodeFromDDS(data, info, outTexture, referenceSource);
+}
 
-    const uint8_t* pixelData = data.data() + dataOffset;
-    size_t pixelDataSize = fileSize - dataOffset;
-
-    // Handle 24-bit BGR by converting to 32-bit BGRA
-    std::vector<uint8_t> convertedData;
-    if (header->ddspf.dwRGBBitCount == 24 && !(header->ddspf.dwFlags & DDPF_FOURCC)) {
-        size_t pixelCount = width * height;
-        convertedData.resize(pixelCount * 4);
-        for (size_t i = 0; i < pixelCount && i * 3 + 2 < pixelDataSize; ++i) {
-            convertedData[i * 4 + 0] = pixelData[i * 3 + 0]; // B
-            convertedData[i * 4 + 1] = pixelData[i * 3 + 1]; // G
-            convertedData[i * 4 + 2] = pixelData[i * 3 + 2]; // R
-            convertedData[i * 4 + 3] = 255;                    // A
+HRESULT DDSLoader::DecodeFromDDS(const uint8_t* fileData, const DDSInfo& info, DecodedTexture& outTexture, bool referenceSource) {
+    outTexture = DecodedTexture{};
+    if (!fileData || info.surfaces.empty()) return E_INVALIDARG;
+
+    if (referenceSource && !info.expand24Bit) {
+        outTexture.width = info.width;
+        outTexture.height = info.height;
+        outTexture.mipLevels = info.mipLevels;
+        outTexture.arraySize = info.arraySize;
+        outTexture.isCubemap = info.isCubemap;
+        outTexture.format = static_cast<DXGI_FORMAT>(info.format);
+        outTexture.externalData = fileData;
+        outTexture.subresources.reserve(info.surfaces.size());
+        for (const auto& surface : info.surfaces) {
+            outTexture.subresources.push_back({ surface.offset, surface.rowPitch, surface.slicePitch });
         }
-        pixelData = convertedData.data();
-        pixelDataSize = convertedData.size();
-        format = DXGI_FORMAT_B8G8R8A8_UNORM;
-        mipCount = 1; // Only base level for converted
+        // Only copies when a chain has to be generated
+        GenerateMips(outTexture);
+        return S_OK;
     }
 
-    // Create texture with first mip level only for simplicity
-    size_t numBytes, rowBytes, numRows;
-    GetSurfaceInfo(width, height, format, numBytes, rowBytes, numRows);
-
-    if (numBytes > pixelDataSize) {
-        return E_FAIL;
+    size_t totalBytes = 0;
+    for (const auto& surface : info.surfaces) totalBytes += surface.slicePitch;
+
+    outTexture.width = info.width;
+    outTexture.height = info.height;
+    outTexture.mipLevels = info.mipLevels;
+    outTexture.arraySize = info.arraySize;
+    outTexture.isCubemap = info.isCubemap;
+    outTexture.format = static_cast<DXGI_FORMAT>(info.format);
+    outTexture.pixels.resize(totalBytes);
+    outTexture.subresources.reserve(info.surfaces.size());
+
+    size_t offset = 0;
+    for (const auto& surface : info.surfaces) {
+        const uint8_t* src = fileData + surface.offset;
+        uint8_t* dst = outTexture.pixels.data() + offset;
+        if (info.expand24Bit) {
+            DDSParser::Expand24To32(src, dst, static_cast<size_t>(surface.width) * surface.height);
+        } else {
+            std::memcpy(dst, src, surface.slicePitch);
+        }
+        outTexture.subresources.push_back({ offset, surface.rowPitch, surface.slicePitch });
+        offset += surface.slicePitch;
     }
+    // Uncompressed single-level files get a chain here so they do not shimmer when minified;
+    // on failure the texture simply keeps its single level.
+    GenerateMips(outTexture);
+    return S_OK;
+}
 
-    D3D11_TEXTURE2D_DESC desc = {};
-    desc.Width = width;
-    desc.Height = height;
-    desc.MipLevels = 1; // Only top mip
-    desc.ArraySize = 1;
-    desc.Format = format;
-    desc.SampleDesc.Count = 1;
-    desc.Usage = D3D11_USAGE_DEFAULT;
-    desc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+HRESULT DDSLoader::GenerateMips(DecodedTexture& texture) {
+    if (texture.mipLevels != 1 || !IsMipGenerationFormat(texture.format)) return S_FALSE;
+    const uint32_t levelCount = MipGenerator::CountMipLevels(texture.width, texture.height);
+    if (levelCount <= 1) return S_FALSE;
+    if (texture.subresources.size() < texture.arraySize) return E_INVALIDARG;
+
+    // Content is sRGB-encoded even in the UNORM formats, so always filter in linear light
+    const bool alphaWeighted = texture.format != DXGI_FORMAT_B8G8R8X8_UNORM && texture.format != DXGI_FORMAT_B8G8R8X8_UNORM_SRGB;
+
+    std::vector<uint8_t> pixels;
+    pixels.reserve(texture.GetSizeBytes() + texture.GetSizeBytes() / 3 + 16);
+    std::vector<DecodedTextureSubresource> subresources;
+    subresources.reserve(static_cast<size_t>(levelCount) * texture.arraySize);
+
+    std::vector<MipLevelRGBA8> levels;
+    for (uint32_t slice = 0; slice < texture.arraySize; ++slice) {
+        const DecodedTextureSubresource& top = texture.subresources[slice];
+        if ((!texture.externalData && top.offset + top.slicePitch > texture.pixels.size()) ||
+            static_cast<size_t>(top.rowPitch) * texture.height > top.slicePitch) {
+            return E_INVALIDARG;
+        }
 
-    D3D11_SUBRESOURCE_DATA initData = {};
-    initData.pSysMem = pixelData;
-    initData.SysMemPitch = (UINT)rowBytes;
+        const uint8_t* topData = texture.GetData() + top.offset;
+        std::string error;
+        if (!MipGenerator::Generate(texture.width, texture.height, topData, top.rowPitch,
+                                    true, alphaWeighted, levels, &error)) {
+            AppLogger::Log("[DDSLoader] Mip generation failed: " + error);
+            return E_FAIL;
+        }
 
-    Microsoft::WRL::ComPtr<ID3D11Texture2D> tex;
-    HRESULT hr = device->CreateTexture2D(&desc, &initData, &tex);
-    if (FAILED(hr)) return hr;
+        subresources.push_back({ pixels.size(), top.rowPitch, top.slicePitch });
+        pixels.insert(pixels.end(), topData, topData + top.slicePitch);
+        for (const MipLevelRGBA8& level : levels) {
+            subresources.push_back({ pixels.size(), level.width * 4, static_cast<uint32_t>(level.pixels.size()) });
+            pixels.insert(pixels.end(), level.pixels.begin(), level.pixels.end());
+        }
+    }
 
-    hr = device->CreateShaderResourceView(tex.Get(), nullptr, &outSRV);
-    return hr;
+    texture.pixels.swap(pixels);
+    texture.externalData = nullptr;
+    texture.externalOwner.reset();
+    texture.subresources.swap(subresources);
+    texture.mipLevels = levelCount;
+    return S_OK;
 }
 
-HRESULT DDSLoader::LoadWICFromFile(ID3D11Device* device, const std::wstring& filePath, Microsoft::WRL::ComPtr<ID3D11ShaderResourceView>& outSRV) {
+HRESULT DDSLoader::DecodeWICFromFile(const std::wstring& filePath, DecodedTexture& outTexture) {
+    outTexture = DecodedTexture{};
+
     Microsoft::WRL::ComPtr<IWICImagingFactory> wicFactory;
     HRESULT hr = CoCreateInstance(CLSID_WICImagingFactory, nullptr, CLSCTX_INPROC_SERVER, IID_PPV_ARGS(&wicFactory));
     if (FAILED(hr)) return hr;
@@ -213,45 +301,91 @@ HRESULT DDSLoader::LoadWICFromFile(ID3D11Device* device, const std::wstring& fil
     hr = wicFactory->CreateDecoderFromFilename(filePath.c_str(), nullptr, GENERIC_READ, WICDecodeMetadataCacheOnLoad, &decoder);
     if (FAILED(hr)) return hr;
 
-    Microsoft::WRL::ComPtr<IWICBitmapFrameDecode> frame;
-    hr = decoder->GetFrame(0, &frame);
-    if (FAILED(hr)) return hr;
+    return DecodeWICFrame(wicFactory.Get(), decoder.Get(), outTexture);
+}
 
-    UINT width, height;
-    frame->GetSize(&width, &height);
+HRESULT DDSLoader::DecodeWICFromMemory(const uint8_t* data, size_t size, DecodedTexture& outTexture) {
+    outTexture = DecodedTexture{};
+    if (!data || size == 0 || size > MAXDWORD) return E_INVALIDARG;
 
-    // Convert to BGRA
-    Microsoft::WRL::ComPtr<IWICFormatConverter> converter;
-    hr = wicFactory->CreateFormatConverter(&converter);
+    Microsoft::WRL::ComPtr<IWICImagingFactory> wicFactory;
+    HRESULT hr = CoCreateInstance(CLSID_WICImagingFactory, nullptr, CLSCTX_INPROC_SERVER, IID_PPV_ARGS(&wicFactory));
     if (FAILED(hr)) return hr;
 
-    hr = converter->Initialize(frame.Get(), GUID_WICPixelFormat32bppBGRA, WICBitmapDitherTypeNone, nullptr, 0.0f, WICBitmapPaletteTypeCustom);
+    // The stream reads the caller's buffer directly; WIC never writes through it.
+    Microsoft::WRL::ComPtr<IWICStream> stream;
+    hr = wicFactory->CreateStream(&stream);
+    if (FAILED(hr)) return hr;
+    hr = stream->InitializeFromMemory(const_cast<BYTE*>(data), static_cast<DWORD>(size));
     if (FAILED(hr)) return hr;
 
-    std::vector<uint8_t> pixels(width * height * 4);
-    hr = converter->CopyPixels(nullptr, width * 4, (UINT)pixels.size(), pixels.data());
+    Microsoft::WRL::ComPtr<IWICBitmapDecoder> decoder;
+    hr = wicFactory->CreateDecoderFromStream(stream.Get(), nullptr, WICDecodeMetadataCacheOnLoad, &decoder);
     if (FAILED(hr)) return hr;
 
+    return DecodeWICFrame(wicFactory.Get(), decoder.Get(), outTexture);
+}
+
+HRESULT DDSLoader::CreateFromDecoded(ID3D11Device* device, const DecodedTexture& texture, Microsoft::WRL::ComPtr<ID3D11ShaderResourceView>& outSRV, uint32_t firstMip) {
+    if (!device || texture.format == DXGI_FORMAT_UNKNOWN || texture.subresources.empty()) return E_INVALIDARG;
+    if (firstMip >= texture.mipLevels || texture.arraySize == 0) return E_INVALIDARG;
+    if (texture.subresources.size() < static_cast<size_t>(texture.mipLevels) * texture.arraySize) return E_INVALIDARG;
+
+    BCnFormat bcnFormat = BCnFormat::BC1;
+    DXGI_FORMAT decodedFormat = DXGI_FORMAT_UNKNOWN;
+    const bool cpuDecodable = GetCpuDecodeFormat(texture.format, bcnFormat, decodedFormat);
+    if (cpuDecodable && !IsTexture2DFormatSupported(device, texture.format)) {
+        return CreateDecompressed(device, texture, bcnFormat, decodedFormat, outSRV, firstMip);
+    }
+
+    const uint32_t mipLevels = texture.mipLevels - firstMip;
+
     D3D11_TEXTURE2D_DESC desc = {};
-    desc.Width = width;
-    desc.Height = height;
-    desc.MipLevels = 1;
-    desc.ArraySize = 1;
-    desc.Format = DXGI_FORMAT_B8G8R8A8_UNORM;
+    desc.Width = std::max<uint32_t>(1, texture.width >> firstMip);
+    desc.Height = std::max<uint32_t>(1, texture.height >> firstMip);
+    desc.MipLevels = mipLevels;
+    desc.ArraySize = texture.arraySize;
+    desc.Format = texture.format;
     desc.SampleDesc.Count = 1;
     desc.Usage = D3D11_USAGE_DEFAULT;
     desc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
-
-    D3D11_SUBRESOURCE_DATA initData = {};
-    initData.pSysMem = pixels.data();
-    initData.SysMemPitch = width * 4;
+    if (texture.isCubemap) desc.MiscFlags = D3D11_RESOURCE_MISC_TEXTURECUBE;
+
+    // Subresources are slice-major (mip + slice * mipLevels); skip the dropped top mips of every slice.
+    std::vector<D3D11_SUBRESOURCE_DATA> initData(static_cast<size_t>(mipLevels) * texture.arraySize);
+    for (uint32_t slice = 0; slice < texture.arraySize; ++slice) {
+        for (uint32_t mip = 0; mip < mipLevels; ++mip) {
+            const DecodedTextureSubresource& sub = texture.subresources[slice * texture.mipLevels + firstMip + mip];
+            D3D11_SUBRESOURCE_DATA& init = initData[slice * mipLevels + mip];
+            init.pSysMem = texture.GetData() + sub.offset;
+            init.SysMemPitch = sub.rowPitch;
+            init.SysMemSlicePitch = sub.slicePitch;
+        }
+    }
 
     Microsoft::WRL::ComPtr<ID3D11Texture2D> tex;
-    hr = device->CreateTexture2D(&desc, &initData, &tex);
+    HRESULT hr = device->CreateTexture2D(&desc, initData.data(), &tex);
+    if (FAILED(hr) && cpuDecodable && hr != E_OUTOFMEMORY) {
+        return CreateDecompressed(device, texture, bcnFormat, decodedFormat, outSRV, firstMip);
+    }
     if (FAILED(hr)) return hr;
 
-    hr = device->CreateShaderResourceView(tex.Get(), nullptr, &outSRV);
-    return hr;
+    if (!texture.isCubemap) {
+        return device->CreateShaderResourceView(tex.Get(), nullptr, &outSRV);
+    }
+
+    // The default view of a cube-flagged array is a 2D array; ask for a cube view explicitly.
+    D3D11_SHADER_RESOURCE_VIEW_DESC srvDesc = {};
+    srvDesc.Format = texture.format;
+    if (texture.arraySize > 6) {
+        srvDesc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURECUBEARRAY;
+        srvDesc.TextureCubeArray.MipLevels = mipLevels;
+        srvDesc.TextureCubeArray.NumCubes = texture.arraySize / 6;
+    } else {
+        srvDesc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURECUBE;
+        srvDesc.TextureCube.MipLevels = mipLevels;
+    }
+    return device->CreateShaderResourceView(tex.Get(), &srvDesc, &outSRV);
 }
 
 }
@@ -0,0 +1,480 @@
+#include "../Include/DDSParser.h"
+
+#include <algorithm>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define RS3_DDS_SSE2 1
+#include <emmintrin.h>
+#else
+#define RS3_DDS_SSE2 0
+#endif
+
+namespace RealSpace3 {
+namespace {
+
+#pragma pack(push, 1)
+struct DDSPixelFormatHeader {
+    uint32_t size;
+    uint32_t flags;
+    uint32_t fourCC;
+    uint32_t rgbBitCount;
+    uint32_t rBitMask;
+    uint32_t gBitMask;
+    uint32_t bBitMask;
+    uint32_t aBitMask;
+};
+
+struct DDSFileHeader {
+    uint32_t size;
+    uint32_t flags;
+    uint32_t height;
+    uint32_t width;
+    uint32_t pitchOrLinearSize;
+    uint32_t depth;
+    uint32_t mipMapCount;
+    uint32_t reserved1[11];
+    DDSPixelFormatHeader ddspf;
+    uint32_t caps;
+    uint32_t caps2;
+    uint32_t caps3;
+    uint32_t caps4;
+    uint32_t reserved2;
+};
+
+struct DDSHeaderDX10 {
+    uint32_t dxgiFormat;
+    uint32_t resourceDimension;
+    uint32_t miscFlag;
+    uint32_t arraySize;
+    uint32_t miscFlags2;
+};
+#pragma pack(pop)
+
+static_assert(sizeof(DDSFileHeader) == 124, "DDS header must be 124 bytes");
+static_assert(sizeof(DDSHeaderDX10) == 20, "DX10 header must be 20 bytes");
+
+constexpr uint32_t DDPF_ALPHA = 0x2;
+constexpr uint32_t DDPF_FOURCC = 0x4;
+constexpr uint32_t DDPF_RGB = 0x40;
+constexpr uint32_t DDPF_LUMINANCE = 0x20000;
+
+constexpr uint32_t DDSD_DEPTH = 0x800000;
+constexpr uint32_t DDSCAPS2_CUBEMAP = 0x200;
+constexpr uint32_t DDSCAPS2_CUBEMAP_ALLFACES = 0xFC00;
+constexpr uint32_t DDSCAPS2_VOLUME = 0x200000;
+
+constexpr uint32_t kDimensionTexture2D = 3;
+constexpr uint32_t kMiscTextureCube = 0x4;
+// D3D11_REQ_TEXTURE2D_ARRAY_AXIS_DIMENSION and D3D11_REQ_TEXTURE2D_U_OR_V_DIMENSION: nothing
+// larger can be created, and the limits keep surface sizes and counts far from overflow.
+constexpr uint32_t kMaxArraySize = 2048;
+constexpr uint32_t kMaxDimension = 16384;
+
+constexpr uint32_t MakeFourCC(char a, char b, char c, char d) {
+    return static_cast<uint32_t>(static_cast<uint8_t>(a)) | (static_cast<uint32_t>(static_cast<uint8_t>(b)) << 8) |
+           (static_cast<uint32_t>(static_cast<uint8_t>(c)) << 16) | (static_cast<uint32_t>(static_cast<uint8_t>(d)) << 24);
+}
+
+void SetError(std::string* outError, const std::string& message) {
+    if (outError) *outError = message;
+}
+
+bool HasMasks(const DDSPixelFormatHeader& pf, uint32_t r, uint32_t g, uint32_t b, uint32_t a) {
+    return pf.rBitMask == r && pf.gBitMask == g && pf.bBitMask == b && pf.aBitMask == a;
+}
+
+DDSFormat GetLegacyFormat(const DDSPixelFormatHeader& pf, bool& outExpand24) {
+    outExpand24 = false;
+
+    if (pf.flags & DDPF_FOURCC) {
+        switch (pf.fourCC) {
+        case MakeFourCC('D', 'X', 'T', '1'): return DDSFormat::BC1_UNORM;
+        case MakeFourCC('D', 'X', 'T', '2'):
+        case MakeFourCC('D', 'X', 'T', '3'): return DDSFormat::BC2_UNORM;
+        case MakeFourCC('D', 'X', 'T', '4'):
+        case MakeFourCC('D', 'X', 'T', '5'): return DDSFormat::BC3_UNORM;
+        case MakeFourCC('A', 'T', 'I', '1'):
+        case MakeFourCC('B', 'C', '4', 'U'): return DDSFormat::BC4_UNORM;
+        case MakeFourCC('B', 'C', '4', 'S'): return DDSFormat::BC4_SNORM;
+        case MakeFourCC('A', 'T', 'I', '2'):
+        case MakeFourCC('B', 'C', '5', 'U'): return DDSFormat::BC5_UNORM;
+        case MakeFourCC('B', 'C', '5', 'S'): return DDSFormat::BC5_SNORM;
+        case 36: return DDSFormat::R16G16B16A16_UNORM;  // D3DFMT_A16B16G16R16
+        case 113: return DDSFormat::R16G16B16A16_FLOAT; // D3DFMT_A16B16G16R16F
+        case 116: return DDSFormat::R32G32B32A32_FLOAT; // D3DFMT_A32B32G32R32F
+        default: return DDSFormat::Unknown;
+        }
+    }
+
+    if (pf.flags & DDPF_RGB) {
+        switch (pf.rgbBitCount) {
+        case 32:
+            if (HasMasks(pf, 0x00FF0000, 0x0000FF00, 0x000000FF, 0xFF000000)) return DDSFormat::B8G8R8A8_UNORM;
+            if (HasMasks(pf, 0x000000FF, 0x0000FF00, 0x00FF0000, 0xFF000000)) return DDSFormat::R8G8B8A8_UNORM;
+            if (HasMasks(pf, 0x00FF0000, 0x0000FF00, 0x000000FF, 0x00000000)) return DDSFormat::B8G8R8X8_UNORM;
+            return DDSFormat::Unknown;
+        case 24:
+            outExpand24 = true;
+            // Stored R,G,B in memory order -> RGBA; otherwise the usual B,G,R -> BGRA.
+            if (HasMasks(pf, 0x000000FF, 0x0000FF00, 0x00FF0000, 0x00000000)) return DDSFormat::R8G8B8A8_UNORM;
+            return DDSFormat::B8G8R8A8_UNORM;
+        case 16:
+            if (HasMasks(pf, 0xF800, 0x07E0, 0x001F, 0x0000)) return DDSFormat::B5G6R5_UNORM;
+            if (HasMasks(pf, 0x7C00, 0x03E0, 0x001F, 0x8000)) return DDSFormat::B5G5R5A1_UNORM;
+            if (HasMasks(pf, 0x0F00, 0x00F0, 0x000F, 0xF000)) return DDSFormat::B4G4R4A4_UNORM;
+            return DDSFormat::Unknown;
+        default:
+            return DDSFormat::Unknown;
+        }
+    }
+
+    if (pf.flags & DDPF_LUMINANCE) {
+        if (pf.rgbBitCount == 8 && pf.rBitMask == 0xFF) return DDSFormat::R8_UNORM;
+        if (pf.rgbBitCount == 16 && pf.rBitMask == 0x00FF && pf.aBitMask == 0xFF00) return DDSFormat::R8G8_UNORM;
+        return DDSFormat::Unknown;
+    }
+
+    if ((pf.flags & DDPF_ALPHA) && pf.rgbBitCount == 8) return DDSFormat::A8_UNORM;
+
+    return DDSFormat::Unknown;
+}
+
+bool IsSupportedFormat(DDSFormat format) {
+    switch (format) {
+    case DDSFormat::R32G32B32A32_FLOAT:
+    case DDSFormat::R16G16B16A16_FLOAT:
+    case DDSFormat::R16G16B16A16_UNORM:
+    case DDSFormat::R8G8B8A8_UNORM:
+    case DDSFormat::R8G8B8A8_UNORM_SRGB:
+    case DDSFormat::R8G8_UNORM:
+    case DDSFormat::R8_UNORM:
+    case DDSFormat::A8_UNORM:
+    case DDSFormat::BC1_UNORM:
+    case DDSFormat::BC1_UNORM_SRGB:
+    case DDSFormat::BC2_UNORM:
+    case DDSFormat::BC2_UNORM_SRGB:
+    case DDSFormat::BC3_UNORM:
+    case DDSFormat::BC3_UNORM_SRGB:
+    case DDSFormat::BC4_UNORM:
+    case DDSFormat::BC4_SNORM:
+    case DDSFormat::BC5_UNORM:
+    case DDSFormat::BC5_SNORM:
+    case DDSFormat::B5G6R5_UNORM:
+    case DDSFormat::B5G5R5A1_UNORM:
+    case DDSFormat::B8G8R8A8_UNORM:
+    case DDSFormat::B8G8R8X8_UNORM:
+    case DDSFormat::B8G8R8A8_UNORM_SRGB:
+    case DDSFormat::B8G8R8X8_UNORM_SRGB:
+    case DDSFormat::BC6H_UF16:
+    case DDSFormat::BC6H_SF16:
+    case DDSFormat::BC7_UNORM:
+    case DDSFormat::BC7_UNORM_SRGB:
+    case DDSFormat::B4G4R4A4_UNORM:
+        return true;
+    default:
+        return false;
+    }
+}
+
+uint32_t MaxMipLevels(uint32_t width, uint32_t height) {
+    uint32_t levels = 1;
+    uint32_t size = std::max(width, height);
+    while (size > 1) {
+        size >>= 1;
+        ++levels;
+    }
+    return levels;
+}
+
+} // namespace
+
+bool DDSParser::IsDDS(const uint8_t* data, size_t size) {
+    if (!data || size < sizeof(uint32_t)) return false;
+    uint32_t magic = 0;
+    std::memcpy(&magic, data, sizeof(magic));
+    return magic == kMagic;
+}
+
+bool DDSParser::Parse(const uint8_t* data, size_t size, DDSInfo& outInfo, std::string* outError) {
+    outInfo = DDSInfo{};
+
+    if (!IsDDS(data, size)) {
+        SetError(outError, "Not a DDS file.");
+        return false;
+    }
+    if (size < sizeof(uint32_t) + sizeof(DDSFileHeader)) {
+        SetError(outError, "Truncated DDS header.");
+        return false;
+    }
+
+    DDSFileHeader header;
+    std::memcpy(&header, data + sizeof(uint32_t), sizeof(header));
+    if (header.size != sizeof(DDSFileHeader) || header.ddspf.size != sizeof(DDSPixelFormatHeader)) {
+        SetError(outError, "Invalid DDS header size.");
+        return false;
+    }
+    if (header.width == 0 || header.height == 0) {
+        SetError(outError, "DDS has zero width or height.");
+        return false;
+    }
+    if (header.width > kMaxDimension || header.height > kMaxDimension) {
+        SetError(outError, "DDS is larger than " + std::to_string(kMaxDimension) + " texels per side.");
+        return false;
+    }
+
+    size_t dataOffset = sizeof(uint32_t) + sizeof(DDSFileHeader);
+    DDSFormat format = DDSFormat::Unknown;
+    uint32_t arraySize = 1;
+    bool isCubemap = false;
+    bool expand24 = false;
+
+    if ((header.ddspf.flags & DDPF_FOURCC) && header.ddspf.fourCC == MakeFourCC('D', 'X', '1', '0')) {
+        if (size < dataOffset + sizeof(DDSHeaderDX10)) {
+            SetError(outError, "Truncated DX10 header.");
+            return false;
+        }
+        DDSHeaderDX10 dx10;
+        std::memcpy(&dx10, data + dataOffset, sizeof(dx10));
+        dataOffset += sizeof(DDSHeaderDX10);
+        outInfo.hasDX10Header = true;
+
+        if (dx10.resourceDimension != kDimensionTexture2D) {
+            SetError(outError, "Only 2D DDS textures are supported (dimension " + std::to_string(dx10.resourceDimension) + ").");
+            return false;
+        }
+        if (dx10.arraySize == 0) {
+            SetError(outError, "DX10 header has zero array size.");
+            return false;
+        }
+        // Checked before the cube multiply so it cannot wrap
+        const bool cube = (dx10.miscFlag & kMiscTextureCube) != 0;
+        if (dx10.arraySize > (cube ? kMaxArraySize / 6 : kMaxArraySize)) {
+            SetError(outError, "DX10 array size " + std::to_string(dx10.arraySize) + (cube ? " cubes" : "") + " exceeds the D3D11 limit.");
+            return false;
+        }
+        format = static_cast<DDSFormat>(dx10.dxgiFormat);
+        arraySize = cube ? dx10.arraySize * 6 : dx10.arraySize;
+        isCubemap = cube;
+    } else {
+        if ((header.caps2 & DDSCAPS2_VOLUME) || ((header.flags & DDSD_DEPTH) && header.depth > 1)) {
+            SetError(outError, "Volume DDS textures are not supported.");
+            return false;
+        }
+        if (header.caps2 & DDSCAPS2_CUBEMAP) {
+            if ((header.caps2 & DDSCAPS2_CUBEMAP_ALLFACES) != DDSCAPS2_CUBEMAP_ALLFACES) {
+                SetError(outError, "Partial DDS cubemaps are not supported.");
+                return false;
+            }
+            isCubemap = true;
+            arraySize = 6;
+        }
+        format = GetLegacyFormat(header.ddspf, expand24);
+    }
+
+    if (!IsSupportedFormat(format)) {
+        SetError(outError, "Unsupported DDS format (DXGI " + std::to_string(static_cast<uint32_t>(format)) + ").");
+        return false;
+    }
+    if (isCubemap && header.width != header.height) {
+        SetError(outError, "DDS cubemap faces must be square.");
+        return false;
+    }
+
+    const uint32_t mipLevels = std::min(std::max(1u, header.mipMapCount), MaxMipLevels(header.width, header.height));
+
+    // Every slice needs at least its top mip: reject array sizes the file cannot hold before
+    // reserving surfaces for them
+    size_t topBytes = 0, topRowBytes = 0, topRows = 0;
+    GetSurfaceInfo(header.width, header.height, format, topBytes, topRowBytes, topRows);
+    const size_t topSourceBytes = expand24 ? static_cast<size_t>(header.width) * header.height * 3 : topBytes;
+    if (size < dataOffset || topSourceBytes == 0 || arraySize > (size - dataOffset) / topSourceBytes) {
+        SetError(outError, "DDS pixel data is truncated.");
+        return false;
+    }
+
+    // Lay out every surface; a truncated chain keeps the levels that fit when there is a single slice.
+    std::vector<DDSSurface> surfaces;
+    surfaces.reserve(static_cast<size_t>(mipLevels) * arraySize);
+    uint32_t keptMips = mipLevels;
+    size_t offset = dataOffset;
+    for (uint32_t slice = 0; slice < arraySize; ++slice) {
+        for (uint32_t mip = 0; mip < mipLevels; ++mip) {
+            DDSSurface surface;
+            surface.arraySlice = slice;
+            surface.mipLevel = mip;
+            surface.width = std::max(1u, header.width >> mip);
+            surface.height = std::max(1u, header.height >> mip);
+
+            size_t numBytes = 0, rowBytes = 0, numRows = 0;
+            GetSurfaceInfo(surface.width, surface.height, format, numBytes, rowBytes, numRows);
+            surface.offset = offset;
+            surface.rowPitch = static_cast<uint32_t>(rowBytes);
+            surface.slicePitch = static_cast<uint32_t>(numBytes);
+            surface.sourceBytes = expand24 ? static_cast<size_t>(surface.width) * surface.height * 3 : numBytes;
+
+            if (offset + surface.sourceBytes > size) {
+                if (arraySize == 1 && mip > 0) {
+                    keptMips = mip;
+                    break;
+                }
+                SetError(outError, "DDS pixel data is truncated.");
+                return false;
+            }
+            offset += surface.sourceBytes;
+            surfaces.push_back(surface);
+        }
+    }
+
+    outInfo.width = header.width;
+    outInfo.height = header.height;
+    outInfo.mipLevels = keptMips;
+    outInfo.arraySize = arraySize;
+    outInfo.isCubemap = isCubemap;
+    outInfo.expand24Bit = expand24;
+    outInfo.format = format;
+    outInfo.dataOffset = dataOffset;
+    outInfo.surfaces = std::move(surfaces);
+    return true;
+}
+
+bool DDSParser::IsBlockCompressed(DDSFormat format) {
+    switch (format) {
+    case DDSFormat::BC1_UNORM:
+    case DDSFormat::BC1_UNORM_SRGB:
+    case DDSFormat::BC2_UNORM:
+    case DDSFormat::BC2_UNORM_SRGB:
+    case DDSFormat::BC3_UNORM:
+    case DDSFormat::BC3_UNORM_SRGB:
+    case DDSFormat::BC4_UNORM:
+    case DDSFormat::BC4_SNORM:
+    case DDSFormat::BC5_UNORM:
+    case DDSFormat::BC5_SNORM:
+    case DDSFormat::BC6H_UF16:
+    case DDSFormat::BC6H_SF16:
+    case DDSFormat::BC7_UNORM:
+    case DDSFormat::BC7_UNORM_SRGB:
+        return true;
+    default:
+        return false;
+    }
+}
+
+bool DDSParser::IsSrgb(DDSFormat format) {
+    switch (format) {
+    case DDSFormat::R8G8B8A8_UNORM_SRGB:
+    case DDSFormat::BC1_UNORM_SRGB:
+    case DDSFormat::BC2_UNORM_SRGB:
+    case DDSFormat::BC3_UNORM_SRGB:
+    case DDSFormat::B8G8R8A8_UNORM_SRGB:
+    case DDSFormat::B8G8R8X8_UNORM_SRGB:
+    case DDSFormat::BC7_UNORM_SRGB:
+        return true;
+    default:
+        return false;
+    }
+}
+
+DDSFormat DDSParser::MakeSrgb(DDSFormat format) {
+    switch (format) {
+    case DDSFormat::R8G8B8A8_UNORM: return DDSFormat::R8G8B8A8_UNORM_SRGB;
+    case DDSFormat::BC1_UNORM: return DDSFormat::BC1_UNORM_SRGB;
+    case DDSFormat::BC2_UNORM: return DDSFormat::BC2_UNORM_SRGB;
+    case DDSFormat::BC3_UNORM: return DDSFormat::BC3_UNORM_SRGB;
+    case DDSFormat::B8G8R8A8_UNORM: return DDSFormat::B8G8R8A8_UNORM_SRGB;
+    case DDSFormat::B8G8R8X8_UNORM: return DDSFormat::B8G8R8X8_UNORM_SRGB;
+    case DDSFormat::BC7_UNORM: return DDSFormat::BC7_UNORM_SRGB;
+    default: return format;
+    }
+}
+
+size_t DDSParser::BitsPerPixel(DDSFormat format) {
+    switch (format) {
+    case DDSFormat::R32G32B32A32_FLOAT:
+        return 128;
+    case DDSFormat::R16G16B16A16_FLOAT:
+    case DDSFormat::R16G16B16A16_UNORM:
+        return 64;
+    case DDSFormat::R8G8B8A8_UNORM:
+    case DDSFormat::R8G8B8A8_UNORM_SRGB:
+    case DDSFormat::B8G8R8A8_UNORM:
+    case DDSFormat::B8G8R8X8_UNORM:
+    case DDSFormat::B8G8R8A8_UNORM_SRGB:
+    case DDSFormat::B8G8R8X8_UNORM_SRGB:
+        return 32;
+    case DDSFormat::R8G8_UNORM:
+    case DDSFormat::B5G6R5_UNORM:
+    case DDSFormat::B5G5R5A1_UNORM:
+    case DDSFormat::B4G4R4A4_UNORM:
+        return 16;
+    case DDSFormat::R8_UNORM:
+    case DDSFormat::A8_UNORM:
+    case DDSFormat::BC2_UNORM:
+    case DDSFormat::BC2_UNORM_SRGB:
+    case DDSFormat::BC3_UNORM:
+    case DDSFormat::BC3_UNORM_SRGB:
+    case DDSFormat::BC5_UNORM:
+    case DDSFormat::BC5_SNORM:
+    case DDSFormat::BC6H_UF16:
+    case DDSFormat::BC6H_SF16:
+    case DDSFormat::BC7_UNORM:
+    case DDSFormat::BC7_UNORM_SRGB:
+        return 8;
+    case DDSFormat::BC1_UNORM:
+    case DDSFormat::BC1_UNORM_SRGB:
+    case DDSFormat::BC4_UNORM:
+    case DDSFormat::BC4_SNORM:
+        return 4;
+    default:
+        return 0;
+    }
+}
+
+bool DDSParser::GetSurfaceInfo(uint32_t width, uint32_t height, DDSFormat format, size_t& outNumBytes, size_t& outRowBytes, size_t& outNumRows) {
+    outNumBytes = outRowBytes = outNumRows = 0;
+    const size_t bpp = BitsPerPixel(format);
+    if (bpp == 0) return false;
+
+    if (IsBlockCompressed(format)) {
+        const size_t blockBytes = bpp * 2; // 4 bpp -> 8-byte blocks, 8 bpp -> 16-byte blocks
+        const size_t blocksWide = std::max<size_t>(1, (static_cast<size_t>(width) + 3) / 4);
+        const size_t blocksHigh = std::max<size_t>(1, (static_cast<size_t>(height) + 3) / 4);
+        outRowBytes = blocksWide * blockBytes;
+        outNumRows = blocksHigh;
+    } else {
+        outRowBytes = (static_cast<size_t>(width) * bpp + 7) / 8;
+        outNumRows = height;
+    }
+    outNumBytes = outRowBytes * outNumRows;
+    return true;
+}
+
+void DDSParser::Expand24To32(const uint8_t* src, uint8_t* dst, size_t pixelCount) {
+    size_t i = 0;
+#if RS3_DDS_SSE2
+    // 4 pixels per step: shift the 12 source bytes so pixel k lands in lane k,
+    // keep its low 3 bytes and OR in opaque alpha. The 16-byte load reads 4 bytes
+    // past the 4 pixels, so stop while that stays inside the source.
+    const __m128i lane0 = _mm_setr_epi32(0x00FFFFFF, 0, 0, 0);
+    const __m128i lane1 = _mm_setr_epi32(0, 0x00FFFFFF, 0, 0);
+    const __m128i lane2 = _mm_setr_epi32(0, 0, 0x00FFFFFF, 0);
+    const __m128i lane3 = _mm_setr_epi32(0, 0, 0, 0x00FFFFFF);
+    const __m128i alpha = _mm_set1_epi32(static_cast<int>(0xFF000000u));
+    for (; i + 6 <= pixelCount; i += 4) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 3));
+        __m128i out = _mm_and_si128(v, lane0);
+        out = _mm_or_si128(out, _mm_and_si128(_mm_slli_si128(v, 1), lane1));
+        out = _mm_or_si128(out, _mm_and_si128(_mm_slli_si128(v, 2), lane2));
+        out = _mm_or_si128(out, _mm_and_si128(_mm_slli_si128(v, 3), lane3));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i * 4), _mm_or_si128(out, alpha));
+    }
+#endif
+    for (; i < pixelCount; ++i) {
+        dst[i * 4 + 0] = src[i * 3 + 0];
+        dst[i * 4 + 1] = src[i * 3 + 1];
+        dst[i * 4 + 2] = src[i * 3 + 2];
+        dst[i * 4 + 3] = 255;
+    }
+}
+
+} // namespace RealSpace3
@@ -0,0 +1,580 @@
+#include "../Include/FrameSink.h"
+
+#include "AppLogger.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <cerrno>
+#include <csignal>
+#include <ctime>
+#include <pthread.h>
+#include <sys/wait.h>
+#endif
+
+namespace RealSpace3 {
+namespace {
+
+void SetError(std::string* outError, const std::string& message) {
+    if (outError) {
+        *outError = message;
+    }
+}
+
+double ElapsedMs(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+bool WriteFileBytes(const std::string& path, const std::vector<uint8_t>& bytes, std::string* outError) {
+    std::ofstream out(std::filesystem::path(path), std::ios::binary | std::ios::trunc);
+    if (!out) {
+        SetError(outError, "Failed to open frame file: " + path);
+        return false;
+    }
+    out.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+    if (!out) {
+        SetError(outError, "Failed to write frame file: " + path);
+        return false;
+    }
+    return true;
+}
+
+#ifndef _WIN32
+// Blocks SIGPIPE on the calling thread while it writes to the pipe, so a child that exits early
+// surfaces as EPIPE instead of killing the process. A SIGPIPE raised meanwhile is consumed before
+// the mask is restored; the process-wide disposition is left to the application.
+class ScopedSigpipeBlock {
+public:
+    ScopedSigpipeBlock() {
+        sigemptyset(&m_sigpipe);
+        sigaddset(&m_sigpipe, SIGPIPE);
+        sigset_t pending;
+        sigpending(&pending);
+        m_wasPending = sigismember(&pending, SIGPIPE) == 1;
+        pthread_sigmask(SIG_BLOCK, &m_sigpipe, &m_previous);
+    }
+
+    ~ScopedSigpipeBlock() {
+        if (!m_wasPending) {
+            sigset_t pending;
+            sigpending(&pending);
+            if (sigismember(&pending, SIGPIPE) == 1) {
+                const timespec zero = { 0, 0 };
+                while (sigtimedwait(&m_sigpipe, nullptr, &zero) == -1 && errno == EINTR) {
+                }
+            }
+        }
+        pthread_sigmask(SIG_SETMASK, &m_previous, nullptr);
+    }
+
+    ScopedSigpipeBlock(const ScopedSigpipeBlock&) = delete;
+    ScopedSigpipeBlock& operator=(const ScopedSigpipeBlock&) = delete;
+
+private:
+    sigset_t m_sigpipe;
+    sigset_t m_previous;
+    bool m_wasPending = false;
+};
+#endif
+
+} // namespace
+
+RS3FramePipeSink::RS3FramePipeSink(CommandBuilder buildCommand)
+    : m_buildCommand(std::move(buildCommand)) {
+}
+
+RS3FramePipeSink::~RS3FramePipeSink() {
+    Close(nullptr);
+}
+
+std::string RS3FramePipeSink::BuildRawVideoInputArgs(uint32_t width, uint32_t height, int fps) {
+    return "-f rawvideo -pix_fmt bgra -s " + std::to_string(width) + "x" + std::to_string(height) +
+        " -r " + std::to_string(std::max(1, fps)) + " -i -";
+}
+
+bool RS3FramePipeSink::Open(uint32_t width, uint32_t height, int fps, std::string* outError) {
+    const std::string command = m_buildCommand ? m_buildCommand(width, height, fps) : std::string();
+    if (command.empty()) {
+        SetError(outError, "Frame pipe command is empty.");
+        return false;
+    }
+    AppLogger::Log("[RS3] Frame pipe: " + command);
+
+#ifdef _WIN32
+    // _popen does not work from GUI processes; spawn the child with a pipe on its stdin instead
+    SECURITY_ATTRIBUTES security = {};
+    security.nLength = sizeof(security);
+    security.bInheritHandle = TRUE;
+    HANDLE readEnd = nullptr;
+    HANDLE writeEnd = nullptr;
+    if (!CreatePipe(&readEnd, &writeEnd, &security, 1u << 20)) {
+        SetError(outError, "Failed to create frame pipe.");
+        return false;
+    }
+    SetHandleInformation(writeEnd, HANDLE_FLAG_INHERIT, 0);
+
+    STARTUPINFOA startup = {};
+    startup.cb = sizeof(startup);
+    startup.dwFlags = STARTF_USESTDHANDLES;
+    startup.hStdInput = readEnd;
+    startup.hStdOutput = GetStdHandle(STD_OUTPUT_HANDLE);
+    startup.hStdError = GetStdHandle(STD_ERROR_HANDLE);
+
+    PROCESS_INFORMATION process = {};
+    std::vector<char> commandLine(command.begin(), command.end());
+    commandLine.push_back('\0');
+    const BOOL created = CreateProcessA(nullptr, commandLine.data(), nullptr, nullptr, TRUE, CREATE_NO_WINDOW,
+        nullptr, nullptr, &startup, &process);
+    CloseHandle(readEnd);
+    if (!created) {
+        CloseHandle(writeEnd);
+        SetError(outError, "Failed to start frame pipe process (error " + std::to_string(GetLastError()) + ").");
+        return false;
+    }
+    CloseHandle(process.hThread);
+    m_stdinWrite = writeEnd;
+    m_process = process.hProcess;
+#else
+    m_pipe = popen(command.c_str(), "w");
+    if (!m_pipe) {
+        SetError(outError, "Failed to start frame pipe process.");
+        return false;
+    }
+#endif
+    return true;
+}
+
+bool RS3FramePipeSink::WriteBytes(const uint8_t* data, size_t size) {
+#ifdef _WIN32
+    while (size > 0) {
+        const DWORD chunk = static_cast<DWORD>(std::min<size_t>(size, 1u << 30));
+        DWORD written = 0;
+        if (!WriteFile(static_cast<HANDLE>(m_stdinWrite), data, chunk, &written, nullptr) || written == 0) {
+            return false;
+        }
+        data += written;
+        size -= written;
+    }
+    return true;
+#else
+    // A child that exits early must surface as a write error, not kill the exporter
+    ScopedSigpipeBlock blockSigpipe;
+    return std::fwrite(data, 1, size, m_pipe) == size;
+#endif
+}
+
+bool RS3FramePipeSink::WriteFrame(const RS3CapturedFrame& frame, std::string* outError) {
+#ifdef _WIN32
+    const bool open = m_stdinWrite != nullptr;
+#else
+    const bool open = m_pipe != nullptr;
+#endif
+    if (!open) {
+        SetError(outError, "Frame pipe is not open.");
+        return false;
+    }
+
+    const size_t frameBytes = static_cast<size_t>(frame.width) * frame.height * 4u;
+    if (frame.bgra.size() < frameBytes) {
+        SetError(outError, "Frame " + std::to_string(frame.index) + " is smaller than its size.");
+        return false;
+    }
+    if (!WriteBytes(frame.bgra.data(), frameBytes)) {
+        SetError(outError, "Frame pipe closed while writing frame " + std::to_string(frame.index) + ".");
+        return false;
+    }
+    return true;
+}
+
+bool RS3FramePipeSink::Close(std::string* outError) {
+#ifdef _WIN32
+    if (!m_process) return true;
+    CloseHandle(static_cast<HANDLE>(m_stdinWrite));
+    m_stdinWrite = nullptr;
+    WaitForSingleObject(static_cast<HANDLE>(m_process), INFINITE);
+    DWORD exitCode = 1;
+    GetExitCodeProcess(static_cast<HANDLE>(m_process), &exitCode);
+    CloseHandle(static_cast<HANDLE>(m_process));
+    m_process = nullptr;
+    const int rc = static_cast<int>(exitCode);
+#else
+    if (!m_pipe) return true;
+    int status = -1;
+    {
+        // pclose flushes what fwrite still buffers
+        ScopedSigpipeBlock blockSigpipe;
+        status = pclose(m_pipe);
+    }
+    m_pipe = nullptr;
+    const int rc = (status != -1 && WIFEXITED(status)) ? WEXITSTATUS(status) : -1;
+#endif
+    AppLogger::Log("[RS3] Frame pipe exit code: " + std::to_string(rc));
+    if (rc != 0) {
+        SetError(outError, "Frame pipe process exited with code " + std::to_string(rc) + ".");
+        return false;
+    }
+    return true;
+}
+
+RS3ImageSequenceSink::RS3ImageSequenceSink(std::string directory, std::string prefix, RS3ImageFormat format,
+    uint32_t threadCount, uint32_t maxFramesInFlight)
+    : m_directory(std::move(directory))
+    , m_prefix(std::move(prefix))
+    , m_format(format) {
+    m_threadCount = threadCount > 0 ? threadCount : std::max(1u, std::thread::hardware_concurrency());
+    m_slotCount = std::max(m_threadCount, maxFramesInFlight > 0 ? maxFramesInFlight : m_threadCount * 2u);
+}
+
+RS3ImageSequenceSink::~RS3ImageSequenceSink() {
+    Close(nullptr);
+}
+
+std::string RS3ImageSequenceSink::GetFramePath(uint64_t index) const {
+    char name[32];
+    std::snprintf(name, sizeof(name), "_%06llu", static_cast<unsigned long long>(index));
+    return (std::filesystem::path(m_directory) / (m_prefix + name + GetImageFormatExtension(m_format))).string();
+}
+
+bool RS3ImageSequenceSink::Open(uint32_t width, uint32_t height, int fps, std::string* outError) {
+    (void)fps;
+    if (m_open) {
+        SetError(outError, "Image sequence sink already open.");
+        return false;
+    }
+    if (width == 0 || height == 0) {
+        SetError(outError, "Image sequence frame size is empty.");
+        return false;
+    }
+    std::error_code ec;
+    std::filesystem::create_directories(std::filesystem::path(m_directory), ec);
+    if (ec) {
+        SetError(outError, "Failed to create frame directory: " + m_directory);
+        return false;
+    }
+
+    m_freeSlots.clear();
+    m_jobs.clear();
+    for (uint32_t i = 0; i < m_slotCount; ++i) {
+        m_freeSlots.push_back(std::make_unique<Slot>());
+    }
+    m_closing = false;
+    m_failed = false;
+    m_error.clear();
+    m_stats = {};
+    m_open = true;
+    for (uint32_t i = 0; i < m_threadCount; ++i) {
+        m_threads.emplace_back(&RS3ImageSequenceSink::EncoderLoop, this);
+    }
+    AppLogger::Log("[RS3] Image sequence: " + GetFramePath(0) + " (" + std::to_string(m_threadCount) +
+        " threads, " + std::to_string(m_slotCount) + " frames in flight)");
+    return true;
+}
+
+bool RS3ImageSequenceSink::WriteFrame(const RS3CapturedFrame& frame, std::string* outError) {
+    const size_t frameBytes = static_cast<size_t>(frame.width) * frame.height * 4u;
+    if (frame.width == 0 || frame.height == 0 || frame.bgra.size() < frameBytes) {
+        SetError(outError, "Frame " + std::to_string(frame.index) + " is smaller than its size.");
+        return false;
+    }
+
+    std::unique_ptr<Slot> slot;
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        if (!m_open) {
+            SetError(outError, "Image sequence sink is not open.");
+            return false;
+        }
+        if (m_freeSlots.empty() && !m_failed) {
+            const auto waitStart = std::chrono::steady_clock::now();
+            m_slotFree.wait(lock, [this]() { return !m_freeSlots.empty() || m_failed; });
+            m_stats.producerWaitMs += ElapsedMs(waitStart);
+        }
+        if (m_failed) {
+            SetError(outError, m_error);
+            return false;
+        }
+        slot = std::move(m_freeSlots.back());
+        m_freeSlots.pop_back();
+    }
+
+    // The caller reuses its buffer as soon as this returns, so the pixels are copied into the slot
+    slot->frame.index = frame.index;
+    slot->frame.width = frame.width;
+    slot->frame.height = frame.height;
+    slot->frame.bgra.assign(frame.bgra.begin(), frame.bgra.begin() + static_cast<std::ptrdiff_t>(frameBytes));
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_jobs.push_back(std::move(slot));
+    m_jobReady.notify_one();
+    return true;
+}
+
+void RS3ImageSequenceSink::EncoderLoop() {
+    for (;;) {
+        std::unique_ptr<Slot> slot;
+        bool failed = false;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_jobReady.wait(lock, [this]() { return !m_jobs.empty() || m_closing; });
+            if (m_jobs.empty()) return;
+            slot = std::move(m_jobs.front());
+            m_jobs.pop_front();
+            failed = m_failed;
+        }
+
+        std::string error;
+        bool ok = true;
+        double encodeMs = 0.0;
+        double fileMs = 0.0;
+        if (!failed) {
+            const RS3CapturedFrame& frame = slot->frame;
+            const auto encodeStart = std::chrono::steady_clock::now();
+            ok = ImageEncoder::Encode(m_format, frame.bgra.data(), frame.width, frame.height,
+                static_cast<size_t>(frame.width) * 4u, slot->encoded);
+            encodeMs = ElapsedMs(encodeStart);
+            if (!ok) {
+                error = "Failed to encode frame " + std::to_string(frame.index) + ".";
+            } else {
+                const auto fileStart = std::chrono::steady_clock::now();
+                ok = WriteFileBytes(GetFramePath(frame.index), slot->encoded, &error);
+                fileMs = ElapsedMs(fileStart);
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!failed) {
+            m_stats.encodeMs += encodeMs;
+            m_stats.fileMs += fileMs;
+            if (ok) {
+                ++m_stats.framesWritten;
+                m_stats.encodedBytes += slot->encoded.size();
+            } else if (!m_failed) {
+                m_failed = true;
+                m_error = error;
+            }
+        }
+        m_freeSlots.push_back(std::move(slot));
+        m_slotFree.notify_all();
+    }
+}
+
+bool RS3ImageSequenceSink::Close(std::string* outError) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_open) return true;
+        m_closing = true;
+        m_jobReady.notify_all();
+    }
+    for (std::thread& thread : m_threads) {
+        thread.join();
+    }
+    m_threads.clear();
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_open = false;
+    AppLogger::Log("[RS3] Image sequence: " + std::to_string(m_stats.framesWritten) + " frames, " +
+        std::to_string(m_stats.encodedBytes) + " bytes");
+    if (m_failed) {
+        SetError(outError, m_error);
+        return false;
+    }
+    return true;
+}
+
+RS3ImageSequenceStats RS3ImageSequenceSink::GetStats() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_stats;
+}
+
+RS3FrameRingSink::RS3FrameRingSink(uint32_t capacity)
+    : m_ring(std::max(1u, capacity)) {
+}
+
+bool RS3FrameRingSink::Open(uint32_t width, uint32_t height, int fps, std::string* outError) {
+    (void)width;
+    (void)height;
+    (void)fps;
+    (void)outError;
+    for (RS3CapturedFrame& frame : m_ring) {
+        frame.width = 0;
+        frame.height = 0;
+    }
+    m_next = 0;
+    m_framesSeen = 0;
+    return true;
+}
+
+bool RS3FrameRingSink::WriteFrame(const RS3CapturedFrame& frame, std::string* outError) {
+    const size_t frameBytes = static_cast<size_t>(frame.width) * frame.height * 4u;
+    if (frame.bgra.size() < frameBytes) {
+        SetError(outError, "Frame " + std::to_string(frame.index) + " is smaller than its size.");
+        return false;
+    }
+    RS3CapturedFrame& slot = m_ring[m_next];
+    slot.index = frame.index;
+    slot.width = frame.width;
+    slot.height = frame.height;
+    slot.bgra.assign(frame.bgra.begin(), frame.bgra.begin() + static_cast<std::ptrdiff_t>(frameBytes));
+    m_next = (m_next + 1) % m_ring.size();
+    ++m_framesSeen;
+    return true;
+}
+
+bool RS3FrameRingSink::Close(std::string* outError) {
+    (void)outError;
+    return true;
+}
+
+std::vector<const RS3CapturedFrame*> RS3FrameRingSink::GetFrames() const {
+    std::vector<const RS3CapturedFrame*> frames;
+    const size_t count = static_cast<size_t>(std::min<uint64_t>(m_framesSeen, m_ring.size()));
+    frames.reserve(count);
+    const size_t first = (m_next + m_ring.size() - count) % m_ring.size();
+    for (size_t i = 0; i < count; ++i) {
+        frames.push_back(&m_ring[(first + i) % m_ring.size()]);
+    }
+    return frames;
+}
+
+RS3FrameWriter::RS3FrameWriter(RS3FrameSink& sink, uint32_t poolSize)
+    : m_sink(sink) {
+    m_pool.reserve(std::max(1u, poolSize));
+    for (uint32_t i = 0; i < std::max(1u, poolSize); ++i) {
+        m_pool.push_back(std::make_unique<RS3CapturedFrame>());
+    }
+}
+
+RS3FrameWriter::~RS3FrameWriter() {
+    Finish(nullptr);
+}
+
+bool RS3FrameWriter::Start(int fps, std::string* outError) {
+    if (m_started) {
+        SetError(outError, "Frame writer already started.");
+        return false;
+    }
+    m_fps = std::max(1, fps);
+    m_started = true;
+    m_thread = std::thread(&RS3FrameWriter::WriterLoop, this);
+    return true;
+}
+
+std::unique_ptr<RS3CapturedFrame> RS3FrameWriter::AcquireFrame() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    if (m_pool.empty() && !m_failed) {
+        const auto waitStart = std::chrono::steady_clock::now();
+        m_poolChanged.wait(lock, [this]() { return !m_pool.empty() || m_failed; });
+        m_stats.producerWaitMs += ElapsedMs(waitStart);
+    }
+    if (m_failed) return nullptr;
+
+    std::unique_ptr<RS3CapturedFrame> frame = std::move(m_pool.back());
+    m_pool.pop_back();
+    return frame;
+}
+
+bool RS3FrameWriter::SubmitFrame(std::unique_ptr<RS3CapturedFrame> frame) {
+    if (!frame) return false;
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_failed || !m_started || m_finishing) {
+        m_pool.push_back(std::move(frame));
+        m_poolChanged.notify_all();
+        return false;
+    }
+    m_queue.push_back(std::move(frame));
+    m_queueChanged.notify_one();
+    return true;
+}
+
+void RS3FrameWriter::WriterLoop() {
+    for (;;) {
+        std::unique_ptr<RS3CapturedFrame> frame;
+        bool failed = false;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_queueChanged.wait(lock, [this]() { return !m_queue.empty() || m_finishing; });
+            if (m_queue.empty()) return;
+            frame = std::move(m_queue.front());
+            m_queue.pop_front();
+            failed = m_failed;
+        }
+
+        // After a failure the queue is only drained so the producer's buffers come back
+        std::string error;
+        bool ok = true;
+        double sinkMs = 0.0;
+        if (!failed) {
+            const auto sinkStart = std::chrono::steady_clock::now();
+            if (!m_sinkOpen) {
+                ok = frame->width > 0 && frame->height > 0 && m_sink.Open(frame->width, frame->height, m_fps, &error);
+                if (ok) {
+                    m_sinkOpen = true;
+                    m_width = frame->width;
+                    m_height = frame->height;
+                } else if (error.empty()) {
+                    error = "Frame " + std::to_string(frame->index) + " has no pixels.";
+                }
+            } else if (frame->width != m_width || frame->height != m_height) {
+                ok = false;
+                error = "Frame " + std::to_string(frame->index) + " changed size during capture.";
+            }
+            if (ok) {
+                ok = m_sink.WriteFrame(*frame, &error);
+            }
+            sinkMs = ElapsedMs(sinkStart);
+        }
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!failed) {
+            m_stats.sinkMs += sinkMs;
+            if (ok) {
+                ++m_stats.framesWritten;
+            } else {
+                m_failed = true;
+                m_error = error;
+            }
+        }
+        m_pool.push_back(std::move(frame));
+        m_poolChanged.notify_all();
+    }
+}
+
+bool RS3FrameWriter::Finish(std::string* outError) {
+    if (!m_started) return !m_failed;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_finishing = true;
+        m_queueChanged.notify_all();
+    }
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+    m_started = false;
+
+    std::string closeError;
+    if (m_sinkOpen) {
+        m_sinkOpen = false;
+        if (!m_sink.Close(&closeError) && !m_failed) {
+            m_failed = true;
+            m_error = closeError;
+        }
+    }
+    if (m_failed) {
+        SetError(outError, m_error);
+        return false;
+    }
+    return true;
+}
+
+RS3FrameWriterStats RS3FrameWriter::GetStats() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_stats;
+}
+
+} // namespace RealSpace3
@@ -0,0 +1,450 @@
+#include "../Include/ImageEncoder.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <cstring>
+
+namespace RealSpace3 {
+namespace {
+
+constexpr uint8_t kPngSignature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+constexpr uint32_t kHashBits = 15;
+constexpr uint32_t kWindowSize = 32768;
+constexpr uint32_t kMinMatch = 4;
+constexpr uint32_t kMaxMatch = 258;
+
+constexpr uint16_t kLengthBase[29] = { 3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+constexpr uint8_t kLengthExtra[29] = { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+constexpr uint16_t kDistanceBase[30] = { 1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577 };
+constexpr uint8_t kDistanceExtra[30] = { 0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+
+uint32_t ReverseBits(uint32_t value, uint32_t count) {
+    uint32_t out = 0;
+    for (uint32_t i = 0; i < count; ++i) {
+        out = (out << 1) | ((value >> i) & 1u);
+    }
+    return out;
+}
+
+// Fixed Huffman codes (RFC 1951 3.2.6), bit-reversed for the LSB-first stream, plus the
+// length/distance code lookups and the CRC-32 slice-by-8 tables.
+struct DeflateTables {
+    uint16_t literalCode[288];
+    uint8_t literalBits[288];
+    uint8_t distanceCode[30];
+    uint8_t lengthSymbol[kMaxMatch + 1];
+    uint8_t distanceSymbolLow[256];   // distance - 1 < 256
+    uint8_t distanceSymbolHigh[256];  // (distance - 1) >> 7 otherwise
+    uint32_t crc[8][256];
+
+    DeflateTables() {
+        for (uint32_t v = 0; v < 288; ++v) {
+            uint32_t code = 0;
+            uint32_t bits = 0;
+            if (v < 144) { code = 0x30 + v; bits = 8; }
+            else if (v < 256) { code = 0x190 + (v - 144); bits = 9; }
+            else if (v < 280) { code = v - 256; bits = 7; }
+            else { code = 0xC0 + (v - 280); bits = 8; }
+            literalCode[v] = static_cast<uint16_t>(ReverseBits(code, bits));
+            literalBits[v] = static_cast<uint8_t>(bits);
+        }
+        for (uint32_t d = 0; d < 30; ++d) {
+            distanceCode[d] = static_cast<uint8_t>(ReverseBits(d, 5));
+        }
+        for (uint32_t s = 0; s < 29; ++s) {
+            const uint32_t end = s + 1 < 29 ? kLengthBase[s + 1] : kMaxMatch + 1;
+            for (uint32_t len = kLengthBase[s]; len < end && len <= kMaxMatch; ++len) {
+                lengthSymbol[len] = static_cast<uint8_t>(s);
+            }
+        }
+        lengthSymbol[kMaxMatch] = 28;
+        for (uint32_t s = 0; s < 30; ++s) {
+            const uint32_t end = s + 1 < 30 ? kDistanceBase[s + 1] : kWindowSize + 1;
+            for (uint32_t d = kDistanceBase[s]; d < end; ++d) {
+                if (d - 1 < 256) {
+                    distanceSymbolLow[d - 1] = static_cast<uint8_t>(s);
+                } else {
+                    distanceSymbolHigh[(d - 1) >> 7] = static_cast<uint8_t>(s);
+                }
+            }
+        }
+        for (uint32_t i = 0; i < 256; ++i) {
+            uint32_t c = i;
+            for (int k = 0; k < 8; ++k) {
+                c = (c & 1u) ? (0xEDB88320u ^ (c >> 1)) : (c >> 1);
+            }
+            crc[0][i] = c;
+        }
+        for (uint32_t i = 0; i < 256; ++i) {
+            for (int t = 1; t < 8; ++t) {
+                crc[t][i] = (crc[t - 1][i] >> 8) ^ crc[0][crc[t - 1][i] & 0xFFu];
+            }
+        }
+    }
+};
+
+const DeflateTables& GetDeflateTables() {
+    static const DeflateTables tables;
+    return tables;
+}
+
+// Per-thread buffers, so encoder threads never share or reallocate them per frame
+struct EncodeScratch {
+    std::vector<uint8_t> filtered;
+    std::vector<uint8_t> rows[2];
+    std::vector<uint8_t> candidates[3];
+    std::vector<int32_t> hashTable;
+};
+
+EncodeScratch& GetScratch() {
+    thread_local EncodeScratch scratch;
+    return scratch;
+}
+
+uint32_t Load32(const uint8_t* p) {
+    uint32_t value = 0;
+    std::memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+void StoreBE32(uint8_t* p, uint32_t value) {
+    p[0] = static_cast<uint8_t>(value >> 24);
+    p[1] = static_cast<uint8_t>(value >> 16);
+    p[2] = static_cast<uint8_t>(value >> 8);
+    p[3] = static_cast<uint8_t>(value);
+}
+
+void AppendBE32(std::vector<uint8_t>& out, uint32_t value) {
+    const size_t at = out.size();
+    out.resize(at + 4);
+    StoreBE32(out.data() + at, value);
+}
+
+uint32_t Crc32(const uint8_t* data, size_t size) {
+    const DeflateTables& tables = GetDeflateTables();
+    uint32_t crc = 0xFFFFFFFFu;
+    while (size >= 8) {
+        const uint32_t lo = Load32(data) ^ crc;
+        const uint32_t hi = Load32(data + 4);
+        crc = tables.crc[7][lo & 0xFFu] ^ tables.crc[6][(lo >> 8) & 0xFFu] ^
+              tables.crc[5][(lo >> 16) & 0xFFu] ^ tables.crc[4][lo >> 24] ^
+              tables.crc[3][hi & 0xFFu] ^ tables.crc[2][(hi >> 8) & 0xFFu] ^
+              tables.crc[1][(hi >> 16) & 0xFFu] ^ tables.crc[0][hi >> 24];
+        data += 8;
+        size -= 8;
+    }
+    while (size-- > 0) {
+        crc = tables.crc[0][(crc ^ *data++) & 0xFFu] ^ (crc >> 8);
+    }
+    return crc ^ 0xFFFFFFFFu;
+}
+
+uint32_t Adler32(const uint8_t* data, size_t size) {
+    uint32_t a = 1;
+    uint32_t b = 0;
+    while (size > 0) {
+        const size_t block = std::min<size_t>(size, 5552);
+        for (size_t i = 0; i < block; ++i) {
+            a += data[i];
+            b += a;
+        }
+        a %= 65521u;
+        b %= 65521u;
+        data += block;
+        size -= block;
+    }
+    return (b << 16) | a;
+}
+
+// LSB-first bit stream into a buffer sized for the worst case up front.
+struct BitWriter {
+    uint8_t* out = nullptr;
+    uint64_t bits = 0;
+    uint32_t count = 0;
+
+    void Put(uint32_t value, uint32_t n) {
+        bits |= static_cast<uint64_t>(value) << count;
+        count += n;
+        if (count >= 32) {
+            std::memcpy(out, &bits, 4);
+            out += 4;
+            bits >>= 32;
+            count -= 32;
+        }
+    }
+
+    void Flush() {
+        while (count > 0) {
+            *out++ = static_cast<uint8_t>(bits);
+            bits >>= 8;
+            count = count > 8 ? count - 8 : 0;
+        }
+    }
+};
+
+// One final fixed-Huffman block with greedy one-probe LZ77 matching. Returns bytes written.
+size_t DeflateFixed(const uint8_t* data, size_t size, uint8_t* out, std::vector<int32_t>& hashTable) {
+    const DeflateTables& tables = GetDeflateTables();
+    hashTable.assign(size_t(1) << kHashBits, -1);
+
+    BitWriter writer;
+    writer.out = out;
+    writer.Put(1, 1); // BFINAL
+    writer.Put(1, 2); // BTYPE = fixed Huffman
+
+    size_t i = 0;
+    while (i + kMinMatch <= size) {
+        const uint32_t value = Load32(data + i);
+        const uint32_t hash = (value * 2654435761u) >> (32 - kHashBits);
+        const int32_t candidate = hashTable[hash];
+        hashTable[hash] = static_cast<int32_t>(i);
+
+        if (candidate >= 0 && i - static_cast<size_t>(candidate) <= kWindowSize && Load32(data + candidate) == value) {
+            const size_t maxLength = std::min<size_t>(kMaxMatch, size - i);
+            size_t length = kMinMatch;
+            while (length < maxLength && data[candidate + length] == data[i + length]) {
+                ++length;
+            }
+            const uint32_t distance = static_cast<uint32_t>(i - static_cast<size_t>(candidate));
+
+            const uint32_t lengthSymbol = tables.lengthSymbol[length];
+            writer.Put(tables.literalCode[257 + lengthSymbol], tables.literalBits[257 + lengthSymbol]);
+            if (kLengthExtra[lengthSymbol] > 0) {
+                writer.Put(static_cast<uint32_t>(length) - kLengthBase[lengthSymbol], kLengthExtra[lengthSymbol]);
+            }
+            const uint32_t distanceSymbol = distance - 1 < 256
+                ? tables.distanceSymbolLow[distance - 1]
+                : tables.distanceSymbolHigh[(distance - 1) >> 7];
+            writer.Put(tables.distanceCode[distanceSymbol], 5);
+            if (kDistanceExtra[distanceSymbol] > 0) {
+                writer.Put(distance - kDistanceBase[distanceSymbol], kDistanceExtra[distanceSymbol]);
+            }
+            i += length;
+        } else {
+            writer.Put(tables.literalCode[data[i]], tables.literalBits[data[i]]);
+            ++i;
+        }
+    }
+    for (; i < size; ++i) {
+        writer.Put(tables.literalCode[data[i]], tables.literalBits[data[i]]);
+    }
+    writer.Put(tables.literalCode[256], tables.literalBits[256]);
+    writer.Flush();
+    return static_cast<size_t>(writer.out - out);
+}
+
+void BgraRowToRgb(const uint8_t* bgra, uint32_t width, uint8_t* rgb) {
+    for (uint32_t x = 0; x < width; ++x) {
+        rgb[0] = bgra[2];
+        rgb[1] = bgra[1];
+        rgb[2] = bgra[0];
+        bgra += 4;
+        rgb += 3;
+    }
+}
+
+uint8_t Paeth(int a, int b, int c) {
+    const int p = a + b - c;
+    const int pa = std::abs(p - a);
+    const int pb = std::abs(p - b);
+    const int pc = std::abs(p - c);
+    if (pa <= pb && pa <= pc) return static_cast<uint8_t>(a);
+    if (pb <= pc) return static_cast<uint8_t>(b);
+    return static_cast<uint8_t>(c);
+}
+
+uint32_t SumAbs(const uint8_t* row, size_t size) {
+    uint32_t sum = 0;
+    for (size_t i = 0; i < size; ++i) {
+        sum += row[i] < 128 ? row[i] : 256u - row[i];
+    }
+    return sum;
+}
+
+// Filtered scanlines for IDAT. Each row takes the smallest of Sub, Up and Paeth by the usual
+// sum-of-absolute-differences heuristic; the first row is always Sub.
+void FilterRows(const uint8_t* bgra, uint32_t width, uint32_t height, size_t rowPitch, EncodeScratch& scratch) {
+    const size_t rowBytes = static_cast<size_t>(width) * 3u;
+    scratch.filtered.resize((rowBytes + 1) * height);
+    scratch.rows[0].assign(rowBytes, 0);
+    scratch.rows[1].resize(rowBytes);
+    for (auto& candidate : scratch.candidates) {
+        candidate.resize(rowBytes);
+    }
+
+    for (uint32_t y = 0; y < height; ++y) {
+        const uint8_t* prev = scratch.rows[y & 1u].data();
+        uint8_t* cur = scratch.rows[(y + 1) & 1u].data();
+        BgraRowToRgb(bgra + rowPitch * y, width, cur);
+
+        uint8_t* sub = scratch.candidates[0].data();
+        uint8_t* up = scratch.candidates[1].data();
+        uint8_t* paeth = scratch.candidates[2].data();
+        for (size_t i = 0; i < rowBytes; ++i) {
+            const uint8_t left = i >= 3 ? cur[i - 3] : 0;
+            const uint8_t above = prev[i];
+            const uint8_t aboveLeft = i >= 3 ? prev[i - 3] : 0;
+            sub[i] = static_cast<uint8_t>(cur[i] - left);
+            up[i] = static_cast<uint8_t>(cur[i] - above);
+            paeth[i] = static_cast<uint8_t>(cur[i] - Paeth(left, above, aboveLeft));
+        }
+
+        uint32_t filterType = 1;
+        const uint8_t* chosen = sub;
+        if (y > 0) {
+            const uint32_t sums[3] = { SumAbs(sub, rowBytes), SumAbs(up, rowBytes), SumAbs(paeth, rowBytes) };
+            if (sums[1] < sums[0] && sums[1] <= sums[2]) {
+                filterType = 2;
+                chosen = up;
+            } else if (sums[2] < sums[0]) {
+                filterType = 4;
+                chosen = paeth;
+            }
+        }
+
+        uint8_t* dst = scratch.filtered.data() + (rowBytes + 1) * y;
+        dst[0] = static_cast<uint8_t>(filterType);
+        std::memcpy(dst + 1, chosen, rowBytes);
+    }
+}
+
+void AppendChunk(std::vector<uint8_t>& out, const char type[4], const uint8_t* data, uint32_t size) {
+    AppendBE32(out, size);
+    const size_t typeAt = out.size();
+    out.insert(out.end(), type, type + 4);
+    if (size > 0) {
+        out.insert(out.end(), data, data + size);
+    }
+    AppendBE32(out, Crc32(out.data() + typeAt, size + 4u));
+}
+
+} // namespace
+
+bool ImageEncoder::EncodePng(const uint8_t* bgra, uint32_t width, uint32_t height, size_t rowPitch, std::vector<uint8_t>& outBytes) {
+    outBytes.clear();
+    if (!bgra || width == 0 || height == 0 || rowPitch < static_cast<size_t>(width) * 4u) return false;
+
+    EncodeScratch& scratch = GetScratch();
+    FilterRows(bgra, width, height, rowPitch, scratch);
+    const size_t filteredSize = scratch.filtered.size();
+
+    // Fixed Huffman spends at most 9 bits per literal
+    const size_t deflateBound = filteredSize + filteredSize / 8 + 64;
+    if (deflateBound > 0x7FFFFFF0u) return false;
+    outBytes.reserve(64 + deflateBound);
+
+    outBytes.insert(outBytes.end(), kPngSignature, kPngSignature + sizeof(kPngSignature));
+    uint8_t header[13] = {};
+    StoreBE32(header, width);
+    StoreBE32(header + 4, height);
+    header[8] = 8;  // bit depth
+    header[9] = 2;  // colour type: RGB
+    AppendChunk(outBytes, "IHDR", header, sizeof(header));
+
+    // IDAT is written in place: length patched after deflate, CRC over type + data
+    const size_t idatAt = outBytes.size();
+    outBytes.resize(idatAt + 8 + 2 + deflateBound + 4);
+    std::memcpy(outBytes.data() + idatAt + 4, "IDAT", 4);
+    uint8_t* zlib = outBytes.data() + idatAt + 8;
+    zlib[0] = 0x78; // deflate, 32K window
+    zlib[1] = 0x01; // fastest, no dictionary; (0x78 << 8 | 0x01) % 31 == 0
+    const size_t deflated = DeflateFixed(scratch.filtered.data(), filteredSize, zlib + 2, scratch.hashTable);
+    StoreBE32(zlib + 2 + deflated, Adler32(scratch.filtered.data(), filteredSize));
+    const uint32_t idatSize = static_cast<uint32_t>(2 + deflated + 4);
+    StoreBE32(outBytes.data() + idatAt, idatSize);
+    outBytes.resize(idatAt + 8 + idatSize);
+    AppendBE32(outBytes, Crc32(outBytes.data() + idatAt + 4, idatSize + 4u));
+
+    AppendChunk(outBytes, "IEND", nullptr, 0);
+    return true;
+}
+
+bool ImageEncoder::EncodeQoi(const uint8_t* bgra, uint32_t width, uint32_t height, size_t rowPitch, std::vector<uint8_t>& outBytes) {
+    outBytes.clear();
+    if (!bgra || width == 0 || height == 0 || rowPitch < static_cast<size_t>(width) * 4u) return false;
+
+    constexpr uint8_t kOpIndex = 0x00;
+    constexpr uint8_t kOpDiff = 0x40;
+    constexpr uint8_t kOpLuma = 0x80;
+    constexpr uint8_t kOpRun = 0xC0;
+    constexpr uint8_t kOpRgb = 0xFE;
+    constexpr uint8_t kEndMarker[8] = { 0, 0, 0, 0, 0, 0, 0, 1 };
+
+    const size_t pixelCount = static_cast<size_t>(width) * height;
+    outBytes.resize(14 + pixelCount * 4 + sizeof(kEndMarker));
+    uint8_t* out = outBytes.data();
+    std::memcpy(out, "qoif", 4);
+    StoreBE32(out + 4, width);
+    StoreBE32(out + 8, height);
+    out[12] = 3; // channels: RGB
+    out[13] = 0; // sRGB with linear alpha
+    out += 14;
+
+    // Frames are opaque, so alpha stays 255 and only RGB enters the ops and the hash
+    std::array<uint32_t, 64> index = {};
+    uint8_t pr = 0, pg = 0, pb = 0;
+    uint32_t run = 0;
+    for (uint32_t y = 0; y < height; ++y) {
+        const uint8_t* src = bgra + rowPitch * y;
+        for (uint32_t x = 0; x < width; ++x, src += 4) {
+            const uint8_t r = src[2];
+            const uint8_t g = src[1];
+            const uint8_t b = src[0];
+            const bool last = (y + 1 == height) && (x + 1 == width);
+
+            if (r == pr && g == pg && b == pb) {
+                ++run;
+                if (run == 62 || last) {
+                    *out++ = static_cast<uint8_t>(kOpRun | (run - 1));
+                    run = 0;
+                }
+                continue;
+            }
+            if (run > 0) {
+                *out++ = static_cast<uint8_t>(kOpRun | (run - 1));
+                run = 0;
+            }
+
+            const uint32_t packed = (static_cast<uint32_t>(r) << 24) | (static_cast<uint32_t>(g) << 16) | (static_cast<uint32_t>(b) << 8) | 0xFFu;
+            const uint32_t slot = (r * 3u + g * 5u + b * 7u + 255u * 11u) % 64u;
+            if (index[slot] == packed) {
+                *out++ = static_cast<uint8_t>(kOpIndex | slot);
+            } else {
+                index[slot] = packed;
+                const int vr = static_cast<int8_t>(r - pr);
+                const int vg = static_cast<int8_t>(g - pg);
+                const int vb = static_cast<int8_t>(b - pb);
+                const int vgr = vr - vg;
+                const int vgb = vb - vg;
+                if (vr > -3 && vr < 2 && vg > -3 && vg < 2 && vb > -3 && vb < 2) {
+                    *out++ = static_cast<uint8_t>(kOpDiff | ((vr + 2) << 4) | ((vg + 2) << 2) | (vb + 2));
+                } else if (vgr > -9 && vgr < 8 && vg > -33 && vg < 32 && vgb > -9 && vgb < 8) {
+                    *out++ = static_cast<uint8_t>(kOpLuma | (vg + 32));
+                    *out++ = static_cast<uint8_t>(((vgr + 8) << 4) | (vgb + 8));
+                } else {
+                    *out++ = kOpRgb;
+                    *out++ = r;
+                    *out++ = g;
+                    *out++ = b;
+                }
+            }
+            pr = r;
+            pg = g;
+            pb = b;
+        }
+    }
+
+    std::memcpy(out, kEndMarker, sizeof(kEndMarker));
+    out += sizeof(kEndMarker);
+    outBytes.resize(static_cast<size_t>(out - outBytes.data()));
+    return true;
+}
+
+bool ImageEncoder::Encode(RS3ImageFormat format, const uint8_t* bgra, uint32_t width, uint32_t height, size_t rowPitch, std::vector<uint8_t>& outBytes) {
+    return format == RS3ImageFormat::Qoi
+        ? EncodeQoi(bgra, width, height, rowPitch, outBytes)
+        : EncodePng(bgra, width, height, rowPitch, outBytes);
+}
+
+} // namespace RealSpace3
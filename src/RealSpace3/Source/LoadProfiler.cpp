@@ -0,0 +1,205 @@
+#include "../Include/LoadProfiler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+
+namespace RealSpace3 {
+namespace {
+
+void SetError(std::string* outError, const std::string& message) {
+    if (outError) *outError = message;
+}
+
+const std::chrono::steady_clock::time_point& GetEpoch() {
+    static const std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+    return epoch;
+}
+
+void AppendJsonString(std::string& out, const std::string& value) {
+    out.push_back('"');
+    for (const char ch : value) {
+        const unsigned char c = static_cast<unsigned char>(ch);
+        switch (c) {
+            case '"': out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            case '\t': out += "\\t"; break;
+            default:
+                if (c < 0x20) {
+                    char escaped[8];
+                    std::snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+                    out += escaped;
+                } else {
+                    out.push_back(ch);
+                }
+                break;
+        }
+    }
+    out.push_back('"');
+}
+
+// Trace timestamps are microseconds; three decimals keep the nanosecond resolution.
+void AppendMicroseconds(std::string& out, uint64_t nanoseconds) {
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%llu.%03u",
+        static_cast<unsigned long long>(nanoseconds / 1000), static_cast<unsigned>(nanoseconds % 1000));
+    out += buffer;
+}
+
+} // namespace
+
+const char* GetLoadStageName(LoadStage stage) {
+    switch (stage) {
+        case LoadStage::Resolve: return "resolve";
+        case LoadStage::Read: return "read";
+        case LoadStage::Decode: return "decode";
+        case LoadStage::Validate: return "validate";
+        case LoadStage::Build: return "build";
+        case LoadStage::Upload: return "upload";
+        case LoadStage::Package: return "package";
+        default: return "unknown";
+    }
+}
+
+uint64_t LoadProfiler::NowNanoseconds() {
+    const auto& epoch = GetEpoch();
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - epoch).count());
+}
+
+uint32_t LoadProfiler::GetThreadId() {
+    static std::atomic<uint32_t> nextId{ 1 };
+    thread_local const uint32_t id = nextId.fetch_add(1, std::memory_order_relaxed);
+    return id;
+}
+
+void LoadProfiler::SetThreadName(const std::string& name) {
+    const uint32_t threadId = GetThreadId();
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (auto& entry : m_threadNames) {
+        if (entry.first == threadId) {
+            entry.second = name;
+            return;
+        }
+    }
+    m_threadNames.emplace_back(threadId, name);
+}
+
+void LoadProfiler::Record(LoadStage stage, const std::string& name, uint64_t startNs, uint64_t endNs, uint64_t bytes) {
+    if (stage >= LoadStage::Count) return;
+
+    Event event;
+    event.stage = stage;
+    event.threadId = GetThreadId();
+    event.startNs = startNs;
+    event.durationNs = (endNs > startNs) ? (endNs - startNs) : 0;
+    event.bytes = bytes;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    // Package spans enclose the other stages; counting them would double the totals
+    if (stage != LoadStage::Package) {
+        LoadStageTotals& totals = m_totals[static_cast<size_t>(stage)];
+        ++totals.count;
+        totals.nanoseconds += event.durationNs;
+        totals.bytes += bytes;
+    }
+    if (m_events.size() >= kMaxEvents) {
+        ++m_droppedEvents;
+        return;
+    }
+    event.name = name;
+    m_events.push_back(std::move(event));
+}
+
+void LoadProfiler::Clear() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_events.clear();
+    m_totals = {};
+    m_droppedEvents = 0;
+}
+
+LoadStageTotals LoadProfiler::GetTotals(LoadStage stage) const {
+    if (stage >= LoadStage::Count) return LoadStageTotals{};
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_totals[static_cast<size_t>(stage)];
+}
+
+size_t LoadProfiler::GetEventCount() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_events.size();
+}
+
+bool LoadProfiler::ExportChromeTrace(const std::string& filePath, std::string* outError) const {
+    std::string json;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        json.reserve(256 + m_events.size() * 160);
+        json += "{\"displayTimeUnit\":\"ns\",\"otherData\":{\"droppedEvents\":";
+        json += std::to_string(m_droppedEvents);
+        json += "},\"traceEvents\":[\n";
+
+        bool first = true;
+        const auto separator = [&]() {
+            if (!first) json += ",\n";
+            first = false;
+        };
+
+        json += "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"RS3 asset loads\"}}";
+        first = false;
+        for (const auto& thread : m_threadNames) {
+            separator();
+            json += "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":";
+            json += std::to_string(thread.first);
+            json += ",\"args\":{\"name\":";
+            AppendJsonString(json, thread.second);
+            json += "}}";
+        }
+
+        // Viewers nest "X" events by start time; emit in that order so spans stack correctly
+        std::vector<const Event*> ordered;
+        ordered.reserve(m_events.size());
+        for (const Event& event : m_events) ordered.push_back(&event);
+        std::stable_sort(ordered.begin(), ordered.end(), [](const Event* a, const Event* b) {
+            if (a->startNs != b->startNs) return a->startNs < b->startNs;
+            return a->durationNs > b->durationNs;
+        });
+
+        for (const Event* event : ordered) {
+            separator();
+            json += "{\"name\":";
+            AppendJsonString(json, event->name);
+            json += ",\"cat\":\"";
+            json += GetLoadStageName(event->stage);
+            json += "\",\"ph\":\"X\",\"pid\":1,\"tid\":";
+            json += std::to_string(event->threadId);
+            json += ",\"ts\":";
+            AppendMicroseconds(json, event->startNs);
+            json += ",\"dur\":";
+            AppendMicroseconds(json, event->durationNs);
+            json += ",\"args\":{\"bytes\":";
+            json += std::to_string(event->bytes);
+            json += ",\"ns\":";
+            json += std::to_string(event->durationNs);
+            json += "}}";
+        }
+        json += "\n]}\n";
+    }
+
+    std::ofstream out(std::filesystem::path(filePath), std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) {
+        SetError(outError, "Failed to open trace file: " + filePath);
+        return false;
+    }
+    out.write(json.data(), static_cast<std::streamsize>(json.size()));
+    if (!out.good()) {
+        SetError(outError, "Failed to write trace file: " + filePath);
+        return false;
+    }
+    return true;
+}
+
+} // namespace RealSpace3
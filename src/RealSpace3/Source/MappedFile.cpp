@@ -0,0 +1,95 @@
+#include "../Include/MappedFile.h"
+
+#include <filesystem>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace RealSpace3 {
+namespace {
+
+void SetError(std::string* outError, const std::string& message) {
+    if (outError) *outError = message;
+}
+
+} // namespace
+
+MappedFile::~MappedFile() {
+    Close();
+}
+
+bool MappedFile::Open(const std::string& path, std::string* outError) {
+    Close();
+
+#ifdef _WIN32
+    HANDLE file = CreateFileW(std::filesystem::path(path).c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL | FILE_FLAG_RANDOM_ACCESS, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        SetError(outError, "Failed to open file: " + path);
+        return false;
+    }
+    m_file = file;
+    LARGE_INTEGER fileSize = {};
+    if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart <= 0) {
+        SetError(outError, "File is empty or unreadable: " + path);
+        Close();
+        return false;
+    }
+    m_size = static_cast<size_t>(fileSize.QuadPart);
+    m_mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!m_mapping) {
+        SetError(outError, "CreateFileMapping failed for: " + path);
+        Close();
+        return false;
+    }
+    m_view = MapViewOfFile(static_cast<HANDLE>(m_mapping), FILE_MAP_READ, 0, 0, 0);
+#else
+    m_fd = ::open(path.c_str(), O_RDONLY);
+    if (m_fd < 0) {
+        SetError(outError, "Failed to open file: " + path);
+        return false;
+    }
+    struct stat st = {};
+    if (::fstat(m_fd, &st) != 0 || st.st_size <= 0) {
+        SetError(outError, "File is empty or unreadable: " + path);
+        Close();
+        return false;
+    }
+    m_size = static_cast<size_t>(st.st_size);
+    m_view = ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, m_fd, 0);
+    if (m_view == MAP_FAILED) m_view = nullptr;
+#endif
+    if (!m_view) {
+        SetError(outError, "Failed to map file: " + path);
+        Close();
+        return false;
+    }
+    return true;
+}
+
+void MappedFile::Close() {
+#ifdef _WIN32
+    if (m_view) UnmapViewOfFile(m_view);
+    if (m_mapping) CloseHandle(static_cast<HANDLE>(m_mapping));
+    if (m_file) CloseHandle(static_cast<HANDLE>(m_file));
+    m_file = nullptr;
+    m_mapping = nullptr;
+#else
+    if (m_view) ::munmap(m_view, m_size);
+    if (m_fd >= 0) ::close(m_fd);
+    m_fd = -1;
+#endif
+    m_view = nullptr;
+    m_size = 0;
+}
+
+} // namespace RealSpace3
@@ -0,0 +1,149 @@
+#include "../Include/MipGenerator.h"
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define RS3_MIP_SSE2 1
+#include <emmintrin.h>
+#else
+#define RS3_MIP_SSE2 0
+#endif
+
+namespace RealSpace3 {
+namespace {
+
+void SetError(std::string* outError, const std::string& message) {
+    if (outError) *outError = message;
+}
+
+constexpr uint32_t kLinearToSrgbSteps = 4096;
+
+struct ColorTables {
+    float srgbToLinear[256];
+    float unormToFloat[256];
+    uint8_t linearToSrgb[kLinearToSrgbSteps + 1];
+
+    ColorTables() {
+        for (uint32_t i = 0; i < 256; ++i) {
+            const float c = static_cast<float>(i) / 255.0f;
+            srgbToLinear[i] = c <= 0.04045f ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+            unormToFloat[i] = c;
+        }
+        for (uint32_t i = 0; i <= kLinearToSrgbSteps; ++i) {
+            const float v = static_cast<float>(i) / kLinearToSrgbSteps;
+            const float c = v <= 0.0031308f ? v * 12.92f : 1.055f * std::pow(v, 1.0f / 2.4f) - 0.055f;
+            linearToSrgb[i] = static_cast<uint8_t>(std::lround(std::min(1.0f, std::max(0.0f, c)) * 255.0f));
+        }
+    }
+};
+
+const ColorTables& GetColorTables() {
+    static const ColorTables tables;
+    return tables;
+}
+
+uint8_t EncodeChannel(float value, bool srgb, const ColorTables& tables) {
+    value = std::min(1.0f, std::max(0.0f, value));
+    if (srgb) return tables.linearToSrgb[static_cast<uint32_t>(value * kLinearToSrgbSteps + 0.5f)];
+    return static_cast<uint8_t>(value * 255.0f + 0.5f);
+}
+
+} // namespace
+
+uint32_t MipGenerator::CountMipLevels(uint32_t width, uint32_t height) {
+    uint32_t levels = 1;
+    while (width > 1 || height > 1) {
+        width = std::max(1u, width >> 1);
+        height = std::max(1u, height >> 1);
+        ++levels;
+    }
+    return levels;
+}
+
+void MipGenerator::Downsample(const uint8_t* src, uint32_t width, uint32_t height, size_t rowPitch,
+                              bool srgb, bool alphaWeighted, uint8_t* dst) {
+    const ColorTables& tables = GetColorTables();
+    const float* decode = srgb ? tables.srgbToLinear : tables.unormToFloat;
+    const uint32_t dstWidth = std::max(1u, width >> 1);
+    const uint32_t dstHeight = std::max(1u, height >> 1);
+
+    for (uint32_t y = 0; y < dstHeight; ++y) {
+        const uint8_t* row0 = src + static_cast<size_t>(std::min(2 * y, height - 1)) * rowPitch;
+        const uint8_t* row1 = src + static_cast<size_t>(std::min(2 * y + 1, height - 1)) * rowPitch;
+        uint8_t* out = dst + static_cast<size_t>(y) * dstWidth * 4;
+
+        for (uint32_t x = 0; x < dstWidth; ++x) {
+            const uint32_t x0 = std::min(2 * x, width - 1) * 4;
+            const uint32_t x1 = std::min(2 * x + 1, width - 1) * 4;
+            const uint8_t* texels[4] = { row0 + x0, row0 + x1, row1 + x0, row1 + x1 };
+
+            float color[4];
+#if RS3_MIP_SSE2
+            // Accumulate (rgb * w, a) for the 2x2 footprint in one register; w = alpha or 1.
+            __m128 sum = _mm_setzero_ps();
+            for (const uint8_t* t : texels) {
+                const float a = tables.unormToFloat[t[3]];
+                const float w = alphaWeighted ? a : 1.0f;
+                const __m128 rgba = _mm_setr_ps(decode[t[0]], decode[t[1]], decode[t[2]], a);
+                sum = _mm_add_ps(sum, _mm_mul_ps(rgba, _mm_setr_ps(w, w, w, 1.0f)));
+            }
+            _mm_storeu_ps(color, sum);
+#else
+            color[0] = color[1] = color[2] = color[3] = 0.0f;
+            for (const uint8_t* t : texels) {
+                const float a = tables.unormToFloat[t[3]];
+                const float w = alphaWeighted ? a : 1.0f;
+                color[0] += decode[t[0]] * w;
+                color[1] += decode[t[1]] * w;
+                color[2] += decode[t[2]] * w;
+                color[3] += a;
+            }
+#endif
+            const float weightSum = alphaWeighted ? color[3] : 4.0f;
+            const float scale = weightSum > 0.0f ? 1.0f / weightSum : 0.0f;
+            out[x * 4 + 0] = EncodeChannel(color[0] * scale, srgb, tables);
+            out[x * 4 + 1] = EncodeChannel(color[1] * scale, srgb, tables);
+            out[x * 4 + 2] = EncodeChannel(color[2] * scale, srgb, tables);
+            out[x * 4 + 3] = static_cast<uint8_t>(color[3] * 0.25f * 255.0f + 0.5f);
+        }
+    }
+}
+
+bool MipGenerator::Generate(uint32_t width, uint32_t height, const uint8_t* pixels, size_t rowPitch,
+                            bool srgb, bool alphaWeighted, std::vector<MipLevelRGBA8>& outLevels, std::string* outError) {
+    outLevels.clear();
+    if (!pixels || width == 0 || height == 0) {
+        SetError(outError, "Invalid mip generation source.");
+        return false;
+    }
+    if (rowPitch < static_cast<size_t>(width) * 4) {
+        SetError(outError, "Source row pitch is smaller than width * 4.");
+        return false;
+    }
+
+    const uint32_t levelCount = CountMipLevels(width, height);
+    outLevels.reserve(levelCount - 1);
+
+    const uint8_t* src = pixels;
+    size_t srcPitch = rowPitch;
+    uint32_t srcWidth = width;
+    uint32_t srcHeight = height;
+    for (uint32_t level = 1; level < levelCount; ++level) {
+        MipLevelRGBA8 mip;
+        mip.width = std::max(1u, srcWidth >> 1);
+        mip.height = std::max(1u, srcHeight >> 1);
+        mip.pixels.resize(static_cast<size_t>(mip.width) * mip.height * 4);
+        Downsample(src, srcWidth, srcHeight, srcPitch, srgb, alphaWeighted, mip.pixels.data());
+        outLevels.push_back(std::move(mip));
+
+        const MipLevelRGBA8& last = outLevels.back();
+        src = last.pixels.data();
+        srcPitch = static_cast<size_t>(last.width) * 4;
+        srcWidth = last.width;
+        srcHeight = last.height;
+    }
+    return true;
+}
+
+} // namespace RealSpace3
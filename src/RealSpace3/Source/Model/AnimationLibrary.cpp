@@ -0,0 +1,170 @@
+#include "../../Include/Model/AnimationLibrary.h"
+#include "AppLogger.h"
+
+#include <algorithm>
+#include <cctype>
+
+namespace RealSpace3 {
+namespace {
+
+float ComputeClipDuration(const RS3AnimationClip& clip) {
+    float duration = 0.0f;
+    for (const auto& channel : clip.channels) {
+        if (!channel.posKeys.empty()) {
+            duration = std::max(duration, channel.posKeys.back().time);
+        }
+        if (!channel.rotKeys.empty()) {
+            duration = std::max(duration, channel.rotKeys.back().time);
+        }
+    }
+    return duration;
+}
+
+// Clip-set bone index -> skeleton bone index (-1 when the skeleton lacks the bone).
+// Clip sets registered without bone names were authored against the skeleton order itself.
+std::vector<int32_t> BuildBoneRemap(const RS3ClipSet& clipSet, const RS3BoneList& skeleton) {
+    if (clipSet.boneNames.empty()) {
+        std::vector<int32_t> identity(skeleton.size());
+        for (size_t i = 0; i < identity.size(); ++i) identity[i] = static_cast<int32_t>(i);
+        return identity;
+    }
+
+    std::unordered_map<std::string, int32_t> skeletonIndex;
+    skeletonIndex.reserve(skeleton.size());
+    for (size_t i = 0; i < skeleton.size(); ++i) {
+        skeletonIndex.emplace(AnimationLibrary::NormalizeBoneName(skeleton[i].name), static_cast<int32_t>(i));
+    }
+
+    std::vector<int32_t> remap(clipSet.boneNames.size(), -1);
+    for (size_t i = 0; i < remap.size(); ++i) {
+        auto it = skeletonIndex.find(clipSet.boneNames[i]);
+        if (it != skeletonIndex.end()) remap[i] = it->second;
+    }
+    return remap;
+}
+
+} // namespace
+
+int32_t RS3ClipSet::FindClip(const std::string& clipName) const {
+    auto it = clipIndexByName.find(clipName);
+    return (it != clipIndexByName.end()) ? static_cast<int32_t>(it->second) : -1;
+}
+
+const RS3AnimationChannel* RS3ClipBinding::FindChannel(uint32_t clipIndex, size_t boneIndex) const {
+    if (clipIndex >= channelByBone.size()) return nullptr;
+    const std::vector<int32_t>& channels = channelByBone[clipIndex];
+    if (boneIndex >= channels.size() || channels[boneIndex] < 0) return nullptr;
+    return &clipSet->clips[clipIndex].channels[static_cast<size_t>(channels[boneIndex])];
+}
+
+std::string AnimationLibrary::NormalizeBoneName(const std::string& name) {
+    std::string normalized = name;
+    std::transform(normalized.begin(), normalized.end(), normalized.begin(),
+        [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return normalized;
+}
+
+std::shared_ptr<const RS3ClipSet> AnimationLibrary::Find(const std::string& clipSetId) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_clipSets.find(clipSetId);
+    if (it == m_clipSets.end()) return nullptr;
+    std::shared_ptr<const RS3ClipSet> clipSet = it->second.lock();
+    if (!clipSet) m_clipSets.erase(it);
+    return clipSet;
+}
+
+std::shared_ptr<const RS3ClipSet> AnimationLibrary::FindForRig(const std::string& rigId) {
+    if (rigId.empty()) return nullptr;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_clipSetsByRig.find(rigId);
+    if (it == m_clipSetsByRig.end()) return nullptr;
+    std::shared_ptr<const RS3ClipSet> clipSet = it->second.lock();
+    if (!clipSet) m_clipSetsByRig.erase(it);
+    return clipSet;
+}
+
+std::shared_ptr<const RS3ClipSet> AnimationLibrary::Register(std::shared_ptr<RS3ClipSet> clipSet) {
+    if (!clipSet) return nullptr;
+
+    clipSet->durations.resize(clipSet->clips.size());
+    clipSet->clipIndexByName.clear();
+    clipSet->clipIndexByName.reserve(clipSet->clips.size());
+    for (size_t i = 0; i < clipSet->clips.size(); ++i) {
+        clipSet->durations[i] = ComputeClipDuration(clipSet->clips[i]);
+        // First clip wins on duplicate names, as the old linear search did
+        clipSet->clipIndexByName.emplace(clipSet->clips[i].name, static_cast<uint32_t>(i));
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::weak_ptr<const RS3ClipSet>& slot = m_clipSets[clipSet->clipSetId];
+    if (std::shared_ptr<const RS3ClipSet> existing = slot.lock()) return existing;
+
+    std::shared_ptr<const RS3ClipSet> registered = std::move(clipSet);
+    slot = registered;
+    if (!registered->rigId.empty()) m_clipSetsByRig[registered->rigId] = registered;
+    return registered;
+}
+
+std::shared_ptr<const RS3ClipBinding> AnimationLibrary::Bind(const std::shared_ptr<const RS3ClipSet>& clipSet,
+    const std::shared_ptr<const RS3BoneList>& skeleton) {
+    if (!clipSet || !skeleton) return nullptr;
+
+    const BindingKey key(clipSet.get(), skeleton.get());
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_bindings.find(key);
+        if (it != m_bindings.end()) {
+            if (std::shared_ptr<const RS3ClipBinding> binding = it->second.lock()) return binding;
+        }
+    }
+
+    auto binding = std::make_shared<RS3ClipBinding>();
+    binding->clipSet = clipSet;
+    binding->skeleton = skeleton;
+
+    const std::vector<int32_t> remap = BuildBoneRemap(*clipSet, *skeleton);
+    binding->channelByBone.resize(clipSet->clips.size());
+    for (size_t c = 0; c < clipSet->clips.size(); ++c) {
+        const RS3AnimationClip& clip = clipSet->clips[c];
+        std::vector<int32_t>& channels = binding->channelByBone[c];
+        channels.assign(skeleton->size(), -1);
+        for (size_t ch = 0; ch < clip.channels.size(); ++ch) {
+            const int32_t sourceBone = clip.channels[ch].boneIndex;
+            const int32_t targetBone = (sourceBone >= 0 && static_cast<size_t>(sourceBone) < remap.size())
+                ? remap[static_cast<size_t>(sourceBone)] : -1;
+            if (targetBone < 0 || static_cast<size_t>(targetBone) >= channels.size()) {
+                ++binding->unmatchedChannels;
+                continue;
+            }
+            // First channel wins, as the old per-bone search did
+            if (channels[static_cast<size_t>(targetBone)] < 0) channels[static_cast<size_t>(targetBone)] = static_cast<int32_t>(ch);
+        }
+    }
+
+    if (binding->unmatchedChannels > 0) {
+        AppLogger::Log("[RS3] AnimationLibrary: clipSet='" + clipSet->clipSetId + "' has " +
+            std::to_string(binding->unmatchedChannels) + " channel(s) without a matching bone in the bound skeleton.");
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (auto it = m_bindings.begin(); it != m_bindings.end();) {
+        it = it->second.expired() ? m_bindings.erase(it) : std::next(it);
+    }
+    std::weak_ptr<const RS3ClipBinding>& slot = m_bindings[key];
+    if (std::shared_ptr<const RS3ClipBinding> existing = slot.lock()) return existing;
+    std::shared_ptr<const RS3ClipBinding> shared = std::move(binding);
+    slot = shared;
+    return shared;
+}
+
+size_t AnimationLibrary::GetLiveClipSetCount() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    size_t count = 0;
+    for (const auto& entry : m_clipSets) {
+        if (!entry.second.expired()) ++count;
+    }
+    return count;
+}
+
+} // namespace RealSpace3
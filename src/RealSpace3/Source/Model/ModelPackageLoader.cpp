@@ -1,4 +1,7 @@
 #include "../../Include/Model/ModelPackageLoader.h"
+#include "../../Include/Model/AnimationLibrary.h"
+#include "../../Include/AssetFileSystem.h"
+#include "../../Include/LoadProfiler.h"
 #include "AppLogger.h"
 
 #include <algorithm>
@@ -6,9 +9,10 @@
 #include <cmath>
 #include <cstring>
 #include <filesystem>
-#include <fstream>
+#include <mutex>
 #include <regex>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace RealSpace3 {
@@ -18,17 +22,17 @@ namespace fs = std::filesystem;
 
 class BinReader {
 public:
-    explicit BinReader(const std::vector<uint8_t>& data)
-        : m_data(data) {
+    explicit BinReader(const AssetView& view)
+        : m_data(view.data), m_size(view.size) {
     }
 
     size_t Remaining() const {
-        return (m_off <= m_data.size()) ? (m_data.size() - m_off) : 0;
+        return (m_off <= m_size) ? (m_size - m_off) : 0;
     }
 
     bool ReadBytes(void* dst, size_t size) {
         if (Remaining() < size) return false;
-        std::memcpy(dst, m_data.data() + m_off, size);
+        std::memcpy(dst, m_data + m_off, size);
         m_off += size;
         return true;
     }
@@ -58,47 +62,33 @@ public:
         if (len == 0) return true;
 
         outValue.assign(
-            reinterpret_cast<const char*>(m_data.data() + m_off),
-            reinterpret_cast<const char*>(m_data.data() + m_off + len));
+            reinterpret_cast<const char*>(m_data + m_off),
+            reinterpret_cast<const char*>(m_data + m_off + len));
         m_off += len;
         return true;
     }
 
 private:
-    const std::vector<uint8_t>& m_data;
+    const uint8_t* m_data = nullptr;
+    size_t m_size = 0;
     size_t m_off = 0;
 };
 
-bool ReadFileBytes(const fs::path& filePath, std::vector<uint8_t>& outBytes) {
-    std::ifstream in(filePath, std::ios::binary);
-    if (!in.is_open()) return false;
-
-    in.seekg(0, std::ios::end);
-    const std::streamoff size = in.tellg();
-    if (size < 0) return false;
-    in.seekg(0, std::ios::beg);
-
-    outBytes.resize(static_cast<size_t>(size));
-    if (!outBytes.empty()) {
-        in.read(reinterpret_cast<char*>(outBytes.data()), size);
-        if (!in.good() && !in.eof()) return false;
-    }
-
-    return true;
-}
-
-bool ReadTextFile(const fs::path& filePath, std::string& outText) {
-    std::ifstream in(filePath, std::ios::binary);
-    if (!in.is_open()) return false;
-
-    std::string text((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+std::string ViewToText(const AssetView& view) {
+    std::string text(reinterpret_cast<const char*>(view.data), view.size);
     if (!text.empty() && static_cast<unsigned char>(text[0]) == 0xEF && text.size() >= 3) {
         if (static_cast<unsigned char>(text[1]) == 0xBB && static_cast<unsigned char>(text[2]) == 0xBF) {
             text = text.substr(3);
         }
     }
+    return text;
+}
 
-    outText = std::move(text);
+bool ReadTextFile(const std::string& assetPath, std::string& outText) {
+    AssetView view;
+    if (!AssetFileSystem::getInstance().Open(assetPath, view)) return false;
+
+    outText = ViewToText(view);
     return true;
 }
 
@@ -239,31 +229,6 @@ void ConvertGlobalBindToLocal(std::vector<RS3Bone>& bones) {
     }
 }
 
-bool ResolveModelDir(const std::string& modelId, fs::path& outDir) {
-    const fs::path cwd = fs::current_path();
-    const fs::path modelRel = fs::path(modelId);
-
-    const std::vector<fs::path> candidates = {
-        cwd / "system" / "rs3" / "models" / modelRel,
-        cwd / "OpenGunZ-Client" / "system" / "rs3" / "models" / modelRel,
-        cwd / ".." / "OpenGunZ-Client" / "system" / "rs3" / "models" / modelRel,
-        cwd / ".." / ".." / "OpenGunZ-Client" / "system" / "rs3" / "models" / modelRel,
-    };
-
-    for (const auto& c : candidates) {
-        std::error_code ec;
-        if (!fs::exists(c, ec) || !fs::is_directory(c, ec)) continue;
-        const fs::path modelJson = c / "model.json";
-        if (fs::exists(modelJson, ec) && fs::is_regular_file(modelJson, ec)) {
-            outDir = fs::weakly_canonical(c, ec);
-            if (ec) outDir = c;
-            return true;
-        }
-    }
-
-    return false;
-}
-
 bool ExtractJsonString(const std::string& text, const std::string& key, std::string& outValue) {
     const std::regex re("\"" + key + "\"\\s*:\\s*\"([^\"]*)\"");
     std::smatch m;
@@ -276,13 +241,76 @@ bool ExtractJsonString(const std::string& text, const std::string& key, std::str
     return true;
 }
 
-bool LoadMesh(const fs::path& filePath, RS3ModelPackage& outPackage, std::string* outError) {
-    std::vector<uint8_t> bytes;
-    if (!ReadFileBytes(filePath, bytes)) {
+// Weak, so a blob is freed once the last package referencing it goes away
+template <typename T>
+class SharedBlobCache {
+public:
+    std::shared_ptr<const T> Find(const std::string& key) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_blobs.find(key);
+        if (it == m_blobs.end()) return nullptr;
+        std::shared_ptr<const T> blob = it->second.lock();
+        if (!blob) m_blobs.erase(it);
+        return blob;
+    }
+
+    // Returns the blob already cached under key when another loader won the race.
+    std::shared_ptr<const T> Insert(const std::string& key, std::shared_ptr<const T> blob) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        std::weak_ptr<const T>& slot = m_blobs[key];
+        if (std::shared_ptr<const T> existing = slot.lock()) return existing;
+        slot = blob;
+        return blob;
+    }
+
+private:
+    std::mutex m_mutex;
+    std::unordered_map<std::string, std::weak_ptr<const T>> m_blobs;
+};
+
+// The fix-up flags travel with the bones so a cache hit reports what the first load did
+struct CachedSkeleton {
+    RS3BoneList bones;
+    size_t normalizedBones = 0;
+    bool convertedGlobalToLocal = false;
+};
+
+SharedBlobCache<CachedSkeleton>& GetSkeletonCache() {
+    static SharedBlobCache<CachedSkeleton> cache;
+    return cache;
+}
+
+bool IsContentStoreReference(const std::string& name) {
+    return name.compare(0, std::char_traits<char>::length(ModelPackageLoader::kContentStorePrefix), ModelPackageLoader::kContentStorePrefix) == 0;
+}
+
+std::string ResolveContentStorePath(const std::string& name) {
+    return std::string(ModelPackageLoader::kContentStoreDirectory) + "/" + name.substr(std::char_traits<char>::length(ModelPackageLoader::kContentStorePrefix));
+}
+
+// Store blobs are named by their sha256, so the path is the identity; anything else
+// (per-package files from older conversions) is keyed by its bytes.
+std::string MakeBlobKey(const std::string& assetPath, const AssetView& bytes) {
+    const std::string storeDir = std::string(ModelPackageLoader::kContentStoreDirectory) + "/";
+    if (assetPath.compare(0, storeDir.size(), storeDir) == 0) return "store:" + assetPath;
+
+    uint64_t hash = 14695981039346656037ull;
+    for (size_t i = 0; i < bytes.size; ++i) {
+        hash ^= bytes.data[i];
+        hash *= 1099511628211ull;
+    }
+    return "fnv:" + std::to_string(hash) + ":" + std::to_string(bytes.size);
+}
+
+bool LoadMesh(const std::string& assetPath, RS3ModelPackage& outPackage, std::string* outError) {
+    AssetView bytes;
+    if (!AssetFileSystem::getInstance().Open(assetPath, bytes)) {
         SetError(outError, "Failed to read mesh.bin");
         return false;
     }
 
+    LoadScope decodeScope(LoadStage::Decode, assetPath);
+    decodeScope.AddBytes(bytes.size);
     BinReader r(bytes);
 
     std::array<uint8_t, 8> magic{};
@@ -378,13 +406,28 @@ bool LoadMesh(const fs::path& filePath, RS3ModelPackage& outPackage, std::string
     return true;
 }
 
-bool LoadSkeleton(const fs::path& filePath, RS3ModelPackage& outPackage, std::string* outError, size_t* outNormalizedBones = nullptr, bool* outConvertedGlobalToLocal = nullptr) {
-    std::vector<uint8_t> bytes;
-    if (!ReadFileBytes(filePath, bytes)) {
+bool LoadSkeleton(const std::string& assetPath, RS3ModelPackage& outPackage, std::string* outError, size_t* outNormalizedBones = nullptr, bool* outConvertedGlobalToLocal = nullptr) {
+    AssetView bytes;
+    if (!AssetFileSystem::getInstance().Open(assetPath, bytes)) {
         SetError(outError, "Failed to read skeleton.bin");
         return false;
     }
 
+    const auto publish = [&](const std::shared_ptr<const CachedSkeleton>& skeleton) {
+        if (outNormalizedBones) *outNormalizedBones = skeleton->normalizedBones;
+        if (outConvertedGlobalToLocal) *outConvertedGlobalToLocal = skeleton->convertedGlobalToLocal;
+        // Aliases the cache entry, which stays alive while any package holds its bones
+        outPackage.bones = std::shared_ptr<const RS3BoneList>(skeleton, &skeleton->bones);
+    };
+
+    const std::string blobKey = MakeBlobKey(assetPath, bytes);
+    if (auto shared = GetSkeletonCache().Find(blobKey)) {
+        publish(shared);
+        return true;
+    }
+
+    LoadScope decodeScope(LoadStage::Decode, assetPath);
+    decodeScope.AddBytes(bytes.size);
     BinReader r(bytes);
 
     std::array<uint8_t, 8> magic{};
@@ -412,11 +455,12 @@ bool LoadSkeleton(const fs::path& filePath, RS3ModelPackage& outPackage, std::st
         return false;
     }
 
-    outPackage.bones.clear();
-    outPackage.bones.resize(boneCount);
+    auto skeleton = std::make_shared<CachedSkeleton>();
+    RS3BoneList& bones = skeleton->bones;
+    bones.resize(boneCount);
 
     for (uint32_t i = 0; i < boneCount; ++i) {
-        auto& b = outPackage.bones[i];
+        auto& b = bones[i];
 
         if (!r.ReadI32(b.parentBone) || !r.ReadString(b.name)) {
             SetError(outError, "skeleton.bin is truncated (bone header)");
@@ -438,8 +482,10 @@ bool LoadSkeleton(const fs::path& filePath, RS3ModelPackage& outPackage, std::st
         }
     }
 
+    decodeScope.End();
+    LoadScope validateScope(LoadStage::Validate, assetPath);
     size_t normalizedBones = 0;
-    for (auto& bone : outPackage.bones) {
+    for (auto& bone : bones) {
         if (LooksLikeColumnMajorMatrix(bone.bind) || LooksLikeColumnMajorMatrix(bone.invBind)) {
             TransposeMatrixInPlace(bone.bind);
             TransposeMatrixInPlace(bone.invBind);
@@ -447,35 +493,62 @@ bool LoadSkeleton(const fs::path& filePath, RS3ModelPackage& outPackage, std::st
         }
     }
 
-    if (outNormalizedBones) {
-        *outNormalizedBones = normalizedBones;
-    }
+    skeleton->normalizedBones = normalizedBones;
 
-    const float errGlobal = ComputeSkinIdentityError(outPackage.bones, BindHierarchyMode::Global);
-    const float errLocalFirst = ComputeSkinIdentityError(outPackage.bones, BindHierarchyMode::LocalFirst);
-    const float errParentFirst = ComputeSkinIdentityError(outPackage.bones, BindHierarchyMode::ParentFirst);
+    const float errGlobal = ComputeSkinIdentityError(bones, BindHierarchyMode::Global);
+    const float errLocalFirst = ComputeSkinIdentityError(bones, BindHierarchyMode::LocalFirst);
+    const float errParentFirst = ComputeSkinIdentityError(bones, BindHierarchyMode::ParentFirst);
     const float errHier = std::min(errLocalFirst, errParentFirst);
 
-    bool convertedGlobalToLocal = false;
     if (errGlobal < (errHier * 0.25f)) {
-        ConvertGlobalBindToLocal(outPackage.bones);
-        convertedGlobalToLocal = true;
-    }
-
-    if (outConvertedGlobalToLocal) {
-        *outConvertedGlobalToLocal = convertedGlobalToLocal;
+        ConvertGlobalBindToLocal(bones);
+        skeleton->convertedGlobalToLocal = true;
     }
 
+    publish(GetSkeletonCache().Insert(blobKey, std::move(skeleton)));
     return true;
 }
 
-bool LoadAnimation(const fs::path& filePath, RS3ModelPackage& outPackage, std::string* outError) {
-    std::vector<uint8_t> bytes;
-    if (!ReadFileBytes(filePath, bytes)) {
+// Packages converted before clip set ids existed are keyed by the anim bytes plus the
+// bone order they index into.
+std::string MakeClipSetKey(const std::string& blobKey, const RS3BoneList& bones) {
+    uint64_t hash = 14695981039346656037ull;
+    for (const RS3Bone& bone : bones) {
+        for (unsigned char c : bone.name) {
+            hash ^= c;
+            hash *= 1099511628211ull;
+        }
+        hash ^= 0xFF;
+        hash *= 1099511628211ull;
+    }
+    return blobKey + ":bones=" + std::to_string(hash);
+}
+
+bool LoadAnimation(const std::string& assetPath, const std::string& clipSetId, RS3ModelPackage& outPackage, std::string* outError) {
+    // A clip set already loaded for another package or character is never read again
+    if (!clipSetId.empty()) {
+        if (auto shared = AnimationLibrary::getInstance().Find(clipSetId)) {
+            outPackage.clipSet = std::move(shared);
+            return true;
+        }
+    }
+
+    AssetView bytes;
+    if (!AssetFileSystem::getInstance().Open(assetPath, bytes)) {
         SetError(outError, "Failed to read anim.bin");
         return false;
     }
 
+    const std::string key = clipSetId.empty() ? MakeClipSetKey(MakeBlobKey(assetPath, bytes), *outPackage.bones) : clipSetId;
+    if (clipSetId.empty()) {
+        if (auto shared = AnimationLibrary::getInstance().Find(key)) {
+            outPackage.clipSet = std::move(shared);
+            return true;
+        }
+    }
+
+    LoadScope decodeScope(LoadStage::Decode, assetPath);
+    decodeScope.AddBytes(bytes.size);
     BinReader r(bytes);
 
     std::array<uint8_t, 8> magic{};
@@ -503,11 +576,13 @@ bool LoadAnimation(const fs::path& filePath, RS3ModelPackage& outPackage, std::s
         return false;
     }
 
-    outPackage.clips.clear();
-    outPackage.clips.resize(clipCount);
+    auto clipSet = std::make_shared<RS3ClipSet>();
+    clipSet->clipSetId = key;
+    clipSet->rigId = outPackage.rigId;
+    clipSet->clips.resize(clipCount);
 
     for (uint32_t c = 0; c < clipCount; ++c) {
-        auto& clip = outPackage.clips[c];
+        auto& clip = clipSet->clips[c];
 
         uint32_t channelCount = 0;
         if (!r.ReadString(clip.name) || !r.ReadU32(channelCount)) {
@@ -557,16 +632,26 @@ bool LoadAnimation(const fs::path& filePath, RS3ModelPackage& outPackage, std::s
         }
     }
 
+    if (clipCount == 0) return true;
+
+    // Channel bone indices refer to this package's skeleton; other skeletons are remapped by name
+    clipSet->boneNames.reserve(outPackage.bones->size());
+    for (const RS3Bone& bone : *outPackage.bones) {
+        clipSet->boneNames.push_back(AnimationLibrary::NormalizeBoneName(bone.name));
+    }
+    outPackage.clipSet = AnimationLibrary::getInstance().Register(std::move(clipSet));
     return true;
 }
 
-bool LoadMaterials(const fs::path& filePath, RS3ModelPackage& outPackage, std::string* outError) {
-    std::vector<uint8_t> bytes;
-    if (!ReadFileBytes(filePath, bytes)) {
+bool LoadMaterials(const std::string& assetPath, RS3ModelPackage& outPackage, std::string* outError) {
+    AssetView bytes;
+    if (!AssetFileSystem::getInstance().Open(assetPath, bytes)) {
         SetError(outError, "Failed to read materials.bin");
         return false;
     }
 
+    LoadScope decodeScope(LoadStage::Decode, assetPath);
+    decodeScope.AddBytes(bytes.size);
     BinReader r(bytes);
 
     std::array<uint8_t, 8> magic{};
@@ -607,21 +692,26 @@ bool LoadMaterials(const fs::path& filePath, RS3ModelPackage& outPackage, std::s
             SetError(outError, "materials.bin is truncated (materials)");
             return false;
         }
+
+        // Store textures resolve through the asset filesystem from any package; TextureManager
+        // caches by path, so every package using one shares a single GPU texture.
+        for (std::string* texture : { &m.baseColorTexture, &m.normalTexture, &m.ormTexture, &m.emissiveTexture, &m.opacityTexture }) {
+            if (IsContentStoreReference(*texture)) *texture = AssetFileSystem::MakeVirtualPath(ResolveContentStorePath(*texture));
+        }
     }
 
     return true;
 }
 
-bool LoadAttachments(const fs::path& filePath, RS3ModelPackage& outPackage, std::string* outError) {
+bool LoadAttachments(const std::string& assetPath, RS3ModelPackage& outPackage, std::string* outError) {
     outPackage.sockets.clear();
 
-    std::error_code ec;
-    if (!fs::exists(filePath, ec) || !fs::is_regular_file(filePath, ec)) {
+    if (!AssetFileSystem::getInstance().Exists(assetPath)) {
         return true;
     }
 
     std::string text;
-    if (!ReadTextFile(filePath, text)) {
+    if (!ReadTextFile(assetPath, text)) {
         SetError(outError, "Failed to read attachments.json");
         return false;
     }
@@ -645,22 +735,23 @@ bool LoadAttachments(const fs::path& filePath, RS3ModelPackage& outPackage, std:
 bool ModelPackageLoader::LoadModelPackage(const std::string& modelId, RS3ModelPackage& outPackage, std::string* outError) {
     outPackage = RS3ModelPackage{};
     outPackage.modelId = modelId;
+    LoadScope packageScope(LoadStage::Package, "model:" + modelId);
 
-    fs::path modelDir;
-    if (!ResolveModelDir(modelId, modelDir)) {
+    const std::string modelDir = "models/" + modelId;
+    AssetView modelJson;
+    if (!AssetFileSystem::getInstance().Open(modelDir + "/model.json", modelJson)) {
         SetError(outError, "Model package directory not found for modelId='" + modelId + "'.");
         return false;
     }
 
-    outPackage.baseDir = modelDir;
+    // Packed models keep a "vfs:" base directory so their textures resolve through the pack too
+    outPackage.baseDir = modelJson.diskPath.empty() ? fs::path(AssetFileSystem::MakeVirtualPath(modelDir))
+                                                    : fs::path(modelJson.diskPath).parent_path();
 
-    const fs::path modelJsonPath = modelDir / "model.json";
-    std::string modelJsonText;
-    if (ReadTextFile(modelJsonPath, modelJsonText)) {
-        std::string sourceGlb;
-        if (ExtractJsonString(modelJsonText, "sourceGlb", sourceGlb)) {
-            outPackage.sourceGlb = sourceGlb;
-        }
+    const std::string modelJsonText = ViewToText(modelJson);
+    std::string sourceGlb;
+    if (ExtractJsonString(modelJsonText, "sourceGlb", sourceGlb)) {
+        outPackage.sourceGlb = sourceGlb;
     }
 
     std::string meshFile = "mesh.bin";
@@ -668,6 +759,7 @@ bool ModelPackageLoader::LoadModelPackage(const std::string& modelId, RS3ModelPa
     std::string animFile = "anim.bin";
     std::string materialsFile = "materials.bin";
     std::string attachmentsFile = "attachments.json";
+    std::string clipSetId;
 
     if (!modelJsonText.empty()) {
         std::string value;
@@ -676,19 +768,24 @@ bool ModelPackageLoader::LoadModelPackage(const std::string& modelId, RS3ModelPa
         if (ExtractJsonString(modelJsonText, "animation", value)) animFile = value;
         if (ExtractJsonString(modelJsonText, "materials", value)) materialsFile = value;
         if (ExtractJsonString(modelJsonText, "attachments", value)) attachmentsFile = value;
+        if (ExtractJsonString(modelJsonText, "rigId", value)) outPackage.rigId = value;
+        if (ExtractJsonString(modelJsonText, "clipSetId", value)) clipSetId = value;
     }
 
-    const fs::path meshPath = modelDir / fs::path(meshFile);
-    const fs::path skeletonPath = modelDir / fs::path(skeletonFile);
-    const fs::path animPath = modelDir / fs::path(animFile);
-    const fs::path materialsPath = modelDir / fs::path(materialsFile);
-    const fs::path attachmentsPath = modelDir / fs::path(attachmentsFile);
+    const auto packageFile = [&](const std::string& name) {
+        return IsContentStoreReference(name) ? ResolveContentStorePath(name) : modelDir + "/" + name;
+    };
+    const std::string meshPath = packageFile(meshFile);
+    const std::string skeletonPath = packageFile(skeletonFile);
+    const std::string animPath = packageFile(animFile);
+    const std::string materialsPath = packageFile(materialsFile);
+    const std::string attachmentsPath = packageFile(attachmentsFile);
 
     if (!LoadMesh(meshPath, outPackage, outError)) return false;
     size_t normalizedBones = 0;
     bool convertedGlobalToLocal = false;
     if (!LoadSkeleton(skeletonPath, outPackage, outError, &normalizedBones, &convertedGlobalToLocal)) return false;
-    if (!LoadAnimation(animPath, outPackage, outError)) return false;
+    if (!LoadAnimation(animPath, clipSetId, outPackage, outError)) return false;
     if (!LoadMaterials(materialsPath, outPackage, outError)) return false;
     if (!LoadAttachments(attachmentsPath, outPackage, outError)) return false;
 
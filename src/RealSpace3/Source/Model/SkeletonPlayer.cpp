@@ -9,19 +9,6 @@
 namespace RealSpace3 {
 namespace {
 
-float ComputeClipDuration(const RS3AnimationClip& clip) {
-    float duration = 0.0f;
-    for (const auto& channel : clip.channels) {
-        if (!channel.posKeys.empty()) {
-            duration = std::max(duration, channel.posKeys.back().time);
-        }
-        if (!channel.rotKeys.empty()) {
-            duration = std::max(duration, channel.rotKeys.back().time);
-        }
-    }
-    return duration;
-}
-
 float WrapTime(float time, float duration) {
     if (duration <= 0.0f) return 0.0f;
     time = std::fmod(time, duration);
@@ -75,13 +62,6 @@ DirectX::XMFLOAT4 SampleRotation(const std::vector<RS3RotKey>& keys, float time,
     return keys.back().value;
 }
 
-const RS3AnimationChannel* FindChannelForBone(const RS3AnimationClip& clip, int32_t boneIndex) {
-    for (const auto& channel : clip.channels) {
-        if (channel.boneIndex == boneIndex) return &channel;
-    }
-    return nullptr;
-}
-
 bool MatrixIsFiniteAndReasonable(const DirectX::XMFLOAT4X4& m, float* outMaxAbs = nullptr, float* outMaxTranslate = nullptr) {
     const float* v = reinterpret_cast<const float*>(&m);
     float maxAbs = 0.0f;
@@ -130,14 +110,14 @@ DirectX::XMFLOAT4 ExtractRotationFromMatrix(const DirectX::XMFLOAT4X4& m) {
     return out;
 }
 
-float ComputeOrderError(const RS3ModelPackage* package, bool localFirstOrder) {
-    if (!package || package->bones.empty()) return 0.0f;
+float ComputeOrderError(const RS3BoneList& bones, bool localFirstOrder) {
+    if (bones.empty()) return 0.0f;
 
-    std::vector<DirectX::XMMATRIX> global(package->bones.size(), DirectX::XMMatrixIdentity());
+    std::vector<DirectX::XMMATRIX> global(bones.size(), DirectX::XMMatrixIdentity());
     float error = 0.0f;
 
-    for (size_t i = 0; i < package->bones.size(); ++i) {
-        const auto& bone = package->bones[i];
+    for (size_t i = 0; i < bones.size(); ++i) {
+        const auto& bone = bones[i];
         const DirectX::XMMATRIX local = DirectX::XMLoadFloat4x4(&bone.bind);
         if (bone.parentBone >= 0 && static_cast<size_t>(bone.parentBone) < global.size()) {
             const DirectX::XMMATRIX parent = global[static_cast<size_t>(bone.parentBone)];
@@ -163,38 +143,46 @@ float ComputeOrderError(const RS3ModelPackage* package, bool localFirstOrder) {
 } // namespace
 
 void SkeletonPlayer::SetPackage(const RS3ModelPackage* package) {
-    m_package = package;
-    m_clipIndex = -1;
-    m_blendSeconds = 0.0f;
-    m_timeSeconds = 0.0f;
-    m_clipDuration = 0.0f;
+    m_skeleton = package ? package->bones : nullptr;
     m_parentOrderResolved = false;
     m_localFirstOrder = true;
     m_loggedOrderDiagnostics = false;
     m_loggedDecomposeWarning = false;
     m_loggedSkinFallbackWarning = false;
+
+    std::shared_ptr<const RS3ClipSet> clipSet;
+    if (package) {
+        clipSet = package->clipSet ? package->clipSet : AnimationLibrary::getInstance().FindForRig(package->rigId);
+    }
+    SetClipSet(std::move(clipSet));
+}
+
+void SkeletonPlayer::SetClipSet(std::shared_ptr<const RS3ClipSet> clipSet) {
+    m_clipSet = std::move(clipSet);
+    m_binding = AnimationLibrary::getInstance().Bind(m_clipSet, m_skeleton);
+    m_clipIndex = -1;
+    m_blendSeconds = 0.0f;
+    m_timeSeconds = 0.0f;
+    m_clipDuration = 0.0f;
 }
 
 bool SkeletonPlayer::SetAnimationClipByName(const std::string& clipName, float blendSeconds) {
-    if (!m_package) return false;
-
-    for (size_t i = 0; i < m_package->clips.size(); ++i) {
-        if (m_package->clips[i].name == clipName) {
-            m_clipIndex = static_cast<int32_t>(i);
-            m_blendSeconds = blendSeconds;
-            m_timeSeconds = 0.0f;
-            m_clipDuration = ComputeClipDuration(m_package->clips[i]);
-            return true;
-        }
-    }
+    if (!m_binding) return false;
 
-    return false;
+    const int32_t clipIndex = m_clipSet->FindClip(clipName);
+    if (clipIndex < 0) return false;
+
+    m_clipIndex = clipIndex;
+    m_blendSeconds = blendSeconds;
+    m_timeSeconds = 0.0f;
+    m_clipDuration = m_clipSet->durations[static_cast<size_t>(clipIndex)];
+    return true;
 }
 
 const RS3AnimationClip* SkeletonPlayer::GetCurrentClip() const {
-    if (!m_package) return nullptr;
-    if (m_clipIndex < 0 || static_cast<size_t>(m_clipIndex) >= m_package->clips.size()) return nullptr;
-    return &m_package->clips[static_cast<size_t>(m_clipIndex)];
+    if (!m_binding) return nullptr;
+    if (m_clipIndex < 0 || static_cast<size_t>(m_clipIndex) >= m_clipSet->clips.size()) return nullptr;
+    return &m_clipSet->clips[static_cast<size_t>(m_clipIndex)];
 }
 
 float SkeletonPlayer::GetBlendSeconds() const {
@@ -203,12 +191,7 @@ float SkeletonPlayer::GetBlendSeconds() const {
 
 void SkeletonPlayer::Update(float deltaSeconds) {
     if (deltaSeconds <= 0.0f) return;
-    if (!m_package) return;
-    if (m_clipIndex < 0 || static_cast<size_t>(m_clipIndex) >= m_package->clips.size()) return;
-
-    if (m_clipDuration <= 0.0f) {
-        m_clipDuration = ComputeClipDuration(m_package->clips[static_cast<size_t>(m_clipIndex)]);
-    }
+    if (!GetCurrentClip()) return;
 
     m_timeSeconds += deltaSeconds;
     if (m_clipDuration > 0.0f) {
@@ -218,14 +201,14 @@ void SkeletonPlayer::Update(float deltaSeconds) {
 
 bool SkeletonPlayer::BuildSkinMatrices(std::vector<DirectX::XMFLOAT4X4>& outMatrices) const {
     outMatrices.clear();
-    if (!m_package) return false;
+    if (!m_skeleton) return false;
 
-    const auto& bones = m_package->bones;
+    const auto& bones = *m_skeleton;
     if (bones.empty()) return true;
 
     if (!m_parentOrderResolved) {
-        const float localFirstError = ComputeOrderError(m_package, true);
-        const float parentFirstError = ComputeOrderError(m_package, false);
+        const float localFirstError = ComputeOrderError(bones, true);
+        const float parentFirstError = ComputeOrderError(bones, false);
         m_localFirstOrder = localFirstError <= parentFirstError;
         m_parentOrderResolved = true;
 
@@ -239,7 +222,7 @@ bool SkeletonPlayer::BuildSkinMatrices(std::vector<DirectX::XMFLOAT4X4>& outMatr
         }
     }
 
-    const RS3AnimationClip* clip = GetCurrentClip();
+    const bool hasClip = GetCurrentClip() != nullptr;
     const float sampleTime = (m_clipDuration > 0.0f) ? WrapTime(m_timeSeconds, m_clipDuration) : 0.0f;
 
     std::vector<DirectX::XMMATRIX> localMats;
@@ -251,7 +234,7 @@ bool SkeletonPlayer::BuildSkinMatrices(std::vector<DirectX::XMFLOAT4X4>& outMatr
     for (size_t i = 0; i < bones.size(); ++i) {
         const auto& bone = bones[i];
         const DirectX::XMMATRIX bindMatrix = DirectX::XMLoadFloat4x4(&bone.bind);
-        const RS3AnimationChannel* channel = clip ? FindChannelForBone(*clip, static_cast<int32_t>(i)) : nullptr;
+        const RS3AnimationChannel* channel = hasClip ? m_binding->FindChannel(static_cast<uint32_t>(m_clipIndex), i) : nullptr;
         const bool hasAnimatedChannel = channel && (!channel->posKeys.empty() || !channel->rotKeys.empty());
 
         if (!hasAnimatedChannel) {
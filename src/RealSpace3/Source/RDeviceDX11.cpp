@@ -2,6 +2,7 @@
 #include "AppLogger.h"
 #include <d3dcompiler.h>
 #include <algorithm>
+#include <cstring>
 
 #pragma comment(lib, "d3dcompiler.lib")
 
@@ -167,6 +168,43 @@ void RDeviceDX11::Clear(float r, float g, float b, float a) {
     if (m_pDepthStencilView) m_pd3dDeviceContext->ClearDepthStencilView(m_pDepthStencilView.Get(), D3D11_CLEAR_DEPTH | D3D11_CLEAR_STENCIL, 1.0f, 0);
 }
 
+namespace {
+
+// Mapped staging texture -> packed BGRA rows; RGBA back buffers are swizzled.
+void CopyMappedToBGRA(const D3D11_MAPPED_SUBRESOURCE& mapped, const D3D11_TEXTURE2D_DESC& desc, std::vector<uint8_t>& outPixels) {
+    const size_t rowBytes = static_cast<size_t>(desc.Width) * 4u;
+    outPixels.resize(rowBytes * desc.Height);
+
+    const bool isRgba = (desc.Format == DXGI_FORMAT_R8G8B8A8_UNORM || desc.Format == DXGI_FORMAT_R8G8B8A8_UNORM_SRGB);
+    for (uint32_t y = 0; y < desc.Height; ++y) {
+        const uint8_t* srcRow = reinterpret_cast<const uint8_t*>(mapped.pData) + static_cast<size_t>(mapped.RowPitch) * y;
+        uint8_t* dstRow = outPixels.data() + rowBytes * y;
+        if (!isRgba) {
+            std::memcpy(dstRow, srcRow, rowBytes);
+            continue;
+        }
+        for (uint32_t x = 0; x < desc.Width; ++x) {
+            const uint8_t* src = srcRow + static_cast<size_t>(x) * 4u;
+            uint8_t* dst = dstRow + static_cast<size_t>(x) * 4u;
+            dst[0] = src[2];
+            dst[1] = src[1];
+            dst[2] = src[0];
+            dst[3] = src[3];
+        }
+    }
+}
+
+D3D11_TEXTURE2D_DESC MakeStagingDesc(const D3D11_TEXTURE2D_DESC& source) {
+    D3D11_TEXTURE2D_DESC stagingDesc = source;
+    stagingDesc.BindFlags = 0;
+    stagingDesc.CPUAccessFlags = D3D11_CPU_ACCESS_READ;
+    stagingDesc.Usage = D3D11_USAGE_STAGING;
+    stagingDesc.MiscFlags = 0;
+    return stagingDesc;
+}
+
+} // namespace
+
 bool RDeviceDX11::ReadBackBufferBGRA(std::vector<uint8_t>& outPixels, uint32_t& outWidth, uint32_t& outHeight) {
     outPixels.clear();
     outWidth = 0;
@@ -182,12 +220,7 @@ bool RDeviceDX11::ReadBackBufferBGRA(std::vector<uint8_t>& outPixels, uint32_t&
     backBuffer->GetDesc(&desc);
     if (desc.Width == 0 || desc.Height == 0) return false;
 
-    D3D11_TEXTURE2D_DESC stagingDesc = desc;
-    stagingDesc.BindFlags = 0;
-    stagingDesc.CPUAccessFlags = D3D11_CPU_ACCESS_READ;
-    stagingDesc.Usage = D3D11_USAGE_STAGING;
-    stagingDesc.MiscFlags = 0;
-
+    const D3D11_TEXTURE2D_DESC stagingDesc = MakeStagingDesc(desc);
     ComPtr<ID3D11Texture2D> staging;
     if (FAILED(m_pd3dDevice->CreateTexture2D(&stagingDesc, nullptr, &staging)) || !staging) {
         return false;
@@ -203,37 +236,78 @@ bool RDeviceDX11::ReadBackBufferBGRA(std::vector<uint8_t>& outPixels, uint32_t&
 
     outWidth = desc.Width;
     outHeight = desc.Height;
-    outPixels.resize(static_cast<size_t>(outWidth) * static_cast<size_t>(outHeight) * 4u);
+    CopyMappedToBGRA(mapped, desc, outPixels);
 
-    const bool isRgba = (desc.Format == DXGI_FORMAT_R8G8B8A8_UNORM || desc.Format == DXGI_FORMAT_R8G8B8A8_UNORM_SRGB);
-    const bool isBgra = (desc.Format == DXGI_FORMAT_B8G8R8A8_UNORM || desc.Format == DXGI_FORMAT_B8G8R8A8_UNORM_SRGB);
+    m_pd3dDeviceContext->Unmap(staging.Get(), 0);
+    return true;
+}
 
-    for (uint32_t y = 0; y < outHeight; ++y) {
-        const uint8_t* srcRow = reinterpret_cast<const uint8_t*>(mapped.pData) + static_cast<size_t>(mapped.RowPitch) * y;
-        uint8_t* dstRow = outPixels.data() + static_cast<size_t>(outWidth) * 4u * y;
-        for (uint32_t x = 0; x < outWidth; ++x) {
-            const uint8_t* src = srcRow + static_cast<size_t>(x) * 4u;
-            uint8_t* dst = dstRow + static_cast<size_t>(x) * 4u;
-            if (isRgba) {
-                dst[0] = src[2];
-                dst[1] = src[1];
-                dst[2] = src[0];
-                dst[3] = src[3];
-            } else if (isBgra) {
-                dst[0] = src[0];
-                dst[1] = src[1];
-                dst[2] = src[2];
-                dst[3] = src[3];
-            } else {
-                dst[0] = src[0];
-                dst[1] = src[1];
-                dst[2] = src[2];
-                dst[3] = src[3];
-            }
+bool RDeviceDX11::BeginCaptureRing(uint32_t slotCount) {
+    EndCaptureRing();
+    if (!m_pSwapChain || !m_pd3dDevice || slotCount == 0) return false;
+
+    ComPtr<ID3D11Texture2D> backBuffer;
+    if (FAILED(m_pSwapChain->GetBuffer(0, IID_PPV_ARGS(&backBuffer))) || !backBuffer) {
+        return false;
+    }
+    backBuffer->GetDesc(&m_captureDesc);
+    if (m_captureDesc.Width == 0 || m_captureDesc.Height == 0) return false;
+
+    const D3D11_TEXTURE2D_DESC stagingDesc = MakeStagingDesc(m_captureDesc);
+    m_captureRing.resize(slotCount);
+    for (auto& slot : m_captureRing) {
+        if (FAILED(m_pd3dDevice->CreateTexture2D(&stagingDesc, nullptr, &slot)) || !slot) {
+            EndCaptureRing();
+            return false;
         }
     }
+    return true;
+}
 
-    m_pd3dDeviceContext->Unmap(staging.Get(), 0);
+void RDeviceDX11::EndCaptureRing() {
+    m_captureRing.clear();
+    m_captureNext = 0;
+    m_captureQueued = 0;
+}
+
+bool RDeviceDX11::QueueBackBufferCapture() {
+    if (m_captureRing.empty() || m_captureQueued >= m_captureRing.size()) return false;
+
+    ComPtr<ID3D11Texture2D> backBuffer;
+    if (FAILED(m_pSwapChain->GetBuffer(0, IID_PPV_ARGS(&backBuffer))) || !backBuffer) {
+        return false;
+    }
+    D3D11_TEXTURE2D_DESC desc = {};
+    backBuffer->GetDesc(&desc);
+    if (desc.Width != m_captureDesc.Width || desc.Height != m_captureDesc.Height || desc.Format != m_captureDesc.Format) {
+        return false;
+    }
+
+    m_pd3dDeviceContext->CopyResource(m_captureRing[m_captureNext].Get(), backBuffer.Get());
+    m_captureNext = (m_captureNext + 1) % static_cast<uint32_t>(m_captureRing.size());
+    ++m_captureQueued;
+    return true;
+}
+
+bool RDeviceDX11::ReadQueuedCapture(std::vector<uint8_t>& outPixels, uint32_t& outWidth, uint32_t& outHeight) {
+    outWidth = 0;
+    outHeight = 0;
+    if (m_captureQueued == 0) return false;
+
+    const uint32_t slotCount = static_cast<uint32_t>(m_captureRing.size());
+    const uint32_t oldest = (m_captureNext + slotCount - m_captureQueued) % slotCount;
+    ID3D11Texture2D* staging = m_captureRing[oldest].Get();
+
+    D3D11_MAPPED_SUBRESOURCE mapped = {};
+    if (FAILED(m_pd3dDeviceContext->Map(staging, 0, D3D11_MAP_READ, 0, &mapped))) {
+        return false;
+    }
+    CopyMappedToBGRA(mapped, m_captureDesc, outPixels);
+    m_pd3dDeviceContext->Unmap(staging, 0);
+
+    --m_captureQueued;
+    outWidth = m_captureDesc.Width;
+    outHeight = m_captureDesc.Height;
     return true;
 }
 
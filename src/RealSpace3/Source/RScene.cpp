@@ -1,4 +1,5 @@
 #include "../Include/RScene.h"
+#include "../Include/LoadProfiler.h"
 
 #include "AppLogger.h"
 
@@ -11,6 +12,7 @@
 #include <cmath>
 #include <cstring>
 #include <limits>
+#include <map>
 #include <sstream>
 #include <string>
 #include <vector>
@@ -33,6 +35,7 @@ constexpr float kCreationShowroomPitch = 0.17f;
 constexpr float kCreationShowroomDistance = 250.0f;
 constexpr float kCreationShowroomFocusHeight = 92.0f;
 constexpr float kShowcasePlatformTargetDiameter = 125.0f;
+constexpr float kSpawnWalkableTolerance = 80.0f;
 constexpr float kPi = 3.14159265358979323846f;
 constexpr float kTwoPi = 6.28318530717958647692f;
 
@@ -65,20 +68,40 @@ DirectX::XMFLOAT4X4 Identity4x4() {
         0.0f, 0.0f, 0.0f, 1.0f);
 }
 
+// Draw passes of map and skin geometry, drawn in increasing order; the id also reaches the shaders in renderParams.x.
+constexpr int kMapPassHidden = -1;
+constexpr int kMapPassOpaque = 0;
+constexpr int kMapPassAlphaTest = 1;
+constexpr int kMapPassAlphaBlend = 2;
+constexpr int kMapPassAdditive = 3;
+
 int ClassifyPass(uint32_t legacyFlags, uint32_t alphaMode) {
     if ((legacyFlags & RM_FLAG_HIDE) != 0) {
-        return -1;
+        return kMapPassHidden;
     }
     if ((legacyFlags & RM_FLAG_ADDITIVE) != 0) {
-        return 3;
+        return kMapPassAdditive;
     }
     if ((legacyFlags & RM_FLAG_USEOPACITY) != 0 || alphaMode == 2) {
-        return 2;
+        return kMapPassAlphaBlend;
     }
     if ((legacyFlags & RM_FLAG_USEALPHATEST) != 0 || alphaMode == 1) {
-        return 1;
+        return kMapPassAlphaTest;
     }
-    return 0;
+    return kMapPassOpaque;
+}
+
+// Splits "textures/array_0_bc1_256x256.dds#3" into path and array slice; plain paths use slice 0.
+bool SplitTextureReference(const std::string& reference, std::string& outPath, uint32_t& outSlice) {
+    outPath = reference;
+    outSlice = 0;
+    const size_t hash = reference.find_last_of('#');
+    if (hash != std::string::npos && hash + 1 < reference.size() && reference.size() - hash - 1 <= 9 &&
+        std::all_of(reference.begin() + hash + 1, reference.end(), [](unsigned char c) { return std::isdigit(c) != 0; })) {
+        outPath = reference.substr(0, hash);
+        outSlice = static_cast<uint32_t>(std::stoul(reference.substr(hash + 1)));
+    }
+    return !outPath.empty();
 }
 
 std::string ToLowerAscii(std::string value) {
@@ -283,12 +306,14 @@ cbuffer PerFrame : register(b0) {
 };
 
 Texture2D gDiffuse : register(t0);
+Texture2DArray gDiffuseArray : register(t1);
 SamplerState gSampler : register(s0);
 
 struct VSIn {
     float3 pos : POSITION;
     float3 normal : NORMAL;
     float2 uv : TEXCOORD0;
+    float slice : TEXCOORD1;
 };
 
 struct VSOut {
@@ -296,6 +321,7 @@ struct VSOut {
     float3 worldPos : TEXCOORD0;
     float3 normalW : TEXCOORD1;
     float2 uv : TEXCOORD2;
+    nointerpolation float slice : TEXCOORD3;
 };
 
 VSOut VSMain(VSIn input) {
@@ -305,12 +331,11 @@ VSOut VSMain(VSIn input) {
     o.worldPos = input.pos;
     o.normalW = normalize(input.normal);
     o.uv = input.uv;
+    o.slice = input.slice;
     return o;
 }
 
-float4 PSMain(VSOut input) : SV_Target {
-    float4 albedo = gDiffuse.Sample(gSampler, input.uv);
-
+float4 Shade(VSOut input, float4 albedo) {
     int alphaMode = (int)gRenderParams.x;
     float alphaRef = gRenderParams.y;
     if (alphaMode == 1) {
@@ -343,6 +368,14 @@ float4 PSMain(VSOut input) : SV_Target {
 
     return float4(color, albedo.a);
 }
+
+float4 PSMain(VSOut input) : SV_Target {
+    return Shade(input, gDiffuse.Sample(gSampler, input.uv));
+}
+
+float4 PSMainArray(VSOut input) : SV_Target {
+    return Shade(input, gDiffuseArray.Sample(gSampler, float3(input.uv, input.slice)));
+}
 )HLSL";
 
 const char* kSkinShaderSource = R"HLSL(
@@ -481,6 +514,7 @@ RScene::~RScene() {
 }
 
 bool RScene::LoadScenePackage(const std::string& sceneId) {
+    LoadScope packageScope(LoadStage::Package, "scene:" + sceneId);
     ScenePackageData package;
     std::string error;
 
@@ -494,9 +528,40 @@ bool RScene::LoadScenePackage(const std::string& sceneId) {
         return false;
     }
 
-    if (!BuildMapGpuResources(package, &error)) {
-        AppLogger::Log("[RS3] LoadScenePackage failed: " + error);
-        return false;
+    {
+        LoadScope uploadScope(LoadStage::Upload, "scene:" + sceneId + "/map");
+        uploadScope.AddBytes(package.vertices.size() * sizeof(package.vertices[0]) + package.indices.size() * sizeof(package.indices[0]));
+        if (!BuildMapGpuResources(package, &error)) {
+            AppLogger::Log("[RS3] LoadScenePackage failed: " + error);
+            return false;
+        }
+    }
+
+    LoadScope collisionScope(LoadStage::Build, "scene:" + sceneId + "/collision");
+    if (!SceneCollisionBsp::Build(package.collision, m_collisionBsp, &error)) {
+        AppLogger::Log("[RS3] LoadScenePackage: collision disabled: " + error);
+        m_collisionBsp.Clear();
+    }
+    collisionScope.End();
+
+    LoadScope raycastScope(LoadStage::Build, "scene:" + sceneId + "/raycast");
+    if (!SceneRaycaster::Build(package, m_worldRaycaster, &error)) {
+        AppLogger::Log("[RS3] LoadScenePackage: world raycasts disabled: " + error);
+        m_worldRaycaster.Clear();
+    }
+    raycastScope.End();
+
+    LoadScope navScope(LoadStage::Build, "scene:" + sceneId + "/navmesh");
+    const bool navLoaded = SceneNavMesh::LoadOrBuild(package, SceneNavSettings{}, m_navMesh, &error);
+    navScope.End();
+    if (!navLoaded) {
+        AppLogger::Log("[RS3] LoadScenePackage: navigation disabled: " + error);
+        m_navMesh.Clear();
+    } else if (package.hasSpawn && !m_navMesh.IsEmpty()) {
+        SceneNavPoint spawnPoint;
+        if (!m_navMesh.FindNearestPoint(package.spawnPos, kSpawnWalkableTolerance, spawnPoint)) {
+            AppLogger::Log("[RS3] LoadScenePackage: spawn position is not on a walkable surface.");
+        }
     }
 
     m_creationShowroomMode = false;
@@ -508,7 +573,10 @@ bool RScene::LoadScenePackage(const std::string& sceneId) {
         << "' verts=" << package.vertices.size()
         << " indices=" << package.indices.size()
         << " sections=" << package.sections.size()
-        << " materials=" << package.materials.size();
+        << " materials=" << package.materials.size()
+        << " collisionNodes=" << m_collisionBsp.GetNodeCount()
+        << " rayBvhNodes=" << m_worldRaycaster.GetNodeCount()
+        << " navPolys=" << m_navMesh.GetPolygonCount();
     AppLogger::Log(oss.str());
     return true;
 }
@@ -594,12 +662,13 @@ void RScene::LoadLobbyBasic() {
 }
 
 bool RScene::EnsureMapPipeline() {
-    if (m_mapVS && m_mapPS && m_mapInputLayout && m_mapSampler && m_mapPerFrameCB) {
+    if (m_mapVS && m_mapPS && m_mapPSArray && m_mapInputLayout && m_mapSampler && m_mapPerFrameCB) {
         return true;
     }
 
     Microsoft::WRL::ComPtr<ID3DBlob> vsBlob;
     Microsoft::WRL::ComPtr<ID3DBlob> psBlob;
+    Microsoft::WRL::ComPtr<ID3DBlob> psArrayBlob;
     std::string compileError;
 
     if (!CompileShader(kMapShaderSource, "VSMain", "vs_5_0", vsBlob, &compileError)) {
@@ -610,6 +679,10 @@ bool RScene::EnsureMapPipeline() {
         AppLogger::Log("[RS3] EnsureMapPipeline PS compile failed: " + compileError);
         return false;
     }
+    if (!CompileShader(kMapShaderSource, "PSMainArray", "ps_5_0", psArrayBlob, &compileError)) {
+        AppLogger::Log("[RS3] EnsureMapPipeline PS(array) compile failed: " + compileError);
+        return false;
+    }
 
     if (FAILED(m_pd3dDevice->CreateVertexShader(vsBlob->GetBufferPointer(), vsBlob->GetBufferSize(), nullptr, &m_mapVS))) {
         AppLogger::Log("[RS3] EnsureMapPipeline failed: CreateVertexShader.");
@@ -619,11 +692,16 @@ bool RScene::EnsureMapPipeline() {
         AppLogger::Log("[RS3] EnsureMapPipeline failed: CreatePixelShader.");
         return false;
     }
+    if (FAILED(m_pd3dDevice->CreatePixelShader(psArrayBlob->GetBufferPointer(), psArrayBlob->GetBufferSize(), nullptr, &m_mapPSArray))) {
+        AppLogger::Log("[RS3] EnsureMapPipeline failed: CreatePixelShader(array).");
+        return false;
+    }
 
     const D3D11_INPUT_ELEMENT_DESC ied[] = {
         { "POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, offsetof(MapGpuVertex, pos), D3D11_INPUT_PER_VERTEX_DATA, 0 },
         { "NORMAL",   0, DXGI_FORMAT_R32G32B32_FLOAT, 0, offsetof(MapGpuVertex, normal), D3D11_INPUT_PER_VERTEX_DATA, 0 },
         { "TEXCOORD", 0, DXGI_FORMAT_R32G32_FLOAT,    0, offsetof(MapGpuVertex, uv), D3D11_INPUT_PER_VERTEX_DATA, 0 },
+        { "TEXCOORD", 1, DXGI_FORMAT_R32_FLOAT,       0, offsetof(MapGpuVertex, textureSlice), D3D11_INPUT_PER_VERTEX_DATA, 0 },
     };
 
     if (FAILED(m_pd3dDevice->CreateInputLayout(ied, static_cast<UINT>(std::size(ied)), vsBlob->GetBufferPointer(), vsBlob->GetBufferSize(), &m_mapInputLayout))) {
@@ -722,13 +800,75 @@ bool RScene::BuildMapGpuResources(const ScenePackageData& package, std::string*
         return false;
     }
 
+    m_textureManager->SetBaseDirectory(package.baseDir);
+
+    // One texture request per distinct path; "<array>.dds#<slice>" materials share their array's request.
+    std::map<std::string, uint32_t> textureKeys;
+    std::vector<TextureHandle> textures;
+    std::vector<SceneDrawSection> drawSections;
+    drawSections.reserve(package.sections.size());
+
+    for (const auto& section : package.sections) {
+        if (section.indexCount == 0) continue;
+
+        SceneDrawSection draw;
+        draw.indexStart = section.indexStart;
+        draw.indexCount = section.indexCount;
+
+        if (section.materialIndex < package.materials.size()) {
+            const auto& mat = package.materials[section.materialIndex];
+            draw.pass = ClassifyPass(mat.flags, 0);
+            std::string texturePath;
+            if (draw.pass != kMapPassHidden && SplitTextureReference(mat.diffuseMap, texturePath, draw.arraySlice)) {
+                auto inserted = textureKeys.emplace(texturePath, static_cast<uint32_t>(textures.size() + 1));
+                if (inserted.second) {
+                    // Streamed: draws with a white placeholder until the decode lands.
+                    textures.push_back(m_textureManager->RequestTexture(texturePath));
+                }
+                draw.textureKey = inserted.first->second;
+            }
+        }
+
+        drawSections.push_back(draw);
+    }
+
+    // Alpha-blended sections keep their authored order; the other passes group by texture.
+    SceneBatchResult batching;
+    std::string batchError;
+    if (!SceneDrawBatcher::Build(drawSections, package.indices, static_cast<uint32_t>(package.vertices.size()), 1u << kMapPassAlphaBlend, batching, &batchError)) {
+        SetError(outError, "Failed to batch map sections: " + batchError);
+        return false;
+    }
+
+    m_mapBatches.clear();
+    m_mapBatches.reserve(batching.batches.size());
+    for (const auto& batch : batching.batches) {
+        MapBatchRuntime runtime;
+        runtime.indexStart = batch.indexStart;
+        runtime.indexCount = batch.indexCount;
+        runtime.pass = batch.pass;
+        if (batch.textureKey != 0) {
+            runtime.diffuseTexture = textures[batch.textureKey - 1];
+        }
+        m_mapBatches.push_back(std::move(runtime));
+    }
+
+    if (m_mapBatches.empty()) {
+        SetError(outError, "Map sections are empty after runtime build.");
+        return false;
+    }
+    AppLogger::Log("[RS3] Map batching: " + std::to_string(drawSections.size()) + " sections -> " +
+        std::to_string(m_mapBatches.size()) + " draws, " + std::to_string(textures.size()) + " textures.");
+
     std::vector<MapGpuVertex> gpuVertices;
-    gpuVertices.reserve(package.vertices.size());
-    for (const auto& v : package.vertices) {
+    gpuVertices.reserve(batching.vertexSource.size());
+    for (size_t i = 0; i < batching.vertexSource.size(); ++i) {
+        const auto& v = package.vertices[batching.vertexSource[i]];
         MapGpuVertex gv;
         gv.pos = v.pos;
         gv.normal = v.normal;
         gv.uv = v.uv;
+        gv.textureSlice = static_cast<float>(batching.vertexSlices[i]);
         gpuVertices.push_back(gv);
     }
 
@@ -746,50 +886,18 @@ bool RScene::BuildMapGpuResources(const ScenePackageData& package, std::string*
     }
 
     D3D11_BUFFER_DESC ibDesc = {};
-    ibDesc.ByteWidth = static_cast<UINT>(sizeof(uint32_t) * package.indices.size());
+    ibDesc.ByteWidth = static_cast<UINT>(sizeof(uint32_t) * batching.indices.size());
     ibDesc.Usage = D3D11_USAGE_DEFAULT;
     ibDesc.BindFlags = D3D11_BIND_INDEX_BUFFER;
 
     D3D11_SUBRESOURCE_DATA ibData = {};
-    ibData.pSysMem = package.indices.data();
+    ibData.pSysMem = batching.indices.data();
 
     if (FAILED(m_pd3dDevice->CreateBuffer(&ibDesc, &ibData, &m_mapIB))) {
         SetError(outError, "Failed to create map index buffer.");
         return false;
     }
 
-    m_mapSections.clear();
-    m_mapSections.reserve(package.sections.size());
-
-    m_textureManager->SetBaseDirectory(package.baseDir);
-
-    for (const auto& section : package.sections) {
-        if (section.indexCount == 0) continue;
-
-        MapSectionRuntime runtime;
-        runtime.indexStart = section.indexStart;
-        runtime.indexCount = section.indexCount;
-
-        if (section.materialIndex < package.materials.size()) {
-            const auto& mat = package.materials[section.materialIndex];
-            runtime.materialFlags = mat.flags;
-            if (!mat.diffuseMap.empty()) {
-                runtime.diffuseSRV = m_textureManager->GetTexture(mat.diffuseMap);
-            }
-        }
-
-        if (!runtime.diffuseSRV) {
-            runtime.diffuseSRV = m_textureManager->GetWhiteTexture();
-        }
-
-        m_mapSections.push_back(std::move(runtime));
-    }
-
-    if (m_mapSections.empty()) {
-        SetError(outError, "Map sections are empty after runtime build.");
-        return false;
-    }
-
     if (package.hasCamera02) {
         m_cameraPos = package.cameraPos02;
         m_cameraDir = package.cameraDir02;
@@ -833,7 +941,10 @@ bool RScene::BuildMapGpuResources(const ScenePackageData& package, std::string*
 void RScene::ReleaseMapResources() {
     m_mapVB.Reset();
     m_mapIB.Reset();
-    m_mapSections.clear();
+    m_mapBatches.clear();
+    m_collisionBsp.Clear();
+    m_worldRaycaster.Clear();
+    m_navMesh.Clear();
     m_hasMapGeometry = false;
 }
 
@@ -1001,7 +1112,7 @@ bool RScene::EnsureShowcaseGpuResources(ShowcaseRenderable& renderable, std::str
 
         SkinPackageRuntime runtime;
         runtime.modelId = package.modelId;
-        runtime.boneCount = static_cast<uint32_t>(std::min<size_t>(package.bones.size(), MAX_BONES));
+        runtime.boneCount = static_cast<uint32_t>(std::min<size_t>(package.bones->size(), MAX_BONES));
 
         std::vector<SkinGpuVertex> gpuVertices;
         gpuVertices.reserve(package.vertices.size());
@@ -1032,6 +1143,7 @@ bool RScene::EnsureShowcaseGpuResources(ShowcaseRenderable& renderable, std::str
                 std::to_string(zeroInfluenceCount) + "/" + std::to_string(gpuVertices.size()));
         }
 
+        LoadScope uploadScope(LoadStage::Upload, "model:" + package.modelId + "/buffers");
         D3D11_BUFFER_DESC vbDesc = {};
         vbDesc.ByteWidth = static_cast<UINT>(sizeof(SkinGpuVertex) * gpuVertices.size());
         vbDesc.Usage = D3D11_USAGE_DEFAULT;
@@ -1057,6 +1169,8 @@ bool RScene::EnsureShowcaseGpuResources(ShowcaseRenderable& renderable, std::str
             SetError(outError, "Failed to create preview skin index buffer for modelId='" + package.modelId + "'.");
             return false;
         }
+        uploadScope.AddBytes(static_cast<uint64_t>(vbDesc.ByteWidth) + ibDesc.ByteWidth);
+        uploadScope.End();
 
         runtime.submeshes.reserve(package.submeshes.size());
         size_t nonIdentityNodeTransformCount = 0;
@@ -1410,11 +1524,13 @@ bool RScene::BuildShowcaseWorldMatrix(const ShowcaseRenderable& renderable, bool
 }
 
 void RScene::BuildBindPoseSkinMatrices(const RS3ModelPackage& package, std::vector<DirectX::XMFLOAT4X4>& outMatrices) const {
-    const size_t count = std::min<size_t>(package.bones.size(), MAX_BONES);
+    const size_t count = std::min<size_t>(package.bones->size(), MAX_BONES);
     outMatrices.assign(count, Identity4x4());
 }
 
 void RScene::Update(float deltaTime) {
+    m_textureManager->Update();
+
     if (deltaTime <= 0.0f) {
         return;
     }
@@ -1463,7 +1579,6 @@ void RScene::DrawWorld(ID3D11DeviceContext* context, DirectX::FXMMATRIX viewProj
         context->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
 
         context->VSSetShader(m_mapVS.Get(), nullptr, 0);
-        context->PSSetShader(m_mapPS.Get(), nullptr, 0);
         context->VSSetConstantBuffers(0, 1, m_mapPerFrameCB.GetAddressOf());
         context->PSSetConstantBuffers(0, 1, m_mapPerFrameCB.GetAddressOf());
         context->PSSetSamplers(0, 1, m_mapSampler.GetAddressOf());
@@ -1473,32 +1588,37 @@ void RScene::DrawWorld(ID3D11DeviceContext* context, DirectX::FXMMATRIX viewProj
             context->OMSetBlendState(blendState, blendFactor, 0xffffffff);
             context->OMSetDepthStencilState(depthState, 0);
 
-            for (const auto& sec : m_mapSections) {
-                if (ClassifyPass(sec.materialFlags, 0) != passId) {
+            MapPerFrameCB cb = {};
+            DirectX::XMStoreFloat4x4(&cb.viewProj, viewProj);
+            FillEnvironmentConstants(cb.lightDirIntensity, cb.lightColorFogMin, cb.fogColorFogMax, cb.cameraPosFogEnabled);
+            cb.renderParams = { static_cast<float>(passId), kDefaultAlphaRef, 0.0f, 0.0f };
+            context->UpdateSubresource(m_mapPerFrameCB.Get(), 0, nullptr, &cb, 0, 0);
+
+            for (const auto& batch : m_mapBatches) {
+                if (batch.pass != passId) {
                     continue;
                 }
 
-                MapPerFrameCB cb = {};
-                DirectX::XMStoreFloat4x4(&cb.viewProj, viewProj);
-                cb.lightDirIntensity = { m_sceneLightDir.x, m_sceneLightDir.y, m_sceneLightDir.z, m_sceneLightIntensity };
-                cb.lightColorFogMin = { m_sceneLightColor.x, m_sceneLightColor.y, m_sceneLightColor.z, m_fogMin };
-                cb.fogColorFogMax = { m_fogColor.x, m_fogColor.y, m_fogColor.z, m_fogMax };
-                cb.cameraPosFogEnabled = { m_cameraPos.x, m_cameraPos.y, m_cameraPos.z, m_fogEnabled ? 1.0f : 0.0f };
-                cb.renderParams = { static_cast<float>(passId), kDefaultAlphaRef, 0.0f, 0.0f };
-
-                context->UpdateSubresource(m_mapPerFrameCB.Get(), 0, nullptr, &cb, 0, 0);
+                m_textureManager->MarkUsed(batch.diffuseTexture);
+                ID3D11ShaderResourceView* srv = (batch.diffuseTexture && batch.diffuseTexture->srv) ? batch.diffuseTexture->srv.Get() : m_textureManager->GetWhiteTexture().Get();
 
-                ID3D11ShaderResourceView* srv = sec.diffuseSRV ? sec.diffuseSRV.Get() : m_textureManager->GetWhiteTexture().Get();
-                context->PSSetShaderResources(0, 1, &srv);
-                context->DrawIndexed(sec.indexCount, sec.indexStart, 0);
+                // Packed arrays sample by per-vertex slice; placeholders and plain textures use the 2D path.
+                if (batch.diffuseTexture && batch.diffuseTexture->srv && batch.diffuseTexture->isArray) {
+                    context->PSSetShader(m_mapPSArray.Get(), nullptr, 0);
+                    context->PSSetShaderResources(1, 1, &srv);
+                } else {
+                    context->PSSetShader(m_mapPS.Get(), nullptr, 0);
+                    context->PSSetShaderResources(0, 1, &srv);
+                }
+                context->DrawIndexed(batch.indexCount, batch.indexStart, 0);
             }
         };
 
         m_stateManager->ApplyPass(RenderPass::Map);
-        drawPass(0, m_bsOpaque.Get(), m_dsDepthWrite.Get());
-        drawPass(1, m_bsOpaque.Get(), m_dsDepthWrite.Get());
-        drawPass(2, m_bsAlphaBlend.Get(), m_dsDepthRead.Get());
-        drawPass(3, m_bsAdditive.Get(), m_dsDepthRead.Get());
+        drawPass(kMapPassOpaque, m_bsOpaque.Get(), m_dsDepthWrite.Get());
+        drawPass(kMapPassAlphaTest, m_bsOpaque.Get(), m_dsDepthWrite.Get());
+        drawPass(kMapPassAlphaBlend, m_bsAlphaBlend.Get(), m_dsDepthRead.Get());
+        drawPass(kMapPassAdditive, m_bsAdditive.Get(), m_dsDepthRead.Get());
     }
 
     m_stateManager->Reset();
@@ -1614,8 +1734,8 @@ void RScene::DrawShowcase(ID3D11DeviceContext* context, DirectX::FXMMATRIX viewP
 
                 for (const auto& sub : runtime.submeshes) {
                     if (renderable.skipCharacterNodeFilter) {
-                        const std::string nodeName = (sub.nodeIndex < sourcePackage.bones.size())
-                            ? sourcePackage.bones[sub.nodeIndex].name
+                        const std::string nodeName = (sub.nodeIndex < sourcePackage.bones->size())
+                            ? (*sourcePackage.bones)[sub.nodeIndex].name
                             : std::string();
                         if (ShouldSkipCharacterPreviewNode(nodeName)) {
                             continue;
@@ -1644,10 +1764,7 @@ void RScene::DrawShowcase(ID3D11DeviceContext* context, DirectX::FXMMATRIX viewP
                     SkinPerFrameCB cb = {};
                     cb.world = world;
                     DirectX::XMStoreFloat4x4(&cb.viewProj, showcaseViewProj);
-                    cb.lightDirIntensity = { m_sceneLightDir.x, m_sceneLightDir.y, m_sceneLightDir.z, m_sceneLightIntensity };
-                    cb.lightColorFogMin = { m_sceneLightColor.x, m_sceneLightColor.y, m_sceneLightColor.z, m_fogMin };
-                    cb.fogColorFogMax = { m_fogColor.x, m_fogColor.y, m_fogColor.z, m_fogMax };
-                    cb.cameraPosFogEnabled = { m_cameraPos.x, m_cameraPos.y, m_cameraPos.z, m_fogEnabled ? 1.0f : 0.0f };
+                    FillEnvironmentConstants(cb.lightDirIntensity, cb.lightColorFogMin, cb.fogColorFogMax, cb.cameraPosFogEnabled);
                     cb.renderParams = { static_cast<float>(passId), kDefaultAlphaRef, 0.0f, 0.0f };
 
                     context->UpdateSubresource(m_skinPerFrameCB.Get(), 0, nullptr, &cb, 0, 0);
@@ -1660,10 +1777,10 @@ void RScene::DrawShowcase(ID3D11DeviceContext* context, DirectX::FXMMATRIX viewP
             };
 
             m_stateManager->ApplyPass(RenderPass::Skin_Base);
-            drawSkinPass(0, m_skinBsOpaque.Get(), depthOpaque);
-            drawSkinPass(1, m_skinBsOpaque.Get(), depthOpaque);
-            drawSkinPass(2, m_skinBsAlphaBlend.Get(), depthAlpha);
-            drawSkinPass(3, m_skinBsAdditive.Get(), depthAlpha);
+            drawSkinPass(kMapPassOpaque, m_skinBsOpaque.Get(), depthOpaque);
+            drawSkinPass(kMapPassAlphaTest, m_skinBsOpaque.Get(), depthOpaque);
+            drawSkinPass(kMapPassAlphaBlend, m_skinBsAlphaBlend.Get(), depthAlpha);
+            drawSkinPass(kMapPassAdditive, m_skinBsAdditive.Get(), depthAlpha);
         }
 
         return drawCount;
@@ -1760,6 +1877,33 @@ void RScene::ClearCameraPose() {
     m_hasCameraOverride = false;
 }
 
+void RScene::SetEnvironmentOverride(const RS3EnvironmentOverride& environment) {
+    m_hasEnvironmentOverride = environment.hasLight || environment.hasFog;
+    m_environmentOverride = environment;
+}
+
+void RScene::ClearEnvironmentOverride() {
+    m_hasEnvironmentOverride = false;
+}
+
+void RScene::FillEnvironmentConstants(DirectX::XMFLOAT4& outLightDirIntensity, DirectX::XMFLOAT4& outLightColorFogMin,
+                                      DirectX::XMFLOAT4& outFogColorFogMax, DirectX::XMFLOAT4& outCameraPosFogEnabled) const {
+    // Timeline light/fog tracks replace the package values; the light direction stays the scene's
+    const bool overrideLight = m_hasEnvironmentOverride && m_environmentOverride.hasLight;
+    const bool overrideFog = m_hasEnvironmentOverride && m_environmentOverride.hasFog;
+    const DirectX::XMFLOAT3& lightColor = overrideLight ? m_environmentOverride.lightColor : m_sceneLightColor;
+    const float lightIntensity = overrideLight ? std::max(0.0f, m_environmentOverride.lightIntensity) : m_sceneLightIntensity;
+    const DirectX::XMFLOAT3& fogColor = overrideFog ? m_environmentOverride.fogColor : m_fogColor;
+    const float fogMin = overrideFog ? m_environmentOverride.fogMin : m_fogMin;
+    const float fogMax = overrideFog ? std::max(fogMin + 1.0f, m_environmentOverride.fogMax) : m_fogMax;
+    const bool fogEnabled = overrideFog || m_fogEnabled;
+
+    outLightDirIntensity = { m_sceneLightDir.x, m_sceneLightDir.y, m_sceneLightDir.z, lightIntensity };
+    outLightColorFogMin = { lightColor.x, lightColor.y, lightColor.z, fogMin };
+    outFogColorFogMax = { fogColor.x, fogColor.y, fogColor.z, fogMax };
+    outCameraPosFogEnabled = { m_cameraPos.x, m_cameraPos.y, m_cameraPos.z, fogEnabled ? 1.0f : 0.0f };
+}
+
 bool RScene::GetPreferredCameraPose(RS3CameraPose& outPose) const {
     outPose.position = m_cameraPos;
     outPose.target = {
@@ -1791,6 +1935,7 @@ bool RScene::SetCreationPreview(int sex, int face, int preset, int hair) {
     CharacterVisualRequest req;
     req.baseModelId = (sex == 1) ? "character/herowoman1" : "character/heroman1";
     req.initialClip = "login_idle#m2";
+    LoadScope packageScope(LoadStage::Package, "character:" + req.baseModelId);
 
     CharacterVisualInstance built;
     std::string error;
@@ -1866,8 +2011,8 @@ bool RScene::SetCreationPreview(int sex, int face, int preset, int hair) {
         }
     }
 
-    if (!clipSet && !built.packages.empty() && !built.packages.front().clips.empty()) {
-        const std::string firstClip = built.packages.front().clips.front().name;
+    if (!clipSet && built.animation.GetClipSet() && !built.animation.GetClipSet()->clips.empty()) {
+        const std::string firstClip = built.animation.GetClipSet()->clips.front().name;
         if (built.animation.SetAnimationClipByName(firstClip, 0.15f)) {
             AppLogger::Log("[RS3] SetCreationPreview fallback clip='" + firstClip + "'.");
         }
@@ -1984,4 +2129,28 @@ bool RScene::GetSpawnPos(DirectX::XMFLOAT3& outPos) const {
     return true;
 }
 
+bool RScene::IsPointInSolid(const DirectX::XMFLOAT3& point) const {
+    return m_collisionBsp.IsPointSolid(point);
+}
+
+bool RScene::TraceCollision(const DirectX::XMFLOAT3& from, const DirectX::XMFLOAT3& to, float* outFraction) const {
+    return m_collisionBsp.TraceSegment(from, to, outFraction);
+}
+
+bool RScene::RaycastWorld(const SceneRay& ray, SceneRayHit& outHit) const {
+    return m_worldRaycaster.Raycast(ray, outHit);
+}
+
+uint32_t RScene::RaycastWorldBatch(const SceneRay* rays, uint32_t rayCount, SceneRayHit* outHits) const {
+    return m_worldRaycaster.RaycastBatch(rays, rayCount, outHits);
+}
+
+bool RScene::FindNearestWalkablePoint(const DirectX::XMFLOAT3& point, float maxDistance, SceneNavPoint& outPoint) const {
+    return m_navMesh.FindNearestPoint(point, maxDistance, outPoint);
+}
+
+bool RScene::FindWalkPath(const DirectX::XMFLOAT3& from, const DirectX::XMFLOAT3& to, std::vector<DirectX::XMFLOAT3>& outWaypoints) const {
+    return m_navMesh.FindPath(from, to, outWaypoints);
+}
+
 } // namespace RealSpace3
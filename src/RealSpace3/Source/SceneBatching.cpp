@@ -0,0 +1,105 @@
+#include "../Include/SceneBatching.h"
+
+#include <algorithm>
+#include <numeric>
+#include <unordered_map>
+
+namespace RealSpace3 {
+namespace {
+
+void SetError(std::string* outError, const std::string& message) {
+    if (outError) *outError = message;
+}
+
+constexpr uint32_t kUnassignedSlice = 0xFFFFFFFFu;
+
+bool IsOrderedPass(int pass, uint32_t orderedPassMask) {
+    return pass >= 0 && pass < 32 && (orderedPassMask & (1u << pass)) != 0;
+}
+
+} // namespace
+
+bool SceneDrawBatcher::Build(const std::vector<SceneDrawSection>& sections, const std::vector<uint32_t>& indices, uint32_t vertexCount,
+                             uint32_t orderedPassMask, SceneBatchResult& outResult, std::string* outError) {
+    outResult = SceneBatchResult{};
+
+    std::vector<uint32_t> order;
+    order.reserve(sections.size());
+    size_t totalIndices = 0;
+    for (uint32_t i = 0; i < sections.size(); ++i) {
+        const SceneDrawSection& section = sections[i];
+        if (section.pass < 0 || section.indexCount == 0) continue; // hidden or empty
+        if (static_cast<uint64_t>(section.indexStart) + section.indexCount > indices.size()) {
+            SetError(outError, "Section " + std::to_string(i) + " index range exceeds the index buffer.");
+            return false;
+        }
+        order.push_back(i);
+        totalIndices += section.indexCount;
+    }
+
+    // Unordered passes group by texture; ordered passes keep section order so only neighbours merge
+    std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+        const SceneDrawSection& sa = sections[a];
+        const SceneDrawSection& sb = sections[b];
+        if (sa.pass != sb.pass) return sa.pass < sb.pass;
+        if (IsOrderedPass(sa.pass, orderedPassMask)) return false;
+        return sa.textureKey < sb.textureKey;
+    });
+
+    outResult.indices.reserve(totalIndices);
+    outResult.vertexSource.resize(vertexCount);
+    std::iota(outResult.vertexSource.begin(), outResult.vertexSource.end(), 0u);
+    outResult.vertexSlices.assign(vertexCount, kUnassignedSlice);
+
+    // (source vertex, slice) -> duplicated output vertex, for vertices shared across slices
+    std::unordered_map<uint64_t, uint32_t> duplicates;
+
+    for (uint32_t sectionIndex : order) {
+        const SceneDrawSection& section = sections[sectionIndex];
+
+        if (outResult.batches.empty() || outResult.batches.back().pass != section.pass || outResult.batches.back().textureKey != section.textureKey) {
+            SceneDrawBatch batch;
+            batch.pass = section.pass;
+            batch.textureKey = section.textureKey;
+            batch.indexStart = static_cast<uint32_t>(outResult.indices.size());
+            outResult.batches.push_back(batch);
+        }
+        SceneDrawBatch& batch = outResult.batches.back();
+        batch.indexCount += section.indexCount;
+        ++batch.sectionCount;
+
+        for (uint32_t i = 0; i < section.indexCount; ++i) {
+            const uint32_t v = indices[section.indexStart + i];
+            if (v >= vertexCount) {
+                SetError(outError, "Section " + std::to_string(sectionIndex) + " references vertex " + std::to_string(v) + " past the vertex buffer.");
+                outResult = SceneBatchResult{};
+                return false;
+            }
+
+            uint32_t& slice = outResult.vertexSlices[v];
+            if (slice == kUnassignedSlice) slice = section.arraySlice;
+            if (slice == section.arraySlice) {
+                outResult.indices.push_back(v);
+                continue;
+            }
+
+            const uint64_t key = (static_cast<uint64_t>(v) << 32) | section.arraySlice;
+            auto it = duplicates.find(key);
+            if (it == duplicates.end()) {
+                const uint32_t copy = static_cast<uint32_t>(outResult.vertexSource.size());
+                outResult.vertexSource.push_back(v);
+                outResult.vertexSlices.push_back(section.arraySlice);
+                it = duplicates.emplace(key, copy).first;
+            }
+            outResult.indices.push_back(it->second);
+        }
+    }
+
+    // Vertices no drawn section touches keep slice 0
+    for (uint32_t& slice : outResult.vertexSlices) {
+        if (slice == kUnassignedSlice) slice = 0;
+    }
+    return true;
+}
+
+} // namespace RealSpace3
@@ -0,0 +1,175 @@
+#include "../Include/SceneCollision.h"
+
+#include <algorithm>
+#include <array>
+
+namespace RealSpace3 {
+namespace {
+
+constexpr size_t kInlineTraceStack = 128;
+
+void SetError(std::string* outError, const std::string& msg) {
+    if (outError) *outError = msg;
+}
+
+bool IsSourceLeaf(const ScenePackageCollisionNode& node) {
+    return node.posChild < 0 && node.negChild < 0;
+}
+
+struct BuildItem {
+    int32_t source = -1;
+    int32_t parent = -1;
+    bool posSide = true;
+    uint32_t depth = 0;
+};
+
+struct TraceItem {
+    int32_t node = -1;
+    float t0 = 0.0f;
+    float t1 = 1.0f;
+};
+
+} // namespace
+
+bool SceneCollisionBsp::Build(const ScenePackageCollision& source, SceneCollisionBsp& outBsp, std::string* outError) {
+    outBsp.Clear();
+
+    if (source.nodes.empty() || source.rootIndex < 0) {
+        return true;
+    }
+
+    const int32_t nodeCount = static_cast<int32_t>(source.nodes.size());
+    if (source.rootIndex >= nodeCount) {
+        SetError(outError, "collision root index is out of range");
+        return false;
+    }
+
+    outBsp.m_planes.reserve(source.nodes.size());
+    outBsp.m_children.reserve(source.nodes.size());
+
+    std::vector<uint8_t> visited(source.nodes.size(), 0);
+    std::vector<BuildItem> stack;
+    stack.push_back({ source.rootIndex, -1, true, 0 });
+
+    uint32_t maxDepth = 0;
+    while (!stack.empty()) {
+        const BuildItem item = stack.back();
+        stack.pop_back();
+
+        int32_t link = kLeafEmpty;
+        if (item.source >= 0) {
+            if (item.source >= nodeCount) {
+                SetError(outError, "collision node child index is out of range");
+                return false;
+            }
+            if (visited[item.source]) {
+                SetError(outError, "collision node graph is not a tree");
+                return false;
+            }
+            visited[item.source] = 1;
+
+            const auto& node = source.nodes[item.source];
+            if (IsSourceLeaf(node)) {
+                link = EncodeLeaf(node.solid);
+            } else {
+                link = static_cast<int32_t>(outBsp.m_planes.size());
+                outBsp.m_planes.emplace_back(node.plane.x, node.plane.y, node.plane.z, node.plane.w);
+                outBsp.m_children.emplace_back();
+                maxDepth = std::max(maxDepth, item.depth + 1);
+
+                // Negative side first on the stack so the positive subtree is
+                // emitted immediately after its parent.
+                stack.push_back({ node.negChild, link, false, item.depth + 1 });
+                stack.push_back({ node.posChild, link, true, item.depth + 1 });
+            }
+        }
+
+        if (item.parent < 0) {
+            outBsp.m_root = link;
+        } else if (item.posSide) {
+            outBsp.m_children[item.parent].pos = link;
+        } else {
+            outBsp.m_children[item.parent].neg = link;
+        }
+    }
+
+    outBsp.m_maxDepth = maxDepth;
+    return true;
+}
+
+void SceneCollisionBsp::Clear() {
+    m_planes.clear();
+    m_children.clear();
+    m_root = kLeafEmpty;
+    m_maxDepth = 0;
+}
+
+bool SceneCollisionBsp::IsPointSolid(const DirectX::XMFLOAT3& point) const {
+    const DirectX::XMVECTOR p = DirectX::XMLoadFloat3(&point);
+
+    int32_t node = m_root;
+    while (node >= 0) {
+        const DirectX::XMVECTOR plane = DirectX::XMLoadFloat4A(&m_planes[node]);
+        const float d = DirectX::XMVectorGetX(DirectX::XMPlaneDotCoord(plane, p));
+        node = (d >= 0.0f) ? m_children[node].pos : m_children[node].neg;
+    }
+    return node == kLeafSolid;
+}
+
+bool SceneCollisionBsp::TraceSegment(const DirectX::XMFLOAT3& from, const DirectX::XMFLOAT3& to, float* outFraction) const {
+    if (m_root == kLeafEmpty) {
+        return false;
+    }
+
+    const DirectX::XMVECTOR a = DirectX::XMLoadFloat3(&from);
+    const DirectX::XMVECTOR b = DirectX::XMLoadFloat3(&to);
+
+    // Worst case keeps one deferred far-side entry per level.
+    std::array<TraceItem, kInlineTraceStack> inlineStack;
+    std::vector<TraceItem> heapStack;
+    TraceItem* stack = inlineStack.data();
+    if (m_maxDepth + 1 > kInlineTraceStack) {
+        heapStack.resize(m_maxDepth + 1);
+        stack = heapStack.data();
+    }
+
+    size_t top = 0;
+    stack[top++] = { m_root, 0.0f, 1.0f };
+
+    while (top > 0) {
+        TraceItem item = stack[--top];
+
+        // Descend the near side inline; only the far side is deferred.
+        while (item.node >= 0) {
+            const DirectX::XMVECTOR plane = DirectX::XMLoadFloat4A(&m_planes[item.node]);
+            const float da = DirectX::XMVectorGetX(DirectX::XMPlaneDotCoord(plane, a));
+            const float db = DirectX::XMVectorGetX(DirectX::XMPlaneDotCoord(plane, b));
+            const float d0 = da + (db - da) * item.t0;
+            const float d1 = da + (db - da) * item.t1;
+            const SceneCollisionChildren& children = m_children[item.node];
+
+            if (d0 >= 0.0f && d1 >= 0.0f) {
+                item.node = children.pos;
+                continue;
+            }
+            if (d0 < 0.0f && d1 < 0.0f) {
+                item.node = children.neg;
+                continue;
+            }
+
+            const float tSplit = std::max(item.t0, std::min(item.t1, da / (da - db)));
+            const bool nearPos = d0 >= 0.0f;
+            stack[top++] = { nearPos ? children.neg : children.pos, tSplit, item.t1 };
+            item = { nearPos ? children.pos : children.neg, item.t0, tSplit };
+        }
+
+        if (item.node == kLeafSolid) {
+            if (outFraction) *outFraction = item.t0;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+} // namespace RealSpace3
@@ -1,6 +1,7 @@
 #include "../Include/SceneManager.h"
 #include "../Include/RScene.h"
 #include "../Include/CinematicTimeline.h"
+#include "../Include/CompiledTimeline.h"
 
 #include "AppLogger.h"
 
@@ -64,22 +65,24 @@ bool SceneManager::loadScenePackage(const std::string& sceneId) {
 bool SceneManager::playTimeline(const std::string& timelinePath, const RS3TimelinePlaybackOptions& opts) {
     if (!EnsureScene()) return false;
 
-    RS3TimelineData timeline;
+    std::shared_ptr<const RS3CompiledTimeline> timeline;
     std::string timelineError;
-    if (!LoadTimelineFromFile(timelinePath, timeline, &timelineError)) {
+    if (!LoadCompiledTimeline(timelinePath, timeline, &timelineError)) {
         AppLogger::Log("[RS3] playTimeline failed: " + timelineError);
         return false;
     }
 
-    if (!m_pCurrentScene->LoadScenePackage(timeline.sceneId)) {
-        AppLogger::Log("[RS3] playTimeline failed: could not load scene package '" + timeline.sceneId + "'.");
+    const std::string sceneId(timeline->GetSceneId());
+    const RS3RenderMode mode = timeline->GetMode();
+    if (!m_pCurrentScene->LoadScenePackage(sceneId)) {
+        AppLogger::Log("[RS3] playTimeline failed: could not load scene package '" + sceneId + "'.");
         return false;
     }
 
-    m_pCurrentScene->SetRenderMode(timeline.mode);
+    m_pCurrentScene->SetRenderMode(mode);
 
     std::string playError;
-    if (!m_cinematicPlayer.Play(timeline, opts, &playError)) {
+    if (!m_cinematicPlayer.Play(std::move(timeline), opts, &playError)) {
         AppLogger::Log("[RS3] playTimeline failed: " + playError);
         return false;
     }
@@ -88,8 +91,9 @@ bool SceneManager::playTimeline(const std::string& timelinePath, const RS3Timeli
     if (m_cinematicPlayer.EvaluateCameraPose(pose)) {
         setCameraPose(pose, true);
     }
+    ApplyTimelineTracks();
 
-    AppLogger::Log("[RS3] playTimeline success: sceneId='" + timeline.sceneId + "' mode='" + std::string(ToRenderModeString(timeline.mode)) + "'.");
+    AppLogger::Log("[RS3] playTimeline success: sceneId='" + sceneId + "' mode='" + std::string(ToRenderModeString(mode)) + "'.");
     return true;
 }
 
@@ -98,6 +102,7 @@ void SceneManager::stopTimeline() {
     m_hasCameraPoseOverride = false;
     if (m_pCurrentScene) {
         m_pCurrentScene->ClearCameraPose();
+        m_pCurrentScene->ClearEnvironmentOverride();
     }
 }
 
@@ -108,6 +113,18 @@ bool SceneManager::setCameraPose(const RS3CameraPose& pose, bool immediate) {
     return m_pCurrentScene->SetCameraPose(pose, immediate);
 }
 
+void SceneManager::setEnvironmentOverride(const RS3EnvironmentOverride& environment) {
+    if (!EnsureScene()) return;
+    m_pCurrentScene->SetEnvironmentOverride(environment);
+}
+
+// Light and fog tracks drive the scene environment. Transform and clip tracks are evaluated
+// for the studio and exporters; the runtime scene has no props to bind them to yet.
+void SceneManager::ApplyTimelineTracks() {
+    if (!m_cinematicPlayer.EvaluateTracks(m_trackFrame)) return;
+    m_pCurrentScene->SetEnvironmentOverride(BuildEnvironmentOverride(m_trackFrame));
+}
+
 void SceneManager::update(float deltaTime) {
     if (!m_pCurrentScene) return;
 
@@ -119,6 +136,7 @@ void SceneManager::update(float deltaTime) {
         if (m_cinematicPlayer.EvaluateCameraPose(pose)) {
             setCameraPose(pose, true);
         }
+        ApplyTimelineTracks();
     }
 }
 
@@ -0,0 +1,680 @@
+#include "../Include/SceneNavigation.h"
+#include "../Include/AssetFileSystem.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <queue>
+#include <unordered_map>
+
+namespace RealSpace3 {
+namespace {
+
+namespace fs = std::filesystem;
+
+constexpr uint32_t kNavVersion = 1;
+constexpr std::array<uint8_t, 8> kNavMagic = { 0x52, 0x53, 0x33, 0x4E, 0x41, 0x56, 0x31, 0x00 }; // RS3NAV1\0
+constexpr float kDegToRad = 0.01745329251994329577f;
+constexpr uint32_t kMaxGridCells = 1u << 20;
+
+void SetError(std::string* outError, const std::string& msg) {
+    if (outError) *outError = msg;
+}
+
+DirectX::XMFLOAT3 Sub(const DirectX::XMFLOAT3& a, const DirectX::XMFLOAT3& b) {
+    return { a.x - b.x, a.y - b.y, a.z - b.z };
+}
+
+DirectX::XMFLOAT3 Add(const DirectX::XMFLOAT3& a, const DirectX::XMFLOAT3& b) {
+    return { a.x + b.x, a.y + b.y, a.z + b.z };
+}
+
+DirectX::XMFLOAT3 Scale(const DirectX::XMFLOAT3& a, float s) {
+    return { a.x * s, a.y * s, a.z * s };
+}
+
+float Dot(const DirectX::XMFLOAT3& a, const DirectX::XMFLOAT3& b) {
+    return a.x * b.x + a.y * b.y + a.z * b.z;
+}
+
+DirectX::XMFLOAT3 Cross(const DirectX::XMFLOAT3& a, const DirectX::XMFLOAT3& b) {
+    return { a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x };
+}
+
+float Distance(const DirectX::XMFLOAT3& a, const DirectX::XMFLOAT3& b) {
+    const DirectX::XMFLOAT3 d = Sub(a, b);
+    return std::sqrt(Dot(d, d));
+}
+
+DirectX::XMFLOAT3 Midpoint(const DirectX::XMFLOAT3& a, const DirectX::XMFLOAT3& b) {
+    return { (a.x + b.x) * 0.5f, (a.y + b.y) * 0.5f, (a.z + b.z) * 0.5f };
+}
+
+class Fnv1a64 {
+public:
+    void Add(const void* data, size_t size) {
+        const uint8_t* bytes = static_cast<const uint8_t*>(data);
+        for (size_t i = 0; i < size; ++i) {
+            m_hash ^= bytes[i];
+            m_hash *= 1099511628211ull;
+        }
+    }
+
+    template <typename T>
+    void AddPod(const T& value) {
+        Add(&value, sizeof(value));
+    }
+
+    uint64_t Value() const { return m_hash; }
+
+private:
+    uint64_t m_hash = 14695981039346656037ull;
+};
+
+uint64_t EdgeKey(uint32_t a, uint32_t b) {
+    const uint32_t lo = std::min(a, b);
+    const uint32_t hi = std::max(a, b);
+    return (static_cast<uint64_t>(lo) << 32) | hi;
+}
+
+uint64_t CellKey(int32_t x, int32_t y) {
+    return (static_cast<uint64_t>(static_cast<uint32_t>(x)) << 32) | static_cast<uint32_t>(y);
+}
+
+uint64_t WeldKey(const DirectX::XMFLOAT3& p, float invTolerance) {
+    const auto q = [invTolerance](float v) {
+        return static_cast<uint64_t>(static_cast<int64_t>(std::floor(v * invTolerance + 0.5f)) + (1ll << 20)) & 0x1FFFFFull;
+    };
+    return (q(p.x) << 42) | (q(p.y) << 21) | q(p.z);
+}
+
+class NavReader {
+public:
+    explicit NavReader(const std::vector<uint8_t>& data) : m_data(data) {}
+
+    bool ReadBytes(void* dst, size_t size) {
+        if (m_data.size() - m_off < size) return false;
+        std::memcpy(dst, m_data.data() + m_off, size);
+        m_off += size;
+        return true;
+    }
+
+    template <typename T>
+    bool Read(T& outValue) {
+        return ReadBytes(&outValue, sizeof(outValue));
+    }
+
+    bool ReadVec3(DirectX::XMFLOAT3& out) {
+        return Read(out.x) && Read(out.y) && Read(out.z);
+    }
+
+private:
+    const std::vector<uint8_t>& m_data;
+    size_t m_off = 0;
+};
+
+class NavWriter {
+public:
+    void WriteBytes(const void* src, size_t size) {
+        const uint8_t* bytes = static_cast<const uint8_t*>(src);
+        m_data.insert(m_data.end(), bytes, bytes + size);
+    }
+
+    template <typename T>
+    void Write(const T& value) {
+        WriteBytes(&value, sizeof(value));
+    }
+
+    void WriteVec3(const DirectX::XMFLOAT3& v) {
+        Write(v.x);
+        Write(v.y);
+        Write(v.z);
+    }
+
+    const std::vector<uint8_t>& Data() const { return m_data; }
+
+private:
+    std::vector<uint8_t> m_data;
+};
+
+struct BoundaryEdge {
+    uint32_t polygon = 0;
+    DirectX::XMFLOAT3 mid = { 0.0f, 0.0f, 0.0f };
+};
+
+} // namespace
+
+uint64_t SceneNavMesh::ComputeSourceHash(const ScenePackageData& package, const SceneNavSettings& settings) {
+    Fnv1a64 h;
+    h.AddPod(kNavVersion);
+    h.AddPod(settings.maxSlopeDeg);
+    h.AddPod(settings.stepHeight);
+    h.AddPod(settings.stepReach);
+    h.AddPod(settings.weldTolerance);
+    h.AddPod(settings.excludeMaterialFlags);
+    for (const auto& m : package.materials) h.AddPod(m.flags);
+    for (const auto& s : package.sections) {
+        h.AddPod(s.materialIndex);
+        h.AddPod(s.indexStart);
+        h.AddPod(s.indexCount);
+    }
+    for (const auto& v : package.vertices) h.AddPod(v.pos);
+    if (!package.indices.empty()) h.Add(package.indices.data(), package.indices.size() * sizeof(uint32_t));
+    return h.Value();
+}
+
+bool SceneNavMesh::Build(const ScenePackageData& package, const SceneNavSettings& settings, SceneNavMesh& outMesh, std::string* outError) {
+    outMesh.Clear();
+    outMesh.m_sourceHash = ComputeSourceHash(package, settings);
+
+    const float minUp = std::cos(settings.maxSlopeDeg * kDegToRad);
+    const float invWeld = 1.0f / std::max(0.001f, settings.weldTolerance);
+
+    std::unordered_map<uint64_t, uint32_t> weld;
+    const auto weldVertex = [&](const DirectX::XMFLOAT3& p) {
+        const auto it = weld.emplace(WeldKey(p, invWeld), static_cast<uint32_t>(outMesh.m_vertices.size()));
+        if (it.second) outMesh.m_vertices.push_back(p);
+        return it.first->second;
+    };
+
+    for (uint32_t s = 0; s < package.sections.size(); ++s) {
+        const auto& sec = package.sections[s];
+        if (sec.materialIndex >= package.materials.size()) continue;
+        if ((package.materials[sec.materialIndex].flags & settings.excludeMaterialFlags) != 0) continue;
+
+        const uint64_t end = static_cast<uint64_t>(sec.indexStart) + sec.indexCount;
+        if (end > package.indices.size()) {
+            SetError(outError, "section index range is out of bounds");
+            return false;
+        }
+
+        for (uint32_t i = sec.indexStart; i + 2 < end; i += 3) {
+            const auto& a = package.vertices[package.indices[i]];
+            const auto& b = package.vertices[package.indices[i + 1]];
+            const auto& c = package.vertices[package.indices[i + 2]];
+
+            DirectX::XMFLOAT3 n = Cross(Sub(b.pos, a.pos), Sub(c.pos, a.pos));
+            const float len = std::sqrt(Dot(n, n));
+            if (len < 1e-6f) continue;
+            n = Scale(n, 1.0f / len);
+
+            // Winding is not guaranteed by the converter; orient by the authored vertex normals.
+            const DirectX::XMFLOAT3 authored = Add(Add(a.normal, b.normal), c.normal);
+            if (Dot(n, authored) < 0.0f) n = Scale(n, -1.0f);
+            if (n.z < minUp) continue;
+
+            Polygon poly;
+            poly.v[0] = weldVertex(a.pos);
+            poly.v[1] = weldVertex(b.pos);
+            poly.v[2] = weldVertex(c.pos);
+            if (poly.v[0] == poly.v[1] || poly.v[1] == poly.v[2] || poly.v[0] == poly.v[2]) continue;
+            poly.sectionIndex = s;
+            poly.center = Scale(Add(Add(a.pos, b.pos), c.pos), 1.0f / 3.0f);
+            outMesh.m_polygons.push_back(poly);
+        }
+    }
+
+    const uint32_t polyCount = static_cast<uint32_t>(outMesh.m_polygons.size());
+    std::vector<std::vector<Link>> adjacency(polyCount);
+    const auto addLink = [&](uint32_t from, uint32_t to, const DirectX::XMFLOAT3& portal) {
+        for (const auto& l : adjacency[from]) {
+            if (l.target == to) return;
+        }
+        adjacency[from].push_back({ to, portal });
+    };
+
+    // Shared edges.
+    std::unordered_map<uint64_t, uint32_t> edgeOwner;
+    std::unordered_map<uint64_t, uint32_t> edgeUses;
+    edgeOwner.reserve(static_cast<size_t>(polyCount) * 3);
+    for (uint32_t p = 0; p < polyCount; ++p) {
+        const Polygon& poly = outMesh.m_polygons[p];
+        for (int e = 0; e < 3; ++e) {
+            const uint32_t va = poly.v[e];
+            const uint32_t vb = poly.v[(e + 1) % 3];
+            const uint64_t key = EdgeKey(va, vb);
+            ++edgeUses[key];
+            const auto it = edgeOwner.emplace(key, p);
+            if (!it.second && it.first->second != p) {
+                const uint32_t other = it.first->second;
+                const DirectX::XMFLOAT3 portal = Midpoint(outMesh.m_vertices[va], outMesh.m_vertices[vb]);
+                addLink(p, other, portal);
+                addLink(other, p, portal);
+            }
+        }
+    }
+
+    // Step links between boundary edges of surfaces that are close but not welded together.
+    std::vector<BoundaryEdge> boundary;
+    for (uint32_t p = 0; p < polyCount; ++p) {
+        const Polygon& poly = outMesh.m_polygons[p];
+        for (int e = 0; e < 3; ++e) {
+            const uint32_t va = poly.v[e];
+            const uint32_t vb = poly.v[(e + 1) % 3];
+            if (edgeUses[EdgeKey(va, vb)] != 1) continue;
+            boundary.push_back({ p, Midpoint(outMesh.m_vertices[va], outMesh.m_vertices[vb]) });
+        }
+    }
+
+    const float reach = std::max(1.0f, settings.stepReach);
+    std::unordered_map<uint64_t, std::vector<uint32_t>> boundaryCells;
+    for (uint32_t i = 0; i < boundary.size(); ++i) {
+        const int32_t cx = static_cast<int32_t>(std::floor(boundary[i].mid.x / reach));
+        const int32_t cy = static_cast<int32_t>(std::floor(boundary[i].mid.y / reach));
+        boundaryCells[CellKey(cx, cy)].push_back(i);
+    }
+
+    for (const auto& edge : boundary) {
+        const int32_t cx = static_cast<int32_t>(std::floor(edge.mid.x / reach));
+        const int32_t cy = static_cast<int32_t>(std::floor(edge.mid.y / reach));
+        for (int32_t dy = -1; dy <= 1; ++dy) {
+            for (int32_t dx = -1; dx <= 1; ++dx) {
+                const auto it = boundaryCells.find(CellKey(cx + dx, cy + dy));
+                if (it == boundaryCells.end()) continue;
+                for (const uint32_t j : it->second) {
+                    const BoundaryEdge& other = boundary[j];
+                    if (other.polygon == edge.polygon) continue;
+                    const float hx = other.mid.x - edge.mid.x;
+                    const float hy = other.mid.y - edge.mid.y;
+                    if (hx * hx + hy * hy > reach * reach) continue;
+                    if (std::fabs(other.mid.z - edge.mid.z) > settings.stepHeight) continue;
+                    addLink(edge.polygon, other.polygon, Midpoint(edge.mid, other.mid));
+                }
+            }
+        }
+    }
+
+    outMesh.m_linkOffsets.resize(static_cast<size_t>(polyCount) + 1, 0);
+    for (uint32_t p = 0; p < polyCount; ++p) {
+        outMesh.m_linkOffsets[p] = static_cast<uint32_t>(outMesh.m_links.size());
+        outMesh.m_links.insert(outMesh.m_links.end(), adjacency[p].begin(), adjacency[p].end());
+    }
+    outMesh.m_linkOffsets[polyCount] = static_cast<uint32_t>(outMesh.m_links.size());
+
+    outMesh.BuildQueryGrid();
+    return true;
+}
+
+bool SceneNavMesh::LoadOrBuild(const ScenePackageData& package, const SceneNavSettings& settings, SceneNavMesh& outMesh, std::string* outError) {
+    const uint64_t sourceHash = ComputeSourceHash(package, settings);
+    const fs::path sidecar = fs::path(package.baseDir) / kSidecarFileName;
+    // Packed scenes are read-only: use a navmesh.bin baked offline (RS3SceneTool --nav-bake)
+    // and packed next to world.bin when it is current, otherwise rebuild on every load
+    const bool packed = AssetFileSystem::IsVirtualPath(package.baseDir);
+    const bool useSidecar = !package.baseDir.empty() && !packed;
+
+    if (useSidecar && outMesh.LoadFromFile(sidecar.string(), sourceHash, nullptr)) {
+        return true;
+    }
+    if (packed) {
+        std::vector<uint8_t> bytes;
+        if (AssetFileSystem::getInstance().ReadFile(package.baseDir + "/" + kSidecarFileName, bytes, nullptr)
+            && outMesh.LoadFromBytes(bytes, sourceHash, nullptr)) {
+            return true;
+        }
+    }
+
+    if (!Build(package, settings, outMesh, outError)) {
+        return false;
+    }
+
+    if (useSidecar) {
+        // Cache write failures are not fatal; the mesh is rebuilt on the next load.
+        (void)outMesh.SaveToFile(sidecar.string(), nullptr);
+    }
+    return true;
+}
+
+bool SceneNavMesh::SaveToFile(const std::string& filePath, std::string* outError) const {
+    NavWriter w;
+    w.WriteBytes(kNavMagic.data(), kNavMagic.size());
+    w.Write(kNavVersion);
+    w.Write(m_sourceHash);
+    w.Write(static_cast<uint32_t>(m_vertices.size()));
+    w.Write(static_cast<uint32_t>(m_polygons.size()));
+    w.Write(static_cast<uint32_t>(m_links.size()));
+
+    for (const auto& v : m_vertices) w.WriteVec3(v);
+    for (const auto& p : m_polygons) {
+        w.Write(p.v[0]);
+        w.Write(p.v[1]);
+        w.Write(p.v[2]);
+        w.Write(p.sectionIndex);
+        w.WriteVec3(p.center);
+    }
+    for (const auto off : m_linkOffsets) w.Write(off);
+    for (const auto& l : m_links) {
+        w.Write(l.target);
+        w.WriteVec3(l.portal);
+    }
+
+    std::ofstream out(fs::path(filePath), std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) {
+        SetError(outError, "Failed to open navmesh.bin for writing");
+        return false;
+    }
+    out.write(reinterpret_cast<const char*>(w.Data().data()), static_cast<std::streamsize>(w.Data().size()));
+    if (!out.good()) {
+        SetError(outError, "Failed to write navmesh.bin");
+        return false;
+    }
+    return true;
+}
+
+bool SceneNavMesh::LoadFromFile(const std::string& filePath, uint64_t expectedSourceHash, std::string* outError) {
+    Clear();
+
+    std::ifstream in(fs::path(filePath), std::ios::binary);
+    if (!in.is_open()) {
+        SetError(outError, "navmesh.bin not found");
+        return false;
+    }
+    const std::vector<uint8_t> bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    return LoadFromBytes(bytes, expectedSourceHash, outError);
+}
+
+bool SceneNavMesh::LoadFromBytes(const std::vector<uint8_t>& bytes, uint64_t expectedSourceHash, std::string* outError) {
+    Clear();
+    NavReader r(bytes);
+
+    std::array<uint8_t, 8> magic{};
+    uint32_t version = 0;
+    uint64_t hash = 0;
+    if (!r.ReadBytes(magic.data(), magic.size()) || magic != kNavMagic || !r.Read(version) || version != kNavVersion) {
+        SetError(outError, "navmesh.bin header mismatch");
+        return false;
+    }
+    if (!r.Read(hash) || hash != expectedSourceHash) {
+        SetError(outError, "navmesh.bin is stale");
+        return false;
+    }
+
+    uint32_t vertexCount = 0;
+    uint32_t polygonCount = 0;
+    uint32_t linkCount = 0;
+    if (!r.Read(vertexCount) || !r.Read(polygonCount) || !r.Read(linkCount)) {
+        SetError(outError, "navmesh.bin is truncated (counts)");
+        return false;
+    }
+
+    // Reject counts that cannot fit in the file before allocating.
+    const uint64_t required = static_cast<uint64_t>(vertexCount) * 12 + static_cast<uint64_t>(polygonCount) * 28
+        + (static_cast<uint64_t>(polygonCount) + 1) * 4 + static_cast<uint64_t>(linkCount) * 16;
+    if (required > bytes.size()) {
+        SetError(outError, "navmesh.bin is truncated");
+        return false;
+    }
+
+    m_vertices.resize(vertexCount);
+    for (auto& v : m_vertices) r.ReadVec3(v);
+
+    m_polygons.resize(polygonCount);
+    for (auto& p : m_polygons) {
+        if (!r.Read(p.v[0]) || !r.Read(p.v[1]) || !r.Read(p.v[2]) || !r.Read(p.sectionIndex) || !r.ReadVec3(p.center)) {
+            SetError(outError, "navmesh.bin is truncated (polygons)");
+            Clear();
+            return false;
+        }
+        if (p.v[0] >= vertexCount || p.v[1] >= vertexCount || p.v[2] >= vertexCount) {
+            SetError(outError, "navmesh.bin polygon vertex is out of range");
+            Clear();
+            return false;
+        }
+    }
+
+    m_linkOffsets.resize(static_cast<size_t>(polygonCount) + 1);
+    for (auto& off : m_linkOffsets) {
+        if (!r.Read(off) || off > linkCount) {
+            SetError(outError, "navmesh.bin link offsets are invalid");
+            Clear();
+            return false;
+        }
+    }
+
+    m_links.resize(linkCount);
+    for (auto& l : m_links) {
+        if (!r.Read(l.target) || !r.ReadVec3(l.portal) || l.target >= polygonCount) {
+            SetError(outError, "navmesh.bin links are invalid");
+            Clear();
+            return false;
+        }
+    }
+
+    m_sourceHash = hash;
+    BuildQueryGrid();
+    return true;
+}
+
+void SceneNavMesh::Clear() {
+    m_vertices.clear();
+    m_polygons.clear();
+    m_linkOffsets.clear();
+    m_links.clear();
+    m_sourceHash = 0;
+    m_gridWidth = 0;
+    m_gridHeight = 0;
+    m_gridOffsets.clear();
+    m_gridPolygons.clear();
+}
+
+void SceneNavMesh::BuildQueryGrid() {
+    m_gridOffsets.clear();
+    m_gridPolygons.clear();
+    m_gridWidth = 0;
+    m_gridHeight = 0;
+    if (m_polygons.empty()) return;
+
+    float minX = FLT_MAX, minY = FLT_MAX, maxX = -FLT_MAX, maxY = -FLT_MAX;
+    for (const auto& v : m_vertices) {
+        minX = std::min(minX, v.x);
+        minY = std::min(minY, v.y);
+        maxX = std::max(maxX, v.x);
+        maxY = std::max(maxY, v.y);
+    }
+
+    const float extentX = std::max(1.0f, maxX - minX);
+    const float extentY = std::max(1.0f, maxY - minY);
+    // Roughly two polygons per cell on average.
+    float cell = std::sqrt(extentX * extentY * 2.0f / static_cast<float>(m_polygons.size()));
+    cell = std::max(cell, std::sqrt(extentX * extentY / static_cast<float>(kMaxGridCells)));
+    cell = std::max(cell, 1.0f);
+
+    m_gridOrigin = { minX, minY };
+    m_gridCellSize = cell;
+    m_gridWidth = static_cast<uint32_t>(extentX / cell) + 1;
+    m_gridHeight = static_cast<uint32_t>(extentY / cell) + 1;
+
+    const auto cellRange = [&](const Polygon& p, uint32_t& x0, uint32_t& y0, uint32_t& x1, uint32_t& y1) {
+        const auto& a = m_vertices[p.v[0]];
+        const auto& b = m_vertices[p.v[1]];
+        const auto& c = m_vertices[p.v[2]];
+        x0 = static_cast<uint32_t>((std::min({ a.x, b.x, c.x }) - minX) / cell);
+        y0 = static_cast<uint32_t>((std::min({ a.y, b.y, c.y }) - minY) / cell);
+        x1 = std::min(m_gridWidth - 1, static_cast<uint32_t>((std::max({ a.x, b.x, c.x }) - minX) / cell));
+        y1 = std::min(m_gridHeight - 1, static_cast<uint32_t>((std::max({ a.y, b.y, c.y }) - minY) / cell));
+    };
+
+    std::vector<uint32_t> counts(static_cast<size_t>(m_gridWidth) * m_gridHeight + 1, 0);
+    for (const auto& p : m_polygons) {
+        uint32_t x0, y0, x1, y1;
+        cellRange(p, x0, y0, x1, y1);
+        for (uint32_t y = y0; y <= y1; ++y)
+            for (uint32_t x = x0; x <= x1; ++x) ++counts[y * m_gridWidth + x];
+    }
+
+    m_gridOffsets.resize(counts.size(), 0);
+    uint32_t running = 0;
+    for (size_t i = 0; i + 1 < counts.size(); ++i) {
+        m_gridOffsets[i] = running;
+        running += counts[i];
+    }
+    m_gridOffsets.back() = running;
+
+    m_gridPolygons.resize(running);
+    std::vector<uint32_t> cursor(m_gridOffsets.begin(), m_gridOffsets.end() - 1);
+    for (uint32_t i = 0; i < m_polygons.size(); ++i) {
+        uint32_t x0, y0, x1, y1;
+        cellRange(m_polygons[i], x0, y0, x1, y1);
+        for (uint32_t y = y0; y <= y1; ++y)
+            for (uint32_t x = x0; x <= x1; ++x) m_gridPolygons[cursor[y * m_gridWidth + x]++] = i;
+    }
+}
+
+DirectX::XMFLOAT3 SceneNavMesh::ClosestPointOnPolygon(uint32_t polygon, const DirectX::XMFLOAT3& p) const {
+    // Ericson, Real-Time Collision Detection 5.1.5.
+    const Polygon& poly = m_polygons[polygon];
+    const DirectX::XMFLOAT3& a = m_vertices[poly.v[0]];
+    const DirectX::XMFLOAT3& b = m_vertices[poly.v[1]];
+    const DirectX::XMFLOAT3& c = m_vertices[poly.v[2]];
+
+    const DirectX::XMFLOAT3 ab = Sub(b, a);
+    const DirectX::XMFLOAT3 ac = Sub(c, a);
+    const DirectX::XMFLOAT3 ap = Sub(p, a);
+    const float d1 = Dot(ab, ap);
+    const float d2 = Dot(ac, ap);
+    if (d1 <= 0.0f && d2 <= 0.0f) return a;
+
+    const DirectX::XMFLOAT3 bp = Sub(p, b);
+    const float d3 = Dot(ab, bp);
+    const float d4 = Dot(ac, bp);
+    if (d3 >= 0.0f && d4 <= d3) return b;
+
+    const float vc = d1 * d4 - d3 * d2;
+    if (vc <= 0.0f && d1 >= 0.0f && d3 <= 0.0f) return Add(a, Scale(ab, d1 / (d1 - d3)));
+
+    const DirectX::XMFLOAT3 cp = Sub(p, c);
+    const float d5 = Dot(ab, cp);
+    const float d6 = Dot(ac, cp);
+    if (d6 >= 0.0f && d5 <= d6) return c;
+
+    const float vb = d5 * d2 - d1 * d6;
+    if (vb <= 0.0f && d2 >= 0.0f && d6 <= 0.0f) return Add(a, Scale(ac, d2 / (d2 - d6)));
+
+    const float va = d3 * d6 - d5 * d4;
+    if (va <= 0.0f && (d4 - d3) >= 0.0f && (d5 - d6) >= 0.0f) {
+        return Add(b, Scale(Sub(c, b), (d4 - d3) / ((d4 - d3) + (d5 - d6))));
+    }
+
+    const float denom = 1.0f / (va + vb + vc);
+    return Add(a, Add(Scale(ab, vb * denom), Scale(ac, vc * denom)));
+}
+
+bool SceneNavMesh::FindNearestPoint(const DirectX::XMFLOAT3& point, float maxDistance, SceneNavPoint& outPoint) const {
+    outPoint = SceneNavPoint{};
+    if (m_polygons.empty() || m_gridWidth == 0) return false;
+
+    const auto clampCell = [](float v, uint32_t size) {
+        if (v < 0.0f) return 0;
+        return static_cast<int32_t>(std::min(static_cast<float>(size - 1), v));
+    };
+    const int32_t cx = clampCell((point.x - m_gridOrigin.x) / m_gridCellSize, m_gridWidth);
+    const int32_t cy = clampCell((point.y - m_gridOrigin.y) / m_gridCellSize, m_gridHeight);
+    const int32_t maxRing = static_cast<int32_t>(std::max(m_gridWidth, m_gridHeight));
+
+    float best = maxDistance;
+    bool found = false;
+    const auto visitCell = [&](int32_t x, int32_t y) {
+        if (x < 0 || y < 0 || x >= static_cast<int32_t>(m_gridWidth) || y >= static_cast<int32_t>(m_gridHeight)) return;
+        const uint32_t cellIndex = static_cast<uint32_t>(y) * m_gridWidth + static_cast<uint32_t>(x);
+        for (uint32_t i = m_gridOffsets[cellIndex]; i < m_gridOffsets[cellIndex + 1]; ++i) {
+            const uint32_t poly = m_gridPolygons[i];
+            const DirectX::XMFLOAT3 q = ClosestPointOnPolygon(poly, point);
+            const float d = Distance(q, point);
+            if (d < best) {
+                best = d;
+                found = true;
+                outPoint.position = q;
+                outPoint.polygon = poly;
+                outPoint.distance = d;
+            }
+        }
+    };
+
+    for (int32_t ring = 0; ring <= maxRing; ++ring) {
+        // Every cell in this ring is at least (ring - 1) cells away horizontally.
+        if (static_cast<float>(ring - 1) * m_gridCellSize > best) break;
+        if (ring == 0) {
+            visitCell(cx, cy);
+            continue;
+        }
+        for (int32_t d = -ring; d <= ring; ++d) {
+            visitCell(cx + d, cy - ring);
+            visitCell(cx + d, cy + ring);
+        }
+        for (int32_t d = -ring + 1; d <= ring - 1; ++d) {
+            visitCell(cx - ring, cy + d);
+            visitCell(cx + ring, cy + d);
+        }
+    }
+
+    return found;
+}
+
+bool SceneNavMesh::FindPath(const DirectX::XMFLOAT3& from, const DirectX::XMFLOAT3& to, std::vector<DirectX::XMFLOAT3>& outWaypoints) const {
+    outWaypoints.clear();
+
+    SceneNavPoint start;
+    SceneNavPoint goal;
+    if (!FindNearestPoint(from, FLT_MAX, start) || !FindNearestPoint(to, FLT_MAX, goal)) {
+        return false;
+    }
+
+    if (start.polygon == goal.polygon) {
+        outWaypoints.push_back(start.position);
+        outWaypoints.push_back(goal.position);
+        return true;
+    }
+
+    const uint32_t polyCount = static_cast<uint32_t>(m_polygons.size());
+    std::vector<float> cost(polyCount, FLT_MAX);
+    std::vector<uint32_t> parentLink(polyCount, UINT32_MAX);
+    std::vector<uint32_t> parent(polyCount, UINT32_MAX);
+    std::vector<uint8_t> closed(polyCount, 0);
+
+    using OpenItem = std::pair<float, uint32_t>;
+    std::priority_queue<OpenItem, std::vector<OpenItem>, std::greater<OpenItem>> open;
+    cost[start.polygon] = 0.0f;
+    open.push({ Distance(m_polygons[start.polygon].center, goal.position), start.polygon });
+
+    bool reached = false;
+    while (!open.empty()) {
+        const uint32_t current = open.top().second;
+        open.pop();
+        if (closed[current]) continue;
+        closed[current] = 1;
+        if (current == goal.polygon) {
+            reached = true;
+            break;
+        }
+
+        const DirectX::XMFLOAT3& currentCenter = m_polygons[current].center;
+        for (uint32_t li = m_linkOffsets[current]; li < m_linkOffsets[current + 1]; ++li) {
+            const Link& link = m_links[li];
+            if (closed[link.target]) continue;
+            const float g = cost[current] + Distance(currentCenter, m_polygons[link.target].center);
+            if (g >= cost[link.target]) continue;
+            cost[link.target] = g;
+            parent[link.target] = current;
+            parentLink[link.target] = li;
+            open.push({ g + Distance(m_polygons[link.target].center, goal.position), link.target });
+        }
+    }
+
+    if (!reached) return false;
+
+    std::vector<DirectX::XMFLOAT3> portals;
+    for (uint32_t p = goal.polygon; p != start.polygon; p = parent[p]) {
+        portals.push_back(m_links[parentLink[p]].portal);
+    }
+
+    outWaypoints.reserve(portals.size() + 2);
+    outWaypoints.push_back(start.position);
+    outWaypoints.insert(outWaypoints.end(), portals.rbegin(), portals.rend());
+    outWaypoints.push_back(goal.position);
+    return true;
+}
+
+} // namespace RealSpace3
@@ -1,9 +1,10 @@
 #include "../Include/ScenePackageLoader.h"
+#include "../Include/AssetFileSystem.h"
+#include "../Include/LoadProfiler.h"
 
 #include <array>
 #include <cstring>
 #include <filesystem>
-#include <fstream>
 #include <vector>
 
 namespace RealSpace3 {
@@ -13,15 +14,15 @@ namespace fs = std::filesystem;
 
 class BinReader {
 public:
-    explicit BinReader(const std::vector<uint8_t>& data) : m_data(data) {}
+    explicit BinReader(const AssetView& view) : m_data(view.data), m_size(view.size) {}
 
     size_t Remaining() const {
-        return (m_off <= m_data.size()) ? (m_data.size() - m_off) : 0;
+        return (m_off <= m_size) ? (m_size - m_off) : 0;
     }
 
     bool ReadBytes(void* dst, size_t size) {
         if (Remaining() < size) return false;
-        std::memcpy(dst, m_data.data() + m_off, size);
+        std::memcpy(dst, m_data + m_off, size);
         m_off += size;
         return true;
     }
@@ -50,34 +51,18 @@ public:
         outValue.clear();
         if (len == 0) return true;
 
-        outValue.assign(reinterpret_cast<const char*>(m_data.data() + m_off),
-            reinterpret_cast<const char*>(m_data.data() + m_off + len));
+        outValue.assign(reinterpret_cast<const char*>(m_data + m_off),
+            reinterpret_cast<const char*>(m_data + m_off + len));
         m_off += len;
         return true;
     }
 
 private:
-    const std::vector<uint8_t>& m_data;
+    const uint8_t* m_data = nullptr;
+    size_t m_size = 0;
     size_t m_off = 0;
 };
 
-bool ReadFileBytes(const fs::path& filePath, std::vector<uint8_t>& outBytes) {
-    std::ifstream in(filePath, std::ios::binary);
-    if (!in.is_open()) return false;
-
-    in.seekg(0, std::ios::end);
-    const std::streamoff size = in.tellg();
-    if (size < 0) return false;
-    in.seekg(0, std::ios::beg);
-
-    outBytes.resize(static_cast<size_t>(size));
-    if (!outBytes.empty()) {
-        in.read(reinterpret_cast<char*>(outBytes.data()), size);
-        if (!in.good() && !in.eof()) return false;
-    }
-    return true;
-}
-
 bool ReadVec3(BinReader& r, DirectX::XMFLOAT3& out) {
     return r.ReadF32(out.x) && r.ReadF32(out.y) && r.ReadF32(out.z);
 }
@@ -90,38 +75,8 @@ void SetError(std::string* outError, const std::string& msg) {
     if (outError) *outError = msg;
 }
 
-bool ResolveSceneDir(const std::string& sceneId, fs::path& outDir) {
-    const fs::path cwd = fs::current_path();
-
-    const std::vector<fs::path> candidates = {
-        cwd / "system" / "rs3" / "scenes" / sceneId,
-        cwd / "OpenGunZ-Client" / "system" / "rs3" / "scenes" / sceneId,
-        cwd / ".." / "OpenGunZ-Client" / "system" / "rs3" / "scenes" / sceneId,
-        cwd / ".." / ".." / "OpenGunZ-Client" / "system" / "rs3" / "scenes" / sceneId,
-    };
-
-    for (const auto& c : candidates) {
-        std::error_code ec;
-        if (!fs::exists(c, ec) || !fs::is_directory(c, ec)) continue;
-        const fs::path worldBin = c / "world.bin";
-        if (fs::exists(worldBin, ec) && fs::is_regular_file(worldBin, ec)) {
-            outDir = fs::weakly_canonical(c, ec);
-            if (ec) outDir = c;
-            return true;
-        }
-    }
-
-    return false;
-}
-
-bool LoadWorld(const fs::path& worldPath, ScenePackageData& outData, std::string* outError) {
-    std::vector<uint8_t> bytes;
-    if (!ReadFileBytes(worldPath, bytes)) {
-        SetError(outError, "Failed to read world.bin");
-        return false;
-    }
-
-    BinReader r(bytes);
+bool LoadWorld(const AssetView& world, ScenePackageData& outData, std::string* outError) {
+    BinReader r(world);
 
     std::array<uint8_t, 8> magic{};
     if (!r.ReadBytes(magic.data(), magic.size())) {
@@ -262,21 +217,23 @@ bool LoadWorld(const fs::path& worldPath, ScenePackageData& outData, std::string
     return true;
 }
 
-bool LoadCollision(const fs::path& collisionPath, ScenePackageData& outData, std::string* outError) {
-    std::error_code ec;
-    if (!fs::exists(collisionPath, ec) || !fs::is_regular_file(collisionPath, ec)) {
+bool LoadCollision(const std::string& collisionPath, ScenePackageData& outData, std::string* outError) {
+    AssetFileSystem& assets = AssetFileSystem::getInstance();
+    if (!assets.Exists(collisionPath)) {
         outData.collision.rootIndex = -1;
         outData.collision.nodes.clear();
         return true;
     }
 
-    std::vector<uint8_t> bytes;
-    if (!ReadFileBytes(collisionPath, bytes)) {
+    AssetView collision;
+    if (!assets.Open(collisionPath, collision)) {
         SetError(outError, "Failed to read collision.bin");
         return false;
     }
 
-    BinReader r(bytes);
+    LoadScope decodeScope(LoadStage::Decode, collisionPath);
+    decodeScope.AddBytes(collision.size);
+    BinReader r(collision);
 
     std::array<uint8_t, 8> magic{};
     if (!r.ReadBytes(magic.data(), magic.size())) {
@@ -326,22 +283,26 @@ bool ScenePackageLoader::Load(const std::string& sceneId, ScenePackageData& outD
     outData = ScenePackageData{};
     outData.sceneId = sceneId;
 
-    fs::path sceneDir;
-    if (!ResolveSceneDir(sceneId, sceneDir)) {
+    // Packed scenes keep a "vfs:" base directory; loose ones the directory world.bin was read from
+    const std::string sceneDir = "scenes/" + sceneId;
+    AssetView world;
+    if (!AssetFileSystem::getInstance().Open(sceneDir + "/world.bin", world)) {
         SetError(outError, "Scene package directory not found");
         return false;
     }
 
-    outData.baseDir = sceneDir.generic_string();
+    outData.baseDir = world.diskPath.empty() ? AssetFileSystem::MakeVirtualPath(sceneDir)
+                                             : fs::path(world.diskPath).parent_path().generic_string();
 
-    const fs::path worldPath = sceneDir / "world.bin";
-    const fs::path collisionPath = sceneDir / "collision.bin";
-
-    if (!LoadWorld(worldPath, outData, outError)) {
-        return false;
+    {
+        LoadScope decodeScope(LoadStage::Decode, sceneDir + "/world.bin");
+        decodeScope.AddBytes(world.size);
+        if (!LoadWorld(world, outData, outError)) {
+            return false;
+        }
     }
 
-    if (!LoadCollision(collisionPath, outData, outError)) {
+    if (!LoadCollision(sceneDir + "/collision.bin", outData, outError)) {
         return false;
     }
 
@@ -0,0 +1,498 @@
+#include "../Include/SceneRaycast.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+namespace RealSpace3 {
+
+using namespace DirectX;
+
+namespace {
+
+constexpr uint32_t kLeafTriangles = 4;
+constexpr uint32_t kSahBins = 12;
+constexpr size_t kInlineTraceStack = 64;
+constexpr float kHitEpsilon = 1e-4f;
+constexpr float kDetEpsilon = 1e-8f;
+
+void SetError(std::string* outError, const std::string& msg) {
+    if (outError) *outError = msg;
+}
+
+struct Aabb {
+    XMFLOAT3 vmin = { FLT_MAX, FLT_MAX, FLT_MAX };
+    XMFLOAT3 vmax = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
+
+    void Grow(const XMFLOAT3& p) {
+        vmin = { std::min(vmin.x, p.x), std::min(vmin.y, p.y), std::min(vmin.z, p.z) };
+        vmax = { std::max(vmax.x, p.x), std::max(vmax.y, p.y), std::max(vmax.z, p.z) };
+    }
+
+    void Grow(const Aabb& b) {
+        if (b.vmin.x > b.vmax.x) return; // empty SAH bin: its FLT_MAX corners would swallow the box
+        Grow(b.vmin);
+        Grow(b.vmax);
+    }
+
+    float Area() const {
+        const float ex = vmax.x - vmin.x;
+        const float ey = vmax.y - vmin.y;
+        const float ez = vmax.z - vmin.z;
+        if (ex < 0.0f || ey < 0.0f || ez < 0.0f) return 0.0f;
+        return ex * ey + ey * ez + ez * ex;
+    }
+};
+
+float Axis(const XMFLOAT3& v, int axis) {
+    return axis == 0 ? v.x : (axis == 1 ? v.y : v.z);
+}
+
+struct BuildItem {
+    uint32_t node = 0;
+    uint32_t depth = 0;
+};
+
+struct TraceItem {
+    uint32_t node = 0;
+    float distance = 0.0f;
+};
+
+// Returns the entry distance, or FLT_MAX when the box is missed or farther than maxT.
+float IntersectBounds(const XMFLOAT3& o, const XMFLOAT3& invDir, const XMFLOAT3& bmin, const XMFLOAT3& bmax, float maxT) {
+    const float tx1 = (bmin.x - o.x) * invDir.x;
+    const float tx2 = (bmax.x - o.x) * invDir.x;
+    float tmin = std::min(tx1, tx2);
+    float tmax = std::max(tx1, tx2);
+    const float ty1 = (bmin.y - o.y) * invDir.y;
+    const float ty2 = (bmax.y - o.y) * invDir.y;
+    tmin = std::max(tmin, std::min(ty1, ty2));
+    tmax = std::min(tmax, std::max(ty1, ty2));
+    const float tz1 = (bmin.z - o.z) * invDir.z;
+    const float tz2 = (bmax.z - o.z) * invDir.z;
+    tmin = std::max(tmin, std::min(tz1, tz2));
+    tmax = std::min(tmax, std::max(tz1, tz2));
+    tmin = std::max(tmin, 0.0f);
+    if (tmax < tmin || tmin >= maxT) return FLT_MAX;
+    return tmin;
+}
+
+float SafeInverse(float v) {
+    return (std::fabs(v) > 1e-20f) ? (1.0f / v) : std::copysign(1e20f, v);
+}
+
+} // namespace
+
+bool SceneRaycaster::Build(const ScenePackageData& package, SceneRaycaster& outRaycaster, std::string* outError) {
+    outRaycaster.Clear();
+
+    std::vector<Triangle> triangles;
+    std::vector<TriangleInfo> infos;
+    std::vector<Aabb> bounds;
+    std::vector<XMFLOAT3> centroids;
+
+    for (uint32_t s = 0; s < package.sections.size(); ++s) {
+        const auto& sec = package.sections[s];
+        const uint32_t materialFlags = (sec.materialIndex < package.materials.size()) ? package.materials[sec.materialIndex].flags : 0;
+        const uint64_t end = static_cast<uint64_t>(sec.indexStart) + sec.indexCount;
+        if (end > package.indices.size()) {
+            SetError(outError, "section index range is out of bounds");
+            return false;
+        }
+
+        for (uint32_t i = sec.indexStart; i + 2 < end; i += 3) {
+            const uint32_t i0 = package.indices[i];
+            const uint32_t i1 = package.indices[i + 1];
+            const uint32_t i2 = package.indices[i + 2];
+            if (i0 >= package.vertices.size() || i1 >= package.vertices.size() || i2 >= package.vertices.size()) {
+                SetError(outError, "triangle references out-of-range vertex");
+                return false;
+            }
+
+            const XMFLOAT3& p0 = package.vertices[i0].pos;
+            const XMFLOAT3& p1 = package.vertices[i1].pos;
+            const XMFLOAT3& p2 = package.vertices[i2].pos;
+
+            Triangle tri;
+            tri.v0 = p0;
+            tri.e1 = { p1.x - p0.x, p1.y - p0.y, p1.z - p0.z };
+            tri.e2 = { p2.x - p0.x, p2.y - p0.y, p2.z - p0.z };
+            triangles.push_back(tri);
+
+            TriangleInfo info;
+            info.sourceTriangle = i / 3;
+            info.sectionIndex = s;
+            info.materialIndex = sec.materialIndex;
+            info.materialFlags = materialFlags;
+            infos.push_back(info);
+
+            Aabb b;
+            b.Grow(p0);
+            b.Grow(p1);
+            b.Grow(p2);
+            bounds.push_back(b);
+            centroids.push_back({
+                (p0.x + p1.x + p2.x) / 3.0f,
+                (p0.y + p1.y + p2.y) / 3.0f,
+                (p0.z + p1.z + p2.z) / 3.0f });
+        }
+    }
+
+    if (triangles.empty()) {
+        return true;
+    }
+
+    const uint32_t triCount = static_cast<uint32_t>(triangles.size());
+    std::vector<uint32_t> order(triCount);
+    for (uint32_t i = 0; i < triCount; ++i) order[i] = i;
+
+    auto& nodes = outRaycaster.m_nodes;
+    nodes.reserve(static_cast<size_t>(triCount) * 2);
+    nodes.emplace_back();
+    nodes[0].leftOrFirst = 0;
+    nodes[0].count = triCount;
+
+    std::vector<BuildItem> stack;
+    stack.push_back({ 0, 1 });
+    uint32_t maxDepth = 1;
+
+    while (!stack.empty()) {
+        const BuildItem item = stack.back();
+        stack.pop_back();
+
+        const uint32_t first = nodes[item.node].leftOrFirst;
+        const uint32_t count = nodes[item.node].count;
+
+        Aabb nodeBounds;
+        Aabb centroidBounds;
+        for (uint32_t i = first; i < first + count; ++i) {
+            nodeBounds.Grow(bounds[order[i]]);
+            centroidBounds.Grow(centroids[order[i]]);
+        }
+        nodes[item.node].boundsMin = nodeBounds.vmin;
+        nodes[item.node].boundsMax = nodeBounds.vmax;
+        maxDepth = std::max(maxDepth, item.depth);
+
+        if (count <= kLeafTriangles) continue;
+
+        // Binned SAH over centroid bounds.
+        int bestAxis = -1;
+        uint32_t bestSplit = 0;
+        float bestCost = nodeBounds.Area() * static_cast<float>(count);
+        for (int axis = 0; axis < 3; ++axis) {
+            const float lo = Axis(centroidBounds.vmin, axis);
+            const float hi = Axis(centroidBounds.vmax, axis);
+            if (hi - lo <= 0.0f) continue;
+
+            std::array<Aabb, kSahBins> binBounds;
+            std::array<uint32_t, kSahBins> binCount{};
+            const float scale = static_cast<float>(kSahBins) / (hi - lo);
+            for (uint32_t i = first; i < first + count; ++i) {
+                const uint32_t b = std::min(kSahBins - 1, static_cast<uint32_t>((Axis(centroids[order[i]], axis) - lo) * scale));
+                binBounds[b].Grow(bounds[order[i]]);
+                ++binCount[b];
+            }
+
+            std::array<float, kSahBins - 1> leftArea{};
+            std::array<uint32_t, kSahBins - 1> leftCount{};
+            Aabb acc;
+            uint32_t accCount = 0;
+            for (uint32_t b = 0; b + 1 < kSahBins; ++b) {
+                acc.Grow(binBounds[b]);
+                accCount += binCount[b];
+                leftArea[b] = acc.Area();
+                leftCount[b] = accCount;
+            }
+
+            acc = Aabb{};
+            accCount = 0;
+            for (uint32_t b = kSahBins - 1; b > 0; --b) {
+                acc.Grow(binBounds[b]);
+                accCount += binCount[b];
+                if (leftCount[b - 1] == 0 || accCount == 0) continue;
+                const float cost = leftArea[b - 1] * static_cast<float>(leftCount[b - 1]) + acc.Area() * static_cast<float>(accCount);
+                if (cost < bestCost) {
+                    bestCost = cost;
+                    bestAxis = axis;
+                    bestSplit = b;
+                }
+            }
+        }
+
+        if (bestAxis < 0) continue;
+
+        const float lo = Axis(centroidBounds.vmin, bestAxis);
+        const float scale = static_cast<float>(kSahBins) / (Axis(centroidBounds.vmax, bestAxis) - lo);
+        const auto mid = std::partition(order.begin() + first, order.begin() + first + count, [&](uint32_t tri) {
+            const uint32_t b = std::min(kSahBins - 1, static_cast<uint32_t>((Axis(centroids[tri], bestAxis) - lo) * scale));
+            return b < bestSplit;
+        });
+        const uint32_t leftCount = static_cast<uint32_t>(mid - (order.begin() + first));
+        if (leftCount == 0 || leftCount == count) continue;
+
+        const uint32_t left = static_cast<uint32_t>(nodes.size());
+        nodes.emplace_back();
+        nodes.emplace_back();
+        nodes[left].leftOrFirst = first;
+        nodes[left].count = leftCount;
+        nodes[left + 1].leftOrFirst = first + leftCount;
+        nodes[left + 1].count = count - leftCount;
+        nodes[item.node].leftOrFirst = left;
+        nodes[item.node].count = 0;
+
+        stack.push_back({ left + 1, item.depth + 1 });
+        stack.push_back({ left, item.depth + 1 });
+    }
+
+    outRaycaster.m_triangles.resize(triCount);
+    outRaycaster.m_triangleInfo.resize(triCount);
+    for (uint32_t i = 0; i < triCount; ++i) {
+        outRaycaster.m_triangles[i] = triangles[order[i]];
+        outRaycaster.m_triangleInfo[i] = infos[order[i]];
+    }
+    outRaycaster.m_nodes.shrink_to_fit();
+    outRaycaster.m_maxDepth = maxDepth;
+    return true;
+}
+
+void SceneRaycaster::Clear() {
+    m_nodes.clear();
+    m_triangles.clear();
+    m_triangleInfo.clear();
+    m_maxDepth = 0;
+}
+
+void SceneRaycaster::FillHit(const SceneRay& ray, uint32_t triangle, float distance, SceneRayHit& outHit) const {
+    const Triangle& tri = m_triangles[triangle];
+    const TriangleInfo& info = m_triangleInfo[triangle];
+
+    outHit.hit = true;
+    outHit.distance = distance;
+    outHit.position = {
+        ray.origin.x + ray.direction.x * distance,
+        ray.origin.y + ray.direction.y * distance,
+        ray.origin.z + ray.direction.z * distance };
+
+    XMVECTOR n = XMVector3Cross(XMLoadFloat3(&tri.e1), XMLoadFloat3(&tri.e2));
+    n = XMVector3Normalize(n);
+    if (XMVectorGetX(XMVector3Dot(n, XMLoadFloat3(&ray.direction))) > 0.0f) {
+        n = XMVectorNegate(n);
+    }
+    XMStoreFloat3(&outHit.normal, n);
+
+    outHit.triangleIndex = info.sourceTriangle;
+    outHit.sectionIndex = info.sectionIndex;
+    outHit.materialIndex = info.materialIndex;
+    outHit.materialFlags = info.materialFlags;
+}
+
+bool SceneRaycaster::Raycast(const SceneRay& ray, SceneRayHit& outHit) const {
+    outHit = SceneRayHit{};
+    if (m_nodes.empty()) return false;
+
+    const XMFLOAT3& o = ray.origin;
+    const XMFLOAT3& d = ray.direction;
+    const XMFLOAT3 invDir = { SafeInverse(d.x), SafeInverse(d.y), SafeInverse(d.z) };
+
+    float best = ray.maxDistance;
+    uint32_t bestTri = UINT32_MAX;
+
+    std::array<TraceItem, kInlineTraceStack> inlineStack;
+    std::vector<TraceItem> heapStack;
+    TraceItem* stack = inlineStack.data();
+    if (m_maxDepth + 1 > kInlineTraceStack) {
+        heapStack.resize(m_maxDepth + 1);
+        stack = heapStack.data();
+    }
+
+    size_t top = 0;
+    const float rootDist = IntersectBounds(o, invDir, m_nodes[0].boundsMin, m_nodes[0].boundsMax, best);
+    if (rootDist != FLT_MAX) {
+        stack[top++] = { 0, rootDist };
+    }
+
+    while (top > 0) {
+        const TraceItem item = stack[--top];
+        if (item.distance >= best) continue;
+
+        uint32_t nodeIndex = item.node;
+        for (;;) {
+            const Node& node = m_nodes[nodeIndex];
+            if (node.count > 0) {
+                for (uint32_t i = node.leftOrFirst; i < node.leftOrFirst + node.count; ++i) {
+                    const Triangle& tri = m_triangles[i];
+                    const XMFLOAT3 p = { d.y * tri.e2.z - d.z * tri.e2.y, d.z * tri.e2.x - d.x * tri.e2.z, d.x * tri.e2.y - d.y * tri.e2.x };
+                    const float det = tri.e1.x * p.x + tri.e1.y * p.y + tri.e1.z * p.z;
+                    if (std::fabs(det) < kDetEpsilon) continue;
+                    const float invDet = 1.0f / det;
+                    const XMFLOAT3 tv = { o.x - tri.v0.x, o.y - tri.v0.y, o.z - tri.v0.z };
+                    const float u = (tv.x * p.x + tv.y * p.y + tv.z * p.z) * invDet;
+                    if (u < 0.0f || u > 1.0f) continue;
+                    const XMFLOAT3 q = { tv.y * tri.e1.z - tv.z * tri.e1.y, tv.z * tri.e1.x - tv.x * tri.e1.z, tv.x * tri.e1.y - tv.y * tri.e1.x };
+                    const float v = (d.x * q.x + d.y * q.y + d.z * q.z) * invDet;
+                    if (v < 0.0f || u + v > 1.0f) continue;
+                    const float t = (tri.e2.x * q.x + tri.e2.y * q.y + tri.e2.z * q.z) * invDet;
+                    if (t > kHitEpsilon && t < best) {
+                        best = t;
+                        bestTri = i;
+                    }
+                }
+                break;
+            }
+
+            uint32_t nearChild = node.leftOrFirst;
+            uint32_t farChild = node.leftOrFirst + 1;
+            float nearDist = IntersectBounds(o, invDir, m_nodes[nearChild].boundsMin, m_nodes[nearChild].boundsMax, best);
+            float farDist = IntersectBounds(o, invDir, m_nodes[farChild].boundsMin, m_nodes[farChild].boundsMax, best);
+            if (farDist < nearDist) {
+                std::swap(nearChild, farChild);
+                std::swap(nearDist, farDist);
+            }
+            if (nearDist == FLT_MAX) break;
+            if (farDist != FLT_MAX) {
+                stack[top++] = { farChild, farDist };
+            }
+            nodeIndex = nearChild;
+        }
+    }
+
+    if (bestTri == UINT32_MAX) return false;
+    FillHit(ray, bestTri, best, outHit);
+    return true;
+}
+
+void SceneRaycaster::TracePacket(const SceneRay* rays, uint32_t laneCount, SceneRayHit* outHits) const {
+    XMFLOAT4A ox, oy, oz, dx, dy, dz, ix, iy, iz, tmax;
+    float* lanes[] = { &ox.x, &oy.x, &oz.x, &dx.x, &dy.x, &dz.x, &ix.x, &iy.x, &iz.x, &tmax.x };
+    for (uint32_t lane = 0; lane < kPacketSize; ++lane) {
+        // Unused lanes get a negative range so every test rejects them.
+        const SceneRay& ray = rays[std::min(lane, laneCount - 1)];
+        const bool active = lane < laneCount;
+        lanes[0][lane] = ray.origin.x;
+        lanes[1][lane] = ray.origin.y;
+        lanes[2][lane] = ray.origin.z;
+        lanes[3][lane] = ray.direction.x;
+        lanes[4][lane] = ray.direction.y;
+        lanes[5][lane] = ray.direction.z;
+        lanes[6][lane] = SafeInverse(ray.direction.x);
+        lanes[7][lane] = SafeInverse(ray.direction.y);
+        lanes[8][lane] = SafeInverse(ray.direction.z);
+        lanes[9][lane] = active ? ray.maxDistance : -1.0f;
+    }
+
+    const XMVECTOR vox = XMLoadFloat4A(&ox), voy = XMLoadFloat4A(&oy), voz = XMLoadFloat4A(&oz);
+    const XMVECTOR vdx = XMLoadFloat4A(&dx), vdy = XMLoadFloat4A(&dy), vdz = XMLoadFloat4A(&dz);
+    const XMVECTOR vix = XMLoadFloat4A(&ix), viy = XMLoadFloat4A(&iy), viz = XMLoadFloat4A(&iz);
+    const XMVECTOR zero = XMVectorZero();
+    const XMVECTOR one = XMVectorSplatOne();
+    const XMVECTOR hitEps = XMVectorReplicate(kHitEpsilon);
+    const XMVECTOR detEps = XMVectorReplicate(kDetEpsilon);
+    XMVECTOR best = XMLoadFloat4A(&tmax);
+    XMVECTOR bestTri = XMVectorReplicateInt(UINT32_MAX);
+
+    const auto boundsMask = [&](const Node& node) {
+        const XMVECTOR tx1 = XMVectorMultiply(XMVectorSubtract(XMVectorReplicate(node.boundsMin.x), vox), vix);
+        const XMVECTOR tx2 = XMVectorMultiply(XMVectorSubtract(XMVectorReplicate(node.boundsMax.x), vox), vix);
+        const XMVECTOR ty1 = XMVectorMultiply(XMVectorSubtract(XMVectorReplicate(node.boundsMin.y), voy), viy);
+        const XMVECTOR ty2 = XMVectorMultiply(XMVectorSubtract(XMVectorReplicate(node.boundsMax.y), voy), viy);
+        const XMVECTOR tz1 = XMVectorMultiply(XMVectorSubtract(XMVectorReplicate(node.boundsMin.z), voz), viz);
+        const XMVECTOR tz2 = XMVectorMultiply(XMVectorSubtract(XMVectorReplicate(node.boundsMax.z), voz), viz);
+        XMVECTOR tmin = XMVectorMax(XMVectorMin(tx1, tx2), XMVectorMin(ty1, ty2));
+        tmin = XMVectorMax(tmin, XMVectorMax(XMVectorMin(tz1, tz2), zero));
+        XMVECTOR tfar = XMVectorMin(XMVectorMax(tx1, tx2), XMVectorMax(ty1, ty2));
+        tfar = XMVectorMin(tfar, XMVectorMin(XMVectorMax(tz1, tz2), best));
+        return XMVectorLessOrEqual(tmin, tfar);
+    };
+
+    const auto anyLane = [](FXMVECTOR mask) {
+        return XMVector4NotEqualInt(mask, XMVectorFalseInt());
+    };
+
+    std::array<uint32_t, kInlineTraceStack> inlineStack;
+    std::vector<uint32_t> heapStack;
+    uint32_t* stack = inlineStack.data();
+    if (m_maxDepth + 1 > kInlineTraceStack) {
+        heapStack.resize(m_maxDepth + 1);
+        stack = heapStack.data();
+    }
+
+    size_t top = 0;
+    stack[top++] = 0;
+    while (top > 0) {
+        const Node& node = m_nodes[stack[--top]];
+        if (!anyLane(boundsMask(node))) continue;
+
+        if (node.count == 0) {
+            stack[top++] = node.leftOrFirst + 1;
+            stack[top++] = node.leftOrFirst;
+            continue;
+        }
+
+        for (uint32_t i = node.leftOrFirst; i < node.leftOrFirst + node.count; ++i) {
+            const Triangle& tri = m_triangles[i];
+            const XMVECTOR e1x = XMVectorReplicate(tri.e1.x), e1y = XMVectorReplicate(tri.e1.y), e1z = XMVectorReplicate(tri.e1.z);
+            const XMVECTOR e2x = XMVectorReplicate(tri.e2.x), e2y = XMVectorReplicate(tri.e2.y), e2z = XMVectorReplicate(tri.e2.z);
+
+            const XMVECTOR px = XMVectorNegativeMultiplySubtract(vdz, e2y, XMVectorMultiply(vdy, e2z));
+            const XMVECTOR py = XMVectorNegativeMultiplySubtract(vdx, e2z, XMVectorMultiply(vdz, e2x));
+            const XMVECTOR pz = XMVectorNegativeMultiplySubtract(vdy, e2x, XMVectorMultiply(vdx, e2y));
+            const XMVECTOR det = XMVectorMultiplyAdd(e1x, px, XMVectorMultiplyAdd(e1y, py, XMVectorMultiply(e1z, pz)));
+            const XMVECTOR invDet = XMVectorReciprocal(det);
+
+            const XMVECTOR tx = XMVectorSubtract(vox, XMVectorReplicate(tri.v0.x));
+            const XMVECTOR ty = XMVectorSubtract(voy, XMVectorReplicate(tri.v0.y));
+            const XMVECTOR tz = XMVectorSubtract(voz, XMVectorReplicate(tri.v0.z));
+            const XMVECTOR u = XMVectorMultiply(XMVectorMultiplyAdd(tx, px, XMVectorMultiplyAdd(ty, py, XMVectorMultiply(tz, pz))), invDet);
+
+            const XMVECTOR qx = XMVectorNegativeMultiplySubtract(tz, e1y, XMVectorMultiply(ty, e1z));
+            const XMVECTOR qy = XMVectorNegativeMultiplySubtract(tx, e1z, XMVectorMultiply(tz, e1x));
+            const XMVECTOR qz = XMVectorNegativeMultiplySubtract(ty, e1x, XMVectorMultiply(tx, e1y));
+            const XMVECTOR v = XMVectorMultiply(XMVectorMultiplyAdd(vdx, qx, XMVectorMultiplyAdd(vdy, qy, XMVectorMultiply(vdz, qz))), invDet);
+            const XMVECTOR t = XMVectorMultiply(XMVectorMultiplyAdd(e2x, qx, XMVectorMultiplyAdd(e2y, qy, XMVectorMultiply(e2z, qz))), invDet);
+
+            XMVECTOR mask = XMVectorGreater(XMVectorAbs(det), detEps);
+            mask = XMVectorAndInt(mask, XMVectorGreaterOrEqual(u, zero));
+            mask = XMVectorAndInt(mask, XMVectorGreaterOrEqual(v, zero));
+            mask = XMVectorAndInt(mask, XMVectorLessOrEqual(XMVectorAdd(u, v), one));
+            mask = XMVectorAndInt(mask, XMVectorGreater(t, hitEps));
+            mask = XMVectorAndInt(mask, XMVectorLess(t, best));
+
+            best = XMVectorSelect(best, t, mask);
+            bestTri = XMVectorSelect(bestTri, XMVectorReplicateInt(i), mask);
+        }
+    }
+
+    XMFLOAT4A bestOut;
+    XMStoreFloat4A(&bestOut, best);
+    uint32_t triOut[4];
+    XMStoreInt4(triOut, bestTri);
+    const float* bestLanes = &bestOut.x;
+
+    for (uint32_t lane = 0; lane < laneCount; ++lane) {
+        outHits[lane] = SceneRayHit{};
+        if (triOut[lane] != UINT32_MAX) {
+            FillHit(rays[lane], triOut[lane], bestLanes[lane], outHits[lane]);
+        }
+    }
+}
+
+uint32_t SceneRaycaster::RaycastBatch(const SceneRay* rays, uint32_t rayCount, SceneRayHit* outHits) const {
+    if (!rays || !outHits) return 0;
+
+    if (m_nodes.empty()) {
+        for (uint32_t i = 0; i < rayCount; ++i) outHits[i] = SceneRayHit{};
+        return 0;
+    }
+
+    uint32_t hits = 0;
+    for (uint32_t base = 0; base < rayCount; base += kPacketSize) {
+        const uint32_t lanes = std::min(kPacketSize, rayCount - base);
+        TracePacket(rays + base, lanes, outHits + base);
+        for (uint32_t lane = 0; lane < lanes; ++lane) {
+            if (outHits[base + lane].hit) ++hits;
+        }
+    }
+    return hits;
+}
+
+} // namespace RealSpace3
@@ -0,0 +1,203 @@
+#include "../Include/TextureDirectoryIndex.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <system_error>
+#include <utility>
+
+namespace RealSpace3 {
+namespace {
+
+namespace fs = std::filesystem;
+
+void SetError(std::string* outError, const std::string& message) {
+    if (outError) *outError = message;
+}
+
+std::string ParentOf(const std::string& path) {
+    const size_t slash = path.find_last_of('/');
+    return slash == std::string::npos ? std::string() : path.substr(0, slash);
+}
+
+} // namespace
+
+std::string TextureDirectoryIndex::Normalize(const std::string& path) {
+    std::string normalized;
+    normalized.reserve(path.size());
+    for (char c : path) {
+        if (c == '\\') c = '/';
+        if (c == '/' && !normalized.empty() && normalized.back() == '/') continue;
+        if (c >= 'A' && c <= 'Z') c = static_cast<char>(c - 'A' + 'a');
+        normalized.push_back(c);
+    }
+
+    // Collapse "." and ".." segments: "root/a/../../x.dds" names a file outside root and must
+    // not be answered from root's index. ".." that climbs above the start of a relative path is
+    // kept; above "/" it is dropped, as the OS does.
+    const bool absolute = !normalized.empty() && normalized[0] == '/';
+    std::vector<std::string> segments;
+    size_t start = absolute ? 1 : 0;
+    while (start <= normalized.size()) {
+        size_t end = normalized.find('/', start);
+        if (end == std::string::npos) end = normalized.size();
+        std::string segment = normalized.substr(start, end - start);
+        if (segment == "..") {
+            if (!segments.empty() && segments.back() != "..") {
+                segments.pop_back();
+            } else if (!absolute) {
+                segments.push_back(std::move(segment));
+            }
+        } else if (!segment.empty() && segment != ".") {
+            segments.push_back(std::move(segment));
+        }
+        start = end + 1;
+    }
+
+    std::string collapsed = absolute ? "/" : "";
+    for (size_t i = 0; i < segments.size(); ++i) {
+        if (i > 0) collapsed.push_back('/');
+        collapsed += segments[i];
+    }
+    if (collapsed.empty() && !normalized.empty()) collapsed = ".";
+    return collapsed;
+}
+
+bool TextureDirectoryIndex::AddRoot(const std::string& root, std::string* outError) {
+    const std::string rootKey = Normalize(root);
+    if (rootKey.empty()) {
+        SetError(outError, "Texture index root is empty.");
+        return false;
+    }
+
+    // Walk (or read the package list) without holding the lock; workers keep resolving meanwhile.
+    std::vector<std::pair<std::string, std::string>> files;
+    std::ifstream packageIndex(root + "/" + kPackageIndexFileName);
+    if (packageIndex.is_open()) {
+        std::string line;
+        std::getline(packageIndex, line);
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        if (line != kPackageIndexHeader) {
+            SetError(outError, std::string("Unexpected header in ") + kPackageIndexFileName + " under " + root + ".");
+            return false;
+        }
+        while (std::getline(packageIndex, line)) {
+            if (!line.empty() && line.back() == '\r') line.pop_back();
+            if (line.empty()) continue;
+            const std::string actual = root + "/" + line;
+            files.emplace_back(Normalize(actual), actual);
+        }
+    } else {
+        std::error_code ec;
+        if (!fs::is_directory(root, ec)) {
+            SetError(outError, "Texture index root is not a directory: " + root);
+            return false;
+        }
+        fs::recursive_directory_iterator it(root, fs::directory_options::skip_permission_denied, ec);
+        for (const fs::recursive_directory_iterator end; !ec && it != end; it.increment(ec)) {
+            std::error_code fileEc;
+            if (!it->is_regular_file(fileEc)) continue;
+            try {
+                files.emplace_back(Normalize(it->path().generic_string()), it->path().string());
+            } catch (const std::exception&) {
+                // Name not representable in the narrow code page; nothing could request it anyway
+            }
+        }
+        if (ec) {
+            SetError(outError, "Failed to index " + root + ": " + ec.message());
+            return false;
+        }
+    }
+
+    std::unique_lock<std::shared_mutex> lock(m_mutex);
+    for (auto& file : files) {
+        m_files.emplace(std::move(file.first), std::move(file.second));
+    }
+    if (std::find(m_roots.begin(), m_roots.end(), rootKey) == m_roots.end()) {
+        m_roots.push_back(rootKey);
+    }
+    return true;
+}
+
+bool TextureDirectoryIndex::HasRoot(const std::string& root) const {
+    const std::string rootKey = Normalize(root);
+    std::shared_lock<std::shared_mutex> lock(m_mutex);
+    return std::find(m_roots.begin(), m_roots.end(), rootKey) != m_roots.end();
+}
+
+bool TextureDirectoryIndex::Resolve(const std::string& path, std::string& outActualPath) {
+    const std::string key = Normalize(path);
+    if (key.empty()) return false;
+    const std::string directoryKey = ParentOf(key);
+
+    {
+        std::shared_lock<std::shared_mutex> lock(m_mutex);
+        auto it = m_files.find(key);
+        if (it != m_files.end()) {
+            outActualPath = it->second;
+            return true;
+        }
+        if (IsCoveredLocked(directoryKey)) return false;
+    }
+
+    // First lookup in an unindexed directory: list it once. Readers wait for this
+    // single listing instead of each probing the same directory.
+    std::unique_lock<std::shared_mutex> lock(m_mutex);
+    if (!IsCoveredLocked(directoryKey)) {
+        std::string directory = path;
+        std::replace(directory.begin(), directory.end(), '\\', '/');
+        ListDirectoryLocked(directoryKey, ParentOf(directory));
+    }
+    auto it = m_files.find(key);
+    if (it == m_files.end()) return false;
+    outActualPath = it->second;
+    return true;
+}
+
+void TextureDirectoryIndex::Clear() {
+    std::unique_lock<std::shared_mutex> lock(m_mutex);
+    m_files.clear();
+    m_roots.clear();
+    m_listedDirectories.clear();
+}
+
+size_t TextureDirectoryIndex::GetFileCount() const {
+    std::shared_lock<std::shared_mutex> lock(m_mutex);
+    return m_files.size();
+}
+
+size_t TextureDirectoryIndex::GetListedDirectoryCount() const {
+    std::shared_lock<std::shared_mutex> lock(m_mutex);
+    return m_listedDirectories.size();
+}
+
+bool TextureDirectoryIndex::IsCoveredLocked(const std::string& normalizedDirectory) const {
+    if (m_listedDirectories.count(normalizedDirectory) != 0) return true;
+    for (const std::string& root : m_roots) {
+        if (normalizedDirectory.size() < root.size() || normalizedDirectory.compare(0, root.size(), root) != 0) continue;
+        if (normalizedDirectory.size() == root.size() || normalizedDirectory[root.size()] == '/') return true;
+    }
+    return false;
+}
+
+void TextureDirectoryIndex::ListDirectoryLocked(const std::string& normalizedDirectory, const std::string& directory) {
+    // Recorded even when the directory is missing, so later misses in it stay off the disk
+    m_listedDirectories.insert(normalizedDirectory);
+
+    std::error_code ec;
+    fs::directory_iterator it(directory.empty() ? fs::path(".") : fs::path(directory), fs::directory_options::skip_permission_denied, ec);
+    for (const fs::directory_iterator end; !ec && it != end; it.increment(ec)) {
+        std::error_code fileEc;
+        if (!it->is_regular_file(fileEc)) continue;
+        try {
+            const std::string name = it->path().filename().string();
+            const std::string actual = directory.empty() ? name : directory + "/" + name;
+            m_files.emplace(Normalize(actual), actual);
+        } catch (const std::exception&) {
+            // Skipped, as in AddRoot
+        }
+    }
+}
+
+} // namespace RealSpace3
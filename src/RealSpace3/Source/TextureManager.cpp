@@ -2,9 +2,12 @@
 #define NOMINMAX
 #endif
 #include "../Include/TextureManager.h"
+#include "../Include/AssetFileSystem.h"
 #include "../Include/DDSLoader.h"
+#include "../Include/LoadProfiler.h"
 #include "AppLogger.h"
 #include <algorithm>
+#include <fstream>
 #include <vector>
 #include <wincodec.h>
 #include <windows.h>
@@ -12,12 +15,25 @@
 #pragma comment(lib, "windowscodecs.lib")
 
 namespace RealSpace3 {
+namespace {
+
+// CreateFromDecoded takes the default view for non-cube textures, which is a 2D array when there are several slices
+bool IsArrayView(const DecodedTexture& texture) {
+    return !texture.isCubemap && texture.arraySize > 1;
+}
+
+} // namespace
 
 TextureManager::TextureManager(ID3D11Device* device) : m_pd3dDevice(device) {
     CreateDefaultTextures();
+    m_missingTexture = std::make_shared<TextureSlot>();
+    m_missingTexture->srv = m_fallbackSRV;
+    m_missingTexture->state = TextureLoadState::Missing;
+    StartWorkers();
 }
 
 TextureManager::~TextureManager() {
+    StopWorkers();
     Clear();
 }
 
@@ -59,47 +75,35 @@ void TextureManager::CreateDefaultTextures() {
     m_pd3dDevice->CreateShaderResourceView(texW.Get(), nullptr, &m_whiteSRV);
 }
 
-bool TextureManager::TryLoadTexture(const std::string& path, Microsoft::WRL::ComPtr<ID3D11ShaderResourceView>& outSRV) {
-    std::wstring wpath = ToWide(path);
-    
-    // Check if file exists
-    DWORD attrs = GetFileAttributesW(wpath.c_str());
-    if (attrs == INVALID_FILE_ATTRIBUTES) return false;
-    
-    HRESULT hr = DDSLoader::LoadFromFile(m_pd3dDevice, wpath, outSRV);
-    if (SUCCEEDED(hr) && outSRV) {
-        return true;
+bool TextureManager::TryDecodeTexture(const std::string& path, DecodedTexture& outTexture) {
+    // Same as DDSLoader::DecodeFromFile, split so the trace shows read and decode separately
+    std::vector<uint8_t> bytes;
+    {
+        LoadScope readScope(LoadStage::Read, path);
+        std::ifstream file(ToWide(path), std::ios::binary | std::ios::ate);
+        if (!file.is_open()) return false;
+        const std::streamoff size = file.tellg();
+        if (size < static_cast<std::streamoff>(sizeof(uint32_t))) return false;
+        bytes.resize(static_cast<size_t>(size));
+        file.seekg(0, std::ios::beg);
+        file.read(reinterpret_cast<char*>(bytes.data()), size);
+        if (!file.good()) return false;
+        readScope.AddBytes(bytes.size());
     }
-    return false;
-}
 
-Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> TextureManager::CreateTextureFromMemory(const uint8_t* data, size_t size) {
-    // TODO: Implement from-memory loading if needed
-    return m_whiteSRV;
+    LoadScope decodeScope(LoadStage::Decode, path);
+    decodeScope.AddBytes(bytes.size());
+    return SUCCEEDED(DDSLoader::DecodeFromMemory(bytes.data(), bytes.size(), outTexture));
 }
 
-Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> TextureManager::GetTexture(const std::string& path) {
-    if (path.empty()) return m_fallbackSRV;
-    
-    std::string key = NormalizePath(path);
-    
-    // Check cache
-    auto it = m_textureCache.find(key);
-    if (it != m_textureCache.end()) return it->second;
-    
-    // Build list of candidates
+std::vector<std::string> TextureManager::BuildCandidates(const std::string& path, const std::string& baseDirectory) {
     std::vector<std::string> candidates;
-    Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> srv;
-    
+
     // Strategy 0: Direct path as provided (relative to app root)
-    if (TryLoadTexture(path, srv)) {
-        AppLogger::Log("[TextureManager] Loaded (Direct): " + path);
-        m_textureCache[key] = srv;
-        return srv;
-    }
+    candidates.push_back(path);
     candidates.push_back(path + ".dds");
 
-    std::string fullPath = m_baseDirectory.empty() ? path : (m_baseDirectory + "/" + path);
+    std::string fullPath = baseDirectory.empty() ? path : (baseDirectory + "/" + path);
     // Strategy 1: Map-relative path (e.g., "Maps/mansion/texture.bmp")
     candidates.push_back(fullPath);
     candidates.push_back(fullPath + ".dds");
@@ -108,27 +112,350 @@ Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> TextureManager::GetTexture(cons
     std::string filename = path;
     auto lastSlash = filename.find_last_of("/\\");
     if (lastSlash != std::string::npos) filename = filename.substr(lastSlash + 1);
+    if (!baseDirectory.empty()) {
+        candidates.push_back(baseDirectory + "/" + filename);
+        candidates.push_back(baseDirectory + "/" + filename + ".dds");
+    }
+    return candidates;
+}
+
+bool TextureManager::ResolveAndDecode(const std::string& path, const std::string& baseDirectory, std::string& outResolved, DecodedTexture& outTexture) {
+    for (const auto& candidate : BuildCandidates(path, baseDirectory)) {
+        if (AssetFileSystem::IsVirtualPath(candidate)) {
+            // Packed package: the pack TOC answers existence; surfaces are referenced, not copied.
+            AssetView view;
+            if (!AssetFileSystem::getInstance().Open(candidate, view)) continue;
+            LoadScope decodeScope(LoadStage::Decode, candidate);
+            decodeScope.AddBytes(view.size);
+            if (SUCCEEDED(DDSLoader::DecodeFromMemory(view.data, view.size, outTexture, true))) {
+                if (outTexture.externalData) outTexture.externalOwner = view.owner;
+                outResolved = candidate;
+                return true;
+            }
+            continue;
+        }
+
+        // Existence comes from the directory index; only files that exist are opened.
+        std::string actual;
+        LoadScope resolveScope(LoadStage::Resolve, candidate);
+        const bool found = m_directoryIndex.Resolve(candidate, actual);
+        resolveScope.End();
+        if (!found) continue;
+        if (TryDecodeTexture(actual, outTexture)) {
+            outResolved = actual;
+            return true;
+        }
+    }
+    return false;
+}
+
+void TextureManager::SetBaseDirectory(const std::string& dir) {
+    m_baseDirectory = dir;
+    if (dir.empty() || AssetFileSystem::IsVirtualPath(dir) || m_directoryIndex.HasRoot(dir)) return;
+
+    const size_t before = m_directoryIndex.GetFileCount();
+    std::string error;
+    if (!m_directoryIndex.AddRoot(dir, &error)) {
+        // Lookups still work; directories are then listed lazily on first use
+        AppLogger::Log("[TextureManager] Directory index skipped: " + error);
+        return;
+    }
+    AppLogger::Log("[TextureManager] Indexed " + std::to_string(m_directoryIndex.GetFileCount() - before) + " files under " + dir);
+}
+
+void TextureManager::InvalidateDirectoryIndex() {
+    m_directoryIndex.Clear();
+    AssetFileSystem::getInstance().InvalidateLooseIndex();
+    m_missingKeys.clear();
     if (!m_baseDirectory.empty()) {
-        candidates.push_back(m_baseDirectory + "/" + filename);
-        candidates.push_back(m_baseDirectory + "/" + filename + ".dds");
+        const std::string dir = m_baseDirectory;
+        m_baseDirectory.clear();
+        SetBaseDirectory(dir);
     }
+}
+
+void TextureManager::RecordMiss(const std::string& key, const std::string& baseDirectory) {
+    m_missingKeys.insert(MakeMissKey(key, baseDirectory));
+    // Existing handles keep their Missing slot; new requests are answered from m_missingKeys.
+    m_textureCache.erase(key);
+}
+
+void TextureManager::ApplyResult(TextureSlot& slot, const std::string& path, const std::string& resolvedPath, const DecodedTexture* texture) {
+    Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> srv;
+    LoadScope uploadScope(LoadStage::Upload, resolvedPath.empty() ? path : resolvedPath);
+    if (texture) uploadScope.AddBytes(texture->GetSizeBytes());
+    const bool uploaded = texture && SUCCEEDED(DDSLoader::CreateFromDecoded(m_pd3dDevice, *texture, srv)) && srv;
+    uploadScope.End();
+    if (uploaded) {
+        AppLogger::Log(std::string("[TextureManager] Loaded") + (resolvedPath == path ? " (Direct)" : "") + ": " + resolvedPath);
+        slot.srv = srv;
+        slot.isArray = IsArrayView(*texture);
+        slot.state = TextureLoadState::Ready;
+        return;
+    }
+
+    // Failed to load — keep the fallback cached to avoid re-trying
+    AppLogger::Log("[TextureManager] MISS: " + path + " (tried " + std::to_string(BuildCandidates(path, m_baseDirectory).size()) + " paths)");
+    slot.srv = m_fallbackSRV;
+    slot.isArray = false;
+    slot.state = TextureLoadState::Missing;
+}
+
+Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> TextureManager::CreateTextureFromMemory(const uint8_t* data, size_t size) {
+    if (!data || size == 0) return m_fallbackSRV;
+
+    Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> srv;
+    const HRESULT hr = DDSLoader::CreateFromMemory(m_pd3dDevice, data, size, srv);
+    if (FAILED(hr) || !srv) {
+        AppLogger::Log("[TextureManager] CreateTextureFromMemory failed: " + std::to_string(size) + " bytes, hr=" + std::to_string(static_cast<long>(hr)));
+        return m_fallbackSRV;
+    }
+    return srv;
+}
+
+Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> TextureManager::GetTexture(const std::string& path) {
+    if (path.empty()) return m_fallbackSRV;
     
-    for (const auto& candidate : candidates) {
-        if (TryLoadTexture(candidate, srv)) {
-            AppLogger::Log("[TextureManager] Loaded: " + candidate);
-            m_textureCache[key] = srv;
-            return srv;
+    std::string key = NormalizePath(path);
+    if (m_missingKeys.count(MakeMissKey(key, m_baseDirectory)) != 0) return m_fallbackSRV;
+
+    // Check cache
+    auto it = m_textureCache.find(key);
+    if (it != m_textureCache.end() && it->second->state != TextureLoadState::Pending) return it->second->srv;
+
+    // A streamed request for the same key may still be queued; finish it here and
+    // let Update() discard the late worker result.
+    TextureHandle slot = (it != m_textureCache.end()) ? it->second : std::make_shared<TextureSlot>();
+    DecodedTexture texture;
+    std::string resolved;
+    const bool decoded = ResolveAndDecode(path, m_baseDirectory, resolved, texture);
+    ApplyResult(*slot, path, resolved, decoded ? &texture : nullptr);
+    m_textureCache[key] = slot;
+    if (!decoded) RecordMiss(key, m_baseDirectory);
+    return slot->srv;
+}
+
+TextureHandle TextureManager::RequestTexture(const std::string& path) {
+    if (path.empty()) {
+        auto missing = std::make_shared<TextureSlot>();
+        missing->srv = m_fallbackSRV;
+        missing->state = TextureLoadState::Missing;
+        return missing;
+    }
+
+    std::string key = NormalizePath(path);
+    if (m_missingKeys.count(MakeMissKey(key, m_baseDirectory)) != 0) return m_missingTexture;
+
+    auto it = m_textureCache.find(key);
+    if (it != m_textureCache.end()) return it->second;
+
+    auto slot = std::make_shared<TextureSlot>();
+    slot->srv = m_whiteSRV;
+    slot->state = TextureLoadState::Pending;
+    m_textureCache[key] = slot;
+    QueueJob(key, path, m_baseDirectory);
+    return slot;
+}
+
+void TextureManager::QueueJob(const std::string& key, const std::string& path, const std::string& baseDirectory) {
+    {
+        std::lock_guard<std::mutex> lock(m_streamMutex);
+        m_jobs.push_back({ key, path, baseDirectory, m_generation });
+    }
+    m_streamCv.notify_one();
+}
+
+void TextureManager::ApplyStreamResult(const TextureHandle& slot, StreamResult& result) {
+    if (!result.texture || result.texture->subresources.empty()) {
+        ApplyResult(*slot, result.path, result.resolvedPath, nullptr);
+        return;
+    }
+
+    const DecodedTexture& texture = *result.texture;
+    std::vector<TextureMipInfo> mips;
+    mips.reserve(texture.mipLevels);
+    for (uint32_t mip = 0; mip < texture.mipLevels; ++mip) {
+        TextureMipInfo info = { std::max<uint32_t>(1, texture.width >> mip), std::max<uint32_t>(1, texture.height >> mip), 0 };
+        for (uint32_t slice = 0; slice < texture.arraySize; ++slice) {
+            const size_t index = static_cast<size_t>(slice) * texture.mipLevels + mip;
+            if (index < texture.subresources.size()) info.bytes += texture.subresources[index].slicePitch;
         }
+        mips.push_back(info);
     }
-    
-    // Failed to load — cache the fallback to avoid re-trying
-    AppLogger::Log("[TextureManager] MISS: " + path + " (tried " + std::to_string(candidates.size()) + " paths)");
-    m_textureCache[key] = m_fallbackSRV;
-    return m_fallbackSRV;
+
+    const uint32_t id = m_nextResidencyId++;
+    m_resident[id] = { slot, result.key, result.path, result.baseDirectory, result.texture };
+    slot->residencyId = id;
+    slot->state = TextureLoadState::Ready;
+
+    // Register commits the mip tail; without VRAM room the placeholder stays until a later Update.
+    m_residency.Register(id, mips, m_frame);
+    if (slot->state == TextureLoadState::Missing) {
+        m_residency.Unregister(id);
+        m_resident.erase(id);
+        slot->residencyId = 0;
+        AppLogger::Log("[TextureManager] MISS: " + result.path + " (upload failed)");
+        return;
+    }
+    AppLogger::Log(std::string("[TextureManager] Loaded") + (result.resolvedPath == result.path ? " (Direct)" : "") + ": " + result.resolvedPath);
+}
+
+void TextureManager::MarkUsed(const TextureHandle& texture) {
+    if (!texture || texture->residencyId == 0) return;
+
+    const uint32_t id = texture->residencyId;
+    m_residency.Touch(id, m_frame);
+    if (!m_residency.NeedsReload(id)) return;
+
+    // Both copies were evicted while unused; decode again from disk.
+    auto it = m_resident.find(id);
+    if (it == m_resident.end()) return;
+    m_residency.Unregister(id);
+    texture->residencyId = 0;
+    texture->state = TextureLoadState::Pending;
+    texture->srv = m_whiteSRV;
+    texture->isArray = false;
+    QueueJob(it->second.key, it->second.path, it->second.baseDirectory);
+    m_resident.erase(it);
+}
+
+bool TextureManager::CommitMips(uint32_t textureId, uint32_t firstMip) {
+    auto it = m_resident.find(textureId);
+    if (it == m_resident.end() || !it->second.texture) return false;
+
+    Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> srv;
+    LoadScope uploadScope(LoadStage::Upload, it->second.path + " (mips " + std::to_string(firstMip) + "+)");
+    const size_t bytes = it->second.texture->GetSizeBytesFromMip(firstMip);
+    uploadScope.AddBytes(bytes);
+    const HRESULT hr = DDSLoader::CreateFromDecoded(m_pd3dDevice, *it->second.texture, srv, firstMip);
+    uploadScope.End();
+    if (FAILED(hr) || !srv) {
+        it->second.slot->srv = m_fallbackSRV;
+        it->second.slot->isArray = false;
+        it->second.slot->state = TextureLoadState::Missing;
+        return false;
+    }
+    m_uploadedBytes += bytes;
+    it->second.slot->srv = srv;
+    it->second.slot->isArray = IsArrayView(*it->second.texture);
+    return true;
+}
+
+void TextureManager::ReleaseGpu(uint32_t textureId) {
+    auto it = m_resident.find(textureId);
+    if (it == m_resident.end()) return;
+    it->second.slot->srv = m_whiteSRV;
+    it->second.slot->isArray = false;
+}
+
+void TextureManager::ReleaseCpu(uint32_t textureId) {
+    auto it = m_resident.find(textureId);
+    if (it != m_resident.end()) it->second.texture.reset();
+}
+
+void TextureManager::Update(uint64_t uploadBudgetBytes) {
+    ++m_frame;
+    m_uploadedBytes = 0;
+    for (;;) {
+        StreamResult result;
+        {
+            std::lock_guard<std::mutex> lock(m_streamMutex);
+            if (m_completed.empty()) break;
+            result = std::move(m_completed.front());
+            m_completed.pop_front();
+            if (result.generation != m_generation) continue;
+        }
+
+        auto it = m_textureCache.find(result.key);
+        if (it == m_textureCache.end() || it->second->state != TextureLoadState::Pending) continue;
+
+        ApplyStreamResult(it->second, result);
+        if (!result.texture) {
+            RecordMiss(result.key, result.baseDirectory);
+            continue;
+        }
+        // Register only committed the mip tail (or nothing, without VRAM room); refinements
+        // upload the rest later through CommitMips and are bounded by refinementsPerUpdate
+        if (m_uploadedBytes >= uploadBudgetBytes) break;
+    }
+
+    m_residency.Update(m_frame);
+}
+
+size_t TextureManager::GetPendingCount() const {
+    std::lock_guard<std::mutex> lock(m_streamMutex);
+    return m_jobs.size() + m_inFlight + m_completed.size();
+}
+
+void TextureManager::StartWorkers() {
+    const unsigned hw = std::thread::hardware_concurrency();
+    const size_t workerCount = std::max<size_t>(1, std::min<size_t>(4, hw / 2));
+    m_stopWorkers = false;
+    for (size_t i = 0; i < workerCount; ++i) {
+        m_workers.emplace_back([this]() { WorkerMain(); });
+    }
+}
+
+void TextureManager::StopWorkers() {
+    {
+        std::lock_guard<std::mutex> lock(m_streamMutex);
+        m_stopWorkers = true;
+        m_jobs.clear();
+    }
+    m_streamCv.notify_all();
+    for (auto& worker : m_workers) {
+        if (worker.joinable()) worker.join();
+    }
+    m_workers.clear();
+}
+
+void TextureManager::WorkerMain() {
+    // WIC decoding needs COM on this thread.
+    const HRESULT coHr = CoInitializeEx(nullptr, COINIT_MULTITHREADED);
+    LoadProfiler::getInstance().SetThreadName("TextureWorker");
+
+    for (;;) {
+        StreamJob job;
+        {
+            std::unique_lock<std::mutex> lock(m_streamMutex);
+            m_streamCv.wait(lock, [this]() { return m_stopWorkers || !m_jobs.empty(); });
+            if (m_stopWorkers) break;
+            job = std::move(m_jobs.front());
+            m_jobs.pop_front();
+            ++m_inFlight;
+        }
+
+        StreamResult result;
+        result.key = job.key;
+        result.path = job.path;
+        result.baseDirectory = job.baseDirectory;
+        result.generation = job.generation;
+        auto texture = std::make_shared<DecodedTexture>();
+        if (ResolveAndDecode(job.path, job.baseDirectory, result.resolvedPath, *texture)) {
+            result.texture = std::move(texture);
+        }
+
+        std::lock_guard<std::mutex> lock(m_streamMutex);
+        --m_inFlight;
+        if (job.generation == m_generation) {
+            m_completed.push_back(std::move(result));
+        }
+    }
+
+    if (SUCCEEDED(coHr)) CoUninitialize();
 }
 
 void TextureManager::Clear() {
+    {
+        std::lock_guard<std::mutex> lock(m_streamMutex);
+        ++m_generation;
+        m_jobs.clear();
+        m_completed.clear();
+    }
+    m_residency.Clear();
+    m_resident.clear();
     m_textureCache.clear();
+    m_missingKeys.clear();
 }
 
 }
@@ -0,0 +1,199 @@
+#include "../Include/TextureResidency.h"
+
+#include <algorithm>
+
+namespace RealSpace3 {
+namespace {
+
+uint64_t ProtectFrom(uint64_t frame) {
+    return frame > 0 ? frame - 1 : 0;
+}
+
+} // namespace
+
+bool TextureResidencyManager::Register(uint32_t textureId, const std::vector<TextureMipInfo>& mips, uint64_t frame) {
+    if (textureId == kNotResident) return false;
+    Unregister(textureId);
+
+    Entry& entry = m_entries[textureId];
+    entry.mips = mips;
+    entry.lastUsedFrame = frame;
+
+    entry.tailMip = mips.empty() ? 0 : static_cast<uint32_t>(mips.size() - 1);
+    for (uint32_t i = 0; i < mips.size(); ++i) {
+        if (std::max(mips[i].width, mips[i].height) <= m_budget.tailDimension) {
+            entry.tailMip = i;
+            break;
+        }
+    }
+
+    entry.ramBytes = BytesFrom(entry, 0);
+    entry.cpuResident = true;
+    m_ramUsage += entry.ramBytes;
+
+    bool committed = false;
+    if (!mips.empty() && MakeVramRoom(BytesFrom(entry, entry.tailMip), ProtectFrom(frame), textureId)) {
+        committed = Commit(textureId, entry, entry.tailMip);
+    }
+    EnforceRamBudget(ProtectFrom(frame));
+    return committed;
+}
+
+void TextureResidencyManager::Unregister(uint32_t textureId) {
+    auto it = m_entries.find(textureId);
+    if (it == m_entries.end()) return;
+    ReleaseGpu(textureId, it->second);
+    ReleaseCpu(textureId, it->second);
+    m_entries.erase(it);
+}
+
+void TextureResidencyManager::Touch(uint32_t textureId, uint64_t frame) {
+    auto it = m_entries.find(textureId);
+    if (it == m_entries.end()) return;
+    it->second.lastUsedFrame = std::max(it->second.lastUsedFrame, frame);
+}
+
+void TextureResidencyManager::Update(uint64_t frame) {
+    const uint64_t protectFrom = ProtectFrom(frame);
+
+    // Refine the most recently used textures one mip at a time.
+    std::vector<std::pair<uint64_t, uint32_t>> candidates;
+    for (const auto& kv : m_entries) {
+        const Entry& e = kv.second;
+        if (!e.cpuResident || e.mips.empty() || e.lastUsedFrame < protectFrom) continue;
+        if (e.firstResidentMip == 0) continue;
+        candidates.push_back({ e.lastUsedFrame, kv.first });
+    }
+    std::sort(candidates.begin(), candidates.end(), [](const auto& a, const auto& b) {
+        return a.first != b.first ? a.first > b.first : a.second < b.second;
+    });
+
+    uint32_t refinements = 0;
+    for (const auto& candidate : candidates) {
+        if (refinements >= m_budget.refinementsPerUpdate) break;
+        Entry& e = m_entries[candidate.second];
+        const uint32_t target = (e.firstResidentMip == kNotResident) ? e.tailMip : e.firstResidentMip - 1;
+        const uint64_t targetBytes = BytesFrom(e, target);
+        const uint64_t extra = targetBytes > e.vramBytes ? targetBytes - e.vramBytes : 0;
+        if (!MakeVramRoom(extra, protectFrom, candidate.second)) break;
+        if (Commit(candidate.second, e, target)) ++refinements;
+    }
+
+    // The budget may have been lowered since the last update.
+    (void)MakeVramRoom(0, protectFrom, kNotResident);
+    EnforceRamBudget(protectFrom);
+}
+
+void TextureResidencyManager::Clear() {
+    for (auto& kv : m_entries) {
+        ReleaseGpu(kv.first, kv.second);
+        ReleaseCpu(kv.first, kv.second);
+    }
+    m_entries.clear();
+    m_vramUsage = 0;
+    m_ramUsage = 0;
+}
+
+uint32_t TextureResidencyManager::GetFirstResidentMip(uint32_t textureId) const {
+    const auto it = m_entries.find(textureId);
+    return it == m_entries.end() ? kNotResident : it->second.firstResidentMip;
+}
+
+bool TextureResidencyManager::IsCpuResident(uint32_t textureId) const {
+    const auto it = m_entries.find(textureId);
+    return it != m_entries.end() && it->second.cpuResident;
+}
+
+bool TextureResidencyManager::NeedsReload(uint32_t textureId) const {
+    const auto it = m_entries.find(textureId);
+    if (it == m_entries.end()) return false;
+    return !it->second.cpuResident && it->second.firstResidentMip == kNotResident;
+}
+
+uint64_t TextureResidencyManager::BytesFrom(const Entry& entry, uint32_t firstMip) const {
+    uint64_t bytes = 0;
+    for (size_t i = firstMip; i < entry.mips.size(); ++i) bytes += entry.mips[i].bytes;
+    return bytes;
+}
+
+bool TextureResidencyManager::Commit(uint32_t textureId, Entry& entry, uint32_t firstMip) {
+    if (!entry.cpuResident || firstMip >= entry.mips.size()) return false;
+    if (!m_device.CommitMips(textureId, firstMip)) return false;
+
+    m_vramUsage -= entry.vramBytes;
+    entry.vramBytes = BytesFrom(entry, firstMip);
+    entry.firstResidentMip = firstMip;
+    m_vramUsage += entry.vramBytes;
+    return true;
+}
+
+void TextureResidencyManager::ReleaseGpu(uint32_t textureId, Entry& entry) {
+    if (entry.firstResidentMip == kNotResident) return;
+    m_device.ReleaseGpu(textureId);
+    m_vramUsage -= entry.vramBytes;
+    entry.vramBytes = 0;
+    entry.firstResidentMip = kNotResident;
+}
+
+void TextureResidencyManager::ReleaseCpu(uint32_t textureId, Entry& entry) {
+    if (!entry.cpuResident) return;
+    m_device.ReleaseCpu(textureId);
+    m_ramUsage -= entry.ramBytes;
+    entry.cpuResident = false;
+}
+
+bool TextureResidencyManager::MakeVramRoom(uint64_t extraBytes, uint64_t protectFromFrame, uint32_t keepId) {
+    while (m_vramUsage + extraBytes > m_budget.vramBytes) {
+        uint32_t victimId = kNotResident;
+        uint64_t victimFrame = UINT64_MAX;
+        for (const auto& kv : m_entries) {
+            const Entry& e = kv.second;
+            if (kv.first == keepId || e.firstResidentMip == kNotResident) continue;
+            if (e.lastUsedFrame >= protectFromFrame) continue;
+            if (e.lastUsedFrame < victimFrame || (e.lastUsedFrame == victimFrame && kv.first < victimId)) {
+                victimFrame = e.lastUsedFrame;
+                victimId = kv.first;
+            }
+        }
+        if (victimId == kNotResident) return false;
+
+        Entry& victim = m_entries[victimId];
+        // Demote to the mip tail first so the texture still has something to sample.
+        if (victim.firstResidentMip < victim.tailMip && Commit(victimId, victim, victim.tailMip)) {
+            continue;
+        }
+        ReleaseGpu(victimId, victim);
+    }
+    return true;
+}
+
+void TextureResidencyManager::EnforceRamBudget(uint64_t protectFromFrame) {
+    while (m_ramUsage > m_budget.ramBytes) {
+        // Fully refined textures no longer need their CPU copy; drop those first, then LRU.
+        uint32_t victimId = kNotResident;
+        bool victimRefined = false;
+        uint64_t victimFrame = UINT64_MAX;
+        for (const auto& kv : m_entries) {
+            const Entry& e = kv.second;
+            if (!e.cpuResident) continue;
+            const bool refined = e.firstResidentMip == 0;
+            const bool old = e.lastUsedFrame < protectFromFrame;
+            if (!refined && !old) continue;
+            const bool better = (refined && !victimRefined)
+                || (refined == victimRefined && (e.lastUsedFrame < victimFrame || (e.lastUsedFrame == victimFrame && kv.first < victimId)));
+            if (victimId == kNotResident || better) {
+                victimId = kv.first;
+                victimRefined = refined;
+                victimFrame = e.lastUsedFrame;
+            }
+        }
+        if (victimId == kNotResident) return;
+        Entry& victim = m_entries[victimId];
+        // Without its CPU copy a partially refined texture could never refine again; drop its
+        // GPU copy too so NeedsReload reports it and the next use decodes it from scratch.
+        if (!victimRefined) ReleaseGpu(victimId, victim);
+        ReleaseCpu(victimId, victim);
+    }
+}
+
+} // namespace RealSpace3
@@ -0,0 +1,159 @@
+#include "../Include/TimelineTracks.h"
+
+#include <algorithm>
+
+namespace RealSpace3 {
+namespace {
+
+constexpr float kEpsilon = 1e-6f;
+
+DirectX::XMFLOAT3 Lerp(const DirectX::XMFLOAT3& a, const DirectX::XMFLOAT3& b, float t) {
+    return {
+        a.x + (b.x - a.x) * t,
+        a.y + (b.y - a.y) * t,
+        a.z + (b.z - a.z) * t
+    };
+}
+
+float Lerp(float a, float b, float t) {
+    return a + (b - a) * t;
+}
+
+// Number of keys at or before time (0 = before the first key). cursor holds the previous
+// answer; the same span or the next one is the common case during playback.
+template <typename Key>
+uint32_t LocateKey(const Key* keys, uint32_t keyCount, float time, uint32_t& cursor) {
+    const auto contains = [&](uint32_t n) {
+        return (n == 0 || keys[n - 1].t <= time) && (n == keyCount || keys[n].t > time);
+    };
+
+    uint32_t n = std::min(cursor, keyCount);
+    if (contains(n)) return n;
+    if (n < keyCount && contains(n + 1)) {
+        cursor = n + 1;
+        return n + 1;
+    }
+
+    const Key* it = std::upper_bound(keys, keys + keyCount, time, [](float value, const Key& key) {
+        return value < key.t;
+    });
+    cursor = static_cast<uint32_t>(it - keys);
+    return cursor;
+}
+
+// Keys a and b around time and the eased blend between them; a == b outside the key range.
+template <typename Key>
+struct KeySpan {
+    const Key* a = nullptr;
+    const Key* b = nullptr;
+    float u = 0.0f;
+};
+
+template <typename Key>
+KeySpan<Key> LocateSpan(const Key* keys, uint32_t keyCount, float time, uint32_t& cursor) {
+    const uint32_t n = LocateKey(keys, keyCount, time, cursor);
+    KeySpan<Key> span;
+    if (n == 0 || n == keyCount) {
+        span.a = span.b = &keys[n == 0 ? 0 : keyCount - 1];
+        return span;
+    }
+
+    span.a = &keys[n - 1];
+    span.b = &keys[n];
+    const float rawU = (time - span.a->t) / std::max(kEpsilon, span.b->t - span.a->t);
+    span.u = ApplyTimelineEase(rawU, static_cast<RS3TimelineEase>(span.b->ease));
+    return span;
+}
+
+} // namespace
+
+void RS3TimelineTrackEvaluator::Bind(std::shared_ptr<const RS3CompiledTimeline> timeline) {
+    m_timeline = std::move(timeline);
+    m_cursors.assign(m_timeline ? m_timeline->GetTrackCount() : 0, 0);
+}
+
+void RS3TimelineTrackEvaluator::Reset() {
+    m_timeline.reset();
+    m_cursors.clear();
+}
+
+void RS3TimelineTrackEvaluator::Evaluate(float timeSec, RS3TimelineTrackFrame& outFrame) {
+    outFrame.Clear();
+    if (!m_timeline) return;
+
+    const RS3CompiledTrack* tracks = m_timeline->GetTracks();
+    const uint32_t trackCount = m_timeline->GetTrackCount();
+    for (uint32_t i = 0; i < trackCount; ++i) {
+        const RS3CompiledTrack& track = tracks[i];
+        uint32_t& cursor = m_cursors[i];
+
+        switch (static_cast<RS3TimelineTrackType>(track.type)) {
+        case RS3TimelineTrackType::Transform: {
+            const auto span = LocateSpan(m_timeline->GetTrackKeys<RS3CompiledTransformKey>(track), track.keyCount, timeSec, cursor);
+            RS3TrackTransformState state;
+            state.track = i;
+            state.target = m_timeline->GetString(track.targetOffset, track.targetLength);
+            state.position = Lerp(span.a->position, span.b->position, span.u);
+            state.scale = Lerp(span.a->scale, span.b->scale, span.u);
+            DirectX::XMStoreFloat4(&state.rotation, DirectX::XMQuaternionNormalize(DirectX::XMQuaternionSlerp(
+                DirectX::XMLoadFloat4(&span.a->rotation), DirectX::XMLoadFloat4(&span.b->rotation), span.u)));
+            outFrame.transforms.push_back(state);
+            break;
+        }
+        case RS3TimelineTrackType::Light: {
+            const auto span = LocateSpan(m_timeline->GetTrackKeys<RS3CompiledLightKey>(track), track.keyCount, timeSec, cursor);
+            RS3TrackLightState state;
+            state.track = i;
+            state.color = Lerp(span.a->color, span.b->color, span.u);
+            state.intensity = Lerp(span.a->intensity, span.b->intensity, span.u);
+            outFrame.lights.push_back(state);
+            break;
+        }
+        case RS3TimelineTrackType::Fog: {
+            const auto span = LocateSpan(m_timeline->GetTrackKeys<RS3CompiledFogKey>(track), track.keyCount, timeSec, cursor);
+            RS3TrackFogState state;
+            state.track = i;
+            state.fogMin = Lerp(span.a->fogMin, span.b->fogMin, span.u);
+            state.fogMax = Lerp(span.a->fogMax, span.b->fogMax, span.u);
+            state.color = Lerp(span.a->color, span.b->color, span.u);
+            outFrame.fogs.push_back(state);
+            break;
+        }
+        case RS3TimelineTrackType::ClipTrigger: {
+            const RS3CompiledClipKey* keys = m_timeline->GetTrackKeys<RS3CompiledClipKey>(track);
+            const uint32_t n = LocateKey(keys, track.keyCount, timeSec, cursor);
+            RS3TrackClipState state;
+            state.track = i;
+            state.target = m_timeline->GetString(track.targetOffset, track.targetLength);
+            if (n > 0) {
+                const RS3CompiledClipKey& key = keys[n - 1];
+                state.clip = m_timeline->GetString(key.clipOffset, key.clipLength);
+                state.startTimeSec = key.t;
+                state.clipTimeSec = (timeSec - key.t) * key.speed;
+                state.loop = key.loop != 0;
+                state.active = true;
+            }
+            outFrame.clips.push_back(state);
+            break;
+        }
+        }
+    }
+}
+
+RS3EnvironmentOverride BuildEnvironmentOverride(const RS3TimelineTrackFrame& frame) {
+    RS3EnvironmentOverride environment;
+    if (!frame.lights.empty()) {
+        environment.hasLight = true;
+        environment.lightColor = frame.lights.front().color;
+        environment.lightIntensity = frame.lights.front().intensity;
+    }
+    if (!frame.fogs.empty()) {
+        environment.hasFog = true;
+        environment.fogMin = frame.fogs.front().fogMin;
+        environment.fogMax = frame.fogs.front().fogMax;
+        environment.fogColor = frame.fogs.front().color;
+    }
+    return environment;
+}
+
+} // namespace RealSpace3
@@ -0,0 +1,197 @@
+#include "../Include/WavFile.h"
+
+#include "../Include/MappedFile.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+namespace RealSpace3 {
+namespace {
+
+void SetError(std::string* outError, const std::string& message) {
+    if (outError) *outError = message;
+}
+
+constexpr uint16_t kFormatPcm = 1;
+constexpr uint16_t kFormatFloat = 3;
+constexpr uint16_t kFormatExtensible = 0xFFFE;
+
+uint16_t ReadU16(const uint8_t* p) {
+    return static_cast<uint16_t>(p[0] | (p[1] << 8));
+}
+
+uint32_t ReadU32(const uint8_t* p) {
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+        (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+void WriteU16(uint8_t* p, uint16_t value) {
+    p[0] = static_cast<uint8_t>(value);
+    p[1] = static_cast<uint8_t>(value >> 8);
+}
+
+void WriteU32(uint8_t* p, uint32_t value) {
+    p[0] = static_cast<uint8_t>(value);
+    p[1] = static_cast<uint8_t>(value >> 8);
+    p[2] = static_cast<uint8_t>(value >> 16);
+    p[3] = static_cast<uint8_t>(value >> 24);
+}
+
+struct WavFormat {
+    uint16_t tag = 0;
+    uint16_t channels = 0;
+    uint32_t sampleRate = 0;
+    uint16_t blockAlign = 0;
+    uint16_t bitsPerSample = 0;
+};
+
+} // namespace
+
+bool WavFile::Decode(const uint8_t* data, size_t size, RS3AudioBuffer& outBuffer, std::string* outError) {
+    if (!data || size < 12 || std::memcmp(data, "RIFF", 4) != 0 || std::memcmp(data + 8, "WAVE", 4) != 0) {
+        SetError(outError, "Not a RIFF/WAVE file.");
+        return false;
+    }
+
+    WavFormat format;
+    bool haveFormat = false;
+    const uint8_t* samples = nullptr;
+    size_t samplesSize = 0;
+    size_t pos = 12;
+    while (pos + 8 <= size) {
+        const uint8_t* chunk = data + pos;
+        const size_t chunkSize = ReadU32(chunk + 4);
+        const size_t available = std::min(chunkSize, size - pos - 8);
+        if (std::memcmp(chunk, "fmt ", 4) == 0 && available >= 16) {
+            format.tag = ReadU16(chunk + 8);
+            format.channels = ReadU16(chunk + 10);
+            format.sampleRate = ReadU32(chunk + 12);
+            format.blockAlign = ReadU16(chunk + 20);
+            format.bitsPerSample = ReadU16(chunk + 22);
+            if (format.tag == kFormatExtensible && available >= 40) {
+                // The sub-format GUID starts with the plain format tag
+                format.tag = ReadU16(chunk + 8 + 24);
+            }
+            haveFormat = true;
+        } else if (std::memcmp(chunk, "data", 4) == 0) {
+            samples = chunk + 8;
+            samplesSize = available; // a truncated file keeps the samples it has
+        }
+        pos += 8 + chunkSize + (chunkSize & 1u);
+    }
+
+    if (!haveFormat || !samples) {
+        SetError(outError, "WAVE file has no fmt or data chunk.");
+        return false;
+    }
+    const uint32_t bytesPerSample = format.bitsPerSample / 8u;
+    const bool supported = format.channels > 0 && format.sampleRate > 0 &&
+        ((format.tag == kFormatPcm && bytesPerSample >= 1 && bytesPerSample <= 4 && format.bitsPerSample % 8 == 0) ||
+         (format.tag == kFormatFloat && format.bitsPerSample == 32));
+    if (!supported || format.blockAlign != bytesPerSample * format.channels) {
+        SetError(outError, "Unsupported WAVE format (tag " + std::to_string(format.tag) + ", " +
+            std::to_string(format.bitsPerSample) + " bits).");
+        return false;
+    }
+
+    const size_t sampleCount = samplesSize / format.blockAlign * format.channels;
+    outBuffer.sampleRate = format.sampleRate;
+    outBuffer.channels = format.channels;
+    outBuffer.samples.resize(sampleCount);
+    float* out = outBuffer.samples.data();
+    const uint8_t* in = samples;
+    switch (format.tag == kFormatFloat ? 0u : bytesPerSample) {
+    case 0:
+        std::memcpy(out, in, sampleCount * sizeof(float));
+        break;
+    case 1:
+        for (size_t i = 0; i < sampleCount; ++i) {
+            out[i] = (static_cast<float>(in[i]) - 128.0f) * (1.0f / 128.0f);
+        }
+        break;
+    case 2:
+        for (size_t i = 0; i < sampleCount; ++i, in += 2) {
+            out[i] = static_cast<float>(static_cast<int16_t>(ReadU16(in))) * (1.0f / 32768.0f);
+        }
+        break;
+    case 3:
+        for (size_t i = 0; i < sampleCount; ++i, in += 3) {
+            const int32_t value = static_cast<int32_t>((static_cast<uint32_t>(in[0]) << 8) |
+                (static_cast<uint32_t>(in[1]) << 16) | (static_cast<uint32_t>(in[2]) << 24)) >> 8;
+            out[i] = static_cast<float>(value) * (1.0f / 8388608.0f);
+        }
+        break;
+    case 4:
+        for (size_t i = 0; i < sampleCount; ++i, in += 4) {
+            out[i] = static_cast<float>(static_cast<int32_t>(ReadU32(in))) * (1.0f / 2147483648.0f);
+        }
+        break;
+    }
+    return true;
+}
+
+bool WavFile::Load(const std::string& path, RS3AudioBuffer& outBuffer, std::string* outError) {
+    MappedFile file;
+    std::string error;
+    if (!file.Open(path, &error)) {
+        SetError(outError, "Failed to open audio file '" + path + "': " + error);
+        return false;
+    }
+    if (!Decode(file.GetData(), file.GetSize(), outBuffer, &error)) {
+        SetError(outError, path + ": " + error);
+        return false;
+    }
+    return true;
+}
+
+void WavFile::EncodePcm16(const RS3AudioBuffer& buffer, std::vector<uint8_t>& outBytes) {
+    const size_t sampleCount = buffer.samples.size();
+    const uint32_t dataSize = static_cast<uint32_t>(sampleCount * 2u);
+    outBytes.resize(44 + static_cast<size_t>(dataSize));
+    uint8_t* p = outBytes.data();
+    std::memcpy(p, "RIFF", 4);
+    WriteU32(p + 4, 36u + dataSize);
+    std::memcpy(p + 8, "WAVEfmt ", 8);
+    WriteU32(p + 16, 16);
+    WriteU16(p + 20, kFormatPcm);
+    WriteU16(p + 22, static_cast<uint16_t>(buffer.channels));
+    WriteU32(p + 24, buffer.sampleRate);
+    WriteU32(p + 28, buffer.sampleRate * buffer.channels * 2u);
+    WriteU16(p + 32, static_cast<uint16_t>(buffer.channels * 2u));
+    WriteU16(p + 34, 16);
+    std::memcpy(p + 36, "data", 4);
+    WriteU32(p + 40, dataSize);
+
+    uint8_t* out = p + 44;
+    for (size_t i = 0; i < sampleCount; ++i, out += 2) {
+        const float clamped = std::max(-1.0f, std::min(1.0f, buffer.samples[i]));
+        const long value = std::lrint(clamped * 32767.0f);
+        WriteU16(out, static_cast<uint16_t>(static_cast<int16_t>(value)));
+    }
+}
+
+bool WavFile::WritePcm16(const std::string& path, const RS3AudioBuffer& buffer, std::string* outError) {
+    if (buffer.channels == 0 || buffer.samples.size() * 2u > 0xFFFFFFD0ull) {
+        SetError(outError, "Audio buffer cannot be written as WAVE: " + path);
+        return false;
+    }
+    std::vector<uint8_t> bytes;
+    EncodePcm16(buffer, bytes);
+
+    std::ofstream out(std::filesystem::path(path), std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) {
+        SetError(outError, "Failed to open audio file for writing: " + path);
+        return false;
+    }
+    out.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+    if (!out.good()) {
+        SetError(outError, "Failed to write audio file: " + path);
+        return false;
+    }
+    return true;
+}
+
+} // namespace RealSpace3
@@ -0,0 +1,617 @@
+// RS3CineEval: samples a cinematic timeline without a window or GPU and writes the camera pose
+// and track values of every frame. Output is a pure function of the timeline and the fps, so a
+// dump doubles as a regression baseline for the interpolation code.
+//
+// --audio-out also renders the timeline's audio mix to a WAV file (same mixer as the export).
+// --bench-sink runs the export frame sinks on synthetic frames instead (no timeline needed) and
+// reports frames per second.
+// --bench-parse parses timeline JSON repeatedly (the given --timeline, or a synthetic one) and
+// reports parse time and throughput.
+
+#include "AppLogger.h"
+#include "RealSpace3/Include/AudioMixer.h"
+#include "RealSpace3/Include/CinematicPlayer.h"
+#include "RealSpace3/Include/CinematicTimeline.h"
+#include "RealSpace3/Include/CompiledTimeline.h"
+#include "RealSpace3/Include/FrameSink.h"
+#include "RealSpace3/Include/TimelineTracks.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#endif
+
+namespace {
+
+constexpr char kPoseMagic[8] = { 'N', 'D', 'G', 'P', 'O', 'S', 'E', '1' };
+constexpr uint64_t kFnvOffset = 1469598103934665603ull;
+constexpr uint64_t kFnvPrime = 1099511628211ull;
+
+enum class OutputFormat {
+    Csv,
+    Binary,
+};
+
+struct EvalOptions {
+    std::string timelinePath;
+    std::string outputPath = "-";
+    OutputFormat format = OutputFormat::Csv;
+    int fps = 0;
+    int repeat = 1;
+    std::string audioOutputPath;
+    uint32_t sampleRate = 48000;
+
+    // Sink benchmark
+    std::string benchSink;
+    int benchFrames = 240;
+    uint32_t benchWidth = 1920;
+    uint32_t benchHeight = 1080;
+    uint32_t benchThreads = 0;
+    std::string benchOutputDir = "rs3_bench_frames";
+    std::string benchPipeCommand;
+
+    // Parse benchmark
+    int benchParseIterations = 0;
+    int benchParseKeys = 4096;
+};
+
+bool ParseArgs(int argc, char** argv, EvalOptions& out) {
+    auto consumeValue = [&](int& index, std::string& outValue) -> bool {
+        if (index + 1 >= argc) return false;
+        ++index;
+        outValue = argv[index];
+        return !outValue.empty();
+    };
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--timeline") {
+            if (!consumeValue(i, out.timelinePath)) return false;
+        } else if (arg == "--output") {
+            if (!consumeValue(i, out.outputPath)) return false;
+        } else if (arg == "--format") {
+            std::string raw;
+            if (!consumeValue(i, raw)) return false;
+            if (raw == "csv") {
+                out.format = OutputFormat::Csv;
+            } else if (raw == "bin") {
+                out.format = OutputFormat::Binary;
+            } else {
+                return false;
+            }
+        } else if (arg == "--fps") {
+            std::string raw;
+            if (!consumeValue(i, raw)) return false;
+            out.fps = std::max(1, std::atoi(raw.c_str()));
+        } else if (arg == "--repeat") {
+            std::string raw;
+            if (!consumeValue(i, raw)) return false;
+            out.repeat = std::max(1, std::atoi(raw.c_str()));
+        } else if (arg == "--audio-out") {
+            if (!consumeValue(i, out.audioOutputPath)) return false;
+        } else if (arg == "--sample-rate") {
+            std::string raw;
+            if (!consumeValue(i, raw)) return false;
+            out.sampleRate = static_cast<uint32_t>(std::max(8000, std::atoi(raw.c_str())));
+        } else if (arg == "--bench-sink") {
+            if (!consumeValue(i, out.benchSink)) return false;
+            if (out.benchSink != "png" && out.benchSink != "qoi" && out.benchSink != "pipe" && out.benchSink != "ring") return false;
+        } else if (arg == "--frames") {
+            std::string raw;
+            if (!consumeValue(i, raw)) return false;
+            out.benchFrames = std::max(1, std::atoi(raw.c_str()));
+        } else if (arg == "--size") {
+            std::string raw;
+            if (!consumeValue(i, raw)) return false;
+            unsigned width = 0;
+            unsigned height = 0;
+            if (std::sscanf(raw.c_str(), "%ux%u", &width, &height) != 2 || width == 0 || height == 0) return false;
+            out.benchWidth = width;
+            out.benchHeight = height;
+        } else if (arg == "--threads") {
+            std::string raw;
+            if (!consumeValue(i, raw)) return false;
+            out.benchThreads = static_cast<uint32_t>(std::max(0, std::atoi(raw.c_str())));
+        } else if (arg == "--output-dir") {
+            if (!consumeValue(i, out.benchOutputDir)) return false;
+        } else if (arg == "--pipe-command") {
+            if (!consumeValue(i, out.benchPipeCommand)) return false;
+        } else if (arg == "--bench-parse") {
+            std::string raw;
+            if (!consumeValue(i, raw)) return false;
+            out.benchParseIterations = std::max(1, std::atoi(raw.c_str()));
+        } else if (arg == "--keys") {
+            std::string raw;
+            if (!consumeValue(i, raw)) return false;
+            out.benchParseKeys = std::max(1, std::atoi(raw.c_str()));
+        } else {
+            return false;
+        }
+    }
+    return !out.timelinePath.empty() || !out.benchSink.empty() || out.benchParseIterations > 0;
+}
+
+// Column names follow the track table, so they are fixed for a given timeline.
+std::vector<std::string> BuildColumns(const RealSpace3::RS3CompiledTimeline& timeline) {
+    std::vector<std::string> columns = {
+        "frame", "time",
+        "cam.px", "cam.py", "cam.pz",
+        "cam.tx", "cam.ty", "cam.tz",
+        "cam.ux", "cam.uy", "cam.uz",
+        "cam.fov"
+    };
+
+    const RealSpace3::RS3CompiledTrack* tracks = timeline.GetTracks();
+    for (uint32_t i = 0; i < timeline.GetTrackCount(); ++i) {
+        const auto type = static_cast<RealSpace3::RS3TimelineTrackType>(tracks[i].type);
+        const std::string prefix = "track" + std::to_string(i) + "." + RealSpace3::ToTimelineTrackTypeString(type) + ".";
+        const char* const* fields = nullptr;
+        size_t fieldCount = 0;
+        static const char* const kTransform[] = { "px", "py", "pz", "qx", "qy", "qz", "qw", "scale" };
+        static const char* const kLight[] = { "r", "g", "b", "intensity" };
+        static const char* const kFog[] = { "min", "max", "r", "g", "b" };
+        static const char* const kClip[] = { "active", "start", "clipTime" };
+        switch (type) {
+        case RealSpace3::RS3TimelineTrackType::Transform: fields = kTransform; fieldCount = std::size(kTransform); break;
+        case RealSpace3::RS3TimelineTrackType::Light: fields = kLight; fieldCount = std::size(kLight); break;
+        case RealSpace3::RS3TimelineTrackType::Fog: fields = kFog; fieldCount = std::size(kFog); break;
+        case RealSpace3::RS3TimelineTrackType::ClipTrigger: fields = kClip; fieldCount = std::size(kClip); break;
+        }
+        for (size_t f = 0; f < fieldCount; ++f) {
+            columns.push_back(prefix + fields[f]);
+        }
+    }
+    return columns;
+}
+
+// One row per frame, in the column order of BuildColumns. The frame evaluators emit each
+// track type in track order, so walking the track table with one index per type lines up.
+void AppendFrameRow(int frame, float timeSec, const RealSpace3::RS3CameraPose& pose,
+                    const RealSpace3::RS3CompiledTimeline& timeline, const RealSpace3::RS3TimelineTrackFrame& trackFrame,
+                    std::vector<float>& outRow) {
+    outRow.clear();
+    outRow.push_back(static_cast<float>(frame));
+    outRow.push_back(timeSec);
+    outRow.insert(outRow.end(), {
+        pose.position.x, pose.position.y, pose.position.z,
+        pose.target.x, pose.target.y, pose.target.z,
+        pose.up.x, pose.up.y, pose.up.z,
+        pose.fovDeg
+    });
+
+    size_t transform = 0;
+    size_t light = 0;
+    size_t fog = 0;
+    size_t clip = 0;
+    const RealSpace3::RS3CompiledTrack* tracks = timeline.GetTracks();
+    for (uint32_t i = 0; i < timeline.GetTrackCount(); ++i) {
+        switch (static_cast<RealSpace3::RS3TimelineTrackType>(tracks[i].type)) {
+        case RealSpace3::RS3TimelineTrackType::Transform: {
+            const auto& s = trackFrame.transforms[transform++];
+            outRow.insert(outRow.end(), {
+                s.position.x, s.position.y, s.position.z,
+                s.rotation.x, s.rotation.y, s.rotation.z, s.rotation.w,
+                s.scale
+            });
+            break;
+        }
+        case RealSpace3::RS3TimelineTrackType::Light: {
+            const auto& s = trackFrame.lights[light++];
+            outRow.insert(outRow.end(), { s.color.x, s.color.y, s.color.z, s.intensity });
+            break;
+        }
+        case RealSpace3::RS3TimelineTrackType::Fog: {
+            const auto& s = trackFrame.fogs[fog++];
+            outRow.insert(outRow.end(), { s.fogMin, s.fogMax, s.color.x, s.color.y, s.color.z });
+            break;
+        }
+        case RealSpace3::RS3TimelineTrackType::ClipTrigger: {
+            const auto& s = trackFrame.clips[clip++];
+            outRow.insert(outRow.end(), { s.active ? 1.0f : 0.0f, s.startTimeSec, s.clipTimeSec });
+            break;
+        }
+        }
+    }
+}
+
+uint64_t HashRow(uint64_t hash, const std::vector<float>& row) {
+    for (const float value : row) {
+        uint32_t bits = 0;
+        std::memcpy(&bits, &value, sizeof(bits));
+        for (int b = 0; b < 4; ++b) {
+            hash ^= (bits >> (b * 8)) & 0xFFu;
+            hash *= kFnvPrime;
+        }
+    }
+    return hash;
+}
+
+void WriteU32(FILE* file, uint32_t value) {
+    const uint8_t bytes[4] = {
+        static_cast<uint8_t>(value), static_cast<uint8_t>(value >> 8),
+        static_cast<uint8_t>(value >> 16), static_cast<uint8_t>(value >> 24)
+    };
+    std::fwrite(bytes, 1, sizeof(bytes), file);
+}
+
+void WriteHeader(FILE* file, OutputFormat format, const std::vector<std::string>& columns, int frameCount, int fps) {
+    if (format == OutputFormat::Csv) {
+        for (size_t i = 0; i < columns.size(); ++i) {
+            std::fputs(columns[i].c_str(), file);
+            std::fputc(i + 1 < columns.size() ? ',' : '\n', file);
+        }
+        return;
+    }
+
+    std::string names;
+    for (const std::string& column : columns) {
+        names += column;
+        names += '\n';
+    }
+    std::fwrite(kPoseMagic, 1, sizeof(kPoseMagic), file);
+    WriteU32(file, static_cast<uint32_t>(frameCount));
+    WriteU32(file, static_cast<uint32_t>(columns.size()));
+    WriteU32(file, static_cast<uint32_t>(fps));
+    WriteU32(file, static_cast<uint32_t>(names.size()));
+    std::fwrite(names.data(), 1, names.size(), file);
+}
+
+void WriteRow(FILE* file, OutputFormat format, const std::vector<float>& row) {
+    if (format == OutputFormat::Csv) {
+        // %.9g round-trips every float exactly
+        char value[32] = {};
+        for (size_t i = 0; i < row.size(); ++i) {
+            std::snprintf(value, sizeof(value), "%.9g", row[i]);
+            std::fputs(value, file);
+            std::fputc(i + 1 < row.size() ? ',' : '\n', file);
+        }
+        return;
+    }
+
+    for (const float value : row) {
+        uint32_t bits = 0;
+        std::memcpy(&bits, &value, sizeof(bits));
+        WriteU32(file, bits);
+    }
+}
+
+// Stand-in for a rendered frame: gradients, a few moving blocks and a noisy band, so the
+// encoders see both flat areas and high-entropy ones.
+void GenerateSyntheticFrame(uint64_t index, uint32_t width, uint32_t height, std::vector<uint8_t>& bgra) {
+    bgra.resize(static_cast<size_t>(width) * height * 4u);
+    uint32_t noise = 0x9E3779B9u ^ static_cast<uint32_t>(index * 2654435761u);
+    const uint32_t shift = static_cast<uint32_t>(index * 7);
+    for (uint32_t y = 0; y < height; ++y) {
+        uint8_t* row = bgra.data() + static_cast<size_t>(y) * width * 4u;
+        const bool noisyBand = y >= height / 2 && y < height / 2 + height / 8;
+        for (uint32_t x = 0; x < width; ++x) {
+            uint8_t* px = row + x * 4u;
+            px[0] = static_cast<uint8_t>((x + shift) * 255u / width);
+            px[1] = static_cast<uint8_t>(y * 255u / height);
+            px[2] = static_cast<uint8_t>(((x + shift) / 64 + y / 64) % 2 ? 200 : 40);
+            px[3] = 255;
+            if (noisyBand) {
+                noise = noise * 1664525u + 1013904223u;
+                px[0] = static_cast<uint8_t>(px[0] + ((noise >> 24) & 0x1F));
+                px[1] = static_cast<uint8_t>(px[1] + ((noise >> 16) & 0x1F));
+            }
+        }
+    }
+    for (uint32_t block = 0; block < 4; ++block) {
+        const uint32_t bx = static_cast<uint32_t>((index * (block + 3) * 5 + block * width / 4) % width);
+        const uint32_t by = (block * height / 4 + height / 16) % height;
+        for (uint32_t y = by; y < std::min(height, by + height / 6); ++y) {
+            for (uint32_t x = bx; x < std::min(width, bx + width / 8); ++x) {
+                uint8_t* px = bgra.data() + (static_cast<size_t>(y) * width + x) * 4u;
+                px[0] = static_cast<uint8_t>(60 * block);
+                px[1] = 255;
+                px[2] = static_cast<uint8_t>(255 - 60 * block);
+            }
+        }
+    }
+}
+
+// Feeds synthetic frames through RS3FrameWriter into the chosen sink, the same path the
+// studio export takes after readback.
+int RunSinkBenchmark(const EvalOptions& options) {
+    using namespace RealSpace3;
+
+    std::unique_ptr<RS3FrameSink> sink;
+    RS3ImageSequenceSink* imageSink = nullptr;
+    if (options.benchSink == "png" || options.benchSink == "qoi") {
+        const RS3ImageFormat format = options.benchSink == "qoi" ? RS3ImageFormat::Qoi : RS3ImageFormat::Png;
+        auto sequence = std::make_unique<RS3ImageSequenceSink>(options.benchOutputDir, "bench", format, options.benchThreads);
+        imageSink = sequence.get();
+        sink = std::move(sequence);
+    } else if (options.benchSink == "pipe") {
+#ifdef _WIN32
+        const std::string command = options.benchPipeCommand;
+#else
+        const std::string command = options.benchPipeCommand.empty() ? std::string("cat > /dev/null") : options.benchPipeCommand;
+#endif
+        sink = std::make_unique<RS3FramePipeSink>([command](uint32_t, uint32_t, int) { return command; });
+    } else {
+        sink = std::make_unique<RS3FrameRingSink>(8);
+    }
+
+    // A handful of distinct source frames, generated up front so the loop measures the sink
+    constexpr uint32_t kSourceFrames = 8;
+    std::vector<std::vector<uint8_t>> sources(kSourceFrames);
+    for (uint32_t i = 0; i < kSourceFrames; ++i) {
+        GenerateSyntheticFrame(i, options.benchWidth, options.benchHeight, sources[i]);
+    }
+
+    RS3FrameWriter writer(*sink, 4);
+    std::string error;
+    if (!writer.Start(60, &error)) {
+        std::fprintf(stderr, "[CINE] Failed to start frame writer: %s\n", error.c_str());
+        return 1;
+    }
+    const auto benchStart = std::chrono::steady_clock::now();
+    for (int frame = 0; frame < options.benchFrames; ++frame) {
+        std::unique_ptr<RS3CapturedFrame> captured = writer.AcquireFrame();
+        if (!captured) break;
+        captured->index = static_cast<uint64_t>(frame);
+        captured->width = options.benchWidth;
+        captured->height = options.benchHeight;
+        captured->bgra = sources[static_cast<uint32_t>(frame) % kSourceFrames];
+        if (!writer.SubmitFrame(std::move(captured))) break;
+    }
+    const bool ok = writer.Finish(&error);
+    const double benchMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - benchStart).count();
+    if (!ok) {
+        std::fprintf(stderr, "[CINE] Sink benchmark failed: %s\n", error.c_str());
+        return 1;
+    }
+
+    const RS3FrameWriterStats stats = writer.GetStats();
+    const double seconds = std::max(benchMs, 1e-3) / 1000.0;
+    std::fprintf(stderr, "[CINE] sink=%s size=%ux%u frames=%llu time=%.1fms fps=%.2f producerWait=%.1fms\n",
+        options.benchSink.c_str(), options.benchWidth, options.benchHeight,
+        static_cast<unsigned long long>(stats.framesWritten), benchMs, stats.framesWritten / seconds, stats.producerWaitMs);
+    if (imageSink) {
+        const RS3ImageSequenceStats imageStats = imageSink->GetStats();
+        const double frames = static_cast<double>(std::max<uint64_t>(1, imageStats.framesWritten));
+        std::fprintf(stderr, "[CINE] threads=%u bytesPerFrame=%.0f encodePerFrame=%.2fms filePerFrame=%.2fms sinkWait=%.1fms\n",
+            imageSink->GetThreadCount(), imageStats.encodedBytes / frames, imageStats.encodeMs / frames,
+            imageStats.fileMs / frames, imageStats.producerWaitMs);
+    }
+    return 0;
+}
+
+// Authoring-style timeline with keysPerTrack keys on the camera and on each track type, plus
+// escaped names, so the parse covers numbers, nesting, key lookups and string decoding.
+std::string BuildSyntheticTimelineJson(int keysPerTrack) {
+    std::string json;
+    json.reserve(static_cast<size_t>(keysPerTrack) * 700 + 1024);
+    char buffer[512] = {};
+    const double durationSec = keysPerTrack / 10.0;
+
+    std::snprintf(buffer, sizeof(buffer),
+        "{\n  \"version\": \"ndg_cine_v1\",\n  \"sceneId\": \"bench\",\n  \"mode\": \"map_only\",\n  \"durationSec\": %.6g,\n  \"fps\": 60,\n",
+        durationSec);
+    json += buffer;
+
+    json += "  \"camera\": {\n    \"keyframes\": [\n";
+    for (int k = 0; k < keysPerTrack; ++k) {
+        const double t = k / 10.0;
+        std::snprintf(buffer, sizeof(buffer),
+            "      {\"t\": %.6g, \"position\": [%.6g, %.6g, %.6g], \"target\": [%.6g, %.6g, %.6g], \"rollDeg\": %.6g, \"fovDeg\": %.6g, \"ease\": \"%s\"}%s\n",
+            t, 1000.0 * std::sin(t), 1000.0 * std::cos(t), 150.0 + k % 7, 0.0, 0.0, 100.0, (k % 5) * 1.5, 55.0 + k % 10,
+            k % 2 ? "easeInOutCubic" : "linear", k + 1 < keysPerTrack ? "," : "");
+        json += buffer;
+    }
+    json += "    ]\n  },\n  \"tracks\": [\n";
+
+    const char* const kTrackHeaders[] = {
+        "    {\"type\": \"transform\", \"name\": \"Hero \\\"Main\\\" \\u00e9\", \"target\": \"hero\", \"keys\": [\n",
+        "    {\"type\": \"light\", \"name\": \"Key\\tLight\", \"keys\": [\n",
+        "    {\"type\": \"fog\", \"name\": \"Fog\", \"keys\": [\n",
+        "    {\"type\": \"clip\", \"name\": \"Clips \\ud83c\\udfac\", \"target\": \"hero\", \"keys\": [\n",
+    };
+    for (size_t track = 0; track < std::size(kTrackHeaders); ++track) {
+        json += kTrackHeaders[track];
+        for (int k = 0; k < keysPerTrack; ++k) {
+            const double t = k / 10.0;
+            const char* separator = k + 1 < keysPerTrack ? "," : "";
+            switch (track) {
+            case 0:
+                std::snprintf(buffer, sizeof(buffer),
+                    "      {\"t\": %.6g, \"position\": [%.6g, %.6g, 0], \"rotationDeg\": [0, %.6g, 0], \"scale\": %.6g, \"ease\": \"ease-in-out-cubic\"}%s\n",
+                    t, 10.0 * k, -5.0 * k, std::fmod(k * 7.5, 360.0), 1.0 + (k % 3) * 0.25, separator);
+                break;
+            case 1:
+                std::snprintf(buffer, sizeof(buffer),
+                    "      {\"t\": %.6g, \"color\": [%.6g, 0.9, 0.8], \"intensity\": %.6g}%s\n",
+                    t, 0.5 + (k % 10) * 0.05, 1.0 + (k % 4) * 0.5, separator);
+                break;
+            case 2:
+                std::snprintf(buffer, sizeof(buffer),
+                    "      {\"t\": %.6g, \"min\": %.6g, \"max\": %.6g, \"color\": [0.5, 0.6, 0.7e0]}%s\n",
+                    t, 800.0 + k % 100, 6000.0 + k % 1000, separator);
+                break;
+            default:
+                std::snprintf(buffer, sizeof(buffer),
+                    "      {\"t\": %.6g, \"clip\": \"run_%d\", \"speed\": %.6g, \"loop\": %s}%s\n",
+                    t, k % 16, 1.0 + (k % 3) * 0.5, k % 2 ? "true" : "false", separator);
+                break;
+            }
+            json += buffer;
+        }
+        json += track + 1 < std::size(kTrackHeaders) ? "    ]},\n" : "    ]}\n";
+    }
+    json += "  ]\n}\n";
+    return json;
+}
+
+// Parses the same bytes repeatedly with ParseTimelineJson: DOM build plus timeline validation,
+// without the file read.
+int RunParseBenchmark(const EvalOptions& options) {
+    std::string json;
+    std::string source = "synthetic";
+    if (!options.timelinePath.empty()) {
+        if (!RealSpace3::ResolveTimelineFile(options.timelinePath, source)) {
+            std::fprintf(stderr, "[CINE] Timeline file not found: %s\n", options.timelinePath.c_str());
+            return 1;
+        }
+        std::ifstream input(source, std::ios::binary);
+        json.assign(std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>());
+        if (!input.good() && !input.eof()) {
+            std::fprintf(stderr, "[CINE] Failed to read timeline: %s\n", source.c_str());
+            return 1;
+        }
+    } else {
+        json = BuildSyntheticTimelineJson(options.benchParseKeys);
+    }
+
+    RealSpace3::RS3TimelineData timeline;
+    std::string error;
+    if (!RealSpace3::ParseTimelineJson(json, timeline, &error)) {
+        std::fprintf(stderr, "[CINE] Failed to parse timeline: %s\n", error.c_str());
+        return 1;
+    }
+    size_t trackKeys = 0;
+    for (const auto& track : timeline.tracks) {
+        trackKeys += track.transformKeys.size() + track.lightKeys.size() + track.fogKeys.size() + track.clipKeys.size();
+    }
+
+    const auto benchStart = std::chrono::steady_clock::now();
+    for (int i = 0; i < options.benchParseIterations; ++i) {
+        if (!RealSpace3::ParseTimelineJson(json, timeline, &error)) {
+            std::fprintf(stderr, "[CINE] Failed to parse timeline: %s\n", error.c_str());
+            return 1;
+        }
+    }
+    const double benchMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - benchStart).count();
+
+    const double perParseMs = benchMs / options.benchParseIterations;
+    const double megabytesPerSec = json.size() / (std::max(perParseMs, 1e-6) / 1000.0) / (1024.0 * 1024.0);
+    std::fprintf(stderr, "[CINE] parse source=%s bytes=%zu keyframes=%zu tracks=%zu trackKeys=%zu iterations=%d time=%.1fms perParse=%.3fms throughput=%.1fMB/s\n",
+        source.c_str(), json.size(), timeline.keyframes.size(), timeline.tracks.size(), trackKeys,
+        options.benchParseIterations, benchMs, perParseMs, megabytesPerSec);
+    return 0;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    EvalOptions options;
+    if (!ParseArgs(argc, argv, options)) {
+        std::fprintf(stderr,
+            "Usage: RS3CineEval --timeline <file.ndgcine.json|file.ndgcine.bin> [--fps N] [--format csv|bin] [--output file] [--repeat N] [--audio-out mix.wav [--sample-rate N]]\n"
+            "       RS3CineEval --bench-sink png|qoi|pipe|ring [--frames N] [--size WxH] [--threads N] [--output-dir dir] [--pipe-command cmd]\n"
+            "       RS3CineEval --bench-parse N [--timeline file.ndgcine.json | --keys N]\n");
+        return 1;
+    }
+    if (options.benchParseIterations > 0) {
+        return RunParseBenchmark(options);
+    }
+    if (!options.benchSink.empty()) {
+        return RunSinkBenchmark(options);
+    }
+
+    std::shared_ptr<const RealSpace3::RS3CompiledTimeline> timeline;
+    std::string error;
+    if (!RealSpace3::LoadCompiledTimeline(options.timelinePath, timeline, &error)) {
+        std::fprintf(stderr, "[CINE] Failed to load timeline: %s\n", error.c_str());
+        return 1;
+    }
+
+    const int fps = options.fps > 0 ? options.fps : timeline->GetFps();
+    RealSpace3::CinematicPlayer player;
+    RealSpace3::RS3TimelinePlaybackOptions playbackOptions;
+    if (!player.Play(timeline, playbackOptions, &error)) {
+        std::fprintf(stderr, "[CINE] Failed to start playback: %s\n", error.c_str());
+        return 1;
+    }
+    player.Pause(true);
+
+    FILE* out = stdout;
+    if (options.outputPath != "-") {
+        out = std::fopen(options.outputPath.c_str(), options.format == OutputFormat::Csv ? "w" : "wb");
+        if (!out) {
+            std::fprintf(stderr, "[CINE] Failed to open output: %s\n", options.outputPath.c_str());
+            return 1;
+        }
+    }
+#ifdef _WIN32
+    else if (options.format == OutputFormat::Binary) {
+        _setmode(_fileno(stdout), _O_BINARY);
+    }
+#endif
+
+    const int frameCount = RealSpace3::GetTimelineFrameCount(player.GetDuration(), fps);
+    const std::vector<std::string> columns = BuildColumns(*timeline);
+    WriteHeader(out, options.format, columns, frameCount, fps);
+
+    // Earlier passes only exercise the evaluators (--repeat for profiling); the last one is written
+    RealSpace3::RS3TimelineTrackFrame trackFrame;
+    std::vector<float> row;
+    row.reserve(columns.size());
+    uint64_t hash = kFnvOffset;
+    const auto evalStart = std::chrono::steady_clock::now();
+    for (int pass = 0; pass < options.repeat; ++pass) {
+        const bool write = pass + 1 == options.repeat;
+        for (int frame = 0; frame < frameCount; ++frame) {
+            const float timeSec = RealSpace3::GetTimelineFrameTime(frame, fps);
+            player.Seek(timeSec);
+
+            RealSpace3::RS3CameraPose pose;
+            player.EvaluateCameraPose(pose);
+            player.EvaluateTracks(trackFrame);
+            AppendFrameRow(frame, player.GetCurrentTime(), pose, *timeline, trackFrame, row);
+            if (write) {
+                hash = HashRow(hash, row);
+                WriteRow(out, options.format, row);
+            }
+        }
+    }
+    const double evalMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - evalStart).count();
+
+    const bool writeOk = std::ferror(out) == 0;
+    if (out != stdout) {
+        std::fclose(out);
+    } else {
+        std::fflush(out);
+    }
+    if (!writeOk) {
+        std::fprintf(stderr, "[CINE] Failed to write output.\n");
+        return 1;
+    }
+
+    std::fprintf(stderr, "[CINE] frames=%d columns=%zu fps=%d fnv1a64=%016llx eval=%.3fms passes=%d\n",
+        frameCount, columns.size(), fps, static_cast<unsigned long long>(hash), evalMs, options.repeat);
+
+    if (!options.audioOutputPath.empty()) {
+        const RealSpace3::RS3TimelineAudio& audio = timeline->GetAudio();
+        const uint64_t audioFrames = RealSpace3::GetTimelineAudioFrameCount(player.GetDuration(), fps, options.sampleRate);
+        const auto mixStart = std::chrono::steady_clock::now();
+        RealSpace3::RS3AudioBuffer mix;
+        if (!RealSpace3::RenderTimelineAudio(audio, audioFrames, options.sampleRate, mix, &error)) {
+            std::fprintf(stderr, "[CINE] Failed to mix audio: %s\n", error.c_str());
+            return 1;
+        }
+        const double mixMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - mixStart).count();
+        if (!RealSpace3::WavFile::WritePcm16(options.audioOutputPath, mix, &error)) {
+            std::fprintf(stderr, "[CINE] %s\n", error.c_str());
+            return 1;
+        }
+        std::fprintf(stderr, "[CINE] audio clips=%zu frames=%llu rate=%u fnv1a64=%016llx mix=%.3fms\n",
+            RealSpace3::GetTimelineAudioClips(audio).size(), static_cast<unsigned long long>(audioFrames), options.sampleRate,
+            static_cast<unsigned long long>(HashRow(kFnvOffset, mix.samples)), mixMs);
+    }
+    return 0;
+}
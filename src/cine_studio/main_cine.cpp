@@ -22,6 +22,10 @@
 #include "RealSpace3/Include/SceneManager.h"
 #include "RealSpace3/Include/CinematicTimeline.h"
 #include "RealSpace3/Include/CinematicPlayer.h"
+#include "RealSpace3/Include/CompiledTimeline.h"
+#include "RealSpace3/Include/FrameSink.h"
+#include "RealSpace3/Include/TimelineTracks.h"
+#include "RealSpace3/Include/AudioMixer.h"
 
 #pragma comment(lib, "user32.lib")
 #pragma comment(lib, "shell32.lib")
@@ -63,8 +67,16 @@ struct CineOptions {
     int fps = 60;
     std::string ffmpegPath = "ffmpeg";
     std::string audioPathOverride;
+    // Image sequence export (--frames): encoded in parallel instead of piped to ffmpeg
+    std::string exportFramesDir;
+    RealSpace3::RS3ImageFormat framesFormat = RealSpace3::RS3ImageFormat::Png;
+    uint32_t encodeThreads = 0;
 };
 
+bool IsExportRequested(const CineOptions& options) {
+    return !options.exportMp4Path.empty() || !options.exportFramesDir.empty();
+}
+
 struct StudioUiState {
     HWND viewport = nullptr;
     HWND sceneTree = nullptr;
@@ -86,6 +98,7 @@ struct StudioUiState {
 
 std::unique_ptr<RealSpace3::RDeviceDX11> g_device;
 RealSpace3::CinematicPlayer g_player;
+RealSpace3::RS3TimelineTrackFrame g_trackFrame;
 RealSpace3::RS3TimelineData g_timelineData;
 RealSpace3::RS3TimelinePlaybackOptions g_playbackOptions;
 StudioUiState g_ui;
@@ -147,12 +160,28 @@ bool ParseArgs(CineOptions& out) {
             if (!consumeValue(i, out.audioPathOverride)) return false;
         } else if (arg == "--ffmpeg") {
             if (!consumeValue(i, out.ffmpegPath)) return false;
+        } else if (arg == "--frames") {
+            if (!consumeValue(i, out.exportFramesDir)) return false;
+        } else if (arg == "--frames-format") {
+            std::string raw;
+            if (!consumeValue(i, raw)) return false;
+            if (raw == "png") {
+                out.framesFormat = RealSpace3::RS3ImageFormat::Png;
+            } else if (raw == "qoi") {
+                out.framesFormat = RealSpace3::RS3ImageFormat::Qoi;
+            } else {
+                return false;
+            }
+        } else if (arg == "--encode-threads") {
+            std::string raw;
+            if (!consumeValue(i, raw)) return false;
+            out.encodeThreads = static_cast<uint32_t>(std::max(0, std::atoi(raw.c_str())));
         }
     }
 
     LocalFree(argv);
 
-    if (!out.preview && out.exportMp4Path.empty()) {
+    if (!out.preview && !IsExportRequested(out)) {
         out.preview = true;
     }
     return true;
@@ -217,6 +246,10 @@ RealSpace3::RS3TimelineData MakeDefaultTimeline() {
     return tl;
 }
 
+const char* TimelineEaseToString(RealSpace3::RS3TimelineEase ease) {
+    return ease == RealSpace3::RS3TimelineEase::EaseInOutCubic ? "ease-in-out-cubic" : "linear";
+}
+
 std::string TimelineToJson(const RealSpace3::RS3TimelineData& tl) {
     std::ostringstream out;
     out.setf(std::ios::fixed, std::ios::floatfield);
@@ -231,7 +264,7 @@ std::string TimelineToJson(const RealSpace3::RS3TimelineData& tl) {
     out << "    \"keyframes\": [\n";
     for (size_t i = 0; i < tl.keyframes.size(); ++i) {
         const auto& kf = tl.keyframes[i];
-        const char* ease = (kf.ease == RealSpace3::RS3TimelineEase::EaseInOutCubic) ? "ease-in-out-cubic" : "linear";
+        const char* ease = TimelineEaseToString(kf.ease);
         out << "      {\n";
         out << "        \"t\": " << kf.t << ",\n";
         out << "        \"position\": [" << kf.position.x << ", " << kf.position.y << ", " << kf.position.z << "],\n";
@@ -245,12 +278,90 @@ std::string TimelineToJson(const RealSpace3::RS3TimelineData& tl) {
     }
     out << "    ]\n";
     out << "  }";
-    if (tl.audio.enabled || !tl.audio.file.empty()) {
+    if (!tl.tracks.empty()) {
+        out << ",\n";
+        out << "  \"tracks\": [\n";
+        for (size_t i = 0; i < tl.tracks.size(); ++i) {
+            const auto& track = tl.tracks[i];
+            out << "    {\n";
+            out << "      \"type\": \"" << RealSpace3::ToTimelineTrackTypeString(track.type) << "\",\n";
+            out << "      \"name\": \"" << JsonEscape(track.name) << "\",\n";
+            if (!track.target.empty()) {
+                out << "      \"target\": \"" << JsonEscape(track.target) << "\",\n";
+            }
+            out << "      \"keys\": [\n";
+            std::vector<std::string> keys;
+            for (const auto& key : track.transformKeys) {
+                std::ostringstream k;
+                k.setf(std::ios::fixed, std::ios::floatfield);
+                k.precision(4);
+                k << "{ \"t\": " << key.t
+                  << ", \"position\": [" << key.position.x << ", " << key.position.y << ", " << key.position.z << "]"
+                  << ", \"rotationDeg\": [" << key.rotationDeg.x << ", " << key.rotationDeg.y << ", " << key.rotationDeg.z << "]"
+                  << ", \"scale\": " << key.scale
+                  << ", \"ease\": \"" << TimelineEaseToString(key.ease) << "\" }";
+                keys.push_back(k.str());
+            }
+            for (const auto& key : track.lightKeys) {
+                std::ostringstream k;
+                k.setf(std::ios::fixed, std::ios::floatfield);
+                k.precision(4);
+                k << "{ \"t\": " << key.t
+                  << ", \"color\": [" << key.color.x << ", " << key.color.y << ", " << key.color.z << "]"
+                  << ", \"intensity\": " << key.intensity
+                  << ", \"ease\": \"" << TimelineEaseToString(key.ease) << "\" }";
+                keys.push_back(k.str());
+            }
+            for (const auto& key : track.fogKeys) {
+                std::ostringstream k;
+                k.setf(std::ios::fixed, std::ios::floatfield);
+                k.precision(4);
+                k << "{ \"t\": " << key.t
+                  << ", \"min\": " << key.fogMin
+                  << ", \"max\": " << key.fogMax
+                  << ", \"color\": [" << key.color.x << ", " << key.color.y << ", " << key.color.z << "]"
+                  << ", \"ease\": \"" << TimelineEaseToString(key.ease) << "\" }";
+                keys.push_back(k.str());
+            }
+            for (const auto& key : track.clipKeys) {
+                std::ostringstream k;
+                k.setf(std::ios::fixed, std::ios::floatfield);
+                k.precision(4);
+                k << "{ \"t\": " << key.t
+                  << ", \"clip\": \"" << JsonEscape(key.clip) << "\""
+                  << ", \"speed\": " << key.speed
+                  << ", \"loop\": " << (key.loop ? "true" : "false") << " }";
+                keys.push_back(k.str());
+            }
+            for (size_t k = 0; k < keys.size(); ++k) {
+                out << "        " << keys[k] << (k + 1 < keys.size() ? ",\n" : "\n");
+            }
+            out << "      ]\n";
+            out << "    }" << (i + 1 < tl.tracks.size() ? ",\n" : "\n");
+        }
+        out << "  ]";
+    }
+    if (tl.audio.enabled || !tl.audio.file.empty() || !tl.audio.clips.empty()) {
         out << ",\n";
         out << "  \"audio\": {\n";
         out << "    \"file\": \"" << JsonEscape(tl.audio.file) << "\",\n";
         out << "    \"offsetSec\": " << tl.audio.offsetSec << ",\n";
-        out << "    \"gainDb\": " << tl.audio.gainDb << "\n";
+        out << "    \"gainDb\": " << tl.audio.gainDb << (tl.audio.clips.empty() ? "\n" : ",\n");
+        if (!tl.audio.clips.empty()) {
+            out << "    \"clips\": [\n";
+            for (size_t i = 0; i < tl.audio.clips.size(); ++i) {
+                const auto& clip = tl.audio.clips[i];
+                out << "      { \"file\": \"" << JsonEscape(clip.file) << "\""
+                    << ", \"startSec\": " << clip.startSec
+                    << ", \"trimInSec\": " << clip.trimInSec
+                    << ", \"durationSec\": " << clip.durationSec
+                    << ", \"gainDb\": " << clip.gainDb
+                    << ", \"fadeInSec\": " << clip.fadeInSec
+                    << ", \"fadeOutSec\": " << clip.fadeOutSec << " }"
+                    << (i + 1 < tl.audio.clips.size() ? ",\n" : "\n");
+            }
+            out << "    ]\n";
+        }
         out << "  }\n";
     } else {
         out << "\n";
@@ -279,6 +390,15 @@ bool SaveTimelineToFile(const std::string& path, const RealSpace3::RS3TimelineDa
         if (outError) *outError = "Failed to write timeline file.";
         return false;
     }
+    out.close();
+
+    // The runtime maps the compiled sibling instead of parsing the JSON; written after the
+    // JSON so its timestamp marks it as current.
+    const std::string compiledPath = RealSpace3::RS3CompiledTimeline::GetCompiledPath(path);
+    std::string compileError;
+    if (!RealSpace3::RS3CompiledTimeline::WriteFile(tl, compiledPath, &compileError)) {
+        AppLogger::Log("[CINE] Compiled timeline not written: " + compileError);
+    }
     return true;
 }
 
@@ -433,6 +553,10 @@ void ApplyCurrentCameraPose() {
         return;
     }
     (void)RealSpace3::SceneManager::getInstance().setCameraPose(pose, true);
+
+    if (g_player.EvaluateTracks(g_trackFrame)) {
+        RealSpace3::SceneManager::getInstance().setEnvironmentOverride(RealSpace3::BuildEnvironmentOverride(g_trackFrame));
+    }
 }
 
 void RefreshTimelineUi() {
@@ -461,6 +585,21 @@ void PopulateTrackList() {
             kf.fovDeg);
         SendMessageA(g_ui.trackList, LB_ADDSTRING, 0, reinterpret_cast<LPARAM>(row));
     }
+
+    for (size_t i = 0; i < g_timelineData.tracks.size(); ++i) {
+        const auto& track = g_timelineData.tracks[i];
+        const size_t keyCount = track.transformKeys.size() + track.lightKeys.size() + track.fogKeys.size() + track.clipKeys.size();
+        char row[256] = {};
+        std::snprintf(row, sizeof(row),
+            "Track %zu: %s (%s) | %zu keys%s%s",
+            i + 2,
+            track.name.empty() ? "Unnamed" : track.name.c_str(),
+            RealSpace3::ToTimelineTrackTypeString(track.type),
+            keyCount,
+            track.target.empty() ? "" : " | target=",
+            track.target.c_str());
+        SendMessageA(g_ui.trackList, LB_ADDSTRING, 0, reinterpret_cast<LPARAM>(row));
+    }
 }
 
 void AddSceneTreeNode(HTREEITEM parent, const char* label, HTREEITEM* outItem = nullptr) {
@@ -514,9 +653,20 @@ void AddDynamicPropNode() {
     AddSceneTreeNode(g_ui.rootProps, label);
     TreeView_Expand(g_ui.sceneTree, g_ui.rootProps, TVE_EXPAND);
 
+    // Each dynamic prop gets a transform track on the current showcase model, keyed at the playhead
+    RealSpace3::RS3TimelineTrack track;
+    track.type = RealSpace3::RS3TimelineTrackType::Transform;
+    track.name = label;
+    track.target = g_currentShowcaseObjectModel;
+    RealSpace3::RS3TimelineTransformKey key;
+    key.t = g_player.GetCurrentTime();
+    track.transformKeys.push_back(key);
+    g_timelineData.tracks.push_back(std::move(track));
+
+    PopulateTrackList();
     SetInspectorText(std::string("New scene node added:\r\n") + label +
-        "\r\n\r\nThis is an editor object entry (timeline-ready scaffold).\r\n"
-        "Next milestone: bind model ID and transform gizmo.");
+        "\r\n\r\nTransform track created for '" + g_currentShowcaseObjectModel + "'.\r\n"
+        "Next milestone: transform gizmo to key position, rotation and scale.");
     MarkSceneDirty(true);
 }
 
@@ -741,69 +891,6 @@ void RenderOneFrame(RealSpace3::RDeviceDX11* device) {
     RealSpace3::SceneManager::getInstance().drawShowcaseOverlay(device->GetContext());
 }
 
-bool RunCommand(const std::string& command) {
-    AppLogger::Log("[CINE] Running command: " + command);
-    const int rc = std::system(command.c_str());
-    AppLogger::Log("[CINE] Command exit code: " + std::to_string(rc));
-    return rc == 0;
-}
-
-bool WriteBmp32(const std::filesystem::path& filePath, const std::vector<uint8_t>& bgra, uint32_t width, uint32_t height) {
-    if (bgra.size() < static_cast<size_t>(width) * static_cast<size_t>(height) * 4u) return false;
-
-    struct BmpFileHeader {
-        uint16_t bfType;
-        uint32_t bfSize;
-        uint16_t bfReserved1;
-        uint16_t bfReserved2;
-        uint32_t bfOffBits;
-    };
-
-    struct BmpInfoHeader {
-        uint32_t biSize;
-        int32_t biWidth;
-        int32_t biHeight;
-        uint16_t biPlanes;
-        uint16_t biBitCount;
-        uint32_t biCompression;
-        uint32_t biSizeImage;
-        int32_t biXPelsPerMeter;
-        int32_t biYPelsPerMeter;
-        uint32_t biClrUsed;
-        uint32_t biClrImportant;
-    };
-
-    const uint32_t rowStride = width * 4u;
-    const uint32_t imageSize = rowStride * height;
-
-    BmpFileHeader fileHeader = {};
-    fileHeader.bfType = 0x4D42;
-    fileHeader.bfOffBits = sizeof(BmpFileHeader) + sizeof(BmpInfoHeader);
-    fileHeader.bfSize = fileHeader.bfOffBits + imageSize;
-
-    BmpInfoHeader infoHeader = {};
-    infoHeader.biSize = sizeof(BmpInfoHeader);
-    infoHeader.biWidth = static_cast<int32_t>(width);
-    infoHeader.biHeight = static_cast<int32_t>(height);
-    infoHeader.biPlanes = 1;
-    infoHeader.biBitCount = 32;
-    infoHeader.biCompression = 0;
-    infoHeader.biSizeImage = imageSize;
-
-    std::ofstream out(filePath, std::ios::binary);
-    if (!out.is_open()) return false;
-
-    out.write(reinterpret_cast<const char*>(&fileHeader), sizeof(fileHeader));
-    out.write(reinterpret_cast<const char*>(&infoHeader), sizeof(infoHeader));
-
-    for (int y = static_cast<int>(height) - 1; y >= 0; --y) {
-        const uint8_t* row = bgra.data() + static_cast<size_t>(y) * rowStride;
-        out.write(reinterpret_cast<const char*>(row), rowStride);
-    }
-
-    return out.good();
-}
-
 bool ConfigureSceneForTimeline(const RealSpace3::RS3TimelineData& timeline) {
     auto& sm = RealSpace3::SceneManager::getInstance();
 
@@ -850,7 +937,7 @@ bool RestartPlaybackForCurrentScene(bool paused) {
         (void)sm.setCreationPreview(0, 0, 0, 0);
         (void)sm.setShowcaseObjectModel(g_currentShowcaseObjectModel);
     }
-    return StartTimelinePlayback(g_options.preview && g_options.exportMp4Path.empty(), paused, 0.0f, g_timelineData.durationSec);
+    return StartTimelinePlayback(g_options.preview && !IsExportRequested(g_options), paused, 0.0f, g_timelineData.durationSec);
 }
 
 bool ConfirmDiscardIfDirty() {
@@ -1028,21 +1115,115 @@ void ApplyRenderModeCommand(int commandId) {
     MarkSceneDirty(true);
 }
 
-bool ExportTimeline(
-    RealSpace3::RDeviceDX11* device,
+// Export pipeline depth: the back buffer is mapped kCaptureRingSize - 1 frames after its copy
+// was queued, and up to kWriterPoolSize frames wait for the sink (ffmpeg pipe or encoders).
+constexpr uint32_t kCaptureRingSize = 3;
+constexpr uint32_t kWriterPoolSize = 4;
+constexpr uint32_t kExportSampleRate = 48000;
+
+// Timeline audio with --audio replacing the single-track file.
+RealSpace3::RS3TimelineAudio GetExportAudio(const CineOptions& options, const RealSpace3::RS3TimelineData& timelineData) {
+    RealSpace3::RS3TimelineAudio audio = timelineData.audio;
+    if (!options.audioPathOverride.empty()) {
+        audio.file = options.audioPathOverride;
+        audio.enabled = true;
+    }
+    return audio;
+}
+
+// Mixes every audio clip of the timeline into a 16-bit WAV as long as the exported video.
+// outPath stays empty when the timeline has no audio. Without clips, a file the mixer cannot
+// read (not WAV) is left to ffmpeg's own -itsoffset/volume handling instead of failing.
+bool RenderExportAudio(
     const CineOptions& options,
-    const RealSpace3::RS3TimelineData& timelineData) {
-    if (!device) return false;
+    const RealSpace3::RS3TimelineData& timelineData,
+    int fps,
+    std::string& outPath,
+    bool& outLegacyAudio) {
+    outPath.clear();
+    outLegacyAudio = false;
+    const RealSpace3::RS3TimelineAudio audio = GetExportAudio(options, timelineData);
+    const size_t clipCount = RealSpace3::GetTimelineAudioClips(audio).size();
+    if (clipCount == 0) return true;
+
+    const auto mixStart = std::chrono::steady_clock::now();
+    const uint64_t frameCount = RealSpace3::GetTimelineAudioFrameCount(timelineData.durationSec, fps, kExportSampleRate);
+    RealSpace3::RS3AudioBuffer mix;
+    std::string error;
+    if (!RealSpace3::RenderTimelineAudio(audio, frameCount, kExportSampleRate, mix, &error)) {
+        if (audio.clips.empty()) {
+            AppLogger::Log("[CINE] Audio not mixed, passing it to ffmpeg: " + error);
+            outLegacyAudio = true;
+            return true;
+        }
+        AppLogger::Log("[CINE] Failed to mix timeline audio: " + error);
+        return false;
+    }
 
-    namespace fs = std::filesystem;
-    const auto nowTicks = std::chrono::steady_clock::now().time_since_epoch().count();
-    fs::path frameDir = fs::temp_directory_path() / ("ndg_cine_frames_" + std::to_string(nowTicks));
+    const std::string path = options.exportFramesDir.empty()
+        ? options.exportMp4Path + ".mix.wav"
+        : (std::filesystem::path(options.exportFramesDir) / "audio.wav").string();
     std::error_code ec;
-    fs::create_directories(frameDir, ec);
-    if (ec) {
-        AppLogger::Log("[CINE] Failed to create frame output dir: " + frameDir.string());
+    if (!options.exportFramesDir.empty()) {
+        std::filesystem::create_directories(std::filesystem::path(options.exportFramesDir), ec);
+    }
+    if (!RealSpace3::WavFile::WritePcm16(path, mix, &error)) {
+        AppLogger::Log("[CINE] Failed to write mixed audio: " + error);
         return false;
     }
+    const double mixMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - mixStart).count();
+    AppLogger::Log("[CINE] Audio mixed: clips=" + std::to_string(clipCount) +
+        " frames=" + std::to_string(frameCount) + " ms=" + std::to_string(mixMs) + " -> " + path);
+    outPath = path;
+    return true;
+}
+
+std::string BuildFfmpegExportCommand(
+    const CineOptions& options,
+    const RealSpace3::RS3TimelineData& timelineData,
+    const std::string& mixedAudioPath,
+    bool legacyAudio,
+    uint32_t width,
+    uint32_t height,
+    int fps) {
+    const std::string ffmpeg = options.ffmpegPath.empty() ? "ffmpeg" : options.ffmpegPath;
+    std::string command = "\"" + ffmpeg + "\" -y -loglevel error " +
+        RealSpace3::RS3FramePipeSink::BuildRawVideoInputArgs(width, height, fps);
+
+    // The mix already has offsets, gains and fades applied and matches the video length
+    if (!mixedAudioPath.empty()) {
+        command += " -i \"" + mixedAudioPath + "\"";
+        command += " -c:v libx264 -pix_fmt yuv420p -preset medium -crf 18";
+        command += " -c:a aac -b:a 192k -shortest";
+        command += " \"" + options.exportMp4Path + "\"";
+        return command;
+    }
+
+    const std::string audioPath = legacyAudio ? GetExportAudio(options, timelineData).file : std::string();
+    if (!audioPath.empty()) {
+        command += " -itsoffset " + std::to_string(timelineData.audio.offsetSec);
+        command += " -i \"" + audioPath + "\"";
+    }
+
+    command += " -c:v libx264 -pix_fmt yuv420p -preset medium -crf 18";
+    if (!audioPath.empty()) {
+        command += " -c:a aac -b:a 192k";
+        if (std::abs(timelineData.audio.gainDb) > 0.001f) {
+            const float gainLinear = std::pow(10.0f, timelineData.audio.gainDb / 20.0f);
+            command += " -filter:a \"volume=" + std::to_string(gainLinear) + "\"";
+        }
+        command += " -shortest";
+    }
+
+    command += " \"" + options.exportMp4Path + "\"";
+    return command;
+}
+
+bool ExportTimeline(
+    RealSpace3::RDeviceDX11* device,
+    const CineOptions& options,
+    const RealSpace3::RS3TimelineData& timelineData) {
+    if (!device) return false;
 
     RealSpace3::CinematicPlayer exportPlayer;
     RealSpace3::RS3TimelinePlaybackOptions exportOpts;
@@ -1061,18 +1242,54 @@ bool ExportTimeline(
 
     const int exportFps = std::max(1, options.fps > 0 ? options.fps : timelineData.fps);
     const float dt = 1.0f / static_cast<float>(exportFps);
-    const int totalFrames = std::max(1, static_cast<int>(std::ceil(timelineData.durationSec * exportFps)));
+    const int totalFrames = RealSpace3::GetTimelineFrameCount(timelineData.durationSec, exportFps);
 
-    AppLogger::Log("[CINE] Export started: frames=" + std::to_string(totalFrames) + " fps=" + std::to_string(exportFps));
+    // Audio is mixed offline up front: cheap next to the video, and ffmpeg reads it as a second input
+    std::string mixedAudioPath;
+    bool legacyAudio = false;
+    if (!RenderExportAudio(options, timelineData, exportFps, mixedAudioPath, legacyAudio)) {
+        return false;
+    }
+
+    if (!device->BeginCaptureRing(kCaptureRingSize)) {
+        AppLogger::Log("[CINE] Failed to create capture staging ring.");
+        return false;
+    }
 
-    std::vector<uint8_t> pixels;
-    uint32_t width = 0;
-    uint32_t height = 0;
+    // Frames stream straight into ffmpeg's stdin, or, with --frames, are encoded to PNG/QOI on a
+    // thread pool; either way nothing but the output is written to disk
+    std::unique_ptr<RealSpace3::RS3FrameSink> sink;
+    if (!options.exportFramesDir.empty()) {
+        sink = std::make_unique<RealSpace3::RS3ImageSequenceSink>(
+            options.exportFramesDir, "frame", options.framesFormat, options.encodeThreads);
+    } else {
+        sink = std::make_unique<RealSpace3::RS3FramePipeSink>([&](uint32_t width, uint32_t height, int fps) {
+            return BuildFfmpegExportCommand(options, timelineData, mixedAudioPath, legacyAudio, width, height, fps);
+        });
+    }
+    RealSpace3::RS3FrameWriter writer(*sink, kWriterPoolSize);
+    writer.Start(exportFps);
 
-    for (int frame = 0; frame < totalFrames; ++frame) {
-        if (frame > 0) {
-            exportPlayer.Update(dt);
+    AppLogger::Log("[CINE] Export started: frames=" + std::to_string(totalFrames) + " fps=" + std::to_string(exportFps));
+    const auto exportStart = std::chrono::steady_clock::now();
+
+    uint64_t nextReadIndex = 0;
+    const auto readOldestCapture = [&]() -> bool {
+        std::unique_ptr<RealSpace3::RS3CapturedFrame> captured = writer.AcquireFrame();
+        if (!captured) return false;
+        captured->index = nextReadIndex;
+        if (!device->ReadQueuedCapture(captured->bgra, captured->width, captured->height)) {
+            AppLogger::Log("[CINE] Failed to read back frame " + std::to_string(nextReadIndex));
+            return false;
         }
+        ++nextReadIndex;
+        return writer.SubmitFrame(std::move(captured));
+    };
+
+    bool ok = true;
+    for (int frame = 0; frame < totalFrames && ok; ++frame) {
+        // Same sample times as RS3CineEval, so its pose dumps describe the exported frames
+        exportPlayer.Seek(RealSpace3::GetTimelineFrameTime(frame, exportFps));
 
         RealSpace3::RS3CameraPose pose;
         if (exportPlayer.EvaluateCameraPose(pose)) {
@@ -1082,52 +1299,44 @@ bool ExportTimeline(
         RealSpace3::SceneManager::getInstance().update(dt);
         RenderOneFrame(device);
 
-        if (!device->ReadBackBufferBGRA(pixels, width, height)) {
-            AppLogger::Log("[CINE] Failed to read back frame " + std::to_string(frame));
-            return false;
+        if (device->GetQueuedCaptureCount() == device->GetCaptureSlotCount()) {
+            ok = readOldestCapture();
         }
-
-        char fileName[64] = {};
-        std::snprintf(fileName, sizeof(fileName), "frame_%06d.bmp", frame);
-        if (!WriteBmp32(frameDir / fileName, pixels, width, height)) {
-            AppLogger::Log("[CINE] Failed to write frame bitmap: " + std::string(fileName));
-            return false;
+        if (ok && !device->QueueBackBufferCapture()) {
+            AppLogger::Log("[CINE] Failed to queue capture of frame " + std::to_string(frame));
+            ok = false;
         }
 
         device->Present();
     }
-
-    const std::string ffmpeg = options.ffmpegPath.empty() ? "ffmpeg" : options.ffmpegPath;
-    std::string command = "\"" + ffmpeg + "\" -y -framerate " + std::to_string(exportFps) +
-        " -i \"" + (frameDir / "frame_%06d.bmp").string() + "\"";
-
-    std::string audioPath = options.audioPathOverride;
-    if (audioPath.empty() && timelineData.audio.enabled) {
-        audioPath = timelineData.audio.file;
+    while (ok && device->GetQueuedCaptureCount() > 0) {
+        ok = readOldestCapture();
     }
+    device->EndCaptureRing();
 
-    if (!audioPath.empty()) {
-        command += " -itsoffset " + std::to_string(timelineData.audio.offsetSec);
-        command += " -i \"" + audioPath + "\"";
+    std::string writeError;
+    if (!writer.Finish(&writeError)) {
+        AppLogger::Log("[CINE] Frame sink failed: " + writeError);
+        ok = false;
     }
 
-    command += " -c:v libx264 -pix_fmt yuv420p -preset medium -crf 18";
-    if (!audioPath.empty()) {
-        command += " -c:a aac -b:a 192k";
-        if (std::abs(timelineData.audio.gainDb) > 0.001f) {
-            const float gainLinear = std::pow(10.0f, timelineData.audio.gainDb / 20.0f);
-            command += " -filter:a \"volume=" + std::to_string(gainLinear) + "\"";
-        }
-        command += " -shortest";
-    }
+    const RealSpace3::RS3FrameWriterStats stats = writer.GetStats();
+    const double totalMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - exportStart).count();
+    AppLogger::Log("[CINE] Export frames=" + std::to_string(stats.framesWritten) +
+        " totalMs=" + std::to_string(totalMs) +
+        " sinkMs=" + std::to_string(stats.sinkMs) +
+        " renderStallMs=" + std::to_string(stats.producerWaitMs));
 
-    command += " \"" + options.exportMp4Path + "\"";
+    // The mp4 has its own copy of the mix; the image sequence keeps audio.wav next to the frames
+    if (!mixedAudioPath.empty() && options.exportFramesDir.empty()) {
+        std::error_code ec;
+        std::filesystem::remove(std::filesystem::path(mixedAudioPath), ec);
+    }
 
-    const bool ok = RunCommand(command);
     if (!ok) {
-        AppLogger::Log("[CINE] FFmpeg export failed.");
+        AppLogger::Log("[CINE] Export failed.");
     } else {
-        AppLogger::Log("[CINE] Export finished: " + options.exportMp4Path);
+        AppLogger::Log("[CINE] Export finished: " + (options.exportFramesDir.empty() ? options.exportMp4Path : options.exportFramesDir));
     }
     return ok;
 }
@@ -1259,7 +1468,7 @@ int WINAPI WinMain(HINSTANCE hInst, HINSTANCE, LPSTR, int nShow) {
 
     if (!ParseArgs(g_options)) {
         MessageBoxA(nullptr,
-            "Usage: RS3CineStudio [--timeline <file.ndgcine.json>] [--preview] [--export out.mp4] [--width N --height N --fps N] [--audio file] [--ffmpeg path]",
+            "Usage: RS3CineStudio [--timeline <file.ndgcine.json>] [--preview] [--export out.mp4] [--width N --height N --fps N] [--audio file] [--ffmpeg path] [--frames dir [--frames-format png|qoi] [--encode-threads N]]",
             "RS3CineStudio",
             MB_OK | MB_ICONINFORMATION);
         return 1;
@@ -1345,7 +1554,7 @@ int WINAPI WinMain(HINSTANCE hInst, HINSTANCE, LPSTR, int nShow) {
         (void)sm.setShowcaseObjectModel(g_currentShowcaseObjectModel);
     }
 
-    if (!StartTimelinePlayback(g_options.preview && g_options.exportMp4Path.empty(), false, 0.0f, g_timelineData.durationSec)) {
+    if (!StartTimelinePlayback(g_options.preview && !IsExportRequested(g_options), false, 0.0f, g_timelineData.durationSec)) {
         MessageBoxA(nullptr, "Failed to start timeline playback.", "RS3CineStudio", MB_OK | MB_ICONERROR);
         return 1;
     }
@@ -1355,7 +1564,7 @@ int WINAPI WinMain(HINSTANCE hInst, HINSTANCE, LPSTR, int nShow) {
 
     MarkSceneDirty(false);
 
-    if (!g_options.exportMp4Path.empty()) {
+    if (IsExportRequested(g_options)) {
         g_isExporting = true;
         const bool ok = ExportTimeline(g_device.get(), g_options, g_timelineData);
         return ok ? 0 : 2;
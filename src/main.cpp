@@ -12,6 +12,7 @@
 #include "RenderManager.h"
 #include "RealSpace3/Include/RDeviceDX11.h"
 #include "RealSpace3/Include/SceneManager.h"
+#include "RealSpace3/Include/LoadProfiler.h"
 #include "AppLogger.h"
 
 #pragma comment(lib, "user32.lib")
@@ -97,6 +98,28 @@ void SanitizeProxyEnvironment() {
     }
 }
 
+void WriteLoadTrace(const std::string& tracePath) {
+    if (tracePath.empty()) return;
+
+    RealSpace3::LoadProfiler& profiler = RealSpace3::LoadProfiler::getInstance();
+    for (int i = 0; i < static_cast<int>(RealSpace3::LoadStage::Package); ++i) {
+        const RealSpace3::LoadStage stage = static_cast<RealSpace3::LoadStage>(i);
+        const RealSpace3::LoadStageTotals totals = profiler.GetTotals(stage);
+        AppLogger::Log(std::string("SISTEMA: Load ") + RealSpace3::GetLoadStageName(stage) +
+            ": count=" + std::to_string(totals.count) +
+            " ms=" + std::to_string(static_cast<double>(totals.nanoseconds) / 1.0e6) +
+            " bytes=" + std::to_string(totals.bytes));
+    }
+
+    std::string error;
+    if (!profiler.ExportChromeTrace(tracePath, &error)) {
+        AppLogger::Log("SISTEMA ERRO: Trace de carregamento nao gravado: " + error);
+        return;
+    }
+    AppLogger::Log("SISTEMA: Trace de carregamento gravado em " + tracePath +
+        " (" + std::to_string(profiler.GetEventCount()) + " eventos).");
+}
+
 } // namespace
 
 LRESULT CALLBACK WindowProc(HWND hWnd, UINT msg, WPARAM wp, LPARAM lp) {
@@ -136,6 +159,15 @@ int WINAPI WinMain(HINSTANCE hInst, HINSTANCE hPrev, LPSTR lpCmd, int nShow) {
     AppLogger::Log("--- OPEN GUNZ: SYSTEM REBOOT ---");
     SanitizeProxyEnvironment();
 
+    // NDG_RS3_LOAD_TRACE=<file.json>: record asset loads, written as Chrome trace JSON on exit
+    const char* envLoadTrace = std::getenv("NDG_RS3_LOAD_TRACE");
+    const std::string loadTracePath = (envLoadTrace && *envLoadTrace) ? envLoadTrace : "";
+    if (!loadTracePath.empty()) {
+        RealSpace3::LoadProfiler::getInstance().SetEnabled(true);
+        RealSpace3::LoadProfiler::getInstance().SetThreadName("Main");
+        AppLogger::Log("SISTEMA: Profiler de carregamento ativo (NDG_RS3_LOAD_TRACE=" + loadTracePath + ").");
+    }
+
     WNDCLASSEX wc = { sizeof(WNDCLASSEX), CS_HREDRAW | CS_VREDRAW, WindowProc, 0, 0, hInst, NULL, LoadCursor(NULL, IDC_ARROW), NULL, NULL, _T("GunzNakamaClass"), NULL };
     RegisterClassEx(&wc);
     HWND hWnd = CreateWindowEx(NULL, _T("GunzNakamaClass"), _T("OpenGunZ"), WS_OVERLAPPEDWINDOW, CW_USEDEFAULT, CW_USEDEFAULT, 1280, 720, NULL, NULL, hInst, NULL);
@@ -195,5 +227,6 @@ int WINAPI WinMain(HINSTANCE hInst, HINSTANCE hPrev, LPSTR lpCmd, int nShow) {
             RenderManager::getInstance().render(); 
         }
     }
+    WriteLoadTrace(loadTracePath);
     return (int)msg.wParam;
 }
@@ -0,0 +1,688 @@
+// RS3SceneTool: world-geometry queries over a scene package without a window or GPU. Loads
+// scenes/<id> through the asset filesystem (same lookup as the game), or generates a synthetic
+// voxel scene so the benchmarks run without game assets.
+//
+// --bench-collision compares point and segment queries on collision.bin as loaded
+// (ScenePackageCollisionNode, walked in place) against the flattened SceneCollisionBsp.
+// --bench-raycast times SceneRaycaster single-ray and packet queries and checks them against
+// a brute-force pass over every triangle.
+// --nav-bake builds the scene's navmesh offline and writes navmesh.bin, so packed scenes (which
+// have no writable sidecar) can ship it next to world.bin.
+// --bench-bcn needs no scene: it times BCnDecoder (the texture loader's CPU fallback for block
+// formats the device rejects) on random blocks, single-threaded and banded over threads.
+
+#include "RealSpace3/Include/AssetFileSystem.h"
+#include "RealSpace3/Include/BCnDecoder.h"
+#include "RealSpace3/Include/SceneCollision.h"
+#include "RealSpace3/Include/SceneNavigation.h"
+#include "RealSpace3/Include/SceneRaycast.h"
+#include "RealSpace3/Include/ScenePackageLoader.h"
+
+#include <DirectXMath.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using namespace RealSpace3;
+
+struct ToolOptions {
+    std::string sceneId;
+    std::string rootDir;
+    std::string outputPath;
+    uint32_t syntheticSize = 0; // > 0: generate a size x size voxel scene instead of loading one
+    uint32_t seed = 1;
+    uint32_t queries = 1000000;
+    uint32_t imageSize = 2048; // --bench-bcn texture edge
+    uint32_t threads = 0;      // --bench-bcn: 0 = hardware concurrency
+
+    bool benchCollision = false;
+    bool benchRaycast = false;
+    bool navBake = false;
+    bool benchBcn = false;
+};
+
+bool ParseArgs(int argc, char** argv, ToolOptions& out) {
+    auto consumeValue = [&](int& index, std::string& outValue) -> bool {
+        if (index + 1 >= argc) return false;
+        ++index;
+        outValue = argv[index];
+        return !outValue.empty();
+    };
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        std::string raw;
+        if (arg == "--scene") {
+            if (!consumeValue(i, out.sceneId)) return false;
+        } else if (arg == "--root") {
+            if (!consumeValue(i, out.rootDir)) return false;
+        } else if (arg == "--synthetic") {
+            if (!consumeValue(i, raw)) return false;
+            out.syntheticSize = static_cast<uint32_t>(std::min(1024, std::max(2, std::atoi(raw.c_str()))));
+        } else if (arg == "--seed") {
+            if (!consumeValue(i, raw)) return false;
+            out.seed = static_cast<uint32_t>(std::strtoul(raw.c_str(), nullptr, 10));
+        } else if (arg == "--queries") {
+            if (!consumeValue(i, raw)) return false;
+            out.queries = static_cast<uint32_t>(std::max(1, std::atoi(raw.c_str())));
+        } else if (arg == "--bench-collision") {
+            out.benchCollision = true;
+        } else if (arg == "--bench-raycast") {
+            out.benchRaycast = true;
+        } else if (arg == "--nav-bake") {
+            out.navBake = true;
+        } else if (arg == "--bench-bcn") {
+            out.benchBcn = true;
+        } else if (arg == "--size") {
+            if (!consumeValue(i, raw)) return false;
+            out.imageSize = static_cast<uint32_t>(std::min(16384, std::max(4, std::atoi(raw.c_str()))));
+        } else if (arg == "--threads") {
+            if (!consumeValue(i, raw)) return false;
+            out.threads = static_cast<uint32_t>(std::max(0, std::atoi(raw.c_str())));
+        } else if (arg == "--output") {
+            if (!consumeValue(i, out.outputPath)) return false;
+        } else {
+            return false;
+        }
+    }
+    const bool haveScene = !out.sceneId.empty() || out.syntheticSize > 0;
+    const bool sceneModes = out.benchCollision || out.benchRaycast || out.navBake;
+    return sceneModes ? haveScene : out.benchBcn;
+}
+
+struct Random {
+    uint32_t state;
+
+    explicit Random(uint32_t seed) : state(seed * 2654435761u + 0x9E3779B9u) {}
+
+    uint32_t Next() {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return state;
+    }
+    float Unit() { return static_cast<float>(Next() >> 8) * (1.0f / 16777216.0f); }
+    float Range(float lo, float hi) { return lo + (hi - lo) * Unit(); }
+};
+
+// Synthetic scene: a size x size x kSyntheticLayers voxel grid (kSyntheticCell units per voxel,
+// +Z up) with a solid floor layer and random pillars. The render mesh is the set of voxel faces
+// that border empty space; collision.bin is a BSP of axis planes over the same voxels, with
+// uniform regions collapsed to leaves and nodes stored in shuffled order like a converter dump.
+constexpr uint32_t kSyntheticLayers = 8;
+constexpr float kSyntheticCell = 64.0f;
+
+class SyntheticScene {
+public:
+    SyntheticScene(uint32_t size, uint32_t seed) : m_size(size), m_solid(size * size * kSyntheticLayers, 0) {
+        Random rng(seed);
+        for (uint32_t y = 0; y < size; ++y) {
+            for (uint32_t x = 0; x < size; ++x) {
+                m_solid[Index(x, y, 0)] = 1;
+                if (rng.Next() % 8 == 0) {
+                    const uint32_t height = 1 + rng.Next() % (kSyntheticLayers - 1);
+                    for (uint32_t z = 1; z <= height && z < kSyntheticLayers; ++z) m_solid[Index(x, y, z)] = 1;
+                }
+            }
+        }
+    }
+
+    void Fill(ScenePackageData& out, uint32_t seed) const {
+        out = ScenePackageData{};
+        out.sceneId = "synthetic";
+        out.boundsMin = { 0.0f, 0.0f, 0.0f };
+        out.boundsMax = { m_size * kSyntheticCell, m_size * kSyntheticCell, kSyntheticLayers * kSyntheticCell };
+        out.spawnPos = { kSyntheticCell * 0.5f, kSyntheticCell * 0.5f, kSyntheticCell + 1.0f };
+        out.hasSpawn = true;
+        out.materials.push_back(ScenePackageMaterial{});
+        BuildMesh(out);
+        BuildCollision(out.collision, seed);
+    }
+
+private:
+    uint32_t Index(uint32_t x, uint32_t y, uint32_t z) const { return (z * m_size + y) * m_size + x; }
+
+    bool IsSolid(int x, int y, int z) const {
+        if (x < 0 || y < 0 || z < 0 || x >= static_cast<int>(m_size) || y >= static_cast<int>(m_size) || z >= static_cast<int>(kSyntheticLayers)) {
+            return false;
+        }
+        return m_solid[Index(x, y, z)] != 0;
+    }
+
+    void BuildMesh(ScenePackageData& out) const {
+        static const int kNormals[6][3] = { { 1, 0, 0 }, { -1, 0, 0 }, { 0, 1, 0 }, { 0, -1, 0 }, { 0, 0, 1 }, { 0, 0, -1 } };
+        for (uint32_t z = 0; z < kSyntheticLayers; ++z) {
+            for (uint32_t y = 0; y < m_size; ++y) {
+                for (uint32_t x = 0; x < m_size; ++x) {
+                    if (!m_solid[Index(x, y, z)]) continue;
+                    for (const auto& n : kNormals) {
+                        if (IsSolid(x + n[0], y + n[1], z + n[2])) continue;
+                        AddFace(out, static_cast<float>(x), static_cast<float>(y), static_cast<float>(z), n);
+                    }
+                }
+            }
+        }
+        ScenePackageSection section;
+        section.indexCount = static_cast<uint32_t>(out.indices.size());
+        out.sections.push_back(section);
+    }
+
+    // Quad on the face of voxel (x, y, z) with outward normal n, wound counter-clockwise seen from outside
+    static void AddFace(ScenePackageData& out, float x, float y, float z, const int n[3]) {
+        const int axis = n[0] != 0 ? 0 : (n[1] != 0 ? 1 : 2);
+        const int u = (axis + 1) % 3;
+        const int v = (axis + 2) % 3;
+        float base[3] = { x, y, z };
+        if (n[axis] > 0) base[axis] += 1.0f;
+
+        const uint32_t first = static_cast<uint32_t>(out.vertices.size());
+        static const float kCorners[4][2] = { { 0, 0 }, { 1, 0 }, { 1, 1 }, { 0, 1 } };
+        for (const auto& corner : kCorners) {
+            float p[3] = { base[0], base[1], base[2] };
+            p[u] += corner[0];
+            p[v] += corner[1];
+            ScenePackageVertex vertex;
+            vertex.pos = { p[0] * kSyntheticCell, p[1] * kSyntheticCell, p[2] * kSyntheticCell };
+            vertex.normal = { static_cast<float>(n[0]), static_cast<float>(n[1]), static_cast<float>(n[2]) };
+            vertex.uv = { corner[0], corner[1] };
+            out.vertices.push_back(vertex);
+        }
+        // (u, v, axis) is right-handed, so corner order is CCW around +axis
+        static const uint32_t kPos[6] = { 0, 1, 2, 0, 2, 3 };
+        static const uint32_t kNeg[6] = { 0, 2, 1, 0, 3, 2 };
+        for (const uint32_t k : (n[axis] > 0 ? kPos : kNeg)) out.indices.push_back(first + k);
+    }
+
+    struct Box {
+        uint32_t lo[3];
+        uint32_t hi[3];
+    };
+
+    // 0 = all empty, 1 = all solid, 2 = mixed
+    int Classify(const Box& box) const {
+        bool anySolid = false;
+        bool anyEmpty = false;
+        for (uint32_t z = box.lo[2]; z < box.hi[2]; ++z) {
+            for (uint32_t y = box.lo[1]; y < box.hi[1]; ++y) {
+                for (uint32_t x = box.lo[0]; x < box.hi[0]; ++x) {
+                    (m_solid[Index(x, y, z)] ? anySolid : anyEmpty) = true;
+                    if (anySolid && anyEmpty) return 2;
+                }
+            }
+        }
+        return anySolid ? 1 : 0;
+    }
+
+    int32_t BuildNode(const Box& box, std::vector<ScenePackageCollisionNode>& nodes) const {
+        const int kind = Classify(box);
+        const int32_t index = static_cast<int32_t>(nodes.size());
+        nodes.emplace_back();
+        if (kind != 2) {
+            nodes[index].solid = kind == 1;
+            return index;
+        }
+
+        int axis = 0;
+        for (int a = 1; a < 3; ++a) {
+            if (box.hi[a] - box.lo[a] > box.hi[axis] - box.lo[axis]) axis = a;
+        }
+        const uint32_t split = (box.lo[axis] + box.hi[axis]) / 2;
+        Box neg = box;
+        Box pos = box;
+        neg.hi[axis] = split;
+        pos.lo[axis] = split;
+
+        DirectX::XMFLOAT4 plane = { 0.0f, 0.0f, 0.0f, -static_cast<float>(split) * kSyntheticCell };
+        (axis == 0 ? plane.x : (axis == 1 ? plane.y : plane.z)) = 1.0f;
+        nodes[index].plane = plane;
+        const int32_t posChild = BuildNode(pos, nodes);
+        const int32_t negChild = BuildNode(neg, nodes);
+        nodes[index].posChild = posChild;
+        nodes[index].negChild = negChild;
+        return index;
+    }
+
+    void BuildCollision(ScenePackageCollision& out, uint32_t seed) const {
+        std::vector<ScenePackageCollisionNode> nodes;
+        const Box all = { { 0, 0, 0 }, { m_size, m_size, kSyntheticLayers } };
+        const int32_t root = BuildNode(all, nodes);
+
+        std::vector<int32_t> order(nodes.size());
+        for (size_t i = 0; i < order.size(); ++i) order[i] = static_cast<int32_t>(i);
+        Random rng(seed ^ 0x5EEDu);
+        for (size_t i = order.size(); i > 1; --i) std::swap(order[i - 1], order[rng.Next() % i]);
+
+        out.nodes.assign(nodes.size(), ScenePackageCollisionNode{});
+        for (size_t i = 0; i < nodes.size(); ++i) {
+            ScenePackageCollisionNode node = nodes[i];
+            if (node.posChild >= 0) node.posChild = order[node.posChild];
+            if (node.negChild >= 0) node.negChild = order[node.negChild];
+            out.nodes[order[i]] = node;
+        }
+        out.rootIndex = order[root];
+    }
+
+    uint32_t m_size;
+    std::vector<uint8_t> m_solid;
+};
+
+bool LoadScene(const ToolOptions& options, ScenePackageData& out) {
+    if (options.syntheticSize > 0) {
+        SyntheticScene(options.syntheticSize, options.seed).Fill(out, options.seed);
+        return true;
+    }
+
+    std::string error;
+    if (!options.rootDir.empty() && !AssetFileSystem::getInstance().MountDirectory(options.rootDir, &error)) {
+        std::fprintf(stderr, "[SCENE] Failed to mount %s: %s\n", options.rootDir.c_str(), error.c_str());
+        return false;
+    }
+    if (!ScenePackageLoader::Load(options.sceneId, out, &error)) {
+        std::fprintf(stderr, "[SCENE] Failed to load scene '%s': %s\n", options.sceneId.c_str(), error.c_str());
+        return false;
+    }
+    return true;
+}
+
+// ---- Collision: collision.bin as loaded, walked without conversion -----------------------------
+
+bool SourceIsPointSolid(const ScenePackageCollision& bsp, const DirectX::XMFLOAT3& point) {
+    const DirectX::XMVECTOR p = DirectX::XMLoadFloat3(&point);
+    int32_t index = bsp.rootIndex;
+    while (index >= 0) {
+        const ScenePackageCollisionNode& node = bsp.nodes[index];
+        if (node.posChild < 0 && node.negChild < 0) return node.solid;
+        const float d = DirectX::XMVectorGetX(DirectX::XMPlaneDotCoord(DirectX::XMLoadFloat4(&node.plane), p));
+        index = d >= 0.0f ? node.posChild : node.negChild;
+    }
+    return false;
+}
+
+bool SourceTraceSegment(const ScenePackageCollision& bsp, int32_t index, DirectX::FXMVECTOR a, DirectX::FXMVECTOR b,
+                        float t0, float t1, float& outFraction) {
+    if (index < 0) return false;
+    const ScenePackageCollisionNode& node = bsp.nodes[index];
+    if (node.posChild < 0 && node.negChild < 0) {
+        if (node.solid) outFraction = t0;
+        return node.solid;
+    }
+
+    const DirectX::XMVECTOR plane = DirectX::XMLoadFloat4(&node.plane);
+    const float da = DirectX::XMVectorGetX(DirectX::XMPlaneDotCoord(plane, a));
+    const float db = DirectX::XMVectorGetX(DirectX::XMPlaneDotCoord(plane, b));
+    const float d0 = da + (db - da) * t0;
+    const float d1 = da + (db - da) * t1;
+    if (d0 >= 0.0f && d1 >= 0.0f) return SourceTraceSegment(bsp, node.posChild, a, b, t0, t1, outFraction);
+    if (d0 < 0.0f && d1 < 0.0f) return SourceTraceSegment(bsp, node.negChild, a, b, t0, t1, outFraction);
+
+    const float tSplit = std::max(t0, std::min(t1, da / (da - db)));
+    const bool nearPos = d0 >= 0.0f;
+    if (SourceTraceSegment(bsp, nearPos ? node.posChild : node.negChild, a, b, t0, tSplit, outFraction)) return true;
+    return SourceTraceSegment(bsp, nearPos ? node.negChild : node.posChild, a, b, tSplit, t1, outFraction);
+}
+
+struct Segment {
+    DirectX::XMFLOAT3 from;
+    DirectX::XMFLOAT3 to;
+};
+
+template <typename Fn>
+double TimeMs(Fn&& fn) {
+    const auto start = std::chrono::steady_clock::now();
+    fn();
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+int RunCollisionBenchmark(const ToolOptions& options, const ScenePackageData& scene) {
+    SceneCollisionBsp flat;
+    std::string error;
+    double buildMs = 0.0;
+    bool built = false;
+    buildMs = TimeMs([&]() { built = SceneCollisionBsp::Build(scene.collision, flat, &error); });
+    if (!built) {
+        std::fprintf(stderr, "[SCENE] collision.bin rejected: %s\n", error.c_str());
+        return 1;
+    }
+    if (flat.IsEmpty()) {
+        std::fprintf(stderr, "[SCENE] Scene has no collision BSP.\n");
+        return 1;
+    }
+
+    // Queries cover the scene bounds plus a margin; segments are up to a tenth of the extent long
+    const DirectX::XMFLOAT3& lo = scene.boundsMin;
+    const DirectX::XMFLOAT3& hi = scene.boundsMax;
+    const float margin = 0.05f * std::max({ hi.x - lo.x, hi.y - lo.y, hi.z - lo.z, 1.0f });
+    const float reach = 2.0f * margin;
+    Random rng(options.seed);
+    std::vector<DirectX::XMFLOAT3> points(options.queries);
+    std::vector<Segment> segments(options.queries);
+    for (uint32_t i = 0; i < options.queries; ++i) {
+        points[i] = { rng.Range(lo.x - margin, hi.x + margin), rng.Range(lo.y - margin, hi.y + margin), rng.Range(lo.z - margin, hi.z + margin) };
+        const DirectX::XMFLOAT3 from = { rng.Range(lo.x, hi.x), rng.Range(lo.y, hi.y), rng.Range(lo.z, hi.z) };
+        segments[i] = { from, { from.x + rng.Range(-reach, reach), from.y + rng.Range(-reach, reach), from.z + rng.Range(-reach, reach) } };
+    }
+
+    uint32_t sourceSolid = 0;
+    uint32_t flatSolid = 0;
+    uint32_t sourceHits = 0;
+    uint32_t flatHits = 0;
+    double sourceFractionSum = 0.0;
+    double flatFractionSum = 0.0;
+    uint32_t mismatches = 0;
+    std::vector<uint8_t> sourcePoint(options.queries);
+    std::vector<float> sourceFraction(options.queries, -1.0f);
+
+    const double sourcePointMs = TimeMs([&]() {
+        for (uint32_t i = 0; i < options.queries; ++i) {
+            sourcePoint[i] = SourceIsPointSolid(scene.collision, points[i]) ? 1 : 0;
+            sourceSolid += sourcePoint[i];
+        }
+    });
+    const double flatPointMs = TimeMs([&]() {
+        for (uint32_t i = 0; i < options.queries; ++i) {
+            const bool solid = flat.IsPointSolid(points[i]);
+            flatSolid += solid ? 1 : 0;
+            mismatches += (solid ? 1 : 0) != sourcePoint[i] ? 1 : 0;
+        }
+    });
+    const double sourceTraceMs = TimeMs([&]() {
+        for (uint32_t i = 0; i < options.queries; ++i) {
+            const DirectX::XMVECTOR a = DirectX::XMLoadFloat3(&segments[i].from);
+            const DirectX::XMVECTOR b = DirectX::XMLoadFloat3(&segments[i].to);
+            float fraction = 1.0f;
+            if (SourceTraceSegment(scene.collision, scene.collision.rootIndex, a, b, 0.0f, 1.0f, fraction)) {
+                ++sourceHits;
+                sourceFractionSum += fraction;
+                sourceFraction[i] = fraction;
+            }
+        }
+    });
+    const double flatTraceMs = TimeMs([&]() {
+        for (uint32_t i = 0; i < options.queries; ++i) {
+            float fraction = 1.0f;
+            const bool hit = flat.TraceSegment(segments[i].from, segments[i].to, &fraction);
+            if (hit) {
+                ++flatHits;
+                flatFractionSum += fraction;
+            }
+            mismatches += (hit ? fraction : -1.0f) != sourceFraction[i] ? 1 : 0;
+        }
+    });
+
+    const double perQuery = 1e6 / options.queries; // ms -> ns per query
+    std::fprintf(stderr, "[SCENE] collision nodes=%zu flatNodes=%zu build=%.2fms queries=%u\n",
+        scene.collision.nodes.size(), flat.GetNodeCount(), buildMs, options.queries);
+    std::fprintf(stderr, "[SCENE] point   source=%.1fns flat=%.1fns speedup=%.2fx solid=%u/%u\n",
+        sourcePointMs * perQuery, flatPointMs * perQuery, sourcePointMs / std::max(flatPointMs, 1e-6), sourceSolid, flatSolid);
+    std::fprintf(stderr, "[SCENE] segment source=%.1fns flat=%.1fns speedup=%.2fx hits=%u/%u fractionSum=%.6f/%.6f\n",
+        sourceTraceMs * perQuery, flatTraceMs * perQuery, sourceTraceMs / std::max(flatTraceMs, 1e-6),
+        sourceHits, flatHits, sourceFractionSum, flatFractionSum);
+    if (mismatches != 0) {
+        std::fprintf(stderr, "[SCENE] %u results differ between the two layouts.\n", mismatches);
+        return 1;
+    }
+    return 0;
+}
+
+// ---- Raycast ------------------------------------------------------------------------------------
+
+// Reference closest hit over every triangle of the package, same Moller-Trumbore test as
+// SceneRaycaster; only the distance is compared (ties between coplanar triangles may pick
+// either one).
+float BruteForceRaycast(const ScenePackageData& scene, const SceneRay& ray) {
+    const DirectX::XMFLOAT3& o = ray.origin;
+    const DirectX::XMFLOAT3& d = ray.direction;
+    float best = ray.maxDistance;
+    bool hit = false;
+    for (const ScenePackageSection& sec : scene.sections) {
+        for (uint32_t i = sec.indexStart; i + 2 < sec.indexStart + sec.indexCount; i += 3) {
+            const DirectX::XMFLOAT3& p0 = scene.vertices[scene.indices[i]].pos;
+            const DirectX::XMFLOAT3& p1 = scene.vertices[scene.indices[i + 1]].pos;
+            const DirectX::XMFLOAT3& p2 = scene.vertices[scene.indices[i + 2]].pos;
+            const DirectX::XMFLOAT3 e1 = { p1.x - p0.x, p1.y - p0.y, p1.z - p0.z };
+            const DirectX::XMFLOAT3 e2 = { p2.x - p0.x, p2.y - p0.y, p2.z - p0.z };
+            const DirectX::XMFLOAT3 p = { d.y * e2.z - d.z * e2.y, d.z * e2.x - d.x * e2.z, d.x * e2.y - d.y * e2.x };
+            const float det = e1.x * p.x + e1.y * p.y + e1.z * p.z;
+            if (std::fabs(det) < 1e-8f) continue;
+            const float invDet = 1.0f / det;
+            const DirectX::XMFLOAT3 tv = { o.x - p0.x, o.y - p0.y, o.z - p0.z };
+            const float u = (tv.x * p.x + tv.y * p.y + tv.z * p.z) * invDet;
+            if (u < 0.0f || u > 1.0f) continue;
+            const DirectX::XMFLOAT3 q = { tv.y * e1.z - tv.z * e1.y, tv.z * e1.x - tv.x * e1.z, tv.x * e1.y - tv.y * e1.x };
+            const float v = (d.x * q.x + d.y * q.y + d.z * q.z) * invDet;
+            if (v < 0.0f || u + v > 1.0f) continue;
+            const float t = (e2.x * q.x + e2.y * q.y + e2.z * q.z) * invDet;
+            if (t > 1e-4f && t < best) {
+                best = t;
+                hit = true;
+            }
+        }
+    }
+    return hit ? best : -1.0f;
+}
+
+bool SameHit(const SceneRayHit& hit, float expected) {
+    if (!hit.hit || expected < 0.0f) return hit.hit == (expected >= 0.0f);
+    return std::fabs(hit.distance - expected) <= 1e-4f * std::max(1.0f, expected);
+}
+
+int RunRaycastBenchmark(const ToolOptions& options, const ScenePackageData& scene) {
+    SceneRaycaster raycaster;
+    std::string error;
+    bool built = false;
+    const double buildMs = TimeMs([&]() { built = SceneRaycaster::Build(scene, raycaster, &error); });
+    if (!built) {
+        std::fprintf(stderr, "[SCENE] Raycaster build failed: %s\n", error.c_str());
+        return 1;
+    }
+
+    const DirectX::XMFLOAT3& lo = scene.boundsMin;
+    const DirectX::XMFLOAT3& hi = scene.boundsMax;
+    const float extent = std::max({ hi.x - lo.x, hi.y - lo.y, hi.z - lo.z, 1.0f });
+
+    // "random": incoherent rays from anywhere in the bounds. "fan": a 2D grid of directions from
+    // the spawn point, neighbours adjacent like a camera's pixels (what packets are built for).
+    Random rng(options.seed);
+    std::vector<SceneRay> randomRays(options.queries);
+    for (SceneRay& ray : randomRays) {
+        ray.origin = { rng.Range(lo.x, hi.x), rng.Range(lo.y, hi.y), rng.Range(lo.z, hi.z) };
+        const float z = rng.Range(-1.0f, 1.0f);
+        const float a = rng.Range(0.0f, 6.2831853f);
+        const float r = std::sqrt(std::max(0.0f, 1.0f - z * z));
+        ray.direction = { r * std::cos(a), r * std::sin(a), z };
+        ray.maxDistance = extent;
+    }
+    std::vector<SceneRay> fanRays(options.queries);
+    const uint32_t fanWidth = std::max(1u, static_cast<uint32_t>(std::sqrt(static_cast<double>(options.queries))));
+    const DirectX::XMFLOAT3 eye = scene.hasSpawn ? scene.spawnPos : DirectX::XMFLOAT3{ (lo.x + hi.x) * 0.5f, (lo.y + hi.y) * 0.5f, (lo.z + hi.z) * 0.5f };
+    for (uint32_t i = 0; i < options.queries; ++i) {
+        const float yaw = (static_cast<float>(i % fanWidth) / fanWidth - 0.5f) * 1.5f + 0.785f;
+        const float pitch = (static_cast<float>(i / fanWidth) / fanWidth - 0.5f) * 1.0f;
+        fanRays[i].origin = { eye.x, eye.y, eye.z + 100.0f };
+        fanRays[i].direction = { std::cos(pitch) * std::cos(yaw), std::cos(pitch) * std::sin(yaw), std::sin(pitch) };
+        fanRays[i].maxDistance = extent;
+    }
+
+    std::fprintf(stderr, "[SCENE] raycast triangles=%zu nodes=%zu build=%.2fms queries=%u\n",
+        raycaster.GetTriangleCount(), raycaster.GetNodeCount(), buildMs, options.queries);
+
+    // Brute force costs a full triangle pass per ray: validate a prefix of each set
+    const uint32_t validated = std::min<uint32_t>(options.queries, 2048);
+    uint32_t mismatches = 0;
+    std::vector<SceneRayHit> hits(options.queries);
+    const std::pair<const char*, const std::vector<SceneRay>*> sets[] = { { "random", &randomRays }, { "fan", &fanRays } };
+    for (const auto& set : sets) {
+        const std::vector<SceneRay>& rays = *set.second;
+        uint32_t singleHits = 0;
+        const double singleMs = TimeMs([&]() {
+            for (uint32_t i = 0; i < options.queries; ++i) {
+                singleHits += raycaster.Raycast(rays[i], hits[i]) ? 1 : 0;
+            }
+        });
+        for (uint32_t i = 0; i < validated; ++i) {
+            mismatches += SameHit(hits[i], BruteForceRaycast(scene, rays[i])) ? 0 : 1;
+        }
+
+        uint32_t batchHits = 0;
+        const double batchMs = TimeMs([&]() { batchHits = raycaster.RaycastBatch(rays.data(), options.queries, hits.data()); });
+        for (uint32_t i = 0; i < validated; ++i) {
+            mismatches += SameHit(hits[i], BruteForceRaycast(scene, rays[i])) ? 0 : 1;
+        }
+
+        const double perQuery = 1e6 / options.queries;
+        std::fprintf(stderr, "[SCENE] %-6s single=%.1fns batch=%.1fns (%.2f Mrays/s) speedup=%.2fx hits=%u/%u\n",
+            set.first, singleMs * perQuery, batchMs * perQuery, options.queries / std::max(batchMs, 1e-6) / 1000.0,
+            singleMs / std::max(batchMs, 1e-6), singleHits, batchHits);
+    }
+
+    std::fprintf(stderr, "[SCENE] brute-force check: %u rays per set, %u mismatches\n", validated, mismatches);
+    return mismatches == 0 ? 0 : 1;
+}
+
+// ---- Navmesh bake -------------------------------------------------------------------------------
+
+int RunNavBake(const ToolOptions& options, const ScenePackageData& scene) {
+    std::string outputPath = options.outputPath;
+    if (outputPath.empty()) {
+        if (scene.baseDir.empty() || AssetFileSystem::IsVirtualPath(scene.baseDir)) {
+            std::fprintf(stderr, "[SCENE] Scene is not a loose directory; pass --output for navmesh.bin.\n");
+            return 1;
+        }
+        outputPath = (std::filesystem::path(scene.baseDir) / SceneNavMesh::kSidecarFileName).string();
+    }
+
+    // Default settings: the hash in the file only matches what the game computes with them
+    const SceneNavSettings settings;
+    SceneNavMesh mesh;
+    std::string error;
+    bool built = false;
+    const double buildMs = TimeMs([&]() { built = SceneNavMesh::Build(scene, settings, mesh, &error); });
+    if (!built) {
+        std::fprintf(stderr, "[SCENE] Navmesh build failed: %s\n", error.c_str());
+        return 1;
+    }
+    if (!mesh.SaveToFile(outputPath, &error)) {
+        std::fprintf(stderr, "[SCENE] Failed to write %s: %s\n", outputPath.c_str(), error.c_str());
+        return 1;
+    }
+
+    // Read it back the way LoadOrBuild does, against a freshly computed hash
+    SceneNavMesh reloaded;
+    if (!reloaded.LoadFromFile(outputPath, SceneNavMesh::ComputeSourceHash(scene, settings), &error)
+        || reloaded.GetPolygonCount() != mesh.GetPolygonCount() || reloaded.GetLinkCount() != mesh.GetLinkCount()) {
+        std::fprintf(stderr, "[SCENE] %s does not load back: %s\n", outputPath.c_str(), error.c_str());
+        return 1;
+    }
+    AssetFileSystem::getInstance().InvalidateLooseIndex();
+
+    std::error_code ec;
+    const auto bytes = std::filesystem::file_size(outputPath, ec);
+    std::fprintf(stderr, "[SCENE] navmesh polygons=%zu links=%zu hash=%016llx build=%.2fms bytes=%llu -> %s\n",
+        mesh.GetPolygonCount(), mesh.GetLinkCount(), static_cast<unsigned long long>(mesh.GetSourceHash()), buildMs,
+        static_cast<unsigned long long>(ec ? 0 : bytes), outputPath.c_str());
+    return 0;
+}
+
+// ---- BCn decode ---------------------------------------------------------------------------------
+
+uint64_t Fnv1a64(const uint8_t* data, size_t size) {
+    uint64_t hash = 14695981039346656037ull;
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= data[i];
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+int RunBcnBenchmark(const ToolOptions& options) {
+    struct FormatCase {
+        BCnFormat format;
+        const char* name;
+    };
+    static const FormatCase kFormats[] = {
+        { BCnFormat::BC1, "BC1" }, { BCnFormat::BC2, "BC2" }, { BCnFormat::BC3, "BC3" },
+        { BCnFormat::BC4, "BC4" }, { BCnFormat::BC5, "BC5" }, { BCnFormat::BC7, "BC7" },
+    };
+
+    const uint32_t size = options.imageSize;
+    const double megapixels = static_cast<double>(size) * size / 1e6;
+    std::fprintf(stderr, "[SCENE] bcn size=%ux%u simd=%s threads=%u\n", size, size, BCnDecoder::HasSimd() ? "sse2" : "scalar",
+        options.threads ? options.threads : std::max(1u, std::thread::hardware_concurrency()));
+
+    // Random bytes hit every BC1-BC5 palette mode and every BC7 mode (mode 8, all-zero
+    // first byte, is rare and decodes to zero as on the GPU)
+    Random rng(options.seed);
+    std::vector<uint8_t> single;
+    std::vector<uint8_t> banded;
+    int result = 0;
+    for (const FormatCase& fc : kFormats) {
+        std::vector<uint8_t> blocks(BCnDecoder::GetCompressedSize(fc.format, size, size));
+        for (uint8_t& b : blocks) b = static_cast<uint8_t>(rng.Next() >> 24);
+
+        std::string error;
+        bool ok = true;
+        const double singleMs = TimeMs([&]() {
+            ok &= BCnDecoder::Decode(fc.format, size, size, blocks.data(), blocks.size(), single, 1, &error);
+        });
+        const double bandedMs = TimeMs([&]() {
+            ok &= BCnDecoder::Decode(fc.format, size, size, blocks.data(), blocks.size(), banded, options.threads, &error);
+        });
+        if (!ok || single != banded) {
+            std::fprintf(stderr, "[SCENE] %s decode failed or threaded output differs: %s\n", fc.name, error.c_str());
+            result = 1;
+            continue;
+        }
+        std::fprintf(stderr, "[SCENE] %s 1 thread=%.1f Mpix/s (%.2fms) banded=%.1f Mpix/s (%.2fms) fnv1a64=%016llx\n",
+            fc.name, megapixels / (singleMs / 1000.0), singleMs, megapixels / (bandedMs / 1000.0), bandedMs,
+            static_cast<unsigned long long>(Fnv1a64(single.data(), single.size())));
+    }
+    return result;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    ToolOptions options;
+    if (!ParseArgs(argc, argv, options)) {
+        std::fprintf(stderr,
+            "Usage: RS3SceneTool (--scene <id> [--root dir] | --synthetic N [--seed N]) [--bench-collision] [--bench-raycast] [--queries N] [--nav-bake [--output navmesh.bin]]\n"
+            "       RS3SceneTool --bench-bcn [--size N] [--threads N] [--seed N]\n");
+        return 1;
+    }
+
+    int result = 0;
+    if (options.benchBcn) {
+        result |= RunBcnBenchmark(options);
+    }
+    if (!options.benchCollision && !options.benchRaycast && !options.navBake) {
+        return result;
+    }
+
+    ScenePackageData scene;
+    if (!LoadScene(options, scene)) {
+        return 1;
+    }
+    std::fprintf(stderr, "[SCENE] scene='%s' verts=%zu indices=%zu sections=%zu\n",
+        scene.sceneId.c_str(), scene.vertices.size(), scene.indices.size(), scene.sections.size());
+
+    if (options.benchCollision) {
+        result |= RunCollisionBenchmark(options, scene);
+    }
+    if (options.benchRaycast) {
+        result |= RunRaycastBenchmark(options, scene);
+    }
+    if (options.navBake) {
+        result |= RunNavBake(options, scene);
+    }
+    return result;
+}
@@ -0,0 +1,192 @@
+// AssetPack on packs written to a temp file: lookups, raw and LZ4 reads, and tables of
+// contents that must be rejected at Open (full hash table, unbounded LZ4 size).
+
+#include "RealSpace3/Include/AssetPack.h"
+
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <system_error>
+#include <vector>
+
+using namespace RealSpace3;
+namespace fs = std::filesystem;
+
+namespace {
+
+int g_failures = 0;
+
+#define CHECK(cond)                                                              \
+    do {                                                                         \
+        if (!(cond)) {                                                           \
+            std::fprintf(stderr, "%s:%d: CHECK failed: %s\n", __FILE__, __LINE__, #cond); \
+            ++g_failures;                                                        \
+        }                                                                        \
+    } while (0)
+
+constexpr size_t kHeaderSize = 64;
+constexpr size_t kEntrySize = 40;
+
+struct TestEntry {
+    std::string path;
+    std::vector<uint8_t> stored;
+    uint64_t size = 0;
+    AssetPackCompression compression = AssetPackCompression::None;
+};
+
+TestEntry RawEntry(const std::string& path, const std::string& text) {
+    return { path, std::vector<uint8_t>(text.begin(), text.end()), text.size(), AssetPackCompression::None };
+}
+
+// "abcd" as literals, then an overlapping 8-byte match at offset 4: "abcdabcdabcd"
+TestEntry LZ4Entry(const std::string& path) {
+    return { path, { 0x44, 'a', 'b', 'c', 'd', 0x04, 0x00 }, 12, AssetPackCompression::LZ4 };
+}
+
+template <typename T>
+void Put(std::vector<uint8_t>& bytes, size_t offset, T value) {
+    std::memcpy(bytes.data() + offset, &value, sizeof(T));
+}
+
+// Same layout as tools/rs3_asset_packer; slots are filled by linear probing unless given
+std::vector<uint8_t> BuildPack(const std::vector<TestEntry>& entries, uint32_t slotCount, const std::vector<uint32_t>& slotsOverride = {}) {
+    std::vector<uint8_t> bytes(kHeaderSize);
+    std::vector<uint64_t> dataOffsets;
+    for (const TestEntry& e : entries) {
+        bytes.resize((bytes.size() + 7) & ~size_t(7));
+        dataOffsets.push_back(bytes.size());
+        bytes.insert(bytes.end(), e.stored.begin(), e.stored.end());
+    }
+    bytes.resize((bytes.size() + 7) & ~size_t(7));
+    const size_t tocOffset = bytes.size();
+
+    std::vector<uint32_t> slots = slotsOverride;
+    if (slots.empty()) {
+        slots.assign(slotCount, 0);
+        for (uint32_t i = 0; i < entries.size(); ++i) {
+            uint32_t slot = static_cast<uint32_t>(AssetPack::HashPath(entries[i].path)) & (slotCount - 1);
+            while (slots[slot] != 0) slot = (slot + 1) & (slotCount - 1);
+            slots[slot] = i + 1;
+        }
+    }
+
+    std::string strings;
+    bytes.resize(tocOffset + entries.size() * kEntrySize);
+    for (size_t i = 0; i < entries.size(); ++i) {
+        const size_t base = tocOffset + i * kEntrySize;
+        Put<uint64_t>(bytes, base + 0, AssetPack::HashPath(entries[i].path));
+        Put<uint64_t>(bytes, base + 8, dataOffsets[i]);
+        Put<uint64_t>(bytes, base + 16, entries[i].stored.size());
+        Put<uint64_t>(bytes, base + 24, entries[i].size);
+        Put<uint32_t>(bytes, base + 32, static_cast<uint32_t>(strings.size()));
+        Put<uint16_t>(bytes, base + 36, static_cast<uint16_t>(entries[i].path.size()));
+        bytes[base + 38] = static_cast<uint8_t>(entries[i].compression);
+        strings += entries[i].path;
+    }
+    for (uint32_t slot : slots) {
+        bytes.resize(bytes.size() + 4);
+        Put<uint32_t>(bytes, bytes.size() - 4, slot);
+    }
+    bytes.insert(bytes.end(), strings.begin(), strings.end());
+
+    std::memcpy(bytes.data(), "RS3PAK1\0", 8);
+    Put<uint32_t>(bytes, 8, 1);
+    Put<uint32_t>(bytes, 12, static_cast<uint32_t>(entries.size()));
+    Put<uint32_t>(bytes, 16, slotCount);
+    Put<uint32_t>(bytes, 20, 8);
+    Put<uint64_t>(bytes, 24, tocOffset);
+    Put<uint64_t>(bytes, 32, bytes.size() - tocOffset);
+    Put<uint64_t>(bytes, 40, strings.size());
+    return bytes;
+}
+
+std::string WritePack(const std::vector<uint8_t>& bytes) {
+    std::error_code ec;
+    const fs::path path = fs::temp_directory_path(ec) / "rs3_asset_pack_test.rs3pak";
+    std::ofstream(path, std::ios::binary).write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+    return path.string();
+}
+
+void TestLookupAndRead() {
+    AssetPack pack;
+    std::string error;
+    const std::string path = WritePack(BuildPack({ RawEntry("scenes/a.txt", "hello"), LZ4Entry("scenes/b.bin") }, 4));
+    CHECK(pack.Open(path, &error));
+    CHECK(pack.GetEntryCount() == 2);
+
+    const uint32_t a = pack.Find("scenes/a.txt");
+    const uint32_t b = pack.Find("scenes/b.bin");
+    CHECK(a == 0);
+    CHECK(b == 1);
+    CHECK(pack.Find("scenes/missing.txt") == AssetPack::kInvalidEntry);
+
+    size_t mappedSize = 0;
+    const uint8_t* mapped = pack.GetMappedData(a, mappedSize);
+    CHECK(mapped && mappedSize == 5 && std::memcmp(mapped, "hello", 5) == 0);
+    CHECK(!pack.GetMappedData(b, mappedSize));
+
+    std::vector<uint8_t> bytes;
+    CHECK(pack.Read(b, bytes));
+    CHECK(std::string(bytes.begin(), bytes.end()) == "abcdabcdabcd");
+    pack.Close();
+    fs::remove(path);
+}
+
+void TestFullHashTableRejected() {
+    // Every slot points at the single entry: slotCount > entryCount holds, yet a miss would
+    // probe forever
+    AssetPack pack;
+    std::string error;
+    const std::string path = WritePack(BuildPack({ RawEntry("a.txt", "hello") }, 2, { 1, 1 }));
+    CHECK(!pack.Open(path, &error));
+    CHECK(error.find("empty slot") != std::string::npos);
+    CHECK(!pack.IsOpen());
+    CHECK(pack.Find("b.txt") == AssetPack::kInvalidEntry);
+    fs::remove(path);
+}
+
+void TestUnboundedLZ4SizeRejected() {
+    AssetPack pack;
+    std::string error;
+
+    // Larger than 7 stored bytes can ever expand to
+    TestEntry ratio = LZ4Entry("a.bin");
+    ratio.size = ratio.stored.size() * 255 + 1;
+    std::string path = WritePack(BuildPack({ ratio }, 2));
+    CHECK(!pack.Open(path, &error));
+
+    // Within the ratio of a large stored size, but past the per-entry cap
+    TestEntry huge = LZ4Entry("a.bin");
+    huge.stored.resize(8u << 20, 0);
+    huge.size = 2ull << 30;
+    path = WritePack(BuildPack({ huge }, 2));
+    CHECK(!pack.Open(path, &error));
+
+    // At the ratio limit the entry is accepted; the decoder then rejects the mismatch
+    TestEntry limit = LZ4Entry("a.bin");
+    limit.size = limit.stored.size() * 255;
+    path = WritePack(BuildPack({ limit }, 2));
+    CHECK(pack.Open(path, &error));
+    std::vector<uint8_t> bytes;
+    CHECK(!pack.Read(0, bytes, &error));
+    CHECK(bytes.empty());
+    pack.Close();
+    fs::remove(path);
+}
+
+} // namespace
+
+int main() {
+    TestLookupAndRead();
+    TestFullHashTableRejected();
+    TestUnboundedLZ4SizeRejected();
+
+    if (g_failures != 0) {
+        std::fprintf(stderr, "AssetPackTest: %d check(s) failed\n", g_failures);
+        return 1;
+    }
+    std::fprintf(stderr, "AssetPackTest: ok\n");
+    return 0;
+}
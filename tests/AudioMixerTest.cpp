@@ -0,0 +1,381 @@
+// WavFile and RS3AudioMixer on synthetic audio: 16-bit round trips, malformed or truncated
+// chunks, stereo conversion, sample-accurate placement, fade envelopes, and bit-identical
+// output whatever block sizes the mix is rendered in.
+
+#include "RealSpace3/Include/AudioMixer.h"
+#include "RealSpace3/Include/WavFile.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace RealSpace3;
+
+namespace {
+
+int g_failures = 0;
+
+#define CHECK(cond)                                                              \
+    do {                                                                         \
+        if (!(cond)) {                                                           \
+            std::fprintf(stderr, "%s:%d: CHECK failed: %s\n", __FILE__, __LINE__, #cond); \
+            ++g_failures;                                                        \
+        }                                                                        \
+    } while (0)
+
+constexpr uint32_t kRate = 48000;
+
+void PutU16(std::vector<uint8_t>& bytes, size_t offset, uint16_t value) {
+    bytes[offset] = static_cast<uint8_t>(value);
+    bytes[offset + 1] = static_cast<uint8_t>(value >> 8);
+}
+
+void PutU32(std::vector<uint8_t>& bytes, size_t offset, uint32_t value) {
+    for (int i = 0; i < 4; ++i) bytes[offset + i] = static_cast<uint8_t>(value >> (8 * i));
+}
+
+void AppendChunk(std::vector<uint8_t>& bytes, const char* id, const std::vector<uint8_t>& payload, uint32_t declaredSize) {
+    const size_t offset = bytes.size();
+    bytes.resize(offset + 8);
+    std::memcpy(bytes.data() + offset, id, 4);
+    PutU32(bytes, offset + 4, declaredSize);
+    bytes.insert(bytes.end(), payload.begin(), payload.end());
+    if (payload.size() & 1u) bytes.push_back(0);
+}
+
+void AppendChunk(std::vector<uint8_t>& bytes, const char* id, const std::vector<uint8_t>& payload) {
+    AppendChunk(bytes, id, payload, static_cast<uint32_t>(payload.size()));
+}
+
+std::vector<uint8_t> FmtPayload(uint16_t tag, uint16_t channels, uint32_t sampleRate, uint16_t bits) {
+    std::vector<uint8_t> payload(16);
+    const uint16_t blockAlign = static_cast<uint16_t>(channels * (bits / 8));
+    PutU16(payload, 0, tag);
+    PutU16(payload, 2, channels);
+    PutU32(payload, 4, sampleRate);
+    PutU32(payload, 8, sampleRate * blockAlign);
+    PutU16(payload, 12, blockAlign);
+    PutU16(payload, 14, bits);
+    return payload;
+}
+
+// RIFF header followed by the given chunks; the RIFF size is not checked by the reader.
+std::vector<uint8_t> Riff() {
+    std::vector<uint8_t> bytes(12);
+    std::memcpy(bytes.data(), "RIFF", 4);
+    std::memcpy(bytes.data() + 8, "WAVE", 4);
+    return bytes;
+}
+
+// Deterministic noise in [-1, 1), different per seed.
+std::vector<float> Noise(size_t count, uint32_t seed) {
+    std::vector<float> samples(count);
+    uint32_t state = seed * 2654435761u + 1u;
+    for (float& sample : samples) {
+        state = state * 1664525u + 1013904223u;
+        sample = static_cast<float>(state >> 8) * (2.0f / 16777216.0f) - 1.0f;
+    }
+    return samples;
+}
+
+std::shared_ptr<const RS3AudioBuffer> StereoSource(uint64_t frames, uint32_t seed) {
+    auto buffer = std::make_shared<RS3AudioBuffer>();
+    buffer->sampleRate = kRate;
+    buffer->channels = 2;
+    buffer->samples = Noise(static_cast<size_t>(frames) * 2, seed);
+    return buffer;
+}
+
+RS3TimelineAudioClip Clip(float startSec, float durationSec, float fadeInSec, float fadeOutSec, float gainDb = 0.0f, float trimInSec = 0.0f) {
+    RS3TimelineAudioClip clip;
+    clip.file = "test.wav";
+    clip.startSec = startSec;
+    clip.durationSec = durationSec;
+    clip.fadeInSec = fadeInSec;
+    clip.fadeOutSec = fadeOutSec;
+    clip.gainDb = gainDb;
+    clip.trimInSec = trimInSec;
+    return clip;
+}
+
+void TestPcm16RoundTrip() {
+    RS3AudioBuffer buffer;
+    buffer.sampleRate = 44100;
+    buffer.channels = 2;
+    buffer.samples = Noise(2000, 1);
+    buffer.samples.push_back(2.0f); // clamped
+    buffer.samples.push_back(-2.0f);
+
+    std::vector<uint8_t> bytes;
+    WavFile::EncodePcm16(buffer, bytes);
+    CHECK(bytes.size() == 44 + buffer.samples.size() * 2);
+
+    RS3AudioBuffer decoded;
+    std::string error;
+    CHECK(WavFile::Decode(bytes.data(), bytes.size(), decoded, &error));
+    CHECK(decoded.sampleRate == 44100);
+    CHECK(decoded.channels == 2);
+    CHECK(decoded.samples.size() == buffer.samples.size());
+    if (decoded.samples.size() != buffer.samples.size()) return;
+    // Written at 32767 full scale, read back at 32768: half a step of rounding plus |x| / 32768
+    float worst = 0.0f;
+    for (size_t i = 0; i + 2 < buffer.samples.size(); ++i) {
+        worst = std::max(worst, std::fabs(decoded.samples[i] - buffer.samples[i]));
+    }
+    CHECK(worst <= 1.5f / 32768.0f);
+    CHECK(decoded.samples[buffer.samples.size() - 2] == 32767.0f / 32768.0f);
+    CHECK(decoded.samples[buffer.samples.size() - 1] == -32767.0f / 32768.0f);
+
+    // Odd-sized unknown chunks are padded and skipped; a truncated data chunk keeps its whole frames
+    std::vector<uint8_t> padded = Riff();
+    AppendChunk(padded, "LIST", { 'a', 'b', 'c' });
+    AppendChunk(padded, "fmt ", FmtPayload(1, 2, 44100, 16));
+    std::vector<uint8_t> pcm(bytes.begin() + 44, bytes.begin() + 44 + 4 * 10 + 2);
+    AppendChunk(padded, "data", pcm, 4 * 100);
+    CHECK(WavFile::Decode(padded.data(), padded.size(), decoded, &error));
+    CHECK(decoded.GetFrameCount() == 10);
+}
+
+void TestOtherSampleFormats() {
+    // 24-bit and float samples decode to the same values
+    std::vector<uint8_t> bytes = Riff();
+    AppendChunk(bytes, "fmt ", FmtPayload(1, 1, kRate, 24));
+    AppendChunk(bytes, "data", { 0x00, 0x00, 0x40, 0x00, 0x00, 0xC0 }); // 0.5, -0.5
+    RS3AudioBuffer decoded;
+    CHECK(WavFile::Decode(bytes.data(), bytes.size(), decoded));
+    CHECK(decoded.channels == 1 && decoded.samples.size() == 2);
+    if (decoded.samples.size() == 2) CHECK(decoded.samples[0] == 0.5f && decoded.samples[1] == -0.5f);
+
+    const float values[2] = { 0.25f, -0.75f };
+    std::vector<uint8_t> floatBytes(sizeof(values));
+    std::memcpy(floatBytes.data(), values, sizeof(values));
+    bytes = Riff();
+    AppendChunk(bytes, "fmt ", FmtPayload(3, 2, kRate, 32));
+    AppendChunk(bytes, "data", floatBytes);
+    CHECK(WavFile::Decode(bytes.data(), bytes.size(), decoded));
+    CHECK((decoded.samples == std::vector<float>{ 0.25f, -0.75f }));
+}
+
+void TestRejectsBadFiles() {
+    RS3AudioBuffer decoded;
+    std::string error;
+    const std::vector<uint8_t> data = { 0, 0, 0, 0 };
+
+    const uint8_t notWave[] = { 'R', 'I', 'F', 'F', 0, 0, 0, 0, 'A', 'V', 'I', ' ' };
+    CHECK(!WavFile::Decode(notWave, sizeof(notWave), decoded, &error));
+    CHECK(!WavFile::Decode(notWave, 8, decoded, &error));
+    CHECK(!WavFile::Decode(nullptr, 0, decoded, &error));
+
+    // fmt chunk shorter than 16 bytes
+    std::vector<uint8_t> bytes = Riff();
+    std::vector<uint8_t> shortFmt = FmtPayload(1, 2, kRate, 16);
+    shortFmt.resize(12);
+    AppendChunk(bytes, "fmt ", shortFmt);
+    AppendChunk(bytes, "data", data);
+    error.clear();
+    CHECK(!WavFile::Decode(bytes.data(), bytes.size(), decoded, &error));
+    CHECK(error.find("fmt") != std::string::npos);
+
+    // File ends inside the fmt chunk
+    bytes = Riff();
+    AppendChunk(bytes, "fmt ", FmtPayload(1, 2, kRate, 16));
+    bytes.resize(bytes.size() - 6);
+    CHECK(!WavFile::Decode(bytes.data(), bytes.size(), decoded, &error));
+
+    // No data chunk
+    bytes = Riff();
+    AppendChunk(bytes, "fmt ", FmtPayload(1, 2, kRate, 16));
+    CHECK(!WavFile::Decode(bytes.data(), bytes.size(), decoded, &error));
+
+    // A chunk size far past the end of the file is not followed
+    bytes = Riff();
+    AppendChunk(bytes, "JUNK", { 1, 2 }, 0xFFFFFFF0u);
+    AppendChunk(bytes, "fmt ", FmtPayload(1, 2, kRate, 16));
+    AppendChunk(bytes, "data", data);
+    CHECK(!WavFile::Decode(bytes.data(), bytes.size(), decoded, &error));
+
+    // Unsupported or inconsistent formats
+    struct BadFormat {
+        uint16_t tag;
+        uint16_t channels;
+        uint32_t sampleRate;
+        uint16_t bits;
+    };
+    const BadFormat badFormats[] = {
+        { 2, 2, kRate, 16 },  // ADPCM
+        { 1, 0, kRate, 16 },  // no channels
+        { 1, 2, 0, 16 },      // no sample rate
+        { 1, 2, kRate, 12 },  // not whole bytes
+        { 1, 2, kRate, 40 },  // wider than 32 bits
+        { 3, 2, kRate, 16 },  // 16-bit float
+    };
+    for (const BadFormat& format : badFormats) {
+        bytes = Riff();
+        AppendChunk(bytes, "fmt ", FmtPayload(format.tag, format.channels, format.sampleRate, format.bits));
+        AppendChunk(bytes, "data", data);
+        error.clear();
+        CHECK(!WavFile::Decode(bytes.data(), bytes.size(), decoded, &error));
+        CHECK(!error.empty());
+    }
+
+    // blockAlign that does not match channels * bytes per sample
+    std::vector<uint8_t> fmt = FmtPayload(1, 2, kRate, 16);
+    PutU16(fmt, 12, 3);
+    bytes = Riff();
+    AppendChunk(bytes, "fmt ", fmt);
+    AppendChunk(bytes, "data", data);
+    CHECK(!WavFile::Decode(bytes.data(), bytes.size(), decoded, &error));
+}
+
+void TestConvertToStereo() {
+    RS3AudioBuffer mono;
+    mono.sampleRate = kRate;
+    mono.channels = 1;
+    mono.samples = { 0.1f, 0.2f, 0.3f };
+    RS3AudioBuffer stereo;
+    RS3AudioMixer::ConvertToStereo(mono, kRate, stereo);
+    CHECK(stereo.channels == 2 && stereo.sampleRate == kRate);
+    CHECK((stereo.samples == std::vector<float>{ 0.1f, 0.1f, 0.2f, 0.2f, 0.3f, 0.3f }));
+
+    // Half the rate: twice the frames, odd frames halfway between their neighbours
+    mono.sampleRate = kRate / 2;
+    mono.samples = { 0.0f, 1.0f, 0.5f, 0.5f };
+    RS3AudioMixer::ConvertToStereo(mono, kRate, stereo);
+    CHECK(stereo.GetFrameCount() == 8);
+    if (stereo.GetFrameCount() == 8) {
+        CHECK(stereo.samples[2] == 0.5f && stereo.samples[3] == 0.5f);
+        CHECK(stereo.samples[4] == 1.0f && stereo.samples[6] == 0.75f);
+    }
+
+    RS3AudioMixer mixer(kRate);
+    CHECK(!mixer.AddClip(Clip(0.0f, 0.0f, 0.0f, 0.0f), std::make_shared<RS3AudioBuffer>(mono)));
+    CHECK(!mixer.AddClip(Clip(0.0f, 0.0f, 0.0f, 0.0f), nullptr));
+}
+
+void TestPlacementAndEnvelope() {
+    RS3AudioMixer mixer(kRate);
+    const uint64_t sourceFrames = 30000;
+    const std::shared_ptr<const RS3AudioBuffer> source = StereoSource(sourceFrames, 7);
+    // Starts at frame 2400, skips 100 source frames, 20000 frames long, fades of 9600 and 4800
+    CHECK(mixer.AddClip(Clip(0.05f, 20000.0f / kRate, 0.2f, 0.1f, -6.0f, 100.0f / kRate), source));
+    CHECK(mixer.GetEndFrame() == 2400 + 20000);
+
+    const uint64_t frames = 24000;
+    std::vector<float> out(frames * 2, 1.0f);
+    mixer.Render(0, frames, out.data());
+
+    const float gain = std::pow(10.0f, -6.0f / 20.0f);
+    bool exactBefore = true;
+    bool exactAfter = true;
+    float worst = 0.0f;
+    for (uint64_t f = 0; f < frames; ++f) {
+        if (f < 2400 || f >= 22400) {
+            if (f < 2400) exactBefore = exactBefore && out[f * 2] == 0.0f && out[f * 2 + 1] == 0.0f;
+            else exactAfter = exactAfter && out[f * 2] == 0.0f && out[f * 2 + 1] == 0.0f;
+            continue;
+        }
+        const double local = static_cast<double>(f - 2400);
+        const double envelope = std::min({ 1.0, local / 9600.0, (20000.0 - local) / 4800.0 });
+        for (int c = 0; c < 2; ++c) {
+            const double expected = source->samples[(100 + (f - 2400)) * 2 + c] * gain * envelope;
+            worst = std::max(worst, static_cast<float>(std::fabs(out[f * 2 + c] - expected)));
+        }
+    }
+    CHECK(exactBefore);
+    CHECK(exactAfter);
+    CHECK(worst < 1e-5f);
+
+    // Overlapping fades on a constant source: the envelope peaks where the two ramps cross
+    auto constant = std::make_shared<RS3AudioBuffer>();
+    constant->sampleRate = kRate;
+    constant->channels = 2;
+    constant->samples.assign(1000 * 2, 1.0f);
+    RS3AudioMixer envelopeOnly(kRate);
+    CHECK(envelopeOnly.AddClip(Clip(0.0f, 1000.0f / kRate, 800.0f / kRate, 600.0f / kRate), constant));
+    std::vector<float> env(1000 * 2);
+    envelopeOnly.Render(0, 1000, env.data());
+    float peak = 0.0f;
+    for (uint64_t f = 0; f < 1000; ++f) {
+        const double expected = std::min({ 1.0, f / 800.0, (1000.0 - f) / 600.0 });
+        CHECK(std::fabs(env[f * 2] - expected) < 1e-5);
+        peak = std::max(peak, env[f * 2]);
+    }
+    CHECK(peak > 0.71f && peak < 0.72f); // ramps cross 4000/7 frames in, at 5/7
+}
+
+// Clips with fades longer than a 4096-frame ramp, trims, gains, a fade crossing and overlaps.
+RS3AudioMixer MakeBusyMixer() {
+    RS3AudioMixer mixer(kRate);
+    CHECK(mixer.AddClip(Clip(0.0f, 0.0f, 0.5f, 0.25f), StereoSource(60000, 1)));
+    CHECK(mixer.AddClip(Clip(0.01f, 1.0f, 0.3f, 0.3f, -3.0f, 0.02f), StereoSource(70000, 2)));
+    CHECK(mixer.AddClip(Clip(0.4f, 0.2f, 0.15f, 0.15f, 4.0f), StereoSource(20000, 3)));
+    CHECK(mixer.AddClip(Clip(1.23457f, 0.0f, 0.0f, 0.01f), StereoSource(777, 4)));
+    return mixer;
+}
+
+void TestSplitRenderIsBitIdentical() {
+    const RS3AudioMixer mixer = MakeBusyMixer();
+    const uint64_t frames = mixer.GetEndFrame() + 500;
+    CHECK(frames > 4 * 4096);
+
+    std::vector<float> whole(frames * 2);
+    mixer.Render(0, frames, whole.data());
+
+    // One frame per call never reaches the SIMD loop; the single block mostly does
+    std::vector<float> single(frames * 2, 9.0f);
+    for (uint64_t f = 0; f < frames; ++f) {
+        mixer.Render(f, 1, single.data() + f * 2);
+    }
+    CHECK(std::memcmp(single.data(), whole.data(), whole.size() * sizeof(float)) == 0);
+
+    // Block sizes that cut through ramp restarts, fade ends and the SIMD tail
+    const uint64_t pattern[] = { 1, 3, 4095, 2, 4097, 5, 7, 8192, 13, 4096, 1000, 6, 9600, 333, 17 };
+    std::vector<float> split(frames * 2, 9.0f);
+    uint64_t start = 0;
+    for (size_t i = 0; start < frames; ++i) {
+        const uint64_t count = std::min(pattern[i % (sizeof(pattern) / sizeof(pattern[0]))], frames - start);
+        mixer.Render(start, count, split.data() + start * 2);
+        start += count;
+    }
+    CHECK(std::memcmp(split.data(), whole.data(), whole.size() * sizeof(float)) == 0);
+
+    // Pseudo-random boundaries, rendered from an arbitrary frame onwards
+    uint32_t state = 12345u;
+    const uint64_t offset = 4093;
+    std::vector<float> random((frames - offset) * 2, 9.0f);
+    start = offset;
+    while (start < frames) {
+        state = state * 1664525u + 1013904223u;
+        const uint64_t count = std::min<uint64_t>(1 + (state >> 16) % 5000, frames - start);
+        mixer.Render(start, count, random.data() + (start - offset) * 2);
+        start += count;
+    }
+    CHECK(std::memcmp(random.data(), whole.data() + offset * 2, random.size() * sizeof(float)) == 0);
+
+    // Rendering past the end only writes silence
+    std::vector<float> tail(64, 9.0f);
+    mixer.Render(frames, 32, tail.data());
+    CHECK(std::all_of(tail.begin(), tail.end(), [](float sample) { return sample == 0.0f; }));
+}
+
+} // namespace
+
+int main() {
+    TestPcm16RoundTrip();
+    TestOtherSampleFormats();
+    TestRejectsBadFiles();
+    TestConvertToStereo();
+    TestPlacementAndEnvelope();
+    TestSplitRenderIsBitIdentical();
+
+    if (g_failures != 0) {
+        std::fprintf(stderr, "AudioMixerTest: %d check(s) failed\n", g_failures);
+        return 1;
+    }
+    std::fprintf(stderr, "AudioMixerTest: ok\n");
+    return 0;
+}
@@ -0,0 +1,346 @@
+// DDSParser on DDS files built in memory: legacy and DX10 headers, mip chains, cubemaps,
+// arrays, 24-bit expansion and malformed or truncated input.
+
+#include "RealSpace3/Include/DDSParser.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+using namespace RealSpace3;
+
+namespace {
+
+int g_failures = 0;
+
+#define CHECK(cond)                                                              \
+    do {                                                                         \
+        if (!(cond)) {                                                           \
+            std::fprintf(stderr, "%s:%d: CHECK failed: %s\n", __FILE__, __LINE__, #cond); \
+            ++g_failures;                                                        \
+        }                                                                        \
+    } while (0)
+
+constexpr uint32_t kHeaderBytes = 4 + 124;
+constexpr uint32_t kDX10Bytes = 20;
+
+constexpr uint32_t FourCC(char a, char b, char c, char d) {
+    return static_cast<uint32_t>(a) | (static_cast<uint32_t>(b) << 8) | (static_cast<uint32_t>(c) << 16) | (static_cast<uint32_t>(d) << 24);
+}
+
+// Header fields the tests vary; everything else is zero.
+struct DDSDesc {
+    uint32_t width = 64;
+    uint32_t height = 64;
+    uint32_t mipCount = 1;
+    uint32_t pfFlags = 0x4; // DDPF_FOURCC
+    uint32_t fourCC = FourCC('D', 'X', 'T', '1');
+    uint32_t rgbBitCount = 0;
+    uint32_t masks[4] = { 0, 0, 0, 0 };
+    uint32_t caps2 = 0;
+    bool dx10 = false;
+    uint32_t dxgiFormat = 0;
+    uint32_t dimension = 3; // texture 2D
+    uint32_t miscFlag = 0;
+    uint32_t arraySize = 1;
+};
+
+void Put32(std::vector<uint8_t>& bytes, size_t offset, uint32_t value) {
+    std::memcpy(bytes.data() + offset, &value, sizeof(value));
+}
+
+// Header followed by payloadBytes of pattern data
+std::vector<uint8_t> MakeDDS(const DDSDesc& desc, size_t payloadBytes) {
+    const size_t headerBytes = kHeaderBytes + (desc.dx10 ? kDX10Bytes : 0);
+    std::vector<uint8_t> bytes(headerBytes + payloadBytes, 0);
+    Put32(bytes, 0, DDSParser::kMagic);
+    Put32(bytes, 4, 124);
+    Put32(bytes, 12, desc.height);
+    Put32(bytes, 16, desc.width);
+    Put32(bytes, 28, desc.mipCount);
+    Put32(bytes, 76, 32); // pixel format size
+    Put32(bytes, 80, desc.pfFlags);
+    Put32(bytes, 84, desc.dx10 ? FourCC('D', 'X', '1', '0') : desc.fourCC);
+    Put32(bytes, 88, desc.rgbBitCount);
+    for (int i = 0; i < 4; ++i) Put32(bytes, 92 + i * 4, desc.masks[i]);
+    Put32(bytes, 112, desc.caps2);
+    if (desc.dx10) {
+        Put32(bytes, kHeaderBytes + 0, desc.dxgiFormat);
+        Put32(bytes, kHeaderBytes + 4, desc.dimension);
+        Put32(bytes, kHeaderBytes + 8, desc.miscFlag);
+        Put32(bytes, kHeaderBytes + 12, desc.arraySize);
+    }
+    for (size_t i = headerBytes; i < bytes.size(); ++i) bytes[i] = static_cast<uint8_t>(i * 7);
+    return bytes;
+}
+
+// Bytes of a full BCn chain of one slice
+size_t BlockChainBytes(uint32_t width, uint32_t height, uint32_t mips, size_t blockBytes) {
+    size_t bytes = 0;
+    for (uint32_t mip = 0; mip < mips; ++mip) {
+        const size_t w = std::max(1u, width >> mip);
+        const size_t h = std::max(1u, height >> mip);
+        bytes += ((w + 3) / 4) * ((h + 3) / 4) * blockBytes;
+    }
+    return bytes;
+}
+
+bool Parse(const std::vector<uint8_t>& bytes, DDSInfo& info, std::string* error = nullptr) {
+    return DDSParser::Parse(bytes.data(), bytes.size(), info, error);
+}
+
+void TestRejectsNonDDS() {
+    DDSInfo info;
+    const uint8_t junk[8] = { 'P', 'N', 'G', 0, 0, 0, 0, 0 };
+    CHECK(!DDSParser::IsDDS(junk, sizeof(junk)));
+    CHECK(!DDSParser::Parse(junk, sizeof(junk), info));
+    CHECK(!DDSParser::Parse(nullptr, 0, info));
+
+    // Magic only, header cut short
+    std::vector<uint8_t> bytes = MakeDDS(DDSDesc{}, 0);
+    bytes.resize(64);
+    std::string error;
+    CHECK(!Parse(bytes, info, &error));
+    CHECK(error.find("Truncated") != std::string::npos);
+}
+
+void TestLegacyMipChain() {
+    DDSDesc desc;
+    desc.width = 64;
+    desc.height = 32;
+    desc.mipCount = 7; // 64x32 .. 1x1
+    const size_t payload = BlockChainBytes(64, 32, 7, 8);
+    DDSInfo info;
+    CHECK(Parse(MakeDDS(desc, payload), info));
+    CHECK(info.format == DDSFormat::BC1_UNORM);
+    CHECK(!info.hasDX10Header);
+    CHECK(info.mipLevels == 7);
+    CHECK(info.arraySize == 1);
+    CHECK(info.dataOffset == kHeaderBytes);
+    CHECK(info.surfaces.size() == 7);
+    if (info.surfaces.size() == 7) {
+        CHECK(info.surfaces[0].rowPitch == 16 * 8);
+        CHECK(info.surfaces[0].slicePitch == 16 * 8 * 8);
+        CHECK(info.surfaces[1].offset == kHeaderBytes + 16 * 8 * 8);
+        CHECK(info.surfaces[6].width == 1 && info.surfaces[6].height == 1);
+        CHECK(info.surfaces[6].slicePitch == 8); // one block even below 4x4
+        CHECK(info.surfaces[6].offset + info.surfaces[6].sourceBytes == kHeaderBytes + payload);
+    }
+
+    // mipMapCount beyond the full chain is clamped
+    desc.mipCount = 20;
+    CHECK(Parse(MakeDDS(desc, payload), info));
+    CHECK(info.mipLevels == 7);
+}
+
+void TestTruncated() {
+    DDSDesc desc;
+    desc.mipCount = 7;
+    const size_t full = BlockChainBytes(64, 64, 7, 8);
+    DDSInfo info;
+    std::string error;
+
+    // Single slice: a cut inside the chain keeps the mips that fit
+    CHECK(Parse(MakeDDS(desc, full - 8), info, &error));
+    CHECK(info.mipLevels == 6);
+    CHECK(info.surfaces.size() == 6);
+    CHECK(Parse(MakeDDS(desc, BlockChainBytes(64, 64, 1, 8)), info));
+    CHECK(info.mipLevels == 1);
+
+    // ... but the top mip must be complete
+    CHECK(!Parse(MakeDDS(desc, BlockChainBytes(64, 64, 1, 8) - 1), info, &error));
+    CHECK(error.find("truncated") != std::string::npos);
+    CHECK(!Parse(MakeDDS(desc, 0), info));
+
+    // Arrays and cubes must be complete in every slice
+    desc.caps2 = 0x200 | 0xFC00;
+    CHECK(!Parse(MakeDDS(desc, full * 6 - 8), info));
+}
+
+void TestLegacyCubemap() {
+    DDSDesc desc;
+    desc.width = 32;
+    desc.height = 32;
+    desc.mipCount = 6;
+    desc.fourCC = FourCC('D', 'X', 'T', '5');
+    desc.caps2 = 0x200 | 0xFC00; // DDSCAPS2_CUBEMAP | all faces
+    const size_t faceBytes = BlockChainBytes(32, 32, 6, 16);
+    DDSInfo info;
+    CHECK(Parse(MakeDDS(desc, faceBytes * 6), info));
+    CHECK(info.format == DDSFormat::BC3_UNORM);
+    CHECK(info.isCubemap);
+    CHECK(info.arraySize == 6);
+    CHECK(info.mipLevels == 6);
+    CHECK(info.surfaces.size() == 36);
+    if (info.surfaces.size() == 36) {
+        // D3D subresource order: mip + slice * mipLevels, faces stored one after another
+        CHECK(info.surfaces[6].arraySlice == 1 && info.surfaces[6].mipLevel == 0);
+        CHECK(info.surfaces[6].offset == kHeaderBytes + faceBytes);
+        CHECK(info.surfaces[35].arraySlice == 5 && info.surfaces[35].mipLevel == 5);
+    }
+
+    // Partial cubes and non-square faces are rejected
+    desc.caps2 = 0x200 | 0x0400;
+    CHECK(!Parse(MakeDDS(desc, faceBytes * 6), info));
+    desc.caps2 = 0x200 | 0xFC00;
+    desc.height = 16;
+    CHECK(!Parse(MakeDDS(desc, faceBytes * 6), info));
+}
+
+void TestDX10() {
+    DDSDesc desc;
+    desc.dx10 = true;
+    desc.width = 16;
+    desc.height = 16;
+    desc.mipCount = 5;
+    desc.dxgiFormat = static_cast<uint32_t>(DDSFormat::BC7_UNORM_SRGB);
+    desc.arraySize = 3;
+    const size_t sliceBytes = BlockChainBytes(16, 16, 5, 16);
+    DDSInfo info;
+    CHECK(Parse(MakeDDS(desc, sliceBytes * 3), info));
+    CHECK(info.hasDX10Header);
+    CHECK(info.format == DDSFormat::BC7_UNORM_SRGB);
+    CHECK(DDSParser::IsSrgb(info.format));
+    CHECK(!info.isCubemap);
+    CHECK(info.arraySize == 3);
+    CHECK(info.dataOffset == kHeaderBytes + kDX10Bytes);
+    CHECK(info.surfaces.size() == 15);
+    if (info.surfaces.size() == 15) CHECK(info.surfaces[5].offset == kHeaderBytes + kDX10Bytes + sliceBytes);
+
+    // Cube array: 2 cubes = 12 slices
+    desc.miscFlag = 0x4;
+    desc.arraySize = 2;
+    CHECK(Parse(MakeDDS(desc, sliceBytes * 12), info));
+    CHECK(info.isCubemap);
+    CHECK(info.arraySize == 12);
+
+    // Uncompressed DX10 format
+    desc = DDSDesc{};
+    desc.dx10 = true;
+    desc.width = 8;
+    desc.height = 4;
+    desc.dxgiFormat = static_cast<uint32_t>(DDSFormat::R16G16B16A16_FLOAT);
+    CHECK(Parse(MakeDDS(desc, 8 * 4 * 8), info));
+    CHECK(info.surfaces.size() == 1 && info.surfaces[0].rowPitch == 64);
+
+    // Unsupported formats, dimensions and zero arrays
+    desc.dxgiFormat = 45; // D24_UNORM_S8_UINT
+    CHECK(!Parse(MakeDDS(desc, 4096), info));
+    desc.dxgiFormat = static_cast<uint32_t>(DDSFormat::R8G8B8A8_UNORM);
+    desc.dimension = 4; // texture 3D
+    CHECK(!Parse(MakeDDS(desc, 4096), info));
+    desc.dimension = 3;
+    desc.arraySize = 0;
+    CHECK(!Parse(MakeDDS(desc, 4096), info));
+
+    // Header cut inside the DX10 extension
+    std::vector<uint8_t> bytes = MakeDDS(desc, 0);
+    bytes.resize(kHeaderBytes + 8);
+    CHECK(!Parse(bytes, info));
+}
+
+void TestHostileArraySizes() {
+    DDSDesc desc;
+    desc.dx10 = true;
+    desc.width = 4;
+    desc.height = 4;
+    desc.dxgiFormat = static_cast<uint32_t>(DDSFormat::BC1_UNORM);
+    DDSInfo info;
+    std::string error;
+
+    // 0x2AAAAAAB * 6 wraps to 2 in 32 bits: must be rejected, not parsed as 2 slices
+    desc.miscFlag = 0x4;
+    desc.arraySize = 0x2AAAAAABu;
+    CHECK(!Parse(MakeDDS(desc, 16), info, &error));
+    CHECK(info.surfaces.empty());
+
+    // Above the D3D11 array limit
+    desc.miscFlag = 0;
+    desc.arraySize = 2049;
+    CHECK(!Parse(MakeDDS(desc, 2049 * 8), info, &error));
+    desc.miscFlag = 0x4;
+    desc.arraySize = 342; // 2052 faces
+    CHECK(!Parse(MakeDDS(desc, 2052 * 8), info, &error));
+
+    // Within the limit but far more slices than bytes: rejected before any allocation
+    desc.miscFlag = 0;
+    desc.arraySize = 2048;
+    CHECK(!Parse(MakeDDS(desc, 64), info, &error));
+    CHECK(error.find("truncated") != std::string::npos);
+
+    // The limit itself is accepted when the data is there
+    CHECK(Parse(MakeDDS(desc, 2048 * 8), info));
+    CHECK(info.arraySize == 2048);
+
+    // Oversized dimensions
+    desc.arraySize = 1;
+    desc.width = 16385;
+    CHECK(!Parse(MakeDDS(desc, 64), info));
+}
+
+void TestLegacy24Bit() {
+    DDSDesc desc;
+    desc.width = 5;
+    desc.height = 3;
+    desc.pfFlags = 0x40; // DDPF_RGB
+    desc.fourCC = 0;
+    desc.rgbBitCount = 24;
+    desc.masks[0] = 0x00FF0000;
+    desc.masks[1] = 0x0000FF00;
+    desc.masks[2] = 0x000000FF;
+    const std::vector<uint8_t> bytes = MakeDDS(desc, 5 * 3 * 3);
+    DDSInfo info;
+    CHECK(Parse(bytes, info));
+    CHECK(info.expand24Bit);
+    CHECK(info.format == DDSFormat::B8G8R8A8_UNORM);
+    CHECK(info.surfaces.size() == 1);
+    if (info.surfaces.size() == 1) {
+        CHECK(info.surfaces[0].sourceBytes == 45);
+        CHECK(info.surfaces[0].rowPitch == 20);
+        CHECK(info.surfaces[0].slicePitch == 60);
+    }
+    CHECK(!Parse(MakeDDS(desc, 44), info));
+
+    // SIMD expansion matches the per-pixel definition at every length around the 4-pixel steps
+    for (size_t count = 0; count < 19; ++count) {
+        std::vector<uint8_t> src(count * 3);
+        for (size_t i = 0; i < src.size(); ++i) src[i] = static_cast<uint8_t>(i * 13 + 1);
+        std::vector<uint8_t> dst(count * 4, 0);
+        DDSParser::Expand24To32(src.data(), dst.data(), count);
+        bool same = true;
+        for (size_t p = 0; p < count; ++p) {
+            same &= dst[p * 4 + 0] == src[p * 3 + 0] && dst[p * 4 + 1] == src[p * 3 + 1]
+                && dst[p * 4 + 2] == src[p * 3 + 2] && dst[p * 4 + 3] == 0xFF;
+        }
+        CHECK(same);
+    }
+}
+
+void TestVolumeRejected() {
+    DDSDesc desc;
+    desc.caps2 = 0x200000; // DDSCAPS2_VOLUME
+    DDSInfo info;
+    CHECK(!Parse(MakeDDS(desc, 4096), info));
+}
+
+} // namespace
+
+int main() {
+    TestRejectsNonDDS();
+    TestLegacyMipChain();
+    TestTruncated();
+    TestLegacyCubemap();
+    TestDX10();
+    TestHostileArraySizes();
+    TestLegacy24Bit();
+    TestVolumeRejected();
+
+    if (g_failures != 0) {
+        std::fprintf(stderr, "DDSParserTest: %d check(s) failed\n", g_failures);
+        return 1;
+    }
+    std::fprintf(stderr, "DDSParserTest: ok\n");
+    return 0;
+}
@@ -0,0 +1,344 @@
+// Frame capture back end: RS3FrameWriter pool bounds and buffer reuse, sink failures reaching the
+// producer, RS3FrameRingSink order after wrap-around and, on POSIX, a pipe round trip through cat.
+
+#include "RealSpace3/Include/FrameSink.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <iterator>
+#include <mutex>
+#include <string>
+#include <system_error>
+#include <vector>
+
+using namespace RealSpace3;
+
+namespace {
+
+namespace fs = std::filesystem;
+
+int g_failures = 0;
+
+#define CHECK(cond)                                                              \
+    do {                                                                         \
+        if (!(cond)) {                                                           \
+            std::fprintf(stderr, "%s:%d: CHECK failed: %s\n", __FILE__, __LINE__, #cond); \
+            ++g_failures;                                                        \
+        }                                                                        \
+    } while (0)
+
+constexpr uint32_t kWidth = 4;
+constexpr uint32_t kHeight = 2;
+
+void FillFrame(RS3CapturedFrame& frame, uint64_t index) {
+    frame.index = index;
+    frame.width = kWidth;
+    frame.height = kHeight;
+    frame.bgra.resize(static_cast<size_t>(kWidth) * kHeight * 4u);
+    for (size_t i = 0; i < frame.bgra.size(); ++i) {
+        frame.bgra[i] = static_cast<uint8_t>(index * 31u + i);
+    }
+}
+
+// Records what the writer thread hands it. WriteFrame waits while the gate is closed and fails
+// at failIndex, so tests control when pool buffers come back.
+class GatedSink : public RS3FrameSink {
+public:
+    explicit GatedSink(bool gateOpen, uint64_t failIndex = UINT64_MAX)
+        : m_gateOpen(gateOpen)
+        , m_failIndex(failIndex) {
+    }
+
+    bool Open(uint32_t width, uint32_t height, int fps, std::string* outError) override {
+        (void)width;
+        (void)height;
+        (void)fps;
+        (void)outError;
+        std::lock_guard<std::mutex> lock(m_mutex);
+        ++m_openCalls;
+        return true;
+    }
+
+    bool WriteFrame(const RS3CapturedFrame& frame, std::string* outError) override {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_gateChanged.wait(lock, [this]() { return m_gateOpen; });
+        if (frame.index == m_failIndex) {
+            if (outError) *outError = "disk full";
+            return false;
+        }
+        m_indices.push_back(frame.index);
+        m_pixels.push_back(frame.bgra);
+        return true;
+    }
+
+    bool Close(std::string* outError) override {
+        (void)outError;
+        std::lock_guard<std::mutex> lock(m_mutex);
+        ++m_closeCalls;
+        return true;
+    }
+
+    void OpenGate() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_gateOpen = true;
+        m_gateChanged.notify_all();
+    }
+
+    std::vector<uint64_t> GetIndices() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_indices;
+    }
+    std::vector<std::vector<uint8_t>> GetPixels() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_pixels;
+    }
+    uint32_t GetOpenCalls() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_openCalls;
+    }
+    uint32_t GetCloseCalls() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_closeCalls;
+    }
+
+private:
+    mutable std::mutex m_mutex;
+    std::condition_variable m_gateChanged;
+    bool m_gateOpen = false;
+    uint64_t m_failIndex = UINT64_MAX;
+    std::vector<uint64_t> m_indices;
+    std::vector<std::vector<uint8_t>> m_pixels;
+    uint32_t m_openCalls = 0;
+    uint32_t m_closeCalls = 0;
+};
+
+void TestPoolBlocksAndReusesBuffers() {
+    GatedSink sink(false);
+    RS3FrameWriter writer(sink, 2);
+    CHECK(writer.Start(30));
+
+    std::unique_ptr<RS3CapturedFrame> first = writer.AcquireFrame();
+    std::unique_ptr<RS3CapturedFrame> second = writer.AcquireFrame();
+    CHECK(first && second);
+    if (!first || !second) return;
+    const RS3CapturedFrame* pooled[] = { first.get(), second.get() };
+    FillFrame(*first, 0);
+    FillFrame(*second, 1);
+    CHECK(writer.SubmitFrame(std::move(first)));
+    CHECK(writer.SubmitFrame(std::move(second)));
+
+    // Both buffers are queued behind the closed gate: the third acquire has to wait
+    std::future<std::unique_ptr<RS3CapturedFrame>> third = std::async(std::launch::async, [&writer]() { return writer.AcquireFrame(); });
+    CHECK(third.wait_for(std::chrono::milliseconds(100)) == std::future_status::timeout);
+
+    sink.OpenGate();
+    std::unique_ptr<RS3CapturedFrame> reused = third.get();
+    CHECK(reused != nullptr);
+    if (!reused) return;
+    CHECK(reused.get() == pooled[0] || reused.get() == pooled[1]);
+    CHECK(reused->bgra.capacity() >= static_cast<size_t>(kWidth) * kHeight * 4u); // storage kept for the next frame
+    FillFrame(*reused, 2);
+    CHECK(writer.SubmitFrame(std::move(reused)));
+
+    std::string error;
+    CHECK(writer.Finish(&error));
+    CHECK(error.empty());
+    CHECK((sink.GetIndices() == std::vector<uint64_t>{ 0, 1, 2 }));
+    CHECK(sink.GetOpenCalls() == 1);
+    CHECK(sink.GetCloseCalls() == 1);
+
+    const RS3FrameWriterStats stats = writer.GetStats();
+    CHECK(stats.framesWritten == 3);
+    CHECK(stats.producerWaitMs > 0.0);
+
+    // Frames arrive with the pixels they were submitted with
+    const std::vector<std::vector<uint8_t>> pixels = sink.GetPixels();
+    for (uint64_t i = 0; i < pixels.size(); ++i) {
+        RS3CapturedFrame expected;
+        FillFrame(expected, i);
+        CHECK(pixels[i] == expected.bgra);
+    }
+
+    // Nothing can be queued once the writer has finished
+    std::unique_ptr<RS3CapturedFrame> late = writer.AcquireFrame();
+    CHECK(late != nullptr);
+    if (late) {
+        FillFrame(*late, 3);
+        CHECK(!writer.SubmitFrame(std::move(late)));
+    }
+}
+
+void TestSinkFailureReachesProducer() {
+    GatedSink sink(true, 2);
+    RS3FrameWriter writer(sink, 2);
+    CHECK(writer.Start(30));
+
+    // Keep producing until the writer reports the failure. Frame 2 fails while at most frame 3
+    // holds the other buffer, so no later frame can be queued
+    bool stopped = false;
+    uint64_t submitted = 0;
+    for (uint64_t index = 0; index < 1000 && !stopped; ++index) {
+        std::unique_ptr<RS3CapturedFrame> frame = writer.AcquireFrame();
+        if (!frame) {
+            stopped = true;
+            break;
+        }
+        FillFrame(*frame, index);
+        if (!writer.SubmitFrame(std::move(frame))) {
+            stopped = true;
+            break;
+        }
+        ++submitted;
+    }
+    CHECK(stopped);
+    CHECK(submitted >= 3 && submitted <= 4);
+
+    std::string error;
+    CHECK(!writer.Finish(&error));
+    CHECK(error == "disk full");
+    CHECK(writer.GetStats().framesWritten == 2);
+    CHECK((sink.GetIndices() == std::vector<uint64_t>{ 0, 1 }));
+    CHECK(sink.GetCloseCalls() == 1);
+    CHECK(!writer.AcquireFrame());
+}
+
+void TestSizeChangeFails() {
+    GatedSink sink(true);
+    RS3FrameWriter writer(sink, 2);
+    CHECK(writer.Start(30));
+
+    std::unique_ptr<RS3CapturedFrame> frame = writer.AcquireFrame();
+    FillFrame(*frame, 0);
+    CHECK(writer.SubmitFrame(std::move(frame)));
+    frame = writer.AcquireFrame();
+    FillFrame(*frame, 1);
+    frame->width = kWidth * 2;
+    frame->bgra.resize(static_cast<size_t>(frame->width) * kHeight * 4u);
+    writer.SubmitFrame(std::move(frame));
+
+    std::string error;
+    CHECK(!writer.Finish(&error));
+    CHECK(error.find("changed size") != std::string::npos);
+    CHECK((sink.GetIndices() == std::vector<uint64_t>{ 0 }));
+}
+
+void TestRingOrderAfterWrap() {
+    RS3FrameRingSink ring(3);
+    std::string error;
+    CHECK(ring.Open(kWidth, kHeight, 30, &error));
+
+    RS3CapturedFrame frame;
+    for (uint64_t index = 0; index < 7; ++index) {
+        FillFrame(frame, index);
+        CHECK(ring.WriteFrame(frame, &error));
+    }
+    CHECK(ring.GetFramesSeen() == 7);
+
+    const std::vector<const RS3CapturedFrame*> frames = ring.GetFrames();
+    CHECK(frames.size() == 3);
+    for (size_t i = 0; i < frames.size(); ++i) {
+        RS3CapturedFrame expected;
+        FillFrame(expected, 4 + i);
+        CHECK(frames[i]->index == expected.index);
+        CHECK(frames[i]->width == kWidth && frames[i]->height == kHeight);
+        CHECK(frames[i]->bgra == expected.bgra);
+    }
+
+    // Reopening starts over; a short frame is rejected and not counted
+    CHECK(ring.Open(kWidth, kHeight, 30, &error));
+    CHECK(ring.GetFrames().empty());
+    FillFrame(frame, 9);
+    frame.bgra.resize(3);
+    CHECK(!ring.WriteFrame(frame, &error));
+    CHECK(!error.empty());
+    CHECK(ring.GetFramesSeen() == 0);
+}
+
+#ifndef _WIN32
+std::vector<uint8_t> ReadFile(const fs::path& path) {
+    std::ifstream file(path, std::ios::binary);
+    return std::vector<uint8_t>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+void TestPipeRoundTrip() {
+    std::error_code ec;
+    const fs::path path = fs::temp_directory_path(ec) / "rs3_frame_sink_test.raw";
+    fs::remove(path, ec);
+
+    uint32_t seenWidth = 0;
+    uint32_t seenHeight = 0;
+    RS3FramePipeSink pipe([&](uint32_t width, uint32_t height, int fps) {
+        (void)fps;
+        seenWidth = width;
+        seenHeight = height;
+        return "cat > '" + path.string() + "'";
+    });
+
+    std::string error;
+    CHECK(pipe.Open(kWidth, kHeight, 30, &error));
+    CHECK(seenWidth == kWidth && seenHeight == kHeight);
+
+    std::vector<uint8_t> expected;
+    RS3CapturedFrame frame;
+    for (uint64_t index = 0; index < 3; ++index) {
+        FillFrame(frame, index);
+        CHECK(pipe.WriteFrame(frame, &error));
+        expected.insert(expected.end(), frame.bgra.begin(), frame.bgra.end());
+    }
+    CHECK(pipe.Close(&error));
+    CHECK(ReadFile(path) == expected);
+    fs::remove(path, ec);
+
+    CHECK(RS3FramePipeSink::BuildRawVideoInputArgs(kWidth, kHeight, 0) == "-f rawvideo -pix_fmt bgra -s 4x2 -r 1 -i -");
+}
+
+void TestPipeChildFailures() {
+    std::string error;
+
+    // Exit code of the child is the result of Close
+    RS3FramePipeSink failing([](uint32_t, uint32_t, int) { return std::string("cat > /dev/null; exit 3"); });
+    CHECK(failing.Open(kWidth, kHeight, 30, &error));
+    CHECK(!failing.Close(&error));
+    CHECK(error.find("code 3") != std::string::npos);
+
+    // A child that stops reading turns into a write error instead of SIGPIPE killing the test
+    RS3FramePipeSink early([](uint32_t, uint32_t, int) { return std::string("true"); });
+    CHECK(early.Open(1024, 1024, 30, &error));
+    RS3CapturedFrame big;
+    big.width = 1024;
+    big.height = 1024;
+    big.bgra.assign(static_cast<size_t>(big.width) * big.height * 4u, 0x7f);
+    error.clear();
+    CHECK(!early.WriteFrame(big, &error));
+    CHECK(error.find("closed") != std::string::npos);
+    early.Close(&error);
+
+    RS3FramePipeSink empty([](uint32_t, uint32_t, int) { return std::string(); });
+    CHECK(!empty.Open(kWidth, kHeight, 30, &error));
+}
+#endif
+
+} // namespace
+
+int main() {
+    TestPoolBlocksAndReusesBuffers();
+    TestSinkFailureReachesProducer();
+    TestSizeChangeFails();
+    TestRingOrderAfterWrap();
+#ifndef _WIN32
+    TestPipeRoundTrip();
+    TestPipeChildFailures();
+#endif
+
+    if (g_failures != 0) {
+        std::fprintf(stderr, "FrameSinkTest: %d check(s) failed\n", g_failures);
+        return 1;
+    }
+    std::fprintf(stderr, "FrameSinkTest: ok\n");
+    return 0;
+}
@@ -0,0 +1,255 @@
+// HttpRequestQueue: priority order, shedding and rejection when full, per-job and global
+// cancellation, expiry, shutdown drops and destroying the queue from inside one of its jobs.
+
+#include "HttpRequestQueue.h"
+
+#include <chrono>
+#include <cstdio>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace Nakama;
+
+namespace {
+
+int g_failures = 0;
+
+#define CHECK(cond)                                                              \
+    do {                                                                         \
+        if (!(cond)) {                                                           \
+            std::fprintf(stderr, "%s:%d: CHECK failed: %s\n", __FILE__, __LINE__, #cond); \
+            ++g_failures;                                                        \
+        }                                                                        \
+    } while (0)
+
+// Occupies a worker until Release, so later submissions stay queued. The job shares the
+// promises instead of pointing at this object: a detached worker may still be inside run
+// after the test has released it and returned.
+class BlockingJob {
+public:
+    BlockingJob()
+        : m_state(std::make_shared<Promises>()) {
+        m_started = m_state->started.get_future().share();
+        m_state->releasedFuture = m_state->release.get_future().share();
+    }
+
+    HttpRequestJob Make() {
+        HttpRequestJob job;
+        job.run = [state = m_state](const HttpCancelToken&) {
+            state->started.set_value();
+            state->releasedFuture.wait();
+        };
+        return job;
+    }
+    void WaitStarted() { m_started.wait(); }
+    void Release() { m_state->release.set_value(); }
+
+private:
+    struct Promises {
+        std::promise<void> started;
+        std::promise<void> release;
+        std::shared_future<void> releasedFuture;
+    };
+    std::shared_ptr<Promises> m_state;
+    std::shared_future<void> m_started;
+};
+
+// Records run and drop events as "name" and "name:reason".
+class EventLog {
+public:
+    HttpRequestJob Make(HttpRequestPriority priority, const std::string& name) {
+        HttpRequestJob job;
+        job.priority = priority;
+        job.run = [this, name](const HttpCancelToken&) { Add(name); };
+        job.drop = [this, name](HttpDropReason reason) { Add(name + ":" + GetHttpDropReasonName(reason)); };
+        return job;
+    }
+    void Add(const std::string& event) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_events += m_events.empty() ? event : " " + event;
+    }
+    std::string Get() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_events;
+    }
+
+private:
+    std::mutex m_mutex;
+    std::string m_events;
+};
+
+template <typename Predicate>
+bool WaitFor(Predicate predicate) {
+    for (int i = 0; i < 2000; ++i) {
+        if (predicate()) return true;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return predicate();
+}
+
+void TestPriorityOrderAndCancel() {
+    HttpRequestQueue queue(1, 8);
+    BlockingJob blocker;
+    EventLog log;
+    queue.submit(blocker.Make());
+    blocker.WaitStarted();
+
+    queue.submit(log.Make(HttpRequestPriority::Cosmetic, "c1"));
+    queue.submit(log.Make(HttpRequestPriority::Gameplay, "g1"));
+    const HttpCancelTokenPtr c2 = queue.submit(log.Make(HttpRequestPriority::Cosmetic, "c2"));
+    queue.submit(log.Make(HttpRequestPriority::Auth, "a1"));
+    queue.submit(log.Make(HttpRequestPriority::Gameplay, "g2"));
+
+    // A waiting job is dropped right away and frees its slot
+    CHECK(queue.cancel(c2));
+    CHECK(log.Get() == "c2:cancelled");
+    CHECK(queue.getStats().GetQueuedTotal() == 4);
+
+    blocker.Release();
+    queue.waitIdle();
+    CHECK(log.Get() == "c2:cancelled a1 g1 g2 c1");
+    CHECK(!queue.cancel(c2));
+
+    const HttpRequestQueueStats stats = queue.getStats();
+    CHECK(stats.submitted == 6);
+    CHECK(stats.started == 5);
+    CHECK(stats.completed == 5);
+    CHECK(stats.cancelled == 1);
+    CHECK(stats.peakQueued == 5);
+}
+
+void TestShedAndReject() {
+    HttpRequestQueue queue(1, 2);
+    BlockingJob blocker;
+    EventLog log;
+    queue.submit(blocker.Make());
+    blocker.WaitStarted();
+
+    CHECK(queue.submit(log.Make(HttpRequestPriority::Cosmetic, "c1")) != nullptr);
+    CHECK(queue.submit(log.Make(HttpRequestPriority::Cosmetic, "c2")) != nullptr);
+    // Full of jobs at its own priority: rejected, its drop already ran
+    CHECK(queue.submit(log.Make(HttpRequestPriority::Cosmetic, "c3")) == nullptr);
+    // Higher priorities evict the newest cosmetic job first
+    CHECK(queue.submit(log.Make(HttpRequestPriority::Auth, "a1")) != nullptr);
+    CHECK(queue.submit(log.Make(HttpRequestPriority::Gameplay, "g1")) != nullptr);
+    CHECK(queue.submit(log.Make(HttpRequestPriority::Gameplay, "g2")) == nullptr);
+    CHECK(log.Get() == "c3:rejected c2:shed c1:shed g2:rejected");
+
+    blocker.Release();
+    queue.waitIdle();
+    CHECK(log.Get() == "c3:rejected c2:shed c1:shed g2:rejected a1 g1");
+    const HttpRequestQueueStats stats = queue.getStats();
+    CHECK(stats.shed == 2);
+    CHECK(stats.rejected == 2);
+}
+
+void TestExpiry() {
+    HttpRequestQueue queue(1, 4);
+    BlockingJob blocker;
+    EventLog log;
+    queue.submit(blocker.Make());
+    blocker.WaitStarted();
+
+    HttpRequestJob late = log.Make(HttpRequestPriority::Gameplay, "late");
+    late.deadline = std::chrono::steady_clock::now() - std::chrono::milliseconds(1);
+    queue.submit(std::move(late));
+    queue.submit(log.Make(HttpRequestPriority::Gameplay, "ok"));
+
+    blocker.Release();
+    queue.waitIdle();
+    CHECK(log.Get() == "late:expired ok");
+    CHECK(queue.getStats().expired == 1);
+}
+
+void TestCancelRunning() {
+    HttpRequestQueue queue(2, 4);
+    std::promise<void> started;
+    std::promise<bool> sawCancel;
+    HttpRequestJob job;
+    job.run = [&](const HttpCancelToken& token) {
+        started.set_value();
+        sawCancel.set_value(WaitFor([&]() { return token.isCancelled(); }));
+    };
+    const HttpCancelTokenPtr token = queue.submit(std::move(job));
+    started.get_future().wait();
+    CHECK(queue.cancel(token));
+    CHECK(sawCancel.get_future().get());
+    queue.waitIdle();
+    CHECK(queue.getStats().completed == 1);
+
+    // cancelAll reaches running and waiting jobs alike
+    BlockingJob blocker;
+    std::promise<void> started2;
+    std::promise<bool> sawCancel2;
+    EventLog log;
+    HttpRequestJob running;
+    running.run = [&](const HttpCancelToken& runningToken) {
+        started2.set_value();
+        sawCancel2.set_value(WaitFor([&]() { return runningToken.isCancelled(); }));
+    };
+    queue.submit(blocker.Make());
+    queue.submit(std::move(running));
+    blocker.WaitStarted();
+    started2.get_future().wait();
+    queue.submit(log.Make(HttpRequestPriority::Auth, "waiting"));
+    queue.cancelAll();
+    CHECK(log.Get() == "waiting:cancelled");
+    CHECK(sawCancel2.get_future().get());
+    blocker.Release();
+    queue.waitIdle();
+}
+
+void TestShutdown() {
+    EventLog log;
+    BlockingJob blocker;
+    {
+        HttpRequestQueue queue(1, 4);
+        queue.submit(blocker.Make());
+        blocker.WaitStarted();
+        queue.submit(log.Make(HttpRequestPriority::Gameplay, "g1"));
+        queue.submit(log.Make(HttpRequestPriority::Cosmetic, "c1"));
+    }
+    CHECK(log.Get() == "g1:shutdown c1:shutdown");
+    // The running job outlives the queue; its detached worker finishes it
+    blocker.Release();
+}
+
+void TestDestroyFromInsideJob() {
+    auto queue = std::make_shared<HttpRequestQueue>(1, 4);
+    std::weak_ptr<HttpRequestQueue> weak = queue;
+    // Shared with the job, which may still be inside set_value when the wait below returns
+    auto released = std::make_shared<std::promise<void>>();
+    std::future<void> releasedFuture = released->get_future();
+    HttpRequestJob job;
+    // The job holds the last reference, as a transport callback can hold its transport
+    job.run = [owner = queue, released](const HttpCancelToken&) mutable {
+        owner.reset();
+        released->set_value();
+    };
+    queue->submit(std::move(job));
+    queue.reset();
+    releasedFuture.wait();
+    CHECK(WaitFor([&]() { return weak.expired(); }));
+}
+
+} // namespace
+
+int main() {
+    TestPriorityOrderAndCancel();
+    TestShedAndReject();
+    TestExpiry();
+    TestCancelRunning();
+    TestShutdown();
+    TestDestroyFromInsideJob();
+
+    if (g_failures != 0) {
+        std::fprintf(stderr, "HttpRequestQueueTest: %d check(s) failed\n", g_failures);
+        return 1;
+    }
+    std::fprintf(stderr, "HttpRequestQueueTest: ok\n");
+    return 0;
+}
@@ -0,0 +1,206 @@
+// SceneDrawBatcher on small hand-built index buffers: grouping by pass and texture, ordered
+// passes, vertex duplication across array slices and out-of-range input.
+
+#include "RealSpace3/Include/SceneBatching.h"
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+using namespace RealSpace3;
+
+namespace {
+
+int g_failures = 0;
+
+#define CHECK(cond)                                                              \
+    do {                                                                         \
+        if (!(cond)) {                                                           \
+            std::fprintf(stderr, "%s:%d: CHECK failed: %s\n", __FILE__, __LINE__, #cond); \
+            ++g_failures;                                                        \
+        }                                                                        \
+    } while (0)
+
+constexpr int kOrderedPass = 2;
+constexpr uint32_t kOrderedMask = 1u << kOrderedPass;
+
+SceneDrawSection Section(int pass, uint32_t textureKey, uint32_t indexStart, uint32_t indexCount, uint32_t arraySlice = 0) {
+    SceneDrawSection section;
+    section.pass = pass;
+    section.textureKey = textureKey;
+    section.arraySlice = arraySlice;
+    section.indexStart = indexStart;
+    section.indexCount = indexCount;
+    return section;
+}
+
+// One triangle per section over its own three vertices: section i uses vertices 3i..3i+2.
+std::vector<uint32_t> DisjointTriangles(uint32_t count) {
+    std::vector<uint32_t> indices;
+    for (uint32_t i = 0; i < count * 3; ++i) indices.push_back(i);
+    return indices;
+}
+
+// The indices a batch draws, for comparing against the source sections.
+std::vector<uint32_t> BatchIndices(const SceneBatchResult& result, const SceneDrawBatch& batch) {
+    return std::vector<uint32_t>(result.indices.begin() + batch.indexStart, result.indices.begin() + batch.indexStart + batch.indexCount);
+}
+
+void TestGroupsByPassAndTexture() {
+    // Interleaved passes and textures; hidden and empty sections are dropped
+    const std::vector<SceneDrawSection> sections = {
+        Section(1, 7, 0, 3),
+        Section(0, 5, 3, 3),
+        Section(-1, 5, 6, 3),
+        Section(1, 6, 9, 3),
+        Section(0, 5, 12, 3),
+        Section(1, 7, 15, 3),
+        Section(0, 9, 18, 0),
+    };
+    const std::vector<uint32_t> indices = DisjointTriangles(7);
+
+    SceneBatchResult result;
+    std::string error;
+    CHECK(SceneDrawBatcher::Build(sections, indices, 21, 0, result, &error));
+    CHECK(error.empty());
+
+    CHECK(result.batches.size() == 3);
+    if (result.batches.size() != 3) return;
+    CHECK(result.batches[0].pass == 0 && result.batches[0].textureKey == 5 && result.batches[0].sectionCount == 2);
+    CHECK(result.batches[1].pass == 1 && result.batches[1].textureKey == 6 && result.batches[1].sectionCount == 1);
+    CHECK(result.batches[2].pass == 1 && result.batches[2].textureKey == 7 && result.batches[2].sectionCount == 2);
+
+    // Batches are contiguous and cover every drawn index exactly once
+    uint32_t next = 0;
+    for (const SceneDrawBatch& batch : result.batches) {
+        CHECK(batch.indexStart == next);
+        next += batch.indexCount;
+    }
+    CHECK(next == result.indices.size());
+    CHECK(result.indices.size() == 15);
+
+    // Sections inside a batch keep their original relative order
+    CHECK((BatchIndices(result, result.batches[0]) == std::vector<uint32_t>{ 3, 4, 5, 12, 13, 14 }));
+    CHECK((BatchIndices(result, result.batches[2]) == std::vector<uint32_t>{ 0, 1, 2, 15, 16, 17 }));
+
+    // Single slice: no duplicates, identity mapping
+    CHECK(result.vertexSource.size() == 21);
+    for (uint32_t v = 0; v < result.vertexSource.size(); ++v) CHECK(result.vertexSource[v] == v);
+    for (uint32_t slice : result.vertexSlices) CHECK(slice == 0);
+}
+
+void TestOrderedPassMergesOnlyNeighbours() {
+    // Texture sequence 4,4,3,4 in the ordered pass: the first two merge, the last one stays apart
+    const std::vector<SceneDrawSection> sections = {
+        Section(kOrderedPass, 4, 0, 3),
+        Section(kOrderedPass, 4, 3, 3),
+        Section(kOrderedPass, 3, 6, 3),
+        Section(kOrderedPass, 4, 9, 3),
+        Section(0, 8, 12, 3),
+    };
+    const std::vector<uint32_t> indices = DisjointTriangles(5);
+
+    SceneBatchResult result;
+    CHECK(SceneDrawBatcher::Build(sections, indices, 15, kOrderedMask, result));
+
+    CHECK(result.batches.size() == 4);
+    if (result.batches.size() != 4) return;
+    CHECK(result.batches[0].pass == 0 && result.batches[0].textureKey == 8);
+    CHECK(result.batches[1].pass == kOrderedPass && result.batches[1].textureKey == 4 && result.batches[1].sectionCount == 2);
+    CHECK(result.batches[2].pass == kOrderedPass && result.batches[2].textureKey == 3 && result.batches[2].sectionCount == 1);
+    CHECK(result.batches[3].pass == kOrderedPass && result.batches[3].textureKey == 4 && result.batches[3].sectionCount == 1);
+
+    // Draw order of the ordered pass is exactly the authored section order
+    CHECK((BatchIndices(result, result.batches[1]) == std::vector<uint32_t>{ 0, 1, 2, 3, 4, 5 }));
+    CHECK((BatchIndices(result, result.batches[2]) == std::vector<uint32_t>{ 6, 7, 8 }));
+    CHECK((BatchIndices(result, result.batches[3]) == std::vector<uint32_t>{ 9, 10, 11 }));
+
+    // Without the mask the same pass groups by texture instead
+    CHECK(SceneDrawBatcher::Build(sections, indices, 15, 0, result));
+    CHECK(result.batches.size() == 3);
+    if (result.batches.size() != 3) return;
+    CHECK(result.batches[1].textureKey == 3 && result.batches[2].textureKey == 4 && result.batches[2].sectionCount == 3);
+}
+
+void TestSharedVertexDuplicatedPerSlice() {
+    // Two quads of one packed array share the edge 1-2; the second quad samples slice 3
+    const std::vector<uint32_t> indices = {
+        0, 1, 2,
+        1, 3, 2,
+        1, 2, 4,
+        2, 1, 4,
+    };
+    const std::vector<SceneDrawSection> sections = {
+        Section(0, 1, 0, 6, 0),
+        Section(0, 1, 6, 6, 3),
+    };
+
+    SceneBatchResult result;
+    CHECK(SceneDrawBatcher::Build(sections, indices, 6, 0, result));
+
+    CHECK(result.batches.size() == 1);
+    if (result.batches.size() != 1) return;
+    CHECK(result.batches[0].sectionCount == 2 && result.batches[0].indexCount == 12);
+
+    // Vertices 1 and 2 get one copy each for slice 3; 4 was first seen at slice 3 and stays in place
+    CHECK(result.vertexSource.size() == 8);
+    CHECK(result.vertexSlices.size() == 8);
+    if (result.vertexSource.size() != 8 || result.vertexSlices.size() != 8) return;
+    for (uint32_t v = 0; v < 6; ++v) CHECK(result.vertexSource[v] == v);
+    CHECK(result.vertexSource[6] == 1 && result.vertexSlices[6] == 3);
+    CHECK(result.vertexSource[7] == 2 && result.vertexSlices[7] == 3);
+    CHECK(result.vertexSlices[0] == 0 && result.vertexSlices[1] == 0 && result.vertexSlices[2] == 0 && result.vertexSlices[3] == 0);
+    CHECK(result.vertexSlices[4] == 3);
+    CHECK(result.vertexSlices[5] == 0); // untouched
+
+    CHECK((result.indices == std::vector<uint32_t>{ 0, 1, 2, 1, 3, 2, 6, 7, 4, 7, 6, 4 }));
+
+    // Every output index still resolves to the source vertex it replaced, at the slice of its section
+    for (size_t i = 0; i < indices.size(); ++i) {
+        const uint32_t out = result.indices[i];
+        CHECK(result.vertexSource[out] == indices[i]);
+        CHECK(result.vertexSlices[out] == (i < 6 ? 0u : 3u));
+    }
+}
+
+void TestRejectsOutOfRange() {
+    const std::vector<uint32_t> indices = { 0, 1, 2, 2, 1, 9 };
+    SceneBatchResult result;
+    std::string error;
+
+    // Index range past the end of the index buffer
+    CHECK(!SceneDrawBatcher::Build({ Section(0, 1, 3, 6) }, indices, 10, 0, result, &error));
+    CHECK(error.find("index range") != std::string::npos);
+    CHECK(result.batches.empty() && result.indices.empty());
+
+    // Huge start must not wrap around the bounds check
+    error.clear();
+    CHECK(!SceneDrawBatcher::Build({ Section(0, 1, 0xFFFFFFFEu, 3) }, indices, 10, 0, result, &error));
+    CHECK(!error.empty());
+
+    // Vertex 9 with only 9 vertices; the partial result is discarded
+    error.clear();
+    CHECK(!SceneDrawBatcher::Build({ Section(0, 1, 0, 3), Section(0, 2, 3, 3) }, indices, 9, 0, result, &error));
+    CHECK(error.find("vertex 9") != std::string::npos);
+    CHECK(result.batches.empty() && result.indices.empty() && result.vertexSource.empty() && result.vertexSlices.empty());
+
+    // A hidden section is not validated at all
+    CHECK(SceneDrawBatcher::Build({ Section(0, 1, 0, 3), Section(-1, 2, 3, 3) }, indices, 9, 0, result));
+    CHECK(result.batches.size() == 1);
+}
+
+} // namespace
+
+int main() {
+    TestGroupsByPassAndTexture();
+    TestOrderedPassMergesOnlyNeighbours();
+    TestSharedVertexDuplicatedPerSlice();
+    TestRejectsOutOfRange();
+
+    if (g_failures != 0) {
+        std::fprintf(stderr, "SceneBatchingTest: %d check(s) failed\n", g_failures);
+        return 1;
+    }
+    std::fprintf(stderr, "SceneBatchingTest: ok\n");
+    return 0;
+}
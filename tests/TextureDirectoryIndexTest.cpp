@@ -0,0 +1,86 @@
+// TextureDirectoryIndex: path normalization and resolution of paths that leave an indexed root
+// through ".." segments.
+
+#include "RealSpace3/Include/TextureDirectoryIndex.h"
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <system_error>
+
+using namespace RealSpace3;
+namespace fs = std::filesystem;
+
+namespace {
+
+int g_failures = 0;
+
+#define CHECK(cond)                                                              \
+    do {                                                                         \
+        if (!(cond)) {                                                           \
+            std::fprintf(stderr, "%s:%d: CHECK failed: %s\n", __FILE__, __LINE__, #cond); \
+            ++g_failures;                                                        \
+        }                                                                        \
+    } while (0)
+
+void WriteFile(const fs::path& path) {
+    fs::create_directories(path.parent_path());
+    std::ofstream(path, std::ios::binary) << "x";
+}
+
+void TestNormalize() {
+    CHECK(TextureDirectoryIndex::Normalize("Maps\\Town//Tex.DDS") == "maps/town/tex.dds");
+    CHECK(TextureDirectoryIndex::Normalize("./maps/./town/") == "maps/town");
+    CHECK(TextureDirectoryIndex::Normalize("maps/town/../interface/a.dds") == "maps/interface/a.dds");
+    CHECK(TextureDirectoryIndex::Normalize("maps/a/../../b.dds") == "b.dds");
+    CHECK(TextureDirectoryIndex::Normalize("../shared/a.dds") == "../shared/a.dds");
+    CHECK(TextureDirectoryIndex::Normalize("maps/../../x/../y") == "../y");
+    CHECK(TextureDirectoryIndex::Normalize("/../data/a.dds") == "/data/a.dds");
+    CHECK(TextureDirectoryIndex::Normalize("/") == "/");
+    CHECK(TextureDirectoryIndex::Normalize(".") == ".");
+    CHECK(TextureDirectoryIndex::Normalize("") == "");
+}
+
+void TestDotSegmentsLeavingRoot() {
+    std::error_code ec;
+    const fs::path base = fs::temp_directory_path(ec) / "rs3_texture_index_test";
+    fs::remove_all(base, ec);
+    WriteFile(base / "Root" / "Sub" / "Inside.dds");
+    WriteFile(base / "Outside" / "Shared.dds");
+
+    TextureDirectoryIndex index;
+    const std::string root = (base / "Root").generic_string();
+    CHECK(index.AddRoot(root));
+
+    std::string actual;
+    CHECK(index.Resolve(root + "/sub/../SUB/inside.dds", actual));
+    CHECK(fs::path(actual).filename() == "Inside.dds");
+
+    // The directory key used to start with the root, so this was answered as a miss from
+    // root's index without ever listing Outside
+    CHECK(index.Resolve(root + "/Sub/../../Outside/shared.dds", actual));
+    CHECK(fs::path(actual).filename() == "Shared.dds");
+    CHECK(fs::exists(actual));
+
+    // Covered from now on: a miss there stays a miss without another listing
+    const size_t listed = index.GetListedDirectoryCount();
+    CHECK(!index.Resolve((base / "outside" / "missing.dds").generic_string(), actual));
+    CHECK(index.GetListedDirectoryCount() == listed);
+
+    fs::remove_all(base, ec);
+}
+
+} // namespace
+
+int main() {
+    TestNormalize();
+    TestDotSegmentsLeavingRoot();
+
+    if (g_failures != 0) {
+        std::fprintf(stderr, "TextureDirectoryIndexTest: %d check(s) failed\n", g_failures);
+        return 1;
+    }
+    std::fprintf(stderr, "TextureDirectoryIndexTest: ok\n");
+    return 0;
+}
@@ -0,0 +1,268 @@
+// TextureResidencyManager against a mock device: tail commit, refinement, VRAM demotion and
+// eviction, RAM eviction and the reload path TextureManager::MarkUsed takes.
+
+#include "RealSpace3/Include/TextureResidency.h"
+
+#include <cstdio>
+#include <map>
+#include <set>
+#include <vector>
+
+using namespace RealSpace3;
+
+namespace {
+
+int g_failures = 0;
+
+#define CHECK(cond)                                                              \
+    do {                                                                         \
+        if (!(cond)) {                                                           \
+            std::fprintf(stderr, "%s:%d: CHECK failed: %s\n", __FILE__, __LINE__, #cond); \
+            ++g_failures;                                                        \
+        }                                                                        \
+    } while (0)
+
+class MockDevice : public ITextureResidencyDevice {
+public:
+    bool CommitMips(uint32_t textureId, uint32_t firstMip) override {
+        if (failCommits) return false;
+        committed[textureId] = firstMip;
+        ++commitCount;
+        return true;
+    }
+    void ReleaseGpu(uint32_t textureId) override { committed.erase(textureId); }
+    void ReleaseCpu(uint32_t textureId) override { cpuReleased.insert(textureId); }
+
+    std::map<uint32_t, uint32_t> committed; // texture -> first mip on the GPU
+    std::set<uint32_t> cpuReleased;
+    uint32_t commitCount = 0;
+    bool failCommits = false;
+};
+
+// Square RGBA8 chain: size, size/2, ..., 1
+std::vector<TextureMipInfo> MakeMips(uint32_t size) {
+    std::vector<TextureMipInfo> mips;
+    for (uint32_t dim = size;; dim /= 2) {
+        mips.push_back({ dim, dim, static_cast<uint64_t>(dim) * dim * 4 });
+        if (dim == 1) break;
+    }
+    return mips;
+}
+
+uint64_t BytesFrom(const std::vector<TextureMipInfo>& mips, uint32_t firstMip) {
+    uint64_t bytes = 0;
+    for (size_t i = firstMip; i < mips.size(); ++i) bytes += mips[i].bytes;
+    return bytes;
+}
+
+TextureResidencyBudget LargeBudget() {
+    TextureResidencyBudget budget;
+    budget.vramBytes = 64ull * 1024 * 1024;
+    budget.ramBytes = 64ull * 1024 * 1024;
+    budget.tailDimension = 64;
+    budget.refinementsPerUpdate = 4;
+    return budget;
+}
+
+void TestTailAndRefine() {
+    MockDevice device;
+    TextureResidencyManager residency(device);
+    residency.SetBudget(LargeBudget());
+    const auto mips = MakeMips(256); // 256, 128, 64 (tail), ...
+
+    CHECK(residency.Register(1, mips, 1));
+    CHECK(residency.GetFirstResidentMip(1) == 2);
+    CHECK(device.committed[1] == 2);
+    CHECK(residency.GetVramUsage() == BytesFrom(mips, 2));
+    CHECK(residency.GetRamUsage() == BytesFrom(mips, 0));
+
+    // One level per update while the texture is in use
+    residency.Touch(1, 2);
+    residency.Update(2);
+    CHECK(residency.GetFirstResidentMip(1) == 1);
+    residency.Touch(1, 3);
+    residency.Update(3);
+    CHECK(residency.GetFirstResidentMip(1) == 0);
+    CHECK(device.committed[1] == 0);
+    CHECK(residency.GetVramUsage() == BytesFrom(mips, 0));
+
+    // Unused textures are not refined
+    CHECK(residency.Register(2, mips, 3));
+    residency.Update(10);
+    CHECK(residency.GetFirstResidentMip(2) == 2);
+
+    residency.Unregister(1);
+    residency.Unregister(2);
+    CHECK(residency.GetVramUsage() == 0);
+    CHECK(residency.GetRamUsage() == 0);
+    CHECK(device.committed.empty());
+}
+
+void TestRefinementsPerUpdate() {
+    MockDevice device;
+    TextureResidencyManager residency(device);
+    TextureResidencyBudget budget = LargeBudget();
+    budget.refinementsPerUpdate = 2;
+    residency.SetBudget(budget);
+    const auto mips = MakeMips(256);
+
+    for (uint32_t id = 1; id <= 5; ++id) residency.Register(id, mips, 1);
+    for (uint32_t id = 1; id <= 5; ++id) residency.Touch(id, 2);
+    const uint32_t before = device.commitCount;
+    residency.Update(2);
+    CHECK(device.commitCount - before == 2);
+}
+
+void TestVramDemoteThenEvict() {
+    MockDevice device;
+    TextureResidencyManager residency(device);
+    const auto mips = MakeMips(256);
+    TextureResidencyBudget budget = LargeBudget();
+    budget.vramBytes = BytesFrom(mips, 0) + BytesFrom(mips, 2);
+    residency.SetBudget(budget);
+
+    // Texture 1 fully refined, then left unused
+    residency.Register(1, mips, 1);
+    for (uint64_t frame = 2; frame <= 3; ++frame) {
+        residency.Touch(1, frame);
+        residency.Update(frame);
+    }
+    CHECK(residency.GetFirstResidentMip(1) == 0);
+
+    // Texture 2 refines at frame 10: texture 1 is demoted to its tail to make room
+    residency.Register(2, mips, 9);
+    residency.Touch(2, 10);
+    residency.Update(10);
+    CHECK(residency.GetFirstResidentMip(2) == 1);
+    CHECK(residency.GetFirstResidentMip(1) == 2);
+    residency.Touch(2, 11);
+    residency.Update(11);
+    CHECK(residency.GetFirstResidentMip(2) == 0);
+    CHECK(residency.GetVramUsage() <= budget.vramBytes);
+
+    // Lowering the budget evicts the unused tail entirely; the in-use texture is protected
+    budget.vramBytes = BytesFrom(mips, 0);
+    residency.SetBudget(budget);
+    residency.Touch(2, 12);
+    residency.Update(12);
+    CHECK(residency.GetFirstResidentMip(1) == TextureResidencyManager::kNotResident);
+    CHECK(residency.GetFirstResidentMip(2) == 0);
+    CHECK(device.committed.count(1) == 0);
+    // Its CPU copy is still there, so the next use can commit it again without a decode
+    CHECK(!residency.NeedsReload(1));
+}
+
+void TestRamEvictsRefinedCpuCopyOnly() {
+    MockDevice device;
+    TextureResidencyManager residency(device);
+    const auto mips = MakeMips(256);
+    TextureResidencyBudget budget = LargeBudget();
+    budget.ramBytes = BytesFrom(mips, 0) * 2;
+    residency.SetBudget(budget);
+
+    residency.Register(1, mips, 1);
+    for (uint64_t frame = 2; frame <= 3; ++frame) {
+        residency.Touch(1, frame);
+        residency.Update(frame);
+    }
+    CHECK(residency.GetFirstResidentMip(1) == 0);
+
+    // A third texture exceeds the RAM budget: the refined one gives up its CPU copy first,
+    // even though it is more recently used than texture 2
+    residency.Register(2, mips, 3);
+    residency.Register(3, mips, 4);
+    CHECK(!residency.IsCpuResident(1));
+    CHECK(residency.GetFirstResidentMip(1) == 0);
+    CHECK(!residency.NeedsReload(1));
+    CHECK(residency.IsCpuResident(2));
+    CHECK(residency.IsCpuResident(3));
+    CHECK(residency.GetRamUsage() <= budget.ramBytes);
+}
+
+void TestRamEvictsUnrefinedCompletely() {
+    MockDevice device;
+    TextureResidencyManager residency(device);
+    const auto mips = MakeMips(256);
+    TextureResidencyBudget budget = LargeBudget();
+    budget.ramBytes = BytesFrom(mips, 0) * 2;
+    residency.SetBudget(budget);
+
+    // Texture 1 stays at its tail and goes unused; two newer textures push RAM over budget
+    residency.Register(1, mips, 1);
+    residency.Register(2, mips, 5);
+    residency.Register(3, mips, 6);
+
+    // Dropping only its CPU copy would strand it at the tail forever: it must be fully
+    // evicted so the owner decodes it again
+    CHECK(!residency.IsCpuResident(1));
+    CHECK(residency.GetFirstResidentMip(1) == TextureResidencyManager::kNotResident);
+    CHECK(device.committed.count(1) == 0);
+    CHECK(residency.NeedsReload(1));
+    CHECK(residency.GetVramUsage() == BytesFrom(mips, 2) * 2);
+
+    // Reload as TextureManager::MarkUsed does: unregister, decode, register again
+    residency.Unregister(1);
+    residency.Unregister(3);
+    CHECK(residency.Register(1, mips, 7));
+    CHECK(residency.GetFirstResidentMip(1) == 2);
+    for (uint64_t frame = 8; frame <= 9; ++frame) {
+        residency.Touch(1, frame);
+        residency.Update(frame);
+    }
+    CHECK(residency.GetFirstResidentMip(1) == 0);
+}
+
+void TestProtectedTexturesKeepCpuCopy() {
+    MockDevice device;
+    TextureResidencyManager residency(device);
+    const auto mips = MakeMips(256);
+    TextureResidencyBudget budget = LargeBudget();
+    budget.ramBytes = BytesFrom(mips, 0);
+    residency.SetBudget(budget);
+
+    // Both were used this frame and neither is refined: nothing may be evicted yet
+    residency.Register(1, mips, 5);
+    residency.Register(2, mips, 5);
+    CHECK(residency.IsCpuResident(1));
+    CHECK(residency.IsCpuResident(2));
+    CHECK(!residency.NeedsReload(1));
+    CHECK(!residency.NeedsReload(2));
+
+    // Once they age out, the least recently used one goes
+    residency.Touch(2, 8);
+    residency.Update(8);
+    CHECK(residency.NeedsReload(1));
+    CHECK(residency.IsCpuResident(2));
+}
+
+void TestFailedCommit() {
+    MockDevice device;
+    TextureResidencyManager residency(device);
+    residency.SetBudget(LargeBudget());
+    device.failCommits = true;
+
+    CHECK(!residency.Register(1, MakeMips(128), 1));
+    CHECK(residency.GetTextureCount() == 1);
+    CHECK(residency.GetFirstResidentMip(1) == TextureResidencyManager::kNotResident);
+    CHECK(residency.GetVramUsage() == 0);
+    CHECK(!residency.NeedsReload(1));
+}
+
+} // namespace
+
+int main() {
+    TestTailAndRefine();
+    TestRefinementsPerUpdate();
+    TestVramDemoteThenEvict();
+    TestRamEvictsRefinedCpuCopyOnly();
+    TestRamEvictsUnrefinedCompletely();
+    TestProtectedTexturesKeepCpuCopy();
+    TestFailedCommit();
+
+    if (g_failures != 0) {
+        std::fprintf(stderr, "TextureResidencyTest: %d check(s) failed\n", g_failures);
+        return 1;
+    }
+    std::fprintf(stderr, "TextureResidencyTest: ok\n");
+    return 0;
+}
@@ -839,21 +839,36 @@ function writeMaterialsBin(model, outPath) {
   fs.writeFileSync(outPath, w.finish());
 }
 
-function writeModelJson(modelId, sourceGlb, model, outPath) {
+/*
+  Clip set identity: anim.bin content plus the bone order its channel indices refer to.
+  Packages with the same id share one runtime clip set (the second anim.bin is never read)
+  and other skeletons of the rig are bound to it by bone name.
+*/
+function computeClipSetId(model, animHash) {
+  if (model.clips.length === 0) return "";
+  const rigId = model.bones.length > 0 ? model.bones[0].name : "";
+  const digest = crypto.createHash("sha256")
+    .update(animHash)
+    .update(model.bones.map((b) => b.name).join("\n"))
+    .digest("hex");
+  return `${rigId}/${digest.slice(0, 16)}`;
+}
+
+function writeModelJson(modelId, sourceGlb, model, files, clipSetId, outPath) {
   const modelJson = {
     version: "rs3_model_v1",
     modelId,
     sourceGlb: normalizeSlash(sourceGlb),
-    files: {
+    files: Object.assign({
       mesh: "mesh.bin",
       skeleton: "skeleton.bin",
       animation: "anim.bin",
       materials: "materials.bin",
       attachments: "attachments.json"
-    },
+    }, files),
     stats: model.stats,
     rigId: model.bones.length > 0 ? model.bones[0].name : "",
-    clipSetId: `${modelId}_clips`,
+    clipSetId,
     materialPolicy: "pbr_v1",
     generatedAt: new Date().toISOString()
   };
@@ -861,6 +876,65 @@ function writeModelJson(modelId, sourceGlb, model, outPath) {
   fs.writeFileSync(outPath, JSON.stringify(modelJson, null, 2), "utf8");
 }
 
+/*
+  Content-addressed store shared by every package under the output root:
+  <output-root>/_store/<kind>/<sha256>.<ext>. Packages reference blobs as
+  "@store/<kind>/<sha256>.<ext>"; identical skeletons, clip sets and textures
+  are written once and loaded once by the runtime.
+*/
+const CONTENT_STORE_DIR = "_store";
+const CONTENT_STORE_PREFIX = "@store/";
+
+function createContentStore(outputRoot) {
+  const storeRoot = path.join(outputRoot, CONTENT_STORE_DIR);
+  const stats = { blobs: 0, hits: 0, bytesWritten: 0, bytesDeduplicated: 0 };
+  const known = new Set();
+
+  // Moves filePath into the store and returns the package reference.
+  function adopt(kind, filePath) {
+    const bytes = fs.readFileSync(filePath);
+    const digest = crypto.createHash("sha256").update(bytes).digest("hex");
+    const ext = path.extname(filePath).toLowerCase() || ".bin";
+    const rel = `${kind}/${digest}${ext}`;
+    const target = path.join(storeRoot, kind, `${digest}${ext}`);
+
+    if (known.has(rel) || fileExistsSafe(target)) {
+      stats.hits++;
+      stats.bytesDeduplicated += bytes.length;
+    } else {
+      ensureDir(path.dirname(target));
+      fs.writeFileSync(target, bytes);
+      stats.blobs++;
+      stats.bytesWritten += bytes.length;
+    }
+    known.add(rel);
+    fs.unlinkSync(filePath);
+    return CONTENT_STORE_PREFIX + rel;
+  }
+
+  return { storeRoot, stats, adopt };
+}
+
+// Package-local texture files move to the store; other references are left alone.
+function adoptMaterialTextures(store, modelDir, materials) {
+  const adopted = new Map();
+  const fields = ["baseColorTexture", "normalTexture", "ormTexture", "emissiveTexture", "opacityTexture"];
+  for (const m of materials) {
+    for (const field of fields) {
+      const ref = String(m[field] || "");
+      if (!ref || ref.startsWith(CONTENT_STORE_PREFIX)) continue;
+      if (!adopted.has(ref)) {
+        const localPath = path.join(modelDir, ref);
+        adopted.set(ref, fileExistsSafe(localPath) ? store.adopt("textures", localPath) : ref);
+      }
+      m[field] = adopted.get(ref);
+    }
+  }
+
+  const texturesDir = path.join(modelDir, "textures");
+  if (fs.existsSync(texturesDir) && fs.readdirSync(texturesDir).length === 0) fs.rmdirSync(texturesDir);
+}
+
 function loadInputEntries(args, inputRoot) {
   const manifestPath = args.manifest ? path.resolve(args.manifest) : path.join(inputRoot, "open_assets_manifest_v1.json");
 
@@ -911,6 +985,7 @@ function main() {
   ensureDir(outputRoot);
 
   const strict = !args["allow-missing"];
+  const contentStore = args["no-content-store"] ? null : createContentStore(outputRoot);
 
   const input = loadInputEntries(args, inputRoot);
   const entries = input.entries;
@@ -946,6 +1021,7 @@ function main() {
     const modelDir = path.join(outputRoot, normalizeSlash(e.modelId));
     ensureDir(modelDir);
     materializeEmbeddedTextures(parsed.json, parsed.bin, modelDir, extracted.materials);
+    if (contentStore) adoptMaterialTextures(contentStore, modelDir, extracted.materials);
 
     const meshPath = path.join(modelDir, "mesh.bin");
     const skeletonPath = path.join(modelDir, "skeleton.bin");
@@ -959,7 +1035,22 @@ function main() {
     writeAnimBin(extracted, animPath);
     writeMaterialsBin(extracted, materialsPath);
     fs.writeFileSync(attachmentsPath, JSON.stringify(extracted.attachments, null, 2), "utf8");
-    writeModelJson(e.modelId, e.glbPath, extracted, modelJsonPath);
+
+    const hashes = {
+      mesh: hashFileSha256(meshPath),
+      skeleton: hashFileSha256(skeletonPath),
+      animation: hashFileSha256(animPath),
+      materials: hashFileSha256(materialsPath)
+    };
+
+    const files = {};
+    if (contentStore) {
+      files.skeleton = contentStore.adopt("skeletons", skeletonPath);
+      files.animation = contentStore.adopt("clips", animPath);
+    }
+    const clipSetId = computeClipSetId(extracted, hashes.animation);
+    writeModelJson(e.modelId, e.glbPath, extracted, files, clipSetId, modelJsonPath);
+    hashes.modelJson = hashFileSha256(modelJsonPath);
 
     const outEntry = {
       modelId: e.modelId,
@@ -967,13 +1058,9 @@ function main() {
       sourceGlb: normalizeSlash(e.glbPath),
       outputDir: normalizeSlash(modelDir),
       stats: extracted.stats,
-      hashes: {
-        mesh: hashFileSha256(meshPath),
-        skeleton: hashFileSha256(skeletonPath),
-        animation: hashFileSha256(animPath),
-        materials: hashFileSha256(materialsPath),
-        modelJson: hashFileSha256(modelJsonPath)
-      }
+      clipSetId,
+      files,
+      hashes
     };
 
     results.push(outEntry);
@@ -1000,6 +1087,7 @@ function main() {
       missingDependencyCount: missing.length
     },
     missing,
+    contentStore: contentStore ? Object.assign({ root: normalizeSlash(contentStore.storeRoot) }, contentStore.stats) : null,
     entries: results
   };
 
@@ -1018,6 +1106,10 @@ function main() {
   report.push(`- ok: **${okCount}**`);
   report.push(`- error: **${errorCount}**`);
   report.push(`- missing_glb: **${missingCount}**`);
+  if (contentStore) {
+    const st = contentStore.stats;
+    report.push(`- content store: **${st.blobs}** blobs (${st.bytesWritten} bytes), **${st.hits}** deduplicated (${st.bytesDeduplicated} bytes)`);
+  }
   report.push("");
   report.push("## Entries");
   report.push("");
@@ -1031,6 +1123,9 @@ function main() {
   fs.writeFileSync(reportPath, report.join("\n"), "utf8");
 
   console.log(`[glb_to_rs3_model] entries=${entries.length} ok=${okCount} error=${errorCount} missing=${missingCount}`);
+  if (contentStore) {
+    console.log(`[glb_to_rs3_model] store blobs=${contentStore.stats.blobs} dedup_hits=${contentStore.stats.hits} dedup_bytes=${contentStore.stats.bytesDeduplicated}`);
+  }
   console.log(`[glb_to_rs3_model] manifest=${normalizeSlash(outputManifestPath)}`);
   console.log(`[glb_to_rs3_model] report=${normalizeSlash(reportPath)}`);
 
@@ -1040,7 +1135,7 @@ function main() {
 }
 
 function printUsage() {
-  console.log("Usage: node glb_to_rs3_model.js --input-root <.../open_assets> --output-root <.../models> [--manifest <open_assets_manifest_v1.json>] [--out-manifest <...>] [--allow-missing]");
+  console.log("Usage: node glb_to_rs3_model.js --input-root <.../open_assets> --output-root <.../models> [--manifest <open_assets_manifest_v1.json>] [--out-manifest <...>] [--allow-missing] [--no-content-store]");
 }
 
 if (process.argv.includes("--help") || process.argv.includes("-h")) {
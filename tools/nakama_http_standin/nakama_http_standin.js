@@ -0,0 +1,127 @@
+#!/usr/bin/env node
+/*
+  nakama_http_standin.js
+  Servidor HTTP local que imita as rotas REST do Nakama usadas pelo cliente e conta
+  conexoes TCP e requisicoes por conexao, para medir o reuso (keep-alive) do transporte.
+*/
+
+const http = require("http");
+
+function parseArgs(argv) {
+  const out = {};
+  for (let i = 2; i < argv.length; i++) {
+    const token = argv[i];
+    if (!token.startsWith("--")) continue;
+    const key = token.slice(2);
+    const next = argv[i + 1];
+    if (next && !next.startsWith("--")) {
+      out[key] = next;
+      i++;
+    } else {
+      out[key] = true;
+    }
+  }
+  return out;
+}
+
+function toInt(value, fallback) {
+  const parsed = Number.parseInt(value, 10);
+  return Number.isFinite(parsed) && parsed >= 0 ? parsed : fallback;
+}
+
+function base64Url(value) {
+  return Buffer.from(value).toString("base64").replace(/=+$/, "").replace(/\+/g, "-").replace(/\//g, "_");
+}
+
+function fakeSessionToken() {
+  const now = Math.floor(Date.now() / 1000);
+  const payload = { tid: "standin", uid: "00000000-0000-0000-0000-000000000001", usn: "standin", exp: now + 3600, iat: now };
+  return `${base64Url(JSON.stringify({ alg: "HS256", typ: "JWT" }))}.${base64Url(JSON.stringify(payload))}.standin`;
+}
+
+function routeResponse(method, pathname, body) {
+  if (pathname.startsWith("/v2/account/authenticate/") || pathname === "/v2/account/session/refresh") {
+    return { status: 200, json: { created: false, token: fakeSessionToken(), refresh_token: fakeSessionToken() } };
+  }
+  if (pathname.startsWith("/v2/rpc/")) {
+    const id = decodeURIComponent(pathname.slice("/v2/rpc/".length));
+    return { status: 200, json: { id, payload: body && body.length ? body : "{}" } };
+  }
+  if (pathname === "/v2/account" && method === "GET") {
+    return { status: 200, json: { user: { id: "00000000-0000-0000-0000-000000000001", username: "standin" } } };
+  }
+  if (pathname === "/healthcheck") {
+    return { status: 200, json: {} };
+  }
+  return { status: 404, json: { error: "not found", message: `stand-in has no route for ${method} ${pathname}`, code: 5 } };
+}
+
+function main() {
+  const args = parseArgs(process.argv);
+  const host = String(args.host || "127.0.0.1");
+  const port = toInt(args.port, 7350);
+  const latencyMs = toInt(args["latency-ms"], 0);
+  const keepAliveMs = toInt(args["keep-alive-ms"], 60000);
+  const quiet = !!args.quiet;
+
+  const stats = { connections: 0, open: 0, requests: 0, reusedRequests: 0, maxOpen: 0 };
+  let nextConnectionId = 0;
+
+  const server = http.createServer((req, res) => {
+    const chunks = [];
+    req.on("data", (chunk) => chunks.push(chunk));
+    req.on("end", () => {
+      const socket = req.socket;
+      socket.ndgRequests = (socket.ndgRequests || 0) + 1;
+      stats.requests++;
+      if (socket.ndgRequests > 1) stats.reusedRequests++;
+
+      const url = new URL(req.url, `http://${host}`);
+      const body = Buffer.concat(chunks).toString("utf8");
+      const reply = url.pathname === "/__standin/stats"
+        ? { status: 200, json: stats }
+        : routeResponse(req.method, url.pathname, body);
+
+      if (!quiet) {
+        console.log(`[conn#${socket.ndgId}] req=${socket.ndgRequests} ${req.method} ${url.pathname} -> ${reply.status}`);
+      }
+      setTimeout(() => {
+        const text = JSON.stringify(reply.json);
+        res.writeHead(reply.status, { "Content-Type": "application/json", "Content-Length": Buffer.byteLength(text) });
+        res.end(text);
+      }, latencyMs);
+    });
+  });
+
+  server.keepAliveTimeout = keepAliveMs;
+  server.headersTimeout = keepAliveMs + 1000;
+
+  server.on("connection", (socket) => {
+    socket.ndgId = ++nextConnectionId;
+    stats.connections++;
+    stats.open++;
+    stats.maxOpen = Math.max(stats.maxOpen, stats.open);
+    if (!quiet) console.log(`[conn#${socket.ndgId}] open from ${socket.remoteAddress}:${socket.remotePort} (abertas=${stats.open})`);
+    socket.on("close", () => {
+      stats.open--;
+      if (!quiet) console.log(`[conn#${socket.ndgId}] close apos ${socket.ndgRequests || 0} requisicoes (abertas=${stats.open})`);
+    });
+  });
+
+  const printSummary = () => {
+    const perConnection = stats.connections > 0 ? (stats.requests / stats.connections).toFixed(2) : "0";
+    console.log(`[standin] conexoes=${stats.connections} max_abertas=${stats.maxOpen} requisicoes=${stats.requests} ` +
+      `reusadas=${stats.reusedRequests} req_por_conexao=${perConnection}`);
+  };
+
+  process.on("SIGINT", () => {
+    printSummary();
+    process.exit(0);
+  });
+
+  server.listen(port, host, () => {
+    console.log(`[standin] ouvindo em http://${host}:${port} latency_ms=${latencyMs} keep_alive_ms=${keepAliveMs}`);
+  });
+}
+
+main();
@@ -0,0 +1,361 @@
+#!/usr/bin/env node
+/*
+  rs3_asset_packer.js
+  Packs rs3 runtime assets (scenes, models, textures) into a single
+  memory-mappable .rs3pak archive read by AssetPack/AssetFileSystem.
+  Layout: docs/rs3_pack_v1.md.
+*/
+
+const fs = require("fs");
+const path = require("path");
+
+const PACK_MAGIC = Buffer.from([0x52, 0x53, 0x33, 0x50, 0x41, 0x4b, 0x31, 0x00]); // RS3PAK1\0
+const PACK_VERSION = 1;
+const HEADER_SIZE = 64;
+const ENTRY_SIZE = 40;
+
+const COMPRESSION_NONE = 0;
+const COMPRESSION_LZ4 = 1;
+
+// Tooling-only files never read through the VFS. navmesh.bin is packed: the runtime uses it
+// when its source hash still matches world.bin (baked with RS3SceneTool --nav-bake)
+const SKIPPED_FILES = new Set(["texture_index_v1.txt"]);
+const SKIPPED_EXTENSIONS = new Set([".md", ".rs3pak"]);
+// Stored raw so the runtime can upload them straight from the mapping
+const RAW_EXTENSIONS = new Set([".dds", ".png", ".jpg", ".jpeg"]);
+
+const FNV_OFFSET = BigInt("14695981039346656037");
+const FNV_PRIME = BigInt("1099511628211");
+const U64_MASK = (BigInt(1) << BigInt(64)) - BigInt(1);
+
+function parseArgs(argv) {
+  const args = {};
+  for (let i = 2; i < argv.length; i++) {
+    const token = argv[i];
+    if (!token.startsWith("--")) continue;
+    const key = token.slice(2);
+    const next = argv[i + 1];
+    if (next && !next.startsWith("--")) {
+      args[key] = next;
+      i++;
+    } else {
+      args[key] = true;
+    }
+  }
+  return args;
+}
+
+function normalizeSlash(v) {
+  return String(v || "").replace(/\\/g, "/");
+}
+
+// Must match TextureDirectoryIndex::Normalize (ASCII lowercase only)
+function normalizeAssetPath(p) {
+  return normalizeSlash(p)
+    .replace(/[A-Z]/g, (c) => c.toLowerCase())
+    .replace(/\/{2,}/g, "/")
+    .replace(/^(\.\/)+/, "")
+    .replace(/\/+$/, "");
+}
+
+function fnv1a64(bytes) {
+  let hash = FNV_OFFSET;
+  for (const b of bytes) {
+    hash ^= BigInt(b);
+    hash = (hash * FNV_PRIME) & U64_MASK;
+  }
+  return hash;
+}
+
+function writeU64(buffer, value, offset) {
+  const big = BigInt(value);
+  buffer.writeUInt32LE(Number(big & BigInt(0xffffffff)), offset);
+  buffer.writeUInt32LE(Number(big >> BigInt(32)), offset + 4);
+}
+
+function readU64(buffer, offset) {
+  return buffer.readUInt32LE(offset) + buffer.readUInt32LE(offset + 4) * 0x100000000;
+}
+
+function alignUp(value, alignment) {
+  return Math.ceil(value / alignment) * alignment;
+}
+
+function nextPowerOfTwo(value) {
+  let p = 1;
+  while (p < value) p *= 2;
+  return p;
+}
+
+/*
+  LZ4 block compressor (greedy, single hash probe). Output follows the LZ4 block
+  format: the last 5 bytes are literals and no match starts in the last 12.
+*/
+function lz4CompressBlock(src) {
+  const n = src.length;
+  const out = Buffer.alloc(n + Math.ceil(n / 255) + 16);
+  const table = new Int32Array(1 << 16).fill(-1);
+  const matchLimit = n - 5;
+  const ipLimit = n - 12;
+  let op = 0;
+  let anchor = 0;
+  let ip = 0;
+
+  const writeLength = (length) => {
+    while (length >= 255) {
+      out[op++] = 255;
+      length -= 255;
+    }
+    out[op++] = length;
+  };
+
+  const emit = (literalEnd, offset, matchLength) => {
+    const literalLength = literalEnd - anchor;
+    const tokenPos = op++;
+    let token = Math.min(literalLength, 15) << 4;
+    if (literalLength >= 15) writeLength(literalLength - 15);
+    src.copy(out, op, anchor, literalEnd);
+    op += literalLength;
+    if (matchLength > 0) {
+      out[op++] = offset & 0xff;
+      out[op++] = offset >> 8;
+      const extra = matchLength - 4;
+      token |= Math.min(extra, 15);
+      if (extra >= 15) writeLength(extra - 15);
+    }
+    out[tokenPos] = token;
+  };
+
+  while (ip < ipLimit) {
+    const sequence = src.readUInt32LE(ip);
+    const h = Math.imul(sequence, 2654435761) >>> 16;
+    const ref = table[h];
+    table[h] = ip;
+    if (ref < 0 || ip - ref > 65535 || src.readUInt32LE(ref) !== sequence) {
+      ip++;
+      continue;
+    }
+    let length = 4;
+    while (ip + length < matchLimit && src[ref + length] === src[ip + length]) length++;
+    emit(ip, ip - ref, length);
+    ip += length;
+    anchor = ip;
+  }
+  emit(n, 0, 0);
+  return out.subarray(0, op);
+}
+
+function lz4DecompressBlock(src, size) {
+  const dst = Buffer.alloc(size);
+  let ip = 0;
+  let op = 0;
+  const readLength = (length) => {
+    let b = 255;
+    while (b === 255) {
+      b = src[ip++];
+      length += b;
+    }
+    return length;
+  };
+  while (ip < src.length) {
+    const token = src[ip++];
+    let literals = token >> 4;
+    if (literals === 15) literals = readLength(literals);
+    src.copy(dst, op, ip, ip + literals);
+    ip += literals;
+    op += literals;
+    if (ip >= src.length) break;
+    const offset = src[ip] | (src[ip + 1] << 8);
+    ip += 2;
+    let length = token & 15;
+    if (length === 15) length = readLength(length);
+    length += 4;
+    for (let i = 0; i < length; i++, op++) dst[op] = dst[op - offset];
+  }
+  if (op !== size) throw new Error(`LZ4 round-trip produced ${op} bytes, expected ${size}`);
+  return dst;
+}
+
+function collectFiles(rootDir, includes) {
+  const files = [];
+  const walk = (dir) => {
+    for (const entry of fs.readdirSync(dir, { withFileTypes: true })) {
+      const full = path.join(dir, entry.name);
+      if (entry.isDirectory()) {
+        walk(full);
+        continue;
+      }
+      if (!entry.isFile()) continue;
+      const lower = entry.name.toLowerCase();
+      if (SKIPPED_FILES.has(lower) || SKIPPED_EXTENSIONS.has(path.extname(lower))) continue;
+      const rel = normalizeSlash(path.relative(rootDir, full));
+      files.push({ full, rel, key: normalizeAssetPath(rel) });
+    }
+  };
+
+  for (const include of includes) {
+    const start = path.join(rootDir, include);
+    if (!fs.existsSync(start)) throw new Error(`include not found: ${normalizeSlash(start)}`);
+    if (fs.statSync(start).isDirectory()) {
+      walk(start);
+    } else {
+      const rel = normalizeSlash(path.relative(rootDir, start));
+      files.push({ full: start, rel, key: normalizeAssetPath(rel) });
+    }
+  }
+
+  const seen = new Map();
+  for (const f of files) {
+    const prior = seen.get(f.key);
+    if (prior && prior.full !== f.full) throw new Error(`paths collide after normalization: ${prior.rel} / ${f.rel}`);
+    seen.set(f.key, f);
+  }
+  return Array.from(seen.values()).sort((a, b) => (a.key < b.key ? -1 : a.key > b.key ? 1 : 0));
+}
+
+function chooseStorage(file, data, compressMode) {
+  if (compressMode === "none" || data.length < 64) return { compression: COMPRESSION_NONE, stored: data };
+  if (compressMode === "auto" && RAW_EXTENSIONS.has(path.extname(file.key))) return { compression: COMPRESSION_NONE, stored: data };
+
+  const packed = lz4CompressBlock(data);
+  // Only worth a decompress on load when it saves at least 1/8
+  if (packed.length <= data.length - (data.length >> 3)) {
+    lz4DecompressBlock(packed, data.length);
+    return { compression: COMPRESSION_LZ4, stored: packed };
+  }
+  return { compression: COMPRESSION_NONE, stored: data };
+}
+
+function buildPack(files, alignment, compressMode) {
+  const entries = [];
+  const chunks = [];
+  let offset = HEADER_SIZE;
+  let rawBytes = 0;
+
+  for (const file of files) {
+    const data = fs.readFileSync(file.full);
+    const { compression, stored } = chooseStorage(file, data, compressMode);
+    const dataOffset = alignUp(offset, alignment);
+    if (dataOffset > offset) chunks.push(Buffer.alloc(dataOffset - offset));
+    chunks.push(stored);
+    offset = dataOffset + stored.length;
+    rawBytes += data.length;
+
+    const pathBytes = Buffer.from(file.key, "utf8");
+    if (pathBytes.length > 0xffff) throw new Error(`path too long: ${file.rel}`);
+    entries.push({ key: file.key, pathBytes, hash: fnv1a64(pathBytes), dataOffset, storedSize: stored.length, size: data.length, compression });
+  }
+
+  const tocOffset = alignUp(offset, 8);
+  if (tocOffset > offset) chunks.push(Buffer.alloc(tocOffset - offset));
+
+  const slotCount = nextPowerOfTwo(Math.max(2, entries.length * 2));
+  const slots = new Uint32Array(slotCount);
+  const stringsSize = entries.reduce((sum, e) => sum + e.pathBytes.length, 0);
+  const toc = Buffer.alloc(entries.length * ENTRY_SIZE + slotCount * 4 + stringsSize);
+
+  let stringOffset = 0;
+  entries.forEach((e, i) => {
+    const base = i * ENTRY_SIZE;
+    writeU64(toc, e.hash, base + 0);
+    writeU64(toc, e.dataOffset, base + 8);
+    writeU64(toc, e.storedSize, base + 16);
+    writeU64(toc, e.size, base + 24);
+    toc.writeUInt32LE(stringOffset, base + 32);
+    toc.writeUInt16LE(e.pathBytes.length, base + 36);
+    toc.writeUInt8(e.compression, base + 38);
+    e.pathBytes.copy(toc, entries.length * ENTRY_SIZE + slotCount * 4 + stringOffset);
+    stringOffset += e.pathBytes.length;
+
+    // Linear probing on the low 32 bits, as AssetPack::Find
+    let slot = Number(e.hash & BigInt(0xffffffff)) & (slotCount - 1);
+    while (slots[slot] !== 0) slot = (slot + 1) & (slotCount - 1);
+    slots[slot] = i + 1;
+  });
+  for (let s = 0; s < slotCount; s++) toc.writeUInt32LE(slots[s], entries.length * ENTRY_SIZE + s * 4);
+
+  const header = Buffer.alloc(HEADER_SIZE);
+  PACK_MAGIC.copy(header, 0);
+  header.writeUInt32LE(PACK_VERSION, 8);
+  header.writeUInt32LE(entries.length, 12);
+  header.writeUInt32LE(slotCount, 16);
+  header.writeUInt32LE(alignment, 20);
+  writeU64(header, tocOffset, 24);
+  writeU64(header, toc.length, 32);
+  writeU64(header, stringsSize, 40);
+
+  return {
+    buffer: Buffer.concat([header, ...chunks, toc]),
+    entries,
+    rawBytes
+  };
+}
+
+function listPack(packPath) {
+  const buf = fs.readFileSync(packPath);
+  if (buf.length < HEADER_SIZE || !buf.subarray(0, 8).equals(PACK_MAGIC)) throw new Error(`not an rs3 pack: ${packPath}`);
+  const entryCount = buf.readUInt32LE(12);
+  const slotCount = buf.readUInt32LE(16);
+  const tocOffset = readU64(buf, 24);
+  const stringsBase = tocOffset + entryCount * ENTRY_SIZE + slotCount * 4;
+  for (let i = 0; i < entryCount; i++) {
+    const base = tocOffset + i * ENTRY_SIZE;
+    const dataOffset = readU64(buf, base + 8);
+    const storedSize = readU64(buf, base + 16);
+    const size = readU64(buf, base + 24);
+    const pathOffset = buf.readUInt32LE(base + 32);
+    const pathLength = buf.readUInt16LE(base + 36);
+    const compression = buf.readUInt8(base + 38);
+    const name = buf.toString("utf8", stringsBase + pathOffset, stringsBase + pathOffset + pathLength);
+    const codec = compression === COMPRESSION_LZ4 ? "lz4" : "raw";
+    console.log(`${name}\t${codec}\t${size}\t${storedSize}\t@${dataOffset}`);
+  }
+}
+
+function main() {
+  const args = parseArgs(process.argv);
+  if (args.list) {
+    listPack(path.resolve(String(args.list)));
+    return;
+  }
+
+  const inputRoot = path.resolve(String(args["input-root"] || ""));
+  const outputPath = path.resolve(String(args.output || ""));
+  if (!args["input-root"] || !args.output) throw new Error("--input-root and --output are required");
+  if (!fs.existsSync(inputRoot) || !fs.statSync(inputRoot).isDirectory()) throw new Error(`input root not found: ${normalizeSlash(inputRoot)}`);
+  if (path.extname(outputPath).toLowerCase() !== ".rs3pak") throw new Error("--output must end in .rs3pak (only those are mounted)");
+
+  const includes = args.include ? String(args.include).split(",").map((s) => s.trim()).filter(Boolean) : ["scenes", "models"];
+  const alignment = Number(args.align || 64);
+  if (!Number.isInteger(alignment) || alignment < 8 || (alignment & (alignment - 1)) !== 0) throw new Error("--align must be a power of two >= 8");
+  const compressMode = String(args.compress || "auto");
+  if (!["none", "lz4", "auto"].includes(compressMode)) throw new Error("--compress must be none, lz4 or auto");
+
+  const files = collectFiles(inputRoot, includes);
+  if (files.length === 0) throw new Error("nothing to pack");
+
+  const pack = buildPack(files, alignment, compressMode);
+  fs.mkdirSync(path.dirname(outputPath), { recursive: true });
+  fs.writeFileSync(outputPath, pack.buffer);
+
+  const compressed = pack.entries.filter((e) => e.compression === COMPRESSION_LZ4).length;
+  console.log(`[rs3_asset_packer] entries=${pack.entries.length} lz4=${compressed} raw_bytes=${pack.rawBytes} pack_bytes=${pack.buffer.length}`);
+  console.log(`[rs3_asset_packer] output=${normalizeSlash(outputPath)}`);
+}
+
+function printUsage() {
+  console.log("Usage: node rs3_asset_packer.js --input-root <.../system/rs3> --output <.../system/rs3/assets.rs3pak> [--include scenes,models] [--compress auto|lz4|none] [--align 64]");
+  console.log("       node rs3_asset_packer.js --list <pack.rs3pak>");
+}
+
+if (process.argv.includes("--help") || process.argv.includes("-h")) {
+  printUsage();
+  process.exit(0);
+}
+
+try {
+  main();
+} catch (err) {
+  console.error(`[rs3_asset_packer] fatal: ${err && err.message ? err.message : err}`);
+  process.exit(1);
+}
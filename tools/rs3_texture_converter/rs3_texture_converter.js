@@ -1,7 +1,8 @@
 #!/usr/bin/env node
 /*
   rs3_texture_converter.js
-  Converts textures used by an rs3_scene_v1 package to PNG (package-local).
+  Converts textures used by an rs3_scene_v1 package to BC-compressed DDS with
+  a full mip chain (default) or to single-level PNG (package-local).
 */
 
 const fs = require("fs");
@@ -520,6 +521,427 @@ function decodeDDS(fileBuffer) {
   throw new Error(`Unsupported DDS format (flags=0x${ddpfFlags.toString(16)}, bits=${ddpfRgbBits})`);
 }
 
+// ---------------------------------------------------------------------------
+// Mip chain generation (gamma-correct) and BC1/BC3 encoding
+// ---------------------------------------------------------------------------
+
+const SRGB_TO_LINEAR = (() => {
+  const table = new Float32Array(256);
+  for (let i = 0; i < 256; i++) {
+    const c = i / 255;
+    table[i] = c <= 0.04045 ? c / 12.92 : Math.pow((c + 0.055) / 1.055, 2.4);
+  }
+  return table;
+})();
+
+function linearToSrgbByte(v) {
+  if (!(v > 0)) return 0;
+  if (v >= 1) return 255;
+  const c = v <= 0.0031308 ? v * 12.92 : 1.055 * Math.pow(v, 1 / 2.4) - 0.055;
+  return Math.round(c * 255);
+}
+
+function besselI0(x) {
+  let sum = 1;
+  let term = 1;
+  const halfX = x / 2;
+  for (let k = 1; k < 32; k++) {
+    term *= (halfX / k) * (halfX / k);
+    sum += term;
+    if (term < sum * 1e-10) break;
+  }
+  return sum;
+}
+
+// Weights for a 2:1 decimation, indexed by source offset k relative to 2*x (k = -2..3).
+function buildDownsampleKernel(filter) {
+  if (filter === "box") {
+    return { first: 0, weights: [0.5, 0.5] };
+  }
+  // Kaiser-windowed sinc, 3 destination texels wide, alpha = 4.
+  const alpha = 4;
+  const halfWidth = 1.5;
+  const weights = [];
+  let sum = 0;
+  for (let k = -2; k <= 3; k++) {
+    const t = (k + 0.5 - 1) / 2; // distance from destination centre in destination texels
+    const x = Math.PI * t;
+    const sinc = t === 0 ? 1 : Math.sin(x) / x;
+    const r = t / halfWidth;
+    const window = Math.abs(r) >= 1 ? 0 : besselI0(alpha * Math.sqrt(1 - r * r)) / besselI0(alpha);
+    const w = sinc * window;
+    weights.push(w);
+    sum += w;
+  }
+  return { first: -2, weights: weights.map((w) => w / sum) };
+}
+
+// Separable 2:1 downsample of a float RGBA image, clamping at the edges.
+function downsampleLinear(src, width, height, kernel) {
+  const dstWidth = Math.max(1, width >> 1);
+  const dstHeight = Math.max(1, height >> 1);
+  const horizontal = new Float32Array(dstWidth * height * 4);
+
+  for (let y = 0; y < height; y++) {
+    for (let x = 0; x < dstWidth; x++) {
+      let r = 0, g = 0, b = 0, a = 0;
+      for (let t = 0; t < kernel.weights.length; t++) {
+        const sx = Math.min(width - 1, Math.max(0, 2 * x + kernel.first + t));
+        const w = kernel.weights[t];
+        const s = (y * width + sx) * 4;
+        r += src[s] * w; g += src[s + 1] * w; b += src[s + 2] * w; a += src[s + 3] * w;
+      }
+      const d = (y * dstWidth + x) * 4;
+      horizontal[d] = r; horizontal[d + 1] = g; horizontal[d + 2] = b; horizontal[d + 3] = a;
+    }
+  }
+
+  const out = new Float32Array(dstWidth * dstHeight * 4);
+  for (let y = 0; y < dstHeight; y++) {
+    for (let x = 0; x < dstWidth; x++) {
+      let r = 0, g = 0, b = 0, a = 0;
+      for (let t = 0; t < kernel.weights.length; t++) {
+        const sy = Math.min(height - 1, Math.max(0, 2 * y + kernel.first + t));
+        const w = kernel.weights[t];
+        const s = (sy * dstWidth + x) * 4;
+        r += horizontal[s] * w; g += horizontal[s + 1] * w; b += horizontal[s + 2] * w; a += horizontal[s + 3] * w;
+      }
+      const d = (y * dstWidth + x) * 4;
+      out[d] = r; out[d + 1] = g; out[d + 2] = b; out[d + 3] = a;
+    }
+  }
+  return { width: dstWidth, height: dstHeight, data: out };
+}
+
+function generateMipChain(width, height, rgba, filter) {
+  const kernel = buildDownsampleKernel(filter);
+  const levels = [{ width, height, rgba }];
+
+  // Premultiplied linear float so transparent texels do not bleed their colour.
+  let current = new Float32Array(width * height * 4);
+  for (let i = 0; i < width * height; i++) {
+    const a = rgba[i * 4 + 3] / 255;
+    current[i * 4 + 0] = SRGB_TO_LINEAR[rgba[i * 4 + 0]] * a;
+    current[i * 4 + 1] = SRGB_TO_LINEAR[rgba[i * 4 + 1]] * a;
+    current[i * 4 + 2] = SRGB_TO_LINEAR[rgba[i * 4 + 2]] * a;
+    current[i * 4 + 3] = a;
+  }
+
+  let w = width;
+  let h = height;
+  while (w > 1 || h > 1) {
+    const next = downsampleLinear(current, w, h, kernel);
+    const out = Buffer.alloc(next.width * next.height * 4);
+    for (let i = 0; i < next.width * next.height; i++) {
+      const a = Math.min(1, Math.max(0, next.data[i * 4 + 3]));
+      const inv = a > 0 ? 1 / a : 0;
+      out[i * 4 + 0] = linearToSrgbByte(next.data[i * 4 + 0] * inv);
+      out[i * 4 + 1] = linearToSrgbByte(next.data[i * 4 + 1] * inv);
+      out[i * 4 + 2] = linearToSrgbByte(next.data[i * 4 + 2] * inv);
+      out[i * 4 + 3] = Math.round(a * 255);
+    }
+    levels.push({ width: next.width, height: next.height, rgba: out });
+    current = next.data;
+    w = next.width;
+    h = next.height;
+  }
+  return levels;
+}
+
+function rgbTo565(r, g, b) {
+  return ((Math.round((r * 31) / 255) << 11) | (Math.round((g * 63) / 255) << 5) | Math.round((b * 31) / 255)) & 0xffff;
+}
+
+// Fits endpoints along the principal axis of the block colours, then picks the nearest palette entry per texel.
+function encodeBC1ColorBlock(pixels, out, offset, allowTransparent) {
+  let hasTransparent = false;
+  const opaque = [];
+  for (let i = 0; i < 16; i++) {
+    if (allowTransparent && pixels[i][3] < 128) {
+      hasTransparent = true;
+    } else {
+      opaque.push(pixels[i]);
+    }
+  }
+
+  let c0 = 0;
+  let c1 = 0;
+  if (opaque.length > 0) {
+    const mean = [0, 0, 0];
+    for (const p of opaque) { mean[0] += p[0]; mean[1] += p[1]; mean[2] += p[2]; }
+    mean[0] /= opaque.length; mean[1] /= opaque.length; mean[2] /= opaque.length;
+
+    const cov = [0, 0, 0, 0, 0, 0];
+    for (const p of opaque) {
+      const r = p[0] - mean[0], g = p[1] - mean[1], b = p[2] - mean[2];
+      cov[0] += r * r; cov[1] += r * g; cov[2] += r * b; cov[3] += g * g; cov[4] += g * b; cov[5] += b * b;
+    }
+    let axis = [1, 1, 1];
+    for (let iter = 0; iter < 6; iter++) {
+      const nx = cov[0] * axis[0] + cov[1] * axis[1] + cov[2] * axis[2];
+      const ny = cov[1] * axis[0] + cov[3] * axis[1] + cov[4] * axis[2];
+      const nz = cov[2] * axis[0] + cov[4] * axis[1] + cov[5] * axis[2];
+      const len = Math.hypot(nx, ny, nz);
+      if (len < 1e-6) break;
+      axis = [nx / len, ny / len, nz / len];
+    }
+
+    let minT = Infinity, maxT = -Infinity;
+    for (const p of opaque) {
+      const t = (p[0] - mean[0]) * axis[0] + (p[1] - mean[1]) * axis[1] + (p[2] - mean[2]) * axis[2];
+      if (t < minT) minT = t;
+      if (t > maxT) maxT = t;
+    }
+    // Inset by 1/16 of the range to reduce quantisation error at the extremes.
+    const inset = (maxT - minT) / 16;
+    minT += inset;
+    maxT -= inset;
+    const clamp = (v) => Math.min(255, Math.max(0, v));
+    const hi = [clamp(mean[0] + axis[0] * maxT), clamp(mean[1] + axis[1] * maxT), clamp(mean[2] + axis[2] * maxT)];
+    const lo = [clamp(mean[0] + axis[0] * minT), clamp(mean[1] + axis[1] * minT), clamp(mean[2] + axis[2] * minT)];
+    c0 = rgbTo565(hi[0], hi[1], hi[2]);
+    c1 = rgbTo565(lo[0], lo[1], lo[2]);
+  }
+
+  // 4-colour mode needs c0 > c1, 3-colour + transparent needs c0 <= c1.
+  if (hasTransparent ? c0 > c1 : c0 < c1) {
+    const t = c0; c0 = c1; c1 = t;
+  }
+
+  const rgb0 = color565ToRgb(c0);
+  const rgb1 = color565ToRgb(c1);
+  let palette;
+  if (!hasTransparent && c0 > c1) {
+    palette = [
+      rgb0, rgb1,
+      [Math.round((2 * rgb0[0] + rgb1[0]) / 3), Math.round((2 * rgb0[1] + rgb1[1]) / 3), Math.round((2 * rgb0[2] + rgb1[2]) / 3)],
+      [Math.round((rgb0[0] + 2 * rgb1[0]) / 3), Math.round((rgb0[1] + 2 * rgb1[1]) / 3), Math.round((rgb0[2] + 2 * rgb1[2]) / 3)]
+    ];
+  } else {
+    palette = [
+      rgb0, rgb1,
+      [Math.round((rgb0[0] + rgb1[0]) / 2), Math.round((rgb0[1] + rgb1[1]) / 2), Math.round((rgb0[2] + rgb1[2]) / 2)]
+    ];
+  }
+
+  let indices = 0;
+  for (let i = 0; i < 16; i++) {
+    let best = 0;
+    if (hasTransparent && pixels[i][3] < 128) {
+      best = 3;
+    } else {
+      let bestDist = Infinity;
+      for (let k = 0; k < palette.length; k++) {
+        const dr = pixels[i][0] - palette[k][0], dg = pixels[i][1] - palette[k][1], db = pixels[i][2] - palette[k][2];
+        const d = dr * dr + dg * dg + db * db;
+        if (d < bestDist) { bestDist = d; best = k; }
+      }
+    }
+    indices |= best << (2 * i);
+  }
+
+  out.writeUInt16LE(c0, offset);
+  out.writeUInt16LE(c1, offset + 2);
+  out.writeUInt32LE(indices >>> 0, offset + 4);
+}
+
+function encodeBC3AlphaBlock(pixels, out, offset) {
+  let minA = 255, maxA = 0;
+  for (let i = 0; i < 16; i++) {
+    minA = Math.min(minA, pixels[i][3]);
+    maxA = Math.max(maxA, pixels[i][3]);
+  }
+  out[offset] = maxA;
+  out[offset + 1] = minA;
+  const palette = buildAlphaPaletteBC3(maxA, minA);
+
+  let bits = 0n;
+  for (let i = 0; i < 16; i++) {
+    let best = 0;
+    let bestDist = Infinity;
+    for (let k = 0; k < 8; k++) {
+      const d = Math.abs(pixels[i][3] - palette[k]);
+      if (d < bestDist) { bestDist = d; best = k; }
+    }
+    bits |= BigInt(best) << BigInt(3 * i);
+  }
+  for (let i = 0; i < 6; i++) {
+    out[offset + 2 + i] = Number((bits >> BigInt(8 * i)) & 0xffn);
+  }
+}
+
+function encodeBC(width, height, rgba, format) {
+  const blockWidth = Math.max(1, Math.ceil(width / 4));
+  const blockHeight = Math.max(1, Math.ceil(height / 4));
+  const blockBytes = format === "BC1" ? 8 : 16;
+  const out = Buffer.alloc(blockWidth * blockHeight * blockBytes);
+
+  let off = 0;
+  const pixels = new Array(16);
+  for (let by = 0; by < blockHeight; by++) {
+    for (let bx = 0; bx < blockWidth; bx++) {
+      for (let i = 0; i < 16; i++) {
+        // Edge blocks repeat the last row/column.
+        const x = Math.min(width - 1, bx * 4 + (i & 3));
+        const y = Math.min(height - 1, by * 4 + (i >> 2));
+        const s = (y * width + x) * 4;
+        pixels[i] = [rgba[s], rgba[s + 1], rgba[s + 2], rgba[s + 3]];
+      }
+      if (format === "BC1") {
+        encodeBC1ColorBlock(pixels, out, off, true);
+      } else {
+        encodeBC3AlphaBlock(pixels, out, off);
+        encodeBC1ColorBlock(pixels, out, off + 8, false);
+      }
+      off += blockBytes;
+    }
+  }
+  return out;
+}
+
+const DXGI_FORMAT_BC1_UNORM = 71;
+const DXGI_FORMAT_BC3_UNORM = 77;
+const D3D10_RESOURCE_DIMENSION_TEXTURE2D = 3;
+// D3D11 allows 2048 slices; smaller arrays keep residency eviction granular.
+const MAX_ARRAY_SLICES = 64;
+
+// Legacy DXT1/DXT5 header for one texture, DX10 header when arraySize > 1.
+function buildDDSHeader(width, height, mipLevels, format, topLevelBytes, arraySize) {
+  const DDSD_CAPS = 0x1, DDSD_HEIGHT = 0x2, DDSD_WIDTH = 0x4, DDSD_PIXELFORMAT = 0x1000;
+  const DDSD_MIPMAPCOUNT = 0x20000, DDSD_LINEARSIZE = 0x80000;
+  const DDSCAPS_COMPLEX = 0x8, DDSCAPS_TEXTURE = 0x1000, DDSCAPS_MIPMAP = 0x400000;
+
+  const useDX10 = arraySize > 1;
+  const header = Buffer.alloc(useDX10 ? 148 : 128, 0);
+  header.writeUInt32LE(DDS_MAGIC, 0);
+  header.writeUInt32LE(124, 4);
+  header.writeUInt32LE(DDSD_CAPS | DDSD_HEIGHT | DDSD_WIDTH | DDSD_PIXELFORMAT | DDSD_MIPMAPCOUNT | DDSD_LINEARSIZE, 8);
+  header.writeUInt32LE(height, 12);
+  header.writeUInt32LE(width, 16);
+  header.writeUInt32LE(topLevelBytes, 20);
+  header.writeUInt32LE(mipLevels, 28);
+  header.writeUInt32LE(32, 76);
+  header.writeUInt32LE(DDPF_FOURCC, 80);
+  header.writeUInt32LE(useDX10 ? FOURCC_DX10 : (format === "BC1" ? FOURCC_DXT1 : FOURCC_DXT5), 84);
+  header.writeUInt32LE(DDSCAPS_TEXTURE | (mipLevels > 1 || useDX10 ? DDSCAPS_COMPLEX : 0) | (mipLevels > 1 ? DDSCAPS_MIPMAP : 0), 108);
+  if (useDX10) {
+    header.writeUInt32LE(format === "BC1" ? DXGI_FORMAT_BC1_UNORM : DXGI_FORMAT_BC3_UNORM, 128);
+    header.writeUInt32LE(D3D10_RESOURCE_DIMENSION_TEXTURE2D, 132);
+    header.writeUInt32LE(0, 136); // miscFlag
+    header.writeUInt32LE(arraySize, 140);
+    header.writeUInt32LE(0, 144); // miscFlags2
+  }
+  return header;
+}
+
+// Groups textures that can share one Texture2DArray: identical format, size and mip count.
+// entries: [{ key, format, width, height, mipLevels }]; returns arrays of >= 2 slices
+// ({ format, width, height, mipLevels, keys }) and the keys left as single textures.
+function planTextureArrays(entries, maxSlices) {
+  const classes = new Map();
+  for (const e of entries) {
+    if (e.format !== "BC1" && e.format !== "BC3") continue;
+    const classKey = `${e.format}_${e.width}x${e.height}_${e.mipLevels}`;
+    if (!classes.has(classKey)) classes.set(classKey, []);
+    classes.get(classKey).push(e);
+  }
+
+  const arrays = [];
+  const packed = new Set();
+  const classKeys = [...classes.keys()].sort();
+  for (const classKey of classKeys) {
+    const members = classes.get(classKey);
+    for (let i = 0; i < members.length; i += maxSlices) {
+      const chunk = members.slice(i, i + maxSlices);
+      if (chunk.length < 2) break;
+      const first = chunk[0];
+      arrays.push({ format: first.format, width: first.width, height: first.height, mipLevels: first.mipLevels, keys: chunk.map((e) => e.key) });
+      for (const e of chunk) packed.add(e.key);
+    }
+  }
+  const singles = entries.filter((e) => !packed.has(e.key)).map((e) => e.key);
+  return { arrays, singles };
+}
+
+// Slices are stored slice-major, each with its full mip chain (D3D subresource order).
+function writeDDSArrayBC(filePath, slices, format) {
+  const first = slices[0];
+  const header = buildDDSHeader(first.width, first.height, first.surfaces.length, format, first.surfaces[0].length, slices.length);
+  const parts = [header];
+  for (const slice of slices) parts.push(...slice.surfaces);
+  const dds = Buffer.concat(parts);
+  fs.writeFileSync(filePath, dds);
+  return dds;
+}
+
+// Decodes the 8-bit RGB/RGBA non-interlaced PNGs written by WIC in decodeImageViaWic.
+function decodePngRGBA(buffer) {
+  const signature = Buffer.from([137, 80, 78, 71, 13, 10, 26, 10]);
+  if (buffer.length < 8 || !buffer.slice(0, 8).equals(signature)) {
+    throw new Error("Not a PNG file");
+  }
+
+  let off = 8;
+  let width = 0, height = 0, bitDepth = 0, colorType = 0, interlace = 0;
+  const idat = [];
+  while (off + 8 <= buffer.length) {
+    const length = buffer.readUInt32BE(off);
+    const type = buffer.toString("ascii", off + 4, off + 8);
+    const data = buffer.slice(off + 8, off + 8 + length);
+    off += 12 + length;
+    if (type === "IHDR") {
+      width = data.readUInt32BE(0);
+      height = data.readUInt32BE(4);
+      bitDepth = data[8];
+      colorType = data[9];
+      interlace = data[12];
+    } else if (type === "IDAT") {
+      idat.push(data);
+    } else if (type === "IEND") {
+      break;
+    }
+  }
+
+  if (bitDepth !== 8 || (colorType !== 6 && colorType !== 2) || interlace !== 0) {
+    throw new Error(`Unsupported PNG layout (depth=${bitDepth}, colorType=${colorType}, interlace=${interlace})`);
+  }
+
+  const bpp = colorType === 6 ? 4 : 3;
+  const stride = width * bpp;
+  const raw = zlib.inflateSync(Buffer.concat(idat));
+  const pixels = Buffer.alloc(stride * height);
+  for (let y = 0; y < height; y++) {
+    const filter = raw[y * (stride + 1)];
+    const src = y * (stride + 1) + 1;
+    const dst = y * stride;
+    for (let x = 0; x < stride; x++) {
+      const left = x >= bpp ? pixels[dst + x - bpp] : 0;
+      const up = y > 0 ? pixels[dst - stride + x] : 0;
+      const upLeft = (y > 0 && x >= bpp) ? pixels[dst - stride + x - bpp] : 0;
+      let pred = 0;
+      if (filter === 1) pred = left;
+      else if (filter === 2) pred = up;
+      else if (filter === 3) pred = (left + up) >> 1;
+      else if (filter === 4) {
+        const p = left + up - upLeft;
+        const pa = Math.abs(p - left), pb = Math.abs(p - up), pc = Math.abs(p - upLeft);
+        pred = (pa <= pb && pa <= pc) ? left : (pb <= pc ? up : upLeft);
+      }
+      pixels[dst + x] = (raw[src + x] + pred) & 0xff;
+    }
+  }
+
+  if (bpp === 4) return { width, height, rgba: pixels };
+  const rgba = Buffer.alloc(width * height * 4);
+  for (let i = 0; i < width * height; i++) {
+    rgba[i * 4 + 0] = pixels[i * 3 + 0];
+    rgba[i * 4 + 1] = pixels[i * 3 + 1];
+    rgba[i * 4 + 2] = pixels[i * 3 + 2];
+    rgba[i * 4 + 3] = 255;
+  }
+  return { width, height, rgba };
+}
+
 const CRC_TABLE = (() => {
   const table = new Uint32Array(256);
   for (let n = 0; n < 256; n++) {
@@ -610,6 +1032,79 @@ function convertToPngViaWic(inputPath, outputPath) {
   }
 }
 
+function decodeImageViaWic(inputPath, tempPngPath) {
+  const script = [
+    "$ErrorActionPreference = 'Stop'",
+    "Add-Type -AssemblyName PresentationCore",
+    "$inPath = [System.IO.Path]::GetFullPath($args[0])",
+    "$outPath = [System.IO.Path]::GetFullPath($args[1])",
+    "$uri = New-Object System.Uri($inPath)",
+    "$decoder = [System.Windows.Media.Imaging.BitmapDecoder]::Create($uri, [System.Windows.Media.Imaging.BitmapCreateOptions]::PreservePixelFormat, [System.Windows.Media.Imaging.BitmapCacheOption]::OnLoad)",
+    "$frame = New-Object System.Windows.Media.Imaging.FormatConvertedBitmap($decoder.Frames[0], [System.Windows.Media.PixelFormats]::Bgra32, $null, 0)",
+    "$encoder = New-Object System.Windows.Media.Imaging.PngBitmapEncoder",
+    "$encoder.Interlace = [System.Windows.Media.Imaging.PngInterlaceOption]::Off",
+    "$encoder.Frames.Add([System.Windows.Media.Imaging.BitmapFrame]::Create($frame))",
+    "$stream = [System.IO.File]::Open($outPath, [System.IO.FileMode]::Create, [System.IO.FileAccess]::Write, [System.IO.FileShare]::None)",
+    "$encoder.Save($stream)",
+    "$stream.Dispose()"
+  ].join("; ");
+
+  const result = childProcess.spawnSync("powershell", ["-NoProfile", "-Command", script, inputPath, tempPngPath], {
+    encoding: "utf8"
+  });
+
+  if (result.status !== 0) {
+    const detail = `${result.stderr || ""}${result.stdout || ""}`.trim();
+    throw new Error(`WIC decode failed for '${inputPath}': ${detail}`);
+  }
+
+  try {
+    return decodePngRGBA(fs.readFileSync(tempPngPath));
+  } finally {
+    fs.rmSync(tempPngPath, { force: true });
+  }
+}
+
+function decodeImageRGBA(inputPath, tempPngPath) {
+  const src = fs.readFileSync(inputPath);
+  const isDDS = (path.extname(inputPath).toLowerCase() === ".dds") || (src.length >= 4 && src.readUInt32LE(0) === DDS_MAGIC);
+  if (isDDS) return decodeDDS(src);
+  if (src.length >= 8 && src.readUInt32BE(0) === 0x89504e47) {
+    try {
+      return decodePngRGBA(src);
+    } catch {
+      // palette/16-bit/interlaced PNGs go through WIC
+    }
+  }
+  return decodeImageViaWic(inputPath, tempPngPath);
+}
+
+// Opaque textures become BC1 (DXT1), anything with alpha BC3 (DXT5). Mips are filtered in
+// linear light and stored sRGB-encoded, like the source texels.
+function encodeImageToBC(inputPath, tempBasePath, mipFilter) {
+  const decoded = decodeImageRGBA(inputPath, `${tempBasePath}.tmp.png`);
+  let opaque = true;
+  for (let i = 3; i < decoded.rgba.length; i += 4) {
+    if (decoded.rgba[i] !== 255) {
+      opaque = false;
+      break;
+    }
+  }
+
+  const levels = generateMipChain(decoded.width, decoded.height, decoded.rgba, mipFilter);
+  const format = opaque ? "BC1" : "BC3";
+  const surfaces = levels.map((level) => encodeBC(level.width, level.height, level.rgba, format));
+  return { width: decoded.width, height: decoded.height, mipLevels: levels.length, format, surfaces };
+}
+
+function convertImageToDds(inputPath, outputPath, mipFilter) {
+  const encoded = encodeImageToBC(inputPath, outputPath, mipFilter);
+  const header = buildDDSHeader(encoded.width, encoded.height, encoded.mipLevels, encoded.format, encoded.surfaces[0].length, 1);
+  const bytes = Buffer.concat([header, ...encoded.surfaces]);
+  fs.writeFileSync(outputPath, bytes);
+  return { bytes, width: encoded.width, height: encoded.height, mipLevels: encoded.mipLevels, format: encoded.format };
+}
+
 function convertImageToPng(inputPath, outputPath) {
   const src = fs.readFileSync(inputPath);
   const isDDS = (path.extname(inputPath).toLowerCase() === ".dds") || (src.length >= 4 && src.readUInt32LE(0) === DDS_MAGIC);
@@ -665,6 +1160,24 @@ function buildBasenameIndex(rootDir) {
   return index;
 }
 
+const TEXTURE_INDEX_FILE = "texture_index_v1.txt";
+const TEXTURE_INDEX_HEADER = "rs3_texture_index_v1";
+
+// File list the runtime TextureManager loads instead of walking the package directory.
+function writePackageTextureIndex(sceneDir) {
+  const files = [];
+  for (const fullPaths of buildBasenameIndex(sceneDir).values()) {
+    for (const full of fullPaths) {
+      const rel = normalizeSlash(path.relative(sceneDir, full));
+      if (rel !== TEXTURE_INDEX_FILE) files.push(rel);
+    }
+  }
+  files.sort();
+  const indexPath = path.join(sceneDir, TEXTURE_INDEX_FILE);
+  fs.writeFileSync(indexPath, `${[TEXTURE_INDEX_HEADER, ...files].join("\n")}\n`, "utf8");
+  return { indexPath, fileCount: files.length };
+}
+
 function chooseExistingFile(candidates) {
   for (const c of candidates) {
     if (!c) continue;
@@ -787,7 +1300,8 @@ function generateReport(reportMeta) {
   lines.push("## Counts");
   lines.push(`- materialCount(world): ${reportMeta.materialCount}`);
   lines.push(`- usedMaterialCount: ${reportMeta.usedMaterialCount}`);
-  lines.push(`- convertedPngCount: ${reportMeta.convertedCount}`);
+  lines.push(`- outputFormat: ${reportMeta.outputFormat}`);
+  lines.push(`- convertedCount: ${reportMeta.convertedCount}`);
   lines.push(`- missingUsedTextures: ${reportMeta.missingCount}`);
   lines.push("");
   lines.push("## Hashes");
@@ -797,7 +1311,13 @@ function generateReport(reportMeta) {
   lines.push("");
   lines.push("## Notes");
   lines.push("- Converted only materials referenced by world.bin sections.");
-  lines.push("- world.bin diffuseMap updated to package-local textures/*.png for converted materials.");
+  lines.push(`- world.bin diffuseMap updated to package-local textures/*.${reportMeta.outputFormat} for converted materials.`);
+  if (reportMeta.outputFormat === "dds") {
+    lines.push(`- DDS: BC1 (opaque) / BC3 (alpha), full mip chain, ${reportMeta.mipFilter} filter in linear light.`);
+  }
+  if (reportMeta.textureArrayCount > 0) {
+    lines.push(`- Texture arrays: ${reportMeta.packedTextureCount} textures packed into ${reportMeta.textureArrayCount} arrays (diffuseMap 'textures/array_*.dds#<slice>').`);
+  }
   if (reportMeta.missing.length > 0) {
     lines.push("");
     lines.push("## Missing (hard-fail)");
@@ -815,8 +1335,21 @@ function main() {
   const sourceMapDir = args["source-map-dir"] ? path.resolve(args["source-map-dir"]) : "";
   const sceneId = args["scene-id"] ? String(args["scene-id"]).trim() : "";
 
+  const outputFormat = args.format ? String(args.format).toLowerCase() : "dds";
+  const mipFilter = args["mip-filter"] ? String(args["mip-filter"]).toLowerCase() : "kaiser";
+  const packArrays = Boolean(args["pack-arrays"]);
+
   if (!sceneDir || !sourceMapDir || !sceneId) {
-    throw new Error("Usage: node rs3_texture_converter.js --scene-dir <dir> --source-map-dir <dir> --scene-id <id>");
+    throw new Error("Usage: node rs3_texture_converter.js --scene-dir <dir> --source-map-dir <dir> --scene-id <id> [--format dds|png] [--mip-filter kaiser|box] [--pack-arrays]");
+  }
+  if (outputFormat !== "dds" && outputFormat !== "png") {
+    throw new Error(`Unsupported --format '${outputFormat}' (expected dds or png)`);
+  }
+  if (mipFilter !== "kaiser" && mipFilter !== "box") {
+    throw new Error(`Unsupported --mip-filter '${mipFilter}' (expected kaiser or box)`);
+  }
+  if (packArrays && outputFormat !== "dds") {
+    throw new Error("--pack-arrays requires --format dds");
   }
 
   const sceneJsonPath = path.join(sceneDir, "scene.json");
@@ -852,6 +1385,19 @@ function main() {
 
   const converted = [];
   const missing = [];
+  const pending = [];
+  const textureArrays = [];
+
+  const assignPackageTexture = (entry, sceneMat, relPkgPath) => {
+    const worldMat = parsedWorld.materials[entry.materialIndex];
+    worldMat.diffuseMap = relPkgPath;
+    entry.packageTexture = relPkgPath;
+    if (sceneMat) {
+      sceneMat.flags = Number(worldMat.flags || 0);
+      sceneMat.sourceDiffuseMap = entry.sourceDiffuseMap;
+      sceneMat.packageTexture = relPkgPath;
+    }
+  };
 
   for (const materialIndex of usedMaterialIndices) {
     if (materialIndex < 0 || materialIndex >= parsedWorld.materials.length) {
@@ -871,32 +1417,89 @@ function main() {
     }
 
     const materialName = sceneMat && sceneMat.name ? sceneMat.name : path.basename(sourceDiffuseMap || `material_${materialIndex}`);
-    const pngName = `mat_${materialIndex}_${slugify(materialName)}.png`;
-    const outPath = path.join(texturesDir, pngName);
-
-    const pngBytes = convertImageToPng(resolvedSource, outPath);
-    const relPkgPath = normalizeSlash(path.join("textures", pngName));
-
-    parsedWorld.materials[materialIndex].diffuseMap = relPkgPath;
-
-    if (sceneMat) {
-      sceneMat.flags = Number(worldMat.flags || 0);
-      sceneMat.sourceDiffuseMap = sourceDiffuseMap;
-      sceneMat.packageTexture = relPkgPath;
-    }
+    const outName = `mat_${materialIndex}_${slugify(materialName)}.${outputFormat}`;
+    const outPath = path.join(texturesDir, outName);
 
-    converted.push({
+    const entry = {
       materialIndex,
       name: sceneMat && sceneMat.name ? sceneMat.name : `material_${materialIndex}`,
       flags: Number(worldMat.flags || 0),
       sourceDiffuseMap,
-      resolvedSource: normalizeSlash(resolvedSource),
-      packageTexture: relPkgPath,
-      width: undefined,
-      height: undefined,
-      bytes: pngBytes.length,
-      sha256: toSha256(pngBytes)
+      resolvedSource: normalizeSlash(resolvedSource)
+    };
+
+    if (packArrays) {
+      // Written after every texture is encoded, once the array layout is known.
+      pending.push({ entry, sceneMat, outName, encoded: encodeImageToBC(resolvedSource, outPath, mipFilter) });
+      continue;
+    }
+
+    let outInfo;
+    if (outputFormat === "dds") {
+      outInfo = convertImageToDds(resolvedSource, outPath, mipFilter);
+    } else {
+      outInfo = { bytes: convertImageToPng(resolvedSource, outPath), width: undefined, height: undefined, mipLevels: 1, format: "RGBA8" };
+    }
+    const relPkgPath = normalizeSlash(path.join("textures", outName));
+    assignPackageTexture(entry, sceneMat, relPkgPath);
+    converted.push(Object.assign(entry, {
+      width: outInfo.width,
+      height: outInfo.height,
+      format: outInfo.format,
+      mipLevels: outInfo.mipLevels,
+      bytes: outInfo.bytes.length,
+      sha256: toSha256(outInfo.bytes)
+    }));
+  }
+
+  if (packArrays && missing.length === 0) {
+    const byKey = new Map(pending.map((p) => [p.entry.materialIndex, p]));
+    const plan = planTextureArrays(pending.map((p) => ({
+      key: p.entry.materialIndex,
+      format: p.encoded.format,
+      width: p.encoded.width,
+      height: p.encoded.height,
+      mipLevels: p.encoded.mipLevels
+    })), MAX_ARRAY_SLICES);
+
+    plan.arrays.forEach((group, arrayIndex) => {
+      const outName = `array_${arrayIndex}_${group.format.toLowerCase()}_${group.width}x${group.height}.dds`;
+      const members = group.keys.map((key) => byKey.get(key));
+      const bytes = writeDDSArrayBC(path.join(texturesDir, outName), members.map((p) => p.encoded), group.format);
+      const relPkgPath = normalizeSlash(path.join("textures", outName));
+      textureArrays.push({ packageTexture: relPkgPath, format: group.format, width: group.width, height: group.height, mipLevels: group.mipLevels, slices: group.keys.length, bytes: bytes.length, sha256: toSha256(bytes) });
+
+      members.forEach((p, slice) => {
+        // "#<slice>" selects the array slice; the runtime batches every section that shares the array.
+        assignPackageTexture(p.entry, p.sceneMat, `${relPkgPath}#${slice}`);
+        converted.push(Object.assign(p.entry, {
+          width: p.encoded.width,
+          height: p.encoded.height,
+          format: p.encoded.format,
+          mipLevels: p.encoded.mipLevels,
+          arrayTexture: relPkgPath,
+          arraySlice: slice
+        }));
+      });
     });
+
+    for (const key of plan.singles) {
+      const p = byKey.get(key);
+      const e = p.encoded;
+      const header = buildDDSHeader(e.width, e.height, e.mipLevels, e.format, e.surfaces[0].length, 1);
+      const bytes = Buffer.concat([header, ...e.surfaces]);
+      fs.writeFileSync(path.join(texturesDir, p.outName), bytes);
+      assignPackageTexture(p.entry, p.sceneMat, normalizeSlash(path.join("textures", p.outName)));
+      converted.push(Object.assign(p.entry, {
+        width: e.width,
+        height: e.height,
+        format: e.format,
+        mipLevels: e.mipLevels,
+        bytes: bytes.length,
+        sha256: toSha256(bytes)
+      }));
+    }
+    converted.sort((x, y) => x.materialIndex - y.materialIndex);
   }
 
   if (missing.length > 0) {
@@ -921,6 +1524,7 @@ function main() {
     usedMaterialIndices,
     entries: converted
   };
+  if (packArrays) manifest.textureArrays = textureArrays;
   writeJson(manifestPath, manifest);
 
   const sceneJsonBytes = fs.readFileSync(sceneJsonPath);
@@ -933,7 +1537,11 @@ function main() {
     generatedAtUtc: manifest.generatedAtUtc,
     materialCount: parsedWorld.materials.length,
     usedMaterialCount: usedMaterialIndices.length,
+    outputFormat,
+    mipFilter,
     convertedCount: converted.length,
+    textureArrayCount: textureArrays.length,
+    packedTextureCount: textureArrays.reduce((sum, a) => sum + a.slices, 0),
     missingCount: 0,
     missing: [],
     worldBinSha256: toSha256(worldOut),
@@ -942,11 +1550,15 @@ function main() {
   });
   fs.writeFileSync(reportPath, `${report}\n`, "utf8");
 
-  console.log(`Converted ${converted.length} textures to PNG for scene '${sceneId}'.`);
+  // Written last so it lists the report and manifest too.
+  const textureIndex = writePackageTextureIndex(sceneDir);
+
+  console.log(`Converted ${converted.length} textures to ${outputFormat.toUpperCase()} for scene '${sceneId}'.`);
   console.log(`- world.bin updated: ${worldBinPath}`);
   console.log(`- scene.json updated: ${sceneJsonPath}`);
   console.log(`- manifest: ${manifestPath}`);
   console.log(`- report: ${reportPath}`);
+  console.log(`- texture index: ${textureIndex.indexPath} (${textureIndex.fileCount} files)`);
 }
 
 try {